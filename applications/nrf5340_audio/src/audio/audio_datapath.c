@@ -190,7 +190,8 @@ static struct {
 
 static bool tone_active;
 /* Buffer which can hold max 1 period test tone at 100 Hz */
-static uint16_t test_tone_buf[CONFIG_AUDIO_SAMPLE_RATE_HZ / 100];
+static uint8_t __aligned(sizeof(uint32_t))
+	test_tone_buf[CONFIG_AUDIO_SAMPLE_RATE_HZ / 100 * CONFIG_AUDIO_BIT_DEPTH_OCTETS];
 static size_t test_tone_size;
 
 static void hfclkaudio_set(uint16_t freq_value)
@@ -492,8 +493,8 @@ int audio_datapath_tone_play(uint16_t freq, uint16_t dur_ms, float amplitude)
 		return -EBUSY;
 	}
 
-	ret = tone_gen(test_tone_buf, &test_tone_size, freq, CONFIG_AUDIO_SAMPLE_RATE_HZ,
-		       amplitude);
+	ret = tone_gen_ext(test_tone_buf, sizeof(test_tone_buf), &test_tone_size, freq,
+			   CONFIG_AUDIO_SAMPLE_RATE_HZ, amplitude, AUDIO_BIT_DEPTH_RESOLUTION, 1);
 	if (ret) {
 		return ret;
 	}
@@ -517,15 +518,15 @@ void audio_datapath_tone_stop(void)
 static void tone_mix(uint8_t *tx_buf)
 {
 	int ret;
-	int8_t tone_buf_continuous[BLK_MONO_SIZE_OCTETS];
+	int8_t __aligned(sizeof(uint32_t)) tone_buf_continuous[BLK_MONO_SIZE_OCTETS];
 	static uint32_t finite_pos;
 
 	ret = contin_array_create(tone_buf_continuous, BLK_MONO_SIZE_OCTETS, test_tone_buf,
 				  test_tone_size, &finite_pos);
 	ERR_CHK(ret);
 
-	ret = pcm_mix(tx_buf, BLK_STEREO_SIZE_OCTETS, tone_buf_continuous, BLK_MONO_SIZE_OCTETS,
-		      B_MONO_INTO_A_STEREO_L);
+	ret = pcm_mix_ext(tx_buf, BLK_STEREO_SIZE_OCTETS, tone_buf_continuous, BLK_MONO_SIZE_OCTETS,
+			  B_MONO_INTO_A_STEREO_L, AUDIO_BIT_DEPTH_RESOLUTION);
 	ERR_CHK(ret);
 }
 
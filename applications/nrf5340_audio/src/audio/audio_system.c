@@ -39,7 +39,8 @@ static k_tid_t encoder_thread_id;
 
 static struct sw_codec_config sw_codec_cfg;
 /* Buffer which can hold max 1 period test tone at 1000 Hz */
-static int16_t test_tone_buf[CONFIG_AUDIO_SAMPLE_RATE_HZ / 1000];
+static uint8_t __aligned(sizeof(uint32_t))
+	test_tone_buf[CONFIG_AUDIO_SAMPLE_RATE_HZ / 1000 * CONFIG_AUDIO_BIT_DEPTH_OCTETS];
 static size_t test_tone_size;
 
 static void audio_gateway_configure(void)
@@ -166,21 +167,14 @@ static void encoder_thread(void *arg1, void *arg2, void *arg3)
 
 int audio_encode_test_tone_set(uint32_t freq)
 {
-	int ret;
-
 	if (freq == 0) {
 		test_tone_size = 0;
 		return 0;
 	}
 
-	ret = tone_gen(test_tone_buf, &test_tone_size, freq, CONFIG_AUDIO_SAMPLE_RATE_HZ, 1);
-	ERR_CHK(ret);
-
-	if (test_tone_size > sizeof(test_tone_buf)) {
-		return -ENOMEM;
-	}
-
-	return 0;
+	/* The tone is generated directly in the configured sample format */
+	return tone_gen_ext(test_tone_buf, sizeof(test_tone_buf), &test_tone_size, freq,
+			    CONFIG_AUDIO_SAMPLE_RATE_HZ, 1, AUDIO_BIT_DEPTH_RESOLUTION, 1);
 }
 
 /* This function is only used on gateway using USB as audio source and bidirectional stream */
@@ -25,6 +25,10 @@
 #define LC3_DEC_TIME_US 0
 #endif /* CONFIG_SW_CODEC_LC3 */
 
+/* Resolution of PCM samples. 24-bit samples are stored in 32-bit words */
+#define AUDIO_BIT_DEPTH_RESOLUTION                                                                 \
+	(IS_ENABLED(CONFIG_AUDIO_BIT_DEPTH_24) ? 24 : CONFIG_AUDIO_BIT_DEPTH_BITS)
+
 /* Max will be used when multiple codecs are supported */
 #define ENC_MAX_FRAME_SIZE MAX(LC3_ENC_MONO_FRAME_SIZE, 0)
 #define ENC_TIME_US MAX(LC3_ENC_TIME_US, 0)
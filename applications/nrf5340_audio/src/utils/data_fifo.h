@@ -11,6 +11,48 @@
 #include <stdint.h>
 #include <zephyr/kernel.h>
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+/* Filled blocks are queued in a ring of slots. The block memory is handed
+ * out from a bitmap of vacant blocks, so a freed block can be reused
+ * regardless of its position in the ring. The sequence number of the slot
+ * at position pos in the ring equals pos + 1 when the slot holds a filled
+ * block.
+ */
+struct data_fifo_slot {
+	atomic_t seq;
+	uint32_t block_idx;
+	size_t size;
+};
+
+struct data_fifo {
+	struct data_fifo_slot *slots;
+	atomic_t *vacant_blocks;
+	char *slab_buffer;
+	/* Position of the next slot to be filled. Updated by producer only. */
+	atomic_t lock_pos;
+	/* Position of the next slot to be read. */
+	atomic_t read_pos;
+	atomic_t alloced_num;
+	atomic_t waiting;
+	struct k_sem vacant_sem;
+	struct k_sem filled_sem;
+	uint32_t elements_max;
+	size_t block_size_max;
+	bool initialized;
+};
+
+#define DATA_FIFO_DEFINE(name, elements_max_in, block_size_max_in)                                 \
+	struct data_fifo_slot _slots_##name[(elements_max_in)];                                    \
+	ATOMIC_DEFINE(_vacant_blocks_##name, (elements_max_in));                                   \
+	char __aligned(WB_UP(1))                                                                   \
+		_slab_buffer_##name[(elements_max_in) * (block_size_max_in)] = { 0 };              \
+	struct data_fifo name = { .slots = _slots_##name,                                          \
+				  .vacant_blocks = _vacant_blocks_##name,                          \
+				  .slab_buffer = _slab_buffer_##name,                              \
+				  .block_size_max = block_size_max_in,                             \
+				  .elements_max = elements_max_in,                                 \
+				  .initialized = false }
+#else
 /* The queue elements hold a pointer to a memory block in a slab and the
  * number of bytes written to that block.
  */
@@ -39,6 +81,7 @@ struct data_fifo {
 				  .block_size_max = block_size_max_in,                             \
 				  .elements_max = elements_max_in,                                 \
 				  .initialized = false }
+#endif /* CONFIG_DATA_FIFO_SPSC */
 
 /**
  * @brief Get pointer to first vacant block in slab.
@@ -56,7 +99,8 @@ struct data_fifo {
  *	or K_FOREVER to wait as long as necessary.
  *
  * @retval 0 Memory allocated.
- * @retval Return values from k_mem_slab_alloc.
+ * @retval -ENOMEM No vacant block and K_NO_WAIT given.
+ * @retval -EAGAIN Waiting period timed out.
  */
 int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
 				       k_timeout_t timeout);
@@ -99,7 +143,8 @@ int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size);
  *	or K_FOREVER to wait as long as necessary.
  *
  * @retval 0 Memory pointer retrieved.
- * @retval Return values from k_msgq_get.
+ * @retval -ENOMSG No filled block and K_NO_WAIT given.
+ * @retval -EAGAIN Waiting period timed out.
  */
 int data_fifo_pointer_last_filled_get(struct data_fifo *data_fifo, void **data, size_t *size,
 				      k_timeout_t timeout);
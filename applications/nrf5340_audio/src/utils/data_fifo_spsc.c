@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "data_fifo.h"
+
+#include <zephyr/kernel.h>
+
+#include "macros_common.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(data_fifo, CONFIG_LOG_DEFAULT_LEVEL);
+
+/* Bits of the waiting field */
+#define WAITING_VACANT BIT(0)
+#define WAITING_FILLED BIT(1)
+
+/* Positions run from 0 to 2 * elements_max - 1. Wrapping at a multiple of
+ * the number of slots keeps slot indexes consistent when the position wraps,
+ * while the filled sequences of two rounds of a slot stay distinct.
+ */
+static inline uint32_t pos_add(struct data_fifo *data_fifo, uint32_t pos, uint32_t val)
+{
+	pos += val;
+
+	return (pos >= 2 * data_fifo->elements_max) ? (pos - 2 * data_fifo->elements_max) : pos;
+}
+
+static inline uint32_t pos_diff(struct data_fifo *data_fifo, uint32_t end, uint32_t start)
+{
+	return pos_add(data_fifo, end, 2 * data_fifo->elements_max - start);
+}
+
+static inline struct data_fifo_slot *slot_get(struct data_fifo *data_fifo, uint32_t pos)
+{
+	uint32_t idx = (pos >= data_fifo->elements_max) ? (pos - data_fifo->elements_max) : pos;
+
+	return &data_fifo->slots[idx];
+}
+
+static inline void *block_get(struct data_fifo *data_fifo, uint32_t idx)
+{
+	return &data_fifo->slab_buffer[idx * data_fifo->block_size_max];
+}
+
+static uint32_t block_idx_get(struct data_fifo *data_fifo, void *data)
+{
+	size_t offset = (char *)data - data_fifo->slab_buffer;
+	uint32_t idx = offset / data_fifo->block_size_max;
+
+	__ASSERT_NO_MSG(idx < data_fifo->elements_max);
+	__ASSERT_NO_MSG((offset % data_fifo->block_size_max) == 0);
+
+	return idx;
+}
+
+/* Wake up the other side only if it waits, so that kernel objects are not
+ * touched when no one is blocked.
+ */
+static void waiter_wake(struct data_fifo *data_fifo, atomic_val_t waiting_bit,
+			struct k_sem *sem)
+{
+	if (atomic_and(&data_fifo->waiting, ~waiting_bit) & waiting_bit) {
+		k_sem_give(sem);
+	}
+}
+
+static bool vacant_block_reserve(struct data_fifo *data_fifo, void **data)
+{
+	for (uint32_t i = 0; i < ATOMIC_BITMAP_SIZE(data_fifo->elements_max); i++) {
+		atomic_val_t vacant = atomic_get(&data_fifo->vacant_blocks[i]);
+
+		if (vacant == 0) {
+			continue;
+		}
+
+		uint32_t idx = i * ATOMIC_BITS + __builtin_ctzl((unsigned long)vacant);
+
+		/* Blocks are freed from both sides, but only the producer
+		 * reserves them, so the block is still vacant.
+		 */
+		atomic_clear_bit(data_fifo->vacant_blocks, idx);
+		atomic_inc(&data_fifo->alloced_num);
+		*data = block_get(data_fifo, idx);
+
+		return true;
+	}
+
+	return false;
+}
+
+static bool filled_block_claim(struct data_fifo *data_fifo, void **data, size_t *size)
+{
+	uint32_t pos;
+	uint32_t idx;
+	size_t block_size;
+
+	/* The producer may drop the oldest block on overrun, so reading is
+	 * claimed with compare and swap. The slot is copied before it is
+	 * claimed, as the producer can refill it right after read_pos moves.
+	 */
+	do {
+		pos = atomic_get(&data_fifo->read_pos);
+
+		struct data_fifo_slot *slot = slot_get(data_fifo, pos);
+
+		if ((uint32_t)atomic_get(&slot->seq) != pos_add(data_fifo, pos, 1)) {
+			return false;
+		}
+
+		idx = slot->block_idx;
+		block_size = slot->size;
+	} while (!atomic_cas(&data_fifo->read_pos, pos, pos_add(data_fifo, pos, 1)));
+
+	*data = block_get(data_fifo, idx);
+	*size = block_size;
+
+	return true;
+}
+
+int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
+				       k_timeout_t timeout)
+{
+	__ASSERT_NO_MSG(data_fifo != NULL);
+	__ASSERT_NO_MSG(data_fifo->initialized);
+
+	while (!vacant_block_reserve(data_fifo, data)) {
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			return -ENOMEM;
+		}
+
+		atomic_or(&data_fifo->waiting, WAITING_VACANT);
+
+		/* Check again in case a block was freed before the flag was set */
+		if (vacant_block_reserve(data_fifo, data)) {
+			break;
+		}
+
+		if (k_sem_take(&data_fifo->vacant_sem, timeout) &&
+		    !vacant_block_reserve(data_fifo, data)) {
+			return -EAGAIN;
+		}
+	}
+
+	return 0;
+}
+
+int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size)
+{
+	__ASSERT_NO_MSG(data_fifo != NULL);
+	__ASSERT_NO_MSG(data_fifo->initialized);
+
+	if (size > data_fifo->block_size_max) {
+		LOG_ERR("Size %zu too big", size);
+		return -ENOMEM;
+	} else if (size == 0) {
+		LOG_ERR("Size is zero");
+		return -EINVAL;
+	}
+
+	uint32_t pos = atomic_get(&data_fifo->lock_pos);
+	struct data_fifo_slot *slot = slot_get(data_fifo, pos);
+
+	/* Every queued slot refers to a different allocated block and the
+	 * locked block is not queued yet, so there is always a free slot.
+	 */
+	__ASSERT_NO_MSG(pos_diff(data_fifo, pos, atomic_get(&data_fifo->read_pos)) <
+			data_fifo->elements_max);
+
+	slot->block_idx = block_idx_get(data_fifo, *data);
+	slot->size = size;
+	atomic_set(&data_fifo->lock_pos, pos_add(data_fifo, pos, 1));
+	/* Publish the block. Atomic operations are full barriers, so the size
+	 * is visible before the sequence is updated.
+	 */
+	atomic_set(&slot->seq, pos_add(data_fifo, pos, 1));
+
+	waiter_wake(data_fifo, WAITING_FILLED, &data_fifo->filled_sem);
+
+	return 0;
+}
+
+int data_fifo_pointer_last_filled_get(struct data_fifo *data_fifo, void **data, size_t *size,
+				      k_timeout_t timeout)
+{
+	__ASSERT_NO_MSG(data_fifo != NULL);
+	__ASSERT_NO_MSG(data_fifo->initialized);
+
+	while (!filled_block_claim(data_fifo, data, size)) {
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			return -ENOMSG;
+		}
+
+		atomic_or(&data_fifo->waiting, WAITING_FILLED);
+
+		/* Check again in case a block was locked before the flag was set */
+		if (filled_block_claim(data_fifo, data, size)) {
+			break;
+		}
+
+		if (k_sem_take(&data_fifo->filled_sem, timeout) &&
+		    !filled_block_claim(data_fifo, data, size)) {
+			return -EAGAIN;
+		}
+	}
+
+	return 0;
+}
+
+int data_fifo_block_free(struct data_fifo *data_fifo, void **data)
+{
+	__ASSERT_NO_MSG(data_fifo != NULL);
+	__ASSERT_NO_MSG(data_fifo->initialized);
+
+	uint32_t idx = block_idx_get(data_fifo, *data);
+
+	__ASSERT(!atomic_test_bit(data_fifo->vacant_blocks, idx), "Block %p already free", *data);
+
+	/* Blocks can be freed in any order and are reusable right away */
+	atomic_dec(&data_fifo->alloced_num);
+	atomic_set_bit(data_fifo->vacant_blocks, idx);
+
+	waiter_wake(data_fifo, WAITING_VACANT, &data_fifo->vacant_sem);
+
+	return 0;
+}
+
+int data_fifo_num_used_get(struct data_fifo *data_fifo, uint32_t *alloced_num, uint32_t *locked_num)
+{
+	__ASSERT_NO_MSG(data_fifo != NULL);
+	__ASSERT_NO_MSG(data_fifo->initialized);
+
+	uint32_t read_pos = atomic_get(&data_fifo->read_pos);
+	uint32_t lock_pos = atomic_get(&data_fifo->lock_pos);
+	uint32_t alloced = atomic_get(&data_fifo->alloced_num);
+
+	/* The values are read without locking, so a block can be read and freed
+	 * between the reads. Never report more locked than alloced blocks.
+	 */
+	*alloced_num = alloced;
+	*locked_num = MIN(pos_diff(data_fifo, lock_pos, read_pos), alloced);
+
+	return 0;
+}
+
+static void data_fifo_reset(struct data_fifo *data_fifo)
+{
+	for (uint32_t i = 0; i < ATOMIC_BITMAP_SIZE(data_fifo->elements_max); i++) {
+		atomic_clear(&data_fifo->vacant_blocks[i]);
+	}
+
+	/* Sequence i is never the filled sequence of slot i */
+	for (uint32_t i = 0; i < data_fifo->elements_max; i++) {
+		atomic_set(&data_fifo->slots[i].seq, i);
+		data_fifo->slots[i].block_idx = 0;
+		data_fifo->slots[i].size = 0;
+		atomic_set_bit(data_fifo->vacant_blocks, i);
+	}
+
+	atomic_set(&data_fifo->lock_pos, 0);
+	atomic_set(&data_fifo->read_pos, 0);
+	atomic_set(&data_fifo->alloced_num, 0);
+	atomic_set(&data_fifo->waiting, 0);
+	k_sem_reset(&data_fifo->vacant_sem);
+	k_sem_reset(&data_fifo->filled_sem);
+}
+
+int data_fifo_empty(struct data_fifo *data_fifo)
+{
+	__ASSERT_NO_MSG(data_fifo != NULL);
+	__ASSERT_NO_MSG(data_fifo->initialized);
+
+	/* As with the slab implementation, reserved blocks are dropped as well.
+	 * The FIFO must not be in use while it is emptied.
+	 */
+	data_fifo_reset(data_fifo);
+
+	return 0;
+}
+
+int data_fifo_init(struct data_fifo *data_fifo)
+{
+	__ASSERT_NO_MSG(data_fifo != NULL);
+	__ASSERT_NO_MSG(!data_fifo->initialized);
+	/* With a single slot, the filled sequences of two rounds would overlap */
+	__ASSERT_NO_MSG(data_fifo->elements_max >= 2);
+	__ASSERT_NO_MSG(data_fifo->block_size_max != 0);
+	__ASSERT_NO_MSG((data_fifo->block_size_max % WB_UP(1)) == 0);
+	int ret;
+
+	ret = k_sem_init(&data_fifo->vacant_sem, 0, 1);
+	if (ret) {
+		return ret;
+	}
+
+	ret = k_sem_init(&data_fifo->filled_sem, 0, 1);
+	if (ret) {
+		return ret;
+	}
+
+	data_fifo_reset(data_fifo);
+	data_fifo->initialized = true;
+
+	return 0;
+}
@@ -6,20 +6,141 @@
 
 #include "pcm_mix.h"
 
+#include <string.h>
 #include <zephyr/kernel.h>
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(pcm_mix, LOG_LEVEL_WRN);
 
+/* Use packed saturating arithmetic (two 16-bit samples per 32-bit word) when the
+ * core implements the DSP extension, for example Cortex-M33 on nRF5340.
+ * Other targets, like native_posix or Cortex-M3, use the scalar implementation.
+ */
+#if defined(__ARM_FEATURE_SIMD32) && (__ARM_FEATURE_SIMD32 == 1) && \
+	(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define PCM_MIX_SIMD 1
+#include <arm_acle.h>
+#else
+#define PCM_MIX_SIMD 0
+#endif
+
 /* Clip signal if amplitude is outside legal range */
-static void hard_limiter(int32_t *const pcm)
+static inline int16_t hard_limiter(int32_t pcm)
+{
+#if PCM_MIX_SIMD
+	return (int16_t)__ssat(pcm, 16);
+#else
+	return (int16_t)CLAMP(pcm, INT16_MIN, INT16_MAX);
+#endif
+}
+
+#if PCM_MIX_SIMD
+static inline uint32_t load_u32(const void *p)
+{
+	uint32_t v;
+
+	/* Buffers are only guaranteed to be 16-bit aligned. Cortex-M33 supports
+	 * unaligned word access, so this compiles to a single load.
+	 */
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline void store_u32(void *p, uint32_t v)
+{
+	memcpy(p, &v, sizeof(v));
+}
+
+/* Saturating addition of two pairs of 16-bit samples */
+static inline uint32_t qadd16(uint32_t a, uint32_t b)
+{
+	return (uint32_t)__qadd16((int16x2_t)a, (int16x2_t)b);
+}
+#endif /* PCM_MIX_SIMD */
+
+static bool is_valid_bit_depth(uint8_t pcm_bit_depth)
+{
+	return (pcm_bit_depth == 16) || (pcm_bit_depth == 24) || (pcm_bit_depth == 32);
+}
+
+/* Add two samples stored in 32-bit words and clip the result to the given
+ * bit depth. Bit depth is a compile time constant in every caller, so the
+ * check is optimized out.
+ */
+static ALWAYS_INLINE int32_t add_limit_32(int32_t a, int32_t b, uint8_t pcm_bit_depth)
+{
+	if (pcm_bit_depth == 24) {
+#if PCM_MIX_SIMD
+		return __ssat(a + b, 24);
+#else
+		return CLAMP(a + b, -(1 << 23), (1 << 23) - 1);
+#endif
+	}
+
+#if PCM_MIX_SIMD
+	return __qadd(a, b);
+#else
+	return (int32_t)CLAMP((int64_t)a + b, INT32_MIN, INT32_MAX);
+#endif
+}
+
+/* Mix mono samples of buffer B into selected channels of buffer A.
+ * Both buffers use 32-bit words.
+ */
+static ALWAYS_INLINE void mix_mono_into_channels_32(int32_t *a, const int32_t *b, size_t frames,
+						     uint8_t num_ch, uint8_t ch_mask,
+						     uint8_t pcm_bit_depth)
+{
+	if (num_ch == 1) {
+		for (size_t i = 0; i < frames; i++) {
+			a[i] = add_limit_32(a[i], b[i], pcm_bit_depth);
+		}
+		return;
+	}
+
+	if ((num_ch == 2) && (ch_mask == (BIT(0) | BIT(1)))) {
+		for (size_t i = 0; i < frames; i++) {
+			a[2 * i] = add_limit_32(a[2 * i], b[i], pcm_bit_depth);
+			a[2 * i + 1] = add_limit_32(a[2 * i + 1], b[i], pcm_bit_depth);
+		}
+		return;
+	}
+
+	for (size_t i = 0; i < frames; i++) {
+		int32_t *frame = &a[i * num_ch];
+
+		for (uint8_t ch = 0; ch < num_ch; ch++) {
+			if (ch_mask & BIT(ch)) {
+				frame[ch] = add_limit_32(frame[ch], b[i], pcm_bit_depth);
+			}
+		}
+	}
+}
+
+static void mix_mono_into_channels_24(int32_t *a, const int32_t *b, size_t frames,
+				      uint8_t num_ch, uint8_t ch_mask)
+{
+	mix_mono_into_channels_32(a, b, frames, num_ch, ch_mask, 24);
+}
+
+static void mix_mono_into_channels_s32(int32_t *a, const int32_t *b, size_t frames,
+				       uint8_t num_ch, uint8_t ch_mask)
 {
-	if (*pcm < INT16_MIN) {
-		LOG_DBG("Clip");
-		*pcm = INT16_MIN;
-	} else if (*pcm > INT16_MAX) {
-		LOG_DBG("Clip");
-		*pcm = INT16_MAX;
+	mix_mono_into_channels_32(a, b, frames, num_ch, ch_mask, 32);
+}
+
+/* Mix mono into selected channels of a 16-bit buffer with more than two channels */
+static void mix_mono_into_channels_16(int16_t *a, const int16_t *b, size_t frames,
+				      uint8_t num_ch, uint8_t ch_mask)
+{
+	for (size_t i = 0; i < frames; i++) {
+		int16_t *frame = &a[i * num_ch];
+
+		for (uint8_t ch = 0; ch < num_ch; ch++) {
+			if (ch_mask & BIT(ch)) {
+				frame[ch] = hard_limiter(frame[ch] + b[i]);
+			}
+		}
 	}
 }
 
@@ -27,14 +148,18 @@ static void hard_limiter(int32_t *const pcm)
 static void pcm_mix_identical(void *const pcm_a, size_t size_a, void const *const pcm_b,
 			      size_t size_b)
 {
-	int32_t res;
-
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i] + ((int16_t *)pcm_b)[i];
+	int16_t *a = (int16_t *)pcm_a;
+	const int16_t *b = (const int16_t *)pcm_b;
+	uint32_t i = 0;
 
-		hard_limiter(&res);
+#if PCM_MIX_SIMD
+	for (; i + 1 < size_b / 2; i += 2) {
+		store_u32(&a[i], qadd16(load_u32(&a[i]), load_u32(&b[i])));
+	}
+#endif
 
-		((int16_t *)pcm_a)[i] = (int16_t)res;
+	for (; i < size_b / 2; i++) {
+		a[i] = hard_limiter(a[i] + b[i]);
 	}
 }
 
@@ -42,55 +167,105 @@ static void pcm_mix_identical(void *const pcm_a, size_t size_a, void const *cons
 static void pcm_mix_b_mono_into_a_stereo_lr(void *const pcm_a, size_t size_a,
 					    void const *const pcm_b, size_t size_b)
 {
-	int32_t res;
+	int16_t *a = (int16_t *)pcm_a;
+	const int16_t *b = (const int16_t *)pcm_b;
+	uint32_t i = 0;
 
 	/* Use size_b as this is the length of the mono sample.
 	 * This must be *2 to traverse the stereo sample and /2 since
 	 * the sample is two bytes in size.
 	 */
-	for (uint32_t i = 0; i < size_b; i++) {
-		res = ((int16_t *)pcm_a)[i] + ((int16_t *)pcm_b)[i / 2];
+#if PCM_MIX_SIMD
+	for (; i + 3 < size_b; i += 4) {
+		uint32_t mono = load_u32(&b[i / 2]);
+
+		/* Duplicate every mono sample to both channels (PKHBT/PKHTB). */
+		uint32_t b_0 = (mono & 0x0000FFFF) | (mono << 16);
+		uint32_t b_1 = (mono & 0xFFFF0000) | (mono >> 16);
 
-		hard_limiter(&res);
+		store_u32(&a[i], qadd16(load_u32(&a[i]), b_0));
+		store_u32(&a[i + 2], qadd16(load_u32(&a[i + 2]), b_1));
+	}
+#endif
 
-		((int16_t *)pcm_a)[i] = (int16_t)res;
+	for (; i < size_b; i++) {
+		a[i] = hard_limiter(a[i] + b[i / 2]);
 	}
 }
 
-/* Mix mono into left channel of a stereo buffer */
-static void pcm_mix_b_mono_into_a_stereo_l(void *const pcm_a, size_t size_a,
-					   void const *const pcm_b, size_t size_b)
+/* Mix mono into one channel of a stereo buffer. Channel offset is 0 for left
+ * and 1 for right channel.
+ */
+static void pcm_mix_b_mono_into_a_stereo_ch(void *const pcm_a, void const *const pcm_b,
+					    size_t size_b, uint8_t ch_offset)
 {
-	int32_t res;
+	int16_t *a = (int16_t *)pcm_a;
+	const int16_t *b = (const int16_t *)pcm_b;
+	uint32_t i = 0;
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i * 2] + ((int16_t *)pcm_b)[i];
+#if PCM_MIX_SIMD
+	/* Adding zero to the other channel leaves it untouched. */
+	uint8_t shift = ch_offset * 16;
 
-		hard_limiter(&res);
+	for (; i + 1 < size_b / 2; i += 2) {
+		uint32_t mono = load_u32(&b[i]);
 
-		((int16_t *)pcm_a)[i * 2] = (int16_t)res;
+		store_u32(&a[i * 2],
+			  qadd16(load_u32(&a[i * 2]), (mono & 0x0000FFFF) << shift));
+		store_u32(&a[i * 2 + 2],
+			  qadd16(load_u32(&a[i * 2 + 2]), (mono >> 16) << shift));
+	}
+#endif
+
+	for (; i < size_b / 2; i++) {
+		a[i * 2 + ch_offset] = hard_limiter(a[i * 2 + ch_offset] + b[i]);
 	}
 }
 
-/* Mix mono into right channel of a stereo buffer */
-static void pcm_mix_b_mono_into_a_stereo_r(void *const pcm_a, size_t size_a,
-					   void const *const pcm_b, size_t size_b)
+int pcm_mix_mono_into_channels(void *const pcm_a, size_t size_a, uint8_t num_ch,
+			       uint8_t ch_mask, void const *const pcm_b, size_t size_b,
+			       uint8_t pcm_bit_depth)
 {
-	int32_t res;
+	if (pcm_a == NULL || size_a == 0 || !is_valid_bit_depth(pcm_bit_depth)) {
+		return -EINVAL;
+	}
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i * 2 + 1] + ((int16_t *)pcm_b)[i];
+	if (num_ch == 0 || num_ch > PCM_MIX_MAX_CHANNELS || ch_mask == 0 ||
+	    (ch_mask & ~BIT_MASK(num_ch))) {
+		return -EINVAL;
+	}
 
-		hard_limiter(&res);
+	if (pcm_b == NULL || size_b == 0) {
+		/* Nothing to mix, returning */
+		return 0;
+	}
 
-		((int16_t *)pcm_a)[i * 2 + 1] = (int16_t)res;
+	if (size_b > (size_a / num_ch)) {
+		LOG_ERR("size a %d size b %d", size_a, size_b);
+		return -EPERM;
 	}
+
+	if (pcm_bit_depth == 24) {
+		mix_mono_into_channels_24(pcm_a, pcm_b, size_b / sizeof(int32_t), num_ch, ch_mask);
+	} else if (pcm_bit_depth == 32) {
+		mix_mono_into_channels_s32(pcm_a, pcm_b, size_b / sizeof(int32_t), num_ch, ch_mask);
+	} else if (num_ch == 1) {
+		pcm_mix_identical(pcm_a, size_a, pcm_b, size_b);
+	} else if (num_ch == 2 && ch_mask == (BIT(0) | BIT(1))) {
+		pcm_mix_b_mono_into_a_stereo_lr(pcm_a, size_a, pcm_b, size_b);
+	} else if (num_ch == 2) {
+		pcm_mix_b_mono_into_a_stereo_ch(pcm_a, pcm_b, size_b, (ch_mask == BIT(0)) ? 0 : 1);
+	} else {
+		mix_mono_into_channels_16(pcm_a, pcm_b, size_b / sizeof(int16_t), num_ch, ch_mask);
+	}
+
+	return 0;
 }
 
-int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
-	    enum pcm_mix_mode mix_mode)
+int pcm_mix_ext(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
+		enum pcm_mix_mode mix_mode, uint8_t pcm_bit_depth)
 {
-	if (pcm_a == NULL || size_a == 0) {
+	if (pcm_a == NULL || size_a == 0 || !is_valid_bit_depth(pcm_bit_depth)) {
 		return -EINVAL;
 	}
 
@@ -106,30 +281,25 @@ int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t si
 		if (size_b > size_a) {
 			return -EPERM;
 		}
-		pcm_mix_identical(pcm_a, size_a, pcm_b, size_b);
-		break;
+		/* Interleaved channels of equal buffers can be mixed as mono */
+		return pcm_mix_mono_into_channels(pcm_a, size_a, 1, BIT(0), pcm_b, size_b,
+						  pcm_bit_depth);
 	case B_MONO_INTO_A_STEREO_LR:
-		if (size_b > (size_a / 2)) {
-			return -EPERM;
-		}
-		pcm_mix_b_mono_into_a_stereo_lr(pcm_a, size_a, pcm_b, size_b);
-		break;
+		return pcm_mix_mono_into_channels(pcm_a, size_a, 2, BIT(0) | BIT(1), pcm_b, size_b,
+						  pcm_bit_depth);
 	case B_MONO_INTO_A_STEREO_L:
-		pcm_mix_b_mono_into_a_stereo_l(pcm_a, size_a, pcm_b, size_b);
-		if (size_b > (size_a / 2)) {
-			LOG_ERR("size a %d size b %d", size_a, size_b);
-			return -EPERM;
-		}
-		break;
+		return pcm_mix_mono_into_channels(pcm_a, size_a, 2, BIT(0), pcm_b, size_b,
+						  pcm_bit_depth);
 	case B_MONO_INTO_A_STEREO_R:
-		pcm_mix_b_mono_into_a_stereo_r(pcm_a, size_a, pcm_b, size_b);
-		if (size_b > (size_a / 2)) {
-			return -EPERM;
-		}
-		break;
+		return pcm_mix_mono_into_channels(pcm_a, size_a, 2, BIT(1), pcm_b, size_b,
+						  pcm_bit_depth);
 	default:
 		return -ESRCH;
 	};
+}
 
-	return 0;
+int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
+	    enum pcm_mix_mode mix_mode)
+{
+	return pcm_mix_ext(pcm_a, size_a, pcm_b, size_b, mix_mode, 16);
 }
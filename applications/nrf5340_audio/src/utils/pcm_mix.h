@@ -9,6 +9,9 @@
 
 #include <zephyr/kernel.h>
 
+/* Maximum number of interleaved channels supported by pcm_mix_mono_into_channels() */
+#define PCM_MIX_MAX_CHANNELS 8
+
 enum pcm_mix_mode {
 	B_STEREO_INTO_A_STEREO,
 	B_MONO_INTO_A_MONO,
@@ -40,4 +43,50 @@ enum pcm_mix_mode {
 int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
 	    enum pcm_mix_mode mix_mode);
 
+/**
+ * @brief Mixes two buffers of PCM data with the given bit depth.
+ *
+ * @note Works as pcm_mix(), but supports 16-bit samples, 24-bit samples
+ * stored in the lower bits of 32-bit words (24-in-32) and 32-bit samples.
+ * 24-bit samples are clipped to the 24-bit range.
+ *
+ * @param pcm_a         [in/out]Pointer to buffer A PCM data
+ * @param size_a        [in]    Size (bytes) of buffer A PCM data
+ * @param pcm_b         [in]    Pointer to buffer B PCM data
+ * @param size_b        [in]    Size (bytes) of buffer B PCM data
+ * @param mix_mode      [in]    Mixing mode according to pcm_mix_mode
+ * @param pcm_bit_depth [in]    Bit depth of PCM samples (16, 24 or 32)
+ *
+ * @return 0            Success. Result stored in pcm_a
+ * @return -EINVAL      pcm_a is NULL, size_a = 0 or pcm_bit_depth is invalid
+ * @return -EPERM       size_b < size_a for stereo to stereo, mono to mono
+ *						or size_a/2 < size_b for mono to stereo mix
+ * @return -ESRCH       Invalid mix_mode
+ */
+int pcm_mix_ext(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
+		enum pcm_mix_mode mix_mode, uint8_t pcm_bit_depth);
+
+/**
+ * @brief Mixes a mono buffer into selected channels of an interleaved
+ *        multi-channel buffer.
+ *
+ * @note Uses simple addition with hard clip protection.
+ *
+ * @param pcm_a         [in/out]Pointer to interleaved buffer A PCM data
+ * @param size_a        [in]    Size (bytes) of buffer A PCM data
+ * @param num_ch        [in]    Number of channels in buffer A [1..PCM_MIX_MAX_CHANNELS]
+ * @param ch_mask       [in]    Bit mask of buffer A channels to mix buffer B into
+ * @param pcm_b         [in]    Pointer to mono buffer B PCM data
+ * @param size_b        [in]    Size (bytes) of buffer B PCM data
+ * @param pcm_bit_depth [in]    Bit depth of PCM samples (16, 24 or 32)
+ *
+ * @return 0            Success. Result stored in pcm_a
+ * @return -EINVAL      pcm_a is NULL, size_a = 0 or num_ch, ch_mask or
+ *                      pcm_bit_depth is invalid
+ * @return -EPERM       size_a/num_ch < size_b
+ */
+int pcm_mix_mono_into_channels(void *const pcm_a, size_t size_a, uint8_t num_ch,
+			       uint8_t ch_mask, void const *const pcm_b, size_t size_b,
+			       uint8_t pcm_bit_depth);
+
 #endif /* _PCM_MIX_H_ */
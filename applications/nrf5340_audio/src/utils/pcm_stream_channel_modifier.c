@@ -8,12 +8,47 @@
 
 #include <zephyr/kernel.h>
 #include <errno.h>
+#include <string.h>
 
 #include "channel_assignment.h"
 
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(pscm);
 
+/* 16-bit and 32-bit samples are moved as whole words instead of byte by byte.
+ * Two 16-bit samples are packed into one word and combined with shifts and
+ * masks, which compile to PKHBT/PKHTB instructions on cores with the DSP
+ * extension. The packing assumes little-endian sample layout.
+ */
+BUILD_ASSERT(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Little-endian samples expected");
+
+static inline uint32_t load_u32(const uint8_t *p)
+{
+	uint32_t v;
+
+	/* Buffers are not guaranteed to be word aligned. */
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline void store_u32(uint8_t *p, uint32_t v)
+{
+	memcpy(p, &v, sizeof(v));
+}
+
+static inline uint16_t load_u16(const uint8_t *p)
+{
+	uint16_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline void store_u16(uint8_t *p, uint16_t v)
+{
+	memcpy(p, &v, sizeof(v));
+}
+
 /**
  * @brief      Determines whether the specified pcm bit depth is valid bit depth.
  *
@@ -60,30 +95,58 @@ int pscm_zero_pad(void const *const input, size_t input_size, enum audio_channel
 		return -EINVAL;
 	}
 
-	char *pointer_input = (char *)input;
-	char *pointer_output = (char *)output;
+	if (channel != AUDIO_CH_L && channel != AUDIO_CH_R) {
+		LOG_ERR("Invalid channel selection");
+		return -EINVAL;
+	}
 
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i++) {
-		if (channel == AUDIO_CH_L) {
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = *pointer_input++;
-			}
+	const uint8_t *pointer_input = (const uint8_t *)input;
+	uint8_t *pointer_output = (uint8_t *)output;
+	size_t samples = input_size / bytes_per_sample;
+	uint32_t i = 0;
 
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = 0;
-			}
-		} else if (channel == AUDIO_CH_R) {
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = 0;
-			}
+	switch (bytes_per_sample) {
+	case sizeof(uint16_t): {
+		/* Left channel is stored in the lower half of the stereo word */
+		uint8_t shift = (channel == AUDIO_CH_L) ? 0 : 16;
 
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = *pointer_input++;
-			}
-		} else {
-			LOG_ERR("Invalid channel selection");
-			return -EINVAL;
+		for (; i + 1 < samples; i += 2) {
+			uint32_t in = load_u32(pointer_input);
+
+			store_u32(pointer_output, (in & 0x0000FFFF) << shift);
+			store_u32(pointer_output + 4, (in >> 16) << shift);
+			pointer_input += 4;
+			pointer_output += 8;
+		}
+
+		if (i < samples) {
+			store_u32(pointer_output, (uint32_t)load_u16(pointer_input) << shift);
 		}
+		break;
+	}
+	case sizeof(uint32_t): {
+		uint8_t data_offset = (channel == AUDIO_CH_L) ? 0 : 4;
+
+		for (; i < samples; i++) {
+			store_u32(pointer_output, 0);
+			store_u32(pointer_output + 4, 0);
+			store_u32(pointer_output + data_offset, load_u32(pointer_input));
+			pointer_input += 4;
+			pointer_output += 8;
+		}
+		break;
+	}
+	default: {
+		uint8_t data_offset = (channel == AUDIO_CH_L) ? 0 : bytes_per_sample;
+
+		for (; i < samples; i++) {
+			memset(pointer_output, 0, 2 * bytes_per_sample);
+			memcpy(pointer_output + data_offset, pointer_input, bytes_per_sample);
+			pointer_input += bytes_per_sample;
+			pointer_output += 2 * bytes_per_sample;
+		}
+		break;
+	}
 	}
 
 	*output_size = input_size * 2;
@@ -99,19 +162,46 @@ int pscm_copy_pad(void const *const input, size_t input_size, uint8_t pcm_bit_de
 		return -EINVAL;
 	}
 
-	char *pointer_input = (char *)input;
-	char *pointer_output = (char *)output;
+	const uint8_t *pointer_input = (const uint8_t *)input;
+	uint8_t *pointer_output = (uint8_t *)output;
+	size_t samples = input_size / bytes_per_sample;
+	uint32_t i = 0;
 
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i++) {
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output++ = *pointer_input++;
+	switch (bytes_per_sample) {
+	case sizeof(uint16_t):
+		for (; i + 1 < samples; i += 2) {
+			uint32_t in = load_u32(pointer_input);
+
+			store_u32(pointer_output, (in & 0x0000FFFF) | (in << 16));
+			store_u32(pointer_output + 4, (in & 0xFFFF0000) | (in >> 16));
+			pointer_input += 4;
+			pointer_output += 8;
 		}
-		/* Move back to start of sample to copy into next channel */
-		pointer_input -= bytes_per_sample;
 
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output++ = *pointer_input++;
+		if (i < samples) {
+			uint32_t in = load_u16(pointer_input);
+
+			store_u32(pointer_output, in | (in << 16));
+		}
+		break;
+	case sizeof(uint32_t):
+		for (; i < samples; i++) {
+			uint32_t in = load_u32(pointer_input);
+
+			store_u32(pointer_output, in);
+			store_u32(pointer_output + 4, in);
+			pointer_input += 4;
+			pointer_output += 8;
 		}
+		break;
+	default:
+		for (; i < samples; i++) {
+			memcpy(pointer_output, pointer_input, bytes_per_sample);
+			memcpy(pointer_output + bytes_per_sample, pointer_input, bytes_per_sample);
+			pointer_input += bytes_per_sample;
+			pointer_output += 2 * bytes_per_sample;
+		}
+		break;
 	}
 
 	*output_size = input_size * 2;
@@ -127,17 +217,49 @@ int pscm_combine(void const *const input_left, void const *const input_right, si
 		return -EINVAL;
 	}
 
-	char *pointer_input_left = (char *)input_left;
-	char *pointer_input_right = (char *)input_right;
-	char *pointer_output = (char *)output;
+	const uint8_t *pointer_input_left = (const uint8_t *)input_left;
+	const uint8_t *pointer_input_right = (const uint8_t *)input_right;
+	uint8_t *pointer_output = (uint8_t *)output;
+	size_t samples = input_size / bytes_per_sample;
+	uint32_t i = 0;
+
+	switch (bytes_per_sample) {
+	case sizeof(uint16_t):
+		for (; i + 1 < samples; i += 2) {
+			uint32_t left = load_u32(pointer_input_left);
+			uint32_t right = load_u32(pointer_input_right);
+
+			store_u32(pointer_output, (left & 0x0000FFFF) | (right << 16));
+			store_u32(pointer_output + 4, (right & 0xFFFF0000) | (left >> 16));
+			pointer_input_left += 4;
+			pointer_input_right += 4;
+			pointer_output += 8;
+		}
 
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i++) {
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output++ = *pointer_input_left++;
+		if (i < samples) {
+			store_u16(pointer_output, load_u16(pointer_input_left));
+			store_u16(pointer_output + 2, load_u16(pointer_input_right));
 		}
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output++ = *pointer_input_right++;
+		break;
+	case sizeof(uint32_t):
+		for (; i < samples; i++) {
+			store_u32(pointer_output, load_u32(pointer_input_left));
+			store_u32(pointer_output + 4, load_u32(pointer_input_right));
+			pointer_input_left += 4;
+			pointer_input_right += 4;
+			pointer_output += 8;
 		}
+		break;
+	default:
+		for (; i < samples; i++) {
+			memcpy(pointer_output, pointer_input_left, bytes_per_sample);
+			memcpy(pointer_output + bytes_per_sample, pointer_input_right,
+			       bytes_per_sample);
+			pointer_input_left += bytes_per_sample;
+			pointer_input_right += bytes_per_sample;
+			pointer_output += 2 * bytes_per_sample;
+		}
+		break;
 	}
 
 	*output_size = input_size * 2;
@@ -154,26 +276,57 @@ int pscm_one_channel_split(void const *const input, size_t input_size,
 		return -EINVAL;
 	}
 
-	char *pointer_input = (char *)input;
-	char *pointer_output = (char *)output;
+	if (channel != AUDIO_CH_L && channel != AUDIO_CH_R) {
+		LOG_ERR("Invalid channel selection");
+		return -EINVAL;
+	}
 
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i += 2) {
-		if (channel == AUDIO_CH_L) {
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = *pointer_input++;
-			}
-			pointer_input += bytes_per_sample;
+	const uint8_t *pointer_input = (const uint8_t *)input;
+	uint8_t *pointer_output = (uint8_t *)output;
+	size_t frames = input_size / (2 * bytes_per_sample);
+	uint8_t data_offset = (channel == AUDIO_CH_L) ? 0 : bytes_per_sample;
+	uint32_t i = 0;
 
-		} else if (channel == AUDIO_CH_R) {
-			pointer_input += bytes_per_sample;
+	switch (bytes_per_sample) {
+	case sizeof(uint16_t):
+		if (channel == AUDIO_CH_L) {
+			for (; i + 1 < frames; i += 2) {
+				uint32_t in_0 = load_u32(pointer_input);
+				uint32_t in_1 = load_u32(pointer_input + 4);
 
-			for (uint8_t j = 0; j < bytes_per_sample; j++) {
-				*pointer_output++ = *pointer_input++;
+				store_u32(pointer_output, (in_0 & 0x0000FFFF) | (in_1 << 16));
+				pointer_input += 8;
+				pointer_output += 4;
 			}
 		} else {
-			LOG_ERR("Invalid channel selection");
-			return -EINVAL;
+			for (; i + 1 < frames; i += 2) {
+				uint32_t in_0 = load_u32(pointer_input);
+				uint32_t in_1 = load_u32(pointer_input + 4);
+
+				store_u32(pointer_output, (in_1 & 0xFFFF0000) | (in_0 >> 16));
+				pointer_input += 8;
+				pointer_output += 4;
+			}
+		}
+
+		if (i < frames) {
+			store_u16(pointer_output, load_u16(pointer_input + data_offset));
+		}
+		break;
+	case sizeof(uint32_t):
+		for (; i < frames; i++) {
+			store_u32(pointer_output, load_u32(pointer_input + data_offset));
+			pointer_input += 8;
+			pointer_output += 4;
 		}
+		break;
+	default:
+		for (; i < frames; i++) {
+			memcpy(pointer_output, pointer_input + data_offset, bytes_per_sample);
+			pointer_input += 2 * bytes_per_sample;
+			pointer_output += bytes_per_sample;
+		}
+		break;
 	}
 
 	*output_size = input_size / 2;
@@ -189,19 +342,174 @@ int pscm_two_channel_split(void const *const input, size_t input_size, uint8_t p
 		return -EINVAL;
 	}
 
-	char *pointer_input = (char *)input;
-	char *pointer_output_left = (char *)output_left;
-	char *pointer_output_right = (char *)output_right;
+	const uint8_t *pointer_input = (const uint8_t *)input;
+	uint8_t *pointer_output_left = (uint8_t *)output_left;
+	uint8_t *pointer_output_right = (uint8_t *)output_right;
+	size_t frames = input_size / (2 * bytes_per_sample);
+	uint32_t i = 0;
+
+	switch (bytes_per_sample) {
+	case sizeof(uint16_t):
+		for (; i + 1 < frames; i += 2) {
+			uint32_t in_0 = load_u32(pointer_input);
+			uint32_t in_1 = load_u32(pointer_input + 4);
+
+			store_u32(pointer_output_left, (in_0 & 0x0000FFFF) | (in_1 << 16));
+			store_u32(pointer_output_right, (in_1 & 0xFFFF0000) | (in_0 >> 16));
+			pointer_input += 8;
+			pointer_output_left += 4;
+			pointer_output_right += 4;
+		}
 
-	for (uint32_t i = 0; i < input_size / bytes_per_sample; i += 2) {
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output_left++ = *pointer_input++;
+		if (i < frames) {
+			store_u16(pointer_output_left, load_u16(pointer_input));
+			store_u16(pointer_output_right, load_u16(pointer_input + 2));
 		}
-		for (uint8_t j = 0; j < bytes_per_sample; j++) {
-			*pointer_output_right++ = *pointer_input++;
+		break;
+	case sizeof(uint32_t):
+		for (; i < frames; i++) {
+			store_u32(pointer_output_left, load_u32(pointer_input));
+			store_u32(pointer_output_right, load_u32(pointer_input + 4));
+			pointer_input += 8;
+			pointer_output_left += 4;
+			pointer_output_right += 4;
 		}
+		break;
+	default:
+		for (; i < frames; i++) {
+			memcpy(pointer_output_left, pointer_input, bytes_per_sample);
+			memcpy(pointer_output_right, pointer_input + bytes_per_sample,
+			       bytes_per_sample);
+			pointer_input += 2 * bytes_per_sample;
+			pointer_output_left += bytes_per_sample;
+			pointer_output_right += bytes_per_sample;
+		}
+		break;
 	}
 
 	*output_size = input_size / 2;
 	return 0;
 }
+
+static bool is_valid_num_ch(uint8_t num_ch)
+{
+	if (num_ch == 0 || num_ch > PSCM_MAX_CHANNELS) {
+		LOG_ERR("Invalid number of channels: %d", num_ch);
+		return false;
+	}
+
+	return true;
+}
+
+int pscm_interleave(void const *const *inputs, uint8_t num_ch, size_t input_size,
+		    uint8_t pcm_bit_depth, void *output, size_t *output_size)
+{
+	uint8_t bytes_per_sample = pcm_bit_depth / 8;
+
+	if (!is_valid_bit_depth(pcm_bit_depth) || !is_valid_num_ch(num_ch) ||
+	    !is_valid_size(input_size, bytes_per_sample, 1)) {
+		return -EINVAL;
+	}
+
+	if (num_ch == 1) {
+		memcpy(output, inputs[0], input_size);
+		*output_size = input_size;
+		return 0;
+	}
+
+	if (num_ch == 2) {
+		return pscm_combine(inputs[0], inputs[1], input_size, pcm_bit_depth, output,
+				    output_size);
+	}
+
+	size_t samples = input_size / bytes_per_sample;
+	size_t frame_size = num_ch * bytes_per_sample;
+
+	/* Channels are handled one by one, so that every input is read sequentially */
+	for (uint8_t ch = 0; ch < num_ch; ch++) {
+		const uint8_t *pointer_input = (const uint8_t *)inputs[ch];
+		uint8_t *pointer_output = (uint8_t *)output + ch * bytes_per_sample;
+
+		switch (bytes_per_sample) {
+		case sizeof(uint16_t):
+			for (uint32_t i = 0; i < samples; i++) {
+				store_u16(pointer_output, load_u16(pointer_input));
+				pointer_input += 2;
+				pointer_output += frame_size;
+			}
+			break;
+		case sizeof(uint32_t):
+			for (uint32_t i = 0; i < samples; i++) {
+				store_u32(pointer_output, load_u32(pointer_input));
+				pointer_input += 4;
+				pointer_output += frame_size;
+			}
+			break;
+		default:
+			for (uint32_t i = 0; i < samples; i++) {
+				memcpy(pointer_output, pointer_input, bytes_per_sample);
+				pointer_input += bytes_per_sample;
+				pointer_output += frame_size;
+			}
+			break;
+		}
+	}
+
+	*output_size = input_size * num_ch;
+	return 0;
+}
+
+int pscm_deinterleave(void const *const input, size_t input_size, uint8_t num_ch,
+		      uint8_t pcm_bit_depth, void *const *outputs, size_t *output_size)
+{
+	uint8_t bytes_per_sample = pcm_bit_depth / 8;
+
+	if (!is_valid_bit_depth(pcm_bit_depth) || !is_valid_num_ch(num_ch) ||
+	    !is_valid_size(input_size, bytes_per_sample, num_ch)) {
+		return -EINVAL;
+	}
+
+	if (num_ch == 2 && outputs[0] && outputs[1]) {
+		return pscm_two_channel_split(input, input_size, pcm_bit_depth, outputs[0],
+					      outputs[1], output_size);
+	}
+
+	size_t frame_size = num_ch * bytes_per_sample;
+	size_t frames = input_size / frame_size;
+
+	for (uint8_t ch = 0; ch < num_ch; ch++) {
+		const uint8_t *pointer_input = (const uint8_t *)input + ch * bytes_per_sample;
+		uint8_t *pointer_output = (uint8_t *)outputs[ch];
+
+		if (pointer_output == NULL) {
+			continue;
+		}
+
+		switch (bytes_per_sample) {
+		case sizeof(uint16_t):
+			for (uint32_t i = 0; i < frames; i++) {
+				store_u16(pointer_output, load_u16(pointer_input));
+				pointer_input += frame_size;
+				pointer_output += 2;
+			}
+			break;
+		case sizeof(uint32_t):
+			for (uint32_t i = 0; i < frames; i++) {
+				store_u32(pointer_output, load_u32(pointer_input));
+				pointer_input += frame_size;
+				pointer_output += 4;
+			}
+			break;
+		default:
+			for (uint32_t i = 0; i < frames; i++) {
+				memcpy(pointer_output, pointer_input, bytes_per_sample);
+				pointer_input += frame_size;
+				pointer_output += bytes_per_sample;
+			}
+			break;
+		}
+	}
+
+	*output_size = input_size / num_ch;
+	return 0;
+}
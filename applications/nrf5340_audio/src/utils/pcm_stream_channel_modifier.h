@@ -11,6 +11,9 @@
 
 #include "sw_codec_select.h"
 
+/* Maximum number of channels supported by pscm_interleave() and pscm_deinterleave() */
+#define PSCM_MAX_CHANNELS 8
+
 /**@brief  Adds a 0 after every sample from *input
  *	   and writes it to *output
  * @note: Use to create stereo stream from a mono source where one
@@ -95,4 +98,41 @@ int pscm_one_channel_split(void const *const input, size_t input_size,
 int pscm_two_channel_split(void const *const input, size_t input_size, uint8_t pcm_bit_depth,
 			   void *output_left, void *output_right, size_t *output_size);
 
+/**@brief  Combines up to PSCM_MAX_CHANNELS mono streams into one
+ *	   interleaved multi-channel stream
+ * @note: Samples with 24-bit resolution stored in 32-bit words
+ *	  are handled with the pcm_bit_depth of 32
+ *
+ * @param[in]	inputs:			Array of pointers to input buffers,
+ *					one for every channel
+ * @param[in]	num_ch:			Number of channels
+ * @param[in]	input_size:		Number of bytes in input. Same for all channels
+ * @param[in]	pcm_bit_depth		Bit depth of pcm samples (16, 24 or 32)
+ * @param[out]	output:			Pointer to output buffer
+ * @param[out]	output_size:		Number of bytes written to output.
+ *
+ * @return	0 if success
+ */
+int pscm_interleave(void const *const *inputs, uint8_t num_ch, size_t input_size,
+		    uint8_t pcm_bit_depth, void *output, size_t *output_size);
+
+/**@brief  Splits an interleaved multi-channel stream with up to
+ *	   PSCM_MAX_CHANNELS channels to separate mono streams
+ * @note: Channels with NULL output buffer are skipped
+ *
+ * @param[in]	input:			Pointer to input buffer
+ * @param[in]	input_size:		Number of bytes in input. Must be
+ *					divisible by number of channels
+ * @param[in]	num_ch:			Number of channels
+ * @param[in]	pcm_bit_depth		Bit depth of pcm samples (16, 24 or 32)
+ * @param[out]	outputs:		Array of pointers to output buffers,
+ *					one for every channel
+ * @param[out]	output_size:		Number of bytes written to output,
+ *					same for all channels
+ *
+ * @return	0 if success.
+ */
+int pscm_deinterleave(void const *const input, size_t input_size, uint8_t num_ch,
+		      uint8_t pcm_bit_depth, void *const *outputs, size_t *output_size);
+
 #endif /* _PCM_STREAM_CHANNEL_MODIFIER_H_ */
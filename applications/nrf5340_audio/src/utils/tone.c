@@ -14,8 +14,8 @@
 #define FREQ_LIMIT_LOW 100
 #define FREQ_LIMIT_HIGH 10000
 
-int tone_gen(int16_t *tone, size_t *tone_size, uint16_t tone_freq_hz, uint32_t smpl_freq_hz,
-	     float amplitude)
+static int tone_params_check(void *tone, size_t *tone_size, uint16_t tone_freq_hz,
+			     uint32_t smpl_freq_hz, float amplitude)
 {
 	if (tone == NULL || tone_size == NULL) {
 		return -ENXIO;
@@ -29,6 +29,18 @@ int tone_gen(int16_t *tone, size_t *tone_size, uint16_t tone_freq_hz, uint32_t s
 		return -EPERM;
 	}
 
+	return 0;
+}
+
+int tone_gen(int16_t *tone, size_t *tone_size, uint16_t tone_freq_hz, uint32_t smpl_freq_hz,
+	     float amplitude)
+{
+	int ret = tone_params_check(tone, tone_size, tone_freq_hz, smpl_freq_hz, amplitude);
+
+	if (ret) {
+		return ret;
+	}
+
 	uint32_t samples_for_one_period = smpl_freq_hz / tone_freq_hz;
 
 	for (uint32_t i = 0; i < samples_for_one_period; i++) {
@@ -43,3 +55,57 @@ int tone_gen(int16_t *tone, size_t *tone_size, uint16_t tone_freq_hz, uint32_t s
 
 	return 0;
 }
+
+int tone_gen_ext(void *tone, size_t tone_buf_size, size_t *tone_size, uint16_t tone_freq_hz,
+		 uint32_t smpl_freq_hz, float amplitude, uint8_t pcm_bit_depth, uint8_t num_ch)
+{
+	int ret = tone_params_check(tone, tone_size, tone_freq_hz, smpl_freq_hz, amplitude);
+
+	if (ret) {
+		return ret;
+	}
+
+	if ((pcm_bit_depth != 16 && pcm_bit_depth != 24 && pcm_bit_depth != 32) || num_ch == 0 ||
+	    num_ch > TONE_MAX_CHANNELS) {
+		return -EINVAL;
+	}
+
+	uint32_t samples_for_one_period = smpl_freq_hz / tone_freq_hz;
+	size_t bytes_per_sample = (pcm_bit_depth == 16) ? sizeof(int16_t) : sizeof(int32_t);
+	size_t size = (size_t)samples_for_one_period * num_ch * bytes_per_sample;
+
+	if (size > tone_buf_size) {
+		return -ENOMEM;
+	}
+
+	/* Full scale value. Calculated in double, as INT32_MAX cannot be
+	 * represented in float without rounding up past the legal range.
+	 */
+	double scale = (double)amplitude * ((pcm_bit_depth == 16) ? INT16_MAX :
+					    (pcm_bit_depth == 24) ? ((1 << 23) - 1) : INT32_MAX);
+
+	for (uint32_t i = 0; i < samples_for_one_period; i++) {
+		float curr_val = i * 2 * PI / samples_for_one_period;
+		float32_t res = arm_sin_f32(curr_val);
+		int32_t sample = (int32_t)CLAMP(res * scale, -scale, scale);
+
+		/* Every sine value is calculated once and copied to all channels */
+		if (bytes_per_sample == sizeof(int16_t)) {
+			int16_t *frame = (int16_t *)tone + i * num_ch;
+
+			for (uint8_t ch = 0; ch < num_ch; ch++) {
+				frame[ch] = (int16_t)sample;
+			}
+		} else {
+			int32_t *frame = (int32_t *)tone + i * num_ch;
+
+			for (uint8_t ch = 0; ch < num_ch; ch++) {
+				frame[ch] = sample;
+			}
+		}
+	}
+
+	*tone_size = size;
+
+	return 0;
+}
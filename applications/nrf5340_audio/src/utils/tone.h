@@ -10,6 +10,9 @@
 #include <stdint.h>
 #include <stddef.h>
 
+/* Maximum number of channels supported by tone_gen_ext() */
+#define TONE_MAX_CHANNELS 8
+
 /**
  * @brief               Generates one full PCM period of a tone with the
  *                      given parameters.
@@ -29,4 +32,31 @@
 int tone_gen(int16_t *tone, size_t *tone_size, uint16_t tone_freq_hz, uint32_t smpl_freq_hz,
 	     float amplitude);
 
+/**
+ * @brief               Generates one full PCM period of a tone with the
+ *                      given parameters, bit depth and number of channels.
+ *
+ * @note                The same tone is written to all channels of
+ *                      the interleaved output. Samples with 24-bit
+ *                      resolution are stored in 32-bit words.
+ *
+ * @param tone          User provided buffer
+ * @param tone_buf_size Size of the user provided buffer in bytes
+ * @param tone_size     Resulting tone size in bytes
+ * @param tone_freq_hz  The desired tone frequency [100..10000] Hz
+ * @param smpl_freq_hz  Sampling frequency
+ * @param amplitude     Amplitude in the range (0..1]
+ * @param pcm_bit_depth Bit depth of PCM samples (16, 24 or 32)
+ * @param num_ch        Number of interleaved channels [1..TONE_MAX_CHANNELS]
+ *
+ * @retval 0            Tone generated
+ * @retval -ENXIO       If tone or tone_size is NULL
+ * @retval -EINVAL      If smpl_freq_hz == 0, tone_freq_hz is out of range
+ *                      or pcm_bit_depth or num_ch is invalid
+ * @retval -EPERM       If amplitude is out of range
+ * @retval -ENOMEM      If the tone does not fit in the buffer
+ */
+int tone_gen_ext(void *tone, size_t tone_buf_size, size_t *tone_size, uint16_t tone_freq_hz,
+		 uint32_t smpl_freq_hz, float amplitude, uint8_t pcm_bit_depth, uint8_t num_ch);
+
 #endif /* __TONE_H__ */
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+
+#include "hid_eventq.h"
+
+
+static struct hid_eventq_event *event_at(const struct hid_eventq *eventq, size_t pos)
+{
+	size_t idx = eventq->head + pos;
+
+	if (idx >= eventq->size) {
+		idx -= eventq->size;
+	}
+
+	return &eventq->events[idx];
+}
+
+static bool is_expired(uint32_t event_ts, uint32_t timestamp, uint32_t expiration)
+{
+	/* Signed difference handles timestamp wrap-around and events newer than
+	 * the given timestamp.
+	 */
+	return ((int32_t)(timestamp - event_ts) >= (int32_t)expiration);
+}
+
+/* Update number of presses pending for the usage of the event at the given
+ * position. The previous event of the usage must have been updated within the
+ * same scan. Events that were already removed from the queue are skipped, as
+ * their presses are not replayed. Key releases without a queued key press do
+ * not need pairing.
+ *
+ * Returns change of the number of usages with pending presses.
+ */
+static int pressed_update(const struct hid_eventq *eventq, size_t pos)
+{
+	struct hid_eventq_event *event = event_at(eventq, pos);
+	int pressed = 0;
+
+	if ((event->prev != 0) && (event->prev <= pos)) {
+		pressed = event_at(eventq, pos - event->prev)->pressed;
+	}
+
+	int prev_pressed = pressed;
+
+	if ((event->value > 0) || (pressed > 0)) {
+		pressed = CLAMP(pressed + event->value, 0, UINT8_MAX);
+	}
+
+	event->pressed = pressed;
+
+	return (pressed > 0) - (prev_pressed > 0);
+}
+
+static size_t region_purge(struct hid_eventq *eventq, size_t cnt)
+{
+	__ASSERT_NO_MSG(cnt <= eventq->len);
+
+	eventq->head = (eventq->head + cnt) % eventq->size;
+	eventq->len -= cnt;
+
+	return cnt;
+}
+
+void hid_eventq_init(struct hid_eventq *eventq, struct hid_eventq_event *events, size_t size)
+{
+	__ASSERT_NO_MSG(events);
+	__ASSERT_NO_MSG((size > 0) && (size <= HID_EVENTQ_SIZE_MAX));
+
+	eventq->events = events;
+	eventq->size = size;
+	hid_eventq_reset(eventq);
+}
+
+void hid_eventq_reset(struct hid_eventq *eventq)
+{
+	eventq->head = 0;
+	eventq->len = 0;
+}
+
+int hid_eventq_append(struct hid_eventq *eventq, uint16_t usage_id, int16_t value,
+		      uint32_t timestamp)
+{
+	if (hid_eventq_is_full(eventq)) {
+		return -ENOBUFS;
+	}
+
+	struct hid_eventq_event *event = event_at(eventq, eventq->len);
+
+	event->timestamp = timestamp;
+	event->usage_id = usage_id;
+	event->value = value;
+	event->prev = 0;
+	event->pressed = 0;
+
+	/* Link the event with the newest queued event of the same usage. */
+	for (size_t dist = 1; dist <= eventq->len; dist++) {
+		if (event_at(eventq, eventq->len - dist)->usage_id == usage_id) {
+			event->prev = dist;
+			break;
+		}
+	}
+
+	eventq->len++;
+
+	return 0;
+}
+
+int hid_eventq_get(struct hid_eventq *eventq, uint16_t *usage_id, int16_t *value)
+{
+	if (hid_eventq_is_empty(eventq)) {
+		return -ENOENT;
+	}
+
+	const struct hid_eventq_event *event = event_at(eventq, 0);
+
+	*usage_id = event->usage_id;
+	*value = event->value;
+
+	region_purge(eventq, 1);
+
+	return 0;
+}
+
+size_t hid_eventq_cleanup(struct hid_eventq *eventq, uint32_t timestamp, uint32_t expiration)
+{
+	size_t purge_cnt = 0;
+	int pending_cnt = 0;
+
+	/* Remove events up to the newest expired event that leaves no key
+	 * pressed. Once a key press is left without the key release among
+	 * expired events, no event after it can be removed.
+	 */
+	for (size_t pos = 0; pos < eventq->len; pos++) {
+		if (!is_expired(event_at(eventq, pos)->timestamp, timestamp, expiration)) {
+			break;
+		}
+
+		pending_cnt += pressed_update(eventq, pos);
+
+		if (pending_cnt == 0) {
+			purge_cnt = pos + 1;
+		}
+	}
+
+	return region_purge(eventq, purge_cnt);
+}
+
+size_t hid_eventq_purge_oldest(struct hid_eventq *eventq)
+{
+	int pending_cnt = 0;
+
+	/* Find the oldest event that leaves no key pressed. Events with the same
+	 * timestamp expire together, so also remove the following events with
+	 * the same timestamp, if possible.
+	 */
+	for (size_t pos = 0; pos < eventq->len; pos++) {
+		pending_cnt += pressed_update(eventq, pos);
+
+		if (pending_cnt == 0) {
+			uint32_t timestamp = event_at(eventq, pos)->timestamp;
+
+			return hid_eventq_cleanup(eventq, timestamp, 0);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _HID_EVENTQ_H_
+#define _HID_EVENTQ_H_
+
+/**
+ * @file
+ * @defgroup hid_eventq HID event queue
+ * @{
+ * @brief Fixed-size queue of HID key events.
+ *
+ * The queue is a ring buffer placed in a memory provided by the user, so
+ * no heap allocation is done. Every enqueued event is linked with the
+ * previous event of the same usage. The links are used to pair key presses
+ * with key releases, so that expired events can be removed from the queue
+ * in a single pass.
+ */
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Maximum number of events in a queue. */
+#define HID_EVENTQ_SIZE_MAX UINT8_MAX
+
+/** @brief Enqueued HID event. */
+struct hid_eventq_event {
+	uint32_t timestamp; /**< HID event timestamp. */
+	uint16_t usage_id; /**< HID usage ID. */
+	int16_t value; /**< HID value. */
+	uint8_t prev; /**< Distance to the previous event of this usage (0 if none). */
+	uint8_t pressed; /**< Presses of this usage pending after this event. */
+};
+
+/** @brief HID event queue. */
+struct hid_eventq {
+	struct hid_eventq_event *events; /**< Queue memory. */
+	uint8_t size; /**< Maximum number of events in the queue. */
+	uint8_t head; /**< Index of the oldest event. */
+	uint8_t len; /**< Number of enqueued events. */
+};
+
+/**
+ * @brief Initialize the HID event queue.
+ *
+ * @param eventq Pointer to the queue.
+ * @param events Memory used to store the events.
+ * @param size   Number of events that fit in the memory.
+ */
+void hid_eventq_init(struct hid_eventq *eventq, struct hid_eventq_event *events, size_t size);
+
+/**
+ * @brief Remove all events from the queue.
+ *
+ * @param eventq Pointer to the queue.
+ */
+void hid_eventq_reset(struct hid_eventq *eventq);
+
+/**
+ * @brief Check if the queue is full.
+ *
+ * @param eventq Pointer to the queue.
+ *
+ * @return True if no more events can be appended to the queue.
+ */
+static inline bool hid_eventq_is_full(const struct hid_eventq *eventq)
+{
+	return (eventq->len >= eventq->size);
+}
+
+/**
+ * @brief Check if the queue is empty.
+ *
+ * @param eventq Pointer to the queue.
+ *
+ * @return True if the queue contains no events.
+ */
+static inline bool hid_eventq_is_empty(const struct hid_eventq *eventq)
+{
+	return (eventq->len == 0);
+}
+
+/**
+ * @brief Append an event to the queue.
+ *
+ * @param eventq    Pointer to the queue.
+ * @param usage_id  HID usage ID.
+ * @param value     HID value. Positive value is a key press, negative value
+ *                  is a key release.
+ * @param timestamp Event timestamp in milliseconds.
+ *
+ * @retval 0 If the event was appended.
+ * @retval -ENOBUFS If the queue is full.
+ */
+int hid_eventq_append(struct hid_eventq *eventq, uint16_t usage_id, int16_t value,
+		      uint32_t timestamp);
+
+/**
+ * @brief Remove the oldest event from the queue.
+ *
+ * @param eventq   Pointer to the queue.
+ * @param usage_id Pointer used to store the HID usage ID of the event.
+ * @param value    Pointer used to store the HID value of the event.
+ *
+ * @retval 0 If the event was removed.
+ * @retval -ENOENT If the queue is empty.
+ */
+int hid_eventq_get(struct hid_eventq *eventq, uint16_t *usage_id, int16_t *value);
+
+/**
+ * @brief Remove expired events from the queue.
+ *
+ * Events older than the expiration time are removed only if every key press
+ * among them is paired with a key release among them. Removing them cannot
+ * leave a key pressed on the host.
+ *
+ * @param eventq     Pointer to the queue.
+ * @param timestamp  Current time in milliseconds.
+ * @param expiration Expiration time in milliseconds.
+ *
+ * @return Number of removed events.
+ */
+size_t hid_eventq_cleanup(struct hid_eventq *eventq, uint32_t timestamp, uint32_t expiration);
+
+/**
+ * @brief Remove the oldest events that can be dropped from the queue.
+ *
+ * The function removes events as if they expired, starting from the oldest
+ * one, until at least one event is removed. The queue is left untouched if
+ * no event can be dropped without leaving a key pressed on the host.
+ *
+ * @param eventq Pointer to the queue.
+ *
+ * @return Number of removed events.
+ */
+size_t hid_eventq_purge_oldest(struct hid_eventq *eventq);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*_HID_EVENTQ_H_ */
@@ -403,7 +403,7 @@ int handle_at_dfu_get(enum at_cmd_type cmd_type)
 			return err;
 		}
 		if (op == SLM_DFU_CANCEL) {
-			if (dlc.fd == -1) {
+			if (!download_client_is_connected(&dlc)) {
 				LOG_WRN("Invalid state");
 				return -EAGAIN;
 			}
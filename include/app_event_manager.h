@@ -51,6 +51,19 @@ enum app_event_type_flags {
 	APP_EVENT_TYPE_FLAGS_INIT_LOG_ENABLE =
 		APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START,
 
+#if defined(CONFIG_APP_EVENT_MANAGER_PROC_QUEUES)
+	/* Process the event in the selected dedicated processing queue.
+	 * Only flags of the configured queues are defined.
+	 */
+	APP_EVENT_TYPE_FLAGS_PROC_QUEUE_1,
+#if CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_COUNT > 1
+	APP_EVENT_TYPE_FLAGS_PROC_QUEUE_2,
+#endif
+#if CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_COUNT > 2
+	APP_EVENT_TYPE_FLAGS_PROC_QUEUE_3,
+#endif
+#endif /* CONFIG_APP_EVENT_MANAGER_PROC_QUEUES */
+
 	/* Number of predefined flags. */
 	APP_EVENT_TYPE_FLAGS_COUNT,
 
@@ -359,6 +372,19 @@ static inline size_t app_event_manager_event_size(const struct app_event_header
 	const struct {} __event_hook_postprocess_last_sub_redefined = {};  \
 	_APP_EVENT_HOOK_POSTPROCESS_REGISTER(hook_fn, _APP_EM_MARKER_FINAL_ELEMENT)
 
+/**
+ * @brief Register event hook called after a listener handles the event.
+ *
+ * The hook function should have a form
+ * `void hook(const struct app_event_header *aeh, const struct event_listener *el, uint32_t cycles)`,
+ * where `cycles` is the number of hardware cycles spent in the listener.
+ *
+ * @param hook_fn Hook function.
+ */
+#define APP_EVENT_HOOK_LISTENER_REGISTER(hook_fn)	\
+	_APP_EVENT_HOOK_LISTENER_REGISTER(hook_fn,	\
+	_APP_EM_SUBS_PRIO_ID(_APP_EM_SUBS_PRIO_NORMAL))
+
 
 /** @brief Initialize the Application Event Manager.
  *
@@ -367,6 +393,16 @@ static inline size_t app_event_manager_event_size(const struct app_event_header
  */
 int app_event_manager_init(void);
 
+/** @brief Find an event type by its name.
+ *
+ * Event types are placed by the linker in order of their names, so the lookup
+ * is done using binary search.
+ *
+ * @param name  Name of the event type.
+ * @retval Pointer to the event type if found, otherwise NULL.
+ */
+const struct event_type *app_event_manager_event_type_find(const char *name);
+
 /** @brief Allocate event.
  *
  * The behavior of this function depends on the actual implementation.
@@ -385,10 +421,26 @@ void *app_event_manager_alloc(size_t size);
  * The default implementation of this function is same as k_free.
  * It is annotated as weak and can be overridden by user.
  *
- * @param addr  Pointer to previously allocated memory.
+ * If @kconfig{CONFIG_APP_EVENT_MANAGER_SLAB_ALLOC} is enabled, the Application
+ * Event Manager calls this function only for memory returned by
+ * @ref app_event_manager_alloc and never passes events allocated from the
+ * memory slabs to it. An override must not be called directly to free an
+ * event, use @ref app_event_manager_event_free instead. The default
+ * implementation also accepts events allocated from the memory slabs.
+ *
+ * @param addr  Pointer to memory allocated by @ref app_event_manager_alloc.
  **/
 void app_event_manager_free(void *addr);
 
+/** @brief Free an event that was allocated but not submitted.
+ *
+ * Returns the event to its memory slab if it was allocated from one, otherwise
+ * passes it to @ref app_event_manager_free.
+ *
+ * @param addr  Pointer to the event.
+ **/
+void app_event_manager_event_free(void *addr);
+
 
 /** @brief Log event.
  *
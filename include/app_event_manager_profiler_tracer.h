@@ -71,6 +71,69 @@ struct nrf_profiler_info {
 	_APP_EVENT_INFO_DEFINE(ename, ENCODE(types), ENCODE(labels), profile_func)
 
 
+/** @brief Types of latency histograms.
+ */
+enum app_event_manager_hist_type {
+	/** Time between event submission and start of its processing (per event type). */
+	APP_EVENT_MANAGER_HIST_DISPATCH_LATENCY,
+
+	/** Time spent in all listeners of the event (per event type). */
+	APP_EVENT_MANAGER_HIST_PROCESSING_TIME,
+
+	/** Number of events in the processing queue on event submission (per event type). */
+	APP_EVENT_MANAGER_HIST_QUEUE_DEPTH,
+
+	/** Number of histogram types kept per event type. */
+	APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT,
+
+	/** Time spent in the listener (per listener). */
+	APP_EVENT_MANAGER_HIST_LISTENER_TIME = APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT,
+};
+
+/** @brief Read a latency histogram.
+ *
+ * Time is expressed in microseconds. Bucket 0 counts zero values and bucket n counts values
+ * from 2^(n-1) to 2^n - 1. The last bucket counts all bigger values.
+ *
+ * @param type Histogram type.
+ * @param idx Index of the event type (in the order displayed by the Application Event Manager
+ *            shell) or index of the listener for @ref APP_EVENT_MANAGER_HIST_LISTENER_TIME.
+ * @param buckets Array of CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_HIST_BUCKET_CNT elements
+ *                for the histogram buckets.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the histogram does not exist.
+ */
+int app_event_manager_profiler_tracer_hist_get(enum app_event_manager_hist_type type,
+					       size_t idx, uint32_t *buckets);
+
+/** @brief Reset all latency histograms.
+ */
+void app_event_manager_profiler_tracer_hist_reset(void);
+
+/** @brief Get size of the binary dump of latency histograms.
+ *
+ * @return Number of bytes required by @ref app_event_manager_profiler_tracer_hist_dump.
+ */
+size_t app_event_manager_profiler_tracer_hist_dump_size(void);
+
+/** @brief Dump all latency histograms as a single binary blob.
+ *
+ * The blob starts with a header that contains format version (1 byte), number of buckets
+ * (1 byte), number of histograms per event type (1 byte), reserved byte, number of event
+ * types (2 bytes) and number of listeners (2 bytes). The header is followed by histograms
+ * of all event types and histograms of all listeners. Every bucket is a 32-bit value.
+ * All multi-byte values are little-endian.
+ *
+ * @param buf Buffer for the dump.
+ * @param size Size of the buffer.
+ *
+ * @return Number of bytes written to the buffer.
+ * @retval -ENOMEM If the buffer is too small.
+ */
+int app_event_manager_profiler_tracer_hist_dump(uint8_t *buf, size_t size);
+
+
 
 #ifdef __cplusplus
 }
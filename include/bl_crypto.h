@@ -97,6 +97,53 @@ int bl_root_of_trust_verify_external(const uint8_t *public_key,
 				     const uint32_t firmware_len);
 
 
+/**
+ * @brief Verify a signature over an already computed firmware hash.
+ *
+ * Same as @ref bl_root_of_trust_verify, but takes the SHA-256 hash of the
+ * firmware instead of the firmware, so the firmware can be hashed while it is
+ * copied or received.
+ *
+ * @param[in]  public_key       Public key.
+ * @param[in]  public_key_hash  Expected hash of the public key. This is the
+ *                              root of trust.
+ * @param[in]  signature        Firmware signature.
+ * @param[in]  firmware_hash    SHA-256 hash of the firmware.
+ *
+ * @retval 0          On success.
+ * @retval -EHASHINV  If public_key_hash didn't match public_key.
+ * @retval -ESIGINV   If signature validation failed.
+ * @return Any error code from @ref bl_sha256_init, @ref bl_sha256_update,
+ *         @ref bl_sha256_finalize, or @ref bl_secp256r1_validate if something
+ *         else went wrong.
+ *
+ * @remark No parameter can be NULL.
+ */
+int bl_root_of_trust_verify_hash(const uint8_t *public_key,
+				 const uint8_t *public_key_hash,
+				 const uint8_t *signature,
+				 const uint8_t *firmware_hash);
+
+/* Typedef for selecting between the local and external implementation. */
+typedef int (*bl_root_of_trust_verify_hash_t)(
+				 const uint8_t *public_key,
+				 const uint8_t *public_key_hash,
+				 const uint8_t *signature,
+				 const uint8_t *firmware_hash);
+
+
+/**
+ * @brief Implementation of rot_verify_hash that is safe to be called from
+ *        EXT_API.
+ *
+ * See @ref bl_root_of_trust_verify_hash for docs.
+ */
+int bl_root_of_trust_verify_hash_external(const uint8_t *public_key,
+					  const uint8_t *public_key_hash,
+					  const uint8_t *signature,
+					  const uint8_t *firmware_hash);
+
+
 /**
  * @brief Initialize a sha256 operation context variable.
  *
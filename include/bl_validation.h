@@ -13,6 +13,7 @@ extern "C" {
 
 #include <stdbool.h>
 #include <fw_info.h>
+#include <bl_crypto.h>
 #include <zephyr/types.h>
 
 /** @defgroup bl_validation Bootloader firmware validation
@@ -58,6 +59,78 @@ bool bl_validate_firmware_local(uint32_t fw_address,
 				const struct fw_info *fwinfo);
 
 
+/** Context for validating firmware while it is being written.
+ *
+ * @note The members are internal to the bl_validation module.
+ */
+struct bl_validate_fw_stream {
+	bl_sha256_ctx_t ctx;
+	uint32_t fw_address;
+	uint32_t fw_size;
+	uint32_t hashed;
+};
+
+/** Start validating firmware that is written in chunks.
+ *
+ * @details Use this together with @ref bl_validate_firmware_stream_update and
+ *          @ref bl_validate_firmware_stream_finish to hash the firmware while
+ *          it is copied or received, instead of in a separate pass over the
+ *          written firmware. The nRF5340 network core bootloader sample
+ *          uses them when it copies an update with @ref pcd_fw_copy_cb.
+ *
+ * @note This function is only available to the bootloader.
+ *
+ * @param[out] stream      Validation context.
+ * @param[in]  fw_address  Address where the firmware is written.
+ * @param[in]  fw_size     Size of the signed part of the firmware, that is
+ *                         the @c size field of its firmware info.
+ *
+ * @retval 0        On success.
+ * @retval -EINVAL  If @p stream is NULL or @p fw_size is 0.
+ * @return Any error code from @ref bl_crypto_init or @ref bl_sha256_init.
+ */
+int bl_validate_firmware_stream_init(struct bl_validate_fw_stream *stream,
+				     uint32_t fw_address, uint32_t fw_size);
+
+/** Hash the next chunk of the firmware.
+ *
+ * @details Chunks must be passed in order, starting at @c fw_address. Bytes
+ *          beyond @c fw_size, like the validation info, are not hashed.
+ *
+ * @warning Pass the chunk as read back from @c fw_address after it has been
+ *          written, not the source buffer. The finish function does not read
+ *          the firmware again, so a chunk that was not written correctly is
+ *          only detected if the read-back data is hashed.
+ *
+ * @note This function is only available to the bootloader.
+ *
+ * @param[in,out] stream  Validation context.
+ * @param[in]     data    Chunk of the firmware.
+ * @param[in]     len     Length of the chunk.
+ *
+ * @retval 0  On success.
+ * @return Any error code from @ref bl_sha256_update.
+ */
+int bl_validate_firmware_stream_update(struct bl_validate_fw_stream *stream,
+				       const uint8_t *data, uint32_t len);
+
+/** Validate the written firmware using the streamed hash.
+ *
+ * @details Runs the same checks as @ref bl_validate_firmware_local on the
+ *          firmware at @c fw_address, but the hash or signature is checked
+ *          against the hash of the streamed chunks. The firmware itself is not
+ *          hashed again.
+ *
+ * @note This function is only available to the bootloader.
+ *
+ * @param[in,out] stream  Validation context.
+ *
+ * @retval  true   if the image is valid
+ * @retval  false  if the image is invalid or not all of it was streamed
+ */
+bool bl_validate_firmware_stream_finish(struct bl_validate_fw_stream *stream);
+
+
 /**
  * @brief Structure describing the BL_VALIDATE_FW EXT_API.
  */
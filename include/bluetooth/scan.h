@@ -473,6 +473,25 @@ void bt_scan_filter_disable(void);
  */
 int bt_scan_filter_status_get(struct bt_filter_status *status);
 
+/**@brief Function for getting the number of matches of a filter.
+ *
+ * @details The hit counter is incremented every time the filter matches
+ *          the scanned device, regardless of the filter mode. Devices
+ *          on the blocklist are not counted. The counter is reset when
+ *          a new filter is added in place of a removed one.
+ *
+ * @param[in] type Filter type.
+ * @param[in] idx Filter index. Filters of a given type are indexed
+ *                in the order in which they were added.
+ * @param[out] hit_cnt Number of matches.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL If the type is invalid or @p hit_cnt is NULL.
+ * @retval -ENOENT If there is no filter with the given index.
+ */
+int bt_scan_filter_hit_cnt_get(enum bt_scan_filter_type type, uint8_t idx,
+			       uint32_t *hit_cnt);
+
 /**@brief Function for adding any type of filter to the scanning.
  *
  * @details This function adds a new filter by type.
@@ -28,6 +28,14 @@ extern "C" {
  * The modem library must be initialized in DFU mode before calling this
  * function.
  *
+ * If @kconfig{CONFIG_FMFU_FDEV_PIPELINE} is enabled, the buffer is split in
+ * two halves, so that one half can be read from the flash device while the
+ * other is written to the modem.
+ *
+ * If @kconfig{CONFIG_FMFU_FDEV_SAVE_PROGRESS} is enabled and an earlier call
+ * for the same update was interrupted, the firmware segments that were
+ * already written are skipped.
+ *
  * @param[in] buf Pointer to buffer used to read data from external flash.
  * @param[in] buf_len Length of provided buffer.
  * @param[in] fdev Flash device to read modem firmware from.
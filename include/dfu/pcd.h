@@ -24,6 +24,7 @@
 #define PCD_H__
 
 #include <zephyr/device.h>
+#include <zephyr/storage/stream_flash.h>
 #include <sys/types.h>
 
 #ifdef __cplusplus
@@ -123,6 +124,20 @@ const void *pcd_cmd_data_ptr_get(void);
  */
 int pcd_fw_copy(const struct device *fdev);
 
+/** @brief Perform the DFU image transfer, and pass the written data to a
+ *         callback.
+ *
+ * Works like @ref pcd_fw_copy, but each buffer of the DFU image is read back
+ * from flash after it is written and passed to @p cb, in order. See
+ * @ref stream_flash_init. If @p cb returns an error, the transfer is stopped.
+ *
+ * @param fdev The flash device to transfer the DFU image to.
+ * @param cb   Callback for the written data, or NULL.
+ *
+ * @retval non-negative integer on success, negative errno code on failure.
+ */
+int pcd_fw_copy_cb(const struct device *fdev, stream_flash_callback_t cb);
+
 #endif /* PCD_H__ */
 
 /**@} */
@@ -34,6 +34,25 @@
 #define EVENT_MANAGER_PROXY_SUBSCRIBE(instance, ename) \
 	event_manager_proxy_subscribe((instance), _EVENT_ID(ename), STRINGIFY(ename))
 
+/**
+ * @brief Initialize an element of the subscription array.
+ *
+ * @param ename Name of the event. The event name has to be the same on remote and local cores.
+ */
+#define EVENT_MANAGER_PROXY_SUBSCRIPTION(ename) \
+	{ .local_event_id = _EVENT_ID(ename), .remote_event_name = STRINGIFY(ename) }
+
+/**
+ * @brief Subscription for the remote event.
+ */
+struct event_manager_proxy_subscription {
+	/** The id of the event we wish to receive for the event on the remote core. */
+	const struct event_type *local_event_id;
+
+	/** The name of the event to register. */
+	const char *remote_event_name;
+};
+
 /**
  * @brief Add remote core communication channel.
  *
@@ -82,6 +101,28 @@ int event_manager_proxy_subscribe(
 	const struct event_type *local_event_id,
 	const char *remote_event_name);
 
+/**
+ * @brief Subscribe for multiple remote events.
+ *
+ * This function works like @ref event_manager_proxy_subscribe, but the subscriptions
+ * are sent to the remote using as few IPC messages as possible.
+ *
+ * @param instance Remote IPC instance.
+ * @param subs     Array of subscriptions.
+ *                 Use @ref EVENT_MANAGER_PROXY_SUBSCRIPTION to initialize the elements.
+ * @param cnt      Number of elements in the @p subs array.
+ *
+ * @retval 0 On success.
+ * @retval -EPIPE  The remote core did not bonded in during timeout period. No communication.
+ * @retval -ENOMEM The event name does not fit in the command buffer.
+ *                 See @kconfig{CONFIG_EVENT_MANAGER_PROXY_SUBSCRIBE_BULK_BUF_SIZE}.
+ * @retval other errno code.
+ */
+int event_manager_proxy_subscribe_bulk(
+	const struct device *instance,
+	const struct event_manager_proxy_subscription *subs,
+	size_t cnt);
+
 /**
  * @brief Start events transfer.
  *
@@ -114,5 +155,20 @@ int event_manager_proxy_start(void);
  */
 int event_manager_proxy_wait_for_remotes(k_timeout_t timeout);
 
+/**
+ * @brief Send the events waiting in the batch buffers to all the remote cores.
+ *
+ * The events are sent without waiting for the flush delay.
+ * If @kconfig{CONFIG_EVENT_MANAGER_PROXY_BATCH} is disabled, the events are
+ * never buffered and the function does nothing.
+ *
+ * If a batch cannot be sent, its events are kept and sent with the next flush.
+ * The batches of the other remote cores are flushed anyway.
+ *
+ * @retval 0 On success.
+ * @retval other errno code of the first batch that could not be sent.
+ */
+int event_manager_proxy_flush(void);
+
 /** @} */
 #endif /* _EVENT_MANAGER_PROXY_H_ */
@@ -117,6 +117,16 @@ static inline void at_monitor_resume(struct at_monitor_entry *mon)
 	mon->flags.paused = false;
 }
 
+/**
+ * @brief Get the number of dropped notifications.
+ *
+ * A notification is dropped when there is no space to copy it
+ * on the AT monitor library heap.
+ *
+ * @return Number of notifications dropped since boot.
+ */
+uint32_t at_monitor_drop_count_get(void);
+
 /** @} */
 
 #ifdef __cplusplus
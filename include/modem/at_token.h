@@ -0,0 +1,244 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#ifndef AT_TOKEN_H__
+#define AT_TOKEN_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <zephyr/types.h>
+
+#include <modem/at_params.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file at_token.h
+ *
+ * @defgroup at_token AT response tokenizer
+ * @ingroup at_cmd_parser
+ * @{
+ * @brief Tokenize AT responses and notifications in place.
+ *
+ * The tokenizer reads the parameters of an AT response or notification
+ * directly from the response string, without copying them. Parameters are
+ * returned as views into the response string, which must remain valid and
+ * unchanged while the cursor is in use. No heap memory is used.
+ *
+ * Parameters are indexed in the same way as with the AT command parser:
+ * the notification ID (for example, +CEREG) is the parameter at index 0.
+ * Reading parameters in increasing index order scans the response once.
+ * Reading the same parameter again does not scan the response. Reading a
+ * parameter located before the previously read parameter restarts the scan
+ * from the beginning of the response.
+ */
+
+/** @brief Parameter of an AT response, pointing into the response string. */
+struct at_token {
+	/** Parameter type. */
+	enum at_param_type type;
+	/** Start of the parameter, without the quotes or parentheses.
+	 *  The parameter is not null-terminated.
+	 */
+	const char *str;
+	/** Length of the parameter. */
+	size_t len;
+};
+
+/** @brief Cursor over the parameters of an AT response or notification. */
+struct at_token_cursor {
+	/** Response string. */
+	const char *str;
+	/** Position of the next parameter in the response string. */
+	const char *pos;
+	/** Index of the next parameter. */
+	size_t index;
+	/** Last parameter read, at index - 1. */
+	struct at_token last;
+	/** Internal state of the cursor. */
+	uint8_t state;
+};
+
+/**
+ * @brief Initialize a cursor over the parameters of an AT response.
+ *
+ * The cursor stops at the end of the first response or notification in
+ * @p str. Final result codes (OK, ERROR, +CME ERROR, +CMS ERROR) and
+ * following notifications are not part of the response.
+ *
+ * @param cursor Cursor to initialize.
+ * @param str    AT response or notification as a null-terminated string.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -EINVAL One or more of the supplied parameters are invalid.
+ */
+int at_token_cursor_init(struct at_token_cursor *cursor, const char *str);
+
+/**
+ * @brief Get the next parameter of the AT response.
+ *
+ * @param cursor Cursor.
+ * @param token  Parameter read from the response.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT  There are no more parameters in the response.
+ * @retval -EBADMSG The response is malformed.
+ * @retval -EINVAL  One or more of the supplied parameters are invalid.
+ */
+int at_token_next(struct at_token_cursor *cursor, struct at_token *token);
+
+/**
+ * @brief Get the parameter at the given index of the AT response.
+ *
+ * @param cursor Cursor.
+ * @param index  Parameter index.
+ * @param token  Parameter read from the response.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT  The response has no parameter at @p index.
+ * @retval -EBADMSG The response is malformed.
+ * @retval -EINVAL  One or more of the supplied parameters are invalid.
+ */
+int at_token_get(struct at_token_cursor *cursor, size_t index, struct at_token *token);
+
+/**
+ * @brief Get the number of parameters in the AT response.
+ *
+ * The position of the cursor is not changed.
+ *
+ * Empty parameters are counted, including the one that follows a separator
+ * at the end of a line, as at_params_valid_count_get() counts the parameters
+ * stored with the AT_PARAM_TYPE_EMPTY type. A count greater than an index
+ * does not mean that the parameter at that index has a value. Use
+ * at_token_type_get() to check that a given parameter is not empty.
+ *
+ * @param cursor Cursor.
+ *
+ * @return Number of parameters, including the notification ID.
+ */
+size_t at_token_count_get(const struct at_token_cursor *cursor);
+
+/**
+ * @brief Get the type of the parameter at the given index.
+ *
+ * @param cursor Cursor.
+ * @param index  Parameter index.
+ *
+ * @return Parameter type, or AT_PARAM_TYPE_INVALID if there is no parameter
+ *         at @p index.
+ */
+enum at_param_type at_token_type_get(struct at_token_cursor *cursor, size_t index);
+
+/**
+ * @brief Get a signed 16-bit integer parameter.
+ *
+ * @param cursor Cursor.
+ * @param index  Parameter index.
+ * @param value  Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT The response has no parameter at @p index.
+ * @retval -EINVAL The parameter is not an integer or is out of range.
+ */
+int at_token_short_get(struct at_token_cursor *cursor, size_t index, int16_t *value);
+
+/**
+ * @brief Get an unsigned 16-bit integer parameter.
+ *
+ * @param cursor Cursor.
+ * @param index  Parameter index.
+ * @param value  Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT The response has no parameter at @p index.
+ * @retval -EINVAL The parameter is not an integer or is out of range.
+ */
+int at_token_unsigned_short_get(struct at_token_cursor *cursor, size_t index, uint16_t *value);
+
+/**
+ * @brief Get a signed 32-bit integer parameter.
+ *
+ * @param cursor Cursor.
+ * @param index  Parameter index.
+ * @param value  Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT The response has no parameter at @p index.
+ * @retval -EINVAL The parameter is not an integer or is out of range.
+ */
+int at_token_int_get(struct at_token_cursor *cursor, size_t index, int32_t *value);
+
+/**
+ * @brief Get a signed 64-bit integer parameter.
+ *
+ * @param cursor Cursor.
+ * @param index  Parameter index.
+ * @param value  Parsed value.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT The response has no parameter at @p index.
+ * @retval -EINVAL The parameter is not an integer or is out of range.
+ */
+int at_token_int64_get(struct at_token_cursor *cursor, size_t index, int64_t *value);
+
+/**
+ * @brief Get a string parameter without copying it.
+ *
+ * @param cursor Cursor.
+ * @param index  Parameter index.
+ * @param str    Start of the string in the response. Not null-terminated.
+ * @param len    Length of the string.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT The response has no parameter at @p index.
+ * @retval -EINVAL The parameter is not a string.
+ */
+int at_token_string_ptr_get(struct at_token_cursor *cursor, size_t index,
+			    const char **str, size_t *len);
+
+/**
+ * @brief Copy a string parameter into a buffer.
+ *
+ * The string is null-terminated.
+ *
+ * @param cursor Cursor.
+ * @param index  Parameter index.
+ * @param value  Buffer to copy the string into.
+ * @param len    Size of @p value as input, length of the string as output,
+ *               excluding the null terminator.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT The response has no parameter at @p index.
+ * @retval -EINVAL The parameter is not a string.
+ * @retval -ENOMEM The buffer is too small for the string.
+ */
+int at_token_string_get(struct at_token_cursor *cursor, size_t index, char *value, size_t *len);
+
+/**
+ * @brief Get an array parameter, for example (1,2,3).
+ *
+ * @param cursor Cursor.
+ * @param index  Parameter index.
+ * @param array  Array to store the values into.
+ * @param len    Size of @p array in bytes as input, size of the parsed
+ *               values in bytes as output.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT The response has no parameter at @p index.
+ * @retval -EINVAL The parameter is not an array.
+ * @retval -ENOMEM @p array is too small for all the values.
+ */
+int at_token_array_get(struct at_token_cursor *cursor, size_t index,
+		       uint32_t *array, size_t *len);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AT_TOKEN_H__ */
@@ -28,6 +28,12 @@
 extern "C" {
 #endif
 
+#if defined(CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW)
+#define DOWNLOAD_CLIENT_COAP_WINDOW CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW
+#else
+#define DOWNLOAD_CLIENT_COAP_WINDOW 1
+#endif
+
 /**
  * @brief Download client event IDs.
  */
@@ -121,23 +127,71 @@ typedef int (*download_client_callback_t)(
 	const struct download_client_evt *event);
 
 /**
- * @brief Download client instance.
+ * @brief Download client connection to the server.
  */
-struct download_client {
+struct download_client_conn {
 	/** Socket descriptor. */
 	int fd;
 
-	/** Destination address storage */
-	struct sockaddr remote_addr;
-
 	/** Response buffer. */
 	char buf[CONFIG_DOWNLOAD_CLIENT_BUF_SIZE];
 	/** Buffer offset. */
 	size_t offset;
 
+	struct {
+		/** Whether the HTTP header for
+		 * the current response has been processed.
+		 */
+		bool has_header;
+		/** The server has closed the connection. */
+		bool connection_close;
+		/** Number of requests sent and not fully received. */
+		uint8_t pending;
+		/** Offset in the file of the payload in the buffer. */
+		size_t pos;
+		/** Payload bytes of the current response
+		 * not yet handed to the application.
+		 */
+		size_t body_left;
+	} http;
+};
+
+/**
+ * @brief Block requested with CoAP block-wise transfer.
+ */
+struct download_client_coap_block {
+	/** Retransmission state of the request. */
+	struct coap_pending pending;
+	/** Token of the request. */
+	uint8_t token[8];
+	/** Offset of the block in the file. */
+	size_t offset;
+	/** Payload length, when the block is received out of order. */
+	uint16_t len;
+	/** Block size exponent (SZX). */
+	uint8_t szx;
+	/** Buffer holding the payload, when received out of order. */
+	uint8_t store;
+	/** Request state. */
+	uint8_t state;
+};
+
+/**
+ * @brief Download client instance.
+ */
+struct download_client {
+	/** Connections to the server.
+	 * HTTP range requests are spread over all connections,
+	 * other downloads use the first connection only.
+	 */
+	struct download_client_conn conn[CONFIG_DOWNLOAD_CLIENT_HTTP_CONNECTIONS];
+
+	/** Destination address storage */
+	struct sockaddr remote_addr;
+
 	/** Size of the file being downloaded, in bytes. */
 	size_t file_size;
-	/** Download progress, number of bytes downloaded. */
+	/** Download progress, number of bytes handed to the application. */
 	size_t progress;
 
 	/** Server hosting the file, null-terminated. */
@@ -151,20 +205,26 @@ struct download_client {
 	int proto;
 
 	struct  {
-		/** Whether the HTTP header for
-		 * the current fragment has been processed.
-		 */
-		bool has_header;
-		/** The server has closed the connection. */
-		bool connection_close;
+		/** Offset in the file of the next range to request. */
+		size_t next_range;
 	} http;
 
 	struct {
-		/** CoAP block context. */
-		struct coap_block_context block_ctx;
-
-		/** CoAP pending object. */
-		struct coap_pending pending;
+		/** Blocks requested and not yet handed to the application. */
+		struct download_client_coap_block block[DOWNLOAD_CLIENT_COAP_WINDOW];
+#if DOWNLOAD_CLIENT_COAP_WINDOW > 1
+		/** Payload of the blocks received out of order. */
+		uint8_t store[DOWNLOAD_CLIENT_COAP_WINDOW - 1]
+			     [16 << CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE];
+#endif
+		/** Offset in the file of the next block to request. */
+		size_t next_block;
+		/** Block size exponent (SZX) of the next block to request. */
+		uint8_t szx;
+		/** Largest block size exponent supported by the server. */
+		uint8_t szx_max;
+		/** Number of blocks received without retransmission. */
+		uint8_t streak;
 	} coap;
 
 	/** Internal thread ID. */
@@ -252,6 +312,16 @@ void download_client_resume(struct download_client *client);
  */
 int download_client_file_size_get(struct download_client *client, size_t *size);
 
+/**
+ * @brief Check whether the client is connected to the server.
+ *
+ * @param[in] client	Client instance.
+ *
+ * @retval true  The client is connected.
+ * @retval false The client is not connected, or @p client is NULL.
+ */
+bool download_client_is_connected(const struct download_client *client);
+
 /**
  * @brief Disconnect from the server.
  *
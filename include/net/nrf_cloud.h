@@ -876,6 +876,55 @@ bool nrf_cloud_fota_is_type_enabled(const enum nrf_cloud_fota_type type);
  */
 int nrf_cloud_gnss_msg_json_encode(const struct nrf_cloud_gnss_data * const gnss,
 				   cJSON * const gnss_msg_obj);
+
+/**
+ * @brief Encode GNSS location data as an nRF Cloud device message into the
+ *        provided buffer, without allocating memory.
+ *
+ * The output is the same as the one of @ref nrf_cloud_gnss_msg_json_encode,
+ * printed unformatted.
+ *
+ * @param[in]  gnss    GNSS data to encode.
+ * @param[out] buf     Buffer for the NULL-terminated message, or NULL to only
+ *                     compute the length of the message.
+ * @param[in]  buf_len Size of the buffer.
+ *
+ * @return Length of the message, not including the terminating NULL character,
+ *         if successful.
+ *         Otherwise, a (negative) error code is returned:
+ *         -ENOMEM if the buffer is too small.
+ *         -EINVAL if NMEA data is missing.
+ *         -EFBIG if the NMEA sentence is too long.
+ *         -EFTYPE if the GNSS data type is not supported.
+ */
+int nrf_cloud_gnss_msg_json_encode_buf(const struct nrf_cloud_gnss_data * const gnss,
+				       char *buf, size_t buf_len);
+
+/** Maximum size of a GNSS device message encoded as CBOR. */
+#define NRF_CLOUD_GNSS_CBOR_MSG_SIZE_MAX 128
+
+/**
+ * @brief Encode GNSS location data as a CBOR nRF Cloud device message.
+ *
+ * The message is described by the CDDL schema in
+ * subsys/net/lib/nrf_cloud/cddl/nrf_cloud_msg.cddl.
+ * It is at most @ref NRF_CLOUD_GNSS_CBOR_MSG_SIZE_MAX bytes long.
+ * Requires CONFIG_NRF_CLOUD_CBOR.
+ *
+ * @param[in]  gnss    GNSS data to encode.
+ * @param[out] buf     Output buffer.
+ * @param[in]  buf_len Size of the output buffer.
+ * @param[out] out_len Length of the encoded message.
+ *
+ * @retval 0 If successful.
+ *         Otherwise, a (negative) error code is returned:
+ *         -ENOMEM if the buffer is too small.
+ *         -EINVAL if NMEA data is missing.
+ *         -EFBIG if the NMEA sentence is too long.
+ *         -EFTYPE if the GNSS data type is not supported.
+ */
+int nrf_cloud_gnss_msg_cbor_encode(const struct nrf_cloud_gnss_data * const gnss,
+				   uint8_t *buf, size_t buf_len, size_t *out_len);
 /** @} */
 
 #ifdef __cplusplus
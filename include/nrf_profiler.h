@@ -311,6 +311,44 @@ static inline void nrf_profiler_log_send(struct log_event_buf *buf,
 #endif
 
 
+#ifdef CONFIG_NRF_PROFILER_STREAM
+/** @brief Initialize the stream sink.
+ *
+ * Called by the stream backend from @ref nrf_profiler_init. The function is
+ * provided by the selected sink. If CONFIG_NRF_PROFILER_STREAM_SINK_CUSTOM is
+ * selected, the application must implement it.
+ *
+ * @retval 0 If the operation was successful.
+ * @return Other negative error code in case of failure.
+ */
+int nrf_profiler_stream_sink_init(void);
+
+/** @brief Write encoded frames to the stream sink.
+ *
+ * Called only from the stream thread. The function may block until the data
+ * is passed to the transport.
+ *
+ * @param data Pointer to the encoded frames.
+ * @param len Number of bytes to write.
+ *
+ * @retval 0 If the operation was successful.
+ * @return Other negative error code in case of failure.
+ */
+int nrf_profiler_stream_sink_write(const uint8_t *data, size_t len);
+
+/** @brief Read a single command byte sent by the host.
+ *
+ * Called only from the stream thread. The function must not block.
+ *
+ * @param cmd Pointer to the location where the command is stored.
+ *
+ * @retval 0 If a command was read.
+ * @retval -EAGAIN If no command is available.
+ */
+int nrf_profiler_stream_sink_read_cmd(uint8_t *cmd);
+#endif /* CONFIG_NRF_PROFILER_STREAM */
+
+
 /**
  * @}
  */
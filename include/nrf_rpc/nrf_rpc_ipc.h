@@ -9,6 +9,7 @@
 
 #include <zephyr/device.h>
 #include <zephyr/ipc/ipc_service.h>
+#include <zephyr/sys/slist.h>
 
 #include <nrf_rpc.h>
 #include <nrf_rpc_tr.h>
@@ -56,6 +57,19 @@ struct nrf_rpc_ipc {
 	/** User context. */
 	void *context;
 
+	/** Maximum size of a Tx buffer in the IPC Service shared memory, or 0 if
+	 *  Tx buffers are allocated on the heap.
+	 */
+	int tx_buf_size;
+
+	/** Tx buffers allocated on the heap, because they did not fit in the
+	 *  IPC Service shared memory.
+	 */
+	sys_slist_t heap_bufs;
+
+	/** Protects @p heap_bufs. */
+	struct k_spinlock heap_bufs_lock;
+
 	/** Indicates if transport is already initialized. */
 	bool used;
 };
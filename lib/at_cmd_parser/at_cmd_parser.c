@@ -17,13 +17,6 @@
 
 #define AT_CMD_MAX_ARRAY_SIZE 32
 
-#define AT_CMD_CGEV_LEN         5
-#define AT_CMD_CPIN_LEN         5
-#define AT_CMD_SHORTSWVER_LEN   11
-#define AT_CMD_HWVERSION_LEN    10
-#define AT_CMD_XMODEMUUID_LEN   11
-#define AT_CMD_XICCID_LEN       7
-
 enum at_parser_state {
 	IDLE,
 	ARRAY,
@@ -64,42 +57,6 @@ static inline void skip_command_prefix(const char **cmd)
 	(*cmd)++;
 }
 
-static inline bool check_response_for_forced_string(const char *tmpstr)
-{
-	bool retval = false;
-
-	if (!strncmp(tmpstr, "+CGEV", AT_CMD_CGEV_LEN) ||
-	    !strncmp(tmpstr, "+CPIN", AT_CMD_CPIN_LEN) ||
-	    !strncmp(tmpstr, "%SHORTSWVER", AT_CMD_SHORTSWVER_LEN) ||
-	    !strncmp(tmpstr, "%HWVERSION", AT_CMD_HWVERSION_LEN) ||
-	    !strncmp(tmpstr, "%XMODEMUUID", AT_CMD_XMODEMUUID_LEN) ||
-	    !strncmp(tmpstr, "%XICCID", AT_CMD_XICCID_LEN)) {
-			retval = true;
-	}
-
-	return retval;
-}
-
-static bool is_result(const char *str)
-{
-	int diff;
-	static const char * const toclip[] = {
-		"OK\r\n",
-		"ERROR\r\n",
-		"+CME ERROR",
-		"+CMS ERROR"
-	};
-
-	for (size_t i = 0; i < ARRAY_SIZE(toclip); i++) {
-		diff = strncmp(str, toclip[i], strlen(toclip[i]));
-		if (!diff) {
-			return true;
-		}
-	}
-
-	return false;
-}
-
 static int at_parse_detect_type(const char **str, int index)
 {
 	const char *tmpstr = *str;
@@ -111,7 +68,7 @@ static int at_parse_detect_type(const char **str, int index)
 		set_new_state(NOTIFICATION);
 
 		/* Check for responses we know need to be strings */
-		set_type_string = check_response_for_forced_string(tmpstr);
+		set_type_string = is_forced_string(tmpstr);
 
 	} else if (set_type_string) {
 		set_new_state(STRING);
@@ -0,0 +1,529 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/types.h>
+
+#include <modem/at_token.h>
+#include "at_utils.h"
+
+enum at_token_state {
+	/* Notification ID, such as +CEREG. */
+	TOKEN_PREFIX,
+	/* Remainder of the line as a single string. */
+	TOKEN_LINE,
+	/* Comma-separated parameter. */
+	TOKEN_PARAM,
+	/* End of the response. */
+	TOKEN_END,
+};
+
+static inline bool is_line_end(char chr)
+{
+	return is_lfcr(chr) || is_terminated(chr);
+}
+
+static inline bool is_space(char chr)
+{
+	return (chr == ' ') || (chr == '\t');
+}
+
+static const char *skip_space(const char *str)
+{
+	while (is_space(*str)) {
+		str++;
+	}
+
+	return str;
+}
+
+static bool is_int(const char *str, size_t len)
+{
+	size_t i = 0;
+
+	if ((len > 0) && ((str[0] == '-') || (str[0] == '+'))) {
+		i++;
+	}
+
+	if (i == len) {
+		return false;
+	}
+
+	for (; i < len; i++) {
+		if (!isdigit((int)str[i])) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void cursor_rewind(struct at_token_cursor *cursor)
+{
+	const char *str = cursor->str;
+
+	while (isspace((int)*str)) {
+		str++;
+	}
+
+	cursor->pos = str;
+	cursor->index = 0;
+
+	if (is_terminated(*str)) {
+		cursor->state = TOKEN_END;
+	} else if (is_notification(*str)) {
+		cursor->state = TOKEN_PREFIX;
+	} else {
+		/* A response without a notification ID, such as the response
+		 * to AT+CGMR, is a single string parameter.
+		 */
+		cursor->state = TOKEN_LINE;
+	}
+}
+
+/* Decide what follows the end of a line. The response ends at the end of the
+ * string, at a result code or at the next notification. Otherwise, the next
+ * line belongs to the response, like the PDU of a +CMT notification, and is
+ * read as a single string parameter.
+ */
+static void line_end_handle(struct at_token_cursor *cursor)
+{
+	const char *str = cursor->pos;
+
+	while (is_lfcr(*str)) {
+		str++;
+	}
+
+	cursor->pos = str;
+
+	if (is_terminated(*str) || is_notification(*str) || is_result(str)) {
+		cursor->state = TOKEN_END;
+	} else {
+		cursor->state = TOKEN_LINE;
+	}
+}
+
+static void prefix_read(struct at_token_cursor *cursor, struct at_token *token)
+{
+	const char *str = cursor->pos;
+	bool forced_string = is_forced_string(str);
+
+	token->type = AT_PARAM_TYPE_STRING;
+	token->str = str++;
+
+	while (is_valid_notification_char(*str)) {
+		str++;
+	}
+
+	token->len = str - token->str;
+
+	if (*str == AT_RSP_SEPARATOR) {
+		str++;
+	}
+
+	cursor->pos = skip_space(str);
+
+	if (is_line_end(*cursor->pos)) {
+		line_end_handle(cursor);
+	} else {
+		cursor->state = forced_string ? TOKEN_LINE : TOKEN_PARAM;
+	}
+}
+
+static void line_read(struct at_token_cursor *cursor, struct at_token *token)
+{
+	const char *str = cursor->pos;
+
+	while (!is_line_end(*str)) {
+		str++;
+	}
+
+	token->type = AT_PARAM_TYPE_STRING;
+	token->str = cursor->pos;
+	token->len = str - cursor->pos;
+
+	cursor->pos = str;
+	line_end_handle(cursor);
+}
+
+static int param_read(struct at_token_cursor *cursor, struct at_token *token)
+{
+	const char *str = skip_space(cursor->pos);
+
+	if (is_dblquote(*str)) {
+		token->type = AT_PARAM_TYPE_STRING;
+		token->str = ++str;
+
+		while (!is_dblquote(*str) && !is_terminated(*str)) {
+			str++;
+		}
+
+		token->len = str - token->str;
+
+		if (is_dblquote(*str)) {
+			str++;
+		}
+	} else if (is_array_start(*str)) {
+		token->type = AT_PARAM_TYPE_ARRAY;
+		token->str = ++str;
+
+		while (!is_array_stop(*str) && !is_terminated(*str)) {
+			str++;
+		}
+
+		token->len = str - token->str;
+
+		if (is_array_stop(*str)) {
+			str++;
+		}
+	} else if (is_separator(*str) || is_line_end(*str)) {
+		token->type = AT_PARAM_TYPE_EMPTY;
+		token->str = str;
+		token->len = 0;
+	} else {
+		token->str = str;
+
+		/* Like the AT command parser, any separator ends an unquoted
+		 * parameter, so that the index of the parameters is the same.
+		 * For example, %XT3412: 360 is read as %XT, 3412 and 360.
+		 */
+		while (!is_separator(*str) && !is_line_end(*str)) {
+			str++;
+		}
+
+		token->len = str - token->str;
+
+		while ((token->len > 0) && is_space(token->str[token->len - 1])) {
+			token->len--;
+		}
+
+		token->type = is_int(token->str, token->len) ? AT_PARAM_TYPE_NUM_INT :
+							       AT_PARAM_TYPE_STRING;
+	}
+
+	str = skip_space(str);
+	cursor->pos = str;
+
+	if (is_separator(*str)) {
+		/* A separator at the end of the line is followed by an empty
+		 * parameter, which is read in the same state.
+		 */
+		cursor->pos++;
+	} else if (is_line_end(*str)) {
+		line_end_handle(cursor);
+	} else {
+		cursor->state = TOKEN_END;
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+int at_token_cursor_init(struct at_token_cursor *cursor, const char *str)
+{
+	if ((cursor == NULL) || (str == NULL)) {
+		return -EINVAL;
+	}
+
+	cursor->str = str;
+	cursor_rewind(cursor);
+
+	return 0;
+}
+
+int at_token_next(struct at_token_cursor *cursor, struct at_token *token)
+{
+	int err = 0;
+
+	if ((cursor == NULL) || (cursor->str == NULL) || (token == NULL)) {
+		return -EINVAL;
+	}
+
+	switch (cursor->state) {
+	case TOKEN_PREFIX:
+		prefix_read(cursor, token);
+		break;
+	case TOKEN_LINE:
+		line_read(cursor, token);
+		break;
+	case TOKEN_PARAM:
+		err = param_read(cursor, token);
+		break;
+	default:
+		return -ENOENT;
+	}
+
+	if (err) {
+		return err;
+	}
+
+	cursor->last = *token;
+	cursor->index++;
+
+	return 0;
+}
+
+int at_token_get(struct at_token_cursor *cursor, size_t index, struct at_token *token)
+{
+	int err;
+
+	if ((cursor == NULL) || (cursor->str == NULL) || (token == NULL)) {
+		return -EINVAL;
+	}
+
+	if ((index + 1) == cursor->index) {
+		*token = cursor->last;
+		return 0;
+	}
+
+	if (index < cursor->index) {
+		cursor_rewind(cursor);
+	}
+
+	do {
+		err = at_token_next(cursor, token);
+		if (err) {
+			return err;
+		}
+	} while (cursor->index <= index);
+
+	return 0;
+}
+
+size_t at_token_count_get(const struct at_token_cursor *cursor)
+{
+	struct at_token_cursor tmp;
+	struct at_token token;
+
+	if ((cursor == NULL) || (cursor->str == NULL)) {
+		return 0;
+	}
+
+	tmp.str = cursor->str;
+	cursor_rewind(&tmp);
+
+	while (!at_token_next(&tmp, &token)) {
+	}
+
+	return tmp.index;
+}
+
+enum at_param_type at_token_type_get(struct at_token_cursor *cursor, size_t index)
+{
+	struct at_token token;
+
+	if (at_token_get(cursor, index, &token)) {
+		return AT_PARAM_TYPE_INVALID;
+	}
+
+	return token.type;
+}
+
+static int int_get(struct at_token_cursor *cursor, size_t index,
+		   int64_t min, int64_t max, int64_t *value)
+{
+	struct at_token token;
+	int64_t tmp;
+	int err;
+
+	err = at_token_get(cursor, index, &token);
+	if (err) {
+		return err;
+	}
+
+	if (token.type != AT_PARAM_TYPE_NUM_INT) {
+		return -EINVAL;
+	}
+
+	/* The integer is followed by a separator, white space or the end of
+	 * the string, which stop the conversion.
+	 */
+	errno = 0;
+	tmp = strtoll(token.str, NULL, 10);
+	if ((errno == ERANGE) || (tmp < min) || (tmp > max)) {
+		return -EINVAL;
+	}
+
+	*value = tmp;
+
+	return 0;
+}
+
+int at_token_short_get(struct at_token_cursor *cursor, size_t index, int16_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = int_get(cursor, index, INT16_MIN, INT16_MAX, &tmp);
+	if (err) {
+		return err;
+	}
+
+	*value = (int16_t)tmp;
+
+	return 0;
+}
+
+int at_token_unsigned_short_get(struct at_token_cursor *cursor, size_t index, uint16_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = int_get(cursor, index, 0, UINT16_MAX, &tmp);
+	if (err) {
+		return err;
+	}
+
+	*value = (uint16_t)tmp;
+
+	return 0;
+}
+
+int at_token_int_get(struct at_token_cursor *cursor, size_t index, int32_t *value)
+{
+	int64_t tmp;
+	int err;
+
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	err = int_get(cursor, index, INT32_MIN, INT32_MAX, &tmp);
+	if (err) {
+		return err;
+	}
+
+	*value = (int32_t)tmp;
+
+	return 0;
+}
+
+int at_token_int64_get(struct at_token_cursor *cursor, size_t index, int64_t *value)
+{
+	if (value == NULL) {
+		return -EINVAL;
+	}
+
+	return int_get(cursor, index, INT64_MIN, INT64_MAX, value);
+}
+
+int at_token_string_ptr_get(struct at_token_cursor *cursor, size_t index,
+			    const char **str, size_t *len)
+{
+	struct at_token token;
+	int err;
+
+	if ((str == NULL) || (len == NULL)) {
+		return -EINVAL;
+	}
+
+	err = at_token_get(cursor, index, &token);
+	if (err) {
+		return err;
+	}
+
+	if (token.type != AT_PARAM_TYPE_STRING) {
+		return -EINVAL;
+	}
+
+	*str = token.str;
+	*len = token.len;
+
+	return 0;
+}
+
+int at_token_string_get(struct at_token_cursor *cursor, size_t index, char *value, size_t *len)
+{
+	const char *str;
+	size_t str_len;
+	int err;
+
+	if ((value == NULL) || (len == NULL)) {
+		return -EINVAL;
+	}
+
+	err = at_token_string_ptr_get(cursor, index, &str, &str_len);
+	if (err) {
+		return err;
+	}
+
+	if (*len <= str_len) {
+		return -ENOMEM;
+	}
+
+	memcpy(value, str, str_len);
+	value[str_len] = '\0';
+	*len = str_len;
+
+	return 0;
+}
+
+int at_token_array_get(struct at_token_cursor *cursor, size_t index,
+		       uint32_t *array, size_t *len)
+{
+	struct at_token token;
+	const char *str;
+	const char *end;
+	size_t cnt = 0;
+	int err;
+
+	if ((array == NULL) || (len == NULL)) {
+		return -EINVAL;
+	}
+
+	err = at_token_get(cursor, index, &token);
+	if (err) {
+		return err;
+	}
+
+	if (token.type != AT_PARAM_TYPE_ARRAY) {
+		return -EINVAL;
+	}
+
+	str = token.str;
+	end = token.str + token.len;
+
+	while (str < end) {
+		char *next;
+
+		if (cnt == (*len / sizeof(uint32_t))) {
+			return -ENOMEM;
+		}
+
+		/* The array is terminated by a parenthesis, which stops the
+		 * conversion.
+		 */
+		array[cnt++] = (uint32_t)strtoul(str, &next, 10);
+
+		str = next;
+
+		while ((str < end) && (*str != AT_PARAM_SEPARATOR)) {
+			str++;
+		}
+
+		if (str < end) {
+			str++;
+		}
+	}
+
+	*len = cnt * sizeof(uint32_t);
+
+	return 0;
+}
@@ -17,8 +17,10 @@
 #define AT_UTILS_H__
 
 #include <zephyr/types.h>
+#include <zephyr/sys/util.h>
 #include <stddef.h>
 #include <ctype.h>
+#include <string.h>
 
 #define AT_PARAM_SEPARATOR ','
 #define AT_RSP_SEPARATOR ':'
@@ -272,7 +274,7 @@ static inline bool is_command(const char *str)
  * @retval true  If the string is a CLAC response
  * @retval false Otherwise
  */
-static bool is_clac(const char *str)
+static inline bool is_clac(const char *str)
 {
 	/* skip leading <CR><LF>, if any, as check not from index 0 */
 	while (is_lfcr(*str)) {
@@ -300,6 +302,67 @@ static bool is_clac(const char *str)
 
 	return true;
 }
+
+/**
+ * @brief Check if a string is the beginning of an AT result code
+ *
+ * This function will check if the string starts with a final result code,
+ * such as OK, ERROR, +CME ERROR or +CMS ERROR.
+ *
+ * @param[in] str String to examine
+ *
+ * @retval true  If the string is a result code
+ * @retval false Otherwise
+ */
+static inline bool is_result(const char *str)
+{
+	static const char * const toclip[] = {
+		"OK\r\n",
+		"ERROR\r\n",
+		"+CME ERROR",
+		"+CMS ERROR"
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(toclip); i++) {
+		if (!strncmp(str, toclip[i], strlen(toclip[i]))) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+ * @brief Check if the parameters of a response must be parsed as a string
+ *
+ * Some responses have parameters that are not quoted, but must not be
+ * parsed as numbers. The remainder of such responses is treated as a single
+ * string parameter.
+ *
+ * @param[in] str Response, starting with the notification ID
+ *
+ * @retval true  If the response parameters are a string
+ * @retval false Otherwise
+ */
+static inline bool is_forced_string(const char *str)
+{
+	static const char * const prefixes[] = {
+		"+CGEV",
+		"+CPIN",
+		"%SHORTSWVER",
+		"%HWVERSION",
+		"%XMODEMUUID",
+		"%XICCID"
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(prefixes); i++) {
+		if (!strncmp(str, prefixes[i], strlen(prefixes[i]))) {
+			return true;
+		}
+	}
+
+	return false;
+}
 /** @} */
 
 #endif /* AT_UTILS_H__ */
@@ -15,9 +15,29 @@
 
 LOG_MODULE_REGISTER(at_monitor, CONFIG_AT_MONITOR_LOG_LEVEL);
 
+/* Monitors are indexed with uint8_t in the filter automaton. If more monitors
+ * are defined, or their filters do not fit in the automaton, notifications are
+ * matched against every filter instead.
+ */
+#define MONITORS_MAX UINT8_MAX
+#define MATCH_SET_WORDS(_cnt) DIV_ROUND_UP(_cnt, 32)
+
+BUILD_ASSERT(CONFIG_AT_MONITOR_TRIE_NODES <= UINT8_MAX);
+
 struct at_notif_fifo {
 	void *fifo_reserved;
-	char data[]; /* Null-terminated AT notification string */
+	char *data; /* Null-terminated AT notification string, after the match set */
+	uint32_t match_set[]; /* Bitmap of the monitors matching the notification */
+};
+
+/* Node of the filter automaton. Node 0 is the root, and also means "none". */
+struct trie_node {
+	uint8_t child; /* First child */
+	uint8_t sibling; /* Next sibling */
+	uint8_t fail; /* Node of the longest proper suffix in the trie */
+	uint8_t out; /* Nearest node on the fail chain that ends a filter */
+	uint8_t mon; /* First monitor whose filter ends here (index + 1) */
+	char c;
 };
 
 static void at_monitor_task(struct k_work *work);
@@ -26,6 +46,21 @@ static K_FIFO_DEFINE(at_monitor_fifo);
 static K_HEAP_DEFINE(at_monitor_heap, CONFIG_AT_MONITOR_HEAP_SIZE);
 static K_WORK_DEFINE(at_monitor_work, at_monitor_task);
 
+extern struct at_monitor_entry _at_monitor_entry_list_start[];
+extern struct at_monitor_entry _at_monitor_entry_list_end[];
+
+/* Aho-Corasick automaton of the monitor filters, built at boot. */
+static struct trie_node trie[CONFIG_AT_MONITOR_TRIE_NODES];
+static size_t trie_len;
+static bool trie_ready;
+/* Next monitor with the same filter, or next monitor with the wildcard filter. */
+static uint8_t mon_next[MONITORS_MAX];
+/* First monitor with the wildcard filter (index + 1). */
+static uint8_t mon_any;
+static size_t mon_cnt;
+
+static atomic_t drop_cnt;
+
 static bool is_paused(const struct at_monitor_entry *mon)
 {
 	return mon->flags.paused;
@@ -36,11 +71,174 @@ static bool is_direct(const struct at_monitor_entry *mon)
 	return mon->flags.direct;
 }
 
+static bool is_any(const struct at_monitor_entry *mon)
+{
+	/* Empty filter matches any notification, as the wildcard does. */
+	return (mon->filter == ANY || mon->filter[0] == '\0');
+}
+
 static bool has_match(const struct at_monitor_entry *mon, const char *notif)
 {
 	return (mon->filter == ANY || strstr(notif, mon->filter));
 }
 
+static void match_set_add(uint32_t *match_set, size_t idx)
+{
+	match_set[idx / 32] |= BIT(idx % 32);
+}
+
+static bool match_set_has(const uint32_t *match_set, size_t idx)
+{
+	return (match_set[idx / 32] & BIT(idx % 32)) != 0;
+}
+
+static bool is_match(const uint32_t *match_set, size_t idx, const char *notif)
+{
+	if (!trie_ready) {
+		return has_match(&_at_monitor_entry_list_start[idx], notif);
+	}
+
+	return match_set_has(match_set, idx);
+}
+
+static void match_set_add_chain(uint32_t *match_set, uint8_t mon)
+{
+	for (; mon != 0; mon = mon_next[mon - 1]) {
+		match_set_add(match_set, mon - 1);
+	}
+}
+
+static uint8_t trie_child(uint8_t node, char c)
+{
+	for (uint8_t child = trie[node].child; child != 0; child = trie[child].sibling) {
+		if (trie[child].c == c) {
+			return child;
+		}
+	}
+
+	return 0;
+}
+
+static int trie_insert(const char *filter, uint8_t idx)
+{
+	uint8_t node = 0;
+
+	for (const char *c = filter; *c != '\0'; c++) {
+		uint8_t child = trie_child(node, *c);
+
+		if (child == 0) {
+			if (trie_len >= ARRAY_SIZE(trie)) {
+				return -ENOMEM;
+			}
+
+			child = trie_len++;
+			trie[child].c = *c;
+			trie[child].sibling = trie[node].child;
+			trie[node].child = child;
+		}
+
+		node = child;
+	}
+
+	mon_next[idx] = trie[node].mon;
+	trie[node].mon = idx + 1;
+
+	return 0;
+}
+
+static void trie_link(void)
+{
+	uint8_t queue[CONFIG_AT_MONITOR_TRIE_NODES];
+	size_t head = 0;
+	size_t tail = 0;
+
+	/* Link the nodes in breadth-first order, so that the fail link of
+	 * every node is set before the links of its children.
+	 */
+	for (uint8_t child = trie[0].child; child != 0; child = trie[child].sibling) {
+		trie[child].out = trie[child].mon ? child : 0;
+		queue[tail++] = child;
+	}
+
+	while (head < tail) {
+		uint8_t node = queue[head++];
+
+		for (uint8_t child = trie[node].child; child != 0;
+		     child = trie[child].sibling) {
+			uint8_t fail = trie[node].fail;
+
+			while (fail != 0 && trie_child(fail, trie[child].c) == 0) {
+				fail = trie[fail].fail;
+			}
+
+			trie[child].fail = trie_child(fail, trie[child].c);
+			trie[child].out = trie[child].mon ? child : trie[trie[child].fail].out;
+			queue[tail++] = child;
+		}
+	}
+}
+
+static void trie_build(void)
+{
+	int err;
+
+	mon_cnt = _at_monitor_entry_list_end - _at_monitor_entry_list_start;
+
+	if (mon_cnt > MONITORS_MAX) {
+		LOG_WRN("More than %d AT monitors, matching is slower", MONITORS_MAX);
+		return;
+	}
+
+	trie_len = 1;
+
+	for (size_t i = 0; i < mon_cnt; i++) {
+		const struct at_monitor_entry *e = &_at_monitor_entry_list_start[i];
+
+		if (is_any(e)) {
+			mon_next[i] = mon_any;
+			mon_any = i + 1;
+			continue;
+		}
+
+		err = trie_insert(e->filter, i);
+		if (err) {
+			LOG_WRN("Filters exceed CONFIG_AT_MONITOR_TRIE_NODES, matching is slower");
+			return;
+		}
+	}
+
+	trie_link();
+	trie_ready = true;
+
+	LOG_DBG("Filters of %zu monitors compiled into %zu nodes", mon_cnt, trie_len);
+}
+
+/* Find all monitors matching the notification in a single pass over the notification.
+ * Without the automaton, the match set is left empty and is_match() checks the filters.
+ */
+static void match_set_get(const char *notif, uint32_t *match_set)
+{
+	uint8_t node = 0;
+
+	if (!trie_ready) {
+		return;
+	}
+
+	match_set_add_chain(match_set, mon_any);
+
+	for (const char *c = notif; *c != '\0'; c++) {
+		while (node != 0 && trie_child(node, *c) == 0) {
+			node = trie[node].fail;
+		}
+
+		node = trie_child(node, *c);
+
+		for (uint8_t out = trie[node].out; out != 0; out = trie[trie[out].fail].out) {
+			match_set_add_chain(match_set, trie[out].mon);
+		}
+	}
+}
+
 /* Dispatch AT notifications immediately, or schedules a workqueue task to do that.
  * Keep this function public so that it can be called by tests.
  * This function is called from an ISR.
@@ -49,20 +247,28 @@ void at_monitor_dispatch(const char *notif)
 {
 	bool monitored;
 	struct at_notif_fifo *at_notif;
+	uint32_t match_set[MATCH_SET_WORDS(MONITORS_MAX)] = {0};
+	size_t match_set_size;
 	size_t sz_needed;
 
 	__ASSERT_NO_MSG(notif != NULL);
 
+	match_set_get(notif, match_set);
+
 	monitored = false;
-	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-		if (!is_paused(e) && has_match(e, notif)) {
-			if (is_direct(e)) {
-				LOG_DBG("Dispatching to %p (ISR)", e->handler);
-				e->handler(notif);
-			} else {
-				/* Copy and schedule work-queue task */
-				monitored = true;
-			}
+	for (size_t i = 0; i < mon_cnt; i++) {
+		struct at_monitor_entry *e = &_at_monitor_entry_list_start[i];
+
+		if (!is_match(match_set, i, notif) || is_paused(e)) {
+			continue;
+		}
+
+		if (is_direct(e)) {
+			LOG_DBG("Dispatching to %p (ISR)", e->handler);
+			e->handler(notif);
+		} else {
+			/* Copy and schedule work-queue task */
+			monitored = true;
 		}
 	}
 
@@ -71,15 +277,20 @@ void at_monitor_dispatch(const char *notif)
 		return;
 	}
 
-	sz_needed = sizeof(struct at_notif_fifo) + strlen(notif) + sizeof(char);
+	match_set_size = trie_ready ? MATCH_SET_WORDS(mon_cnt) * sizeof(uint32_t) : 0;
+	sz_needed = sizeof(struct at_notif_fifo) + match_set_size + strlen(notif) + sizeof(char);
 
 	at_notif = k_heap_alloc(&at_monitor_heap, sz_needed, K_NO_WAIT);
 	if (!at_notif) {
+		atomic_inc(&drop_cnt);
 		LOG_WRN("No heap space for incoming notification: %s",
 			notif);
 		return;
 	}
 
+	/* Pass the match set along, so that the notification is not matched again. */
+	memcpy(at_notif->match_set, match_set, match_set_size);
+	at_notif->data = (char *)at_notif->match_set + match_set_size;
 	strcpy(at_notif->data, notif);
 
 	k_fifo_put(&at_monitor_fifo, at_notif);
@@ -91,10 +302,12 @@ static void at_monitor_task(struct k_work *work)
 	struct at_notif_fifo *at_notif;
 
 	while ((at_notif = k_fifo_get(&at_monitor_fifo, K_NO_WAIT))) {
-		/* Match notification with all monitors */
 		LOG_DBG("AT notif: %.*s", strlen(at_notif->data) - strlen("\r\n"), at_notif->data);
-		STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-			if (!is_paused(e) && !is_direct(e) && has_match(e, at_notif->data)) {
+		for (size_t i = 0; i < mon_cnt; i++) {
+			struct at_monitor_entry *e = &_at_monitor_entry_list_start[i];
+
+			if (is_match(at_notif->match_set, i, at_notif->data) &&
+			    !is_paused(e) && !is_direct(e)) {
 				LOG_DBG("Dispatching to %p", e->handler);
 				e->handler(at_notif->data);
 			}
@@ -103,10 +316,17 @@ static void at_monitor_task(struct k_work *work)
 	}
 }
 
+uint32_t at_monitor_drop_count_get(void)
+{
+	return atomic_get(&drop_cnt);
+}
+
 static int at_monitor_sys_init(const struct device *unused)
 {
 	int err;
 
+	trie_build();
+
 	err = nrf_modem_at_notif_handler_set(at_monitor_dispatch);
 	if (err) {
 		LOG_ERR("Failed to hook the dispatch function, err %d", err);
@@ -13,8 +13,7 @@
 #include <zephyr/posix/time.h>
 
 #include <nrf_modem_at.h>
-#include <modem/at_cmd_parser.h>
-#include <modem/at_params.h>
+#include <modem/at_token.h>
 #include <net/nrf_cloud.h>
 #include <modem/location.h>
 
@@ -24,10 +23,16 @@ LOG_MODULE_DECLARE(location, CONFIG_LOCATION_LOG_LEVEL);
 
 #define AT_CMD_PDP_ACT_READ "AT+CGACT?"
 #define MODEM_PARAM_STR_MAX_LEN 16
+#define MODEM_PARAM_RESP_MAX_LEN 256
 
-/* For having a numeric constant in scanf string length */
-#define L_(x) #x
-#define L(x) L_(x)
+/* Format of XMONITOR AT command response:
+ * %XMONITOR: <reg_status>,[<full_name>,<short_name>,<plmn>,<tac>,<AcT>,<band>,<cell_id>,
+ * <phys_cell_id>,...]
+ */
+#define AT_XMONITOR_PLMN_INDEX 4
+#define AT_XMONITOR_TAC_INDEX 5
+#define AT_XMONITOR_CELL_ID_INDEX 8
+#define AT_XMONITOR_PHYS_CELL_ID_INDEX 9
 
 char jwt_buf[600];
 
@@ -54,57 +59,78 @@ bool location_utils_is_default_pdn_active(void)
 
 int location_utils_modem_params_read(struct location_utils_modem_params_info *modem_params)
 {
-	/* Parsed strings include double quotes */
-	char plmn_str[MODEM_PARAM_STR_MAX_LEN + 1] = { 0 };
-	char tac_str[MODEM_PARAM_STR_MAX_LEN + 1] = { 0 };
-	char cell_id_str[MODEM_PARAM_STR_MAX_LEN + 1] = { 0 };
-	int err = 0;
+	char response[MODEM_PARAM_RESP_MAX_LEN];
+	char plmn_str[MODEM_PARAM_STR_MAX_LEN] = { 0 };
+	char tac_str[MODEM_PARAM_STR_MAX_LEN] = { 0 };
+	char cell_id_str[MODEM_PARAM_STR_MAX_LEN] = { 0 };
+	struct at_token_cursor resp;
+	size_t len;
+	int err;
 
 	__ASSERT_NO_MSG(modem_params != NULL);
 
-	err = nrf_modem_at_scanf(
-		"AT%XMONITOR",
-		"%%XMONITOR: "
-		"%*d"                                 /* <reg_status>: ignored */
-		",%*[^,]"                             /* <full_name>: ignored */
-		",%*[^,]"                             /* <short_name>: ignored */
-		",%"L(MODEM_PARAM_STR_MAX_LEN)"[^,]"  /* <plmn> */
-		",%"L(MODEM_PARAM_STR_MAX_LEN)"[^,]"  /* <tac> */
-		",%*d"                                /* <AcT>: ignored */
-		",%*d"                                /* <band>: ignored */
-		",%"L(MODEM_PARAM_STR_MAX_LEN)"[^,]"  /* <cell_id> */
-		",%d",                                /* <phys_cell_id> */
-		plmn_str, tac_str, cell_id_str, &modem_params->phys_cell_id);
-
-	if (err <= 2) {
+	err = nrf_modem_at_cmd(response, sizeof(response), "AT%%XMONITOR");
+	if (err) {
 		LOG_ERR("Cannot get modem parameters, err %d", err);
-	} else {
-		/* Indicate success to the caller with zero return value */
-		err = 0;
+		return err < 0 ? err : -EIO;
+	}
 
-		/* Read MNC and store as integer. The MNC starts as the fifth character
-		 * in the string, following double quote and three characters long MCC.
-		 */
-		modem_params->mnc = strtol(&plmn_str[4], NULL, 10);
+	/* The parameters are read in order from the response, without copying
+	 * the parameters that are not needed.
+	 */
+	err = at_token_cursor_init(&resp, response);
+	if (err) {
+		return err;
+	}
 
-		/* Null-terminated MCC, read and store it. */
-		plmn_str[4] = '\0';
+	len = sizeof(plmn_str);
+	err = at_token_string_get(&resp, AT_XMONITOR_PLMN_INDEX, plmn_str, &len);
+	if (err || (len < 4)) {
+		LOG_ERR("Cannot get PLMN from modem parameters, err %d", err);
+		return -EBADMSG;
+	}
 
-		modem_params->mcc = strtol(plmn_str + 1, NULL, 10);
+	len = sizeof(tac_str);
+	err = at_token_string_get(&resp, AT_XMONITOR_TAC_INDEX, tac_str, &len);
+	if (err) {
+		LOG_ERR("Cannot get TAC from modem parameters, err %d", err);
+		return -EBADMSG;
+	}
 
-		/* <tac> */
-		modem_params->tac = strtol(tac_str + 1, NULL, 16);
+	len = sizeof(cell_id_str);
+	err = at_token_string_get(&resp, AT_XMONITOR_CELL_ID_INDEX, cell_id_str, &len);
+	if (err) {
+		LOG_ERR("Cannot get cell ID from modem parameters, err %d", err);
+		return -EBADMSG;
+	}
 
-		/* <cell_id> */
-		modem_params->cell_id = strtol(cell_id_str + 1, NULL, 16);
+	/* Physical cell ID is read if present. */
+	(void)at_token_unsigned_short_get(&resp, AT_XMONITOR_PHYS_CELL_ID_INDEX,
+					  &modem_params->phys_cell_id);
 
-		LOG_DBG("parsed modem parameters: "
-			"mcc %d, mnc %d, tac %d (string: %s), cell_id %d (string: %s) phys_cell_id %d",
-			modem_params->mcc, modem_params->mnc, modem_params->tac,
-			tac_str, modem_params->cell_id, cell_id_str,
-			modem_params->phys_cell_id);
-	}
-	return err;
+	/* Read MNC and store as integer. The MNC starts as the fourth character
+	 * in the string, following three characters long MCC.
+	 */
+	modem_params->mnc = strtol(&plmn_str[3], NULL, 10);
+
+	/* Null-terminated MCC, read and store it. */
+	plmn_str[3] = '\0';
+
+	modem_params->mcc = strtol(plmn_str, NULL, 10);
+
+	/* <tac> */
+	modem_params->tac = strtol(tac_str, NULL, 16);
+
+	/* <cell_id> */
+	modem_params->cell_id = strtol(cell_id_str, NULL, 16);
+
+	LOG_DBG("parsed modem parameters: "
+		"mcc %d, mnc %d, tac %d (string: %s), cell_id %d (string: %s) phys_cell_id %d",
+		modem_params->mcc, modem_params->mnc, modem_params->tac,
+		tac_str, modem_params->cell_id, cell_id_str,
+		modem_params->phys_cell_id);
+
+	return 0;
 }
 
 const char *location_utils_nrf_cloud_jwt_generate(void)
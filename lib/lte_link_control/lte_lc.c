@@ -367,11 +367,6 @@ static void at_handler_ncellmeas(const char *response)
 	err = parse_ncellmeas(response, &evt.cells_info);
 
 	switch (err) {
-	case -E2BIG:
-		LOG_WRN("Not all neighbor cells could be parsed");
-		LOG_WRN("More cells than the configured max count of %d were found",
-			CONFIG_LTE_NEIGHBOR_CELLS_MAX);
-		/* Fall through */
 	case 0: /* Fall through */
 	case 1:
 		evt.type = LTE_LC_EVT_NEIGHBOR_CELL_MEAS;
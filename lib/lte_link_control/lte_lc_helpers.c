@@ -12,8 +12,7 @@
 #include <stdio.h>
 #include <zephyr/device.h>
 #include <modem/lte_lc.h>
-#include <modem/at_cmd_parser.h>
-#include <modem/at_params.h>
+#include <modem/at_token.h>
 #include <zephyr/logging/log.h>
 
 #include "lte_lc_helpers.h"
@@ -134,20 +133,18 @@ void event_handler_list_dispatch(const struct lte_lc_evt *const evt)
 /* Converts integer on string format to integer type.
  * Returns zero on success, otherwise negative error on failure.
  */
-static int string_param_to_int(struct at_param_list *resp_list,
+static int string_param_to_int(struct at_token_cursor *resp,
 			       size_t idx, int *output, int base)
 {
 	int err;
 	char str_buf[16];
 	size_t len = sizeof(str_buf);
 
-	err = at_params_string_get(resp_list, idx, str_buf, &len);
+	err = at_token_string_get(resp, idx, str_buf, &len);
 	if (err) {
 		return err;
 	}
 
-	str_buf[len] = '\0';
-
 	if (string_to_int(str_buf, base, output)) {
 		return -ENODATA;
 	}
@@ -155,6 +152,35 @@ static int string_param_to_int(struct at_param_list *resp_list,
 	return 0;
 }
 
+/* Check that the response starts with the given notification ID.
+ * Returns zero on success, otherwise negative error on failure.
+ */
+/* Unlike at_token_count_get(), which counts empty parameters, a parameter is
+ * present only if it is not empty.
+ */
+static bool param_is_present(struct at_token_cursor *resp, size_t index)
+{
+	enum at_param_type type = at_token_type_get(resp, index);
+
+	return (type != AT_PARAM_TYPE_INVALID) && (type != AT_PARAM_TYPE_EMPTY);
+}
+
+static int response_prefix_check(struct at_token_cursor *resp, const char *prefix, bool *valid)
+{
+	int err;
+	const char *str;
+	size_t len;
+
+	err = at_token_string_ptr_get(resp, AT_RESPONSE_PREFIX_INDEX, &str, &len);
+	if (err) {
+		return err;
+	}
+
+	*valid = (len == strlen(prefix)) && response_is_valid(str, len, prefix);
+
+	return 0;
+}
+
 /* Confirm valid system mode and set Paging Time Window multiplier.
  * Multiplier is 1.28 s for LTE-M, and 2.56 s for NB-IoT, derived from
  * Figure 10.5.5.32/3GPP TS 24.008.
@@ -254,13 +280,13 @@ bool response_is_valid(const char *response, size_t response_len,
  * Returns the (positive) registration value if it's found, otherwise a negative
  * error code.
  */
-static int get_nw_reg_status(struct at_param_list *list, bool is_notif)
+static int get_nw_reg_status(struct at_token_cursor *resp, bool is_notif)
 {
 	int err, reg_status;
 	size_t reg_status_index = is_notif ? AT_CEREG_REG_STATUS_INDEX :
 					     AT_CEREG_READ_REG_STATUS_INDEX;
 
-	err = at_params_int_get(list, reg_status_index, &reg_status);
+	err = at_token_int_get(resp, reg_status_index, &reg_status);
 	if (err) {
 		return err;
 	}
@@ -306,39 +332,27 @@ int parse_edrx(const char *at_response, struct lte_lc_edrx_cfg *cfg)
 {
 	int err, tmp_int;
 	uint8_t idx;
-	struct at_param_list resp_list = {0};
+	struct at_token_cursor resp;
 	char tmp_buf[5];
-	size_t len = sizeof(tmp_buf) - 1;
+	size_t len = sizeof(tmp_buf);
 	float ptw_multiplier;
 
 	if ((at_response == NULL) || (cfg == NULL)) {
 		return -EINVAL;
 	}
 
-	err = at_params_list_init(&resp_list, AT_CEDRXP_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	/* Parse CEDRXP response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
+	err = at_token_cursor_init(&resp, at_response);
 	if (err) {
 		LOG_ERR("Could not parse +CEDRXP response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	err = at_params_string_get(&resp_list, AT_CEDRXP_NW_EDRX_INDEX,
-				   tmp_buf, &len);
+	err = at_token_string_get(&resp, AT_CEDRXP_NW_EDRX_INDEX, tmp_buf, &len);
 	if (err) {
 		LOG_ERR("Failed to get eDRX configuration, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	tmp_buf[len] = '\0';
-
 	/* The eDRX value is a multiple of 10.24 seconds, except for the
 	 * special case of idx == 0 for LTE-M, where the value is 5.12 seconds.
 	 * The variable idx is used to map to the entry of index idx in
@@ -347,10 +361,10 @@ int parse_edrx(const char *at_response, struct lte_lc_edrx_cfg *cfg)
 	 */
 	idx = strtoul(tmp_buf, NULL, 2);
 
-	err = at_params_int_get(&resp_list, AT_CEDRXP_ACTT_INDEX, &tmp_int);
+	err = at_token_int_get(&resp, AT_CEDRXP_ACTT_INDEX, &tmp_int);
 	if (err) {
 		LOG_ERR("Failed to get LTE mode, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* The acces technology indicators 4 for LTE-M and 5 for NB-IoT are
@@ -367,34 +381,30 @@ int parse_edrx(const char *at_response, struct lte_lc_edrx_cfg *cfg)
 	err = get_ptw_multiplier(cfg->mode, &ptw_multiplier);
 	if (err) {
 		LOG_WRN("Active LTE mode could not be determined");
-		goto clean_exit;
+		return err;
 	}
 
 	err = get_edrx_value(cfg->mode, idx, &cfg->edrx);
 	if (err) {
 		LOG_ERR("Failed to get eDRX value, error; %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	len = sizeof(tmp_buf) - 1;
+	len = sizeof(tmp_buf);
 
-	err = at_params_string_get(&resp_list, AT_CEDRXP_NW_PTW_INDEX,
-				   tmp_buf, &len);
+	err = at_token_string_get(&resp, AT_CEDRXP_NW_PTW_INDEX, tmp_buf, &len);
 	if (err) {
 		LOG_ERR("Failed to get PTW configuration, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	tmp_buf[len] = '\0';
-
 	/* Value can be a maximum of 15, as there are 16 entries in the table
 	 * for paging time window (both for LTE-M and NB1).
 	 */
 	idx = strtoul(tmp_buf, NULL, 2);
 	if (idx > 15) {
 		LOG_ERR("Invalid PTW lookup index: %d", idx);
-		err = -EINVAL;
-		goto clean_exit;
+		return -EINVAL;
 	}
 
 	/* The Paging Time Window is different for LTE-M and NB-IoT:
@@ -411,10 +421,7 @@ int parse_edrx(const char *at_response, struct lte_lc_edrx_cfg *cfg)
 		(int)cfg->ptw,
 		(int)(100 * (cfg->ptw - (int)cfg->ptw)));
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 int parse_psm(const char *active_time_str, const char *tau_ext_str,
@@ -507,28 +514,19 @@ int parse_rrc_mode(const char *at_response,
 		   size_t mode_index)
 {
 	int err, temp_mode;
-	struct at_param_list resp_list = {0};
-
-	err = at_params_list_init(&resp_list, AT_CSCON_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
+	struct at_token_cursor resp;
 
-	/* Parse CSCON response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
+	err = at_token_cursor_init(&resp, at_response);
 	if (err) {
 		LOG_ERR("Could not parse +CSCON response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* Get the RRC mode from the response */
-	err = at_params_int_get(&resp_list, mode_index, &temp_mode);
+	err = at_token_int_get(&resp, mode_index, &temp_mode);
 	if (err) {
 		LOG_ERR("Could not get signalling mode, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* Check if the parsed value maps to a valid registration status */
@@ -538,13 +536,10 @@ int parse_rrc_mode(const char *at_response,
 		*mode = LTE_LC_RRC_MODE_CONNECTED;
 	} else {
 		LOG_ERR("Invalid signalling mode: %d", temp_mode);
-		err = -EINVAL;
+		return -EINVAL;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 int parse_cereg(const char *at_response,
@@ -554,51 +549,36 @@ int parse_cereg(const char *at_response,
 		enum lte_lc_lte_mode *lte_mode)
 {
 	int err, status;
-	struct at_param_list resp_list;
+	struct at_token_cursor resp;
 	char str_buf[10];
-	char  response_prefix[sizeof(AT_CEREG_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
-	size_t len = sizeof(str_buf) - 1;
-
-	err = at_params_list_init(&resp_list, AT_CEREG_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
+	size_t len = sizeof(str_buf);
+	bool valid;
 
-	/* Parse CEREG response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
+	err = at_token_cursor_init(&resp, at_response);
 	if (err) {
 		LOG_ERR("Could not parse AT+CEREG response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* Check if AT command response starts with +CEREG */
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
+	err = response_prefix_check(&resp, AT_CEREG_RESPONSE_PREFIX, &valid);
 	if (err) {
 		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_CEREG_RESPONSE_PREFIX)) {
+	if (!valid) {
 		/* The unsolicited response is not a CEREG response, ignore it.
 		 */
 		LOG_DBG("Not a valid CEREG response");
-		goto clean_exit;
+		return 0;
 	}
 
 	/* Get network registration status */
-	status = get_nw_reg_status(&resp_list, is_notif);
+	status = get_nw_reg_status(&resp, is_notif);
 	if (status < 0) {
 		LOG_ERR("Could not get registration status, error: %d", status);
-		err = status;
-		goto clean_exit;
+		return status;
 	}
 
 	if (reg_status) {
@@ -609,34 +589,32 @@ int parse_cereg(const char *at_response,
 
 
 	if (cell && (status != LTE_LC_NW_REG_UICC_FAIL) &&
-	    (at_params_valid_count_get(&resp_list) > AT_CEREG_CELL_ID_INDEX)) {
+	    param_is_present(&resp, is_notif ? AT_CEREG_CELL_ID_INDEX :
+						 AT_CEREG_READ_CELL_ID_INDEX)) {
 		/* Parse tracking area code */
-		err = at_params_string_get(
-				&resp_list,
+		err = at_token_string_get(&resp,
 				is_notif ? AT_CEREG_TAC_INDEX :
 					   AT_CEREG_READ_TAC_INDEX,
 				str_buf, &len);
 		if (err) {
 			LOG_ERR("Could not get tracking area code, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 
-		str_buf[len] = '\0';
 		cell->tac = strtoul(str_buf, NULL, 16);
 
 		/* Parse cell ID */
-		len = sizeof(str_buf) - 1;
+		len = sizeof(str_buf);
 
-		err = at_params_string_get(&resp_list,
+		err = at_token_string_get(&resp,
 				is_notif ? AT_CEREG_CELL_ID_INDEX :
 					   AT_CEREG_READ_CELL_ID_INDEX,
 				str_buf, &len);
 		if (err) {
 			LOG_ERR("Could not get cell ID, error: %d", err);
-			goto clean_exit;
+			return err;
 		}
 
-		str_buf[len] = '\0';
 		cell->id = strtoul(str_buf, NULL, 16);
 	} else if (cell) {
 		cell->tac = UINT32_MAX;
@@ -647,7 +625,7 @@ int parse_cereg(const char *at_response,
 		int mode;
 
 		/* Get currently active LTE mode. */
-		err = at_params_int_get(&resp_list,
+		err = at_token_int_get(&resp,
 				is_notif ? AT_CEREG_ACT_INDEX :
 					   AT_CEREG_READ_ACT_INDEX,
 				&mode);
@@ -659,7 +637,6 @@ int parse_cereg(const char *at_response,
 			 * expected in some situations that LTE mode is not
 			 * available.
 			 */
-			err = 0;
 		} else {
 			*lte_mode = mode;
 
@@ -667,49 +644,37 @@ int parse_cereg(const char *at_response,
 		}
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 int parse_xt3412(const char *at_response, uint64_t *time)
 {
 	int err;
-	struct at_param_list resp_list = {0};
+	struct at_token_cursor resp;
 
 	if (time == NULL || at_response == NULL) {
 		return -EINVAL;
 	}
 
-	err = at_params_list_init(&resp_list, AT_XT3412_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	/* Parse XT3412 response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response, NULL, &resp_list);
+	err = at_token_cursor_init(&resp, at_response);
 	if (err) {
 		LOG_ERR("Could not parse %%XT3412 response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	/* Get the remaining time of T3412 from the response */
-	err = at_params_int64_get(&resp_list, AT_XT3412_TIME_INDEX, time);
+	err = at_token_int64_get(&resp, AT_XT3412_TIME_INDEX, time);
 	if (err) {
 		LOG_ERR("Could not get time until next TAU, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
 	if ((*time > T3412_MAX) || *time < 0) {
 		LOG_WRN("Parsed time parameter not within valid range");
-		err = -EINVAL;
+		return -EINVAL;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-	return err;
+	return 0;
 }
 
 uint32_t neighborcell_count_get(const char *at_response)
@@ -741,75 +706,54 @@ uint32_t neighborcell_count_get(const char *at_response)
  *	     The ncells_count indicates how many neighbor cells were parsed
  *	     into the neighbor_cells array.
  * Returns 1 on measurement failure
- * Returns -E2BIG if not all cells were parsed due to memory limitations
  * Returns otherwise a negative error code.
  */
 int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
 {
-	int err, status, tmp, len;
-	struct at_param_list resp_list;
-	char  response_prefix[sizeof(AT_NCELLMEAS_RESPONSE_PREFIX)] = {0};
-	size_t response_prefix_len = sizeof(response_prefix);
+	int err, status, tmp;
+	struct at_token_cursor resp;
 	char tmp_str[7];
-	bool incomplete = false;
-	/* Count the actual numbers of parameters in the AT response before
-	 * allocating heap for it. This may save quite a bit of heap as the
-	 * worst case scenario is 96 elements.
-	 * 3 is added to account for the parameters that do not have a trailng
-	 * comma.
-	 */
-	size_t param_count = get_char_frequency(at_response, ',') + 3;
+	size_t len;
+	bool valid;
 
 	cells->ncells_count = 0;
 	cells->current_cell.id = LTE_LC_CELL_EUTRAN_ID_INVALID;
 
-	err = at_params_list_init(&resp_list, param_count);
+	/* The parameters are read in order, so the response is scanned only
+	 * once, without copying the parameters.
+	 */
+	err = at_token_cursor_init(&resp, at_response);
 	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	err = at_parser_params_from_str(at_response,
-					NULL,
-					&resp_list);
-	if (err && err != -E2BIG) {
 		LOG_ERR("Could not parse AT%%NCELLMEAS response, error: %d", err);
-		goto clean_exit;
-	} else if (err == -E2BIG) {
-		incomplete = true;
+		return err;
 	}
 
-	err = at_params_string_get(&resp_list,
-				   AT_RESPONSE_PREFIX_INDEX,
-				   response_prefix,
-				   &response_prefix_len);
+	err = response_prefix_check(&resp, AT_NCELLMEAS_RESPONSE_PREFIX, &valid);
 	if (err) {
 		LOG_ERR("Could not get response prefix, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	if (!response_is_valid(response_prefix, response_prefix_len,
-			       AT_NCELLMEAS_RESPONSE_PREFIX)) {
+	if (!valid) {
 		/* The unsolicited response is not a NCELLMEAS response, ignore it. */
 		LOG_DBG("Not a valid NCELLMEAS response");
-		goto clean_exit;
+		return 0;
 	}
 
 	/* Status code. */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_STATUS_INDEX, &status);
+	err = at_token_int_get(&resp, AT_NCELLMEAS_STATUS_INDEX, &status);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	if (status != AT_NCELLMEAS_STATUS_VALUE_SUCCESS) {
-		err = 1;
-		goto clean_exit;
+		return 1;
 	}
 
 	/* Current cell ID. */
-	err = string_param_to_int(&resp_list, AT_NCELLMEAS_CELL_ID_INDEX, &tmp, 16);
+	err = string_param_to_int(&resp, AT_NCELLMEAS_CELL_ID_INDEX, &tmp, 16);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	if (tmp > LTE_LC_CELL_EUTRAN_ID_MAX) {
@@ -820,20 +764,17 @@ int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
 	/* PLMN */
 	len = sizeof(tmp_str);
 
-	err = at_params_string_get(&resp_list, AT_NCELLMEAS_PLMN_INDEX,
-				   tmp_str, &len);
+	err = at_token_string_get(&resp, AT_NCELLMEAS_PLMN_INDEX, tmp_str, &len);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
-	tmp_str[len] = '\0';
-
 	/* Read MNC and store as integer. The MNC starts as the fourth character
 	 * in the string, following three characters long MCC.
 	 */
 	err = string_to_int(&tmp_str[3], 10, &cells->current_cell.mnc);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* Null-terminated MCC, read and store it. */
@@ -841,191 +782,172 @@ int parse_ncellmeas(const char *at_response, struct lte_lc_cells_info *cells)
 
 	err = string_to_int(tmp_str, 10, &cells->current_cell.mcc);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* Tracking area code. */
-	err = string_param_to_int(&resp_list, AT_NCELLMEAS_TAC_INDEX, &tmp, 16);
+	err = string_param_to_int(&resp, AT_NCELLMEAS_TAC_INDEX, &tmp, 16);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	cells->current_cell.tac = tmp;
 
 	/* Timing advance */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_TIMING_ADV_INDEX,
-				&tmp);
+	err = at_token_int_get(&resp, AT_NCELLMEAS_TIMING_ADV_INDEX, &tmp);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	cells->current_cell.timing_advance = tmp;
 
 	/* EARFCN */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_EARFCN_INDEX,
-				&cells->current_cell.earfcn);
+	err = at_token_int_get(&resp, AT_NCELLMEAS_EARFCN_INDEX,
+			       &cells->current_cell.earfcn);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* Physical cell ID. */
-	err = at_params_short_get(&resp_list, AT_NCELLMEAS_PHYS_CELL_ID_INDEX,
-				&cells->current_cell.phys_cell_id);
+	err = at_token_short_get(&resp, AT_NCELLMEAS_PHYS_CELL_ID_INDEX,
+				 &cells->current_cell.phys_cell_id);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* RSRP */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_RSRP_INDEX, &tmp);
+	err = at_token_int_get(&resp, AT_NCELLMEAS_RSRP_INDEX, &tmp);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	cells->current_cell.rsrp = tmp;
 
 	/* RSRQ */
-	err = at_params_int_get(&resp_list, AT_NCELLMEAS_RSRQ_INDEX, &tmp);
+	err = at_token_int_get(&resp, AT_NCELLMEAS_RSRQ_INDEX, &tmp);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	cells->current_cell.rsrq = tmp;
 
 	/* Measurement time. */
-	err = at_params_int64_get(&resp_list, AT_NCELLMEAS_MEASUREMENT_TIME_INDEX,
-				  &cells->current_cell.measurement_time);
+	err = at_token_int64_get(&resp, AT_NCELLMEAS_MEASUREMENT_TIME_INDEX,
+				 &cells->current_cell.measurement_time);
 	if (err) {
-		goto clean_exit;
+		return err;
 	}
 
 	/* Neighbor cell count. */
 	cells->ncells_count = neighborcell_count_get(at_response);
 
-	/* Starting from modem firmware v1.3.1, timing advance measurement time
-	 * information is added as the last parameter in the response.
-	 */
-	size_t ta_meas_time_index = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
-			cells->ncells_count * AT_NCELLMEAS_N_PARAMS_COUNT;
-
-	if (at_params_valid_count_get(&resp_list) > ta_meas_time_index) {
-		err = at_params_int64_get(&resp_list, ta_meas_time_index,
-					  &cells->current_cell.timing_advance_meas_time);
-		if (err) {
-			goto clean_exit;
-		}
-	} else {
-		cells->current_cell.timing_advance_meas_time = 0;
-	}
-
-	if ((cells->ncells_count == 0) || (cells->neighbor_cells == NULL)) {
-		goto clean_exit;
-	}
+	if ((cells->ncells_count != 0) && (cells->neighbor_cells != NULL)) {
+		/* Neighboring cells. */
+		for (size_t i = 0; i < cells->ncells_count; i++) {
+			size_t start_idx = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
+					   i * AT_NCELLMEAS_N_PARAMS_COUNT;
+
+			/* EARFCN */
+			err = at_token_int_get(&resp,
+					       start_idx + AT_NCELLMEAS_N_EARFCN_INDEX,
+					       &cells->neighbor_cells[i].earfcn);
+			if (err) {
+				return err;
+			}
 
-	/* Neighboring cells. */
-	for (size_t i = 0; i < cells->ncells_count; i++) {
-		size_t start_idx = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
-				   i * AT_NCELLMEAS_N_PARAMS_COUNT;
+			/* Physical cell ID. */
+			err = at_token_short_get(&resp,
+						 start_idx + AT_NCELLMEAS_N_PHYS_CELL_ID_INDEX,
+						 &cells->neighbor_cells[i].phys_cell_id);
+			if (err) {
+				return err;
+			}
 
-		/* EARFCN */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_EARFCN_INDEX,
-					&cells->neighbor_cells[i].earfcn);
-		if (err) {
-			goto clean_exit;
-		}
+			/* RSRP */
+			err = at_token_int_get(&resp,
+					       start_idx + AT_NCELLMEAS_N_RSRP_INDEX,
+					       &tmp);
+			if (err) {
+				return err;
+			}
 
-		/* Physical cell ID. */
-		err = at_params_short_get(&resp_list,
-					  start_idx + AT_NCELLMEAS_N_PHYS_CELL_ID_INDEX,
-					  &cells->neighbor_cells[i].phys_cell_id);
-		if (err) {
-			goto clean_exit;
-		}
+			cells->neighbor_cells[i].rsrp = tmp;
 
-		/* RSRP */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_RSRP_INDEX,
-					&tmp);
-		if (err) {
-			goto clean_exit;
-		}
+			/* RSRQ */
+			err = at_token_int_get(&resp,
+					       start_idx + AT_NCELLMEAS_N_RSRQ_INDEX,
+					       &tmp);
+			if (err) {
+				return err;
+			}
 
-		cells->neighbor_cells[i].rsrp = tmp;
+			cells->neighbor_cells[i].rsrq = tmp;
 
-		/* RSRQ */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_RSRQ_INDEX,
-					&tmp);
-		if (err) {
-			goto clean_exit;
+			/* Time difference. */
+			err = at_token_int_get(&resp,
+					       start_idx + AT_NCELLMEAS_N_TIME_DIFF_INDEX,
+					       &cells->neighbor_cells[i].time_diff);
+			if (err) {
+				return err;
+			}
 		}
+	}
 
-		cells->neighbor_cells[i].rsrq = tmp;
+	/* Starting from modem firmware v1.3.1, timing advance measurement time
+	 * information is added as the last parameter in the response.
+	 */
+	size_t ta_meas_time_index = AT_NCELLMEAS_PRE_NCELLS_PARAMS_COUNT +
+			cells->ncells_count * AT_NCELLMEAS_N_PARAMS_COUNT;
 
-		/* Time difference. */
-		err = at_params_int_get(&resp_list,
-					start_idx + AT_NCELLMEAS_N_TIME_DIFF_INDEX,
-					&cells->neighbor_cells[i].time_diff);
+	if (param_is_present(&resp, ta_meas_time_index)) {
+		err = at_token_int64_get(&resp, ta_meas_time_index,
+					 &cells->current_cell.timing_advance_meas_time);
 		if (err) {
-			goto clean_exit;
+			return err;
 		}
+	} else {
+		cells->current_cell.timing_advance_meas_time = 0;
 	}
 
-	if (incomplete) {
-		err = -E2BIG;
-	}
-
-clean_exit:
-	at_params_list_free(&resp_list);
-
-	return err;
+	return 0;
 }
 
 int parse_xmodemsleep(const char *at_response, struct lte_lc_modem_sleep *modem_sleep)
 {
 	int err;
-	struct at_param_list resp_list = {0};
+	struct at_token_cursor resp;
 	uint16_t type;
 
 	if (modem_sleep == NULL || at_response == NULL) {
 		return -EINVAL;
 	}
 
-	err = at_params_list_init(&resp_list, AT_XMODEMSLEEP_PARAMS_COUNT_MAX);
-	if (err) {
-		LOG_ERR("Could not init AT params list, error: %d", err);
-		return err;
-	}
-
-	/* Parse XMODEMSLEEP response and populate AT parameter list */
-	err = at_parser_params_from_str(at_response, NULL, &resp_list);
+	err = at_token_cursor_init(&resp, at_response);
 	if (err) {
 		LOG_ERR("Could not parse %%XMODEMSLEEP response, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-	err = at_params_unsigned_short_get(&resp_list, AT_XMODEMSLEEP_TYPE_INDEX, &type);
+	err = at_token_unsigned_short_get(&resp, AT_XMODEMSLEEP_TYPE_INDEX, &type);
 	if (err) {
 		LOG_ERR("Could not get mode sleep type, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 	modem_sleep->type = type;
 
 	/* If the time parameter is not present sleep time is considered infinite. */
-	if (at_params_valid_count_get(&resp_list) < AT_XMODEMSLEEP_PARAMS_COUNT_MAX - 1) {
+	if (!param_is_present(&resp, AT_XMODEMSLEEP_TIME_INDEX)) {
 		modem_sleep->time = -1;
-		goto clean_exit;
+		return 0;
 	}
 
-	err = at_params_int64_get(&resp_list, AT_XMODEMSLEEP_TIME_INDEX, &modem_sleep->time);
+	err = at_token_int64_get(&resp, AT_XMODEMSLEEP_TIME_INDEX, &modem_sleep->time);
 	if (err) {
 		LOG_ERR("Could not get time until next modem sleep, error: %d", err);
-		goto clean_exit;
+		return err;
 	}
 
-clean_exit:
-	at_params_list_free(&resp_list);
-	return err;
+	return 0;
 }
 
 int parse_mdmev(const char *at_response, enum lte_lc_modem_evt *modem_evt)
@@ -9,8 +9,7 @@
 #include <string.h>
 #include <stdio.h>
 #include <modem/lte_lc.h>
-#include <modem/at_cmd_parser.h>
-#include <modem/at_params.h>
+#include <modem/at_token.h>
 #include <zephyr/logging/log.h>
 
 #define LC_MAX_READ_LENGTH			128
@@ -6,7 +6,7 @@
 
 #include <nrf_modem_at.h>
 #include <modem/at_monitor.h>
-#include <modem/at_cmd_parser.h>
+#include <modem/at_token.h>
 #include <ctype.h>
 #include <zephyr/device.h>
 #include <errno.h>
@@ -72,68 +72,35 @@ LOG_MODULE_REGISTER(modem_info);
 #define IP_ADDR_SEPARATOR_LEN (sizeof(IP_ADDR_SEPARATOR)-1)
 
 #define RSRP_NOTIFY_PARAM_INDEX	1
-#define RSRP_NOTIFY_PARAM_COUNT	5
-
 #define RSRP_PARAM_INDEX	6
-#define RSRP_PARAM_COUNT	7
-
 #define BAND_PARAM_INDEX	1 /* Index of desired parameter */
-#define BAND_PARAM_COUNT	2 /* Number of parameters */
-
 #define MODE_PARAM_INDEX	1
-#define MODE_PARAM_COUNT	2
-
 #define OPERATOR_PARAM_INDEX	3
-#define OPERATOR_PARAM_COUNT	5
-
 #define CELLID_PARAM_INDEX	4
-#define CELLID_PARAM_COUNT	10
-
 #define AREA_CODE_PARAM_INDEX	3
-#define AREA_CODE_PARAM_COUNT	10
-
 #define IP_ADDRESS_PARAM_INDEX	4
-#define IP_ADDRESS_PARAM_COUNT	7
-
 #define UICC_PARAM_INDEX	1
-#define UICC_PARAM_COUNT	2
-
 #define VBAT_PARAM_INDEX	1
-#define VBAT_PARAM_COUNT	2
-
 #define TEMP_PARAM_INDEX	1
-#define TEMP_PARAM_COUNT	2
-
 #define MODEM_FW_PARAM_INDEX	0
-#define MODEM_FW_PARAM_COUNT	1
 
 #define ICCID_PARAM_INDEX	3
-#define ICCID_PARAM_COUNT	4
 #define ICCID_LEN		20
 #define ICCID_PAD_CHAR		'F'
 
 #define LTE_MODE_PARAM_INDEX	1
 #define NBIOT_MODE_PARAM_INDEX	2
 #define GPS_MODE_PARAM_INDEX	3
-#define SYSTEMMODE_PARAM_COUNT	5
 
 #define IMSI_PARAM_INDEX	0
-#define IMSI_PARAM_COUNT	1
-
 #define MODEM_IMEI_PARAM_INDEX	0
-#define MODEM_IMEI_PARAM_COUNT  1
-
 #define DATE_TIME_PARAM_INDEX	1
-#define DATE_TIME_PARAM_COUNT	2
-
 #define APN_PARAM_INDEX		3
-#define APN_PARAM_COUNT		7
 
 struct modem_info_data {
 	const char *cmd;
 	const char *data_name;
 	uint8_t param_index;
-	uint8_t param_count;
 	enum at_param_type data_type;
 };
 
@@ -141,7 +108,6 @@ static const struct modem_info_data rsrp_data = {
 	.cmd		= AT_CMD_CESQ,
 	.data_name	= RSRP_DATA_NAME,
 	.param_index	= RSRP_PARAM_INDEX,
-	.param_count	= RSRP_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -149,7 +115,6 @@ static const struct modem_info_data band_data = {
 	.cmd		= AT_CMD_CURRENT_BAND,
 	.data_name	= CUR_BAND_DATA_NAME,
 	.param_index	= BAND_PARAM_INDEX,
-	.param_count	= BAND_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -157,7 +122,6 @@ static const struct modem_info_data band_sup_data = {
 	.cmd		= AT_CMD_SUPPORTED_BAND,
 	.data_name	= SUP_BAND_DATA_NAME,
 	.param_index	= BAND_PARAM_INDEX,
-	.param_count	= BAND_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -165,7 +129,6 @@ static const struct modem_info_data mode_data = {
 	.cmd		= AT_CMD_CURRENT_MODE,
 	.data_name	= UE_MODE_DATA_NAME,
 	.param_index	= MODE_PARAM_INDEX,
-	.param_count	= MODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -173,7 +136,6 @@ static const struct modem_info_data operator_data = {
 	.cmd		= AT_CMD_CURRENT_OP,
 	.data_name	= OPERATOR_DATA_NAME,
 	.param_index	= OPERATOR_PARAM_INDEX,
-	.param_count	= OPERATOR_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -181,7 +143,6 @@ static const struct modem_info_data mcc_data = {
 	.cmd		= AT_CMD_CURRENT_OP,
 	.data_name	= MCC_DATA_NAME,
 	.param_index	= OPERATOR_PARAM_INDEX,
-	.param_count	= OPERATOR_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -189,7 +150,6 @@ static const struct modem_info_data mnc_data = {
 	.cmd		= AT_CMD_CURRENT_OP,
 	.data_name	= MNC_DATA_NAME,
 	.param_index	= OPERATOR_PARAM_INDEX,
-	.param_count	= OPERATOR_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -197,7 +157,6 @@ static const struct modem_info_data cellid_data = {
 	.cmd		= AT_CMD_NETWORK_STATUS,
 	.data_name	= CELLID_DATA_NAME,
 	.param_index	= CELLID_PARAM_INDEX,
-	.param_count	= CELLID_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -205,7 +164,6 @@ static const struct modem_info_data area_data = {
 	.cmd		= AT_CMD_NETWORK_STATUS,
 	.data_name	= AREA_CODE_DATA_NAME,
 	.param_index	= AREA_CODE_PARAM_INDEX,
-	.param_count	= AREA_CODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -213,7 +171,6 @@ static const struct modem_info_data ip_data = {
 	.cmd		= AT_CMD_PDP_CONTEXT,
 	.data_name	= IP_ADDRESS_DATA_NAME,
 	.param_index	= IP_ADDRESS_PARAM_INDEX,
-	.param_count	= IP_ADDRESS_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -221,7 +178,6 @@ static const struct modem_info_data uicc_data = {
 	.cmd		= AT_CMD_UICC_STATE,
 	.data_name	= UICC_DATA_NAME,
 	.param_index	= UICC_PARAM_INDEX,
-	.param_count	= UICC_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -229,7 +185,6 @@ static const struct modem_info_data battery_data = {
 	.cmd		= AT_CMD_VBAT,
 	.data_name	= BATTERY_DATA_NAME,
 	.param_index	= VBAT_PARAM_INDEX,
-	.param_count	= VBAT_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -237,7 +192,6 @@ static const struct modem_info_data temp_data = {
 	.cmd		= AT_CMD_TEMP,
 	.data_name	= TEMPERATURE_DATA_NAME,
 	.param_index	= TEMP_PARAM_INDEX,
-	.param_count	= TEMP_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -245,7 +199,6 @@ static const struct modem_info_data fw_data = {
 	.cmd		= AT_CMD_FW_VERSION,
 	.data_name	= MODEM_FW_DATA_NAME,
 	.param_index	= MODEM_FW_PARAM_INDEX,
-	.param_count	= MODEM_FW_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -253,7 +206,6 @@ static const struct modem_info_data iccid_data = {
 	.cmd		= AT_CMD_ICCID,
 	.data_name	= ICCID_DATA_NAME,
 	.param_index	= ICCID_PARAM_INDEX,
-	.param_count	= ICCID_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -261,7 +213,6 @@ static const struct modem_info_data lte_mode_data = {
 	.cmd		= AT_CMD_SYSTEMMODE,
 	.data_name	= LTE_MODE_DATA_NAME,
 	.param_index	= LTE_MODE_PARAM_INDEX,
-	.param_count	= SYSTEMMODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -269,7 +220,6 @@ static const struct modem_info_data nbiot_mode_data = {
 	.cmd		= AT_CMD_SYSTEMMODE,
 	.data_name	= NBIOT_MODE_DATA_NAME,
 	.param_index	= NBIOT_MODE_PARAM_INDEX,
-	.param_count	= SYSTEMMODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -277,7 +227,6 @@ static const struct modem_info_data gps_mode_data = {
 	.cmd		= AT_CMD_SYSTEMMODE,
 	.data_name	= GPS_MODE_DATA_NAME,
 	.param_index	= GPS_MODE_PARAM_INDEX,
-	.param_count	= SYSTEMMODE_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_NUM_INT,
 };
 
@@ -285,7 +234,6 @@ static const struct modem_info_data imsi_data = {
 	.cmd		= AT_CMD_IMSI,
 	.data_name	= IMSI_DATA_NAME,
 	.param_index	= IMSI_PARAM_INDEX,
-	.param_count	= IMSI_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -293,7 +241,6 @@ static const struct modem_info_data imei_data = {
 	.cmd		= AT_CMD_IMEI,
 	.data_name	= MODEM_IMEI_DATA_NAME,
 	.param_index	= MODEM_IMEI_PARAM_INDEX,
-	.param_count	= MODEM_IMEI_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -301,7 +248,6 @@ static const struct modem_info_data date_time_data = {
 	.cmd		= AT_CMD_DATE_TIME,
 	.data_name	= DATE_TIME_DATA_NAME,
 	.param_index	= DATE_TIME_PARAM_INDEX,
-	.param_count	= DATE_TIME_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -309,7 +255,6 @@ static const struct modem_info_data apn_data = {
 	.cmd		= AT_CMD_PDP_CONTEXT,
 	.data_name	= APN_DATA_NAME,
 	.param_index	= APN_PARAM_INDEX,
-	.param_count	= APN_PARAM_COUNT,
 	.data_type	= AT_PARAM_TYPE_STRING,
 };
 
@@ -341,7 +286,6 @@ static const struct modem_info_data *const modem_data[] = {
 AT_MONITOR(modem_info_cesq_mon, "%CESQ", modem_info_rsrp_subscribe_handler, PAUSED);
 
 static rsrp_cb_t modem_info_rsrp_cb;
-static struct at_param_list m_param_list;
 
 static void flip_iccid_string(char *buf)
 {
@@ -358,28 +302,25 @@ static void flip_iccid_string(char *buf)
 }
 
 static int modem_info_parse(const struct modem_info_data *modem_data,
-			    const char *buf)
+			    const char *buf, struct at_token_cursor *resp)
 {
 	int err;
-	uint32_t param_index;
-
-	err = at_parser_max_params_from_str(buf, NULL, &m_param_list,
-					    modem_data->param_count);
 
-	if (err == -EAGAIN) {
-		LOG_DBG("More items exist to parse for: %s",
-			modem_data->data_name);
-		err = 0;
-	} else if (err != 0) {
+	/* The parameters are read from the response in place, only the
+	 * parameter at modem_data->param_index is parsed.
+	 */
+	err = at_token_cursor_init(resp, buf);
+	if (err) {
 		return err;
 	}
 
-	param_index = at_params_valid_count_get(&m_param_list);
-	if (param_index > modem_data->param_count) {
-		return -EAGAIN;
+	if (at_token_type_get(resp, modem_data->param_index) == AT_PARAM_TYPE_INVALID) {
+		LOG_DBG("No parameter %d for: %s", modem_data->param_index,
+			modem_data->data_name);
+		return -EINVAL;
 	}
 
-	return err;
+	return 0;
 }
 
 enum at_param_type modem_info_type_get(enum modem_info info_type)
@@ -416,6 +357,7 @@ int modem_info_short_get(enum modem_info info, uint16_t *buf)
 {
 	int err;
 	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE] = {0};
+	struct at_token_cursor resp;
 
 	if (buf == NULL) {
 		return -EINVAL;
@@ -430,14 +372,14 @@ int modem_info_short_get(enum modem_info info, uint16_t *buf)
 		return -EIO;
 	}
 
-	err = modem_info_parse(modem_data[info], recv_buf);
+	err = modem_info_parse(modem_data[info], recv_buf, &resp);
 	if (err) {
 		return err;
 	}
 
-	err = at_params_unsigned_short_get(&m_param_list,
-					   modem_data[info]->param_index,
-					   buf);
+	err = at_token_unsigned_short_get(&resp,
+					  modem_data[info]->param_index,
+					  buf);
 
 	if (err) {
 		return err;
@@ -462,6 +404,7 @@ static int parse_ip_addresses(char *out_buf, size_t out_buf_size, char *in_buf)
 	char ip_buf[INET_ADDRSTRLEN + sizeof(" ") + INET6_ADDRSTRLEN];
 	char *ip_v6_str;
 	bool first_address;
+	struct at_token_cursor resp;
 
 	p = strstr(in_buf, "OK\r\n");
 	if (!p) {
@@ -501,21 +444,21 @@ parse_line:
 	line_len = str_end - &in_buf[line_start_idx];
 	in_buf[++line_len + line_start_idx] = '\0';
 
-	err = modem_info_parse(modem_data[MODEM_INFO_IP_ADDRESS], &in_buf[line_start_idx]);
+	err = modem_info_parse(modem_data[MODEM_INFO_IP_ADDRESS], &in_buf[line_start_idx], &resp);
 	if (err) {
 		LOG_ERR("Unable to parse data: %d", err);
 		return err;
 	}
 
 	len = sizeof(ip_buf);
-	err = at_params_string_get(&m_param_list,
-				   modem_data[MODEM_INFO_IP_ADDRESS]->param_index,
-				   ip_buf,
-				   &len);
-	if (err != 0) {
-		return err;
-	} else if (len >= sizeof(ip_buf)) {
+	err = at_token_string_get(&resp,
+				  modem_data[MODEM_INFO_IP_ADDRESS]->param_index,
+				  ip_buf,
+				  &len);
+	if (err == -ENOMEM) {
 		return -EMSGSIZE;
+	} else if (err != 0) {
+		return err;
 	}
 
 	if (len == 0) {
@@ -529,8 +472,6 @@ parse_line:
 		}
 	}
 
-	ip_buf[len] = '\0';
-
 	/* For now get only IPv4 address if both v4 and v6 are given,
 	 * discard IPv6 which are separated by a space.
 	 */
@@ -574,14 +515,9 @@ int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size
 	char recv_buf[CONFIG_MODEM_INFO_BUFFER_SIZE] = {0};
 	uint16_t param_value;
 	char *str_end = recv_buf;
-	/* tracks length of buf when parsing multiple IP addresses */
-	size_t out_buf_len = 0;
 	/* return value indicating length of the string written to buf */
 	size_t len = 0;
-	/* The accumulated length written to buf when a command has more than
-	 * one elements, such as multiple IP addresses.
-	 */
-	size_t accumulated_len = 0;
+	struct at_token_cursor resp;
 
 	if ((buf == NULL) || (buf_size == 0)) {
 		return -EINVAL;
@@ -620,20 +556,20 @@ int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size
 		return len;
 	}
 
-	err = modem_info_parse(modem_data[info], recv_buf);
+	if (info == MODEM_INFO_IP_ADDRESS) {
+		return parse_ip_addresses(buf, buf_size, recv_buf);
+	}
+
+	err = modem_info_parse(modem_data[info], recv_buf, &resp);
 	if (err) {
 		LOG_ERR("Unable to parse data: %d", err);
 		return err;
 	}
 
-	if (info == MODEM_INFO_IP_ADDRESS) {
-		return parse_ip_addresses(buf, buf_size, recv_buf);
-	}
-
 	if (modem_data[info]->data_type == AT_PARAM_TYPE_NUM_INT) {
-		err = at_params_unsigned_short_get(&m_param_list,
-						    modem_data[info]->param_index,
-						    &param_value);
+		err = at_token_unsigned_short_get(&resp,
+						  modem_data[info]->param_index,
+						  &param_value);
 		if (err) {
 			LOG_ERR("Unable to obtain short: %d", err);
 			return err;
@@ -644,20 +580,16 @@ int modem_info_string_get(enum modem_info info, char *buf, const size_t buf_size
 			return -EMSGSIZE;
 		}
 	} else if (modem_data[info]->data_type == AT_PARAM_TYPE_STRING) {
-		len = buf_size - out_buf_len;
-		err = at_params_string_get(&m_param_list,
-					   modem_data[info]->param_index,
-					   &buf[out_buf_len],
-					   &len);
-		if (err != 0) {
-			return err;
-		} else if (len >= buf_size) {
+		len = buf_size;
+		err = at_token_string_get(&resp,
+					  modem_data[info]->param_index,
+					  buf,
+					  &len);
+		if (err == -ENOMEM) {
 			return -EMSGSIZE;
-
+		} else if (err != 0) {
+			return err;
 		}
-
-		accumulated_len += len;
-		buf[accumulated_len] = '\0';
 	}
 
 	if (info == MODEM_INFO_ICCID) {
@@ -678,25 +610,25 @@ static void modem_info_rsrp_subscribe_handler(const char *notif)
 {
 	int err;
 	uint16_t param_value;
+	struct at_token_cursor resp;
 
 	const struct modem_info_data rsrp_notify_data = {
 		.cmd		= AT_CMD_CESQ,
 		.data_name	= RSRP_DATA_NAME,
 		.param_index	= RSRP_NOTIFY_PARAM_INDEX,
-		.param_count	= RSRP_NOTIFY_PARAM_COUNT,
 		.data_type	= AT_PARAM_TYPE_NUM_INT,
 	};
 
-	err = modem_info_parse(&rsrp_notify_data, notif);
+	err = modem_info_parse(&rsrp_notify_data, notif, &resp);
 	if (err != 0) {
 		LOG_ERR("modem_info_parse failed to parse "
 			"CESQ notification, %d", err);
 		return;
 	}
 
-	err = at_params_unsigned_short_get(&m_param_list,
-					   rsrp_notify_data.param_index,
-					   &param_value);
+	err = at_token_unsigned_short_get(&resp,
+					  rsrp_notify_data.param_index,
+					  &param_value);
 	if (err != 0) {
 		LOG_ERR("Failed to obtain RSRP value, %d", err);
 		return;
@@ -720,13 +652,6 @@ int modem_info_rsrp_register(rsrp_cb_t cb)
 
 int modem_info_init(void)
 {
-	int err = 0;
-
-	if (m_param_list.params == NULL) {
-		/* Init at_cmd_parser storage module */
-		err = at_params_list_init(&m_param_list,
-					  CONFIG_MODEM_INFO_MAX_AT_PARAMS_RSP);
-	}
-
-	return err;
+	/* Responses are parsed in place, there is nothing to allocate. */
+	return 0;
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <zephyr/kernel.h>
 #include <zephyr/types.h>
 #include <zephyr/sys/printk.h>
 #include <pm_config.h>
@@ -16,6 +17,16 @@
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
 
+static struct bl_validate_fw_stream fw_stream;
+
+/* Called by PCD with each buffer of the update as read back from flash. */
+static int fw_stream_update(uint8_t *buf, size_t len, size_t offset)
+{
+	ARG_UNUSED(offset);
+
+	return bl_validate_firmware_stream_update(&fw_stream, buf, len);
+}
+
 void main(void)
 {
 	int err;
@@ -48,7 +59,21 @@ void main(void)
 			goto failure;
 		}
 
-		err = pcd_fw_copy(fdev);
+		const struct fw_info *update_info = fw_info_find(update_addr);
+
+		err = bl_validate_firmware_stream_init(&fw_stream, s0_addr,
+						       update_info->size);
+		if (err != 0) {
+			printk("Failed to start validation: %d\n\r", err);
+			goto failure;
+		}
+
+		uint32_t start = k_cycle_get_32();
+
+		/* The image is hashed while it is copied, from the data read
+		 * back from flash after each write.
+		 */
+		err = pcd_fw_copy_cb(fdev, fw_stream_update);
 		if (err != 0) {
 			printk("Failed to transfer image: %d\n\r", err);
 			goto failure;
@@ -59,7 +84,18 @@ void main(void)
 		 * is performed by the application core. This check is only
 		 * done to verify that the flash copy operation was successful.
 		 */
-		valid = bl_validate_firmware(s0_addr, s0_addr);
+		valid = bl_validate_firmware_stream_finish(&fw_stream);
+
+		if (IS_ENABLED(CONFIG_NETBOOT_PRINT_COPY_TIME)) {
+			printk("Copied and validated %u bytes in %u cycles\n\r",
+				update_info->size, k_cycle_get_32() - start);
+
+			start = k_cycle_get_32();
+			(void)bl_validate_firmware(s0_addr, s0_addr);
+			printk("Validating them again in place takes %u cycles\n\r",
+				k_cycle_get_32() - start);
+		}
+
 		if (valid) {
 			pcd_fw_copy_done();
 		} else {
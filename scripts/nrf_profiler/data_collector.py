@@ -10,6 +10,9 @@ import logging
 import signal
 from stream import Stream
 from rtt2stream import Rtt2Stream
+from uart2stream import Uart2Stream
+from rtt_nordic_config import RttNordicConfig
+from uart_nordic_config import UartNordicConfig
 from model_creator import ModelCreator
 
 is_waiting = True
@@ -26,12 +29,23 @@ def rtt2stream(stream, event, event_close, log_lvl_number):
     except Exception as e:
         print("[ERROR] Unhandled exception in Profiler Rtt to stream module: {}".format(e))
 
-def model_creator(stream, event, event_close, dataset_name, log_lvl_number):
+def uart2stream(stream, event, event_close, port, baudrate, dump, log_lvl_number):
+    signal.signal(signal.SIGINT, signal.SIG_IGN)
+    try:
+        uart2s = Uart2Stream(stream, event_close, port, baudrate=baudrate, dump_filename=dump,
+                             log_lvl=log_lvl_number)
+        event.wait()
+        uart2s.read_and_transmit_data()
+    except Exception as e:
+        print("[ERROR] Unhandled exception in Profiler UART to stream module: {}".format(e))
+
+def model_creator(stream, event, event_close, dataset_name, config, log_lvl_number):
     signal.signal(signal.SIGINT, signal.SIG_IGN)
     try:
         mc = ModelCreator(stream,
                           event_close,
                           sending_events=False,
+                          config=config,
                           event_filename=dataset_name + ".csv",
                           event_types_filename=dataset_name + ".json",
                           log_lvl=log_lvl_number)
@@ -49,6 +63,9 @@ def main():
     parser.add_argument('time', type=int, help='Time of collecting data [s]')
     parser.add_argument('dataset_name', help='Name of dataset')
     parser.add_argument('--log', help='Log level')
+    parser.add_argument('--uart', help='Serial port used by Stream nrf_profiler backend')
+    parser.add_argument('--baudrate', type=int, help='Baudrate of the serial port')
+    parser.add_argument('--dump', help='File to store raw data received over serial port')
     args = parser.parse_args()
 
     if args.log is not None:
@@ -65,13 +82,22 @@ def main():
     streams = Stream.create_stream(2)
 
     processes = []
-    processes.append((Process(target=rtt2stream,
-                                args=(streams[0], event, event_close_rtt2stream, log_lvl_number),
-                                daemon=True),
-                        event_close_rtt2stream))
+    if args.uart is not None:
+        config = UartNordicConfig
+        processes.append((Process(target=uart2stream,
+                                    args=(streams[0], event, event_close_rtt2stream, args.uart,
+                                        args.baudrate, args.dump, log_lvl_number),
+                                    daemon=True),
+                            event_close_rtt2stream))
+    else:
+        config = RttNordicConfig
+        processes.append((Process(target=rtt2stream,
+                                    args=(streams[0], event, event_close_rtt2stream, log_lvl_number),
+                                    daemon=True),
+                            event_close_rtt2stream))
     processes.append((Process(target=model_creator,
                                 args=(streams[1], event, event_close_model_creator,
-                                    args.dataset_name, log_lvl_number),
+                                    args.dataset_name, config, log_lvl_number),
                                 daemon=True),
                         event_close_model_creator))
 
@@ -4,6 +4,7 @@
 # SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
 
 import csv
+import struct
 from io import StringIO
 from ast import literal_eval
 
@@ -41,6 +42,10 @@ class EventType():
 
 
 class TrackedEvent():
+    # Every serialized event in a batch is preceded by its length, as event
+    # data may contain any character.
+    BATCH_LEN_FORMAT = '<I'
+    BATCH_LEN_SIZE = struct.calcsize(BATCH_LEN_FORMAT)
     TRACKED_EVENT_FIELDNAMES = ['type_id', 'timestamp', 'data', 'proc_start_time', 'proc_end_time']
     si = StringIO()
     wr = csv.DictWriter(si, delimiter=',', fieldnames=TRACKED_EVENT_FIELDNAMES)
@@ -81,6 +86,21 @@ class TrackedEvent():
         proc_end_time = float(row['proc_end_time']) if row['proc_end_time'] != '' else None
         return TrackedEvent(Event(type_id, timestamp, data), proc_start_time, proc_end_time)
 
+    @staticmethod
+    def batch_pack(events_bytes):
+        return b''.join(struct.pack(TrackedEvent.BATCH_LEN_FORMAT, len(event_bytes)) + event_bytes
+                        for event_bytes in events_bytes)
+
+    @staticmethod
+    def batch_unpack(batch):
+        pos = 0
+        while pos < len(batch):
+            event_len, = struct.unpack_from(TrackedEvent.BATCH_LEN_FORMAT, batch, pos)
+            pos += TrackedEvent.BATCH_LEN_SIZE
+            assert pos + event_len <= len(batch)
+            yield batch[pos:pos + event_len]
+            pos += event_len
+
 class EventsData():
     def __init__(self, events, registered_events_types):
         self.events = events
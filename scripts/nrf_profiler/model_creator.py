@@ -10,7 +10,8 @@ import json
 from rtt_nordic_config import RttNordicConfig
 from events import Event, EventType, TrackedEvent, EventsData
 from processed_events import ProcessedEvents
-from stream import StreamError
+from stream import Stream, StreamError
+from stream_decoder import create_decoder, StreamDecoderError
 from io import StringIO
 import csv
 
@@ -46,8 +47,7 @@ class ModelCreator:
         self.stream.set_timeouts(timeouts)
         self.sending = sending_events
 
-        self.timestamp_overflows = 0
-        self.after_half = False
+        self.decoder = None
 
         self.processed_events = ProcessedEvents()
         self.temp_events = []
@@ -58,9 +58,6 @@ class ModelCreator:
         self.submit_event = None
         self.start_event = None
 
-        self.bufs = list()
-        self.bcnt = 0
-
         self.logger = logging.getLogger('Profiler model creator')
         self.logger_console = logging.StreamHandler()
         self.logger.setLevel(log_lvl)
@@ -74,24 +71,8 @@ class ModelCreator:
                                                                self.event_filename,
                                                                self.event_types_filename)
 
-    def _get_buffered_data(self, num_bytes):
-        buf = bytearray()
-        while len(buf) < num_bytes:
-            tbuf = self.bufs[0]
-            size = num_bytes - len(buf)
-            if len(tbuf) <= size:
-                buf.extend(tbuf)
-                del self.bufs[0]
-            else:
-                buf.extend(tbuf[0:size])
-                self.bufs[0] = tbuf[size:]
-        self.bcnt -= num_bytes
-        return buf
-
-    def _read_bytes(self, num_bytes):
+    def _read_events(self):
         while True:
-            if self.bcnt >= num_bytes:
-                break
             try:
                 buf = self.stream.recv_ev()
             except StreamError as err:
@@ -102,16 +83,23 @@ class ModelCreator:
                 self.logger.error("Receiving error: {}".format(err))
                 self.close()
             if len(buf) > 0:
-                self.bufs.append(buf)
-                self.bcnt += len(buf)
+                break
 
-        return self._get_buffered_data(num_bytes)
+        dropped = self.decoder.dropped
+        corrupted = getattr(self.decoder, 'corrupted', 0)
+        try:
+            events = self.decoder.feed(buf)
+        except (StreamDecoderError, KeyError) as err:
+            self.logger.error("Cannot decode received data: {}".format(err))
+            self.close()
 
-    def _timestamp_from_ticks(self, clock_ticks):
-        ts_ticks_aggregated = self.timestamp_overflows * self.config['timestamp_raw_max']
-        ts_ticks_aggregated += clock_ticks
-        ts_s = ts_ticks_aggregated * self.config['ms_per_timestamp_tick'] / 1000
-        return ts_s
+        if self.decoder.dropped != dropped:
+            self.logger.warning("{} events dropped on device. Ring buffer has overflown."
+                                .format(self.decoder.dropped - dropped))
+        if getattr(self.decoder, 'corrupted', 0) != corrupted:
+            self.logger.warning("{} malformed frames skipped. Data was lost in transmission."
+                                .format(self.decoder.corrupted - corrupted))
+        return events
 
     def transmit_all_events_descriptions(self):
         while True:
@@ -146,6 +134,8 @@ class ModelCreator:
         self.event_processing_end_id = \
             self.raw_data.get_event_type_id('event_processing_end')
 
+        self.decoder = create_decoder(self.raw_data.registered_events_types, self.config)
+
         if self.sending:
             event_types_dict = dict((k, v.serialize())
                     for k, v in self.processed_events.registered_events_types.items())
@@ -156,85 +146,26 @@ class ModelCreator:
                 self.logger.error("Sending error: {}. Cannot send descriptions.".format(err))
                 sys.exit()
 
-    def _read_single_event(self):
-        id = int.from_bytes(
-            self._read_bytes(1),
-            byteorder=self.config['byteorder'],
-            signed=False)
-        et = self.raw_data.registered_events_types[id]
-
-        buf = self._read_bytes(4)
-        timestamp_raw = (
-            int.from_bytes(
-                buf,
-                byteorder=self.config['byteorder'],
-                signed=False))
-
-        if self.after_half \
-        and timestamp_raw < 0.4 * self.config['timestamp_raw_max']:
-            self.timestamp_overflows += 1
-            self.after_half = False
-
-        if timestamp_raw > 0.6 * self.config['timestamp_raw_max']:
-            self.after_half = True
-
-        timestamp = self._timestamp_from_ticks(timestamp_raw)
-
-        def process_int32(self, data):
-            buf = self._read_bytes(4)
-            data.append(int.from_bytes(buf, byteorder=self.config['byteorder'],
-                                       signed=True))
-
-        def process_uint32(self, data):
-            buf = self._read_bytes(4)
-            data.append(int.from_bytes(buf, byteorder=self.config['byteorder'],
-                                       signed=False))
-
-        def process_int16(self, data):
-            buf = self._read_bytes(2)
-            data.append(int.from_bytes(buf, byteorder=self.config['byteorder'],
-                                       signed=True))
-
-        def process_uint16(self, data):
-            buf = self._read_bytes(2)
-            data.append(int.from_bytes(buf, byteorder=self.config['byteorder'],
-                                       signed=False))
-
-        def process_int8(self, data):
-            buf = self._read_bytes(1)
-            data.append(int.from_bytes(buf, byteorder=self.config['byteorder'],
-                                       signed=True))
-
-        def process_uint8(self, data):
-            buf = self._read_bytes(1)
-            data.append(int.from_bytes(buf, byteorder=self.config['byteorder'],
-                                       signed=False))
-
-        def process_string(self, data):
-            buf = self._read_bytes(1)
-            buf = self._read_bytes(int.from_bytes(buf, byteorder=self.config['byteorder'],
-                                                  signed=False))
-            data.append(buf.decode())
-
-        READ_BYTES = {
-            "u8": process_uint8,
-            "s8": process_int8,
-            "u16": process_uint16,
-            "s16": process_int16,
-            "u32": process_uint32,
-            "s32": process_int32,
-            "s": process_string,
-            "t": process_uint32
-        }
-        data=[]
-        for event_data_type in et.data_types:
-            READ_BYTES[event_data_type](self, data)
-        return Event(id, timestamp, data)
-
-    def _send_event(self, tracked_event):
-        event_string = tracked_event.serialize()
+    def _send_events(self, tracked_events):
+        # Events are sent in batches to reduce the number of transfers between processes.
+        batch = []
+        batch_len = 0
+        for tracked_event in tracked_events:
+            event_bytes = tracked_event.serialize().encode()
+            event_len = TrackedEvent.BATCH_LEN_SIZE + len(event_bytes)
+            if batch_len + event_len > Stream.RECV_BUF_SIZE:
+                self._send_batch(batch)
+                batch = []
+                batch_len = 0
+            batch.append(event_bytes)
+            batch_len += event_len
+
+        if len(batch) > 0:
+            self._send_batch(batch)
+
+    def _send_batch(self, batch):
         try:
-            self.stream.send_ev(event_string.encode())
+            self.stream.send_ev(TrackedEvent.batch_pack(batch))
         except StreamError as err:
             self.logger.error("Sending error: {}. Cannot send event.".format(err))
             self.close()
@@ -252,46 +183,51 @@ class ModelCreator:
                 self.event_filename,
                 self.event_types_filename)
         while True:
-            event = self._read_single_event()
-            if self.raw_data.registered_events_types[event.type_id].name == NRF_PROFILER_FATAL_ERROR_EVENT_NAME:
-                self.logger.error("Fatal error of Profiler on device! Event has been dropped. "
-                                  "Data buffer has overflown. No more events will be received.")
-
-            if event.type_id == self.event_processing_start_id:
-                self.start_event = event
-                for i in range(len(self.temp_events) - 1, -1, -1):
-                    # comparing memory addresses of event processing start
-                    # and event submit to identify matching events
-                    if self.temp_events[i].data[0] == self.start_event.data[0]:
-                        self.submit_event = self.temp_events[i]
-                        self.submitted_event_type = self.submit_event.type_id
-                        del self.temp_events[i]
-                        break
-
-            elif event.type_id == self.event_processing_end_id:
-                # comparing memory addresses of event processing start and
-                # end to identify matching events
-                if self.submitted_event_type is not None and event.data[0] \
-                            == self.start_event.data[0]:
-                    tracked_event = TrackedEvent(
-                            self.submit_event,
-                            self.start_event.timestamp,
-                            event.timestamp)
-                    if self.csvfile is not None:
-                        self._write_event_to_file(self.csvfile, tracked_event)
-                    if self.sending:
-                        self._send_event(tracked_event)
-                    self.submitted_event_type = None
-
-            elif not self.processed_events.is_event_tracked(event.type_id):
-                tracked_event = TrackedEvent(event, None, None)
-                if self.csvfile is not None:
+            tracked_events = []
+            for event in self._read_events():
+                tracked_event = self._process_event(event)
+                if tracked_event is not None:
+                    tracked_events.append(tracked_event)
+
+            if self.csvfile is not None:
+                for tracked_event in tracked_events:
                     self._write_event_to_file(self.csvfile, tracked_event)
-                if self.sending:
-                    self._send_event(tracked_event)
-
-            else:
-                self.temp_events.append(event)
+            if self.sending:
+                self._send_events(tracked_events)
+
+    def _process_event(self, event):
+        if self.raw_data.registered_events_types[event.type_id].name == NRF_PROFILER_FATAL_ERROR_EVENT_NAME:
+            self.logger.error("Fatal error of Profiler on device! Event has been dropped. "
+                              "Data buffer has overflown. No more events will be received.")
+
+        if event.type_id == self.event_processing_start_id:
+            self.start_event = event
+            for i in range(len(self.temp_events) - 1, -1, -1):
+                # comparing memory addresses of event processing start
+                # and event submit to identify matching events
+                if self.temp_events[i].data[0] == self.start_event.data[0]:
+                    self.submit_event = self.temp_events[i]
+                    self.submitted_event_type = self.submit_event.type_id
+                    del self.temp_events[i]
+                    break
+
+        elif event.type_id == self.event_processing_end_id:
+            # comparing memory addresses of event processing start and
+            # end to identify matching events
+            if self.submitted_event_type is not None and event.data[0] \
+                        == self.start_event.data[0]:
+                self.submitted_event_type = None
+                return TrackedEvent(self.submit_event,
+                                    self.start_event.timestamp,
+                                    event.timestamp)
+
+        elif not self.processed_events.is_event_tracked(event.type_id):
+            return TrackedEvent(event, None, None)
+
+        else:
+            self.temp_events.append(event)
+
+        return None
 
     def start(self):
         self.transmit_all_events_descriptions()
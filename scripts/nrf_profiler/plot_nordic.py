@@ -402,23 +402,23 @@ class PlotNordic():
                 self.logger.error("Receiving error: {}. Exiting".format(err))
                 self.close_event(None)
                 sys.exit()
-            data_str = data.decode()
-            tracked_event = TrackedEvent.deserialize(data_str)
-
-            events.append(tracked_event.submit)
-            self.processed_events.tracked_events.append(tracked_event)
-
-            if tracked_event.proc_start_time is not None:
-                assert tracked_event.proc_end_time is not None
-                rects.append(
-                    matplotlib.patches.Rectangle(
-                        (tracked_event.proc_start_time,
-                            tracked_event.submit.type_id -
-                            self.draw_state.event_processing_rect_height/2),
-                        tracked_event.proc_end_time -
-                        tracked_event.proc_start_time,
-                        self.draw_state.event_processing_rect_height,
-                        edgecolor='black'))
+            for event_bytes in TrackedEvent.batch_unpack(data):
+                tracked_event = TrackedEvent.deserialize(event_bytes.decode())
+
+                events.append(tracked_event.submit)
+                self.processed_events.tracked_events.append(tracked_event)
+
+                if tracked_event.proc_start_time is not None:
+                    assert tracked_event.proc_end_time is not None
+                    rects.append(
+                        matplotlib.patches.Rectangle(
+                            (tracked_event.proc_start_time,
+                                tracked_event.submit.type_id -
+                                self.draw_state.event_processing_rect_height/2),
+                            tracked_event.proc_end_time -
+                            tracked_event.proc_start_time,
+                            self.draw_state.event_processing_rect_height,
+                            edgecolor='black'))
 
         # translating plot
         if not self.draw_state.synchronized_with_events:
@@ -4,6 +4,7 @@
 # SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
 
 RttNordicConfig = {
+    'stream_format': 'raw',
     'device_snr': None,
     'rtt_up_channel_names':  {
         'Nordic nrf_profiler info': 'info',
@@ -0,0 +1,292 @@
+#
+# Copyright (c) 2022 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+import struct
+from events import Event
+
+class Frame():
+    # Frame IDs that are not used by event types.
+    TIME = 0xFC
+    CLOCK = 0xFD
+    DESCR = 0xFE
+    DROP = 0xFF
+    HDR_LEN = 2
+    # Frames are COBS-encoded and terminated with the delimiter.
+    DELIMITER = 0x00
+
+def cobs_decode(data):
+    """Decode a COBS-encoded frame. Returns None if the data is malformed."""
+    out = bytearray()
+    pos = 0
+    end = len(data)
+    while pos < end:
+        code = data[pos]
+        pos += 1
+        if code == 0 or pos + code - 1 > end:
+            return None
+        out += data[pos:pos + code - 1]
+        pos += code - 1
+        if code != 0xFF and pos < end:
+            out.append(0)
+    return out
+
+def decode_frame(encoded):
+    """Decode a single frame. Returns (frame ID, body) or None if the frame is
+    malformed.
+    """
+    frame = cobs_decode(encoded)
+    if frame is None or len(frame) < Frame.HDR_LEN or \
+       len(frame) != Frame.HDR_LEN + frame[1]:
+        return None
+    return frame[0], bytes(frame[Frame.HDR_LEN:])
+
+class StreamDecoderError(Exception):
+    pass
+
+class EventDecoder():
+    """Incremental decoder of nrf_profiler events.
+
+    Data can be fed in chunks of any size. Bytes of an incomplete event are kept
+    until the next call of the feed method. Every event type is decoded using
+    precompiled structures, so fixed-size data fields of an event are unpacked
+    with a single call.
+    """
+
+    FORMATS = {
+        "u8": "B",
+        "s8": "b",
+        "u16": "H",
+        "s16": "h",
+        "u32": "I",
+        "s32": "i",
+        "t": "I"
+    }
+
+    def __init__(self, event_types, config):
+        self.config = config
+        self.prefix = '<' if config['byteorder'] == 'little' else '>'
+        self.parsers = dict((id, self._compile(et.data_types))
+                            for id, et in event_types.items())
+        self.buf = bytearray()
+        self.seconds_per_tick = config['ms_per_timestamp_tick'] / 1000
+        self.dropped = 0
+
+    def _compile(self, data_types):
+        steps = []
+        fmt = ''
+        for data_type in data_types:
+            if data_type == 's':
+                if fmt:
+                    steps.append(struct.Struct(self.prefix + fmt))
+                    fmt = ''
+                # Strings are prefixed with one byte of length.
+                steps.append(None)
+            else:
+                fmt += EventDecoder.FORMATS[data_type]
+        if fmt:
+            steps.append(struct.Struct(self.prefix + fmt))
+        return steps
+
+    @staticmethod
+    def _decode_data(steps, buf, pos, end):
+        data = []
+        for step in steps:
+            if step is None:
+                if pos >= end:
+                    return None, pos
+                str_len = buf[pos]
+                pos += 1
+                if pos + str_len > end:
+                    return None, pos
+                data.append(bytes(buf[pos:pos + str_len]).decode())
+                pos += str_len
+            else:
+                if pos + step.size > end:
+                    return None, pos
+                data.extend(step.unpack_from(buf, pos))
+                pos += step.size
+        return data, pos
+
+    def _decode(self, buf):
+        raise NotImplementedError
+
+    def feed(self, data):
+        """Decode received bytes and return the list of complete events."""
+        self.buf.extend(data)
+        events, pos = self._decode(self.buf)
+        del self.buf[:pos]
+        return events
+
+class RawEventDecoder(EventDecoder):
+    """Decoder of the data sent by the Nordic (RTT) nrf_profiler backend.
+
+    Every event is sent as one byte of event type ID, 32-bit timestamp and
+    event data.
+    """
+
+    def __init__(self, event_types, config):
+        super().__init__(event_types, config)
+        self.header = struct.Struct(self.prefix + 'BI')
+        self.timestamp_raw_max = config['timestamp_raw_max']
+        self.timestamp_overflows = 0
+        self.after_half = False
+
+    def _decode(self, buf):
+        events = []
+        pos = 0
+        end = len(buf)
+        while pos + self.header.size <= end:
+            type_id, timestamp_raw = self.header.unpack_from(buf, pos)
+            data, data_end = self._decode_data(self.parsers[type_id], buf,
+                                               pos + self.header.size, end)
+            if data is None:
+                break
+            pos = data_end
+
+            if self.after_half and timestamp_raw < 0.4 * self.timestamp_raw_max:
+                self.timestamp_overflows += 1
+                self.after_half = False
+
+            if timestamp_raw > 0.6 * self.timestamp_raw_max:
+                self.after_half = True
+
+            ticks = self.timestamp_overflows * self.timestamp_raw_max + timestamp_raw
+            events.append(Event(type_id, ticks * self.seconds_per_tick, data))
+
+        return events, pos
+
+class FrameEventDecoder(EventDecoder):
+    """Decoder of the frames sent by the Stream nrf_profiler backend.
+
+    Every frame consists of one byte of frame ID, one byte of body length and
+    the frame body. It is COBS-encoded and terminated with a zero byte. Event
+    frames use event type ID as frame ID. Body of the event frame starts with
+    zigzag-encoded varint timestamp difference to the previous event, followed
+    by the event data. The time frame carries the absolute timestamp that the
+    following difference refers to.
+
+    Malformed frames are skipped and counted, decoding continues from the next
+    delimiter.
+    """
+
+    def __init__(self, event_types, config):
+        super().__init__(event_types, config)
+        self.clock = struct.Struct(self.prefix + 'II')
+        self.drop = struct.Struct(self.prefix + 'I')
+        self.time = struct.Struct(self.prefix + 'I')
+        self.timestamp_raw_max = config['timestamp_raw_max']
+        self.ticks = 0
+        self.synced = False
+        self.corrupted = 0
+
+    @staticmethod
+    def _decode_varint(buf, pos, end):
+        value = 0
+        shift = 0
+        while pos < end:
+            byte = buf[pos]
+            pos += 1
+            value |= (byte & 0x7F) << shift
+            if byte < 0x80:
+                return value, pos
+            shift += 7
+        raise StreamDecoderError("Truncated timestamp")
+
+    def _set_time(self, timestamp_raw):
+        # Restore the absolute time, keeping the number of timestamp
+        # overflows counted so far.
+        ticks = self.ticks - self.ticks % self.timestamp_raw_max + timestamp_raw
+        if ticks - self.ticks > self.timestamp_raw_max // 2:
+            ticks -= self.timestamp_raw_max
+        elif self.ticks - ticks > self.timestamp_raw_max // 2:
+            ticks += self.timestamp_raw_max
+        self.ticks = ticks
+
+    def _decode_frame(self, frame_id, body):
+        if frame_id == Frame.CLOCK:
+            if len(body) != self.clock.size:
+                return None
+            freq, self.ticks = self.clock.unpack(body)
+            self.seconds_per_tick = 1 / freq
+        elif frame_id == Frame.TIME:
+            if len(body) != self.time.size:
+                return None
+            self._set_time(self.time.unpack(body)[0])
+        elif frame_id == Frame.DROP:
+            if len(body) != self.drop.size:
+                return None
+            self.dropped += self.drop.unpack(body)[0]
+        elif frame_id == Frame.DESCR:
+            pass
+        elif frame_id in self.parsers:
+            try:
+                zigzag, data_start = self._decode_varint(body, 0, len(body))
+            except StreamDecoderError:
+                return None
+            data, data_end = self._decode_data(self.parsers[frame_id], body,
+                                               data_start, len(body))
+            if data is None or data_end != len(body):
+                return None
+            self.ticks += (zigzag >> 1) ^ -(zigzag & 1)
+            return Event(frame_id, self.ticks * self.seconds_per_tick, data)
+        else:
+            return None
+        return True
+
+    def _decode(self, buf):
+        events = []
+        encoded_frames, pos = split_encoded_frames(buf)
+        for encoded in encoded_frames:
+            if not self.synced:
+                # Data before the first delimiter can be a part of a frame.
+                self.synced = True
+                if len(encoded) > 0:
+                    continue
+            if len(encoded) == 0:
+                continue
+
+            frame = decode_frame(encoded)
+            result = None
+            if frame is not None:
+                try:
+                    result = self._decode_frame(*frame)
+                except (UnicodeDecodeError, struct.error):
+                    result = None
+            if result is None:
+                self.corrupted += 1
+            elif isinstance(result, Event):
+                events.append(result)
+
+        return events, pos
+
+def split_encoded_frames(buf):
+    """Split buffer into COBS-encoded frames terminated with the delimiter.
+
+    Returns the list of encoded frames and the number of consumed bytes.
+    """
+    frames = []
+    pos = 0
+    while True:
+        end = buf.find(Frame.DELIMITER, pos)
+        if end < 0:
+            break
+        frames.append(bytes(buf[pos:end]))
+        pos = end + 1
+    return frames, pos
+
+def split_frames(buf):
+    """Split buffer into complete frames. Malformed frames are skipped.
+
+    Returns the list of (frame ID, body) tuples and the number of consumed bytes.
+    """
+    encoded_frames, pos = split_encoded_frames(buf)
+    frames = [frame for frame in map(decode_frame, encoded_frames)
+              if frame is not None]
+    return frames, pos
+
+def create_decoder(event_types, config):
+    if config.get('stream_format') == 'frame':
+        return FrameEventDecoder(event_types, config)
+    return RawEventDecoder(event_types, config)
@@ -0,0 +1,162 @@
+#
+# Copyright (c) 2022 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+from uart_nordic_config import UartNordicConfig
+import sys
+import logging
+import time
+import serial
+from enum import Enum
+from stream import Stream, StreamError
+from stream_decoder import Frame, split_frames
+
+class Command(Enum):
+    START = 1
+    STOP = 2
+    INFO = 3
+
+class Uart2Stream:
+    def __init__(self, out_stream, event_close, port, baudrate=None, dump_filename=None,
+                 config=UartNordicConfig, log_lvl=logging.INFO):
+        self.config = config
+
+        self.out_stream = out_stream
+
+        self.event_close = event_close
+
+        self.logger = logging.getLogger('Profiler UART to stream')
+        self.logger_console = logging.StreamHandler()
+        self.logger.setLevel(log_lvl)
+        self.log_format = logging.Formatter('[%(levelname)s] %(name)s: %(message)s')
+        self.logger_console.setFormatter(self.log_format)
+        self.logger.addHandler(self.logger_console)
+
+        if baudrate is None:
+            baudrate = self.config['baudrate']
+
+        try:
+            # Native UART of native_posix is a pseudoterminal that can be
+            # opened in the same way as a serial port.
+            self.uart = serial.Serial(port, baudrate, timeout=0)
+        except serial.SerialException as err:
+            self.logger.error("Cannot open {}: {}".format(port, err))
+            sys.exit()
+
+        self.dump_file = None
+        if dump_filename is not None:
+            self.dump_file = open(dump_filename, 'wb')
+
+        self.logger.info("Connected to device via {}".format(port))
+
+    def _read_bytes(self):
+        try:
+            buf = self.uart.read(self.config['uart_read_chunk_size'])
+        except serial.SerialException:
+            self.logger.error("Problem with reading UART data")
+            self._disconnect()
+            sys.exit()
+
+        if self.dump_file is not None:
+            self.dump_file.write(buf)
+
+        return buf
+
+    def _disconnect(self):
+        self.uart.close()
+        if self.dump_file is not None:
+            self.dump_file.close()
+        self.logger.info("Disconnected from device")
+
+    def _read_all_events_descriptions(self):
+        # Frames are terminated with a delimiter, so the descriptions can be
+        # found in the data that the device is already sending. Logging is
+        # stopped only to reduce the amount of that data.
+        self._send_command(Command.STOP)
+        self._send_command(Command.INFO)
+        buf = bytearray()
+        descriptions = []
+        start_time = time.time()
+        while True:
+            if self.event_close.is_set():
+                self.logger.info("Module closed before receiving event descriptions.")
+                self._disconnect()
+                sys.exit()
+
+            if time.time() - start_time > self.config['descriptions_timeout']:
+                self.logger.error("Event descriptions not received")
+                self._disconnect()
+                sys.exit()
+
+            buf.extend(self._read_bytes())
+            frames, pos = split_frames(buf)
+            del buf[:pos]
+            for frame_id, body in frames:
+                if frame_id != Frame.DESCR:
+                    continue
+                # Empty description is sent after last event description
+                if len(body) == 0:
+                    return bytearray('\n'.join(descriptions) + '\n\n', 'utf-8')
+                descriptions.append(body.decode())
+
+            time.sleep(self.config['uart_read_sleep_time'])
+
+    def _send_events(self, buf):
+        try:
+            for i in range(0, len(buf), Stream.RECV_BUF_SIZE):
+                self.out_stream.send_ev(buf[i:i + Stream.RECV_BUF_SIZE])
+        except StreamError as err:
+            self.logger.error("Error: {}. Unable to send data".format(err))
+            self._disconnect()
+            sys.exit()
+
+    def read_and_transmit_data(self):
+        desc_buf = self._read_all_events_descriptions()
+        try:
+            self.out_stream.send_desc(desc_buf)
+        except StreamError as err:
+            self.logger.error("Error: {}. Unable to send data".format(err))
+            self._disconnect()
+            sys.exit()
+
+        self._start_logging_events()
+        while True:
+            if self.event_close.is_set():
+                self.close()
+
+            buf = self._read_bytes()
+
+            if len(buf) > 0:
+                self._send_events(buf)
+            else:
+                time.sleep(self.config['uart_read_sleep_time'])
+
+    def _read_remaining_data(self):
+        self._stop_logging_events()
+        # Give device time to drain the ring buffer.
+        time.sleep(self.config['uart_sync_time'])
+        buf = self._read_bytes()
+        while len(buf) > 0:
+            self._send_events(buf)
+            buf = self._read_bytes()
+
+    def _start_logging_events(self):
+        self._send_command(Command.START)
+
+    def _stop_logging_events(self):
+        self._send_command(Command.STOP)
+
+    def _send_command(self, command_type):
+        command = bytearray(1)
+        command[0] = command_type.value
+        try:
+            self.uart.write(command)
+        except serial.SerialException:
+            self.logger.error("Problem with writing UART data")
+
+    def close(self):
+        self.logger.info("Real time transmission closed")
+        self._read_remaining_data()
+        self._disconnect()
+        sys.exit()
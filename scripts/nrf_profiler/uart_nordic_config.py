@@ -0,0 +1,18 @@
+#
+# Copyright (c) 2022 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+UartNordicConfig = {
+    'stream_format': 'frame',
+    'baudrate': 1000000,
+    # Used until the clock frame is received from the device.
+    'ms_per_timestamp_tick': 0.03125,
+    'byteorder': 'little',
+    'timestamp_raw_max': 2**32,
+    'uart_read_chunk_size': 4096,
+    'uart_read_sleep_time': 0.005, # In seconds.
+    # Time given to the device to send the remaining data after logging is stopped.
+    'uart_sync_time': 0.5, # In seconds.
+    'descriptions_timeout': 5, # In seconds.
+}
@@ -5,6 +5,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/spinlock.h>
 #include <zephyr/sys/slist.h>
@@ -15,13 +16,67 @@
 LOG_MODULE_REGISTER(app_event_manager, CONFIG_APP_EVENT_MANAGER_LOG_LEVEL);
 
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROC_QUEUES)
+#define PROC_QUEUE_CNT CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_COUNT
+#else
+#define PROC_QUEUE_CNT 0
+#endif
+
+/* Events are processed by the system workqueue unless the event type is
+ * assigned to one of the dedicated processing queues.
+ */
+#define EVENT_QUEUE_CNT _APP_EVENT_MANAGER_QUEUE_CNT
+
+BUILD_ASSERT(EVENT_QUEUE_CNT == (PROC_QUEUE_CNT + 1));
+/* Event type flags are stored in a single byte. */
+BUILD_ASSERT(APP_EVENT_TYPE_FLAGS_COUNT <= 8);
+
+struct event_queue {
+	struct k_work work;
+	struct k_work_q *work_q;
+	sys_slist_t list;
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH)
+	/* Intrusive multi-producer single-consumer queue. Producers only
+	 * exchange the tail pointer, the consumer (event processor) is the only
+	 * one that modifies the head.
+	 */
+	sys_snode_t stub;
+	atomic_ptr_t tail;
+	sys_snode_t *head;
+#endif
+};
+
 static void event_processor_fn(struct k_work *work);
 
 struct app_event_manager_event_display_bm _app_event_manager_event_display_bm;
-
-static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
+struct app_event_manager_queue_stats _app_event_manager_queue_stats[EVENT_QUEUE_CNT];
+
+static struct event_queue event_queues[EVENT_QUEUE_CNT] = {
+	[0] = {
+		.work = Z_WORK_INITIALIZER(event_processor_fn),
+		.list = SYS_SLIST_STATIC_INIT(&event_queues[0].list),
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH)
+		.tail = ATOMIC_PTR_INIT(&event_queues[0].stub),
+		.head = &event_queues[0].stub,
+#endif
+	},
+};
 static struct k_spinlock lock;
+static struct k_spinlock stats_lock;
+
+#if PROC_QUEUE_CNT > 0
+static K_THREAD_STACK_DEFINE(proc_queue_1_stack, CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_1_STACK_SIZE);
+static struct k_work_q proc_queue_1;
+#endif
+#if PROC_QUEUE_CNT > 1
+static K_THREAD_STACK_DEFINE(proc_queue_2_stack, CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_2_STACK_SIZE);
+static struct k_work_q proc_queue_2;
+#endif
+#if PROC_QUEUE_CNT > 2
+static K_THREAD_STACK_DEFINE(proc_queue_3_stack, CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_3_STACK_SIZE);
+static struct k_work_q proc_queue_3;
+#endif
+static bool proc_queues_started;
 
 static bool log_is_event_displayed(const struct event_type *et)
 {
@@ -132,94 +187,522 @@ void * __weak app_event_manager_alloc(size_t size)
 	return event;
 }
 
+/* Single release point for memory taken from the memory slabs. */
+static bool event_slab_free(void *addr)
+{
+	return IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SLAB_ALLOC) &&
+	       _app_event_manager_slab_free(addr);
+}
+
 void __weak app_event_manager_free(void *addr)
 {
+	/* The default implementation also accepts events from the memory
+	 * slabs, for applications that free unsubmitted events with it.
+	 */
+	if (event_slab_free(addr)) {
+		return;
+	}
+
 	k_free(addr);
 }
 
-static void event_processor_fn(struct k_work *work)
+void app_event_manager_event_free(void *addr)
 {
-	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
+	/* Memory from the slabs must never reach a user-defined
+	 * app_event_manager_free.
+	 */
+	if (event_slab_free(addr)) {
+		return;
+	}
 
-	/* Make current event list local. */
-	k_spinlock_key_t key = k_spin_lock(&lock);
+	app_event_manager_free(addr);
+}
 
-	if (sys_slist_is_empty(&eventq)) {
-		k_spin_unlock(&lock, key);
-		return;
+static bool has_submit_hooks;
+/* The dispatch table is built by app_event_manager_init. Events submitted
+ * earlier take the regular path, so that no subscriber or submit hook is
+ * skipped.
+ */
+static bool dispatch_ready;
+
+static bool event_notify_listener(const struct event_listener *el,
+				  const struct app_event_header *aeh)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_HOOKS)) {
+		return el->notification(aeh);
 	}
 
-	sys_slist_merge_slist(&events, &eventq);
+	uint32_t start = k_cycle_get_32();
+	bool consumed = el->notification(aeh);
+	uint32_t cycles = k_cycle_get_32() - start;
 
-	k_spin_unlock(&lock, key);
+	STRUCT_SECTION_FOREACH(event_listener_hook, h) {
+		h->hook(aeh, el, cycles);
+	}
 
-	/* Traverse the list of events. */
-	sys_snode_t *node;
-	while (NULL != (node = sys_slist_get(&events))) {
-		struct app_event_header *aeh = CONTAINER_OF(node,
-						       struct app_event_header,
-						       node);
+	return consumed;
+}
 
-		APP_EVENT_ASSERT_ID(aeh->type_id);
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH)
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_HOOKS)
+/* Listener hooks need the listener, so the listeners of all subscribers are
+ * stored instead of their notification functions.
+ */
+static const struct event_listener *dispatch_table[CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH_TABLE_SIZE];
 
-		const struct event_type *et = aeh->type_id;
+static void dispatch_entry_set(size_t idx, const struct event_listener *el)
+{
+	dispatch_table[idx] = el;
+}
 
-		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PREPROCESS_HOOKS)) {
-			STRUCT_SECTION_FOREACH(event_preprocess_hook, h) {
-				h->hook(aeh);
-			}
+static bool dispatch_entry_call(size_t idx, const struct app_event_header *aeh)
+{
+	return event_notify_listener(dispatch_table[idx], aeh);
+}
+#else
+/* Notification functions of all subscribers, grouped by event type. */
+static cb_fn dispatch_table[CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH_TABLE_SIZE];
+
+static void dispatch_entry_set(size_t idx, const struct event_listener *el)
+{
+	dispatch_table[idx] = el->notification;
+}
+
+static bool dispatch_entry_call(size_t idx, const struct app_event_header *aeh)
+{
+	return dispatch_table[idx](aeh);
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_LISTENER_HOOKS */
+static uint16_t dispatch_offset[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT + 1];
+
+static void eventq_push(struct event_queue *q, sys_snode_t *node)
+{
+	__atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+
+	sys_snode_t *prev = atomic_ptr_set(&q->tail, node);
+
+	__atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+static sys_snode_t *eventq_pop(struct event_queue *q)
+{
+	sys_snode_t *head = q->head;
+	sys_snode_t *next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+
+	if (head == &q->stub) {
+		if (!next) {
+			return NULL;
 		}
+		q->head = next;
+		head = next;
+		next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+	}
 
-		log_event(aeh);
+	if (next) {
+		q->head = next;
+		return head;
+	}
+
+	if (head != atomic_ptr_get(&q->tail)) {
+		/* Producer is in the middle of appending an event. The event
+		 * processor is resubmitted once the event is linked.
+		 */
+		return NULL;
+	}
 
-		bool consumed = false;
+	eventq_push(q, &q->stub);
+
+	next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+	if (next) {
+		q->head = next;
+		return head;
+	}
+
+	return NULL;
+}
+
+static void eventq_init(struct event_queue *q)
+{
+	atomic_ptr_set(&q->tail, &q->stub);
+	q->head = &q->stub;
+}
+
+static int dispatch_table_init(void)
+{
+	size_t cnt = 0;
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		size_t idx = et - _event_type_list_start;
+
+		dispatch_offset[idx] = cnt;
 
 		for (const struct event_subscriber *es = et->subs_start;
-		     (es != et->subs_stop) && !consumed;
+		     es != et->subs_stop;
 		     es++) {
+			if (cnt >= ARRAY_SIZE(dispatch_table)) {
+				LOG_ERR("Dispatch table too small");
+				return -ENOMEM;
+			}
+
+			__ASSERT_NO_MSG(es->listener != NULL);
+			__ASSERT_NO_MSG(es->listener->notification != NULL);
 
-			__ASSERT_NO_MSG(es != NULL);
+			dispatch_entry_set(cnt, es->listener);
+			cnt++;
+		}
+	}
 
-			const struct event_listener *el = es->listener;
+	dispatch_offset[_event_type_list_end - _event_type_list_start] = cnt;
 
-			__ASSERT_NO_MSG(el != NULL);
-			__ASSERT_NO_MSG(el->notification != NULL);
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_HOOKS)) {
+		STRUCT_SECTION_FOREACH(event_submit_hook, h) {
+			has_submit_hooks = true;
+			break;
+		}
+	}
 
-			log_event_progress(et, el);
+	return 0;
+}
 
-			consumed = el->notification(aeh);
+static bool event_dispatch(const struct app_event_header *aeh)
+{
+	size_t idx = aeh->type_id - _event_type_list_start;
 
-			if (consumed) {
-				log_event_consumed(et);
-			}
+	for (size_t i = dispatch_offset[idx]; i < dispatch_offset[idx + 1]; i++) {
+		if (dispatch_entry_call(i, aeh)) {
+			log_event_consumed(aeh->type_id);
+			return true;
 		}
+	}
 
-		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTPROCESS_HOOKS)) {
-			STRUCT_SECTION_FOREACH(event_postprocess_hook, h) {
-				h->hook(aeh);
-			}
+	return false;
+}
+#else
+static void eventq_push(struct event_queue *q, sys_snode_t *node)
+{
+	__ASSERT_NO_MSG(false);
+}
+
+static sys_snode_t *eventq_pop(struct event_queue *q)
+{
+	__ASSERT_NO_MSG(false);
+	return NULL;
+}
+
+static void eventq_init(struct event_queue *q)
+{
+}
+
+static int dispatch_table_init(void)
+{
+	return 0;
+}
+
+static bool event_dispatch(const struct app_event_header *aeh)
+{
+	__ASSERT_NO_MSG(false);
+	return false;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH */
+
+static bool event_notify_subscribers(const struct app_event_header *aeh)
+{
+	const struct event_type *et = aeh->type_id;
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH) && dispatch_ready) {
+		return event_dispatch(aeh);
+	}
+
+	for (const struct event_subscriber *es = et->subs_start;
+	     es != et->subs_stop;
+	     es++) {
+
+		__ASSERT_NO_MSG(es != NULL);
+
+		const struct event_listener *el = es->listener;
+
+		__ASSERT_NO_MSG(el != NULL);
+		__ASSERT_NO_MSG(el->notification != NULL);
+
+		log_event_progress(et, el);
+
+		if (event_notify_listener(el, aeh)) {
+			log_event_consumed(et);
+			return true;
 		}
+	}
+
+	return false;
+}
+
+size_t _app_event_manager_queue_idx(const struct event_type *et)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROC_QUEUES)
+	/* Events submitted before the dedicated queues are started are
+	 * processed by the system workqueue.
+	 */
+	if (!proc_queues_started) {
+		return 0;
+	}
+
+	uint8_t queue_flags = et->flags & _APP_EVENT_PROC_QUEUE_FLAGS_MASK;
+
+	if (queue_flags) {
+		return __builtin_ctz(queue_flags) - APP_EVENT_TYPE_FLAGS_PROC_QUEUE_1 + 1;
+	}
+#endif
+
+	return 0;
+}
 
-		app_event_manager_free(aeh);
+static void queue_stats_submit(size_t queue_idx)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_QUEUE_STATS)) {
+		return;
 	}
+
+	struct app_event_manager_queue_stats *stats = &_app_event_manager_queue_stats[queue_idx];
+	atomic_val_t depth = atomic_inc(&stats->depth) + 1;
+	atomic_val_t max_depth;
+
+	do {
+		max_depth = atomic_get(&stats->max_depth);
+		if (depth <= max_depth) {
+			break;
+		}
+	} while (!atomic_cas(&stats->max_depth, max_depth, depth));
 }
 
-void _event_submit(struct app_event_header *aeh)
+static void queue_stats_process(size_t queue_idx, const struct app_event_header *aeh)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_QUEUE_STATS)
+	struct app_event_manager_queue_stats *stats = &_app_event_manager_queue_stats[queue_idx];
+	uint32_t latency = k_cyc_to_us_floor32(k_cycle_get_32() - aeh->submit_time);
+
+	atomic_dec(&stats->depth);
+
+	/* Latency statistics are not atomic, readers take a snapshot. */
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	stats->processed_cnt++;
+	stats->latency_sum_us += latency;
+	stats->latency_max_us = MAX(stats->latency_max_us, latency);
+	k_spin_unlock(&stats_lock, key);
+#endif
+}
+
+void _app_event_manager_queue_stats_get(size_t queue_idx,
+					struct app_event_manager_queue_stats *stats)
+{
+	__ASSERT_NO_MSG(queue_idx < ARRAY_SIZE(_app_event_manager_queue_stats));
+
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*stats = _app_event_manager_queue_stats[queue_idx];
+	k_spin_unlock(&stats_lock, key);
+}
+
+static void event_process(struct app_event_header *aeh)
 {
-	__ASSERT_NO_MSG(aeh);
 	APP_EVENT_ASSERT_ID(aeh->type_id);
 
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PREPROCESS_HOOKS)) {
+		STRUCT_SECTION_FOREACH(event_preprocess_hook, h) {
+			h->hook(aeh);
+		}
+	}
+
+	log_event(aeh);
+
+	event_notify_subscribers(aeh);
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTPROCESS_HOOKS)) {
+		STRUCT_SECTION_FOREACH(event_postprocess_hook, h) {
+			h->hook(aeh);
+		}
+	}
+
+	app_event_manager_event_free(aeh);
+}
+
+static void event_queue_process(size_t queue_idx, sys_snode_t *node)
+{
+	struct app_event_header *aeh = CONTAINER_OF(node, struct app_event_header, node);
+
+	queue_stats_process(queue_idx, aeh);
+	event_process(aeh);
+}
+
+static void event_list_process(struct event_queue *q, size_t queue_idx)
+{
+	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
+	sys_snode_t *node;
+
+	/* Make current event list local. */
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
+	if (sys_slist_is_empty(&q->list)) {
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	sys_slist_merge_slist(&events, &q->list);
+
+	k_spin_unlock(&lock, key);
+
+	/* Traverse the list of events. */
+	while (NULL != (node = sys_slist_get(&events))) {
+		event_queue_process(queue_idx, node);
+	}
+}
+
+static void event_processor_fn(struct k_work *work)
+{
+	struct event_queue *q = CONTAINER_OF(work, struct event_queue, work);
+	size_t queue_idx = q - event_queues;
+	sys_snode_t *node;
+
+	/* With fast dispatch the list holds only events submitted before
+	 * initialization and stays empty afterwards. These events are processed
+	 * first to keep the order. An event appended after the check resubmits
+	 * the work.
+	 */
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH) || !sys_slist_is_empty(&q->list)) {
+		event_list_process(q, queue_idx);
+	}
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH)) {
+		while (NULL != (node = eventq_pop(q))) {
+			event_queue_process(queue_idx, node);
+		}
+	}
+}
+
+static void event_submit_hooks_call(const struct app_event_header *aeh)
+{
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_HOOKS)) {
 		STRUCT_SECTION_FOREACH(event_submit_hook, h) {
 			h->hook(aeh);
 		}
 	}
-	sys_slist_append(&eventq, &aeh->node);
-	k_spin_unlock(&lock, key);
+}
+
+void _event_submit(struct app_event_header *aeh)
+{
+	__ASSERT_NO_MSG(aeh);
+	APP_EVENT_ASSERT_ID(aeh->type_id);
+
+	size_t queue_idx = _app_event_manager_queue_idx(aeh->type_id);
+	struct event_queue *q = &event_queues[queue_idx];
 
-	k_work_submit(&event_processor);
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_TIMESTAMP)
+	aeh->submit_time = k_cycle_get_32();
+#endif
+	queue_stats_submit(queue_idx);
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_FAST_DISPATCH) && dispatch_ready) {
+		if (has_submit_hooks) {
+			/* Submit hooks must be called in the order of events in the queue. */
+			k_spinlock_key_t key = k_spin_lock(&lock);
+
+			event_submit_hooks_call(aeh);
+			eventq_push(q, &aeh->node);
+			k_spin_unlock(&lock, key);
+		} else {
+			eventq_push(q, &aeh->node);
+		}
+	} else {
+		k_spinlock_key_t key = k_spin_lock(&lock);
+
+		event_submit_hooks_call(aeh);
+		sys_slist_append(&q->list, &aeh->node);
+		k_spin_unlock(&lock, key);
+	}
+
+	if (q->work_q) {
+		k_work_submit_to_queue(q->work_q, &q->work);
+	} else {
+		k_work_submit(&q->work);
+	}
+}
+
+#if PROC_QUEUE_CNT > 0
+static void proc_queue_start(size_t queue_idx, struct k_work_q *work_q,
+			     k_thread_stack_t *stack, size_t stack_size, int prio)
+{
+	struct event_queue *q = &event_queues[queue_idx];
+	char name[] = "aem_queue_X";
+
+	name[sizeof(name) - 2] = '0' + queue_idx;
+
+	const struct k_work_queue_config cfg = {
+		.name = name,
+	};
+
+	k_work_init(&q->work, event_processor_fn);
+	sys_slist_init(&q->list);
+	eventq_init(q);
+	q->work_q = work_q;
+
+	k_work_queue_start(work_q, stack, stack_size, prio, &cfg);
+}
+#endif /* PROC_QUEUE_CNT > 0 */
+
+static void proc_queues_init(void)
+{
+#if PROC_QUEUE_CNT > 0
+	proc_queue_start(1, &proc_queue_1, proc_queue_1_stack,
+			 K_THREAD_STACK_SIZEOF(proc_queue_1_stack),
+			 CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_1_PRIORITY);
+#endif
+#if PROC_QUEUE_CNT > 1
+	proc_queue_start(2, &proc_queue_2, proc_queue_2_stack,
+			 K_THREAD_STACK_SIZEOF(proc_queue_2_stack),
+			 CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_2_PRIORITY);
+#endif
+#if PROC_QUEUE_CNT > 2
+	proc_queue_start(3, &proc_queue_3, proc_queue_3_stack,
+			 K_THREAD_STACK_SIZEOF(proc_queue_3_stack),
+			 CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_3_PRIORITY);
+#endif
+	proc_queues_started = true;
+}
+
+const struct event_type *app_event_manager_event_type_find(const char *name)
+{
+	/* Event types are placed by the linker in order of their names. */
+	size_t lo = 0;
+	size_t hi = _event_type_list_end - _event_type_list_start;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		const struct event_type *et = &_event_type_list_start[mid];
+		int cmp = strcmp(name, et->name);
+
+		if (cmp == 0) {
+			return et;
+		} else if (cmp < 0) {
+			hi = mid;
+		} else {
+			lo = mid + 1;
+		}
+	}
+
+	return NULL;
+}
+
+static void event_type_order_check(void)
+{
+	if (!IS_ENABLED(CONFIG_ASSERT)) {
+		return;
+	}
+
+	for (const struct event_type *et = _event_type_list_start + 1;
+	     et < _event_type_list_end;
+	     et++) {
+		__ASSERT(strcmp((et - 1)->name, et->name) < 0,
+			 "Event types not sorted by name: %s, %s", (et - 1)->name, et->name);
+	}
 }
 
 int app_event_manager_init(void)
@@ -229,8 +712,20 @@ int app_event_manager_init(void)
 	__ASSERT_NO_MSG(_event_type_list_end - _event_type_list_start <=
 			CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT);
 
+	event_type_order_check();
 	log_event_init();
 
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROC_QUEUES)) {
+		proc_queues_init();
+	}
+
+	ret = dispatch_table_init();
+	if (ret) {
+		return ret;
+	}
+
+	dispatch_ready = true;
+
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTINIT_HOOK)) {
 		STRUCT_SECTION_FOREACH(app_event_manager_postinit_hook, h) {
 			ret = h->hook();
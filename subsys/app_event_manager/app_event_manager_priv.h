@@ -121,6 +121,17 @@ extern "C" {
 #define _EVENT_ID(ename) (&_CONCAT(__event_type_, ename))
 
 
+/* Allocate memory for an event of the given ename type.
+ * If memory slabs are in use, the event type is passed to the allocator so that
+ * the event can be taken from the memory slab dedicated to the event type.
+ */
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SLAB_ALLOC)
+#define _APP_EVENT_ALLOC(ename, size) _app_event_manager_slab_alloc(_EVENT_ID(ename), (size))
+#else
+#define _APP_EVENT_ALLOC(ename, size) app_event_manager_alloc(size)
+#endif
+
+
 /* Macro generates a function of name new_ename where ename is provided as
  * an argument. Allocator function is used to create an event of the given
  * ename type.
@@ -129,7 +140,7 @@ extern "C" {
 	static inline struct ename *_CONCAT(new_, ename)(void)			\
 	{									\
 		struct ename *event =						\
-			(struct ename *)app_event_manager_alloc(sizeof(*event));\
+			(struct ename *)_APP_EVENT_ALLOC(ename, sizeof(*event));\
 		BUILD_ASSERT(offsetof(struct ename, header) == 0,		\
 				 "");						\
 		if (event != NULL) {						\
@@ -147,7 +158,7 @@ extern "C" {
 	static inline struct ename *_CONCAT(new_, ename)(size_t size)			\
 	{										\
 		struct ename *event =							\
-			(struct ename *)app_event_manager_alloc(sizeof(*event) + size);	\
+			(struct ename *)_APP_EVENT_ALLOC(ename, sizeof(*event) + size);	\
 		BUILD_ASSERT((offsetof(struct ename, dyndata) +				\
 				  sizeof(event->dyndata.size)) ==			\
 				 sizeof(*event), "");					\
@@ -221,6 +232,47 @@ extern "C" {
 #define _APP_EVENT_TYPE_DEFINE_SIZES(ename)
 #endif
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SLAB_ALLOC)
+/* Name of the memory slab dedicated to the given event type. */
+#define _APP_EVENT_SLAB_NAME(ename) _CONCAT(__event_slab_, ename)
+
+/* Name of the buffer of the memory slab dedicated to the given event type. */
+#define _APP_EVENT_SLAB_BUF_NAME(ename) _CONCAT(__event_slab_buf_, ename)
+
+#define _APP_EVENT_SLAB_BLOCK_SIZE(ename) ROUND_UP(sizeof(struct ename), sizeof(void *))
+
+/* The memory slabs are not placed in the iterable section of the kernel, as
+ * K_MEM_SLAB_DEFINE does, because events with dynamic data do not use them.
+ * These events are allocated from the dynamic data pool, so their slab is not
+ * referenced by the event type and is discarded by the compiler.
+ * The slabs in use are initialized by the Application Event Manager.
+ */
+#define _APP_EVENT_SLAB_DEFINE(ename)								\
+	static char __aligned(sizeof(void *)) _APP_EVENT_SLAB_BUF_NAME(ename)			\
+		[_APP_EVENT_SLAB_BLOCK_SIZE(ename) * CONFIG_APP_EVENT_MANAGER_SLAB_DEPTH];	\
+	static struct k_mem_slab _APP_EVENT_SLAB_NAME(ename) =					\
+		Z_MEM_SLAB_INITIALIZER(_APP_EVENT_SLAB_NAME(ename),				\
+				       _APP_EVENT_SLAB_BUF_NAME(ename),				\
+				       _APP_EVENT_SLAB_BLOCK_SIZE(ename),			\
+				       CONFIG_APP_EVENT_MANAGER_SLAB_DEPTH)
+
+#define _APP_EVENT_TYPE_DEFINE_SLAB(ename)						\
+	.slab = ((_CONCAT(ename, _HAS_DYNDATA)) ? NULL : &_APP_EVENT_SLAB_NAME(ename)),
+#else
+#define _APP_EVENT_SLAB_DEFINE(ename)
+#define _APP_EVENT_TYPE_DEFINE_SLAB(ename)
+#endif
+
+/* Number of event processing queues, including the system workqueue. */
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROC_QUEUES)
+#define _APP_EVENT_MANAGER_QUEUE_CNT (CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_COUNT + 1)
+#define _APP_EVENT_PROC_QUEUE_FLAGS_MASK							\
+	(BIT_MASK(CONFIG_APP_EVENT_MANAGER_PROC_QUEUE_COUNT) << APP_EVENT_TYPE_FLAGS_PROC_QUEUE_1)
+#else
+#define _APP_EVENT_MANAGER_QUEUE_CNT 1
+#define _APP_EVENT_PROC_QUEUE_FLAGS_MASK 0
+#endif
+
 /** @brief Event header.
  *
  * When defining an event structure, the application event header
@@ -232,6 +284,11 @@ struct app_event_header {
 
 	/** Pointer to the event type object. */
 	const struct event_type *type_id;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_TIMESTAMP)
+	/** Cycle counter value captured on event submission. */
+	uint32_t submit_time;
+#endif
 };
 
 /** Function to log data from this event. */
@@ -294,18 +351,37 @@ struct event_type {
 	/** The size of the event structure */
 	uint16_t struct_size;
 #endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SLAB_ALLOC)
+	/** Memory slab used to allocate events of this type.
+	 *  NULL for events with dynamic data.
+	 */
+	struct k_mem_slab *slab;
+#endif
 };
 
 
 extern struct event_type _event_type_list_start[];
 extern struct event_type _event_type_list_end[];
 
+/** @brief Get the index of the queue that processes events of the given type.
+ *
+ * @param et  Pointer to the event type.
+ * @retval Index of the dedicated processing queue, or 0 for the system
+ *         workqueue.
+ */
+size_t _app_event_manager_queue_idx(const struct event_type *et);
+
 
 #define _APP_EVENT_TYPE_DEFINE(ename, log_fn, trace_data_pointer, et_flags)		\
 	BUILD_ASSERT(((et_flags) & ((BIT_MASK(APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START-	\
 		APP_EVENT_TYPE_FLAGS_SYSTEM_START))<<					\
 		APP_EVENT_TYPE_FLAGS_SYSTEM_START)) == 0);				\
+	BUILD_ASSERT(((et_flags) & _APP_EVENT_PROC_QUEUE_FLAGS_MASK &			\
+		(((et_flags) & _APP_EVENT_PROC_QUEUE_FLAGS_MASK) - 1)) == 0,		\
+		"Event type assigned to more than one processing queue");		\
 	_APP_EVENT_SUBSCRIBERS_ARRAY_TAGS(ename);					\
+	_APP_EVENT_SLAB_DEFINE(ename);							\
 	STRUCT_SECTION_ITERABLE(event_type, _CONCAT(__event_type_, ename)) = {		\
 		.name            = STRINGIFY(ename),					\
 		.subs_start      = _APP_EVENT_SUBSCRIBERS_START_TAG(ename),		\
@@ -317,6 +393,7 @@ extern struct event_type _event_type_list_end[];
 				((et_flags) | BIT(APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)) :	\
 				((et_flags) & (~BIT(APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)))),\
 		_APP_EVENT_TYPE_DEFINE_SIZES(ename) /* No comma here intentionally */	\
+		_APP_EVENT_TYPE_DEFINE_SLAB(ename) /* No comma here intentionally */	\
 	}
 
 /**
@@ -356,6 +433,11 @@ extern struct app_event_manager_event_display_bm _app_event_manager_event_displa
 		     "Enable APP_EVENT_MANAGER_POSTPROCESS_HOOKS before usage"); \
 	_APP_EVENT_HOOK_REGISTER(event_postprocess_hook, hook_fn, prio)
 
+#define _APP_EVENT_HOOK_LISTENER_REGISTER(hook_fn, prio)                      \
+	BUILD_ASSERT(IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_HOOKS),     \
+		     "Enable APP_EVENT_MANAGER_LISTENER_HOOKS before usage"); \
+	_APP_EVENT_HOOK_REGISTER(event_listener_hook, hook_fn, prio)
+
 /**
  * @brief Joining together event type flags.
  */
@@ -427,6 +509,83 @@ struct event_postprocess_hook {
 	void (*hook)(const struct app_event_header *aeh);
 };
 
+/** @brief Structure used to register event listener hook
+ */
+struct event_listener_hook {
+	/** @brief Hook function */
+	void (*hook)(const struct app_event_header *aeh, const struct event_listener *el,
+		     uint32_t cycles);
+};
+
+
+
+/** @brief Allocation statistics of a memory pool used for events.
+ */
+struct app_event_manager_pool_stats {
+	/** Number of blocks currently in use. */
+	atomic_t used;
+
+	/** Maximum number of blocks used at the same time. */
+	atomic_t max_used;
+
+	/** Number of allocations that could not be served by the pool. */
+	atomic_t fallback_cnt;
+};
+
+/** @brief Allocate an event of the given type from the memory slabs.
+ *
+ * @param et    Pointer to the event type.
+ * @param size  Amount of memory requested (in bytes).
+ * @retval Address of the allocated memory if successful, otherwise NULL.
+ */
+void *_app_event_manager_slab_alloc(const struct event_type *et, size_t size);
+
+/** @brief Free an event allocated from the memory slabs.
+ *
+ * @param addr  Pointer to the event.
+ * @retval true If the event was allocated from the memory slabs and was freed.
+ * @retval false If the event was not allocated from the memory slabs.
+ */
+bool _app_event_manager_slab_free(void *addr);
+
+/** Allocation statistics of the memory slabs, indexed by event type. */
+extern struct app_event_manager_pool_stats
+	_app_event_manager_slab_stats[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+
+/** Allocation statistics of the dynamic data pool. */
+extern struct app_event_manager_pool_stats _app_event_manager_dyndata_pool_stats;
+
+
+/** @brief Statistics of an event processing queue.
+ */
+struct app_event_manager_queue_stats {
+	/** Number of events waiting in the queue. */
+	atomic_t depth;
+
+	/** Maximum number of events waiting in the queue. */
+	atomic_t max_depth;
+
+	/** Number of processed events. */
+	uint32_t processed_cnt;
+
+	/** Sum of time between event submission and processing [us]. */
+	uint64_t latency_sum_us;
+
+	/** Maximum time between event submission and processing [us]. */
+	uint32_t latency_max_us;
+};
+
+/** Statistics of the event processing queues. */
+extern struct app_event_manager_queue_stats
+	_app_event_manager_queue_stats[_APP_EVENT_MANAGER_QUEUE_CNT];
+
+/** @brief Get a consistent copy of statistics of an event processing queue.
+ *
+ * @param queue_idx  Index of the event processing queue.
+ * @param stats      Pointer to the structure to be filled with the statistics.
+ */
+void _app_event_manager_queue_stats_get(size_t queue_idx,
+					struct app_event_manager_queue_stats *stats);
 
 
 /** @brief Submit an event to the Application Event Manager.
@@ -81,6 +81,73 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+static void print_pool_stats(const struct shell *shell, const char *name,
+			     const struct app_event_manager_pool_stats *stats)
+{
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "|\t[P:%s] used: %ld, max used: %ld, fallbacks: %ld\n",
+		      name,
+		      (long)atomic_get(&stats->used),
+		      (long)atomic_get(&stats->max_used),
+		      (long)atomic_get(&stats->fallback_cnt));
+}
+
+static int show_pools(const struct shell *shell, size_t argc,
+		      char **argv)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SLAB_ALLOC)) {
+		shell_error(shell, "Memory slabs are not in use");
+		return -ENOTSUP;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Event memory pools:\n");
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		if (app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)) {
+			continue;
+		}
+
+		size_t ev_id = et - _event_type_list_start;
+
+		print_pool_stats(shell, et->name, &_app_event_manager_slab_stats[ev_id]);
+	}
+
+	print_pool_stats(shell, "dyndata", &_app_event_manager_dyndata_pool_stats);
+
+	return 0;
+}
+
+static int show_queues(const struct shell *shell, size_t argc,
+		       char **argv)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_QUEUE_STATS)) {
+		shell_error(shell, "Queue statistics are not in use");
+		return -ENOTSUP;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Event processing queues:\n");
+
+	for (size_t i = 0; i < ARRAY_SIZE(_app_event_manager_queue_stats); i++) {
+		struct app_event_manager_queue_stats stats;
+
+		_app_event_manager_queue_stats_get(i, &stats);
+
+		uint32_t cnt = stats.processed_cnt;
+
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t[Q:%zu] depth: %ld, max depth: %ld, processed: %u, "
+			      "latency avg: %u us, max: %u us\n",
+			      i,
+			      (long)atomic_get(&stats.depth),
+			      (long)atomic_get(&stats.max_depth),
+			      cnt,
+			      (cnt > 0) ? (uint32_t)(stats.latency_sum_us / cnt) : 0,
+			      stats.latency_max_us);
+	}
+
+	return 0;
+}
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -107,6 +174,17 @@ static void set_event_displaying(const struct shell *shell, size_t argc,
 
 			event_indexes[i] = strtol(argv[i + 1], &end, 10);
 
+			if (end == argv[i + 1]) {
+				/* Not a number, look the event up by name. */
+				const struct event_type *et =
+					app_event_manager_event_type_find(argv[i + 1]);
+
+				if (et) {
+					event_indexes[i] = et - _event_type_list_start;
+					end = "";
+				}
+			}
+
 			if ((event_indexes[i] < 0)
 			    || (event_indexes[i] >= _event_type_list_end - _event_type_list_start)
 			    || (*end != '\0')) {
@@ -155,10 +233,14 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_app_event_manager,
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
-	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
+	SHELL_CMD_ARG(show_pools, NULL, "Show event memory pool statistics",
+		      show_pools, 0, 0),
+	SHELL_CMD_ARG(show_queues, NULL, "Show event processing queue statistics",
+		      show_queues, 0, 0),
+	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID or name",
 		      disable_event_displaying, 0,
 		      sizeof(_app_event_manager_event_display_bm) * 8 - 1),
-	SHELL_CMD_ARG(enable, NULL, "Enable displaying event with given ID",
+	SHELL_CMD_ARG(enable, NULL, "Enable displaying event with given ID or name",
 		      enable_event_displaying, 0,
 		      sizeof(_app_event_manager_event_display_bm) * 8 - 1),
 	SHELL_SUBCMD_SET_END
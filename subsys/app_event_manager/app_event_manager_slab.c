@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <app_event_manager.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(app_event_manager, CONFIG_APP_EVENT_MANAGER_LOG_LEVEL);
+
+struct app_event_manager_pool_stats
+	_app_event_manager_slab_stats[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+struct app_event_manager_pool_stats _app_event_manager_dyndata_pool_stats;
+
+static K_HEAP_DEFINE(dyndata_pool, CONFIG_APP_EVENT_MANAGER_SLAB_DYNDATA_POOL_SIZE);
+
+
+static void stats_alloc(struct app_event_manager_pool_stats *stats)
+{
+	atomic_val_t used = atomic_inc(&stats->used) + 1;
+	atomic_val_t max_used;
+
+	do {
+		max_used = atomic_get(&stats->max_used);
+		if (used <= max_used) {
+			break;
+		}
+	} while (!atomic_cas(&stats->max_used, max_used, used));
+}
+
+static void stats_free(struct app_event_manager_pool_stats *stats)
+{
+	atomic_dec(&stats->used);
+}
+
+static bool is_in_slab(const struct k_mem_slab *slab, const void *addr)
+{
+	const char *ptr = addr;
+
+	return (ptr >= slab->buffer) &&
+	       (ptr < slab->buffer + (slab->num_blocks * slab->block_size));
+}
+
+static bool is_in_dyndata_pool(const void *addr)
+{
+	const char *ptr = addr;
+	const char *pool_start = dyndata_pool.heap.init_mem;
+
+	return (ptr >= pool_start) && (ptr < pool_start + dyndata_pool.heap.init_bytes);
+}
+
+void *_app_event_manager_slab_alloc(const struct event_type *et, size_t size)
+{
+	APP_EVENT_ASSERT_ID(et);
+
+	size_t idx = et - _event_type_list_start;
+	void *event;
+
+	if (app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_HAS_DYNDATA)) {
+		event = k_heap_alloc(&dyndata_pool, size, K_NO_WAIT);
+		if (event) {
+			stats_alloc(&_app_event_manager_dyndata_pool_stats);
+			return event;
+		}
+
+		atomic_inc(&_app_event_manager_dyndata_pool_stats.fallback_cnt);
+	} else {
+		__ASSERT_NO_MSG(size <= et->slab->block_size);
+
+		if (!k_mem_slab_alloc(et->slab, &event, K_NO_WAIT)) {
+			stats_alloc(&_app_event_manager_slab_stats[idx]);
+			return event;
+		}
+
+		atomic_inc(&_app_event_manager_slab_stats[idx].fallback_cnt);
+	}
+
+	LOG_DBG("No free block for %s, using fallback allocator", et->name);
+
+	return app_event_manager_alloc(size);
+}
+
+bool _app_event_manager_slab_free(void *addr)
+{
+	const struct app_event_header *aeh = addr;
+
+	APP_EVENT_ASSERT_ID(aeh->type_id);
+
+	const struct event_type *et = aeh->type_id;
+	size_t idx = et - _event_type_list_start;
+
+	if (et->slab && is_in_slab(et->slab, addr)) {
+		k_mem_slab_free(et->slab, &addr);
+		stats_free(&_app_event_manager_slab_stats[idx]);
+		return true;
+	}
+
+	if (is_in_dyndata_pool(addr)) {
+		k_heap_free(&dyndata_pool, addr);
+		stats_free(&_app_event_manager_dyndata_pool_stats);
+		return true;
+	}
+
+	return false;
+}
+
+static int slabs_init(const struct device *unused)
+{
+	ARG_UNUSED(unused);
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		if (!et->slab) {
+			continue;
+		}
+
+		int err = k_mem_slab_init(et->slab, et->slab->buffer, et->slab->block_size,
+					  et->slab->num_blocks);
+
+		if (err) {
+			LOG_ERR("Cannot initialize memory slab of %s (err: %d)", et->name, err);
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+SYS_INIT(slabs_init, PRE_KERNEL_1, CONFIG_KERNEL_INIT_PRIORITY_OBJECTS);
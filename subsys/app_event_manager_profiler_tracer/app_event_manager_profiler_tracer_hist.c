@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <app_event_manager.h>
+#include <app_event_manager_profiler_tracer.h>
+
+#define BUCKET_CNT	CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_HIST_BUCKET_CNT
+#define EVENT_CNT	CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT
+#define LISTENER_CNT	CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_HIST_MAX_LISTENERS
+#define QUEUE_CNT	_APP_EVENT_MANAGER_QUEUE_CNT
+
+#define DUMP_VERSION	1
+
+extern struct event_listener _event_listener_list_start[];
+extern struct event_listener _event_listener_list_end[];
+
+struct hist {
+	atomic_t buckets[BUCKET_CNT];
+};
+
+/* Header of the binary histogram dump. It is followed by the histograms of
+ * every event type (all event histogram types for the first event type, then
+ * for the second one and so on) and the listener histograms. Every bucket is
+ * stored as 32-bit little-endian value.
+ */
+struct hist_dump_hdr {
+	uint8_t version;
+	uint8_t bucket_cnt;
+	uint8_t event_hist_cnt;
+	uint8_t reserved;
+	uint16_t event_cnt;
+	uint16_t listener_cnt;
+} __packed;
+
+static struct hist event_hists[EVENT_CNT][APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT];
+static struct hist listener_hists[LISTENER_CNT];
+
+/* Processing start time of the event currently processed by the queue.
+ * Every queue is served by a single thread, so no synchronization is needed.
+ */
+static uint32_t processing_start[QUEUE_CNT];
+
+
+static size_t event_cnt(void)
+{
+	return _event_type_list_end - _event_type_list_start;
+}
+
+static size_t listener_cnt(void)
+{
+	return MIN(_event_listener_list_end - _event_listener_list_start, LISTENER_CNT);
+}
+
+static size_t bucket_idx(uint32_t value)
+{
+	/* Bucket 0 holds zero, bucket n holds values from 2^(n-1) to 2^n - 1.
+	 * The last bucket holds all bigger values.
+	 */
+	size_t idx = (value == 0) ? 0 : (32 - __builtin_clz(value));
+
+	return MIN(idx, BUCKET_CNT - 1);
+}
+
+static void hist_add(struct hist *h, uint32_t value)
+{
+	atomic_inc(&h->buckets[bucket_idx(value)]);
+}
+
+static struct hist *event_hist_get(const struct event_type *et,
+				   enum app_event_manager_hist_type type)
+{
+	size_t idx = et - _event_type_list_start;
+
+	__ASSERT_NO_MSG(idx < EVENT_CNT);
+
+	return &event_hists[idx][type];
+}
+
+static void hist_event_submit(const struct app_event_header *aeh)
+{
+	/* The queue statistics are updated before the submit hooks are called,
+	 * so the depth includes the submitted event.
+	 */
+	size_t q = _app_event_manager_queue_idx(aeh->type_id);
+	atomic_val_t depth = atomic_get(&_app_event_manager_queue_stats[q].depth);
+
+	hist_add(event_hist_get(aeh->type_id, APP_EVENT_MANAGER_HIST_QUEUE_DEPTH), depth);
+}
+
+static void hist_event_preprocess(const struct app_event_header *aeh)
+{
+	size_t q = _app_event_manager_queue_idx(aeh->type_id);
+	uint32_t now = k_cycle_get_32();
+
+	processing_start[q] = now;
+	hist_add(event_hist_get(aeh->type_id, APP_EVENT_MANAGER_HIST_DISPATCH_LATENCY),
+		 k_cyc_to_us_floor32(now - aeh->submit_time));
+}
+
+static void hist_event_postprocess(const struct app_event_header *aeh)
+{
+	size_t q = _app_event_manager_queue_idx(aeh->type_id);
+
+	hist_add(event_hist_get(aeh->type_id, APP_EVENT_MANAGER_HIST_PROCESSING_TIME),
+		 k_cyc_to_us_floor32(k_cycle_get_32() - processing_start[q]));
+}
+
+static void hist_listener(const struct app_event_header *aeh, const struct event_listener *el,
+			  uint32_t cycles)
+{
+	size_t idx = el - _event_listener_list_start;
+
+	if (idx < LISTENER_CNT) {
+		hist_add(&listener_hists[idx], k_cyc_to_us_floor32(cycles));
+	}
+}
+
+APP_EVENT_HOOK_ON_SUBMIT_REGISTER(hist_event_submit);
+APP_EVENT_HOOK_PREPROCESS_REGISTER(hist_event_preprocess);
+APP_EVENT_HOOK_POSTPROCESS_REGISTER(hist_event_postprocess);
+APP_EVENT_HOOK_LISTENER_REGISTER(hist_listener);
+
+int app_event_manager_profiler_tracer_hist_get(enum app_event_manager_hist_type type,
+					       size_t idx, uint32_t *buckets)
+{
+	const struct hist *h;
+
+	if (type == APP_EVENT_MANAGER_HIST_LISTENER_TIME) {
+		if (idx >= listener_cnt()) {
+			return -EINVAL;
+		}
+		h = &listener_hists[idx];
+	} else if (type < APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT) {
+		if (idx >= event_cnt()) {
+			return -EINVAL;
+		}
+		h = &event_hists[idx][type];
+	} else {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < BUCKET_CNT; i++) {
+		buckets[i] = atomic_get(&h->buckets[i]);
+	}
+
+	return 0;
+}
+
+void app_event_manager_profiler_tracer_hist_reset(void)
+{
+	for (size_t i = 0; i < EVENT_CNT; i++) {
+		for (size_t t = 0; t < APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT; t++) {
+			for (size_t b = 0; b < BUCKET_CNT; b++) {
+				atomic_clear(&event_hists[i][t].buckets[b]);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < LISTENER_CNT; i++) {
+		for (size_t b = 0; b < BUCKET_CNT; b++) {
+			atomic_clear(&listener_hists[i].buckets[b]);
+		}
+	}
+}
+
+size_t app_event_manager_profiler_tracer_hist_dump_size(void)
+{
+	size_t hist_cnt = event_cnt() * APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT + listener_cnt();
+
+	return sizeof(struct hist_dump_hdr) + hist_cnt * BUCKET_CNT * sizeof(uint32_t);
+}
+
+int app_event_manager_profiler_tracer_hist_dump(uint8_t *buf, size_t size)
+{
+	size_t dump_size = app_event_manager_profiler_tracer_hist_dump_size();
+
+	if (size < dump_size) {
+		return -ENOMEM;
+	}
+
+	struct hist_dump_hdr hdr = {
+		.version = DUMP_VERSION,
+		.bucket_cnt = BUCKET_CNT,
+		.event_hist_cnt = APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT,
+		.event_cnt = sys_cpu_to_le16(event_cnt()),
+		.listener_cnt = sys_cpu_to_le16(listener_cnt()),
+	};
+	uint8_t *pos = buf;
+
+	memcpy(pos, &hdr, sizeof(hdr));
+	pos += sizeof(hdr);
+
+	for (size_t i = 0; i < event_cnt(); i++) {
+		for (size_t t = 0; t < APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT; t++) {
+			for (size_t b = 0; b < BUCKET_CNT; b++) {
+				sys_put_le32(atomic_get(&event_hists[i][t].buckets[b]), pos);
+				pos += sizeof(uint32_t);
+			}
+		}
+	}
+
+	for (size_t i = 0; i < listener_cnt(); i++) {
+		for (size_t b = 0; b < BUCKET_CNT; b++) {
+			sys_put_le32(atomic_get(&listener_hists[i].buckets[b]), pos);
+			pos += sizeof(uint32_t);
+		}
+	}
+
+	__ASSERT_NO_MSG(pos - buf == dump_size);
+
+	return dump_size;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/shell/shell.h>
+#include <app_event_manager.h>
+#include <app_event_manager_profiler_tracer.h>
+
+#define BUCKET_CNT	CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_HIST_BUCKET_CNT
+
+extern struct event_listener _event_listener_list_start[];
+extern struct event_listener _event_listener_list_end[];
+
+static const char * const hist_names[] = {
+	[APP_EVENT_MANAGER_HIST_DISPATCH_LATENCY] = "dispatch latency [us]",
+	[APP_EVENT_MANAGER_HIST_PROCESSING_TIME] = "processing time [us]",
+	[APP_EVENT_MANAGER_HIST_QUEUE_DEPTH] = "queue depth",
+};
+
+
+static void print_hist(const struct shell *shell, const char *name, const uint32_t *buckets)
+{
+	uint32_t total = 0;
+
+	for (size_t i = 0; i < BUCKET_CNT; i++) {
+		total += buckets[i];
+	}
+
+	if (total == 0) {
+		return;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "  %s (%u samples):\n", name, total);
+
+	for (size_t i = 0; i < BUCKET_CNT; i++) {
+		if (buckets[i] == 0) {
+			continue;
+		}
+
+		/* Bucket 0 holds zero, bucket n holds values from 2^(n-1) to 2^n - 1. */
+		uint32_t low = (i == 0) ? 0 : BIT(i - 1);
+
+		if (i == BUCKET_CNT - 1) {
+			shell_fprintf(shell, SHELL_NORMAL, "    >= %u: %u\n", low, buckets[i]);
+		} else {
+			shell_fprintf(shell, SHELL_NORMAL, "    %u..%u: %u\n",
+				      low, (i == 0) ? 0 : (uint32_t)(BIT(i) - 1), buckets[i]);
+		}
+	}
+}
+
+static int show_events(const struct shell *shell, size_t argc, char **argv)
+{
+	uint32_t buckets[BUCKET_CNT];
+
+	for (const struct event_type *et = _event_type_list_start;
+	     (et != NULL) && (et != _event_type_list_end);
+	     et++) {
+		size_t ev_id = et - _event_type_list_start;
+
+		if ((argc > 1) && strcmp(argv[1], et->name)) {
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL, "%zu: %s\n", ev_id, et->name);
+
+		for (size_t t = 0; t < APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT; t++) {
+			if (!app_event_manager_profiler_tracer_hist_get(t, ev_id, buckets)) {
+				print_hist(shell, hist_names[t], buckets);
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int show_listeners(const struct shell *shell, size_t argc, char **argv)
+{
+	uint32_t buckets[BUCKET_CNT];
+
+	STRUCT_SECTION_FOREACH(event_listener, el) {
+		size_t idx = el - _event_listener_list_start;
+
+		if (app_event_manager_profiler_tracer_hist_get(APP_EVENT_MANAGER_HIST_LISTENER_TIME,
+							       idx, buckets)) {
+			shell_warn(shell, "Listener %s not tracked", el->name);
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL, "%zu: %s\n", idx, el->name);
+		print_hist(shell, "handler time [us]", buckets);
+	}
+
+	return 0;
+}
+
+static int dump(const struct shell *shell, size_t argc, char **argv)
+{
+	size_t size = app_event_manager_profiler_tracer_hist_dump_size();
+	uint8_t *buf = k_malloc(size);
+
+	if (!buf) {
+		shell_error(shell, "Cannot allocate %zu bytes for the dump", size);
+		return -ENOMEM;
+	}
+
+	int ret = app_event_manager_profiler_tracer_hist_dump(buf, size);
+
+	if (ret > 0) {
+		shell_hexdump(shell, buf, ret);
+	} else {
+		shell_error(shell, "Dump failed (err: %d)", ret);
+	}
+
+	k_free(buf);
+
+	return (ret > 0) ? 0 : ret;
+}
+
+static int reset(const struct shell *shell, size_t argc, char **argv)
+{
+	app_event_manager_profiler_tracer_hist_reset();
+	shell_print(shell, "Histograms cleared");
+
+	return 0;
+}
+
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_app_event_manager_hist,
+	SHELL_CMD_ARG(show_events, NULL, "Show event histograms, optionally for given event name",
+		      show_events, 1, 1),
+	SHELL_CMD_ARG(show_listeners, NULL, "Show listener handler time histograms",
+		      show_listeners, 0, 0),
+	SHELL_CMD_ARG(dump, NULL, "Dump all histograms as binary blob",
+		      dump, 0, 0),
+	SHELL_CMD_ARG(reset, NULL, "Clear all histograms",
+		      reset, 0, 0),
+	SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(app_event_manager_hist, &sub_app_event_manager_hist,
+		   "Application Event Manager latency histograms", NULL);
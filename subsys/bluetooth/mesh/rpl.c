@@ -18,15 +18,116 @@
 #include <mesh/rpl.h>
 #include <emds/emds.h>
 
+/* Open addressing hash index has twice as many entries as the RPL, so that
+ * probe sequences stay short even when the RPL is full.
+ */
+#define RPL_INDEX_SIZE (2 * CONFIG_BT_MESH_CRPL)
+
+BUILD_ASSERT(CONFIG_BT_MESH_CRPL < UINT16_MAX, "RPL index entries are 16-bit");
+
 static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 
 EMDS_STATIC_ENTRY_DEFINE(rpl_store, CONFIG_BT_MESH_RPL_INDEX, replay_list, sizeof(replay_list));
 
+/* Index of replay_list by source address, kept in RAM only. Every entry holds
+ * replay_list index incremented by one, zero marks an unused entry. Used
+ * replay_list slots are always at the beginning of the list, so the flat
+ * layout stored in the Emergency Data Storage is not changed.
+ */
+static uint16_t rpl_index[RPL_INDEX_SIZE];
+static uint16_t rpl_count;
+
 static inline int rpl_idx(const struct bt_mesh_rpl *rpl)
 {
 	return rpl - &replay_list[0];
 }
 
+static inline size_t rpl_hash(uint16_t src)
+{
+	/* Fibonacci hashing spreads consecutive unicast addresses. */
+	return ((uint32_t)src * 2654435761U >> 16) % RPL_INDEX_SIZE;
+}
+
+static inline size_t rpl_index_next(size_t pos)
+{
+	return (pos + 1 == RPL_INDEX_SIZE) ? 0 : pos + 1;
+}
+
+/* Find index entry of the given address, or the unused entry where it can be
+ * inserted. The index is never full, so the search always terminates.
+ */
+static size_t rpl_index_find(uint16_t src)
+{
+	size_t pos = rpl_hash(src);
+
+	while (rpl_index[pos] && replay_list[rpl_index[pos] - 1].src != src) {
+		pos = rpl_index_next(pos);
+	}
+
+	return pos;
+}
+
+static void rpl_index_insert(const struct bt_mesh_rpl *rpl)
+{
+	size_t pos = rpl_index_find(rpl->src);
+
+	rpl_index[pos] = rpl_idx(rpl) + 1;
+}
+
+/* Remove entry from the index, moving back the following entries of the
+ * probe sequence so that no tombstones are needed.
+ */
+static void rpl_index_remove(size_t pos)
+{
+	size_t next = pos;
+
+	while (true) {
+		next = rpl_index_next(next);
+
+		if (!rpl_index[next]) {
+			break;
+		}
+
+		size_t home = rpl_hash(replay_list[rpl_index[next] - 1].src);
+
+		/* Move the entry if its home position is not between the
+		 * removed entry and its current position.
+		 */
+		if ((next > pos) ? (home <= pos || home > next) : (home <= pos && home > next)) {
+			rpl_index[pos] = rpl_index[next];
+			pos = next;
+		}
+	}
+
+	rpl_index[pos] = 0;
+}
+
+static void rpl_index_rebuild(void)
+{
+	(void)memset(rpl_index, 0, sizeof(rpl_index));
+
+	for (rpl_count = 0; rpl_count < ARRAY_SIZE(replay_list); rpl_count++) {
+		if (!replay_list[rpl_count].src) {
+			break;
+		}
+
+		rpl_index_insert(&replay_list[rpl_count]);
+	}
+}
+
+/* Rebuild the index if the number of used slots does not match the list. This
+ * is the case after the list is restored from the Emergency Data Storage on
+ * boot, when the index is still empty.
+ */
+static void rpl_index_sync(void)
+{
+	if ((rpl_count < ARRAY_SIZE(replay_list) && replay_list[rpl_count].src) ||
+	    (rpl_count > 0 && !replay_list[rpl_count - 1].src)) {
+		BT_DBG("RPL index rebuild");
+		rpl_index_rebuild();
+	}
+}
+
 void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		struct bt_mesh_net_rx *rx)
 {
@@ -37,7 +138,26 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		rpl->seg = 0;
 	}
 
-	rpl->src = rx->ctx.addr;
+	if (rpl->src != rx->ctx.addr) {
+		rpl_index_sync();
+
+		if (rpl->src) {
+			/* Slot is reused for another address. */
+			size_t pos = rpl_index_find(rpl->src);
+
+			if (rpl_index[pos]) {
+				rpl_index_remove(pos);
+			}
+		} else {
+			/* Unused slots are handed out in order by bt_mesh_rpl_check(). */
+			__ASSERT_NO_MSG(rpl_idx(rpl) == rpl_count);
+			rpl_count++;
+		}
+
+		rpl->src = rx->ctx.addr;
+		rpl_index_insert(rpl);
+	}
+
 	rpl->seq = rx->seq;
 	rpl->old_iv = rx->old_iv;
 }
@@ -50,7 +170,8 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
+	size_t pos;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -62,48 +183,54 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
+	rpl_index_sync();
 
-		/* Empty slot */
-		if (!rpl->src) {
-			if (match) {
-				*match = rpl;
-			} else {
-				bt_mesh_rpl_update(rpl, rx);
-			}
+	pos = rpl_index_find(rx->ctx.addr);
 
-			return false;
+	/* Empty slot */
+	if (!rpl_index[pos]) {
+		if (rpl_count >= ARRAY_SIZE(replay_list)) {
+			BT_ERR("RPL is full!");
+			return true;
 		}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
+		rpl = &replay_list[rpl_count];
 
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
+		}
 
-				return false;
-			} else {
-				return true;
-			}
+		return false;
+	}
+
+	/* Existing slot for given address */
+	rpl = &replay_list[rpl_index[pos] - 1];
+
+	if (rx->old_iv && !rpl->old_iv) {
+		return true;
+	}
+
+	if ((!rx->old_iv && rpl->old_iv) ||
+	    rpl->seq < rx->seq) {
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
 		}
+
+		return false;
 	}
 
-	BT_ERR("RPL is full!");
 	return true;
 }
 
 void bt_mesh_rpl_clear(void)
 {
 	(void)memset(replay_list, 0, sizeof(replay_list));
+	(void)memset(rpl_index, 0, sizeof(rpl_index));
+	rpl_count = 0;
 }
 
 void bt_mesh_rpl_reset(void)
@@ -135,6 +262,9 @@ void bt_mesh_rpl_reset(void)
 	}
 
 	(void) memset(&replay_list[last - shift + 1], 0, sizeof(struct bt_mesh_rpl) * shift);
+
+	/* Entries were moved, reindex the compacted list. */
+	rpl_index_rebuild();
 }
 
 void bt_mesh_rpl_pending_store(uint16_t addr)
@@ -41,6 +41,14 @@ struct bt_conn {
 	struct bt_le_oob_sc_data oobd_local;
 	struct bt_le_oob_sc_data oobd_remote;
 #endif /* defined(CONFIG_BT_SMP) && !defined(CONFIG_BT_SMP_OOB_LEGACY_PAIR_ONLY) */
+#if defined(CONFIG_BT_RPC_CONN_INFO_CACHE)
+	struct bt_conn_info info;
+	bool info_valid;
+	/* Incremented on every connection event, to detect events received
+	 * while the information was being fetched from the host.
+	 */
+	uint32_t info_gen;
+#endif /* defined(CONFIG_BT_RPC_CONN_INFO_CACHE) */
 };
 
 static struct bt_conn connections[CONFIG_BT_MAX_CONN];
@@ -50,6 +58,18 @@ static inline uint8_t get_conn_index(const struct bt_conn *conn)
 	return (uint8_t)(conn - connections);
 }
 
+static void conn_info_invalidate(struct bt_conn *conn)
+{
+#if defined(CONFIG_BT_RPC_CONN_INFO_CACHE)
+	if (conn) {
+		LOCK_CONN_INFO();
+		conn->info_valid = false;
+		conn->info_gen++;
+		UNLOCK_CONN_INFO();
+	}
+#endif /* defined(CONFIG_BT_RPC_CONN_INFO_CACHE) */
+}
+
 void bt_rpc_encode_bt_conn(struct nrf_rpc_cbor_ctx *encoder, const struct bt_conn *conn)
 {
 	uint8_t index;
@@ -236,11 +256,29 @@ static bool bt_conn_get_dst_out(const struct bt_conn *conn, bt_addr_le_t *dst)
 
 const bt_addr_le_t *bt_conn_get_dst(const struct bt_conn *conn)
 {
+	struct bt_conn *cached = (struct bt_conn *)conn;
+	bt_addr_le_t dst;
 	bool not_null;
 
-	not_null = bt_conn_get_dst_out(conn, (bt_addr_le_t *)&conn->dst);
+#if defined(CONFIG_BT_RPC_CONN_INFO_CACHE)
+	bool valid;
+
+	LOCK_CONN_INFO();
+	valid = cached->info_valid;
+	UNLOCK_CONN_INFO();
+
+	if (valid) {
+		return &conn->dst;
+	}
+#endif /* defined(CONFIG_BT_RPC_CONN_INFO_CACHE) */
+
+	not_null = bt_conn_get_dst_out(conn, &dst);
 
 	if (not_null) {
+		LOCK_CONN_INFO();
+		bt_addr_le_copy(&cached->dst, &dst);
+		UNLOCK_CONN_INFO();
+
 		return &conn->dst;
 	} else {
 		return NULL;
@@ -341,6 +379,19 @@ int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
 	struct nrf_rpc_cbor_ctx ctx;
 	struct bt_conn_get_info_rpc_res result;
 	size_t buffer_size_max = 3;
+#if defined(CONFIG_BT_RPC_CONN_INFO_CACHE)
+	struct bt_conn *cached = (struct bt_conn *)conn;
+	uint32_t gen;
+
+	LOCK_CONN_INFO();
+	if (cached->info_valid) {
+		*info = cached->info;
+		UNLOCK_CONN_INFO();
+		return 0;
+	}
+	gen = cached->info_gen;
+	UNLOCK_CONN_INFO();
+#endif /* defined(CONFIG_BT_RPC_CONN_INFO_CACHE) */
 
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
@@ -352,6 +403,20 @@ int bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
 	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_CONN_GET_INFO_RPC_CMD,
 				&ctx, bt_conn_get_info_rpc_rsp, &result);
 
+#if defined(CONFIG_BT_RPC_CONN_INFO_CACHE)
+	/* Only an established connection is cached. Other states change
+	 * without an event from the host.
+	 */
+	if ((result.result == 0) && (info->state == BT_CONN_STATE_CONNECTED)) {
+		LOCK_CONN_INFO();
+		if (cached->info_gen == gen) {
+			cached->info = *info;
+			cached->info_valid = true;
+		}
+		UNLOCK_CONN_INFO();
+	}
+#endif /* defined(CONFIG_BT_RPC_CONN_INFO_CACHE) */
+
 	return result.result;
 }
 
@@ -508,6 +573,8 @@ int bt_conn_disconnect(struct bt_conn *conn, uint8_t reason)
 	int result;
 	size_t buffer_size_max = 5;
 
+	conn_info_invalidate(conn);
+
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
 	bt_rpc_encode_bt_conn(&ctx, conn);
@@ -736,6 +803,7 @@ static void bt_conn_cb_connected_call_rpc_handler(const struct nrf_rpc_group *gr
 		goto decoding_error;
 	}
 
+	conn_info_invalidate(conn);
 	bt_conn_cb_connected_call(conn, err);
 
 	ser_rsp_send_void(group);
@@ -779,6 +847,7 @@ static void bt_conn_cb_disconnected_call_rpc_handler(const struct nrf_rpc_group
 		goto decoding_error;
 	}
 
+	conn_info_invalidate(conn);
 	bt_conn_cb_disconnected_call(conn, reason);
 
 	ser_rsp_send_void(group);
@@ -879,6 +948,15 @@ static void bt_conn_cb_le_param_updated_call_rpc_handler(const struct nrf_rpc_gr
 		goto decoding_error;
 	}
 
+#if defined(CONFIG_BT_RPC_CONN_INFO_CACHE)
+	LOCK_CONN_INFO();
+	conn->info.le.interval = interval;
+	conn->info.le.latency = latency;
+	conn->info.le.timeout = timeout;
+	conn->info_gen++;
+	UNLOCK_CONN_INFO();
+#endif /* defined(CONFIG_BT_RPC_CONN_INFO_CACHE) */
+
 	bt_conn_cb_le_param_updated_call(conn, interval, latency, timeout);
 
 	ser_rsp_send_void(group);
@@ -929,6 +1007,9 @@ static void bt_conn_cb_identity_resolved_call_rpc_handler(const struct nrf_rpc_g
 		goto decoding_error;
 	}
 
+	/* The destination address changes to the identity address. */
+	conn_info_invalidate(conn);
+
 	bt_conn_cb_identity_resolved_call(conn, rpa, identity);
 
 	ser_rsp_send_void(group);
@@ -978,6 +1059,9 @@ static void bt_conn_cb_security_changed_call_rpc_handler(const struct nrf_rpc_gr
 		goto decoding_error;
 	}
 
+	/* Pairing can change the addresses of the connection. */
+	conn_info_invalidate(conn);
+
 	bt_conn_cb_security_changed_call(conn, level, err);
 
 	ser_rsp_send_void(group);
@@ -1073,6 +1157,14 @@ static void bt_conn_cb_le_phy_updated_call_rpc_handler(const struct nrf_rpc_grou
 		goto decoding_error;
 	}
 
+#if defined(CONFIG_BT_RPC_CONN_INFO_CACHE)
+	LOCK_CONN_INFO();
+	conn->phy = param;
+	conn->info.le.phy = &conn->phy;
+	conn->info_gen++;
+	UNLOCK_CONN_INFO();
+#endif /* defined(CONFIG_BT_RPC_CONN_INFO_CACHE) */
+
 	bt_conn_cb_le_phy_updated_call(conn, &param);
 
 	ser_rsp_send_void(group);
@@ -1120,6 +1212,14 @@ static void bt_conn_cb_le_data_len_updated_call_rpc_handler(const struct nrf_rpc
 		goto decoding_error;
 	}
 
+#if defined(CONFIG_BT_RPC_CONN_INFO_CACHE)
+	LOCK_CONN_INFO();
+	conn->data_len = info;
+	conn->info.le.data_len = &conn->data_len;
+	conn->info_gen++;
+	UNLOCK_CONN_INFO();
+#endif /* defined(CONFIG_BT_RPC_CONN_INFO_CACHE) */
+
 	bt_conn_cb_le_data_len_updated_call(conn, &info);
 
 	ser_rsp_send_void(group);
@@ -1861,6 +1961,14 @@ bt_security_t bt_conn_get_security(struct bt_conn *conn)
 
 void bt_rpc_conn_init(void)
 {
+	/* The cached connection information is updated by the connection events,
+	 * so the host must send them even if no callbacks are registered.
+	 */
+	if (IS_ENABLED(CONFIG_BT_RPC_CONN_INFO_CACHE)) {
+		bt_conn_cb_register_on_remote();
+		return;
+	}
+
 	STRUCT_SECTION_FOREACH(bt_conn_cb, cb) {
 		bt_conn_cb_register_on_remote();
 		return;
@@ -13,6 +13,7 @@
 #include "bluetooth/att.h"
 #include "bluetooth/gatt.h"
 
+#include "bt_rpc.h"
 #include "bt_rpc_common.h"
 #include "bt_rpc_gatt_common.h"
 #include "serialize.h"
@@ -696,6 +697,9 @@ int bt_gatt_service_unregister(struct bt_gatt_service *svc)
 	uint16_t svc_index;
 	int err;
 
+	/* Queued notifications may refer to attributes of this service. */
+	bt_rpc_gatt_notify_flush();
+
 	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
 
 	err = bt_rpc_gatt_service_to_index(svc, &svc_index);
@@ -754,6 +758,180 @@ void bt_gatt_notify_params_enc(struct nrf_rpc_cbor_ctx *encoder,
 	}
 }
 
+#if defined(CONFIG_BT_RPC_GATT_NOTIFY_BATCH)
+/* Notifications without a completion callback are queued in the batch buffer
+ * and sent to the host in one command, so a burst of notifications costs one
+ * round trip instead of one per notification. A queued notification holds a
+ * reference to its connection until the batch is sent, so that the connection
+ * index cannot be reused by another connection in the meantime.
+ */
+struct notify_batch_entry {
+	struct bt_conn *conn;
+	const struct bt_gatt_attr *attr;
+	uint16_t len;
+	uint8_t data[];
+};
+
+/* Encoded size of an entry without its data: connection index, attribute
+ * index and buffer header.
+ */
+#define NOTIFY_BATCH_ENTRY_ENC_SIZE 10
+
+/* Notifications are queued in one batch while the other one is being sent, so
+ * that queuing does not wait for the host to process the sent batch.
+ */
+struct notify_batch {
+	uint8_t buf[CONFIG_BT_RPC_GATT_NOTIFY_BATCH_SIZE] __aligned(sizeof(void *));
+	size_t len;
+	size_t count;
+	size_t enc_size;
+};
+
+static struct notify_batch notify_batches[2];
+static struct notify_batch *notify_batch_fill = &notify_batches[0];
+
+/* Protects the batch being filled. */
+static K_MUTEX_DEFINE(notify_batch_mutex);
+
+/* Serializes sending of the batches, so the notifications keep their order. */
+static K_MUTEX_DEFINE(notify_batch_send_mutex);
+
+static void notify_batch_timeout(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(notify_batch_work, notify_batch_timeout);
+
+static size_t notify_batch_entry_size(uint16_t len)
+{
+	return ROUND_UP(sizeof(struct notify_batch_entry) + len, sizeof(void *));
+}
+
+static void notify_batch_send(struct notify_batch *batch)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct notify_batch_entry *entry;
+	size_t buffer_size_max = 5;
+	size_t offset;
+	int result;
+
+	if (batch->count == 0) {
+		return;
+	}
+
+	buffer_size_max += batch->enc_size;
+
+	NRF_RPC_CBOR_ALLOC(&bt_rpc_grp, ctx, buffer_size_max);
+	ser_encode_uint(&ctx, batch->count);
+
+	for (offset = 0; offset < batch->len;) {
+		entry = (struct notify_batch_entry *)&batch->buf[offset];
+
+		bt_rpc_encode_bt_conn(&ctx, entry->conn);
+		bt_rpc_encode_gatt_attr(&ctx, entry->attr);
+		ser_encode_buffer(&ctx, entry->data, entry->len);
+
+		offset += notify_batch_entry_size(entry->len);
+	}
+
+	nrf_rpc_cbor_cmd_no_err(&bt_rpc_grp, BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD,
+				&ctx, ser_rsp_decode_i32, &result);
+
+	if (result) {
+		LOG_WRN("Batched notification failed: %d", result);
+	}
+
+	for (offset = 0; offset < batch->len;) {
+		entry = (struct notify_batch_entry *)&batch->buf[offset];
+
+		if (entry->conn) {
+			bt_conn_unref(entry->conn);
+		}
+
+		offset += notify_batch_entry_size(entry->len);
+	}
+
+	batch->len = 0;
+	batch->count = 0;
+	batch->enc_size = 0;
+}
+
+static void notify_batch_timeout(struct k_work *work)
+{
+	bt_rpc_gatt_notify_flush();
+}
+
+static bool notify_batch_add(struct bt_conn *conn, const struct bt_gatt_notify_params *params)
+{
+	struct notify_batch *batch;
+	struct notify_batch_entry *entry;
+	size_t size = notify_batch_entry_size(params->len);
+
+	if (size > sizeof(notify_batches[0].buf)) {
+		return false;
+	}
+
+	k_mutex_lock(&notify_batch_mutex, K_FOREVER);
+
+	while (notify_batch_fill->len + size > sizeof(notify_batch_fill->buf)) {
+		/* Sending waits for the host, so the batch mutex is released. */
+		k_mutex_unlock(&notify_batch_mutex);
+		bt_rpc_gatt_notify_flush();
+		k_mutex_lock(&notify_batch_mutex, K_FOREVER);
+	}
+
+	batch = notify_batch_fill;
+	entry = (struct notify_batch_entry *)&batch->buf[batch->len];
+	entry->conn = conn ? bt_conn_ref(conn) : NULL;
+	entry->attr = params->attr;
+	entry->len = params->len;
+	if (params->len > 0) {
+		memcpy(entry->data, params->data, params->len);
+	}
+
+	batch->len += size;
+	batch->count++;
+	batch->enc_size += NOTIFY_BATCH_ENTRY_ENC_SIZE + params->len;
+
+	/* Does nothing if the batch timeout is already running. */
+	k_work_schedule(&notify_batch_work, K_MSEC(CONFIG_BT_RPC_GATT_NOTIFY_BATCH_TIMEOUT));
+
+	k_mutex_unlock(&notify_batch_mutex);
+
+	return true;
+}
+
+void bt_rpc_gatt_notify_flush(void)
+{
+	struct notify_batch *batch;
+	struct notify_batch *next;
+
+	k_mutex_lock(&notify_batch_send_mutex, K_FOREVER);
+	k_mutex_lock(&notify_batch_mutex, K_FOREVER);
+
+	batch = notify_batch_fill;
+	next = (batch == &notify_batches[0]) ? &notify_batches[1] : &notify_batches[0];
+
+	if (next->count == 0) {
+		notify_batch_fill = next;
+		k_mutex_unlock(&notify_batch_mutex);
+
+		notify_batch_send(batch);
+	} else {
+		/* The other batch is still being sent by this thread, which
+		 * handles a host command while waiting for the response. The
+		 * batch is sent in place.
+		 */
+		notify_batch_send(batch);
+		k_mutex_unlock(&notify_batch_mutex);
+	}
+
+	k_mutex_unlock(&notify_batch_send_mutex);
+}
+#else
+void bt_rpc_gatt_notify_flush(void)
+{
+}
+#endif /* defined(CONFIG_BT_RPC_GATT_NOTIFY_BATCH) */
+
 int bt_gatt_notify_cb(struct bt_conn *conn,
 		      struct bt_gatt_notify_params *params)
 {
@@ -762,6 +940,17 @@ int bt_gatt_notify_cb(struct bt_conn *conn,
 	size_t scratchpad_size = 0;
 	size_t buffer_size_max = 8;
 
+#if defined(CONFIG_BT_RPC_GATT_NOTIFY_BATCH)
+	/* The host looks up attributes by UUID itself, so only notifications
+	 * with a known attribute are batched.
+	 */
+	if (!params->func && !params->uuid && notify_batch_add(conn, params)) {
+		return 0;
+	}
+#endif /* defined(CONFIG_BT_RPC_GATT_NOTIFY_BATCH) */
+
+	bt_rpc_gatt_notify_flush();
+
 	buffer_size_max += bt_gatt_notify_params_buf_size(params);
 
 	scratchpad_size += bt_gatt_notify_params_sp_size(params);
@@ -843,6 +1032,8 @@ int bt_gatt_indicate(struct bt_conn *conn, struct bt_gatt_indicate_params *param
 	size_t buffer_size_max = 13;
 	uintptr_t params_addr = (uintptr_t)params;
 
+	bt_rpc_gatt_notify_flush();
+
 	buffer_size_max += bt_gatt_indicate_params_buf_size(params);
 	scratchpad_size += bt_gatt_indicate_params_sp_size(params);
 
@@ -134,6 +134,7 @@ enum bt_rpc_cmd_from_cli_to_host {
 	BT_GATT_RESUBSCRIBE_RPC_CMD,
 	BT_GATT_UNSUBSCRIBE_RPC_CMD,
 	BT_RPC_GATT_SUBSCRIBE_FLAG_UPDATE_RPC_CMD,
+	BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD,
 	/* crypto.h API */
 	BT_RAND_RPC_CMD,
 	BT_ENCRYPT_LE_RPC_CMD,
@@ -826,6 +826,59 @@ decoding_error:
 NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_gatt_notify_cb, BT_GATT_NOTIFY_CB_RPC_CMD,
 	bt_gatt_notify_cb_rpc_handler, NULL);
 
+static void bt_rpc_gatt_notify_batch_rpc_handler(const struct nrf_rpc_group *group,
+						 struct nrf_rpc_cbor_ctx *ctx, void *handler_data)
+{
+	struct bt_gatt_notify_params params = { 0 };
+	struct bt_conn *conn;
+	size_t count;
+	size_t len;
+	int result = 0;
+	int err;
+
+	count = ser_decode_uint(ctx);
+
+	/* Notifications are sent while the data is still in the received packet,
+	 * the Bluetooth stack copies it.
+	 */
+	for (size_t i = 0; i < count; i++) {
+		conn = bt_rpc_decode_bt_conn(ctx);
+		params.attr = bt_rpc_decode_gatt_attr(ctx);
+		/* A notification without data is valid, its data can be
+		 * decoded as NULL.
+		 */
+		len = 0;
+		params.data = ser_decode_buffer_ptr_and_size(ctx, &len);
+		params.len = len;
+
+		if (!params.attr) {
+			ser_decoder_invalid(ctx, ZCBOR_ERR_WRONG_TYPE);
+		}
+
+		if (!ser_decode_valid(ctx)) {
+			break;
+		}
+
+		err = bt_gatt_notify_cb(conn, &params);
+		if (err && !result) {
+			result = err;
+		}
+	}
+
+	if (!ser_decoding_done_and_check(group, ctx)) {
+		goto decoding_error;
+	}
+
+	ser_rsp_send_int(group, result);
+
+	return;
+decoding_error:
+	report_decoding_error(BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD, handler_data);
+}
+
+NRF_RPC_CBOR_CMD_DECODER(bt_rpc_grp, bt_rpc_gatt_notify_batch, BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD,
+	bt_rpc_gatt_notify_batch_rpc_handler, NULL);
+
 void bt_gatt_indicate_params_dec(struct ser_scratchpad *scratchpad,
 				 struct bt_gatt_indicate_params *data)
 {
@@ -58,6 +58,15 @@ int bt_rpc_gatt_subscribe_flag_clear(struct bt_gatt_subscribe_params *params, ui
  */
 int bt_rpc_gatt_subscribe_flag_get(struct bt_gatt_subscribe_params *params, uint32_t flags_bit);
 
+/** @brief Send queued notifications to the host.
+ *
+ * If the @kconfig{CONFIG_BT_RPC_GATT_NOTIFY_BATCH} option is enabled, notifications without
+ * a completion callback are queued and sent in batches. This function sends the queued
+ * notifications immediately and returns after the host has processed them.
+ * Otherwise, this function does nothing.
+ */
+void bt_rpc_gatt_notify_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
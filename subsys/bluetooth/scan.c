@@ -18,34 +18,22 @@ LOG_MODULE_REGISTER(nrf_bt_scan, CONFIG_BT_SCAN_LOG_LEVEL);
 	BT_SCAN_SHORT_NAME_FILTER | BT_SCAN_APPEARANCE_FILTER | \
 	BT_SCAN_UUID_FILTER | BT_SCAN_MANUFACTURER_DATA_FILTER)
 
-/* Scan filter mutex. */
-K_MUTEX_DEFINE(scan_mutex);
-
-/* Scanning control structure used to
- * compare matching filters, their mode and event generation.
+/* Size of an address hash table. It is always larger than the number
+ * of stored addresses, so that the linear probing ends on an empty slot.
  */
-struct bt_scan_control {
-	/* Number of active filters. */
-	uint8_t filter_cnt;
-
-	/* Number of matched filters. */
-	uint8_t filter_match_cnt;
-
-	/* Indicates whether at least one filter has been fitted. */
-	bool filter_match;
+#define ADDR_HASH_SIZE(_cnt) (2 * (_cnt) + 1)
 
-	/* Indicates in which mode filters operate. */
-	bool all_mode;
+/* Number of 32-bit words in a bitmap indexed with a byte. */
+#define BYTE_BITMAP_WORDS (BIT(8) / 32)
 
-	/* Inform that device is connectable. */
-	bool connectable;
-
-	/* Data needed to establish connection and advertising information. */
-	struct bt_scan_device_info device_info;
+/* Filter indexes are stored in hash tables as uint8_t (index + 1). */
+BUILD_ASSERT(CONFIG_BT_SCAN_ADDRESS_CNT < UINT8_MAX);
+#if CONFIG_BT_SCAN_BLOCKLIST
+BUILD_ASSERT(CONFIG_BT_SCAN_BLOCKLIST_LEN < UINT8_MAX);
+#endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
-	/* Scan filter status. */
-	struct bt_scan_filter_match filter_status;
-};
+/* Scan filter mutex. */
+K_MUTEX_DEFINE(scan_mutex);
 
 /* Name filter structure.
  */
@@ -55,6 +43,9 @@ struct bt_scan_name_filter {
 	 */
 	char target_name[CONFIG_BT_SCAN_NAME_CNT][CONFIG_BT_SCAN_NAME_MAX_LEN];
 
+	/* Number of matches of every name. */
+	atomic_t hit_cnt[CONFIG_BT_SCAN_NAME_CNT];
+
 	/* Name filter counter. */
 	uint8_t cnt;
 
@@ -63,18 +54,25 @@ struct bt_scan_name_filter {
 	bool enabled;
 };
 
+/* Short name filter entry.
+ */
+struct scan_short_name {
+	/* Short name that the main application will scan for,
+	 * and that will be advertised by the peripherals.
+	 */
+	char target_name[CONFIG_BT_SCAN_SHORT_NAME_MAX_LEN];
+
+	/* Minimum length of the short name. */
+	uint8_t min_len;
+};
+
 /* Short names filter structure.
  */
 struct bt_scan_short_name_filter {
-	struct {
-		/* Short names that the main application will scan for,
-		 * and that will be advertised by the peripherals.
-		 */
-		char target_name[CONFIG_BT_SCAN_SHORT_NAME_MAX_LEN];
+	struct scan_short_name name[CONFIG_BT_SCAN_SHORT_NAME_CNT];
 
-		/* Minimum length of the short name. */
-		uint8_t min_len;
-	} name[CONFIG_BT_SCAN_SHORT_NAME_CNT];
+	/* Number of matches of every short name. */
+	atomic_t hit_cnt[CONFIG_BT_SCAN_SHORT_NAME_CNT];
 
 	/* Short name filter counter. */
 	uint8_t cnt;
@@ -89,6 +87,9 @@ struct bt_scan_addr_filter {
 	/* Addresses advertised by the peripherals. */
 	bt_addr_le_t target_addr[CONFIG_BT_SCAN_ADDRESS_CNT];
 
+	/* Number of matches of every address. */
+	atomic_t hit_cnt[CONFIG_BT_SCAN_ADDRESS_CNT];
+
 	/* Address filter counter. */
 	uint8_t cnt;
 
@@ -120,6 +121,9 @@ struct bt_scan_uuid_filter {
 	 */
 	struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
 
+	/* Number of matches of every UUID. */
+	atomic_t hit_cnt[CONFIG_BT_SCAN_UUID_CNT];
+
 	/* UUID filter counter. */
 	uint8_t cnt;
 
@@ -133,6 +137,9 @@ struct bt_scan_appearance_filter {
 	 */
 	uint16_t appearance[CONFIG_BT_SCAN_APPEARANCE_CNT];
 
+	/* Number of matches of every appearance. */
+	atomic_t hit_cnt[CONFIG_BT_SCAN_APPEARANCE_CNT];
+
 	/* Appearance filter counter. */
 	uint8_t cnt;
 
@@ -140,20 +147,27 @@ struct bt_scan_appearance_filter {
 	bool enabled;
 };
 
+/* Manufacturer data filter entry.
+ */
+struct scan_manufacturer_data {
+	/* Manufacturer data that the main application will scan for,
+	 * and that will be advertised by the peripherals.
+	 */
+	uint8_t data[CONFIG_BT_SCAN_MANUFACTURER_DATA_MAX_LEN];
+
+	/* Length of the manufacturere data that the main application
+	 * will scan for.
+	 */
+	uint8_t data_len;
+};
+
 /* Manufacturer data filter structure.
  */
 struct bt_scan_manufacturer_data_filter {
-	struct {
-		/* Manufacturer data that the main application will scan for,
-		 * and that will be advertised by the peripherals.
-		 */
-		uint8_t data[CONFIG_BT_SCAN_MANUFACTURER_DATA_MAX_LEN];
+	struct scan_manufacturer_data manufacturer_data[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT];
 
-		/* Length of the manufacturere data that the main application
-		 * will scan for.
-		 */
-		uint8_t data_len;
-	} manufacturer_data[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT];
+	/* Number of matches of every manufacturer data. */
+	atomic_t hit_cnt[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT];
 
 	/* Name filter counter. */
 	uint8_t cnt;
@@ -230,6 +244,125 @@ struct conn_blocklist {
 };
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
+/* UUID in the form used for matching. UUIDs based on the Bluetooth Base UUID
+ * are stored as 32-bit values, so that UUIDs of different sizes compare as
+ * bt_uuid_cmp() does. Other UUIDs point to their 128-bit value.
+ */
+struct scan_uuid_key {
+	/* 128-bit value, or NULL for UUIDs based on the Bluetooth Base UUID. */
+	const uint8_t *val_128;
+
+	/* 32-bit value of the UUID based on the Bluetooth Base UUID. */
+	uint32_t val;
+};
+
+/* Compiled filters.
+ * Filters are copied and compiled into lookup tables whenever they are
+ * changed, so that advertising reports are matched without taking the scan
+ * mutex. Matching reads only the bank and never the filters in bt_scan. The
+ * bank is compiled while it is inactive and is then published with an atomic
+ * pointer swap. A bank is not compiled again while a reader still uses it.
+ */
+struct scan_filter_bank {
+	/* Number of readers using the bank. */
+	atomic_t readers;
+
+	/* Given by the last reader of the bank after it was swapped out. */
+	struct k_sem released;
+
+	/* Enabled filter types, combination of BT_SCAN_*_FILTER. */
+	uint8_t mode;
+
+	/* Generation of the filters the bank was compiled from. */
+	atomic_val_t gen;
+
+	/* Number of enabled filter types. */
+	uint8_t filter_cnt;
+
+	/* Filter mode. */
+	bool all_mode;
+
+	/* Number of filters of every type at the time of compilation. */
+	uint8_t name_cnt;
+	uint8_t short_name_cnt;
+	uint8_t addr_cnt;
+	uint8_t uuid_cnt;
+	uint8_t appearance_cnt;
+	uint8_t manufacturer_data_cnt;
+
+	/* Copies of the filters. */
+	bt_addr_le_t addr[CONFIG_BT_SCAN_ADDRESS_CNT];
+	char name[CONFIG_BT_SCAN_NAME_CNT][CONFIG_BT_SCAN_NAME_MAX_LEN];
+	struct scan_short_name short_name[CONFIG_BT_SCAN_SHORT_NAME_CNT];
+	struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
+	uint16_t appearance[CONFIG_BT_SCAN_APPEARANCE_CNT];
+	struct scan_manufacturer_data manufacturer_data[CONFIG_BT_SCAN_MANUFACTURER_DATA_CNT];
+
+	/* Address filter indexes (index + 1) hashed by address. */
+	uint8_t addr_hash[ADDR_HASH_SIZE(CONFIG_BT_SCAN_ADDRESS_CNT)];
+
+	/* Bitmaps of the first bytes of the names and manufacturer data.
+	 * Advertising data starting with other bytes is rejected at once.
+	 */
+	uint32_t name_first[BYTE_BITMAP_WORDS];
+	uint32_t short_name_first[BYTE_BITMAP_WORDS];
+	uint32_t manufacturer_data_first[BYTE_BITMAP_WORDS];
+
+	/* UUID filters in the form used for matching and bitmap of their
+	 * hashes.
+	 */
+	struct scan_uuid_key uuid_key[CONFIG_BT_SCAN_UUID_CNT];
+	uint32_t uuid_bitmap[BYTE_BITMAP_WORDS];
+
+#if CONFIG_BT_SCAN_BLOCKLIST
+	/* Copy of the blocklist and its indexes (index + 1) hashed by address. */
+	bt_addr_le_t blocklist[CONFIG_BT_SCAN_BLOCKLIST_LEN];
+	uint8_t blocklist_hash[ADDR_HASH_SIZE(CONFIG_BT_SCAN_BLOCKLIST_LEN)];
+#endif /* CONFIG_BT_SCAN_BLOCKLIST */
+};
+
+/* Scanning control structure used to
+ * compare matching filters, their mode and event generation.
+ */
+struct bt_scan_control {
+	/* Compiled filters used for matching. */
+	const struct scan_filter_bank *bank;
+
+	/* Number of active filters. */
+	uint8_t filter_cnt;
+
+	/* Number of matched filters. */
+	uint8_t filter_match_cnt;
+
+	/* Indicates whether at least one filter has been fitted. */
+	bool filter_match;
+
+	/* Indicates in which mode filters operate. */
+	bool all_mode;
+
+	/* Inform that device is connectable. */
+	bool connectable;
+
+	/* Data needed to establish connection and advertising information. */
+	struct bt_scan_device_info device_info;
+
+	/* Scan filter status. */
+	struct bt_scan_filter_match filter_status;
+
+	/* Copies of the matched filters that the filter status points to.
+	 * The bank is released before the callbacks are called, and may be
+	 * compiled again if the callbacks change the filters.
+	 */
+	struct {
+		bt_addr_le_t addr;
+		char name[CONFIG_BT_SCAN_NAME_MAX_LEN];
+		char short_name[CONFIG_BT_SCAN_SHORT_NAME_MAX_LEN];
+		struct bt_scan_uuid uuid[CONFIG_BT_SCAN_UUID_CNT];
+		uint16_t appearance;
+		uint8_t manufacturer_data[CONFIG_BT_SCAN_MANUFACTURER_DATA_MAX_LEN];
+	} match;
+};
+
 /* Scanning module instance. Options for the different scanning modes.
  * This structure stores all module settings. It is used to enable
  * or disable scanning modes and to configure filters.
@@ -266,6 +399,26 @@ static struct bt_scan {
 
 } bt_scan;
 
+/* Banks of compiled filters and the bank used by the readers. */
+static struct scan_filter_bank filter_banks[2] = {
+	{ .released = Z_SEM_INITIALIZER(filter_banks[0].released, 0, 1) },
+	{ .released = Z_SEM_INITIALIZER(filter_banks[1].released, 0, 1) },
+};
+static atomic_ptr_t filter_bank = ATOMIC_PTR_INIT(&filter_banks[0]);
+
+/* Serializes the compilation of the filters. The scan mutex is not held while
+ * waiting for the readers of the inactive bank.
+ */
+static K_MUTEX_DEFINE(filter_bank_mutex);
+
+/* Generation of the filters, incremented whenever they are changed. */
+static atomic_t filters_gen;
+
+/* Bluetooth Base UUID without the leading 32-bit value, in little-endian. */
+static const uint8_t uuid_base[] = {
+	0xfb, 0x34, 0x9b, 0x5f, 0x80, 0x00, 0x00, 0x80, 0x00, 0x10, 0x00, 0x00
+};
+
 static sys_slist_t callback_list;
 
 void bt_scan_cb_register(struct bt_scan_cb *cb)
@@ -326,24 +479,146 @@ static void notify_connecting_error(struct bt_scan_device_info *device_info)
 	}
 }
 
-#if CONFIG_BT_SCAN_BLOCKLIST
-static bool blocklist_device_check(const bt_addr_le_t *addr)
+static void byte_bitmap_set(uint32_t *bitmap, uint8_t byte)
 {
-	bool blocklist_device = false;
+	bitmap[byte / 32] |= BIT(byte % 32);
+}
 
-	k_mutex_lock(&scan_mutex, K_FOREVER);
+static bool byte_bitmap_test(const uint32_t *bitmap, uint8_t byte)
+{
+	return (bitmap[byte / 32] & BIT(byte % 32)) != 0;
+}
 
-	for (size_t i = 0; i < bt_scan.blocklist.count; i++) {
-		if (bt_addr_le_cmp(&bt_scan.blocklist.addr[i], addr) == 0) {
-			blocklist_device = true;
+static size_t addr_hash(const bt_addr_le_t *addr, size_t size)
+{
+	uint32_t hash = sys_get_le32(&addr->a.val[0]) ^
+			((uint32_t)sys_get_le16(&addr->a.val[4]) << 8) ^
+			addr->type;
 
-			break;
+	/* Fibonacci hashing spreads the address bits over the whole word. */
+	return (hash * 2654435769U) % size;
+}
+
+static void addr_hash_add(uint8_t *table, size_t size,
+			  const bt_addr_le_t *addr, uint8_t idx)
+{
+	size_t pos = addr_hash(addr, size);
+
+	while (table[pos] != 0) {
+		pos = (pos + 1) % size;
+	}
+
+	table[pos] = idx + 1;
+}
+
+static int addr_hash_find(const uint8_t *table, size_t size,
+			  const bt_addr_le_t *addrs, const bt_addr_le_t *addr)
+{
+	for (size_t pos = addr_hash(addr, size); table[pos] != 0;
+	     pos = (pos + 1) % size) {
+		uint8_t idx = table[pos] - 1;
+
+		if (bt_addr_le_cmp(&addrs[idx], addr) == 0) {
+			return idx;
 		}
 	}
 
-	k_mutex_unlock(&scan_mutex);
+	return -ENOENT;
+}
+
+static void uuid_key_get(const uint8_t *data, uint8_t uuid_len,
+			 struct scan_uuid_key *key)
+{
+	key->val_128 = NULL;
+
+	switch (uuid_len) {
+	case sizeof(uint16_t):
+		key->val = sys_get_le16(data);
+		break;
 
-	return blocklist_device;
+	case sizeof(uint32_t):
+		key->val = sys_get_le32(data);
+		break;
+
+	default:
+		key->val = sys_get_le32(&data[sizeof(uuid_base)]);
+
+		if (memcmp(data, uuid_base, sizeof(uuid_base)) != 0) {
+			key->val_128 = data;
+		}
+		break;
+	}
+}
+
+static uint8_t uuid_key_hash(const struct scan_uuid_key *key)
+{
+	return key->val ^ (key->val >> 8) ^ (key->val >> 16) ^ (key->val >> 24);
+}
+
+static bool uuid_key_cmp(const struct scan_uuid_key *key_1,
+			 const struct scan_uuid_key *key_2)
+{
+	if ((key_1->val != key_2->val) ||
+	    ((key_1->val_128 == NULL) != (key_2->val_128 == NULL))) {
+		return false;
+	}
+
+	return !key_1->val_128 ||
+	       (memcmp(key_1->val_128, key_2->val_128, BT_SCAN_UUID_128_SIZE) == 0);
+}
+
+static void scan_uuid_copy(struct bt_scan_uuid *dst, const struct bt_scan_uuid *src)
+{
+	dst->uuid_data = src->uuid_data;
+
+	/* Every UUID type starts with the generic UUID header. */
+	dst->uuid = (struct bt_uuid *)&dst->uuid_data;
+}
+
+static struct scan_filter_bank *filter_bank_acquire(void)
+{
+	struct scan_filter_bank *bank;
+
+	while (true) {
+		bank = atomic_ptr_get(&filter_bank);
+		atomic_inc(&bank->readers);
+
+		/* The bank could have been swapped out before the reader
+		 * was registered, and may be compiled again. Retry then.
+		 */
+		if (atomic_ptr_get(&filter_bank) == bank) {
+			return bank;
+		}
+
+		filter_bank_release(bank);
+	}
+}
+
+static void filter_bank_release(struct scan_filter_bank *bank)
+{
+	/* Only a bank that was swapped out can be waited for. */
+	if ((atomic_dec(&bank->readers) == 1) && (atomic_ptr_get(&filter_bank) != bank)) {
+		k_sem_give(&bank->released);
+	}
+}
+
+/* Filter indexes may refer to other filters once the filters are changed, so
+ * matches on a bank compiled from older filters are not counted.
+ */
+static void filter_hit_count(const struct bt_scan_control *control, atomic_t *hit_cnt)
+{
+	if (control->bank->gen == atomic_get(&filters_gen)) {
+		atomic_inc(hit_cnt);
+	}
+}
+
+#if CONFIG_BT_SCAN_BLOCKLIST
+static bool blocklist_device_check(const struct scan_filter_bank *bank,
+				   const bt_addr_le_t *addr)
+{
+	return addr_hash_find(bank->blocklist_hash,
+			      ARRAY_SIZE(bank->blocklist_hash),
+			      bank->blocklist, addr) >= 0;
 }
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
@@ -452,12 +727,6 @@ static bool conn_attempts_exceeded(const bt_addr_le_t *addr)
 
 static bool scan_device_filter_check(const bt_addr_le_t *addr)
 {
-#if CONFIG_BT_SCAN_BLOCKLIST
-	if (blocklist_device_check(addr)) {
-		return false;
-	}
-#endif /* CONFIG_BT_SCAN_BLOCKLIST */
-
 #if CONFIG_BT_SCAN_CONN_ATTEMPTS_FILTER
 	if (conn_attempts_exceeded(addr)) {
 		return false;
@@ -503,19 +772,20 @@ static void scan_connect_with_target(struct bt_scan_control *control,
 static bool adv_addr_compare(const bt_addr_le_t *target_addr,
 			     struct bt_scan_control *control)
 {
-	const bt_addr_le_t *addr =
-			bt_scan.scan_filters.addr.target_addr;
-	uint8_t counter = bt_scan.scan_filters.addr.cnt;
-
-	for (size_t i = 0; i < counter; i++) {
-		if (bt_addr_le_cmp(target_addr, &addr[i]) == 0) {
-			control->filter_status.addr.addr = &addr[i];
+	const struct scan_filter_bank *bank = control->bank;
+	int idx;
 
-			return true;
-		}
+	idx = addr_hash_find(bank->addr_hash, ARRAY_SIZE(bank->addr_hash),
+			     bank->addr, target_addr);
+	if (idx < 0) {
+		return false;
 	}
 
-	return false;
+	bt_addr_le_copy(&control->match.addr, &bank->addr[idx]);
+	control->filter_status.addr.addr = &control->match.addr;
+	filter_hit_count(control, &bt_scan.scan_filters.addr.hit_cnt[idx]);
+
+	return true;
 }
 
 static bool is_addr_filter_enabled(void)
@@ -526,7 +796,7 @@ static bool is_addr_filter_enabled(void)
 static void check_addr(struct bt_scan_control *control,
 		       const bt_addr_le_t *addr)
 {
-	if (is_addr_filter_enabled()) {
+	if (control->bank->mode & BT_SCAN_ADDR_FILTER) {
 		if (adv_addr_compare(addr, control)) {
 			control->filter_match_cnt++;
 
@@ -558,6 +828,7 @@ static int scan_addr_filter_add(const bt_addr_le_t *target_addr)
 
 	/* Add target address to filter. */
 	bt_addr_le_copy(&addr_filter[counter], target_addr);
+	atomic_set(&bt_scan.scan_filters.addr.hit_cnt[counter], 0);
 
 	LOG_DBG("Filter set on address type %i",
 		addr_filter[counter].type);
@@ -582,20 +853,27 @@ static bool adv_name_cmp(const uint8_t *data,
 static bool adv_name_compare(const struct bt_data *data,
 			     struct bt_scan_control *control)
 {
-	struct bt_scan_name_filter const *name_filter =
-			&bt_scan.scan_filters.name;
-	uint8_t counter = bt_scan.scan_filters.name.cnt;
+	const struct scan_filter_bank *bank = control->bank;
+	uint8_t counter = bank->name_cnt;
 	uint8_t data_len = data->data_len;
 
+	/* No name starts with the advertised first character. */
+	if ((data_len > 0) &&
+	    !byte_bitmap_test(bank->name_first, data->data[0])) {
+		return false;
+	}
+
 	/* Compare the name found with the name filter. */
 	for (size_t i = 0; i < counter; i++) {
 		if (adv_name_cmp(data->data,
 				 data_len,
-				 name_filter->target_name[i])) {
+				 bank->name[i])) {
 
-			control->filter_status.name.name =
-				name_filter->target_name[i];
+			memcpy(control->match.name, bank->name[i],
+			       sizeof(control->match.name));
+			control->filter_status.name.name = control->match.name;
 			control->filter_status.name.len = data_len;
+			filter_hit_count(control, &bt_scan.scan_filters.name.hit_cnt[i]);
 
 			return true;
 		}
@@ -612,7 +890,7 @@ static inline bool is_name_filter_enabled(void)
 static void name_check(struct bt_scan_control *control,
 		       const struct bt_data *data)
 {
-	if (is_name_filter_enabled()) {
+	if (control->bank->mode & BT_SCAN_NAME_FILTER) {
 		if (adv_name_compare(data, control)) {
 			control->filter_match_cnt++;
 
@@ -650,6 +928,7 @@ static int scan_name_filter_add(const char *name)
 	/* Add name to filter. */
 	memcpy(bt_scan.scan_filters.name.target_name[counter],
 	       name, name_len);
+	atomic_set(&bt_scan.scan_filters.name.hit_cnt[counter], 0);
 
 	bt_scan.scan_filters.name.cnt++;
 
@@ -674,21 +953,30 @@ static bool adv_short_name_cmp(const uint8_t *data,
 static bool adv_short_name_compare(const struct bt_data *data,
 				   struct bt_scan_control *control)
 {
-	const struct bt_scan_short_name_filter *name_filter =
-			&bt_scan.scan_filters.short_name;
-	uint8_t counter = bt_scan.scan_filters.short_name.cnt;
+	const struct scan_filter_bank *bank = control->bank;
+	uint8_t counter = bank->short_name_cnt;
 	uint8_t data_len = data->data_len;
 
+	/* No short name starts with the advertised first character. */
+	if ((data_len > 0) &&
+	    !byte_bitmap_test(bank->short_name_first, data->data[0])) {
+		return false;
+	}
+
 	/* Compare the name found with the name filters. */
 	for (size_t i = 0; i < counter; i++) {
 		if (adv_short_name_cmp(data->data,
 				       data_len,
-				       name_filter->name[i].target_name,
-				       name_filter->name[i].min_len)) {
+				       bank->short_name[i].target_name,
+				       bank->short_name[i].min_len)) {
 
+			memcpy(control->match.short_name,
+			       bank->short_name[i].target_name,
+			       sizeof(control->match.short_name));
 			control->filter_status.short_name.name =
-				name_filter->name[i].target_name;
+				control->match.short_name;
 			control->filter_status.short_name.len = data_len;
+			filter_hit_count(control, &bt_scan.scan_filters.short_name.hit_cnt[i]);
 
 			return true;
 		}
@@ -705,7 +993,7 @@ static inline bool is_short_name_filter_enabled(void)
 static void short_name_check(struct bt_scan_control *control,
 			     const struct bt_data *data)
 {
-	if (is_short_name_filter_enabled()) {
+	if (control->bank->mode & BT_SCAN_SHORT_NAME_FILTER) {
 		if (adv_short_name_compare(data, control)) {
 			control->filter_match_cnt++;
 
@@ -750,6 +1038,7 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	memcpy(short_name_filter->name[counter].target_name,
 	       short_name->name,
 	       name_len);
+	atomic_set(&short_name_filter->hit_cnt[counter], 0);
 
 	bt_scan.scan_filters.short_name.cnt++;
 
@@ -758,61 +1047,48 @@ static int scan_short_name_filter_add(const struct bt_scan_short_name *short_nam
 	return 0;
 }
 
-static bool find_uuid(const uint8_t *data,
-		      uint8_t data_len,
-		      uint8_t uuid_type,
-		      const struct bt_scan_uuid *target_uuid)
+static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_len,
+			     struct bt_scan_control *control)
 {
-	uint8_t uuid_len;
-
-	switch (uuid_type) {
-	case BT_UUID_TYPE_16:
-		uuid_len = sizeof(uint16_t);
-		break;
+	struct bt_scan_uuid_filter *uuid_filter =
+			&bt_scan.scan_filters.uuid;
+	const struct scan_filter_bank *bank = control->bank;
+	const bool all_filters_mode = bank->all_mode;
+	const uint8_t counter = bank->uuid_cnt;
+	uint8_t data_len = data->data_len;
+	uint8_t uuid_match_cnt = 0;
+	bool found[CONFIG_BT_SCAN_UUID_CNT];
+	size_t i;
 
-	case BT_UUID_TYPE_32:
-		uuid_len = sizeof(uint32_t);
-		break;
+	memset(found, 0, sizeof(found));
 
-	case BT_UUID_TYPE_128:
-		uuid_len = BT_SCAN_UUID_128_SIZE * sizeof(uint8_t);
-		break;
-
-	default:
-		return false;
-	}
+	/* Mark the filters found in the advertising data. UUIDs with hashes
+	 * that are not in the bitmap cannot match any filter.
+	 */
+	for (size_t pos = 0; (pos + uuid_len) <= data_len; pos += uuid_len) {
+		struct scan_uuid_key key;
 
-	for (size_t i = 0; i < data_len; i += uuid_len) {
-		struct bt_uuid_128 uuid;
+		uuid_key_get(&data->data[pos], uuid_len, &key);
 
-		if (!bt_uuid_create(&uuid.uuid, &data[i], uuid_len)) {
-			return false;
+		if (!byte_bitmap_test(bank->uuid_bitmap, uuid_key_hash(&key))) {
+			continue;
 		}
 
-		if (bt_uuid_cmp(&uuid.uuid, target_uuid->uuid) == 0) {
-			return true;
+		for (i = 0; i < counter; i++) {
+			if (uuid_key_cmp(&key, &bank->uuid_key[i])) {
+				found[i] = true;
+			}
 		}
 	}
 
-	return false;
-}
-
-static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
-			     struct bt_scan_control *control)
-{
-	const struct bt_scan_uuid_filter *uuid_filter =
-			&bt_scan.scan_filters.uuid;
-	const bool all_filters_mode = bt_scan.scan_filters.all_mode;
-	const uint8_t counter = bt_scan.scan_filters.uuid.cnt;
-	uint8_t data_len = data->data_len;
-	uint8_t uuid_match_cnt = 0;
-
-	for (size_t i = 0; i < counter; i++) {
+	for (i = 0; i < counter; i++) {
+		if (found[i]) {
+			struct bt_scan_uuid *match =
+				&control->match.uuid[uuid_match_cnt];
 
-		if (find_uuid(data->data, data_len, uuid_type,
-			      &uuid_filter->uuid[i])) {
+			scan_uuid_copy(match, &bank->uuid[i]);
 			control->filter_status.uuid.uuid[uuid_match_cnt] =
-				uuid_filter->uuid[i].uuid;
+				match->uuid;
 
 			uuid_match_cnt++;
 
@@ -820,6 +1096,7 @@ static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
 			 * only one UUID is needed to match.
 			 */
 			if (!all_filters_mode) {
+				filter_hit_count(control, &uuid_filter->hit_cnt[i]);
 				break;
 			}
 
@@ -833,12 +1110,15 @@ static bool adv_uuid_compare(const struct bt_data *data, uint8_t uuid_type,
 	/* In the multifilter mode, all UUIDs must be found in
 	 * the advertisement packets.
 	 */
-	if ((all_filters_mode && (uuid_match_cnt == counter)) ||
-	    ((!all_filters_mode) && (uuid_match_cnt > 0))) {
+	if (all_filters_mode && (uuid_match_cnt == counter)) {
+		for (i = 0; i < counter; i++) {
+			filter_hit_count(control, &uuid_filter->hit_cnt[i]);
+		}
+
 		return true;
 	}
 
-	return false;
+	return (!all_filters_mode) && (uuid_match_cnt > 0);
 }
 
 static bool is_uuid_filter_enabled(void)
@@ -848,10 +1128,10 @@ static bool is_uuid_filter_enabled(void)
 
 static void uuid_check(struct bt_scan_control *control,
 		       const struct bt_data *data,
-		       uint8_t type)
+		       uint8_t uuid_len)
 {
-	if (is_uuid_filter_enabled()) {
-		if (adv_uuid_compare(data, type, control)) {
+	if (control->bank->mode & BT_SCAN_UUID_FILTER) {
+		if (adv_uuid_compare(data, uuid_len, control)) {
 			control->filter_match_cnt++;
 
 			/* Information about the filters matched. */
@@ -911,6 +1191,7 @@ static int scan_uuid_filter_add(struct bt_uuid *uuid)
 		return -EINVAL;
 	}
 
+	atomic_set(&bt_scan.scan_filters.uuid.hit_cnt[counter], 0);
 	bt_scan.scan_filters.uuid.cnt++;
 	LOG_DBG("Added filter on UUID type %x", uuid->type);
 
@@ -938,10 +1219,8 @@ static bool find_appearance(const uint8_t *data,
 static bool adv_appearance_compare(const struct bt_data *data,
 				   struct bt_scan_control *control)
 {
-	const struct bt_scan_appearance_filter *appearance_filter =
-			&bt_scan.scan_filters.appearance;
-	const uint8_t counter =
-			bt_scan.scan_filters.appearance.cnt;
+	const struct scan_filter_bank *bank = control->bank;
+	const uint8_t counter = bank->appearance_cnt;
 	uint8_t data_len = data->data_len;
 
 	/* Verify if the advertised appearance matches
@@ -950,10 +1229,12 @@ static bool adv_appearance_compare(const struct bt_data *data,
 	for (size_t i = 0; i < counter; i++) {
 		if (find_appearance(data->data,
 				    data_len,
-				    &appearance_filter->appearance[i])) {
+				    &bank->appearance[i])) {
 
+			control->match.appearance = bank->appearance[i];
 			control->filter_status.appearance.appearance =
-					&appearance_filter->appearance[i];
+					&control->match.appearance;
+			filter_hit_count(control, &bt_scan.scan_filters.appearance.hit_cnt[i]);
 
 			return true;
 		}
@@ -970,7 +1251,7 @@ static inline bool is_appearance_filter_enabled(void)
 static void appearance_check(struct bt_scan_control *control,
 			     const struct bt_data *data)
 {
-	if (is_appearance_filter_enabled()) {
+	if (control->bank->mode & BT_SCAN_APPEARANCE_FILTER) {
 		if (adv_appearance_compare(data, control)) {
 			control->filter_match_cnt++;
 
@@ -1000,6 +1281,7 @@ static int scan_appearance_filter_add(uint16_t appearance)
 
 	/* Add appearance to the filter. */
 	appearance_filter[counter] = appearance;
+	atomic_set(&bt_scan.scan_filters.appearance.hit_cnt[counter], 0);
 	bt_scan.scan_filters.appearance.cnt++;
 
 	LOG_DBG("Added filter on appearance %x", appearance);
@@ -1026,21 +1308,32 @@ static bool adv_manufacturer_data_cmp(const uint8_t *data,
 static bool adv_manufacturer_data_compare(const struct bt_data *data,
 					  struct bt_scan_control *control)
 {
-	const struct bt_scan_manufacturer_data_filter *md_filter =
-		&bt_scan.scan_filters.manufacturer_data;
-	uint8_t counter = bt_scan.scan_filters.manufacturer_data.cnt;
+	const struct scan_filter_bank *bank = control->bank;
+	uint8_t counter = bank->manufacturer_data_cnt;
+
+	/* No manufacturer data starts with the advertised first byte. */
+	if ((data->data_len > 0) &&
+	    !byte_bitmap_test(bank->manufacturer_data_first,
+			      data->data[0])) {
+		return false;
+	}
 
 	/* Compare the name found with the name filter. */
 	for (size_t i = 0; i < counter; i++) {
+		const struct scan_manufacturer_data *md = &bank->manufacturer_data[i];
+
 		if (adv_manufacturer_data_cmp(data->data,
 				data->data_len,
-				md_filter->manufacturer_data[i].data,
-				md_filter->manufacturer_data[i].data_len)) {
+				md->data,
+				md->data_len)) {
 
+			memcpy(control->match.manufacturer_data, md->data,
+			       md->data_len);
 			control->filter_status.manufacturer_data.data =
-				md_filter->manufacturer_data[i].data;
+				control->match.manufacturer_data;
 			control->filter_status.manufacturer_data.len =
-				md_filter->manufacturer_data[i].data_len;
+				md->data_len;
+			filter_hit_count(control, &bt_scan.scan_filters.manufacturer_data.hit_cnt[i]);
 
 			return true;
 		}
@@ -1057,7 +1350,7 @@ static inline bool is_manufacturer_data_filter_enabled(void)
 static void manufacturer_data_check(struct bt_scan_control *control,
 				    const struct bt_data *data)
 {
-	if (is_manufacturer_data_filter_enabled()) {
+	if (control->bank->mode & BT_SCAN_MANUFACTURER_DATA_FILTER) {
 		if (adv_manufacturer_data_compare(data, control)) {
 			control->filter_match_cnt++;
 
@@ -1101,6 +1394,7 @@ static int scan_manufacturer_data_filter_add(const struct bt_scan_manufacturer_d
 			manufacturer_data->data, manufacturer_data->data_len);
 	md_filter->manufacturer_data[counter].data_len =
 		manufacturer_data->data_len;
+	atomic_set(&md_filter->hit_cnt[counter], 0);
 
 	bt_scan.scan_filters.manufacturer_data.cnt++;
 
@@ -1109,6 +1403,155 @@ static int scan_manufacturer_data_filter_add(const struct bt_scan_manufacturer_d
 	return 0;
 }
 
+static void uuid_filter_key_get(const struct bt_uuid *uuid,
+				struct scan_uuid_key *key)
+{
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		key->val_128 = NULL;
+		key->val = BT_UUID_16(uuid)->val;
+		break;
+
+	case BT_UUID_TYPE_32:
+		key->val_128 = NULL;
+		key->val = BT_UUID_32(uuid)->val;
+		break;
+
+	default:
+		uuid_key_get(BT_UUID_128(uuid)->val, BT_SCAN_UUID_128_SIZE, key);
+		break;
+	}
+}
+
+/* Mark the filters as changed. The filters must be compiled afterwards.
+ * Must be called with the scan mutex locked.
+ */
+static void filters_changed(void)
+{
+	atomic_inc(&filters_gen);
+}
+
+/* Compile the filters into the inactive bank and publish it.
+ * Must be called with the scan mutex unlocked.
+ */
+static void filters_compile(void)
+{
+	const struct bt_scan_filters *filters = &bt_scan.scan_filters;
+
+	k_mutex_lock(&filter_bank_mutex, K_FOREVER);
+
+	struct scan_filter_bank *bank = &filter_banks[0];
+
+	if (atomic_ptr_get(&filter_bank) == bank) {
+		bank = &filter_banks[1];
+	}
+
+	/* Wait for the readers that got the bank before it was swapped out.
+	 * The semaphore may have been given by a reader of an earlier
+	 * compilation, so the reader counter is checked again.
+	 */
+	while (atomic_get(&bank->readers) != 0) {
+		k_sem_take(&bank->released, K_FOREVER);
+	}
+
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
+	/* Readers may still register on the bank for a moment, so the reader
+	 * counter is left intact.
+	 */
+	memset((uint8_t *)bank + offsetof(struct scan_filter_bank, mode), 0,
+	       sizeof(*bank) - offsetof(struct scan_filter_bank, mode));
+
+	bank->gen = atomic_get(&filters_gen);
+	bank->all_mode = filters->all_mode;
+
+	if (is_addr_filter_enabled()) {
+		bank->mode |= BT_SCAN_ADDR_FILTER;
+		bank->addr_cnt = filters->addr.cnt;
+
+		for (size_t i = 0; i < bank->addr_cnt; i++) {
+			bt_addr_le_copy(&bank->addr[i], &filters->addr.target_addr[i]);
+			addr_hash_add(bank->addr_hash, ARRAY_SIZE(bank->addr_hash),
+				      &bank->addr[i], i);
+		}
+	}
+
+	if (is_name_filter_enabled()) {
+		bank->mode |= BT_SCAN_NAME_FILTER;
+		bank->name_cnt = filters->name.cnt;
+
+		memcpy(bank->name, filters->name.target_name,
+		       bank->name_cnt * sizeof(bank->name[0]));
+
+		for (size_t i = 0; i < bank->name_cnt; i++) {
+			byte_bitmap_set(bank->name_first, bank->name[i][0]);
+		}
+	}
+
+	if (is_short_name_filter_enabled()) {
+		bank->mode |= BT_SCAN_SHORT_NAME_FILTER;
+		bank->short_name_cnt = filters->short_name.cnt;
+
+		memcpy(bank->short_name, filters->short_name.name,
+		       bank->short_name_cnt * sizeof(bank->short_name[0]));
+
+		for (size_t i = 0; i < bank->short_name_cnt; i++) {
+			byte_bitmap_set(bank->short_name_first,
+					bank->short_name[i].target_name[0]);
+		}
+	}
+
+	if (is_uuid_filter_enabled()) {
+		bank->mode |= BT_SCAN_UUID_FILTER;
+		bank->uuid_cnt = filters->uuid.cnt;
+
+		/* The keys of 128-bit UUIDs point to the copies in the bank. */
+		for (size_t i = 0; i < bank->uuid_cnt; i++) {
+			scan_uuid_copy(&bank->uuid[i], &filters->uuid.uuid[i]);
+			uuid_filter_key_get(bank->uuid[i].uuid, &bank->uuid_key[i]);
+			byte_bitmap_set(bank->uuid_bitmap, uuid_key_hash(&bank->uuid_key[i]));
+		}
+	}
+
+	if (is_appearance_filter_enabled()) {
+		bank->mode |= BT_SCAN_APPEARANCE_FILTER;
+		bank->appearance_cnt = filters->appearance.cnt;
+		memcpy(bank->appearance, filters->appearance.appearance,
+		       bank->appearance_cnt * sizeof(bank->appearance[0]));
+	}
+
+	if (is_manufacturer_data_filter_enabled()) {
+		bank->mode |= BT_SCAN_MANUFACTURER_DATA_FILTER;
+		bank->manufacturer_data_cnt = filters->manufacturer_data.cnt;
+
+		memcpy(bank->manufacturer_data,
+		       filters->manufacturer_data.manufacturer_data,
+		       bank->manufacturer_data_cnt * sizeof(bank->manufacturer_data[0]));
+
+		for (size_t i = 0; i < bank->manufacturer_data_cnt; i++) {
+			byte_bitmap_set(bank->manufacturer_data_first,
+					bank->manufacturer_data[i].data[0]);
+		}
+	}
+
+	for (uint8_t mode = bank->mode; mode; mode &= (mode - 1)) {
+		bank->filter_cnt++;
+	}
+
+#if CONFIG_BT_SCAN_BLOCKLIST
+	for (size_t i = 0; i < bt_scan.blocklist.count; i++) {
+		bt_addr_le_copy(&bank->blocklist[i], &bt_scan.blocklist.addr[i]);
+		addr_hash_add(bank->blocklist_hash, ARRAY_SIZE(bank->blocklist_hash),
+			      &bank->blocklist[i], i);
+	}
+#endif /* CONFIG_BT_SCAN_BLOCKLIST */
+
+	atomic_ptr_set(&filter_bank, bank);
+
+	k_mutex_unlock(&scan_mutex);
+	k_mutex_unlock(&filter_bank_mutex);
+}
+
 static bool check_filter_mode(uint8_t mode)
 {
 	return (mode & MODE_CHECK) != 0;
@@ -1203,8 +1646,16 @@ int bt_scan_filter_add(enum bt_scan_filter_type type,
 		break;
 	}
 
+	if (!err) {
+		filters_changed();
+	}
+
 	k_mutex_unlock(&scan_mutex);
 
+	if (!err) {
+		filters_compile();
+	}
+
 	return err;
 }
 
@@ -1236,12 +1687,16 @@ void bt_scan_filter_remove_all(void)
 		&bt_scan.scan_filters.manufacturer_data;
 	manufacturer_data_filter->cnt = 0;
 
+	filters_changed();
+
 	k_mutex_unlock(&scan_mutex);
+
+	filters_compile();
 }
 
-void bt_scan_filter_disable(void)
+/* Must be called with the scan mutex locked. */
+static void filters_disable(void)
 {
-	/* Disable all filters. */
 	bt_scan.scan_filters.name.enabled = false;
 	bt_scan.scan_filters.short_name.enabled = false;
 	bt_scan.scan_filters.addr.enabled = false;
@@ -1250,6 +1705,19 @@ void bt_scan_filter_disable(void)
 	bt_scan.scan_filters.manufacturer_data.enabled = false;
 }
 
+void bt_scan_filter_disable(void)
+{
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
+	/* Disable all filters. */
+	filters_disable();
+	filters_changed();
+
+	k_mutex_unlock(&scan_mutex);
+
+	filters_compile();
+}
+
 int bt_scan_filter_enable(uint8_t mode, bool match_all)
 {
 	/* Check if the mode is correct. */
@@ -1257,8 +1725,10 @@ int bt_scan_filter_enable(uint8_t mode, bool match_all)
 		return -EINVAL;
 	}
 
+	k_mutex_lock(&scan_mutex, K_FOREVER);
+
 	/* Disable filters. */
-	bt_scan_filter_disable();
+	filters_disable();
 
 	struct bt_scan_filters *filters = &bt_scan.scan_filters;
 
@@ -1290,6 +1760,13 @@ int bt_scan_filter_enable(uint8_t mode, bool match_all)
 	/* Select the filter mode. */
 	filters->all_mode = match_all;
 
+	filters_changed();
+
+	k_mutex_unlock(&scan_mutex);
+
+	/* Compile the filters, so that they are matched without locking. */
+	filters_compile();
+
 	return 0;
 }
 
@@ -1318,6 +1795,61 @@ int bt_scan_filter_status_get(struct bt_filter_status *status)
 	return 0;
 }
 
+int bt_scan_filter_hit_cnt_get(enum bt_scan_filter_type type, uint8_t idx,
+			       uint32_t *hit_cnt)
+{
+	struct bt_scan_filters *filters = &bt_scan.scan_filters;
+	atomic_t *filter_hit_cnt;
+	uint8_t counter;
+
+	if (!hit_cnt) {
+		return -EINVAL;
+	}
+
+	switch (type) {
+	case BT_SCAN_FILTER_TYPE_NAME:
+		filter_hit_cnt = filters->name.hit_cnt;
+		counter = filters->name.cnt;
+		break;
+
+	case BT_SCAN_FILTER_TYPE_SHORT_NAME:
+		filter_hit_cnt = filters->short_name.hit_cnt;
+		counter = filters->short_name.cnt;
+		break;
+
+	case BT_SCAN_FILTER_TYPE_ADDR:
+		filter_hit_cnt = filters->addr.hit_cnt;
+		counter = filters->addr.cnt;
+		break;
+
+	case BT_SCAN_FILTER_TYPE_UUID:
+		filter_hit_cnt = filters->uuid.hit_cnt;
+		counter = filters->uuid.cnt;
+		break;
+
+	case BT_SCAN_FILTER_TYPE_APPEARANCE:
+		filter_hit_cnt = filters->appearance.hit_cnt;
+		counter = filters->appearance.cnt;
+		break;
+
+	case BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA:
+		filter_hit_cnt = filters->manufacturer_data.hit_cnt;
+		counter = filters->manufacturer_data.cnt;
+		break;
+
+	default:
+		return -EINVAL;
+	}
+
+	if (idx >= counter) {
+		return -ENOENT;
+	}
+
+	*hit_cnt = atomic_get(&filter_hit_cnt[idx]);
+
+	return 0;
+}
+
 int bt_scan_stop(void)
 {
 	return bt_le_scan_stop();
@@ -1329,7 +1861,12 @@ void bt_scan_init(const struct bt_scan_init_param *init)
 	bt_le_scan_cb_register(&scan_cb);
 
 	/* Disable all scanning filters. */
+	k_mutex_lock(&scan_mutex, K_FOREVER);
 	memset(&bt_scan.scan_filters, 0, sizeof(bt_scan.scan_filters));
+	filters_changed();
+	k_mutex_unlock(&scan_mutex);
+
+	filters_compile();
 
 	/* If the pointer to the initialization structure exist,
 	 * use it to scan the configuration.
@@ -1368,40 +1905,9 @@ void bt_scan_update_init_conn_params(struct bt_le_conn_param *new_conn_param)
 	bt_scan.conn_param = *new_conn_param;
 }
 
-static void check_enabled_filters(struct bt_scan_control *control)
-{
-	control->filter_cnt = 0;
-
-	if (is_addr_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_short_name_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_uuid_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_appearance_filter_enabled()) {
-		control->filter_cnt++;
-	}
-
-	if (is_manufacturer_data_filter_enabled()) {
-		control->filter_cnt++;
-	}
-}
-
-static bool adv_data_found(struct bt_data *data, void *user_data)
+static void adv_data_found(const struct bt_data *data,
+			   struct bt_scan_control *scan_control)
 {
-	struct bt_scan_control *scan_control =
-			(struct bt_scan_control *)user_data;
-
 	switch (data->type) {
 	case BT_DATA_NAME_COMPLETE:
 		/* Check the name filter. */
@@ -1421,18 +1927,18 @@ static bool adv_data_found(struct bt_data *data, void *user_data)
 	case BT_DATA_UUID16_SOME:
 	case BT_DATA_UUID16_ALL:
 		/* Check the UUID filter. */
-		uuid_check(scan_control, data, BT_UUID_TYPE_16);
+		uuid_check(scan_control, data, sizeof(uint16_t));
 		break;
 
 	case BT_DATA_UUID32_SOME:
 	case BT_DATA_UUID32_ALL:
-		uuid_check(scan_control, data, BT_UUID_TYPE_32);
+		uuid_check(scan_control, data, sizeof(uint32_t));
 		break;
 
 	case BT_DATA_UUID128_SOME:
 	case BT_DATA_UUID128_ALL:
 		/* Check the UUID filter. */
-		uuid_check(scan_control, data, BT_UUID_TYPE_128);
+		uuid_check(scan_control, data, BT_SCAN_UUID_128_SIZE);
 		break;
 
 	case BT_DATA_MANUFACTURER_DATA:
@@ -1443,8 +1949,40 @@ static bool adv_data_found(struct bt_data *data, void *user_data)
 	default:
 		break;
 	}
+}
 
-	return true;
+/* Match the advertising data structures in a single pass, without modifying
+ * the buffer. The data is split in the same way as by bt_data_parse().
+ */
+static void adv_data_match(struct bt_scan_control *control,
+			   const struct net_buf_simple *ad)
+{
+	const uint8_t *ptr = ad->data;
+	size_t len = ad->len;
+
+	while (len > 1) {
+		struct bt_data data;
+		uint8_t field_len = ptr[0];
+
+		/* Check for early termination. */
+		if (field_len == 0) {
+			return;
+		}
+
+		if (field_len > (len - 1)) {
+			LOG_DBG("Malformed advertising data");
+			return;
+		}
+
+		data.type = ptr[1];
+		data.data_len = field_len - 1;
+		data.data = &ptr[2];
+
+		adv_data_found(&data, control);
+
+		ptr += field_len + 1;
+		len -= field_len + 1;
+	}
 }
 
 static void filter_state_check(struct bt_scan_control *control,
@@ -1480,13 +2018,21 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 		      struct net_buf_simple *ad)
 {
 	struct bt_scan_control scan_control;
-	struct net_buf_simple_state state;
+	struct scan_filter_bank *bank = filter_bank_acquire();
 
-	memset(&scan_control, 0, sizeof(scan_control));
+#if CONFIG_BT_SCAN_BLOCKLIST
+	/* No event is generated for the blocklist devices. */
+	if (blocklist_device_check(bank, info->addr)) {
+		filter_bank_release(bank);
+		return;
+	}
+#endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
-	scan_control.all_mode = bt_scan.scan_filters.all_mode;
+	memset(&scan_control, 0, sizeof(scan_control));
 
-	check_enabled_filters(&scan_control);
+	scan_control.bank = bank;
+	scan_control.all_mode = bank->all_mode;
+	scan_control.filter_cnt = bank->filter_cnt;
 
 	/* Check id device is connectable. */
 	scan_control.connectable =
@@ -1495,12 +2041,11 @@ static void scan_recv(const struct bt_le_scan_recv_info *info,
 	/* Check the address filter. */
 	check_addr(&scan_control, info->addr);
 
-	/* Save advertising buffer state to transfer it
-	 * data to application if futher processing is needed.
-	 */
-	net_buf_simple_save(ad, &state);
-	bt_data_parse(ad, adv_data_found, (void *)&scan_control);
-	net_buf_simple_restore(ad, &state);
+	adv_data_match(&scan_control, ad);
+
+	/* The filters may be changed from the callbacks. */
+	filter_bank_release(bank);
+	scan_control.bank = NULL;
 
 	scan_control.device_info.recv_info = info;
 	scan_control.device_info.conn_param = &bt_scan.conn_param;
@@ -1590,12 +2135,17 @@ int bt_scan_blocklist_device_add(const bt_addr_le_t *addr)
 		bt_addr_le_copy(&bt_scan.blocklist.addr[bt_scan.blocklist.count],
 				addr);
 		bt_scan.blocklist.count++;
+		filters_changed();
 		LOG_INF("Device %s added to the scanning blocklist", addr_str);
 	}
 
 out:
 	k_mutex_unlock(&scan_mutex);
 
+	if (!err) {
+		filters_compile();
+	}
+
 	return err;
 }
 
@@ -1603,7 +2153,10 @@ void bt_scan_blocklist_clear(void)
 {
 	k_mutex_lock(&scan_mutex, K_FOREVER);
 	memset(&bt_scan.blocklist, 0, sizeof(bt_scan.blocklist));
+	filters_changed();
 	k_mutex_unlock(&scan_mutex);
+
+	filters_compile();
 }
 #endif /* CONFIG_BT_SCAN_BLOCKLIST */
 
@@ -54,23 +54,30 @@ static int verify_truncated_hash(const uint8_t *data, uint32_t data_len,
 	return 0;
 }
 
-static int verify_signature(const uint8_t *data, uint32_t data_len,
-		const uint8_t *signature, const uint8_t *public_key, bool external)
+static int verify_signature_hash(const uint8_t *data_hash, const uint8_t *signature,
+		const uint8_t *public_key, bool external)
 {
-	uint8_t hash1[CONFIG_SB_HASH_LEN];
 	uint8_t hash2[CONFIG_SB_HASH_LEN];
 
-	int retval = get_hash(hash1, data, data_len, external);
+	int retval = get_hash(hash2, data_hash, CONFIG_SB_HASH_LEN, external);
 	if (retval != 0) {
 		return retval;
 	}
 
-	retval = get_hash(hash2, hash1, CONFIG_SB_HASH_LEN, external);
+	return bl_secp256r1_validate(hash2, CONFIG_SB_HASH_LEN, public_key, signature);
+}
+
+static int verify_signature(const uint8_t *data, uint32_t data_len,
+		const uint8_t *signature, const uint8_t *public_key, bool external)
+{
+	uint8_t hash1[CONFIG_SB_HASH_LEN];
+
+	int retval = get_hash(hash1, data, data_len, external);
 	if (retval != 0) {
 		return retval;
 	}
 
-	return bl_secp256r1_validate(hash2, CONFIG_SB_HASH_LEN, public_key, signature);
+	return verify_signature_hash(hash1, signature, public_key, external);
 }
 
 /* Base implementation, with 'external' parameter. */
@@ -91,6 +98,47 @@ static int root_of_trust_verify(
 	return verify_signature(firmware, firmware_len, signature, public_key,
 			external);
 }
+
+/* Base implementation of the variant taking the firmware hash. */
+static int root_of_trust_verify_hash(
+		const uint8_t *public_key, const uint8_t *public_key_hash,
+		const uint8_t *signature, const uint8_t *firmware_hash,
+		bool external)
+{
+	__ASSERT(public_key && public_key_hash && signature && firmware_hash,
+			"A parameter was NULL.");
+	int retval = verify_truncated_hash(public_key, CONFIG_SB_PUBLIC_KEY_LEN,
+			public_key_hash, CONFIG_SB_PUBLIC_KEY_HASH_LEN, external);
+
+	if (retval != 0) {
+		return retval;
+	}
+
+	return verify_signature_hash(firmware_hash, signature, public_key,
+			external);
+}
+
+
+/* For use by the bootloader. */
+int bl_root_of_trust_verify_hash(const uint8_t *public_key,
+				 const uint8_t *public_key_hash,
+				 const uint8_t *signature,
+				 const uint8_t *firmware_hash)
+{
+	return root_of_trust_verify_hash(public_key, public_key_hash, signature,
+					firmware_hash, false);
+}
+
+
+/* For use in functions called through EXT_API. */
+int bl_root_of_trust_verify_hash_external(const uint8_t *public_key,
+					  const uint8_t *public_key_hash,
+					  const uint8_t *signature,
+					  const uint8_t *firmware_hash)
+{
+	return root_of_trust_verify_hash(public_key, public_key_hash, signature,
+					firmware_hash, true);
+}
 #endif
 
 
@@ -65,6 +65,7 @@ bool bl_validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address)
 #include <zephyr/sys/printk.h>
 #include <zephyr/toolchain.h>
 #include <bl_crypto.h>
+#include <ocrypto_constant_time.h>
 #include "bl_validation_internal.h"
 
 #if USE_PARTITION_MANAGER
@@ -144,9 +145,10 @@ validation_info_find(uint32_t start_address, uint32_t search_distance)
 }
 
 #ifdef CONFIG_SB_VALIDATE_FW_SIGNATURE
+/* If fw_hash is not NULL, it is used instead of hashing the firmware. */
 static bool validate_signature(const uint32_t fw_src_address, const uint32_t fw_size,
 			       const struct fw_validation_info *fw_val_info,
-			       bool external)
+			       const uint8_t *fw_hash, bool external)
 {
 	int init_retval = bl_crypto_init();
 
@@ -168,6 +170,9 @@ static bool validate_signature(const uint32_t fw_src_address, const uint32_t fw_
 	bl_root_of_trust_verify_t rot_verify = external ?
 					bl_root_of_trust_verify_external :
 					bl_root_of_trust_verify;
+	bl_root_of_trust_verify_hash_t rot_verify_hash = external ?
+					bl_root_of_trust_verify_hash_external :
+					bl_root_of_trust_verify_hash;
 	/* Some key data storage backends require word sized reads, hence
 	 * we need to ensure word alignment for 'key_data'
 	 */
@@ -192,11 +197,20 @@ static bool validate_signature(const uint32_t fw_src_address, const uint32_t fw_
 		PRINT("Verifying signature against key %d.\n\r", key_data_idx);
 		PRINT("Hash: 0x%02x...%02x\r\n", key_data[0],
 			key_data[CONFIG_SB_PUBLIC_KEY_HASH_LEN-1]);
-		int retval = rot_verify(fw_val_info->public_key,
+		int retval;
+
+		if (fw_hash) {
+			retval = rot_verify_hash(fw_val_info->public_key,
+						key_data,
+						fw_val_info->signature,
+						fw_hash);
+		} else {
+			retval = rot_verify(fw_val_info->public_key,
 					key_data,
 					fw_val_info->signature,
 					(const uint8_t *)fw_src_address,
 					fw_size);
+		}
 
 		if (retval == 0) {
 			for (uint32_t i = 0; i < key_data_idx; i++) {
@@ -221,9 +235,10 @@ static bool validate_signature(const uint32_t fw_src_address, const uint32_t fw_
 
 
 #elif defined(CONFIG_SB_VALIDATE_FW_HASH)
+/* If fw_hash is not NULL, it is used instead of hashing the firmware. */
 static bool validate_hash(const uint32_t fw_src_address, const uint32_t fw_size,
 			  const struct fw_validation_info *fw_val_info,
-			  bool external)
+			  const uint8_t *fw_hash, bool external)
 {
 	int retval = bl_crypto_init();
 
@@ -232,8 +247,13 @@ static bool validate_hash(const uint32_t fw_src_address, const uint32_t fw_size,
 		return false;
 	}
 
-	retval = bl_sha256_verify((const uint8_t *)fw_src_address, fw_size,
-			fw_val_info->hash);
+	if (fw_hash) {
+		retval = ocrypto_constant_time_equal(fw_hash, fw_val_info->hash,
+				CONFIG_SB_HASH_LEN) ? 0 : -EHASHINV;
+	} else {
+		retval = bl_sha256_verify((const uint8_t *)fw_src_address,
+				fw_size, fw_val_info->hash);
+	}
 
 	if (retval != 0) {
 		PRINT("Firmware validation failed with error %d.\n\r",
@@ -249,7 +269,8 @@ static bool validate_hash(const uint32_t fw_src_address, const uint32_t fw_size,
 
 
 static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
-			      const struct fw_info *fwinfo, bool external)
+			      const struct fw_info *fwinfo,
+			      const uint8_t *fw_hash, bool external)
 {
 	const struct fw_validation_info *fw_val_info;
 	const uint32_t fwinfo_address = (uint32_t)fwinfo;
@@ -340,10 +361,10 @@ static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
 
 #ifdef CONFIG_SB_VALIDATE_FW_SIGNATURE
 	return validate_signature(fw_src_address, fwinfo->size, fw_val_info,
-				external);
+				fw_hash, external);
 #elif defined(CONFIG_SB_VALIDATE_FW_HASH)
 	return validate_hash(fw_src_address, fwinfo->size, fw_val_info,
-				external);
+				fw_hash, external);
 #else
 	#error "Validation not specified."
 #endif
@@ -353,13 +374,88 @@ static bool validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address,
 bool bl_validate_firmware(uint32_t fw_dst_address, uint32_t fw_src_address)
 {
 	return validate_firmware(fw_dst_address, fw_src_address,
-				fw_info_find(fw_src_address), true);
+				fw_info_find(fw_src_address), NULL, true);
 }
 
 
 bool bl_validate_firmware_local(uint32_t fw_address, const struct fw_info *fwinfo)
 {
-	return validate_firmware(fw_address, fw_address, fwinfo, false);
+	return validate_firmware(fw_address, fw_address, fwinfo, NULL, false);
+}
+
+
+int bl_validate_firmware_stream_init(struct bl_validate_fw_stream *stream,
+				     uint32_t fw_address, uint32_t fw_size)
+{
+	if (!stream || (fw_size == 0)) {
+		return -EINVAL;
+	}
+
+	int retval = bl_crypto_init();
+
+	if (retval) {
+		return retval;
+	}
+
+	stream->fw_address = fw_address;
+	stream->fw_size = fw_size;
+	stream->hashed = 0;
+
+	return bl_sha256_init(&stream->ctx);
+}
+
+
+int bl_validate_firmware_stream_update(struct bl_validate_fw_stream *stream,
+				       const uint8_t *data, uint32_t len)
+{
+	uint32_t remaining = stream->fw_size - stream->hashed;
+
+	if (len > remaining) {
+		len = remaining;
+	}
+
+	if (len == 0) {
+		return 0;
+	}
+
+	int retval = bl_sha256_update(&stream->ctx, data, len);
+
+	if (retval) {
+		return retval;
+	}
+
+	stream->hashed += len;
+	return 0;
+}
+
+
+bool bl_validate_firmware_stream_finish(struct bl_validate_fw_stream *stream)
+{
+	const bool external = false;
+	const struct fw_info *fwinfo = fw_info_find(stream->fw_address);
+	uint8_t fw_hash[CONFIG_SB_HASH_LEN];
+
+	if (!fwinfo) {
+		PRINT("Could not find firmware info.\n\r");
+		return false;
+	}
+
+	if ((stream->hashed != stream->fw_size)
+		|| (fwinfo->size != stream->fw_size)) {
+		PRINT("Streamed %u bytes, firmware size is %u.\n\r",
+			stream->hashed, fwinfo->size);
+		return false;
+	}
+
+	int retval = bl_sha256_finalize(&stream->ctx, fw_hash);
+
+	if (retval) {
+		PRINT("bl_sha256_finalize() returned %d.\n\r", retval);
+		return false;
+	}
+
+	return validate_firmware(stream->fw_address, stream->fw_address,
+				fwinfo, fw_hash, external);
 }
 #endif
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <zephyr/kernel.h>
 #include <zephyr/drivers/flash.h>
 #include <zephyr/logging/log.h>
 #include <dfu/fmfu_fdev.h>
@@ -12,11 +13,19 @@
 #include <stdio.h>
 #include <modem_update_decode.h>
 
+#ifdef CONFIG_FMFU_FDEV_SAVE_PROGRESS
+#define MODULE "fmfu"
+#define PROGRESS_KEY "progress"
+#include <zephyr/settings/settings.h>
+#endif /* CONFIG_FMFU_FDEV_SAVE_PROGRESS */
+
 LOG_MODULE_REGISTER(fmfu_fdev, CONFIG_FMFU_FDEV_LOG_LEVEL);
 
 /* The size of the cbor metadata structure will not exceed this value. */
 #define MAX_META_LEN 1024
 
+#define HASH_LEN 32
+
 static uint8_t meta_buf[MAX_META_LEN];
 
 static int get_hash_from_flash(const struct device *fdev, size_t offset,
@@ -78,36 +87,352 @@ static int write_chunk(uint8_t *buf, size_t buf_len, uint32_t address,
 	return 0;
 }
 
-static int load_segment(const struct device *fdev, size_t seg_size,
-			uint32_t seg_target_addr, uint32_t seg_offset,
-			uint8_t *buf, size_t buf_len, bool is_bootloader)
+/* Reads the blob from the flash device one chunk at a time. A chunk never
+ * spans two segments.
+ */
+struct blob_reader {
+	const struct device *fdev;
+	const struct Segments *seg;
+	/* Firmware segments before this one were written before a reset. They
+	 * are not written again, only hashed if hash on read is enabled.
+	 */
+	int first_seg;
+	/* Segment and offset within it of the next chunk. */
+	int seg_idx;
+	size_t seg_offs;
+	/* Flash offset of the current segment. */
+	size_t seg_start;
+#ifdef CONFIG_FMFU_FDEV_HASH_ON_READ
+	mbedtls_sha256_context sha256_ctx;
+#endif
+};
+
+struct chunk {
+	uint8_t *buf;
+	size_t len;
+	int err;
+};
+
+static bool segment_skipped(const struct blob_reader *reader, int seg_idx)
+{
+	/* The bootloader is never skipped, as it is lost on reset. */
+	return seg_idx != 0 && seg_idx < reader->first_seg;
+}
+
+static int read_chunk(struct blob_reader *reader, uint8_t *buf, size_t buf_len,
+		      size_t *len)
 {
+	const struct Segments *seg = reader->seg;
 	int err;
-	uint32_t read_addr = seg_offset;
-	size_t bytes_left = seg_size;
 
-	while (bytes_left) {
-		uint32_t read_len = MIN(buf_len, bytes_left);
+	while (reader->seg_idx < seg->_Segments__Segment_count) {
+		size_t seg_len =
+			seg->_Segments__Segment[reader->seg_idx]._Segment_len;
+		size_t part_len = MIN(buf_len, seg_len - reader->seg_offs);
+		bool skip = segment_skipped(reader, reader->seg_idx);
+
+		if (part_len == 0) {
+			reader->seg_start += seg_len;
+			reader->seg_offs = 0;
+			reader->seg_idx++;
+			continue;
+		}
+
+		if (skip && !IS_ENABLED(CONFIG_FMFU_FDEV_HASH_ON_READ)) {
+			reader->seg_offs = seg_len;
+			continue;
+		}
 
-		err = flash_read(fdev, read_addr, buf, read_len);
+		err = flash_read(reader->fdev,
+				 reader->seg_start + reader->seg_offs, buf,
+				 part_len);
 		if (err != 0) {
 			LOG_ERR("flash_read failed: %d", err);
 			return err;
 		}
 
-		err = write_chunk(buf, read_len, seg_target_addr,
+#ifdef CONFIG_FMFU_FDEV_HASH_ON_READ
+		err = mbedtls_sha256_update(&reader->sha256_ctx, buf, part_len);
+		if (err != 0) {
+			LOG_ERR("mbedtls_sha256_update failed: %d", err);
+			return err;
+		}
+#endif
+		reader->seg_offs += part_len;
+
+		if (!skip) {
+			*len = part_len;
+			return 0;
+		}
+	}
+
+	*len = 0;
+	return 0;
+}
+
+/* Hands the chunks from the reader to the modem writer. With the pipeline
+ * enabled, the buffer is split in two and a reader thread fills one half
+ * while the other is written to the modem.
+ */
+struct loader {
+	struct blob_reader reader;
+	uint8_t *buf;
+	size_t buf_len;
+#ifdef CONFIG_FMFU_FDEV_PIPELINE
+	int next;
+#else
+	struct chunk chunk;
+#endif
+};
+
+#ifdef CONFIG_FMFU_FDEV_PIPELINE
+static K_THREAD_STACK_DEFINE(reader_stack,
+			     CONFIG_FMFU_FDEV_PIPELINE_STACK_SIZE);
+static struct k_thread reader_thread;
+static K_SEM_DEFINE(chunk_free, 0, 2);
+static K_SEM_DEFINE(chunk_ready, 0, 2);
+static struct chunk chunks[2];
+static atomic_t reader_stop;
+
+static void reader_thread_fn(void *p1, void *p2, void *p3)
+{
+	struct loader *loader = p1;
+	size_t half_len = loader->buf_len / 2;
+
+	for (int i = 0; ; i = !i) {
+		struct chunk *chunk = &chunks[i];
+
+		k_sem_take(&chunk_free, K_FOREVER);
+		if (atomic_get(&reader_stop)) {
+			return;
+		}
+
+		chunk->buf = loader->buf + i * half_len;
+		chunk->err = read_chunk(&loader->reader, chunk->buf, half_len,
+					&chunk->len);
+		k_sem_give(&chunk_ready);
+
+		if (chunk->err != 0 || chunk->len == 0) {
+			return;
+		}
+	}
+}
+
+static int loader_start(struct loader *loader)
+{
+	if (loader->buf_len < 2) {
+		LOG_ERR("Buffer too small to be split");
+		return -EINVAL;
+	}
+
+	k_sem_reset(&chunk_free);
+	k_sem_reset(&chunk_ready);
+	k_sem_give(&chunk_free);
+	k_sem_give(&chunk_free);
+	atomic_clear(&reader_stop);
+	loader->next = 0;
+
+	k_thread_create(&reader_thread, reader_stack,
+			K_THREAD_STACK_SIZEOF(reader_stack), reader_thread_fn,
+			loader, NULL, NULL,
+			CONFIG_FMFU_FDEV_PIPELINE_THREAD_PRIO, 0, K_NO_WAIT);
+	k_thread_name_set(&reader_thread, "fmfu_fdev_reader");
+
+	return 0;
+}
+
+static void loader_stop(struct loader *loader)
+{
+	/* Wake up the reader if it is waiting for a free buffer. */
+	atomic_set(&reader_stop, 1);
+	k_sem_give(&chunk_free);
+	k_thread_join(&reader_thread, K_FOREVER);
+}
+
+static struct chunk *chunk_get(struct loader *loader)
+{
+	k_sem_take(&chunk_ready, K_FOREVER);
+
+	return &chunks[loader->next];
+}
+
+static void chunk_put(struct loader *loader)
+{
+	loader->next = !loader->next;
+	k_sem_give(&chunk_free);
+}
+#else
+static int loader_start(struct loader *loader)
+{
+	return 0;
+}
+
+static void loader_stop(struct loader *loader)
+{
+}
+
+static struct chunk *chunk_get(struct loader *loader)
+{
+	struct chunk *chunk = &loader->chunk;
+
+	chunk->buf = loader->buf;
+	chunk->err = read_chunk(&loader->reader, chunk->buf, loader->buf_len,
+				&chunk->len);
+
+	return chunk;
+}
+
+static void chunk_put(struct loader *loader)
+{
+}
+#endif /* CONFIG_FMFU_FDEV_PIPELINE */
+
+#ifdef CONFIG_FMFU_FDEV_SAVE_PROGRESS
+struct progress {
+	/* Hash of the blob that is being loaded. */
+	uint8_t blob_hash[HASH_LEN];
+	/* Index of the next firmware segment to write. */
+	uint32_t next_seg;
+};
+
+static struct progress progress;
+
+/**
+ * @brief Function used by settings_load() to restore the progress.
+ *	  See the Zephyr documentation of the settings subsystem for more
+ *	  information.
+ */
+static int settings_set(const char *key, size_t len_rd,
+			settings_read_cb read_cb, void *cb_arg)
+{
+	if (!strcmp(key, PROGRESS_KEY)) {
+		ssize_t len = read_cb(cb_arg, &progress, sizeof(progress));
+
+		if (len != sizeof(progress)) {
+			LOG_ERR("Can't read progress from storage");
+			memset(&progress, 0, sizeof(progress));
+			return len;
+		}
+	}
+
+	return 0;
+}
+
+/* Returns the index of the first firmware segment to write. */
+static int progress_load(const uint8_t *blob_hash,
+			 const struct Segments *seg)
+{
+	static struct settings_handler sh = {
+		.name = MODULE,
+		.h_set = settings_set,
+	};
+	int err;
+
+	memset(&progress, 0, sizeof(progress));
+
+	/* settings_subsys_init is idempotent so this is safe to do. */
+	err = settings_subsys_init();
+	if (err) {
+		LOG_ERR("settings_subsys_init failed (err %d)", err);
+		return err;
+	}
+
+	err = settings_register(&sh);
+	if (err && err != -EEXIST) {
+		LOG_ERR("setting_register failed: (err %d)", err);
+		return err;
+	}
+
+	err = settings_load();
+	if (err) {
+		LOG_ERR("settings_load failed (err %d)", err);
+		return err;
+	}
+
+	if (memcmp(progress.blob_hash, blob_hash, HASH_LEN) != 0 ||
+	    progress.next_seg <= 1 ||
+	    progress.next_seg > seg->_Segments__Segment_count) {
+		return 1;
+	}
+
+	LOG_INF("Resuming at segment %d/%d", progress.next_seg + 1,
+		seg->_Segments__Segment_count);
+
+	return progress.next_seg;
+}
+
+static void progress_store(const uint8_t *blob_hash, uint32_t next_seg)
+{
+	int err;
+
+	memcpy(progress.blob_hash, blob_hash, HASH_LEN);
+	progress.next_seg = next_seg;
+
+	err = settings_save_one(MODULE "/" PROGRESS_KEY, &progress,
+				sizeof(progress));
+	if (err) {
+		/* Failing to store progress is not a critical error, you'll
+		 * just be left to write a bit more if you fail and resume.
+		 */
+		LOG_WRN("Unable to store write progress: %d", err);
+	}
+}
+
+static void progress_clear(void)
+{
+	int err = settings_delete(MODULE "/" PROGRESS_KEY);
+
+	if (err) {
+		LOG_ERR("setting_delete error %d", err);
+	}
+}
+#else
+static int progress_load(const uint8_t *blob_hash,
+			 const struct Segments *seg)
+{
+	return 1;
+}
+
+static void progress_store(const uint8_t *blob_hash, uint32_t next_seg)
+{
+}
+
+static void progress_clear(void)
+{
+}
+#endif /* CONFIG_FMFU_FDEV_SAVE_PROGRESS */
+
+static int load_segment(struct loader *loader, size_t seg_size,
+			uint32_t seg_target_addr, bool is_bootloader)
+{
+	int err;
+	size_t bytes_left = seg_size;
+
+	while (bytes_left) {
+		struct chunk *chunk = chunk_get(loader);
+
+		if (chunk->err != 0) {
+			return chunk->err;
+		}
+
+		if (chunk->len == 0 || chunk->len > bytes_left) {
+			LOG_ERR("Unexpected chunk size 0x%x", chunk->len);
+			return -EINVAL;
+		}
+
+		err = write_chunk(chunk->buf, chunk->len, seg_target_addr,
 				  is_bootloader);
 		if (err != 0) {
 			LOG_ERR("write_chunk failed: %d", err);
 			return err;
 		}
 
-		LOG_DBG("Wrote chunk: offset 0x%x target addr 0x%x size 0x%x",
-			read_addr, seg_target_addr, read_len);
+		LOG_DBG("Wrote chunk: target addr 0x%x size 0x%x",
+			seg_target_addr, chunk->len);
 
-		seg_target_addr += read_len;
-		bytes_left -= read_len;
-		read_addr += read_len;
+		seg_target_addr += chunk->len;
+		bytes_left -= chunk->len;
+		chunk_put(loader);
 	}
 
 	if (is_bootloader) {
@@ -124,26 +449,27 @@ static int load_segment(const struct device *fdev, size_t seg_size,
 	return 0;
 }
 
-static int load_segments(const struct device *fdev, uint8_t *meta_buf,
-			 size_t wrapper_len, const struct Segments *seg,
-			 size_t blob_offset, uint8_t *buf, size_t buf_len)
+static int write_segments(struct loader *loader, uint8_t *meta_buf,
+			  size_t wrapper_len, const struct Segments *seg,
+			  const uint8_t *expected_hash)
 {
 	int err;
-	size_t prev_segments_len = 0;
 
 	for (int i = 0; i < seg->_Segments__Segment_count; i++) {
 		size_t seg_size = seg->_Segments__Segment[i]._Segment_len;
 		uint32_t seg_addr =
 			seg->_Segments__Segment[i]._Segment_target_addr;
-		uint32_t read_addr = blob_offset + prev_segments_len;
 		bool is_bootloader = i == 0;
 
+		if (segment_skipped(&loader->reader, i)) {
+			continue;
+		}
+
 		LOG_INF("Writing segment %d/%d, Target addr: 0x%x, size: 0%x",
 			i + 1, seg->_Segments__Segment_count, seg_addr,
 			seg_size);
 
-		err = load_segment(fdev, seg_size, seg_addr, read_addr, buf,
-				   buf_len, is_bootloader);
+		err = load_segment(loader, seg_size, seg_addr, is_bootloader);
 		if (err != 0) {
 			LOG_ERR("load_segment failed: %d", err);
 			return err;
@@ -165,16 +491,83 @@ static int load_segments(const struct device *fdev, uint8_t *meta_buf,
 			LOG_WRN("[WARNING] Skipping prevalidation, this "
 				"should only be done during development");
 #endif /* CONFIG_FMFU_FDEV_SKIP_PREVALIDATION */
+		} else {
+			progress_store(expected_hash, i + 1);
 		}
-		prev_segments_len += seg_size;
 	}
 
+	return 0;
+}
+
+static int load_segments(const struct device *fdev, uint8_t *meta_buf,
+			 size_t wrapper_len, const struct Segments *seg,
+			 size_t blob_offset, const uint8_t *expected_hash,
+			 uint8_t *buf, size_t buf_len)
+{
+	struct loader loader = {
+		.reader = {
+			.fdev = fdev,
+			.seg = seg,
+			.seg_start = blob_offset,
+		},
+		.buf = buf,
+		.buf_len = buf_len,
+	};
+	int err;
+
+	err = progress_load(expected_hash, seg);
+	if (err < 0) {
+		return err;
+	}
+	loader.reader.first_seg = err;
+
+#ifdef CONFIG_FMFU_FDEV_HASH_ON_READ
+	uint8_t hash[HASH_LEN];
+
+	mbedtls_sha256_init(&loader.reader.sha256_ctx);
+
+	err = mbedtls_sha256_starts(&loader.reader.sha256_ctx, false);
+	if (err != 0) {
+		return err;
+	}
+#endif
+
+	err = loader_start(&loader);
+	if (err != 0) {
+		return err;
+	}
+
+	err = write_segments(&loader, meta_buf, wrapper_len, seg,
+			     expected_hash);
+	loader_stop(&loader);
+	if (err != 0) {
+		return err;
+	}
+
+#ifdef CONFIG_FMFU_FDEV_HASH_ON_READ
+	err = mbedtls_sha256_finish(&loader.reader.sha256_ctx, hash);
+	if (err != 0) {
+		return err;
+	}
+
+	/* The blob was hashed before the bootloader was applied. The chunks
+	 * that have been written are hashed again, so that the firmware is
+	 * not applied if the flash device changed in between.
+	 */
+	if (memcmp(expected_hash, hash, sizeof(hash)) != 0) {
+		LOG_ERR("Blob changed while it was written");
+		progress_clear();
+		return -EINVAL;
+	}
+#endif
+
 	err = nrf_modem_full_dfu_apply();
 	if (err != 0) {
 		LOG_ERR("nrf_..._full_dfu_apply (fw) failed, err: %d", err);
 		return err;
 	}
 
+	progress_clear();
 	LOG_INF("FMFU finished");
 
 	return 0;
@@ -185,14 +578,10 @@ int fmfu_fdev_load(uint8_t *buf, size_t buf_len, const struct device *fdev,
 {
 	const struct zcbor_string *segments_string;
 	struct COSE_Sign1_Manifest wrapper;
-	bool hash_len_valid = false;
-	uint8_t expected_hash[32];
-	bool hash_valid = false;
+	uint8_t expected_hash[HASH_LEN];
 	struct Segments segments;
 	size_t blob_offset;
 	size_t wrapper_len;
-	uint8_t hash[32];
-	size_t blob_len;
 	int err;
 
 	if (buf == NULL || fdev == NULL) {
@@ -240,38 +629,35 @@ int fmfu_fdev_load(uint8_t *buf, size_t buf_len, const struct device *fdev,
 		       .value,
 	       sizeof(expected_hash));
 
-	/* Calculate total length of all segments */
-	blob_len = 0;
-	for (int i = 0; i < segments._Segments__Segment_count; i++) {
-		blob_len += segments._Segments__Segment[i]._Segment_len;
-	}
-
-	if (sizeof(hash) ==
+	if (sizeof(expected_hash) !=
 	    wrapper._COSE_Sign1_Manifest_payload_cbor._Manifest_blob_hash.len) {
-		hash_len_valid = true;
-	} else {
 		LOG_ERR("Invalid hash length");
 		return -EINVAL;
 	}
 
+	/* The whole blob is hashed before anything is written, as the
+	 * bootloader must be applied before the firmware can be written.
+	 */
+	uint8_t hash[HASH_LEN];
+	size_t blob_len = 0;
+
+	/* Calculate total length of all segments */
+	for (int i = 0; i < segments._Segments__Segment_count; i++) {
+		blob_len += segments._Segments__Segment[i]._Segment_len;
+	}
+
 	err = get_hash_from_flash(fdev, blob_offset, blob_len, hash, buf,
 				  buf_len);
 	if (err != 0) {
 		return err;
 	}
 
-	if (memcmp(expected_hash, hash, sizeof(hash)) == 0) {
-		hash_valid = true;
-	} else {
+	if (memcmp(expected_hash, hash, sizeof(hash)) != 0) {
 		LOG_ERR("Invalid hash");
 		return -EINVAL;
 	}
 
-	if (hash_len_valid && hash_valid) {
-		return load_segments(fdev, meta_buf, wrapper_len,
-				     (const struct Segments *)&segments,
-				     blob_offset, buf, buf_len);
-	} else {
-		return -EINVAL;
-	}
+	return load_segments(fdev, meta_buf, wrapper_len,
+			     (const struct Segments *)&segments, blob_offset,
+			     expected_hash, buf, buf_len);
 }
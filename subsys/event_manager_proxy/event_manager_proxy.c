@@ -31,6 +31,7 @@ extern struct event_type *_event_manager_proxy_array_list_end[];
 enum emp_cmd_code {
 	EMP_CMD_SUBSCRIBE,
 	EMP_CMD_START,
+	EMP_CMD_SUBSCRIBE_BULK,
 	EMP_CMD_COUNT,
 	EMP_CMD_FORCE_INT_SIZE = INT_MAX
 };
@@ -51,6 +52,48 @@ struct emp_cmd_subscribe {
 	char name[];
 };
 
+#if IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCH)
+/**
+ * @brief The header of a single event in the batch.
+ */
+struct emp_batch_record {
+	uint32_t len;
+	uint32_t data[];
+};
+
+/** @brief Events waiting to be sent to the remote in a single IPC message. */
+struct emp_batch {
+	struct k_mutex lock;
+	struct k_work_delayable flush_work;
+	size_t len;
+	/* Number of events in the buffer. */
+	size_t event_cnt;
+	/* Number of events dropped because the batch could not be sent. */
+	size_t dropped_cnt;
+	uint32_t buf[ceiling_fraction(CONFIG_EVENT_MANAGER_PROXY_BATCH_BUF_SIZE, sizeof(uint32_t))];
+};
+#endif
+
+/**
+ * @brief The single subscription in the bulk subscribe command.
+ */
+struct emp_subscribe_record {
+	const struct event_type *id;
+	char name[];
+};
+
+/**
+ * @brief The command structure used to subscribe for multiple events.
+ *
+ * The command is followed by @ref emp_subscribe_record entries,
+ * each one aligned to the 4-byte boundary.
+ */
+struct emp_cmd_subscribe_bulk {
+	enum emp_cmd_code code;
+	uint32_t cnt;
+	uint32_t data[];
+};
+
 /** @brief Inter-core communication data. */
 struct emp_ipc_data {
 	struct ipc_ept ept;
@@ -59,6 +102,9 @@ struct emp_ipc_data {
 	bool started;
 	struct k_event bound;
 	const struct event_type **event_type_map;
+#if IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCH)
+	struct emp_batch batch;
+#endif
 };
 
 
@@ -92,25 +138,6 @@ static struct emp_ipc_data *find_ipc_by_instance(const struct device *instance)
 	return NULL;
 }
 
-/**
- * @brief Find event type by name.
- *
- * @param name The name of the event.
- *
- * @retval NULL    Cannot find event.
- * @retval pointer Pointer to the event type structure.
- */
-static struct event_type *find_event_by_name(const char *name)
-{
-	STRUCT_SECTION_FOREACH(event_type, et) {
-		if (!strcmp(et->name, name)) {
-			return et;
-		}
-	}
-
-	return NULL;
-}
-
 /**
  * @brief Get event type position index on the event type array.
  *
@@ -151,7 +178,7 @@ static void handle_ipc_endpoint_bound(void *priv)
 	k_event_set(&ipc->bound, 0x1);
 }
 
-static void handle_remote_event(struct emp_ipc_data *ipc, const void *data, size_t len)
+static void submit_remote_event(const void *data, size_t len)
 {
 	void *event = app_event_manager_alloc(len);
 
@@ -159,6 +186,55 @@ static void handle_remote_event(struct emp_ipc_data *ipc, const void *data, size
 	_event_submit(event);
 }
 
+static void handle_remote_batch(struct emp_ipc_data *ipc, const void *data, size_t len)
+{
+#if IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCH)
+	const uint8_t *pos = data;
+	const uint8_t *end = pos + len;
+
+	while (pos < end) {
+		const struct emp_batch_record *rec = (const struct emp_batch_record *)pos;
+		size_t remaining = end - pos;
+
+		if ((remaining < sizeof(*rec)) ||
+		    ((remaining - sizeof(*rec)) < rec->len)) {
+			LOG_ERR("Malformed event batch from ipc %zu", ipc2idx(ipc));
+			__ASSERT_NO_MSG(false);
+			return;
+		}
+
+		submit_remote_event(rec->data, rec->len);
+		pos += sizeof(*rec) + ROUND_UP(rec->len, sizeof(uint32_t));
+	}
+#endif
+}
+
+static void handle_remote_event(struct emp_ipc_data *ipc, const void *data, size_t len)
+{
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCH)) {
+		handle_remote_batch(ipc, data, len);
+	} else {
+		submit_remote_event(data, len);
+	}
+}
+
+static void register_remote_subscription(struct emp_ipc_data *ipc,
+					 const struct event_type *remote_id,
+					 const char *name)
+{
+	const struct event_type *et = app_event_manager_event_type_find(name);
+
+	if (!et) {
+		LOG_ERR("Cannot register event: %s", name);
+	} else {
+		size_t ctx_idx = ipc2idx(ipc);
+		size_t et_idx = et2idx(et);
+
+		ipc->event_type_map[et_idx] = remote_id;
+		LOG_DBG("Remote event %s registered on ipc %zu", name, ctx_idx);
+	}
+}
+
 static void handle_remote_command_subscribe(struct emp_ipc_data *ipc, const void *data, size_t len)
 {
 	if (ipc->started) {
@@ -176,16 +252,49 @@ static void handle_remote_command_subscribe(struct emp_ipc_data *ipc, const void
 		return;
 	}
 
-	struct event_type *et = find_event_by_name(cmd->name);
+	register_remote_subscription(ipc, cmd->id, cmd->name);
+}
 
-	if (!et) {
-		LOG_ERR("Cannot register event: %s", cmd->name);
-	} else {
-		size_t ctx_idx = ipc2idx(ipc);
-		size_t et_idx = et2idx(et);
+static void handle_remote_command_subscribe_bulk(struct emp_ipc_data *ipc,
+						 const void *data, size_t len)
+{
+	if (ipc->started) {
+		/* Reject if started. */
+		__ASSERT_NO_MSG(false);
+		return;
+	}
 
-		ipc->event_type_map[et_idx] = cmd->id;
-		LOG_DBG("Remote event %s registered on ipc %zu", cmd->name, ctx_idx);
+	const struct emp_cmd_subscribe_bulk *cmd = data;
+
+	if (len < sizeof(*cmd)) {
+		LOG_ERR("Unexpected command size: %zu", len);
+		__ASSERT_NO_MSG(false);
+		return;
+	}
+
+	const uint8_t *pos = (const uint8_t *)cmd->data;
+	const uint8_t *end = (const uint8_t *)data + len;
+
+	for (uint32_t i = 0; i < cmd->cnt; i++) {
+		const struct emp_subscribe_record *rec = (const struct emp_subscribe_record *)pos;
+		size_t remaining = end - pos;
+		size_t name_len;
+
+		if (remaining <= sizeof(*rec)) {
+			LOG_ERR("Unexpected command size: %zu", len);
+			__ASSERT_NO_MSG(false);
+			return;
+		}
+
+		name_len = strnlen(rec->name, remaining - sizeof(*rec));
+		if (name_len == (remaining - sizeof(*rec))) {
+			LOG_ERR("Event name not terminated");
+			__ASSERT_NO_MSG(false);
+			return;
+		}
+
+		register_remote_subscription(ipc, rec->id, rec->name);
+		pos += ROUND_UP(sizeof(*rec) + name_len + 1, sizeof(uint32_t));
 	}
 }
 
@@ -232,6 +341,10 @@ static void handle_remote_command(struct emp_ipc_data *ipc, const void *data, si
 		handle_remote_command_start(ipc, data, len);
 		break;
 
+	case EMP_CMD_SUBSCRIBE_BULK:
+		handle_remote_command_subscribe_bulk(ipc, data, len);
+		break;
+
 	default:
 		LOG_ERR("Unsupported command %u", cmd->code);
 		__ASSERT_NO_MSG(false);
@@ -274,24 +387,12 @@ static void handle_ipc_endpoint_error(const char *message, void *priv)
 	__ASSERT_NO_MSG(false);
 }
 
-static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event_header *eh)
+static int send_to_remote(struct emp_ipc_data *ipc, const void *data, size_t len)
 {
-	const struct event_type *remote_ev = ipc->event_type_map[et2idx(eh->type_id)];
 	int ret;
 
-	if (remote_ev == NULL) {
-		return 0;
-	}
-
-	size_t size = app_event_manager_event_size(eh);
-	uint32_t buffer[ceiling_fraction(size, sizeof(uint32_t))];
-	struct app_event_header *remote_eh = (struct app_event_header *)buffer;
-
-	memcpy(buffer, eh, sizeof(buffer));
-	remote_eh->type_id = remote_ev;
-
 	for (size_t cnt = CONFIG_EVENT_MANAGER_PROXY_SEND_RETRIES + 1; cnt > 0; --cnt) {
-		ret = ipc_service_send(&ipc->ept, buffer, sizeof(buffer));
+		ret = ipc_service_send(&ipc->ept, data, len);
 		if (ret >= 0) {
 			break;
 		}
@@ -305,6 +406,139 @@ static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event
 	return ret;
 }
 
+#if IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCH)
+static int batch_flush(struct emp_ipc_data *ipc)
+{
+	struct emp_batch *batch = &ipc->batch;
+
+	if (batch->len == 0) {
+		return 0;
+	}
+
+	int ret = send_to_remote(ipc, batch->buf, batch->len);
+
+	if (ret < 0) {
+		/* The events are kept in the batch and sent with the next flush. */
+		return ret;
+	}
+
+	batch->len = 0;
+	batch->event_cnt = 0;
+
+	return 0;
+}
+
+static void batch_drop(struct emp_batch *batch)
+{
+	batch->dropped_cnt += batch->event_cnt;
+	LOG_ERR("Dropped %zu events from the batch (total dropped: %zu)",
+		batch->event_cnt, batch->dropped_cnt);
+
+	batch->len = 0;
+	batch->event_cnt = 0;
+}
+
+static void batch_flush_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct emp_batch *batch = CONTAINER_OF(dwork, struct emp_batch, flush_work);
+	struct emp_ipc_data *ipc = CONTAINER_OF(batch, struct emp_ipc_data, batch);
+
+	k_mutex_lock(&batch->lock, K_FOREVER);
+	if (batch_flush(ipc)) {
+		(void)k_work_schedule(&batch->flush_work,
+				      K_MSEC(CONFIG_EVENT_MANAGER_PROXY_BATCH_FLUSH_DELAY_MS));
+	}
+	k_mutex_unlock(&batch->lock);
+}
+
+static void batch_init(struct emp_ipc_data *ipc)
+{
+	k_mutex_init(&ipc->batch.lock);
+	k_work_init_delayable(&ipc->batch.flush_work, batch_flush_work_handler);
+	ipc->batch.len = 0;
+	ipc->batch.event_cnt = 0;
+	ipc->batch.dropped_cnt = 0;
+}
+
+static int batch_append(struct emp_ipc_data *ipc, const struct app_event_header *eh,
+			const struct event_type *remote_ev, size_t size)
+{
+	struct emp_batch *batch = &ipc->batch;
+	size_t rec_size = sizeof(struct emp_batch_record) + ROUND_UP(size, sizeof(uint32_t));
+	int ret = 0;
+
+	if (rec_size > sizeof(batch->buf)) {
+		LOG_ERR("Event %s does not fit in the batch buffer", eh->type_id->name);
+		__ASSERT_NO_MSG(false);
+		return -ENOMEM;
+	}
+
+	k_mutex_lock(&batch->lock, K_FOREVER);
+
+	if ((batch->len + rec_size) > sizeof(batch->buf)) {
+		ret = batch_flush(ipc);
+		if (ret) {
+			/* There is no space for the new event. */
+			batch_drop(batch);
+		}
+	}
+
+	struct emp_batch_record *rec = (struct emp_batch_record *)((uint8_t *)batch->buf +
+								    batch->len);
+	struct app_event_header *remote_eh = (struct app_event_header *)rec->data;
+
+	rec->len = size;
+	memcpy(rec->data, eh, size);
+	remote_eh->type_id = remote_ev;
+
+	batch->len += rec_size;
+	batch->event_cnt++;
+
+	/* The flush deadline is counted from the first event in the batch. */
+	(void)k_work_schedule(&batch->flush_work,
+			      K_MSEC(CONFIG_EVENT_MANAGER_PROXY_BATCH_FLUSH_DELAY_MS));
+
+	k_mutex_unlock(&batch->lock);
+
+	return ret;
+}
+#else
+static void batch_init(struct emp_ipc_data *ipc)
+{
+}
+
+static int batch_append(struct emp_ipc_data *ipc, const struct app_event_header *eh,
+			const struct event_type *remote_ev, size_t size)
+{
+	__ASSERT_NO_MSG(false);
+	return -ENOTSUP;
+}
+#endif /* CONFIG_EVENT_MANAGER_PROXY_BATCH */
+
+static int send_event_to_remote(struct emp_ipc_data *ipc, const struct app_event_header *eh)
+{
+	const struct event_type *remote_ev = ipc->event_type_map[et2idx(eh->type_id)];
+
+	if (remote_ev == NULL) {
+		return 0;
+	}
+
+	size_t size = app_event_manager_event_size(eh);
+
+	if (IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCH)) {
+		return batch_append(ipc, eh, remote_ev, size);
+	}
+
+	uint32_t buffer[ceiling_fraction(size, sizeof(uint32_t))];
+	struct app_event_header *remote_eh = (struct app_event_header *)buffer;
+
+	memcpy(buffer, eh, sizeof(buffer));
+	remote_eh->type_id = remote_ev;
+
+	return send_to_remote(ipc, buffer, sizeof(buffer));
+}
+
 static void event_manager_proxy_on_event_process(const struct app_event_header *eh)
 {
 	int ret = 0;
@@ -354,6 +588,7 @@ static int add_ipc_instace(struct emp_ipc_data *ipc, const struct device *instan
 	memset(ipc->event_type_map, 0, event_type_count * sizeof(ipc->event_type_map[0]));
 
 	k_event_init(&ipc->bound);
+	batch_init(ipc);
 
 	ret = ipc_service_register_endpoint(instance, &ipc->ept, &ipc->ept_cfg);
 	if (ret) {
@@ -425,6 +660,67 @@ int event_manager_proxy_subscribe(const struct device *instance,
 	return send_subscribe_command_to_remote(ipc, local_event_id, remote_event_name);
 }
 
+int event_manager_proxy_subscribe_bulk(const struct device *instance,
+		const struct event_manager_proxy_subscription *subs, size_t cnt)
+{
+	__ASSERT_NO_MSG(!emp_started);
+
+	struct emp_ipc_data *ipc = find_ipc_by_instance(instance);
+	uint32_t buffer[ceiling_fraction(CONFIG_EVENT_MANAGER_PROXY_SUBSCRIBE_BULK_BUF_SIZE,
+					 sizeof(uint32_t))];
+	struct emp_cmd_subscribe_bulk *cmd = (struct emp_cmd_subscribe_bulk *)buffer;
+	size_t pos = sizeof(*cmd);
+	int ret;
+
+	__ASSERT_NO_MSG(ipc);
+
+	if (!k_event_wait(&ipc->bound, 0x1, false, EMP_BIND_TIMEOUT)) {
+		LOG_ERR("IPC bind timeout");
+		return -EPIPE;
+	}
+
+	cmd->code = EMP_CMD_SUBSCRIBE_BULK;
+	cmd->cnt = 0;
+
+	for (size_t i = 0; i < cnt; i++) {
+		size_t rec_size = ROUND_UP(sizeof(struct emp_subscribe_record) +
+					   strlen(subs[i].remote_event_name) + 1,
+					   sizeof(uint32_t));
+
+		if ((sizeof(*cmd) + rec_size) > sizeof(buffer)) {
+			LOG_ERR("Event name too long: %s", subs[i].remote_event_name);
+			return -ENOMEM;
+		}
+
+		if ((pos + rec_size) > sizeof(buffer)) {
+			ret = ipc_service_send(&ipc->ept, buffer, pos);
+			if (ret < 0) {
+				return ret;
+			}
+
+			pos = sizeof(*cmd);
+			cmd->cnt = 0;
+		}
+
+		struct emp_subscribe_record *rec =
+			(struct emp_subscribe_record *)((uint8_t *)buffer + pos);
+
+		rec->id = subs[i].local_event_id;
+		strcpy(rec->name, subs[i].remote_event_name);
+		pos += rec_size;
+		cmd->cnt++;
+	}
+
+	if (cmd->cnt > 0) {
+		ret = ipc_service_send(&ipc->ept, buffer, pos);
+		if (ret < 0) {
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
 static int send_start_command_to_remote(struct emp_ipc_data *ipc)
 {
 	const struct emp_cmd cmd = {.code = EMP_CMD_START};
@@ -478,3 +774,30 @@ int event_manager_proxy_wait_for_remotes(k_timeout_t timeout)
 
 	return 0;
 }
+
+int event_manager_proxy_flush(void)
+{
+	int ret = 0;
+
+#if IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCH)
+	for (size_t i = 0; i < ARRAY_SIZE(emp_ipc_data); ++i) {
+		struct emp_ipc_data *ipc = &emp_ipc_data[i];
+
+		if (!ipc->used || !ipc->started) {
+			continue;
+		}
+
+		k_mutex_lock(&ipc->batch.lock, K_FOREVER);
+		int err = batch_flush(ipc);
+
+		k_mutex_unlock(&ipc->batch.lock);
+
+		/* Batches of the other remotes are flushed anyway. */
+		if (err && !ret) {
+			ret = err;
+		}
+	}
+#endif
+
+	return ret;
+}
@@ -8,6 +8,7 @@
 #include <zephyr/net/coap.h>
 #include <net/download_client.h>
 #include <zephyr/logging/log.h>
+#include <limits.h>
 #include <string.h>
 
 LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
@@ -22,47 +23,111 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 extern char *strtok_r(char *str, const char *sep, char **state);
 
 int url_parse_file(const char *url, char *file, size_t len);
-int socket_send(const struct download_client *client, size_t len, int timeout);
-
-static int coap_get_current_from_response_pkt(const struct coap_packet *cpkt)
+int socket_send(int fd, const char *buf, size_t len, int timeout);
+
+int coap_request_send(struct download_client *client);
+
+#define WINDOW DOWNLOAD_CLIENT_COAP_WINDOW
+
+/* Smallest block size when adapting to packet loss */
+#define SZX_MIN COAP_BLOCK_64
+/* Blocks received without retransmission before the block size is doubled */
+#define SZX_GROW_STREAK (4 * WINDOW)
+
+enum block_state {
+	/* Slot not in use */
+	BLOCK_FREE,
+	/* Request to be sent for the first time */
+	BLOCK_NEW,
+	/* Request to be retransmitted */
+	BLOCK_RESEND,
+	/* Request sent, waiting for the response */
+	BLOCK_SENT,
+	/* Response received ahead of a previous block */
+	BLOCK_RECEIVED,
+};
+
+static size_t block_bytes(uint8_t szx)
 {
-	int block = 0;
+	return coap_block_size_to_bytes(szx);
+}
 
-	block = coap_get_option_int(cpkt, COAP_OPTION_BLOCK2);
-	if (block < 0) {
-		return block;
+static void window_reset(struct download_client *client, size_t from)
+{
+	for (size_t i = 0; i < WINDOW; i++) {
+		client->coap.block[i].state = BLOCK_FREE;
 	}
 
-	return GET_BLOCK_NUM(block) << (GET_BLOCK_SIZE(block) + 4);
+	/* Request the block containing the first byte to download */
+	client->coap.next_block = from - (from % block_bytes(client->coap.szx));
 }
 
-static bool has_pending(struct download_client *client)
+int coap_block_init(struct download_client *client, size_t from)
 {
-	return client->coap.pending.timeout > 0;
+	client->coap.szx_max = CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE;
+	client->coap.szx = CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE;
+	client->coap.streak = 0;
+
+	window_reset(client, from);
+
+	return 0;
 }
 
-int coap_block_init(struct download_client *client, size_t from)
+static void block_size_shrink(struct download_client *client)
 {
-	coap_block_transfer_init(&client->coap.block_ctx,
-				 CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE, 0);
-	client->coap.block_ctx.current = from;
-	return 0;
+	client->coap.streak = 0;
+
+	if (!IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE_ADAPTIVE) ||
+	    client->coap.szx <= MIN(SZX_MIN, client->coap.szx_max)) {
+		return;
+	}
+
+	client->coap.szx--;
+	LOG_DBG("Block size decreased to %d", block_bytes(client->coap.szx));
 }
 
-int coap_get_recv_timeout(struct download_client *dl)
+static void block_size_grow(struct download_client *client)
 {
-	int timeout;
+	if (!IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE_ADAPTIVE) ||
+	    ++client->coap.streak < SZX_GROW_STREAK) {
+		return;
+	}
 
-	if (!has_pending(dl)) {
-		LOG_ERR("Must have coap pending");
-		return -1;
+	client->coap.streak = 0;
+
+	if (client->coap.szx < client->coap.szx_max) {
+		client->coap.szx++;
+		LOG_DBG("Block size increased to %d", block_bytes(client->coap.szx));
 	}
+}
+
+int coap_get_recv_timeout(struct download_client *dl)
+{
+	int timeout = INT_MAX;
+	int remaining;
+	bool sent = false;
 
 	/* Retransmission is cycled in case recv() times out. In case sending request
 	 * blocks, the time that is used for sending request must be substracted next time
 	 * recv() is called.
 	 */
-	timeout = dl->coap.pending.t0 + dl->coap.pending.timeout - k_uptime_get_32();
+	for (size_t i = 0; i < WINDOW; i++) {
+		struct download_client_coap_block *block = &dl->coap.block[i];
+
+		if (block->state != BLOCK_SENT) {
+			continue;
+		}
+
+		remaining = block->pending.t0 + block->pending.timeout - k_uptime_get_32();
+		timeout = MIN(timeout, remaining);
+		sent = true;
+	}
+
+	if (!sent) {
+		LOG_ERR("Must have coap pending");
+		return -1;
+	}
+
 	if (timeout < 0) {
 		/* All time is spent when sending request and time this
 		 * method is called, there is no time left for receiving;
@@ -77,93 +142,149 @@ int coap_get_recv_timeout(struct download_client *dl)
 
 int coap_initiate_retransmission(struct download_client *dl)
 {
-	if (dl->coap.pending.timeout == 0) {
+	bool sent = false;
+	bool lost = false;
+
+	for (size_t i = 0; i < WINDOW; i++) {
+		struct download_client_coap_block *block = &dl->coap.block[i];
+
+		if (block->state != BLOCK_SENT) {
+			continue;
+		}
+
+		sent = true;
+
+		if ((int32_t)(block->pending.t0 + block->pending.timeout -
+			      k_uptime_get_32()) > 0) {
+			continue;
+		}
+
+		if (!coap_pending_cycle(&block->pending)) {
+			LOG_ERR("CoAP max-retransmissions exceeded");
+			return -1;
+		}
+
+		block->state = BLOCK_RESEND;
+		lost = true;
+	}
+
+	if (!sent) {
 		return -EINVAL;
 	}
 
-	if (!coap_pending_cycle(&dl->coap.pending)) {
-		LOG_ERR("CoAP max-retransmissions exceeded");
-		return -1;
+	if (lost) {
+		block_size_shrink(dl);
 	}
 
 	return 0;
 }
 
-int coap_block_update(struct download_client *client, struct coap_packet *pkt, size_t *blk_off)
+static struct download_client_coap_block *block_find(struct download_client *client,
+						     const struct coap_packet *pkt)
 {
-	int err, new_current;
-	bool more;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t tkl;
 
-	*blk_off = client->coap.block_ctx.current %
-		   coap_block_size_to_bytes(client->coap.block_ctx.block_size);
-	if (*blk_off) {
-		LOG_DBG("%d bytes of current block already downloaded",
-			*blk_off);
-	}
+	tkl = coap_header_get_token(pkt, token);
 
-	new_current = coap_get_current_from_response_pkt(pkt);
-	if (new_current < 0) {
-		LOG_ERR("Failed to get current from CoAP packet, err %d", new_current);
-		return new_current;
-	}
+	for (size_t i = 0; i < WINDOW; i++) {
+		struct download_client_coap_block *block = &client->coap.block[i];
 
-	if (new_current < client->coap.block_ctx.current) {
-		LOG_WRN("Block out of order %d, expected %d", new_current,
-			client->coap.block_ctx.current);
-		return 1;
-	} else if (new_current > client->coap.block_ctx.current) {
-		LOG_WRN("Block out of order %d, expected %d", new_current,
-			client->coap.block_ctx.current);
-		return -1;
-	}
+		if (block->state != BLOCK_SENT && block->state != BLOCK_RESEND) {
+			continue;
+		}
 
-	err = coap_update_from_block(pkt, &client->coap.block_ctx);
-	if (err) {
-		return err;
+		if (coap_header_get_id(pkt) == block->pending.id &&
+		    tkl == sizeof(block->token) &&
+		    !memcmp(token, block->token, sizeof(block->token))) {
+			return block;
+		}
 	}
 
-	if (client->file_size == 0) {
-		LOG_DBG("Total size: %d", client->coap.block_ctx.total_size);
-		client->file_size = client->coap.block_ctx.total_size;
+	return NULL;
+}
+
+static int block_store(struct download_client *client,
+		       struct download_client_coap_block *block,
+		       const uint8_t *payload, uint16_t len)
+{
+#if WINDOW > 1
+	bool used[WINDOW - 1] = { 0 };
+
+	for (size_t i = 0; i < WINDOW; i++) {
+		if (client->coap.block[i].state == BLOCK_RECEIVED) {
+			used[client->coap.block[i].store] = true;
+		}
 	}
 
-	more = coap_next_block(pkt, &client->coap.block_ctx);
-	if (!more) {
-		LOG_DBG("Last block received");
+	for (size_t i = 0; i < ARRAY_SIZE(used); i++) {
+		if (!used[i]) {
+			memcpy(client->coap.store[i], payload, len);
+			block->store = i;
+			block->len = len;
+			block->state = BLOCK_RECEIVED;
+			return 0;
+		}
 	}
+#endif
+	return -ENOMEM;
+}
+
+int coap_fragment_get(struct download_client *client)
+{
+#if WINDOW > 1
+	for (size_t i = 0; i < WINDOW; i++) {
+		struct download_client_coap_block *block = &client->coap.block[i];
+
+		if (block->state != BLOCK_RECEIVED || block->offset != client->progress) {
+			continue;
+		}
+
+		memcpy(client->conn[0].buf, client->coap.store[block->store], block->len);
+		client->conn[0].offset = block->len;
+		client->progress += block->len;
+		block->state = BLOCK_FREE;
 
+		return 1;
+	}
+#endif
 	return 0;
 }
 
+/* Returns:
+ *  0 if the payload of the next block is in the buffer
+ *  1 if no payload is to be handed to the application
+ * -1 on error
+ */
 int coap_parse(struct download_client *client, size_t len)
 {
 	int err;
-	size_t blk_off;
+	int block2;
+	int size2;
+	size_t skip;
+	size_t offset;
+	uint8_t szx;
+	bool retransmitted;
 	uint8_t response_code;
 	uint16_t payload_len;
 	const uint8_t *payload;
 	struct coap_packet response;
+	struct download_client_coap_block *block;
 
 	/* TODO: currently we stop download on every error, but this is mostly not necessary
 	 * and we can just request the same block again using retry mechanism
 	 */
 
-	err = coap_packet_parse(&response, client->buf, len, NULL, 0);
+	err = coap_packet_parse(&response, client->conn[0].buf, len, NULL, 0);
 	if (err) {
 		LOG_ERR("Failed to parse CoAP packet, err %d", err);
 		return -1;
 	}
 
-	coap_pending_clear(&client->coap.pending);
-
-	err = coap_block_update(client, &response, &blk_off);
-	if (err) {
-		return err;
-	}
-
-	if (coap_header_get_id(&response) != client->coap.pending.id) {
-		LOG_ERR("Response is not pending");
-		return -1;
+	block = block_find(client, &response);
+	if (!block) {
+		LOG_WRN("Response is not pending");
+		return 1;
 	}
 
 	if (coap_header_get_type(&response) != COAP_TYPE_ACK) {
@@ -178,45 +299,150 @@ int coap_parse(struct download_client *client, size_t len)
 		return -1;
 	}
 
+	block2 = coap_get_option_int(&response, COAP_OPTION_BLOCK2);
+	if (block2 < 0) {
+		LOG_ERR("Failed to get block from CoAP packet, err %d", block2);
+		return -1;
+	}
+
+	szx = GET_BLOCK_SIZE(block2);
+	offset = GET_BLOCK_NUM(block2) << (szx + 4);
+
+	if (offset != block->offset || szx > block->szx) {
+		LOG_ERR("Block out of order %d, expected %d", offset, block->offset);
+		return -1;
+	}
+
 	payload = coap_packet_get_payload(&response, &payload_len);
-	if (!payload) {
+	if (!payload || payload_len > block_bytes(szx)) {
 		LOG_WRN("No CoAP payload!");
 		return -1;
 	}
 
-	/* TODO: because our buffer is large enough for the whole datagram,
-	 * we don't scrictly need to copy the bytes at the beginning
-	 * of the buffer, we could simply send a fragment pointing to the
-	 * payload directly.
-	 */
+	if (client->file_size == 0) {
+		size2 = coap_get_option_int(&response, COAP_OPTION_SIZE2);
+		if (size2 > 0) {
+			client->file_size = size2;
+		} else if (!GET_MORE(block2)) {
+			client->file_size = offset + payload_len;
+		}
+		LOG_DBG("Total size: %d", client->file_size);
+	}
+
+	retransmitted = block->pending.retries !=
+			CONFIG_DOWNLOAD_CLIENT_COAP_MAX_RETRANSMIT_REQUEST_COUNT;
+
+	if (szx < block->szx) {
+		/* The server uses smaller blocks, the rest of the block has
+		 * not been received. Request the file again from the first
+		 * missing byte, with the block size of the server.
+		 */
+		LOG_DBG("Server block size is %d", block_bytes(szx));
+		client->coap.szx_max = szx;
+		client->coap.szx = MIN(client->coap.szx, szx);
+
+		if (offset != client->progress) {
+			window_reset(client, client->progress);
+			return coap_request_send(client) ? -1 : 1;
+		}
+
+		window_reset(client, offset + payload_len);
+	}
+
+	if (!retransmitted) {
+		block_size_grow(client);
+	}
+
+	if (offset > client->progress) {
+		/* Keep the block until the previous blocks are received.
+		 * If it cannot be kept, it is requested again on timeout.
+		 */
+		LOG_DBG("Block %d received ahead of %d", offset, client->progress);
+		(void)block_store(client, block, payload, payload_len);
+		return 1;
+	}
+
+	/* The download may resume from the middle of a block */
+	skip = client->progress - offset;
+	if (skip > payload_len) {
+		LOG_ERR("Block %d does not contain offset %d", offset, client->progress);
+		return -1;
+	}
+
 	LOG_DBG("CoAP response: %d, copying %d bytes",
-		coap_header_get_code(&response), payload_len - blk_off);
-	memcpy(client->buf + client->offset, payload + blk_off,
-	       payload_len - blk_off);
+		coap_header_get_code(&response), payload_len - skip);
+	memmove(client->conn[0].buf, payload + skip, payload_len - skip);
 
-	client->offset += payload_len - blk_off;
-	client->progress += payload_len - blk_off;
+	client->conn[0].offset = payload_len - skip;
+	client->progress += payload_len - skip;
+	block->state = BLOCK_FREE;
 
 	return 0;
 }
 
-int coap_request_send(struct download_client *client)
+static bool block_needed(const struct download_client *client)
+{
+	if (client->file_size == 0) {
+		/* Only request the first block until the file size is known */
+		for (size_t i = 0; i < WINDOW; i++) {
+			if (client->coap.block[i].state != BLOCK_FREE) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	return client->coap.next_block < client->file_size;
+}
+
+static struct download_client_coap_block *block_new(struct download_client *client)
+{
+	struct download_client_coap_block *block = NULL;
+	uint8_t szx = client->coap.szx;
+
+	for (size_t i = 0; i < WINDOW; i++) {
+		if (client->coap.block[i].state == BLOCK_FREE) {
+			block = &client->coap.block[i];
+			break;
+		}
+	}
+
+	if (!block || !block_needed(client)) {
+		return NULL;
+	}
+
+	/* The block offset must be a multiple of the block size */
+	while (client->coap.next_block % block_bytes(szx)) {
+		szx--;
+	}
+
+	block->offset = client->coap.next_block;
+	block->szx = szx;
+	block->state = BLOCK_NEW;
+
+	client->coap.next_block += block_bytes(szx);
+
+	return block;
+}
+
+static int block_request_send(struct download_client *client,
+			      struct download_client_coap_block *block)
 {
 	int err;
-	uint16_t id;
 	char file[FILENAME_SIZE];
 	char *path_elem;
 	char *path_elem_saveptr;
 	struct coap_packet request;
 
-	if (has_pending(client)) {
-		id = client->coap.pending.id;
-	} else {
-		id = coap_next_id();
+	if (block->state == BLOCK_NEW) {
+		block->pending.id = coap_next_id();
+		memcpy(block->token, coap_next_token(), sizeof(block->token));
 	}
 
-	err = coap_packet_init(&request, client->buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE, COAP_VER,
-			       COAP_TYPE_CON, 8, coap_next_token(), COAP_METHOD_GET, id);
+	err = coap_packet_init(&request, client->conn[0].buf, CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
+			       COAP_VER, COAP_TYPE_CON, sizeof(block->token), block->token,
+			       COAP_METHOD_GET, block->pending.id);
 	if (err) {
 		LOG_ERR("Failed to init CoAP message, err %d", err);
 		return err;
@@ -238,31 +464,37 @@ int coap_request_send(struct download_client *client)
 		}
 	} while ((path_elem = strtok_r(NULL, COAP_PATH_ELEM_DELIM, &path_elem_saveptr)));
 
-	err = coap_append_block2_option(&request, &client->coap.block_ctx);
+	err = coap_append_option_int(&request, COAP_OPTION_BLOCK2,
+				     ((block->offset / block_bytes(block->szx)) << 4) |
+				     block->szx);
 	if (err) {
 		LOG_ERR("Unable to add block2 option");
 		return err;
 	}
 
-	err = coap_append_size2_option(&request, &client->coap.block_ctx);
-	if (err) {
-		LOG_ERR("Unable to add size2 option");
-		return err;
+	if (client->file_size == 0) {
+		/* Ask for the file size */
+		err = coap_append_option_int(&request, COAP_OPTION_SIZE2, 0);
+		if (err) {
+			LOG_ERR("Unable to add size2 option");
+			return err;
+		}
 	}
 
-	if (!has_pending(client)) {
-		err = coap_pending_init(&client->coap.pending, &request, &client->remote_addr,
+	if (block->state == BLOCK_NEW) {
+		err = coap_pending_init(&block->pending, &request, &client->remote_addr,
 					CONFIG_DOWNLOAD_CLIENT_COAP_MAX_RETRANSMIT_REQUEST_COUNT);
 		if (err < 0) {
 			return -EINVAL;
 		}
 
-		coap_pending_cycle(&client->coap.pending);
+		coap_pending_cycle(&block->pending);
 	}
 
-	LOG_DBG("CoAP next block: %d", client->coap.block_ctx.current);
+	LOG_DBG("CoAP next block: %d", block->offset);
 
-	err = socket_send(client, request.offset, client->coap.pending.timeout);
+	err = socket_send(client->conn[0].fd, client->conn[0].buf, request.offset,
+			  block->pending.timeout);
 	if (err) {
 		LOG_ERR("Failed to send CoAP request, errno %d", errno);
 		return err;
@@ -272,5 +504,37 @@ int coap_request_send(struct download_client *client)
 		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
 	}
 
+	block->state = BLOCK_SENT;
+
+	return 0;
+}
+
+int coap_request_send(struct download_client *client)
+{
+	int err;
+	struct download_client_coap_block *block;
+
+	/* Retransmit the requests which timed out */
+	for (size_t i = 0; i < WINDOW; i++) {
+		block = &client->coap.block[i];
+
+		if (block->state != BLOCK_RESEND) {
+			continue;
+		}
+
+		err = block_request_send(client, block);
+		if (err) {
+			return err;
+		}
+	}
+
+	/* Request the next blocks, as long as the window allows */
+	while ((block = block_new(client))) {
+		err = block_request_send(client, block);
+		if (err) {
+			return err;
+		}
+	}
+
 	return 0;
 }
@@ -12,6 +12,7 @@
 #if defined(CONFIG_POSIX_API)
 #include <zephyr/posix/unistd.h>
 #include <zephyr/posix/netdb.h>
+#include <zephyr/posix/poll.h>
 #include <zephyr/posix/sys/time.h>
 #include <zephyr/posix/sys/socket.h>
 #else
@@ -32,14 +33,22 @@ int url_parse_port(const char *url, uint16_t *port);
 int url_parse_proto(const char *url, int *proto, int *type);
 int url_parse_host(const char *url, char *host, size_t len);
 
-int http_parse(struct download_client *client, size_t len);
+int http_parse(struct download_client *client,
+	       struct download_client_conn *conn, size_t len);
 int http_get_request_send(struct download_client *client);
+size_t http_conn_count(const struct download_client *client);
+size_t http_fragment_len(const struct download_client *client,
+			 const struct download_client_conn *conn);
+struct download_client_conn *http_fragment_conn_get(struct download_client *client);
+void http_fragment_consume(struct download_client *client,
+			   struct download_client_conn *conn, size_t len);
 
 int coap_block_init(struct download_client *client, size_t from);
 int coap_get_recv_timeout(struct download_client *dl);
 int coap_initiate_retransmission(struct download_client *dl);
 int coap_parse(struct download_client *client, size_t len);
 int coap_request_send(struct download_client *client);
+int coap_fragment_get(struct download_client *client);
 
 static const char *str_family(int family)
 {
@@ -209,6 +218,93 @@ static int host_lookup(const char *host, int family, uint8_t pdn_id,
 	return 0;
 }
 
+static int conn_connect(struct download_client *dl,
+			struct download_client_conn *conn, int type,
+			socklen_t addrlen)
+{
+	int err;
+
+	conn->fd = socket(dl->remote_addr.sa_family, type, dl->proto);
+	if (conn->fd < 0) {
+		LOG_ERR("Failed to create socket, err %d", errno);
+		return -errno;
+	}
+
+	if (dl->config.pdn_id) {
+		err = socket_pdn_id_set(conn->fd, dl->config.pdn_id);
+		if (err) {
+			goto cleanup;
+		}
+	}
+
+	if ((dl->proto == IPPROTO_TLS_1_2 || dl->proto == IPPROTO_DTLS_1_2)
+	     && (dl->config.sec_tag != -1)) {
+		err = socket_sectag_set(conn->fd, dl->config.sec_tag);
+		if (err) {
+			goto cleanup;
+		}
+
+		if (dl->config.set_tls_hostname) {
+			err = socket_tls_hostname_set(conn->fd, dl->host);
+			if (err) {
+				goto cleanup;
+			}
+		}
+	}
+
+	LOG_INF("Connecting to %s", dl->host);
+	LOG_DBG("fd %d, addrlen %d, fam %s", conn->fd, addrlen,
+		str_family(dl->remote_addr.sa_family));
+
+	err = connect(conn->fd, &dl->remote_addr, addrlen);
+	if (err) {
+		LOG_ERR("Unable to connect, errno %d", errno);
+		err = -errno;
+	}
+
+cleanup:
+	if (err) {
+		/* Unable to connect, close socket */
+		close(conn->fd);
+		conn->fd = -1;
+	}
+
+	return err;
+}
+
+static int conns_close(struct download_client *dl)
+{
+	int err = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(dl->conn); i++) {
+		if (dl->conn[i].fd < 0) {
+			continue;
+		}
+
+		if (close(dl->conn[i].fd)) {
+			LOG_ERR("Failed to close socket, errno %d", errno);
+			err = -errno;
+		}
+
+		dl->conn[i].fd = -1;
+	}
+
+	return err;
+}
+
+/* Discard the data received on all connections and
+ * request the file again from the current progress.
+ */
+static void conns_reset(struct download_client *dl)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(dl->conn); i++) {
+		dl->conn[i].offset = 0;
+		memset(&dl->conn[i].http, 0, sizeof(dl->conn[i].http));
+	}
+
+	dl->http.next_range = dl->progress;
+}
+
 static int client_connect(struct download_client *dl)
 {
 	int err;
@@ -285,67 +381,30 @@ static int client_connect(struct download_client *dl)
 	LOG_DBG("family: %d, type: %d, proto: %d",
 		dl->remote_addr.sa_family, type, dl->proto);
 
-	dl->fd = socket(dl->remote_addr.sa_family, type, dl->proto);
-	if (dl->fd < 0) {
-		LOG_ERR("Failed to create socket, err %d", errno);
-		return -errno;
-	}
-
-	if (dl->config.pdn_id) {
-		err = socket_pdn_id_set(dl->fd, dl->config.pdn_id);
+	for (size_t i = 0; i < http_conn_count(dl); i++) {
+		err = conn_connect(dl, &dl->conn[i], type, addrlen);
 		if (err) {
-			goto cleanup;
+			conns_close(dl);
+			return err;
 		}
 	}
 
-	if ((dl->proto == IPPROTO_TLS_1_2 || dl->proto == IPPROTO_DTLS_1_2)
-	     && (dl->config.sec_tag != -1)) {
-		err = socket_sectag_set(dl->fd, dl->config.sec_tag);
-		if (err) {
-			goto cleanup;
-		}
-
-		if (dl->config.set_tls_hostname) {
-			err = socket_tls_hostname_set(dl->fd, dl->host);
-			if (err) {
-				goto cleanup;
-			}
-		}
-	}
-
-	LOG_INF("Connecting to %s", dl->host);
-	LOG_DBG("fd %d, addrlen %d, fam %s, port %d",
-		dl->fd, addrlen, str_family(dl->remote_addr.sa_family), port);
-
-	err = connect(dl->fd, &dl->remote_addr, addrlen);
-	if (err) {
-		LOG_ERR("Unable to connect, errno %d", errno);
-		err = -errno;
-	}
-
-cleanup:
-	if (err) {
-		/* Unable to connect, close socket */
-		close(dl->fd);
-		dl->fd = -1;
-	}
-
-	return err;
+	return 0;
 }
 
-int socket_send(const struct download_client *client, size_t len, int timeout)
+int socket_send(int fd, const char *buf, size_t len, int timeout)
 {
 	int err;
 	int sent;
 	size_t off = 0;
 
-	err = set_snd_socket_timeout(client->fd, timeout);
+	err = set_snd_socket_timeout(fd, timeout);
 	if (err) {
 		return -errno;
 	}
 
 	while (len) {
-		sent = send(client->fd, client->buf + off, len, 0);
+		sent = send(fd, buf + off, len, 0);
 		if (sent < 0) {
 			return -errno;
 		}
@@ -357,6 +416,11 @@ int socket_send(const struct download_client *client, size_t len, int timeout)
 	return 0;
 }
 
+static bool is_http(const struct download_client *dl)
+{
+	return dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2;
+}
+
 static int request_send(struct download_client *dl)
 {
 	switch (dl->proto) {
@@ -373,16 +437,17 @@ static int request_send(struct download_client *dl)
 	return 0;
 }
 
-static int fragment_evt_send(const struct download_client *client)
+static int fragment_evt_send(const struct download_client *client,
+			     const char *buf, size_t len)
 {
-	__ASSERT(client->offset <= CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
+	__ASSERT(len <= CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
 		 "Buffer overflow!");
 
 	const struct download_client_evt evt = {
 		.id = DOWNLOAD_CLIENT_EVT_FRAGMENT,
 		.fragment = {
-			.buf = client->buf,
-			.len = client->offset,
+			.buf = buf,
+			.len = len,
 		}
 	};
 
@@ -417,10 +482,73 @@ static int reconnect(struct download_client *dl)
 		return err;
 	}
 
+	/* Responses to pipelined requests are lost */
+	if (is_http(dl)) {
+		conns_reset(dl);
+	} else if (IS_ENABLED(CONFIG_COAP)) {
+		coap_block_init(dl, dl->progress);
+	}
+
 	return 0;
 }
 
-static size_t socket_recv(struct download_client *dl)
+/* Get the HTTP connection to receive from. Connections holding a fragment
+ * received ahead of the previous fragments are not read from until the
+ * fragment has been handed to the application.
+ */
+static struct download_client_conn *http_conn_wait(struct download_client *dl,
+						   int timeout)
+{
+	struct pollfd fds[ARRAY_SIZE(dl->conn)];
+	struct download_client_conn *conns[ARRAY_SIZE(dl->conn)];
+	nfds_t nfds = 0;
+	int rc;
+
+	for (size_t i = 0; i < ARRAY_SIZE(dl->conn); i++) {
+		struct download_client_conn *conn = &dl->conn[i];
+
+		if (conn->fd < 0 || !conn->http.pending ||
+		    http_fragment_len(dl, conn)) {
+			continue;
+		}
+
+		fds[nfds].fd = conn->fd;
+		fds[nfds].events = POLLIN;
+		conns[nfds] = conn;
+		nfds++;
+	}
+
+	if (nfds == 0) {
+		LOG_ERR("No response expected");
+		errno = ENOTCONN;
+		return NULL;
+	}
+
+	if (nfds == 1) {
+		/* Wait in recv() */
+		return conns[0];
+	}
+
+	rc = poll(fds, nfds, timeout > 0 ? timeout : -1);
+	if (rc <= 0) {
+		if (rc == 0) {
+			errno = ETIMEDOUT;
+		}
+
+		return NULL;
+	}
+
+	for (size_t i = 0; i < nfds; i++) {
+		if (fds[i].revents) {
+			return conns[i];
+		}
+	}
+
+	return NULL;
+}
+
+static size_t socket_recv(struct download_client *dl,
+			  struct download_client_conn **conn)
 {
 	int err, timeout = 0;
 
@@ -428,10 +556,15 @@ static size_t socket_recv(struct download_client *dl)
 	case IPPROTO_TCP:
 	case IPPROTO_TLS_1_2:
 		timeout = CONFIG_DOWNLOAD_CLIENT_TCP_SOCK_TIMEO_MS;
+		*conn = http_conn_wait(dl, timeout);
+		if (!*conn) {
+			return -1;
+		}
 		break;
 	case IPPROTO_UDP:
 	case IPPROTO_DTLS_1_2:
 		if (IS_ENABLED(CONFIG_COAP)) {
+			*conn = &dl->conn[0];
 			timeout = coap_get_recv_timeout(dl);
 			if (timeout <= 0) {
 				errno = ETIMEDOUT;
@@ -444,12 +577,24 @@ static size_t socket_recv(struct download_client *dl)
 		return -1;
 	}
 
-	err = set_recv_socket_timeout(dl->fd, timeout);
+	if (sizeof((*conn)->buf) - (*conn)->offset == 0) {
+		LOG_ERR("Could not fit HTTP header from server (> %d)",
+			sizeof((*conn)->buf));
+		errno = E2BIG;
+		return -1;
+	}
+
+	err = set_recv_socket_timeout((*conn)->fd, timeout);
 	if (err) {
 		return -1;
 	}
 
-	return recv(dl->fd, dl->buf + dl->offset, sizeof(dl->buf) - dl->offset, 0);
+	LOG_DBG("Receiving up to %d bytes at %p...",
+		(sizeof((*conn)->buf) - (*conn)->offset),
+		((*conn)->buf + (*conn)->offset));
+
+	return recv((*conn)->fd, (*conn)->buf + (*conn)->offset,
+		    sizeof((*conn)->buf) - (*conn)->offset, 0);
 }
 
 static int request_resend(struct download_client *dl)
@@ -473,40 +618,133 @@ static int request_resend(struct download_client *dl)
 	return 0;
 }
 
+/* Hand the payload received in order to the application before
+ * the connections are reset, so that it is not downloaded again.
+ */
+static int http_partial_fragment_send(struct download_client *dl)
+{
+	int rc;
+
+	for (size_t i = 0; i < ARRAY_SIZE(dl->conn); i++) {
+		struct download_client_conn *conn = &dl->conn[i];
+		size_t len = MIN(conn->offset, conn->http.body_left);
+
+		if (!conn->http.has_header || conn->http.pos != dl->progress ||
+		    len == 0) {
+			continue;
+		}
+
+		rc = fragment_evt_send(dl, conn->buf, len);
+		if (rc) {
+			return rc;
+		}
+
+		http_fragment_consume(dl, conn, len);
+		break;
+	}
+
+	return 0;
+}
+
+/* Returns:
+ *  0 to continue the download
+ *  1 if the download is complete or has been stopped
+ */
+static int fragments_send(struct download_client *dl,
+			  struct download_client_conn *conn)
+{
+	int rc;
+	size_t len;
+
+	do {
+		len = is_http(dl) ? http_fragment_len(dl, conn) : conn->offset;
+
+		/* Send fragment to application.
+		 * If the application callback returns non-zero, stop.
+		 */
+		rc = fragment_evt_send(dl, conn->buf, len);
+		if (rc) {
+			LOG_INF("Fragment refused, download stopped.");
+			return 1;
+		}
+
+		if (is_http(dl)) {
+			http_fragment_consume(dl, conn, len);
+
+			/* Parse the response to the next pipelined request,
+			 * which may have been received already.
+			 */
+			if (conn->offset && http_parse(dl, conn, 0) < 0) {
+				error_evt_send(dl, EBADMSG);
+				return 1;
+			}
+		}
+
+		if (dl->file_size) {
+			LOG_INF("Downloaded %u/%u bytes (%d%%)",
+				dl->progress, dl->file_size,
+				(dl->progress * 100) / dl->file_size);
+		} else {
+			LOG_INF("Downloaded %u bytes", dl->progress);
+		}
+
+		if (dl->progress == dl->file_size) {
+			LOG_INF("Download complete");
+			const struct download_client_evt evt = {
+				.id = DOWNLOAD_CLIENT_EVT_DONE,
+			};
+			dl->callback(&evt);
+			return 1;
+		}
+
+		/* Attempt to reconnect if the connection was closed */
+		if (conn->http.connection_close && !conn->http.has_header) {
+			conn->http.connection_close = false;
+			reconnect(dl);
+		}
+
+		/* Fragments received ahead of the previous fragments
+		 * may now be handed to the application.
+		 */
+		if (is_http(dl)) {
+			conn = http_fragment_conn_get(dl);
+		} else if (!IS_ENABLED(CONFIG_COAP) || !coap_fragment_get(dl)) {
+			conn = NULL;
+		}
+	} while (conn);
+
+	return 0;
+}
+
 void download_thread(void *client, void *a, void *b)
 {
 	int rc = 0;
 	int error_cause;
 	size_t len;
 	struct download_client *const dl = client;
+	struct download_client_conn *conn;
 
 restart_and_suspend:
 	k_thread_suspend(dl->tid);
 
 	while (true) {
-		__ASSERT(dl->offset < sizeof(dl->buf), "Buffer overflow");
-
-		if (sizeof(dl->buf) - dl->offset == 0) {
-			LOG_ERR("Could not fit HTTP header from server (> %d)",
-				sizeof(dl->buf));
-			error_evt_send(dl, E2BIG);
-			break;
-		}
-
-		LOG_DBG("Receiving up to %d bytes at %p...",
-			(sizeof(dl->buf) - dl->offset), (dl->buf + dl->offset));
-
-		len = socket_recv(dl);
+		conn = NULL;
+		len = socket_recv(dl, &conn);
 
 		if ((len == 0) || (len == -1)) {
 			/* We just had an unexpected socket error or closure */
 
+			if (len == -1 && errno == E2BIG) {
+				error_evt_send(dl, E2BIG);
+				break;
+			}
+
 			/* If there is a partial data payload in our buffer,
-			 * and it has been accounted in our progress, we have
-			 * to hand it to the application before discarding it.
+			 * we have to hand it to the application before
+			 * discarding it.
 			 */
-			if ((dl->offset > 0) && (dl->http.has_header)) {
-				rc = fragment_evt_send(dl);
+			if (is_http(dl)) {
+				rc = http_partial_fragment_send(dl);
 				if (rc) {
 					/* Restart and suspend */
 					LOG_INF("Fragment refused, download stopped.");
@@ -555,8 +793,8 @@ restart_and_suspend:
 
 		LOG_DBG("Read %d bytes from socket", len);
 
-		if (dl->proto == IPPROTO_TCP || dl->proto == IPPROTO_TLS_1_2) {
-			rc = http_parse(client, len);
+		if (is_http(dl)) {
+			rc = http_parse(client, conn, len);
 			if (rc > 0) {
 				/* Wait for more data (fragment/header) */
 				continue;
@@ -577,63 +815,46 @@ restart_and_suspend:
 			break;
 		}
 
-		if (dl->file_size) {
-			LOG_INF("Downloaded %u/%u bytes (%d%%)",
-				dl->progress, dl->file_size,
-				(dl->progress * 100) / dl->file_size);
-		} else {
-			LOG_INF("Downloaded %u bytes", dl->progress);
+		if (is_http(dl)) {
+			/* Fragments are handed to the application in order.
+			 * A fragment received ahead of the previous fragments
+			 * is kept in the buffer of its connection meanwhile.
+			 */
+			conn = http_fragment_conn_get(dl);
+			if (!conn) {
+				continue;
+			}
 		}
 
-		/* Send fragment to application.
-		 * If the application callback returns non-zero, stop.
-		 */
-		rc = fragment_evt_send(dl);
+		rc = fragments_send(dl, conn);
 		if (rc) {
-			/* Restart and suspend */
-			LOG_INF("Fragment refused, download stopped.");
-			break;
-		}
-
-		if (dl->progress == dl->file_size) {
-			LOG_INF("Download complete");
-			const struct download_client_evt evt = {
-				.id = DOWNLOAD_CLIENT_EVT_DONE,
-			};
-			dl->callback(&evt);
 			/* Restart and suspend */
 			break;
 		}
 
-		/* Attempt to reconnect if the connection was closed */
-		if (dl->http.connection_close) {
-			dl->http.connection_close = false;
-			reconnect(dl);
-		}
-
 send_again:
-		dl->offset = 0;
-		/* Request next fragment, if necessary (HTTPS/CoAP) */
-		if (dl->proto != IPPROTO_TCP || len == 0
-		   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
-			dl->http.has_header = false;
+		if (!is_http(dl)) {
+			dl->conn[0].offset = 0;
+		}
 
-			rc = request_send(dl);
+		/* Request next fragment, if necessary. With HTTP,
+		 * this keeps the configured number of ranges requested.
+		 */
+		rc = request_send(dl);
+		if (rc) {
+			rc = error_evt_send(dl, ECONNRESET);
 			if (rc) {
-				rc = error_evt_send(dl, ECONNRESET);
-				if (rc) {
-					/* Restart and suspend */
-					break;
-				}
-
-				rc = reconnect(dl);
-				if (rc) {
-					error_evt_send(dl, EHOSTDOWN);
-					break;
-				}
+				/* Restart and suspend */
+				break;
+			}
 
-				goto send_again;
+			rc = reconnect(dl);
+			if (rc) {
+				error_evt_send(dl, EHOSTDOWN);
+				break;
 			}
+
+			goto send_again;
 		}
 	}
 
@@ -648,7 +869,10 @@ int download_client_init(struct download_client *const client,
 		return -EINVAL;
 	}
 
-	client->fd = -1;
+	for (size_t i = 0; i < ARRAY_SIZE(client->conn); i++) {
+		client->conn[i].fd = -1;
+	}
+
 	client->callback = callback;
 
 	/* The thread is spawned now, but it will suspend itself;
@@ -674,7 +898,7 @@ int download_client_connect(struct download_client *client, const char *host,
 		return -EINVAL;
 	}
 
-	if (client->fd != -1) {
+	if (client->conn[0].fd != -1) {
 		/* Already connected */
 		return 0;
 	}
@@ -701,7 +925,7 @@ int download_client_connect(struct download_client *client, const char *host,
 	client->host = host;
 
 	err = client_connect(client);
-	if (client->fd < 0) {
+	if (client->conn[0].fd < 0) {
 		return err;
 	}
 
@@ -710,21 +934,11 @@ int download_client_connect(struct download_client *client, const char *host,
 
 int download_client_disconnect(struct download_client *const client)
 {
-	int err;
-
-	if (client == NULL || client->fd < 0) {
+	if (client == NULL || client->conn[0].fd < 0) {
 		return -EINVAL;
 	}
 
-	err = close(client->fd);
-	if (err) {
-		LOG_ERR("Failed to close socket, errno %d", errno);
-		return -errno;
-	}
-
-	client->fd = -1;
-
-	return 0;
+	return conns_close(client);
 }
 
 int download_client_start(struct download_client *client, const char *file,
@@ -736,7 +950,7 @@ int download_client_start(struct download_client *client, const char *file,
 		return -EINVAL;
 	}
 
-	if (client->fd < 0) {
+	if (client->conn[0].fd < 0) {
 		return -ENOTCONN;
 	}
 
@@ -744,8 +958,7 @@ int download_client_start(struct download_client *client, const char *file,
 	client->file_size = 0;
 	client->progress = from;
 
-	client->offset = 0;
-	client->http.has_header = false;
+	conns_reset(client);
 
 	if (client->proto == IPPROTO_UDP || client->proto == IPPROTO_DTLS_1_2) {
 		if (IS_ENABLED(CONFIG_COAP)) {
@@ -786,3 +999,8 @@ int download_client_file_size_get(struct download_client *client, size_t *size)
 
 	return 0;
 }
+
+bool download_client_is_connected(const struct download_client *client)
+{
+	return client && (client->conn[0].fd >= 0);
+}
@@ -42,13 +42,43 @@ LOG_MODULE_DECLARE(download_client, CONFIG_DOWNLOAD_CLIENT_LOG_LEVEL);
 
 int url_parse_host(const char *url, char *host, size_t len);
 int url_parse_file(const char *url, char *file, size_t len);
-int socket_send(const struct download_client *client, size_t len, int timeout);
+int socket_send(int fd, const char *buf, size_t len, int timeout);
 
-int http_get_request_send(struct download_client *client)
+static size_t frag_size_get(const struct download_client *client)
+{
+	if (client->config.frag_size_override) {
+		return client->config.frag_size_override;
+	}
+
+	return CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE;
+}
+
+static bool range_requests_used(const struct download_client *client)
+{
+	return (client->proto == IPPROTO_TLS_1_2) ||
+	       (client->proto == IPPROTO_TCP &&
+		IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS));
+}
+
+size_t http_conn_count(const struct download_client *client)
+{
+	/* Only ranges of the file can be requested over parallel connections */
+	return range_requests_used(client) ? ARRAY_SIZE(client->conn) : 1;
+}
+
+/* Returns:
+ *  0 if the request has been sent
+ *  -EAGAIN if the request does not fit in the buffer yet
+ *  a negative error code otherwise
+ */
+static int request_send(struct download_client *client,
+			struct download_client_conn *conn)
 {
 	int err;
 	int len;
 	size_t off;
+	char *req;
+	size_t req_size;
 	char host[HOSTNAME_SIZE];
 	char file[FILENAME_SIZE];
 
@@ -65,49 +95,158 @@ int http_get_request_send(struct download_client *client)
 		return err;
 	}
 
+	/* The request is written after the response bytes in the buffer,
+	 * which may belong to responses to pipelined requests.
+	 */
+	req = conn->buf + conn->offset;
+	req_size = sizeof(conn->buf) - conn->offset;
+
 	/* Offset of last byte in range (Content-Range) */
-	if (client->config.frag_size_override) {
-		off = client->progress + client->config.frag_size_override - 1;
-	} else {
-		off = client->progress +
-			CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE - 1;
-	}
+	off = client->http.next_range + frag_size_get(client) - 1;
 
 	if (client->file_size != 0) {
 		/* Don't request bytes past the end of file */
 		off = MIN(off, client->file_size - 1);
 	}
 
-	if (client->proto == IPPROTO_TLS_1_2
-	   || IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS)) {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			HTTP_GET_RANGE, file, host, client->progress, off);
+	if (range_requests_used(client)) {
+		len = snprintf(req, req_size, HTTP_GET_RANGE, file, host,
+			       client->http.next_range, off);
 	} else if (client->progress) {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			HTTP_GET_OFFSET, file, host, client->progress);
+		len = snprintf(req, req_size, HTTP_GET_OFFSET, file, host,
+			       client->progress);
 	} else {
-		len = snprintf(client->buf,
-			CONFIG_DOWNLOAD_CLIENT_BUF_SIZE,
-			HTTP_GET, file, host);
+		len = snprintf(req, req_size, HTTP_GET, file, host);
 	}
 
-	if (len < 0 || len > CONFIG_DOWNLOAD_CLIENT_BUF_SIZE) {
+	if (len < 0 || len >= req_size) {
+		if (conn->offset) {
+			/* Wait for the buffer to be emptied */
+			return -EAGAIN;
+		}
+
 		LOG_ERR("Cannot create GET request, buffer too small");
 		return -ENOMEM;
 	}
 
 	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(client->buf, len, "HTTP request");
+		LOG_HEXDUMP_DBG(req, len, "HTTP request");
 	}
 
-	err = socket_send(client, len, 0);
+	err = socket_send(conn->fd, req, len, 0);
 	if (err) {
 		LOG_ERR("Failed to send HTTP request, errno %d", errno);
 		return err;
 	}
 
+	conn->http.pending++;
+
+	if (range_requests_used(client)) {
+		client->http.next_range = off + 1;
+	}
+
+	return 0;
+}
+
+static bool range_request_needed(const struct download_client *client,
+				 const struct download_client_conn *conn)
+{
+	if (conn->fd < 0 || conn->http.connection_close ||
+	    conn->http.pending >= CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH) {
+		return false;
+	}
+
+	if (client->file_size == 0) {
+		/* Only request the first range until the file size is known */
+		for (size_t i = 0; i < ARRAY_SIZE(client->conn); i++) {
+			if (client->conn[i].http.pending) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	return client->http.next_range < client->file_size;
+}
+
+int http_get_request_send(struct download_client *client)
+{
+	int err;
+	bool sent;
+
+	if (!range_requests_used(client)) {
+		/* The rest of the file is requested at once */
+		if (client->conn[0].http.pending) {
+			return 0;
+		}
+
+		return request_send(client, &client->conn[0]);
+	}
+
+	/* Send one request per connection in turn, so that consecutive
+	 * ranges are received in parallel over all connections.
+	 */
+	do {
+		sent = false;
+
+		for (size_t i = 0; i < http_conn_count(client); i++) {
+			struct download_client_conn *conn = &client->conn[i];
+
+			if (!range_request_needed(client, conn)) {
+				continue;
+			}
+
+			err = request_send(client, conn);
+			if (err == -EAGAIN) {
+				continue;
+			} else if (err) {
+				return err;
+			}
+
+			sent = true;
+		}
+	} while (sent);
+
+	return 0;
+}
+
+static char *header_end_find(char *buf, size_t len)
+{
+	static const char end[] = "\r\n\r\n";
+
+	for (size_t i = 0; i + strlen(end) <= len; i++) {
+		if (!memcmp(&buf[i], end, strlen(end))) {
+			return &buf[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Parse "bytes <first>-<last>/<size>" */
+static int content_range_parse(const char *p, size_t *first, size_t *last,
+			       size_t *size)
+{
+	char *q;
+
+	p = strstr(p, "bytes");
+	if (!p) {
+		return -1;
+	}
+
+	*first = strtoul(p + strlen("bytes"), &q, 10);
+	if (*q != '-') {
+		return -1;
+	}
+
+	*last = strtoul(q + 1, &q, 10);
+	if (*q != '/' || *last < *first) {
+		return -1;
+	}
+
+	*size = strtoul(q + 1, NULL, 10);
+
 	return 0;
 }
 
@@ -116,39 +255,46 @@ int http_get_request_send(struct download_client *client)
  *  0 if the header has been fully received
  * -1 on error
  */
-static int http_header_parse(struct download_client *client, size_t *hdr_len)
+static int http_header_parse(struct download_client *client,
+			     struct download_client_conn *conn, size_t *hdr_len)
 {
 	char *p;
 	char *q;
+	size_t first;
+	size_t last;
+	size_t size;
 	unsigned int http_status;
 	const bool using_range_requests =
-		(client->proto == IPPROTO_TLS_1_2 ||
-		 IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_RANGE_REQUESTS) ||
-		 client->progress);
+		(range_requests_used(client) || client->progress);
 
 	const unsigned int expected_status = using_range_requests ? 206 : 200;
 
-	p = strstr(client->buf, "\r\n\r\n");
-	if (!p || p > client->buf + client->offset) {
+	p = header_end_find(conn->buf, conn->offset);
+	if (!p) {
 		/* Waiting full HTTP header */
 		LOG_DBG("Waiting full header in response");
 		return 1;
 	}
 
 	/* Offset of the end of the HTTP header in the buffer */
-	*hdr_len = p + strlen("\r\n\r\n") - client->buf;
+	*hdr_len = p + strlen("\r\n\r\n") - conn->buf;
 
 	LOG_DBG("GET header size: %u", *hdr_len);
 	if (IS_ENABLED(CONFIG_DOWNLOAD_CLIENT_LOG_HEADERS)) {
-		LOG_HEXDUMP_DBG(client->buf, *hdr_len, "HTTP response");
+		LOG_HEXDUMP_DBG(conn->buf, *hdr_len, "HTTP response");
 	}
 
 	for (size_t i = 0; i < *hdr_len; i++) {
-		client->buf[i] = tolower(client->buf[i]);
+		conn->buf[i] = tolower(conn->buf[i]);
 	}
 
+	/* Terminate the header, so that it is searched without
+	 * looking into the payload which follows it.
+	 */
+	conn->buf[*hdr_len - 1] = '\0';
+
 	/* Look for the status code just after "http/1.1 " */
-	p = strstr(client->buf, "http/1.1 ");
+	p = strstr(conn->buf, "http/1.1 ");
 	if (!p) {
 		LOG_ERR("Server response missing HTTP/1.1");
 		return -1;
@@ -163,10 +309,7 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 
 	if (http_status != expected_status) {
 		/* Truncate the server response at the first CR or LF after the
-		 * status and message so we can log it. Normally we can't
-		 * modify the response like this since we'd need to look at
-		 * data beyond this point, but we're already in a failing
-		 * condition.
+		 * status and message so we can log it.
 		 */
 		while ((*q != '\0') && (*q != '\r') && (*q != '\n')) {
 			q++;
@@ -179,68 +322,124 @@ static int http_header_parse(struct download_client *client, size_t *hdr_len)
 
 	/* The file size is returned via "Content-Length" in case of HTTP,
 	 * and via "Content-Range" in case of HTTPS with range requests.
+	 * Responses to range requests also give the position of the payload
+	 * in the file, because pipelined responses may follow each other.
 	 */
-	if (client->file_size == 0) {
-		if (using_range_requests) {
-			p = strstr(client->buf, "content-range");
-			if (!p) {
-				LOG_ERR("Server did not send "
-					"\"Content-Range\" in response");
-				return -1;
-			}
-			p = strstr(p, "/");
-			if (!p) {
-				LOG_ERR("No file size in response");
-				return -1;
-			}
-		} else { /* proto == PROTO_HTTP */
-			p = strstr(client->buf, "content-length");
-			if (!p) {
-				LOG_WRN("Server did not send "
-					"\"Content-Length\" in response");
-					return -1;
-			}
-			p = strstr(p, ":");
-			if (!p) {
-				LOG_ERR("No file size in response");
-				return -1;
-			}
-			/* Accumulate any eventual progress (starting offset)
-			 * when reading the file size from Content-Length
-			 */
-			client->file_size = client->progress;
+	if (using_range_requests) {
+		p = strstr(conn->buf, "content-range");
+		if (!p) {
+			LOG_ERR("Server did not send "
+				"\"Content-Range\" in response");
+			return -1;
+		}
+
+		if (content_range_parse(p, &first, &last, &size)) {
+			LOG_ERR("No file size in response");
+			return -1;
+		}
+
+		conn->http.pos = first;
+		conn->http.body_left = last - first + 1;
+	} else { /* proto == PROTO_HTTP */
+		p = strstr(conn->buf, "content-length");
+		if (!p) {
+			LOG_WRN("Server did not send "
+				"\"Content-Length\" in response");
+			return -1;
+		}
+		p = strstr(p, ":");
+		if (!p) {
+			LOG_ERR("No file size in response");
+			return -1;
 		}
 
-		client->file_size += atoi(p + 1);
+		conn->http.pos = client->progress;
+		conn->http.body_left = atoi(p + 1);
+		/* Accumulate any eventual progress (starting offset)
+		 * when reading the file size from Content-Length
+		 */
+		size = client->progress + conn->http.body_left;
+	}
+
+	if (client->file_size == 0) {
+		client->file_size = size;
 		LOG_DBG("File size = %u", client->file_size);
 	}
 
-	p = strstr(client->buf, "connection: close");
+	p = strstr(conn->buf, "connection: close");
 	if (p) {
 		LOG_WRN("Peer closed connection, will re-connect");
-		client->http.connection_close = true;
+		conn->http.connection_close = true;
 	}
 
-	client->http.has_header = true;
+	conn->http.has_header = true;
 
 	return 0;
 }
 
+size_t http_fragment_len(const struct download_client *client,
+			 const struct download_client_conn *conn)
+{
+	size_t len = MIN(conn->http.body_left, frag_size_get(client));
+
+	if (!conn->http.has_header || conn->offset < len) {
+		return 0;
+	}
+
+	return len;
+}
+
+struct download_client_conn *http_fragment_conn_get(struct download_client *client)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(client->conn); i++) {
+		struct download_client_conn *conn = &client->conn[i];
+
+		if (conn->http.pos == client->progress &&
+		    http_fragment_len(client, conn)) {
+			return conn;
+		}
+	}
+
+	return NULL;
+}
+
+void http_fragment_consume(struct download_client *client,
+			   struct download_client_conn *conn, size_t len)
+{
+	__ASSERT_NO_MSG(len <= MIN(conn->offset, conn->http.body_left));
+
+	/* Move the remaining bytes, which may belong to the
+	 * response to a pipelined request, to the beginning of the buffer.
+	 */
+	conn->offset -= len;
+	memmove(conn->buf, conn->buf + len, conn->offset);
+
+	conn->http.pos += len;
+	conn->http.body_left -= len;
+	client->progress += len;
+
+	if (conn->http.body_left == 0) {
+		conn->http.has_header = false;
+		conn->http.pending--;
+	}
+}
+
 /* Returns:
  *  1 if more data is expected
  *  0 if a whole fragment has been received
  * -1 on error
  */
-int http_parse(struct download_client *client, size_t len)
+int http_parse(struct download_client *client,
+	       struct download_client_conn *conn, size_t len)
 {
 	int rc;
 	size_t hdr_len;
 
 	/* Accumulate buffer offset */
-	client->offset += len;
+	conn->offset += len;
 
-	if (!client->http.has_header) {
-		rc = http_header_parse(client, &hdr_len);
+	if (!conn->http.has_header) {
+		rc = http_header_parse(client, conn, &hdr_len);
 		if (rc > 0) {
 			/* Wait for header */
 			return 1;
@@ -250,39 +449,14 @@ int http_parse(struct download_client *client, size_t len)
 			return -1;
 		}
 
-		if (client->offset != hdr_len) {
-			/* The buffer contains some payload bytes,
-			 * copy them at the beginning of the buffer
-			 * and update the offset.
-			 */
-			LOG_DBG("Copying %u payload bytes",
-				client->offset - hdr_len);
-			memcpy(client->buf, client->buf + hdr_len,
-			       client->offset - hdr_len);
-
-			client->offset -= hdr_len;
-		} else {
-			/* Reset the offset.
-			 * The payload is received in an empty buffer.
-			 */
-			client->offset = 0;
-		}
+		/* Move any payload bytes at the beginning of the buffer */
+		LOG_DBG("Copying %u payload bytes", conn->offset - hdr_len);
+		memmove(conn->buf, conn->buf + hdr_len, conn->offset - hdr_len);
+		conn->offset -= hdr_len;
 	}
 
-	/* Accumulate overall file progress.
-	 * If the last recv() call read an HTTP header,
-	 * `offset` has been moved at the end of any trailing
-	 * payload bytes by http_header_parse(). In this case,
-	 * `offset` is less than `len` and it represents
-	 * the actual payload bytes.
-	 */
-	client->progress += MIN(client->offset, len);
-
-	/* Have we received a whole fragment or the whole file? */
-	if (client->progress != client->file_size &&
-	    client->offset < (client->config.frag_size_override != 0 ?
-			      client->config.frag_size_override :
-			      CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE)) {
+	/* Have we received a whole fragment or the rest of the response? */
+	if (!http_fragment_len(client, conn)) {
 		return 1;
 	}
 
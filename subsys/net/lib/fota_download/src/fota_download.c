@@ -480,7 +480,7 @@ int fota_download_cancel(void)
 
 	downloading = false;
 
-	if (dlc.fd == -1) {
+	if (!download_client_is_connected(&dlc)) {
 		/* Download not started, aborted or completed */
 		LOG_WRN("%s invalid state", __func__);
 		return -EAGAIN;
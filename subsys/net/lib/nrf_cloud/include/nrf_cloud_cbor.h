@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_CLOUD_CBOR_H__
+#define NRF_CLOUD_CBOR_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <modem/lte_lc.h>
+#include <net/nrf_cloud.h>
+#include <net/nrf_cloud_cell_pos.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Size of an encoded sensor data message.
+ *
+ * @param[in] app_id   App ID of the sensor.
+ * @param[in] data_len Length of the sensor data.
+ */
+size_t nrf_cloud_cbor_sensor_msg_size(const char *app_id, size_t data_len);
+
+/**
+ * @brief Encode a sensor data device message.
+ *
+ * @param[in]  app_id   App ID of the sensor.
+ * @param[in]  data     Sensor data, not necessarily NULL-terminated.
+ * @param[in]  data_len Length of the sensor data.
+ * @param[out] buf      Output buffer.
+ * @param[in]  buf_len  Size of the output buffer.
+ * @param[out] out_len  Length of the encoded message.
+ *
+ * @retval 0 If successful.
+ * @retval -ENOMEM If the buffer is too small.
+ */
+int nrf_cloud_cbor_sensor_msg_encode(const char *app_id, const char *data, size_t data_len,
+				     uint8_t *buf, size_t buf_len, size_t *out_len);
+
+/** @brief Maximum size of an encoded cellular positioning request. */
+size_t nrf_cloud_cbor_cell_pos_req_size_max(const struct lte_lc_cells_info *inf);
+
+/**
+ * @brief Encode a cellular positioning request device message.
+ *
+ * @param[in] request_loc If false, nRF Cloud is asked not to send the location
+ *                        to the device.
+ *
+ * @retval 0 If successful.
+ * @retval -ENOMEM If the buffer is too small, or out of memory.
+ * @retval -EINVAL If the neighbor cell information is missing, or there are
+ *                 more than 17 neighbor cells.
+ */
+int nrf_cloud_cbor_cell_pos_req_encode(const struct lte_lc_cells_info *inf, bool request_loc,
+				       uint8_t *buf, size_t buf_len, size_t *out_len);
+
+/**
+ * @brief Decode a cellular positioning response.
+ *
+ * @return Same values as nrf_cloud_parse_cell_pos_response():
+ *         0 if a location was found, 1 if the message is not a cellular
+ *         positioning response, -EFAULT if nRF Cloud returned an error,
+ *         -EBADMSG if the message is malformed.
+ */
+int nrf_cloud_cbor_cell_pos_resp_decode(const uint8_t *buf, size_t len,
+					struct nrf_cloud_cell_pos_result *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_CLOUD_CBOR_H__ */
@@ -126,10 +126,23 @@ extern "C" {
 /**@brief Initialize the codec used encoding the data to the cloud. */
 int nrf_cloud_codec_init(void);
 
-/**@brief Encode the sensor data based on the indicated type. */
+/**@brief Encode the sensor data based on the indicated type, as JSON, or
+ * as CBOR if CONFIG_NRF_CLOUD_CBOR is enabled.
+ * If successful, memory is allocated for the output and the user is
+ * responsible for freeing it using @ref nrf_cloud_free.
+ */
 int nrf_cloud_encode_sensor_data(const struct nrf_cloud_sensor_data *input,
 				 struct nrf_cloud_data *output);
 
+/**@brief Encode the sensor data based on the indicated type into the provided buffer,
+ * without allocating memory. If @p buf is NULL, only the length of the output is computed.
+ *
+ * @return Length of the output, not including the terminating NULL character,
+ *         or -ENOMEM if the buffer is too small.
+ */
+int nrf_cloud_encode_sensor_data_buf(const struct nrf_cloud_sensor_data *input,
+				     char *buf, size_t buf_len);
+
 /**@brief Encode the sensor data to be sent to the device shadow. */
 int nrf_cloud_encode_shadow_data(const struct nrf_cloud_sensor_data *sensor,
 				 struct nrf_cloud_data *output);
@@ -185,11 +198,21 @@ int nrf_cloud_json_add_modem_info(cJSON * const data_obj);
 
 /** @brief Builds a cellular positioning request string using the provided cell info.
  * If successful, memory will be allocated for the output string and the user is
- * responsible for freeing it using @ref cJSON_free.
+ * responsible for freeing it using @ref nrf_cloud_free.
  */
 int nrf_cloud_format_cell_pos_req(struct lte_lc_cells_info const *const inf,
 				  size_t inf_cnt, char **string_out);
 
+/** @brief Builds a cellular positioning request string using the provided cell info
+ * into the provided buffer, without allocating memory. If @p buf is NULL, only the
+ * length of the output is computed.
+ *
+ * @return Length of the output, not including the terminating NULL character,
+ *         or a negative error code.
+ */
+int nrf_cloud_format_cell_pos_req_buf(struct lte_lc_cells_info const *const inf,
+				      size_t inf_cnt, char *buf, size_t buf_len);
+
 /** @brief Builds a cellular positioning request in the provided cJSON object
  * using the provided cell info
  */
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_CLOUD_JSON_WRITER_H__
+#define NRF_CLOUD_JSON_WRITER_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <modem/lte_lc.h>
+#include <net/nrf_cloud.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum nesting depth of objects and arrays. */
+#define NRF_CLOUD_JSON_WRITER_DEPTH_MAX 32
+
+/**
+ * @brief Writer serializing JSON directly into a buffer, without allocating
+ * memory. The output is the same as the one of cJSON_PrintUnformatted() for
+ * the same object.
+ *
+ * Errors are kept in the writer, so that a message can be written without
+ * checking the result of every call, and checked with
+ * @ref nrf_cloud_json_writer_finish.
+ */
+struct nrf_cloud_json_writer {
+	/** Output buffer, or NULL to only compute the length of the output. */
+	char *buf;
+	/** Size of the output buffer. */
+	size_t size;
+	/** Length of the output. */
+	size_t len;
+	/** First error, if any. */
+	int err;
+	/** Nesting depth of the current object or array. */
+	uint8_t depth;
+	/** Bit n is set if the object or array at depth n has members. */
+	uint32_t has_members;
+};
+
+/**
+ * @brief Initialize a writer.
+ *
+ * @param[out] writer Writer.
+ * @param[in]  buf    Output buffer, or NULL to only compute the length of the output.
+ * @param[in]  size   Size of the output buffer, including the terminating NULL character.
+ */
+void nrf_cloud_json_writer_init(struct nrf_cloud_json_writer *writer, char *buf, size_t size);
+
+/**
+ * @brief Terminate the output with a NULL character.
+ *
+ * @return Length of the output, not including the terminating NULL character,
+ *         or a negative error code:
+ *         -ENOMEM if the output does not fit in the buffer,
+ *         -E2BIG if objects and arrays are nested too deeply,
+ *         -EINVAL if objects and arrays are not closed.
+ */
+int nrf_cloud_json_writer_finish(struct nrf_cloud_json_writer *writer);
+
+/**
+ * @brief Start an object.
+ *
+ * @param[in] key Key of the object in the enclosing object, or NULL for the
+ *                root object or an array element.
+ */
+void nrf_cloud_json_obj_start(struct nrf_cloud_json_writer *writer, const char *key);
+
+/** @brief End the current object. */
+void nrf_cloud_json_obj_end(struct nrf_cloud_json_writer *writer);
+
+/** @brief Start an array. See @ref nrf_cloud_json_obj_start. */
+void nrf_cloud_json_arr_start(struct nrf_cloud_json_writer *writer, const char *key);
+
+/** @brief End the current array. */
+void nrf_cloud_json_arr_end(struct nrf_cloud_json_writer *writer);
+
+/** @brief Add a string. A NULL string is written as an empty string, as cJSON does. */
+void nrf_cloud_json_str_add(struct nrf_cloud_json_writer *writer, const char *key,
+			    const char *str);
+
+/** @brief Add a number, formatted as cJSON does. */
+void nrf_cloud_json_num_add(struct nrf_cloud_json_writer *writer, const char *key, double num);
+
+/**
+ * @brief Write a sensor data device message, as an object.
+ *
+ * @param[in] app_id App ID of the sensor.
+ * @param[in] data   NULL-terminated sensor data.
+ */
+void nrf_cloud_json_sensor_msg_write(struct nrf_cloud_json_writer *writer,
+				     const char *app_id, const char *data);
+
+/**
+ * @brief Write a GNSS device message, as an object.
+ *
+ * @retval 0 If the message is written, or the writer has failed.
+ * @retval -EINVAL If NMEA data is missing.
+ * @retval -EFBIG If the NMEA sentence is too long.
+ * @retval -EFTYPE If the GNSS data type is not supported.
+ */
+int nrf_cloud_json_gnss_msg_write(struct nrf_cloud_json_writer *writer,
+				  const struct nrf_cloud_gnss_data *gnss);
+
+/**
+ * @brief Write the LTE cell information of a cellular positioning request,
+ *        as the "lte" array member of the current object.
+ */
+void nrf_cloud_json_cell_pos_lte_write(struct nrf_cloud_json_writer *writer,
+				       const struct lte_lc_cells_info *inf, size_t inf_cnt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_CLOUD_JSON_WRITER_H__ */
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Generated using zcbor version 0.5.1
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 128
+ */
+
+#ifndef NRF_CLOUD_MSG_DECODE_H__
+#define NRF_CLOUD_MSG_DECODE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_decode.h"
+#include "nrf_cloud_msg_decode_types.h"
+
+#if DEFAULT_MAX_QTY != 128
+#error "The type file was generated with a different default_max_qty than this file"
+#endif
+
+int cbor_decode_Cell_pos_resp(const uint8_t *payload, size_t payload_len,
+			      struct Cell_pos_resp *result, size_t *payload_len_out);
+
+#endif /* NRF_CLOUD_MSG_DECODE_H__ */
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Generated using zcbor version 0.5.1
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 128
+ */
+
+#ifndef NRF_CLOUD_MSG_DECODE_TYPES_H__
+#define NRF_CLOUD_MSG_DECODE_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_decode.h"
+
+/** Which value for --default-max-qty this file was created with.
+ *
+ *  The define is used in the other generated file to do a build-time
+ *  compatibility check.
+ *
+ *  See `zcbor --help` for more information about --default-max-qty
+ */
+#define DEFAULT_MAX_QTY 128
+
+struct Cell_pos_result_res_fulfilled_with {
+	struct zcbor_string _Cell_pos_result_res_fulfilled_with;
+};
+
+struct Cell_pos_result {
+	double _Cell_pos_result_res_lat;
+	double _Cell_pos_result_res_lon;
+	uint32_t _Cell_pos_result_res_unc;
+	struct Cell_pos_result_res_fulfilled_with _Cell_pos_result_res_fulfilled_with;
+	uint_fast32_t _Cell_pos_result_res_fulfilled_with_present;
+};
+
+struct Cell_pos_resp {
+	union {
+		struct Cell_pos_result _Cell_pos_resp_data;
+		int32_t _Cell_pos_resp_err;
+	};
+	enum {
+		_Cell_pos_resp_data,
+		_Cell_pos_resp_err,
+	} _Cell_pos_resp_union_choice;
+};
+
+#endif /* NRF_CLOUD_MSG_DECODE_TYPES_H__ */
@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Generated using zcbor version 0.5.1
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 128
+ */
+
+#ifndef NRF_CLOUD_MSG_ENCODE_H__
+#define NRF_CLOUD_MSG_ENCODE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_encode.h"
+#include "nrf_cloud_msg_encode_types.h"
+
+#if DEFAULT_MAX_QTY != 128
+#error "The type file was generated with a different default_max_qty than this file"
+#endif
+
+int cbor_encode_Sensor_msg(uint8_t *payload, size_t payload_len, const struct Sensor_msg *input,
+			   size_t *payload_len_out);
+
+int cbor_encode_Gnss_msg(uint8_t *payload, size_t payload_len, const struct Gnss_msg *input,
+			 size_t *payload_len_out);
+
+int cbor_encode_Cell_pos_req(uint8_t *payload, size_t payload_len,
+			     const struct Cell_pos_req *input, size_t *payload_len_out);
+
+#endif /* NRF_CLOUD_MSG_ENCODE_H__ */
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Generated using zcbor version 0.5.1
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 128
+ */
+
+#ifndef NRF_CLOUD_MSG_ENCODE_TYPES_H__
+#define NRF_CLOUD_MSG_ENCODE_TYPES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_encode.h"
+
+/** Which value for --default-max-qty this file was created with.
+ *
+ *  The define is used in the other generated file to do a build-time
+ *  compatibility check.
+ *
+ *  See `zcbor --help` for more information about --default-max-qty
+ */
+#define DEFAULT_MAX_QTY 128
+
+struct Sensor_msg {
+	struct zcbor_string _Sensor_msg_app_id;
+	struct zcbor_string _Sensor_msg_data;
+};
+
+struct Gnss_msg_ts {
+	uint64_t _Gnss_msg_ts;
+};
+
+struct Pvt_pvt_alt {
+	float _Pvt_pvt_alt;
+};
+
+struct Pvt_pvt_spd {
+	float _Pvt_pvt_spd;
+};
+
+struct Pvt_pvt_hdg {
+	float _Pvt_pvt_hdg;
+};
+
+struct Pvt {
+	double _Pvt_pvt_lng;
+	double _Pvt_pvt_lat;
+	float _Pvt_pvt_acc;
+	struct Pvt_pvt_alt _Pvt_pvt_alt;
+	uint_fast32_t _Pvt_pvt_alt_present;
+	struct Pvt_pvt_spd _Pvt_pvt_spd;
+	uint_fast32_t _Pvt_pvt_spd_present;
+	struct Pvt_pvt_hdg _Pvt_pvt_hdg;
+	uint_fast32_t _Pvt_pvt_hdg_present;
+};
+
+struct Gnss_msg {
+	struct Gnss_msg_ts _Gnss_msg_ts;
+	uint_fast32_t _Gnss_msg_ts_present;
+	union {
+		struct Pvt _Gnss_msg_data_Pvt;
+		struct zcbor_string _Gnss_msg_data_tstr;
+	};
+	enum {
+		_Gnss_msg_data_Pvt,
+		_Gnss_msg_data_tstr,
+	} _Gnss_msg_data_choice;
+};
+
+struct Lte_cell_cell_earfcn {
+	uint32_t _Lte_cell_cell_earfcn;
+};
+
+struct Lte_cell_cell_rsrp {
+	int32_t _Lte_cell_cell_rsrp;
+};
+
+struct Lte_cell_cell_rsrq {
+	float _Lte_cell_cell_rsrq;
+};
+
+struct Lte_cell_cell_adv {
+	uint32_t _Lte_cell_cell_adv;
+};
+
+struct Ncell_ncell_rsrp {
+	int32_t _Ncell_ncell_rsrp;
+};
+
+struct Ncell_ncell_rsrq {
+	float _Ncell_ncell_rsrq;
+};
+
+struct Ncell {
+	uint32_t _Ncell_ncell_earfcn;
+	uint32_t _Ncell_ncell_pci;
+	struct Ncell_ncell_rsrp _Ncell_ncell_rsrp;
+	uint_fast32_t _Ncell_ncell_rsrp_present;
+	struct Ncell_ncell_rsrq _Ncell_ncell_rsrq;
+	uint_fast32_t _Ncell_ncell_rsrq_present;
+};
+
+struct Lte_cell_cell_nmr {
+	struct Ncell _Lte_cell_cell_nmr_Ncell[17];
+	uint_fast32_t _Lte_cell_cell_nmr_Ncell_count;
+};
+
+struct Lte_cell {
+	uint32_t _Lte_cell_cell_eci;
+	uint32_t _Lte_cell_cell_mcc;
+	uint32_t _Lte_cell_cell_mnc;
+	uint32_t _Lte_cell_cell_tac;
+	struct Lte_cell_cell_earfcn _Lte_cell_cell_earfcn;
+	uint_fast32_t _Lte_cell_cell_earfcn_present;
+	struct Lte_cell_cell_rsrp _Lte_cell_cell_rsrp;
+	uint_fast32_t _Lte_cell_cell_rsrp_present;
+	struct Lte_cell_cell_rsrq _Lte_cell_cell_rsrq;
+	uint_fast32_t _Lte_cell_cell_rsrq_present;
+	struct Lte_cell_cell_adv _Lte_cell_cell_adv;
+	uint_fast32_t _Lte_cell_cell_adv_present;
+	struct Lte_cell_cell_nmr _Lte_cell_cell_nmr;
+	uint_fast32_t _Lte_cell_cell_nmr_present;
+};
+
+struct Cell_pos_req_data_req_do_reply {
+	bool _Cell_pos_req_data_req_do_reply;
+};
+
+struct Cell_pos_req_data {
+	struct Lte_cell _Cell_pos_req_data_req_lte_Lte_cell;
+	struct Cell_pos_req_data_req_do_reply _Cell_pos_req_data_req_do_reply;
+	uint_fast32_t _Cell_pos_req_data_req_do_reply_present;
+};
+
+struct Cell_pos_req {
+	struct Cell_pos_req_data _Cell_pos_req_data;
+};
+
+#endif /* NRF_CLOUD_MSG_ENCODE_TYPES_H__ */
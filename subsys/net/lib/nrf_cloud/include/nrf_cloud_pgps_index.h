@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_CLOUD_PGPS_INDEX_H_
+#define NRF_CLOUD_PGPS_INDEX_H_
+
+#include <zephyr/kernel.h>
+#include <net/nrf_cloud_pgps.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Checks the format of a stored prediction; returns 0 if it is usable. */
+typedef int (*npgps_index_check_t)(const struct nrf_cloud_pgps_prediction *p);
+
+/* In-RAM index of stored predictions, in time order. Prediction number 0 is
+ * the oldest stored prediction. The GPS time of each prediction is read from
+ * flash once, when the prediction is first looked up, so later lookups do not
+ * access flash.
+ */
+void npgps_index_reset(void);
+struct nrf_cloud_pgps_prediction *npgps_index_get(int pnum);
+void npgps_index_set(int pnum, struct nrf_cloud_pgps_prediction *p);
+void npgps_index_discard(int num, int count);
+int npgps_index_find(int pnum, int64_t gps_sec, uint32_t window_sec,
+		     npgps_index_check_t check,
+		     struct nrf_cloud_pgps_prediction **prediction);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_CLOUD_PGPS_INDEX_H_ */
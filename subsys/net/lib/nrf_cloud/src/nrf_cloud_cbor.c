@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zcbor_decode.h>
+#include <modem/modem_info.h>
+
+#include "nrf_cloud_codec.h"
+#include "nrf_cloud_cbor.h"
+#include "nrf_cloud_mem.h"
+#include "nrf_cloud_msg_encode.h"
+#include "nrf_cloud_msg_decode.h"
+
+LOG_MODULE_REGISTER(nrf_cloud_cbor, CONFIG_NRF_CLOUD_LOG_LEVEL);
+
+/* Encoded sizes, see cddl/nrf_cloud_msg.cddl */
+#define CBOR_CONTAINER_SIZE_MAX		2
+#define CBOR_CELL_POS_REQ_SIZE_MAX	32
+#define CBOR_CELL_SIZE_MAX		56
+#define CBOR_NCELL_SIZE_MAX		24
+
+/* Keys of the device message map */
+#define CBOR_KEY_APPID		1
+#define CBOR_KEY_MSG_TYPE	2
+
+#define ZSTR(s) ((struct zcbor_string){ .value = (const uint8_t *)(s), .len = strlen(s) })
+
+/* Size of the head of a CBOR data item */
+static size_t head_size(size_t value)
+{
+	if (value < 24) {
+		return 1;
+	} else if (value <= UINT8_MAX) {
+		return 2;
+	} else if (value <= UINT16_MAX) {
+		return 3;
+	}
+
+	return 5;
+}
+
+static int encode_result(int err)
+{
+	if (err != ZCBOR_SUCCESS) {
+		LOG_DBG("Failed to encode CBOR message: %d", err);
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+static bool zstr_equal(const struct zcbor_string *zstr, const char *str)
+{
+	return (zstr->len == strlen(str)) && !memcmp(zstr->value, str, zstr->len);
+}
+
+size_t nrf_cloud_cbor_sensor_msg_size(const char *app_id, size_t data_len)
+{
+	size_t app_id_len = strlen(app_id);
+	size_t msg_type_len = strlen(NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+
+	return CBOR_CONTAINER_SIZE_MAX +
+	       1 + head_size(app_id_len) + app_id_len +
+	       1 + head_size(msg_type_len) + msg_type_len +
+	       1 + head_size(data_len) + data_len;
+}
+
+int nrf_cloud_cbor_sensor_msg_encode(const char *app_id, const char *data, size_t data_len,
+				     uint8_t *buf, size_t buf_len, size_t *out_len)
+{
+	__ASSERT_NO_MSG(app_id != NULL);
+	__ASSERT_NO_MSG(data != NULL);
+
+	struct Sensor_msg msg = {
+		._Sensor_msg_app_id = ZSTR(app_id),
+		._Sensor_msg_data = {
+			.value = (const uint8_t *)data,
+			.len = data_len
+		}
+	};
+
+	return encode_result(cbor_encode_Sensor_msg(buf, buf_len, &msg, out_len));
+}
+
+static void pvt_set(struct Pvt *out, const struct nrf_cloud_gnss_pvt *pvt)
+{
+	out->_Pvt_pvt_lng = pvt->lon;
+	out->_Pvt_pvt_lat = pvt->lat;
+	out->_Pvt_pvt_acc = pvt->accuracy;
+	out->_Pvt_pvt_alt._Pvt_pvt_alt = pvt->alt;
+	out->_Pvt_pvt_alt_present = pvt->has_alt;
+	out->_Pvt_pvt_spd._Pvt_pvt_spd = pvt->speed;
+	out->_Pvt_pvt_spd_present = pvt->has_speed;
+	out->_Pvt_pvt_hdg._Pvt_pvt_hdg = pvt->heading;
+	out->_Pvt_pvt_hdg_present = pvt->has_heading;
+}
+
+int nrf_cloud_gnss_msg_cbor_encode(const struct nrf_cloud_gnss_data *const gnss,
+				   uint8_t *buf, size_t buf_len, size_t *out_len)
+{
+	__ASSERT_NO_MSG(gnss != NULL);
+
+	const struct nrf_cloud_gnss_pvt *pvt = NULL;
+	const char *nmea = NULL;
+	struct Gnss_msg msg = { 0 };
+#if defined(CONFIG_NRF_MODEM)
+	struct nrf_cloud_gnss_pvt mdm_pvt;
+#endif
+
+	switch (gnss->type) {
+	case NRF_CLOUD_GNSS_TYPE_PVT:
+		pvt = &gnss->pvt;
+		break;
+	case NRF_CLOUD_GNSS_TYPE_MODEM_PVT:
+#if defined(CONFIG_NRF_MODEM)
+		if (!gnss->mdm_pvt) {
+			return -EINVAL;
+		}
+
+		mdm_pvt = (struct nrf_cloud_gnss_pvt) {
+			.lon =		gnss->mdm_pvt->longitude,
+			.lat =		gnss->mdm_pvt->latitude,
+			.accuracy =	gnss->mdm_pvt->accuracy,
+			.alt =		gnss->mdm_pvt->altitude,
+			.has_alt =	1,
+			.speed =	gnss->mdm_pvt->speed,
+			.has_speed =	1,
+			.heading =	gnss->mdm_pvt->heading,
+			.has_heading =	1
+		};
+		pvt = &mdm_pvt;
+		break;
+#else
+		return -EFTYPE;
+#endif
+	case NRF_CLOUD_GNSS_TYPE_MODEM_NMEA:
+#if defined(CONFIG_NRF_MODEM)
+		if (gnss->mdm_nmea) {
+			nmea = gnss->mdm_nmea->nmea_str;
+		}
+#endif
+		break;
+	case NRF_CLOUD_GNSS_TYPE_NMEA:
+		nmea = gnss->nmea.sentence;
+		break;
+	default:
+		return -EFTYPE;
+	}
+
+	if (pvt) {
+		msg._Gnss_msg_data_choice = _Gnss_msg_data_Pvt;
+		pvt_set(&msg._Gnss_msg_data_Pvt, pvt);
+	} else {
+		if (nmea == NULL) {
+			return -EINVAL;
+		}
+
+		if (memchr(nmea, '\0', NRF_MODEM_GNSS_NMEA_MAX_LEN) == NULL) {
+			return -EFBIG;
+		}
+
+		msg._Gnss_msg_data_choice = _Gnss_msg_data_tstr;
+		msg._Gnss_msg_data_tstr = ZSTR(nmea);
+	}
+
+	if (gnss->ts_ms > NRF_CLOUD_NO_TIMESTAMP) {
+		msg._Gnss_msg_ts._Gnss_msg_ts = (uint64_t)gnss->ts_ms;
+		msg._Gnss_msg_ts_present = true;
+	}
+
+	return encode_result(cbor_encode_Gnss_msg(buf, buf_len, &msg, out_len));
+}
+
+size_t nrf_cloud_cbor_cell_pos_req_size_max(const struct lte_lc_cells_info *inf)
+{
+	__ASSERT_NO_MSG(inf != NULL);
+
+	return CBOR_CELL_POS_REQ_SIZE_MAX + CBOR_CELL_SIZE_MAX +
+	       inf->ncells_count * CBOR_NCELL_SIZE_MAX;
+}
+
+static void ncell_set(struct Ncell *out, const struct lte_lc_ncell *ncell)
+{
+	out->_Ncell_ncell_earfcn = ncell->earfcn;
+	out->_Ncell_ncell_pci = ncell->phys_cell_id;
+
+	if (ncell->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP) {
+		out->_Ncell_ncell_rsrp._Ncell_ncell_rsrp = RSRP_IDX_TO_DBM(ncell->rsrp);
+		out->_Ncell_ncell_rsrp_present = true;
+	}
+
+	if (ncell->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ) {
+		out->_Ncell_ncell_rsrq._Ncell_ncell_rsrq = RSRQ_IDX_TO_DB(ncell->rsrq);
+		out->_Ncell_ncell_rsrq_present = true;
+	}
+}
+
+static void cell_set(struct Lte_cell *out, const struct lte_lc_cells_info *inf)
+{
+	const struct lte_lc_cell *cell = &inf->current_cell;
+
+	out->_Lte_cell_cell_eci = cell->id;
+	out->_Lte_cell_cell_mcc = cell->mcc;
+	out->_Lte_cell_cell_mnc = cell->mnc;
+	out->_Lte_cell_cell_tac = cell->tac;
+
+	if (cell->earfcn != NRF_CLOUD_CELL_POS_OMIT_EARFCN) {
+		out->_Lte_cell_cell_earfcn._Lte_cell_cell_earfcn = cell->earfcn;
+		out->_Lte_cell_cell_earfcn_present = true;
+	}
+
+	if (cell->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP) {
+		out->_Lte_cell_cell_rsrp._Lte_cell_cell_rsrp = RSRP_IDX_TO_DBM(cell->rsrp);
+		out->_Lte_cell_cell_rsrp_present = true;
+	}
+
+	if (cell->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ) {
+		out->_Lte_cell_cell_rsrq._Lte_cell_cell_rsrq = RSRQ_IDX_TO_DB(cell->rsrq);
+		out->_Lte_cell_cell_rsrq_present = true;
+	}
+
+	if (cell->timing_advance != NRF_CLOUD_CELL_POS_OMIT_TIME_ADV) {
+		out->_Lte_cell_cell_adv._Lte_cell_cell_adv =
+			MIN(cell->timing_advance, NRF_CLOUD_CELL_POS_TIME_ADV_MAX);
+		out->_Lte_cell_cell_adv_present = true;
+	}
+
+	if (inf->ncells_count) {
+		struct Lte_cell_cell_nmr *nmr = &out->_Lte_cell_cell_nmr;
+
+		for (size_t i = 0; i < inf->ncells_count; i++) {
+			ncell_set(&nmr->_Lte_cell_cell_nmr_Ncell[i], &inf->neighbor_cells[i]);
+		}
+
+		nmr->_Lte_cell_cell_nmr_Ncell_count = inf->ncells_count;
+		out->_Lte_cell_cell_nmr_present = true;
+	}
+}
+
+int nrf_cloud_cbor_cell_pos_req_encode(const struct lte_lc_cells_info *inf, bool request_loc,
+				       uint8_t *buf, size_t buf_len, size_t *out_len)
+{
+	__ASSERT_NO_MSG(inf != NULL);
+
+	struct Cell_pos_req *req;
+	struct Cell_pos_req_data *data;
+	int err;
+
+	if (inf->ncells_count && !inf->neighbor_cells) {
+		LOG_WRN("Neighbor cell count is %d, but buffer is NULL",
+			inf->ncells_count);
+		return -EINVAL;
+	}
+
+	if (inf->ncells_count >
+	    ARRAY_SIZE(req->_Cell_pos_req_data._Cell_pos_req_data_req_lte_Lte_cell
+			       ._Lte_cell_cell_nmr._Lte_cell_cell_nmr_Ncell)) {
+		LOG_WRN("Too many neighbor cells: %d", inf->ncells_count);
+		return -EINVAL;
+	}
+
+	/* Room for all the neighbor cells, too large for the stack */
+	req = nrf_cloud_calloc(1, sizeof(*req));
+	if (!req) {
+		return -ENOMEM;
+	}
+
+	data = &req->_Cell_pos_req_data;
+	cell_set(&data->_Cell_pos_req_data_req_lte_Lte_cell, inf);
+
+	/* By default, nRF Cloud will send the location to the device */
+	if (!request_loc) {
+		data->_Cell_pos_req_data_req_do_reply._Cell_pos_req_data_req_do_reply = false;
+		data->_Cell_pos_req_data_req_do_reply_present = true;
+	}
+
+	err = encode_result(cbor_encode_Cell_pos_req(buf, buf_len, req, out_len));
+	nrf_cloud_free(req);
+
+	return err;
+}
+
+/* Checks the header of the message, without decoding the rest of it */
+static bool is_cell_pos_msg(const uint8_t *buf, size_t len)
+{
+	ZCBOR_STATE_D(states, 1, buf, len, 1);
+	struct zcbor_string app_id = ZSTR(NRF_CLOUD_JSON_APPID_VAL_CELL_POS);
+	struct zcbor_string msg_type = ZSTR(NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+
+	return zcbor_map_start_decode(states) &&
+	       zcbor_uint32_expect(states, CBOR_KEY_APPID) &&
+	       zcbor_tstr_expect(states, &app_id) &&
+	       zcbor_uint32_expect(states, CBOR_KEY_MSG_TYPE) &&
+	       zcbor_tstr_expect(states, &msg_type);
+}
+
+static void cell_pos_result_get(const struct Cell_pos_result *data,
+				struct nrf_cloud_cell_pos_result *result)
+{
+	const struct zcbor_string *type =
+		&data->_Cell_pos_result_res_fulfilled_with._Cell_pos_result_res_fulfilled_with;
+
+	result->lat = data->_Cell_pos_result_res_lat;
+	result->lon = data->_Cell_pos_result_res_lon;
+	result->unc = data->_Cell_pos_result_res_unc;
+	result->type = CELL_POS_TYPE__INVALID;
+
+	if (!data->_Cell_pos_result_res_fulfilled_with_present) {
+		LOG_WRN("Cellular positioning type not found in message");
+	} else if (zstr_equal(type, NRF_CLOUD_CELL_POS_TYPE_VAL_MCELL)) {
+		result->type = CELL_POS_TYPE_MULTI;
+	} else if (zstr_equal(type, NRF_CLOUD_CELL_POS_TYPE_VAL_SCELL)) {
+		result->type = CELL_POS_TYPE_SINGLE;
+	} else {
+		LOG_WRN("Unhandled cellular positioning type: %.*s",
+			(int)type->len, type->value);
+	}
+}
+
+int nrf_cloud_cbor_cell_pos_resp_decode(const uint8_t *buf, size_t len,
+					struct nrf_cloud_cell_pos_result *result)
+{
+	struct Cell_pos_resp resp;
+	int err;
+
+	if ((buf == NULL) || (result == NULL)) {
+		return -EINVAL;
+	}
+
+	if (!is_cell_pos_msg(buf, len)) {
+		/* Not a cellular positioning data message */
+		return 1;
+	}
+
+	result->err = NRF_CLOUD_ERROR_NONE;
+
+	err = cbor_decode_Cell_pos_resp(buf, len, &resp, NULL);
+	if (err != ZCBOR_SUCCESS) {
+		LOG_ERR("Failed to parse cellular positioning message: %d", err);
+		err = -EBADMSG;
+	} else if (resp._Cell_pos_resp_union_choice == _Cell_pos_resp_err) {
+		/* Indicate that an nRF Cloud error code was found */
+		result->err = (enum nrf_cloud_error)resp._Cell_pos_resp_err;
+		err = -EFAULT;
+	} else {
+		cell_pos_result_get(&resp._Cell_pos_resp_data, result);
+		return 0;
+	}
+
+	/* Clear data on error */
+	result->lat = 0.0;
+	result->lon = 0.0;
+	result->unc = 0;
+	result->type = CELL_POS_TYPE__INVALID;
+
+	/* Set to unknown error if an error code was not found */
+	if (result->err == NRF_CLOUD_ERROR_NONE) {
+		result->err = NRF_CLOUD_ERROR_UNKNOWN;
+	}
+
+	return err;
+}
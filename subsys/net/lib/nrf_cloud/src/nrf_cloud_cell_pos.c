@@ -23,10 +23,130 @@ int nrf_cloud_cell_pos_request_json_get(const struct lte_lc_cells_info *const ce
 					const bool request_loc, cJSON **req_obj_out);
 
 #include "nrf_cloud_codec.h"
+#include "nrf_cloud_json_writer.h"
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+#include "nrf_cloud_cbor.h"
+#endif
+#include "nrf_cloud_mem.h"
 #include "nrf_cloud_transport.h"
 
 #define CELL_POS_JSON_CELL_LOC_KEY_DOREPLY	"doReply"
 
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+static int cell_pos_request_encode(const struct lte_lc_cells_info *const cells_inf,
+				   const bool request_loc, void **buf_out, size_t *len_out)
+{
+	size_t size = nrf_cloud_cbor_cell_pos_req_size_max(cells_inf);
+	uint8_t *buf;
+	int err;
+
+	buf = nrf_cloud_malloc(size);
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	err = nrf_cloud_cbor_cell_pos_req_encode(cells_inf, request_loc, buf, size, len_out);
+	if (err) {
+		nrf_cloud_free(buf);
+		return err;
+	}
+
+	*buf_out = buf;
+
+	return 0;
+}
+#else
+/* Same request as the one of nrf_cloud_cell_pos_request_json_get(),
+ * written without building a cJSON object.
+ */
+static int cell_pos_request_write(const struct lte_lc_cells_info *const cells_inf,
+				  const bool request_loc, char *buf, size_t buf_len)
+{
+	struct nrf_cloud_json_writer writer;
+
+	nrf_cloud_json_writer_init(&writer, buf, buf_len);
+
+	nrf_cloud_json_obj_start(&writer, NULL);
+	nrf_cloud_json_str_add(&writer, NRF_CLOUD_JSON_APPID_KEY,
+			       NRF_CLOUD_JSON_APPID_VAL_CELL_POS);
+	nrf_cloud_json_str_add(&writer, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+			       NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+
+	nrf_cloud_json_obj_start(&writer, NRF_CLOUD_JSON_DATA_KEY);
+	nrf_cloud_json_cell_pos_lte_write(&writer, cells_inf, 1);
+
+	/* By default, nRF Cloud will send the location to the device */
+	if (!request_loc) {
+		nrf_cloud_json_num_add(&writer, CELL_POS_JSON_CELL_LOC_KEY_DOREPLY, 0);
+	}
+
+	nrf_cloud_json_obj_end(&writer);
+	nrf_cloud_json_obj_end(&writer);
+
+	return nrf_cloud_json_writer_finish(&writer);
+}
+
+static int cell_pos_request_encode(const struct lte_lc_cells_info *const cells_inf,
+				   const bool request_loc, void **buf_out, size_t *len_out)
+{
+	char *buf;
+	int len;
+
+	/* Allocate the request only, with its exact length */
+	len = cell_pos_request_write(cells_inf, request_loc, NULL, 0);
+	if (len < 0) {
+		return len;
+	}
+
+	buf = nrf_cloud_malloc(len + 1);
+	if (!buf) {
+		return -ENOMEM;
+	}
+
+	len = cell_pos_request_write(cells_inf, request_loc, buf, len + 1);
+	if (len < 0) {
+		nrf_cloud_free(buf);
+		return len;
+	}
+
+	*buf_out = buf;
+	*len_out = len;
+
+	return 0;
+}
+#endif /* CONFIG_NRF_CLOUD_CBOR */
+
+static int cell_pos_request_send(const struct lte_lc_cells_info *const cells_inf,
+				 const bool request_loc, nrf_cloud_cell_pos_response_t cb)
+{
+	void *buf;
+	size_t len;
+	int err;
+
+	err = cell_pos_request_encode(cells_inf, request_loc, &buf, &len);
+	if (err) {
+		return err;
+	}
+
+	if (request_loc) {
+		nfsm_set_cell_pos_response_cb(cb);
+	}
+
+	struct nct_dc_data msg = {
+		.data.ptr = buf,
+		.data.len = len
+	};
+
+	err = nct_dc_send(&msg);
+	if (err) {
+		LOG_ERR("Failed to send request, error: %d", err);
+	}
+
+	nrf_cloud_free(buf);
+
+	return err;
+}
+
 int nrf_cloud_cell_pos_request(const struct lte_lc_cells_info *const cells_inf,
 			       const bool request_loc, nrf_cloud_cell_pos_response_t cb)
 {
@@ -34,6 +154,10 @@ int nrf_cloud_cell_pos_request(const struct lte_lc_cells_info *const cells_inf,
 		return -EACCES;
 	}
 
+	if (cells_inf) {
+		return cell_pos_request_send(cells_inf, request_loc, cb);
+	}
+
 	int err = 0;
 	cJSON *cell_pos_req_obj = NULL;
 
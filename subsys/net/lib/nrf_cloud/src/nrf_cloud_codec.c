@@ -7,6 +7,10 @@
 #include "nrf_cloud_codec.h"
 #include "nrf_cloud_mem.h"
 #include "nrf_cloud_fsm.h"
+#include "nrf_cloud_json_writer.h"
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+#include "nrf_cloud_cbor.h"
+#endif
 #include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
@@ -318,44 +322,102 @@ int nrf_cloud_encode_shadow_data(const struct nrf_cloud_sensor_data *sensor,
 	return ret;
 }
 
-int nrf_cloud_encode_sensor_data(const struct nrf_cloud_sensor_data *sensor,
-				 struct nrf_cloud_data *output)
+int nrf_cloud_encode_sensor_data_buf(const struct nrf_cloud_sensor_data *sensor,
+				     char *buf, size_t buf_len)
 {
-	int ret;
+	struct nrf_cloud_json_writer writer;
 
 	__ASSERT_NO_MSG(sensor != NULL);
 	__ASSERT_NO_MSG(sensor->data.ptr != NULL);
 	__ASSERT_NO_MSG(sensor->data.len != 0);
-	__ASSERT_NO_MSG(output != NULL);
 	__ASSERT_NO_MSG(sensor->type < SENSOR_TYPE_ARRAY_SIZE);
 
-	cJSON *root_obj = cJSON_CreateObject();
+	nrf_cloud_json_writer_init(&writer, buf, buf_len);
+	nrf_cloud_json_sensor_msg_write(&writer, sensor_type_str[sensor->type], sensor->data.ptr);
 
-	if (root_obj == NULL) {
-		return -ENOMEM;
-	}
+	return nrf_cloud_json_writer_finish(&writer);
+}
 
-	ret = json_add_str_cs(root_obj, NRF_CLOUD_JSON_APPID_KEY, sensor_type_str[sensor->type]);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_MSG_TYPE_KEY,
-			       NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+static int encode_sensor_data_cbor(const struct nrf_cloud_sensor_data *sensor,
+				   struct nrf_cloud_data *output)
+{
+	const char *app_id;
+	size_t data_len;
+	size_t size;
+	size_t len;
+	uint8_t *buffer;
+	int err;
 
-	if (ret != 0) {
-		cJSON_Delete(root_obj);
+	__ASSERT_NO_MSG(sensor != NULL);
+	__ASSERT_NO_MSG(sensor->data.ptr != NULL);
+	__ASSERT_NO_MSG(sensor->data.len != 0);
+	__ASSERT_NO_MSG(sensor->type < SENSOR_TYPE_ARRAY_SIZE);
+
+	app_id = sensor_type_str[sensor->type];
+	data_len = strnlen(sensor->data.ptr, sensor->data.len);
+	size = nrf_cloud_cbor_sensor_msg_size(app_id, data_len);
+
+	buffer = nrf_cloud_malloc(size);
+	if (buffer == NULL) {
 		return -ENOMEM;
 	}
 
+	err = nrf_cloud_cbor_sensor_msg_encode(app_id, sensor->data.ptr, data_len,
+					       buffer, size, &len);
+	if (err) {
+		nrf_cloud_free(buffer);
+		return err;
+	}
+
+	output->ptr = buffer;
+	output->len = len;
+
+	return 0;
+}
+#endif /* CONFIG_NRF_CLOUD_CBOR */
+
+static int encode_sensor_data_json(const struct nrf_cloud_sensor_data *sensor,
+				   struct nrf_cloud_data *output)
+{
 	char *buffer;
+	int len;
 
-	buffer = cJSON_PrintUnformatted(root_obj);
-	cJSON_Delete(root_obj);
+	/* Allocate the message only, with its exact length */
+	len = nrf_cloud_encode_sensor_data_buf(sensor, NULL, 0);
+	if (len < 0) {
+		return len;
+	}
+
+	buffer = nrf_cloud_malloc(len + 1);
+	if (buffer == NULL) {
+		return -ENOMEM;
+	}
+
+	len = nrf_cloud_encode_sensor_data_buf(sensor, buffer, len + 1);
+	if (len < 0) {
+		nrf_cloud_free(buffer);
+		return len;
+	}
 
 	output->ptr = buffer;
-	output->len = strlen(buffer);
+	output->len = len;
 
 	return 0;
 }
 
+int nrf_cloud_encode_sensor_data(const struct nrf_cloud_sensor_data *sensor,
+				 struct nrf_cloud_data *output)
+{
+	__ASSERT_NO_MSG(output != NULL);
+
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+	return encode_sensor_data_cbor(sensor, output);
+#else
+	return encode_sensor_data_json(sensor, output);
+#endif
+}
+
 #ifdef CONFIG_NRF_CLOUD_GATEWAY
 void nrf_cloud_register_gateway_state_handler(gateway_state_handler_t handler)
 {
@@ -1411,6 +1473,23 @@ cleanup:
 	return -ENOMEM;
 }
 
+int nrf_cloud_format_cell_pos_req_buf(struct lte_lc_cells_info const *const inf,
+				      size_t inf_cnt, char *buf, size_t buf_len)
+{
+	struct nrf_cloud_json_writer writer;
+
+	if (!inf || !inf_cnt) {
+		return -EINVAL;
+	}
+
+	nrf_cloud_json_writer_init(&writer, buf, buf_len);
+	nrf_cloud_json_obj_start(&writer, NULL);
+	nrf_cloud_json_cell_pos_lte_write(&writer, inf, inf_cnt);
+	nrf_cloud_json_obj_end(&writer);
+
+	return nrf_cloud_json_writer_finish(&writer);
+}
+
 int nrf_cloud_format_cell_pos_req(struct lte_lc_cells_info const *const inf,
 	size_t inf_cnt, char **string_out)
 {
@@ -1418,23 +1497,27 @@ int nrf_cloud_format_cell_pos_req(struct lte_lc_cells_info const *const inf,
 		return -EINVAL;
 	}
 
-	int err = 0;
-	cJSON *req_obj = cJSON_CreateObject();
+	int len;
 
-	err = nrf_cloud_format_cell_pos_req_json(inf, inf_cnt, req_obj);
-	if (err) {
-		goto cleanup;
+	/* Allocate the request only, with its exact length */
+	len = nrf_cloud_format_cell_pos_req_buf(inf, inf_cnt, NULL, 0);
+	if (len < 0) {
+		return len;
 	}
 
-	*string_out = cJSON_PrintUnformatted(req_obj);
+	*string_out = nrf_cloud_malloc(len + 1);
 	if (*string_out == NULL) {
-		err = -ENOMEM;
+		return -ENOMEM;
 	}
 
-cleanup:
-	cJSON_Delete(req_obj);
+	len = nrf_cloud_format_cell_pos_req_buf(inf, inf_cnt, *string_out, len + 1);
+	if (len < 0) {
+		nrf_cloud_free(*string_out);
+		*string_out = NULL;
+		return len;
+	}
 
-	return err;
+	return 0;
 }
 
 static bool json_item_string_exists(const cJSON *const obj, const char *const key,
@@ -1854,3 +1937,23 @@ cleanup:
 
 	return ret;
 }
+
+int nrf_cloud_gnss_msg_json_encode_buf(const struct nrf_cloud_gnss_data * const gnss,
+				       char *buf, size_t buf_len)
+{
+	struct nrf_cloud_json_writer writer;
+	int err;
+
+	if (!gnss) {
+		return -EINVAL;
+	}
+
+	nrf_cloud_json_writer_init(&writer, buf, buf_len);
+
+	err = nrf_cloud_json_gnss_msg_write(&writer, gnss);
+	if (err) {
+		return err;
+	}
+
+	return nrf_cloud_json_writer_finish(&writer);
+}
@@ -509,12 +509,16 @@ static int dc_connection_handler(const struct nct_evt *nct_evt)
 	return 0;
 }
 
-static int cell_pos_cb_send(const char *const rx_buf)
+static int cell_pos_cb_send(const struct nrf_cloud_data *const rx_data)
 {
 #if defined(CONFIG_NRF_CLOUD_CELL_POS) && defined(CONFIG_NRF_CLOUD_MQTT)
 	if (cell_pos_cb) {
 		struct nrf_cloud_cell_pos_result res;
-		int ret = nrf_cloud_cell_pos_process(rx_buf, &res);
+#if defined(CONFIG_NRF_CLOUD_CBOR)
+		int ret = nrf_cloud_cbor_cell_pos_resp_decode(rx_data->ptr, rx_data->len, &res);
+#else
+		int ret = nrf_cloud_cell_pos_process(rx_data->ptr, &res);
+#endif
 
 		if (ret <= 0) {
 			/* A cell-pos response was received, send to callback */
@@ -541,7 +545,7 @@ static int dc_rx_data_handler(const struct nct_evt *nct_evt)
 	bool discon_req = nrf_cloud_detect_disconnection_request(nct_evt->param.dc->data.ptr);
 
 	/* All data is forwared to the app... unless a callback is registered */
-	if (cell_pos_cb_send(nct_evt->param.dc->data.ptr) == 0) {
+	if (cell_pos_cb_send(&nct_evt->param.dc->data) == 0) {
 		return 0;
 	}
 
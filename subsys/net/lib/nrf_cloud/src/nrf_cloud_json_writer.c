@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "nrf_cloud_codec.h"
+#include "nrf_cloud_json_writer.h"
+
+LOG_MODULE_REGISTER(nrf_cloud_json_writer, CONFIG_NRF_CLOUD_LOG_LEVEL);
+
+void nrf_cloud_json_writer_init(struct nrf_cloud_json_writer *writer, char *buf, size_t size)
+{
+	__ASSERT_NO_MSG(writer != NULL);
+
+	writer->buf = buf;
+	writer->size = size;
+	writer->len = 0;
+	writer->err = 0;
+	writer->depth = 0;
+	writer->has_members = 0;
+}
+
+int nrf_cloud_json_writer_finish(struct nrf_cloud_json_writer *writer)
+{
+	if (!writer->err && writer->depth) {
+		writer->err = -EINVAL;
+	}
+
+	if (writer->err) {
+		return writer->err;
+	}
+
+	/* The writer always leaves room for the NULL character */
+	if (writer->buf) {
+		writer->buf[writer->len] = '\0';
+	}
+
+	return writer->len;
+}
+
+/* The length keeps being counted when the output does not fit, so that
+ * the size of the buffer needed is known.
+ */
+static void raw_write(struct nrf_cloud_json_writer *writer, const char *str, size_t len)
+{
+	if (writer->buf && !writer->err) {
+		if (writer->len + len >= writer->size) {
+			writer->err = -ENOMEM;
+		} else {
+			memcpy(writer->buf + writer->len, str, len);
+		}
+	}
+
+	writer->len += len;
+}
+
+static void chr_write(struct nrf_cloud_json_writer *writer, char chr)
+{
+	raw_write(writer, &chr, 1);
+}
+
+/* Escape the string like cJSON: quotation marks, backslashes and control
+ * characters only.
+ */
+static void string_write(struct nrf_cloud_json_writer *writer, const char *str)
+{
+	const char *run;
+	const char *pos;
+	char esc[sizeof("\\u0000")];
+
+	if (!str) {
+		str = "";
+	}
+
+	chr_write(writer, '"');
+
+	for (run = pos = str; *pos; pos++) {
+		unsigned char chr = *pos;
+
+		if (chr != '"' && chr != '\\' && chr >= ' ') {
+			continue;
+		}
+
+		raw_write(writer, run, pos - run);
+		run = pos + 1;
+
+		switch (chr) {
+		case '"':
+		case '\\':
+			esc[0] = '\\';
+			esc[1] = chr;
+			raw_write(writer, esc, 2);
+			break;
+		case '\b':
+			raw_write(writer, "\\b", 2);
+			break;
+		case '\f':
+			raw_write(writer, "\\f", 2);
+			break;
+		case '\n':
+			raw_write(writer, "\\n", 2);
+			break;
+		case '\r':
+			raw_write(writer, "\\r", 2);
+			break;
+		case '\t':
+			raw_write(writer, "\\t", 2);
+			break;
+		default:
+			snprintf(esc, sizeof(esc), "\\u%04x", chr);
+			raw_write(writer, esc, sizeof(esc) - 1);
+			break;
+		}
+	}
+
+	raw_write(writer, run, pos - run);
+	chr_write(writer, '"');
+}
+
+static bool double_equal(double a, double b)
+{
+	double max = (fabs(a) > fabs(b)) ? fabs(a) : fabs(b);
+
+	return fabs(a - b) <= max * DBL_EPSILON;
+}
+
+/* Format the number like cJSON: as an integer if it is one within the
+ * range of int, otherwise with the shortest of 15 and 17 significant
+ * digits that gives the number back.
+ */
+static void num_write(struct nrf_cloud_json_writer *writer, double num)
+{
+	char str[26];
+	int valueint;
+	int len;
+
+	if (isnan(num) || isinf(num)) {
+		raw_write(writer, "null", 4);
+		return;
+	}
+
+	if (num >= INT_MAX) {
+		valueint = INT_MAX;
+	} else if (num <= (double)INT_MIN) {
+		valueint = INT_MIN;
+	} else {
+		valueint = (int)num;
+	}
+
+	if (num == (double)valueint) {
+		len = snprintf(str, sizeof(str), "%d", valueint);
+	} else {
+		len = snprintf(str, sizeof(str), "%1.15g", num);
+		if (!double_equal(strtod(str, NULL), num)) {
+			len = snprintf(str, sizeof(str), "%1.17g", num);
+		}
+	}
+
+	raw_write(writer, str, len);
+}
+
+static void member_start(struct nrf_cloud_json_writer *writer, const char *key)
+{
+	uint32_t bit = BIT(writer->depth);
+
+	if (writer->has_members & bit) {
+		chr_write(writer, ',');
+	}
+
+	writer->has_members |= bit;
+
+	if (key) {
+		string_write(writer, key);
+		chr_write(writer, ':');
+	}
+}
+
+static void container_start(struct nrf_cloud_json_writer *writer, const char *key, char chr)
+{
+	member_start(writer, key);
+	chr_write(writer, chr);
+
+	if (writer->depth == NRF_CLOUD_JSON_WRITER_DEPTH_MAX - 1) {
+		writer->err = writer->err ? writer->err : -E2BIG;
+		return;
+	}
+
+	writer->depth++;
+	writer->has_members &= ~BIT(writer->depth);
+}
+
+static void container_end(struct nrf_cloud_json_writer *writer, char chr)
+{
+	if (writer->depth == 0) {
+		writer->err = writer->err ? writer->err : -EINVAL;
+		return;
+	}
+
+	writer->depth--;
+	chr_write(writer, chr);
+}
+
+void nrf_cloud_json_obj_start(struct nrf_cloud_json_writer *writer, const char *key)
+{
+	container_start(writer, key, '{');
+}
+
+void nrf_cloud_json_obj_end(struct nrf_cloud_json_writer *writer)
+{
+	container_end(writer, '}');
+}
+
+void nrf_cloud_json_arr_start(struct nrf_cloud_json_writer *writer, const char *key)
+{
+	container_start(writer, key, '[');
+}
+
+void nrf_cloud_json_arr_end(struct nrf_cloud_json_writer *writer)
+{
+	container_end(writer, ']');
+}
+
+void nrf_cloud_json_str_add(struct nrf_cloud_json_writer *writer, const char *key,
+			    const char *str)
+{
+	member_start(writer, key);
+	string_write(writer, str);
+}
+
+void nrf_cloud_json_num_add(struct nrf_cloud_json_writer *writer, const char *key, double num)
+{
+	member_start(writer, key);
+	num_write(writer, num);
+}
+
+void nrf_cloud_json_sensor_msg_write(struct nrf_cloud_json_writer *writer,
+				     const char *app_id, const char *data)
+{
+	nrf_cloud_json_obj_start(writer, NULL);
+	nrf_cloud_json_str_add(writer, NRF_CLOUD_JSON_APPID_KEY, app_id);
+	nrf_cloud_json_str_add(writer, NRF_CLOUD_JSON_DATA_KEY, data);
+	nrf_cloud_json_str_add(writer, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+			       NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	nrf_cloud_json_obj_end(writer);
+}
+
+static void pvt_write(struct nrf_cloud_json_writer *writer, const struct nrf_cloud_gnss_pvt *pvt)
+{
+	nrf_cloud_json_obj_start(writer, NRF_CLOUD_JSON_DATA_KEY);
+	nrf_cloud_json_num_add(writer, NRF_CLOUD_JSON_GNSS_PVT_KEY_LON, pvt->lon);
+	nrf_cloud_json_num_add(writer, NRF_CLOUD_JSON_GNSS_PVT_KEY_LAT, pvt->lat);
+	nrf_cloud_json_num_add(writer, NRF_CLOUD_JSON_GNSS_PVT_KEY_ACCURACY, pvt->accuracy);
+
+	if (pvt->has_alt) {
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_JSON_GNSS_PVT_KEY_ALTITUDE, pvt->alt);
+	}
+
+	if (pvt->has_speed) {
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_JSON_GNSS_PVT_KEY_SPEED, pvt->speed);
+	}
+
+	if (pvt->has_heading) {
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_JSON_GNSS_PVT_KEY_HEADING, pvt->heading);
+	}
+
+	nrf_cloud_json_obj_end(writer);
+}
+
+int nrf_cloud_json_gnss_msg_write(struct nrf_cloud_json_writer *writer,
+				  const struct nrf_cloud_gnss_data *gnss)
+{
+	const struct nrf_cloud_gnss_pvt *pvt = NULL;
+	const char *nmea = NULL;
+#if defined(CONFIG_NRF_MODEM)
+	struct nrf_cloud_gnss_pvt mdm_pvt;
+#endif
+
+	/* Check the data before anything is written */
+	switch (gnss->type) {
+	case NRF_CLOUD_GNSS_TYPE_PVT:
+		pvt = &gnss->pvt;
+		break;
+	case NRF_CLOUD_GNSS_TYPE_MODEM_PVT:
+#if defined(CONFIG_NRF_MODEM)
+		if (!gnss->mdm_pvt) {
+			return -EINVAL;
+		}
+
+		mdm_pvt = (struct nrf_cloud_gnss_pvt) {
+			.lon =		gnss->mdm_pvt->longitude,
+			.lat =		gnss->mdm_pvt->latitude,
+			.accuracy =	gnss->mdm_pvt->accuracy,
+			.alt =		gnss->mdm_pvt->altitude,
+			.has_alt =	1,
+			.speed =	gnss->mdm_pvt->speed,
+			.has_speed =	1,
+			.heading =	gnss->mdm_pvt->heading,
+			.has_heading =	1
+		};
+		pvt = &mdm_pvt;
+		break;
+#else
+		return -EFTYPE;
+#endif
+	case NRF_CLOUD_GNSS_TYPE_MODEM_NMEA:
+#if defined(CONFIG_NRF_MODEM)
+		if (gnss->mdm_nmea) {
+			nmea = gnss->mdm_nmea->nmea_str;
+		}
+#endif
+		break;
+	case NRF_CLOUD_GNSS_TYPE_NMEA:
+		nmea = gnss->nmea.sentence;
+		break;
+	default:
+		return -EFTYPE;
+	}
+
+	if (!pvt) {
+		if (nmea == NULL) {
+			return -EINVAL;
+		}
+
+		if (memchr(nmea, '\0', NRF_MODEM_GNSS_NMEA_MAX_LEN) == NULL) {
+			return -EFBIG;
+		}
+	}
+
+	nrf_cloud_json_obj_start(writer, NULL);
+	nrf_cloud_json_str_add(writer, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_GNSS);
+	nrf_cloud_json_str_add(writer, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+			       NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+
+	if (gnss->ts_ms > NRF_CLOUD_NO_TIMESTAMP) {
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_MSG_TIMESTAMP_KEY, gnss->ts_ms);
+	}
+
+	if (pvt) {
+		pvt_write(writer, pvt);
+	} else {
+		nrf_cloud_json_str_add(writer, NRF_CLOUD_JSON_DATA_KEY, nmea);
+	}
+
+	nrf_cloud_json_obj_end(writer);
+
+	return 0;
+}
+
+static void ncells_write(struct nrf_cloud_json_writer *writer,
+			 const struct lte_lc_cells_info *lte)
+{
+	nrf_cloud_json_arr_start(writer, NRF_CLOUD_CELL_POS_JSON_KEY_NBORS);
+
+	for (uint8_t j = 0; j < lte->ncells_count; ++j) {
+		const struct lte_lc_ncell *ncell = lte->neighbor_cells + j;
+
+		nrf_cloud_json_obj_start(writer, NULL);
+
+		/* required items */
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN, ncell->earfcn);
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_PCI,
+				       ncell->phys_cell_id);
+
+		/* optional */
+		if (ncell->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP) {
+			nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_RSRP,
+					       RSRP_IDX_TO_DBM(ncell->rsrp));
+		}
+
+		if (ncell->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ) {
+			nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ,
+					       RSRQ_IDX_TO_DB(ncell->rsrq));
+		}
+
+		nrf_cloud_json_obj_end(writer);
+	}
+
+	nrf_cloud_json_arr_end(writer);
+}
+
+void nrf_cloud_json_cell_pos_lte_write(struct nrf_cloud_json_writer *writer,
+				       const struct lte_lc_cells_info *inf, size_t inf_cnt)
+{
+	nrf_cloud_json_arr_start(writer, NRF_CLOUD_CELL_POS_JSON_KEY_LTE);
+
+	for (size_t i = 0; i < inf_cnt; ++i) {
+		const struct lte_lc_cells_info *lte = inf + i;
+		const struct lte_lc_cell *cur = &lte->current_cell;
+
+		nrf_cloud_json_obj_start(writer, NULL);
+
+		/* required items */
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_ECI, cur->id);
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_MCC, cur->mcc);
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_MNC, cur->mnc);
+		nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_TAC, cur->tac);
+
+		/* optional */
+		if (cur->earfcn != NRF_CLOUD_CELL_POS_OMIT_EARFCN) {
+			nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN,
+					       cur->earfcn);
+		}
+
+		if (cur->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP) {
+			nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_RSRP,
+					       RSRP_IDX_TO_DBM(cur->rsrp));
+		}
+
+		if (cur->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ) {
+			nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ,
+					       RSRQ_IDX_TO_DB(cur->rsrq));
+		}
+
+		if (cur->timing_advance != NRF_CLOUD_CELL_POS_OMIT_TIME_ADV) {
+			nrf_cloud_json_num_add(writer, NRF_CLOUD_CELL_POS_JSON_KEY_T_ADV,
+					       MIN(cur->timing_advance,
+						   NRF_CLOUD_CELL_POS_TIME_ADV_MAX));
+		}
+
+		if (lte->ncells_count && lte->neighbor_cells == NULL) {
+			/* Like the cJSON encoder, stop at the invalid cell information */
+			LOG_WRN("Neighbor cell count is %u, but buffer is NULL",
+				lte->ncells_count);
+			nrf_cloud_json_obj_end(writer);
+			break;
+		}
+
+		/* Add an array for neighbor cell data if there are any */
+		if (lte->ncells_count) {
+			ncells_write(writer, lte);
+		}
+
+		nrf_cloud_json_obj_end(writer);
+	}
+
+	nrf_cloud_json_arr_end(writer);
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Generated using zcbor version 0.5.1
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 128
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_decode.h"
+#include "nrf_cloud_msg_decode.h"
+
+#if DEFAULT_MAX_QTY != 128
+#error "The type file was generated with a different default_max_qty than this file"
+#endif
+
+static bool decode_repeated_Cell_pos_result_res_fulfilled_with(
+	zcbor_state_t *state, struct Cell_pos_result_res_fulfilled_with *result);
+static bool decode_Cell_pos_result(zcbor_state_t *state, struct Cell_pos_result *result);
+static bool decode_Cell_pos_resp(zcbor_state_t *state, struct Cell_pos_resp *result);
+
+static bool decode_repeated_Cell_pos_result_res_fulfilled_with(
+	zcbor_state_t *state, struct Cell_pos_result_res_fulfilled_with *result)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result =
+		((((zcbor_uint32_expect(state, (4)))) &&
+		  (zcbor_tstr_decode(state, (&(*result)._Cell_pos_result_res_fulfilled_with)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool decode_Cell_pos_result(zcbor_state_t *state, struct Cell_pos_result *result)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result =
+		(((zcbor_map_start_decode(state) &&
+		   (((((zcbor_uint32_expect(state, (1)))) &&
+		      (zcbor_float64_decode(state, (&(*result)._Cell_pos_result_res_lat)))) &&
+		     (((zcbor_uint32_expect(state, (2)))) &&
+		      (zcbor_float64_decode(state, (&(*result)._Cell_pos_result_res_lon)))) &&
+		     (((zcbor_uint32_expect(state, (3)))) &&
+		      (zcbor_uint32_decode(state, (&(*result)._Cell_pos_result_res_unc)))) &&
+		     zcbor_present_decode(
+			     &((*result)._Cell_pos_result_res_fulfilled_with_present),
+			     (zcbor_decoder_t *)decode_repeated_Cell_pos_result_res_fulfilled_with,
+			     state, (&(*result)._Cell_pos_result_res_fulfilled_with))) ||
+		    (zcbor_list_map_end_force_decode(state), false)) &&
+		   zcbor_map_end_decode(state))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool decode_Cell_pos_resp(zcbor_state_t *state, struct Cell_pos_resp *result)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+	bool int_res;
+
+	bool tmp_result =
+		(((zcbor_map_start_decode(state) &&
+		   (((((zcbor_uint32_expect(state, (1)))) &&
+		      (zcbor_tstr_expect(state, ((tmp_str.value = (uint8_t *)"CELL_POS",
+						  tmp_str.len = sizeof("CELL_POS") - 1,
+						  &tmp_str))))) &&
+		     (((zcbor_uint32_expect(state, (2)))) &&
+		      (zcbor_tstr_expect(state, ((tmp_str.value = (uint8_t *)"DATA",
+						  tmp_str.len = sizeof("DATA") - 1, &tmp_str))))) &&
+		     ((zcbor_union_start_code(state) &&
+		       (int_res =
+				(((((zcbor_uint32_expect_union(state, (4)))) &&
+				   (decode_Cell_pos_result(state, (&(*result)._Cell_pos_resp_data)))) &&
+				  (((*result)._Cell_pos_resp_union_choice = _Cell_pos_resp_data), true)) ||
+				 ((((zcbor_uint32_expect_union(state, (5)))) &&
+				   (zcbor_int32_decode(state, (&(*result)._Cell_pos_resp_err)))) &&
+				  (((*result)._Cell_pos_resp_union_choice = _Cell_pos_resp_err), true))),
+			zcbor_union_end_code(state), int_res)))) ||
+		    (zcbor_list_map_end_force_decode(state), false)) &&
+		   zcbor_map_end_decode(state))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+int cbor_decode_Cell_pos_resp(const uint8_t *payload, size_t payload_len,
+			      struct Cell_pos_resp *result, size_t *payload_len_out)
+{
+	zcbor_state_t states[4];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = decode_Cell_pos_resp(states, result);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
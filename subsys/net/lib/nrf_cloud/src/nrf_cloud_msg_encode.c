@@ -0,0 +1,485 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Generated using zcbor version 0.5.1
+ * https://github.com/NordicSemiconductor/zcbor
+ * Generated with a --default-max-qty of 128
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include "zcbor_encode.h"
+#include "nrf_cloud_msg_encode.h"
+
+#if DEFAULT_MAX_QTY != 128
+#error "The type file was generated with a different default_max_qty than this file"
+#endif
+
+static bool encode_Sensor_msg(zcbor_state_t *state, const struct Sensor_msg *input);
+static bool encode_repeated_Gnss_msg_ts(zcbor_state_t *state, const struct Gnss_msg_ts *input);
+static bool encode_repeated_Pvt_pvt_alt(zcbor_state_t *state, const struct Pvt_pvt_alt *input);
+static bool encode_repeated_Pvt_pvt_spd(zcbor_state_t *state, const struct Pvt_pvt_spd *input);
+static bool encode_repeated_Pvt_pvt_hdg(zcbor_state_t *state, const struct Pvt_pvt_hdg *input);
+static bool encode_Pvt(zcbor_state_t *state, const struct Pvt *input);
+static bool encode_Gnss_msg(zcbor_state_t *state, const struct Gnss_msg *input);
+static bool encode_repeated_Lte_cell_cell_earfcn(zcbor_state_t *state,
+						 const struct Lte_cell_cell_earfcn *input);
+static bool encode_repeated_Lte_cell_cell_rsrp(zcbor_state_t *state,
+					       const struct Lte_cell_cell_rsrp *input);
+static bool encode_repeated_Lte_cell_cell_rsrq(zcbor_state_t *state,
+					       const struct Lte_cell_cell_rsrq *input);
+static bool encode_repeated_Lte_cell_cell_adv(zcbor_state_t *state,
+					      const struct Lte_cell_cell_adv *input);
+static bool encode_repeated_Ncell_ncell_rsrp(zcbor_state_t *state,
+					     const struct Ncell_ncell_rsrp *input);
+static bool encode_repeated_Ncell_ncell_rsrq(zcbor_state_t *state,
+					     const struct Ncell_ncell_rsrq *input);
+static bool encode_Ncell(zcbor_state_t *state, const struct Ncell *input);
+static bool encode_repeated_Lte_cell_cell_nmr(zcbor_state_t *state,
+					      const struct Lte_cell_cell_nmr *input);
+static bool encode_Lte_cell(zcbor_state_t *state, const struct Lte_cell *input);
+static bool encode_repeated_Cell_pos_req_data_req_do_reply(
+	zcbor_state_t *state, const struct Cell_pos_req_data_req_do_reply *input);
+static bool encode_Cell_pos_req_data(zcbor_state_t *state, const struct Cell_pos_req_data *input);
+static bool encode_Cell_pos_req(zcbor_state_t *state, const struct Cell_pos_req *input);
+
+static bool encode_Sensor_msg(zcbor_state_t *state, const struct Sensor_msg *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result =
+		(((zcbor_map_start_encode(state, 3) &&
+		   (((((zcbor_uint32_put(state, (1)))) &&
+		      (zcbor_tstr_encode(state, (&(*input)._Sensor_msg_app_id)))) &&
+		     (((zcbor_uint32_put(state, (2)))) &&
+		      (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"DATA",
+						  tmp_str.len = sizeof("DATA") - 1, &tmp_str))))) &&
+		     (((zcbor_uint32_put(state, (4)))) &&
+		      (zcbor_tstr_encode(state, (&(*input)._Sensor_msg_data))))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 3))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Gnss_msg_ts(zcbor_state_t *state, const struct Gnss_msg_ts *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (3)))) &&
+			    (zcbor_uint64_encode(state, (&(*input)._Gnss_msg_ts)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Pvt_pvt_alt(zcbor_state_t *state, const struct Pvt_pvt_alt *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (4)))) &&
+			    (zcbor_float32_encode(state, (&(*input)._Pvt_pvt_alt)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Pvt_pvt_spd(zcbor_state_t *state, const struct Pvt_pvt_spd *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (5)))) &&
+			    (zcbor_float32_encode(state, (&(*input)._Pvt_pvt_spd)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Pvt_pvt_hdg(zcbor_state_t *state, const struct Pvt_pvt_hdg *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (6)))) &&
+			    (zcbor_float32_encode(state, (&(*input)._Pvt_pvt_hdg)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_Pvt(zcbor_state_t *state, const struct Pvt *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result =
+		(((zcbor_map_start_encode(state, 6) &&
+		   (((((zcbor_uint32_put(state, (1)))) &&
+		      (zcbor_float64_encode(state, (&(*input)._Pvt_pvt_lng)))) &&
+		     (((zcbor_uint32_put(state, (2)))) &&
+		      (zcbor_float64_encode(state, (&(*input)._Pvt_pvt_lat)))) &&
+		     (((zcbor_uint32_put(state, (3)))) &&
+		      (zcbor_float32_encode(state, (&(*input)._Pvt_pvt_acc)))) &&
+		     zcbor_present_encode(&((*input)._Pvt_pvt_alt_present),
+					  (zcbor_encoder_t *)encode_repeated_Pvt_pvt_alt, state,
+					  (&(*input)._Pvt_pvt_alt)) &&
+		     zcbor_present_encode(&((*input)._Pvt_pvt_spd_present),
+					  (zcbor_encoder_t *)encode_repeated_Pvt_pvt_spd, state,
+					  (&(*input)._Pvt_pvt_spd)) &&
+		     zcbor_present_encode(&((*input)._Pvt_pvt_hdg_present),
+					  (zcbor_encoder_t *)encode_repeated_Pvt_pvt_hdg, state,
+					  (&(*input)._Pvt_pvt_hdg))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 6))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_Gnss_msg(zcbor_state_t *state, const struct Gnss_msg *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result =
+		(((zcbor_map_start_encode(state, 4) &&
+		   (((((zcbor_uint32_put(state, (1)))) &&
+		      (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"GNSS",
+						  tmp_str.len = sizeof("GNSS") - 1, &tmp_str))))) &&
+		     (((zcbor_uint32_put(state, (2)))) &&
+		      (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"DATA",
+						  tmp_str.len = sizeof("DATA") - 1, &tmp_str))))) &&
+		     zcbor_present_encode(&((*input)._Gnss_msg_ts_present),
+					  (zcbor_encoder_t *)encode_repeated_Gnss_msg_ts, state,
+					  (&(*input)._Gnss_msg_ts)) &&
+		     (((zcbor_uint32_put(state, (4)))) &&
+		      ((((*input)._Gnss_msg_data_choice == _Gnss_msg_data_Pvt) ?
+				((encode_Pvt(state, (&(*input)._Gnss_msg_data_Pvt)))) :
+		       (((*input)._Gnss_msg_data_choice == _Gnss_msg_data_tstr) ?
+				((zcbor_tstr_encode(state, (&(*input)._Gnss_msg_data_tstr)))) :
+				false))))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 4))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Lte_cell_cell_earfcn(zcbor_state_t *state,
+						 const struct Lte_cell_cell_earfcn *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (5)))) &&
+			    (zcbor_uint32_encode(state, (&(*input)._Lte_cell_cell_earfcn)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Lte_cell_cell_rsrp(zcbor_state_t *state,
+					       const struct Lte_cell_cell_rsrp *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (6)))) &&
+			    (zcbor_int32_encode(state, (&(*input)._Lte_cell_cell_rsrp)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Lte_cell_cell_rsrq(zcbor_state_t *state,
+					       const struct Lte_cell_cell_rsrq *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (7)))) &&
+			    (zcbor_float32_encode(state, (&(*input)._Lte_cell_cell_rsrq)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Lte_cell_cell_adv(zcbor_state_t *state,
+					      const struct Lte_cell_cell_adv *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (8)))) &&
+			    (zcbor_uint32_encode(state, (&(*input)._Lte_cell_cell_adv)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Ncell_ncell_rsrp(zcbor_state_t *state,
+					     const struct Ncell_ncell_rsrp *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (3)))) &&
+			    (zcbor_int32_encode(state, (&(*input)._Ncell_ncell_rsrp)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Ncell_ncell_rsrq(zcbor_state_t *state,
+					     const struct Ncell_ncell_rsrq *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result = ((((zcbor_uint32_put(state, (4)))) &&
+			    (zcbor_float32_encode(state, (&(*input)._Ncell_ncell_rsrq)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_Ncell(zcbor_state_t *state, const struct Ncell *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result =
+		(((zcbor_map_start_encode(state, 4) &&
+		   (((((zcbor_uint32_put(state, (1)))) &&
+		      (zcbor_uint32_encode(state, (&(*input)._Ncell_ncell_earfcn)))) &&
+		     (((zcbor_uint32_put(state, (2)))) &&
+		      (zcbor_uint32_encode(state, (&(*input)._Ncell_ncell_pci)))) &&
+		     zcbor_present_encode(&((*input)._Ncell_ncell_rsrp_present),
+					  (zcbor_encoder_t *)encode_repeated_Ncell_ncell_rsrp,
+					  state, (&(*input)._Ncell_ncell_rsrp)) &&
+		     zcbor_present_encode(&((*input)._Ncell_ncell_rsrq_present),
+					  (zcbor_encoder_t *)encode_repeated_Ncell_ncell_rsrq,
+					  state, (&(*input)._Ncell_ncell_rsrq))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 4))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Lte_cell_cell_nmr(zcbor_state_t *state,
+					      const struct Lte_cell_cell_nmr *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result =
+		((((zcbor_uint32_put(state, (9)))) &&
+		  (zcbor_list_start_encode(state, 17) &&
+		   ((zcbor_multi_encode_minmax(1, 17, &(*input)._Lte_cell_cell_nmr_Ncell_count,
+					       (zcbor_encoder_t *)encode_Ncell, state,
+					       (&(*input)._Lte_cell_cell_nmr_Ncell),
+					       sizeof(struct Ncell))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_list_end_encode(state, 17))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_Lte_cell(zcbor_state_t *state, const struct Lte_cell *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result =
+		(((zcbor_map_start_encode(state, 9) &&
+		   (((((zcbor_uint32_put(state, (1)))) &&
+		      (zcbor_uint32_encode(state, (&(*input)._Lte_cell_cell_eci)))) &&
+		     (((zcbor_uint32_put(state, (2)))) &&
+		      (zcbor_uint32_encode(state, (&(*input)._Lte_cell_cell_mcc)))) &&
+		     (((zcbor_uint32_put(state, (3)))) &&
+		      (zcbor_uint32_encode(state, (&(*input)._Lte_cell_cell_mnc)))) &&
+		     (((zcbor_uint32_put(state, (4)))) &&
+		      (zcbor_uint32_encode(state, (&(*input)._Lte_cell_cell_tac)))) &&
+		     zcbor_present_encode(&((*input)._Lte_cell_cell_earfcn_present),
+					  (zcbor_encoder_t *)encode_repeated_Lte_cell_cell_earfcn,
+					  state, (&(*input)._Lte_cell_cell_earfcn)) &&
+		     zcbor_present_encode(&((*input)._Lte_cell_cell_rsrp_present),
+					  (zcbor_encoder_t *)encode_repeated_Lte_cell_cell_rsrp,
+					  state, (&(*input)._Lte_cell_cell_rsrp)) &&
+		     zcbor_present_encode(&((*input)._Lte_cell_cell_rsrq_present),
+					  (zcbor_encoder_t *)encode_repeated_Lte_cell_cell_rsrq,
+					  state, (&(*input)._Lte_cell_cell_rsrq)) &&
+		     zcbor_present_encode(&((*input)._Lte_cell_cell_adv_present),
+					  (zcbor_encoder_t *)encode_repeated_Lte_cell_cell_adv,
+					  state, (&(*input)._Lte_cell_cell_adv)) &&
+		     zcbor_present_encode(&((*input)._Lte_cell_cell_nmr_present),
+					  (zcbor_encoder_t *)encode_repeated_Lte_cell_cell_nmr,
+					  state, (&(*input)._Lte_cell_cell_nmr))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 9))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_repeated_Cell_pos_req_data_req_do_reply(
+	zcbor_state_t *state, const struct Cell_pos_req_data_req_do_reply *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result =
+		((((zcbor_uint32_put(state, (2)))) &&
+		  (zcbor_bool_encode(state, (&(*input)._Cell_pos_req_data_req_do_reply)))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_Cell_pos_req_data(zcbor_state_t *state, const struct Cell_pos_req_data *input)
+{
+	zcbor_print("%s\r\n", __func__);
+
+	bool tmp_result =
+		(((zcbor_map_start_encode(state, 2) &&
+		   (((((zcbor_uint32_put(state, (1)))) &&
+		      (zcbor_list_start_encode(state, 1) &&
+		       ((((encode_Lte_cell(state,
+					   (&(*input)._Cell_pos_req_data_req_lte_Lte_cell))))) ||
+			(zcbor_list_map_end_force_encode(state), false)) &&
+		       zcbor_list_end_encode(state, 1))) &&
+		     zcbor_present_encode(
+			     &((*input)._Cell_pos_req_data_req_do_reply_present),
+			     (zcbor_encoder_t *)encode_repeated_Cell_pos_req_data_req_do_reply,
+			     state, (&(*input)._Cell_pos_req_data_req_do_reply))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 2))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+static bool encode_Cell_pos_req(zcbor_state_t *state, const struct Cell_pos_req *input)
+{
+	zcbor_print("%s\r\n", __func__);
+	struct zcbor_string tmp_str;
+
+	bool tmp_result =
+		(((zcbor_map_start_encode(state, 3) &&
+		   (((((zcbor_uint32_put(state, (1)))) &&
+		      (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"CELL_POS",
+						  tmp_str.len = sizeof("CELL_POS") - 1,
+						  &tmp_str))))) &&
+		     (((zcbor_uint32_put(state, (2)))) &&
+		      (zcbor_tstr_encode(state, ((tmp_str.value = (uint8_t *)"DATA",
+						  tmp_str.len = sizeof("DATA") - 1, &tmp_str))))) &&
+		     (((zcbor_uint32_put(state, (4)))) &&
+		      (encode_Cell_pos_req_data(state, (&(*input)._Cell_pos_req_data))))) ||
+		    (zcbor_list_map_end_force_encode(state), false)) &&
+		   zcbor_map_end_encode(state, 3))));
+
+	if (!tmp_result)
+		zcbor_trace();
+
+	return tmp_result;
+}
+
+int cbor_encode_Sensor_msg(uint8_t *payload, size_t payload_len, const struct Sensor_msg *input,
+			   size_t *payload_len_out)
+{
+	zcbor_state_t states[3];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = encode_Sensor_msg(states, input);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
+
+int cbor_encode_Gnss_msg(uint8_t *payload, size_t payload_len, const struct Gnss_msg *input,
+			 size_t *payload_len_out)
+{
+	zcbor_state_t states[4];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = encode_Gnss_msg(states, input);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
+
+int cbor_encode_Cell_pos_req(uint8_t *payload, size_t payload_len,
+			     const struct Cell_pos_req *input, size_t *payload_len_out)
+{
+	zcbor_state_t states[8];
+
+	zcbor_new_state(states, sizeof(states) / sizeof(zcbor_state_t), payload, payload_len, 1);
+
+	bool ret = encode_Cell_pos_req(states, input);
+
+	if (ret && (payload_len_out != NULL)) {
+		*payload_len_out = MIN(payload_len, (size_t)states[0].payload - (size_t)payload);
+	}
+
+	if (!ret) {
+		int err = zcbor_pop_error(states);
+
+		zcbor_print("Return error: %d\r\n", err);
+		return (err == ZCBOR_SUCCESS) ? ZCBOR_ERR_UNKNOWN : err;
+	}
+	return ZCBOR_SUCCESS;
+}
@@ -28,6 +28,7 @@ LOG_MODULE_REGISTER(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
 #include "nrf_cloud_fsm.h"
 #include "nrf_cloud_pgps_schema_v1.h"
 #include "nrf_cloud_pgps_utils.h"
+#include "nrf_cloud_pgps_index.h"
 #include "nrf_cloud_codec.h"
 
 #define FORCE_HTTP_DL			0 /* set to 1 to force HTTP instead of HTTPS */
@@ -76,9 +77,6 @@ struct pgps_index {
 	bool stale_server_data;
 	uint32_t storage_extent;
 	int store_block;
-
-	/* array of pointers to predictions, in sorted time order */
-	struct nrf_cloud_pgps_prediction *predictions[NUM_PREDICTIONS];
 };
 
 static struct pgps_index index;
@@ -160,30 +158,47 @@ static bool validate_pgps_header(const struct nrf_cloud_pgps_header *header)
 	return true;
 }
 
-static int validate_prediction(const struct nrf_cloud_pgps_prediction *p,
-			       uint16_t gps_day,
-			       uint32_t gps_time_of_day,
-			       uint16_t period_min,
-			       bool exact,
-			       bool margin)
+static int validate_prediction_format(const struct nrf_cloud_pgps_prediction *p)
 {
 	int err = 0;
 
-	/* validate that this prediction was actually updated and matches */
 	if ((p->schema_version != NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION) ||
 	    (p->time_type != NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK) ||
 	    (p->time_count != 1)) {
 		LOG_ERR("invalid prediction header");
 		err = -EINVAL;
-	} else if (exact && (p->time.date_day != gps_day)) {
-		LOG_ERR("prediction day:%u, expected:%u",
-			p->time.date_day, gps_day);
-		err = -EINVAL;
-	} else if (exact && (p->time.time_full_s != gps_time_of_day)) {
-		LOG_ERR("prediction time:%u, expected:%u",
-			p->time.time_full_s, gps_time_of_day);
+	}
+
+	if ((p->ephemeris_type != NRF_CLOUD_AGPS_EPHEMERIDES) ||
+	    (p->ephemeris_count != NRF_CLOUD_PGPS_NUM_SV)) {
+		LOG_ERR("ephemeris header bad:%u, %u",
+			p->ephemeris_type, p->ephemeris_count);
 		err = -EINVAL;
 	}
+	return err;
+}
+
+static int validate_prediction(const struct nrf_cloud_pgps_prediction *p,
+			       uint16_t gps_day,
+			       uint32_t gps_time_of_day,
+			       uint16_t period_min,
+			       bool exact,
+			       bool margin)
+{
+	/* validate that this prediction was actually updated and matches */
+	int err = validate_prediction_format(p);
+
+	if (exact && !err) {
+		if (p->time.date_day != gps_day) {
+			LOG_ERR("prediction day:%u, expected:%u",
+				p->time.date_day, gps_day);
+			err = -EINVAL;
+		} else if (p->time.time_full_s != gps_time_of_day) {
+			LOG_ERR("prediction time:%u, expected:%u",
+				p->time.time_full_s, gps_time_of_day);
+			err = -EINVAL;
+		}
+	}
 
 	int64_t gps_sec = npgps_gps_day_time_to_sec(gps_day,
 						    gps_time_of_day);
@@ -202,13 +217,6 @@ static int validate_prediction(const struct nrf_cloud_pgps_prediction *p,
 		err = -EINVAL;
 	}
 
-	if ((p->ephemeris_type != NRF_CLOUD_AGPS_EPHEMERIDES) ||
-	    (p->ephemeris_count != NRF_CLOUD_PGPS_NUM_SV)) {
-		LOG_ERR("ephemeris header bad:%u, %u",
-			p->ephemeris_type, p->ephemeris_count);
-		err = -EINVAL;
-	}
-
 	if (exact && !err) {
 		uint32_t expected_sentinel;
 		uint32_t stored_sentinel;
@@ -247,9 +255,7 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	int pnum;
 
 	/* reset catalog of predictions */
-	for (pnum = 0; pnum < count; pnum++) {
-		index.predictions[pnum] = NULL;
-	}
+	npgps_index_reset();
 
 	npgps_reset_block_pool();
 
@@ -262,8 +268,8 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 			LOG_ERR("prediction idx:%u, ofs:%p, out of expected time range;"
 				" day:%u, time:%u", i, p, pred->time.date_day,
 				pred->time.time_full_s);
-		} else if (index.predictions[pnum] == NULL) {
-			index.predictions[pnum] = pred;
+		} else if (npgps_index_get(pnum) == NULL) {
+			npgps_index_set(pnum, pred);
 			LOG_DBG("Prediction num:%u stored at idx:%d", pnum, i);
 		} else {
 			LOG_WRN("Prediction num:%u stored more than once!", pnum);
@@ -278,7 +284,7 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		gps_sec = start_gps_sec + pnum * period_min * SEC_PER_MIN;
 		npgps_gps_sec_to_day_time(gps_sec, &gps_day, &gps_time_of_day);
 
-		pred = index.predictions[pnum];
+		pred = npgps_index_get(pnum);
 		if (pred == NULL) {
 			LOG_WRN("Prediction num:%u missing", pnum);
 			/* request partial data; download interrupted? */
@@ -338,7 +344,6 @@ static void get_prediction_day_time(int pnum, int64_t *gps_sec, uint16_t *gps_da
 
 static void discard_oldest_predictions(int num)
 {
-	int i;
 	int pnum;
 	int block;
 	int last = MIN(num, index.header.prediction_count);
@@ -350,25 +355,16 @@ static void discard_oldest_predictions(int num)
 	LOG_DBG("Discarding %d", last);
 
 	for (pnum = 0; pnum < last; pnum++) {
-		block = npgps_pointer_to_block((uint8_t *)index.predictions[pnum]);
+		block = npgps_pointer_to_block((uint8_t *)npgps_index_get(pnum));
 		__ASSERT((block != -1), "unexpected ptr:%p for Prediction num:%d",
-			 index.predictions[pnum], pnum);
+			 npgps_index_get(pnum), pnum);
 		npgps_free_block(block);
 	}
 
-	/* move predictions we are keeping to the start */
-	for (i = last; i < index.header.prediction_count; i++) {
-		pnum = i - last;
-		index.predictions[pnum] = index.predictions[i];
-	}
-
-	/* set prediction pointers for 'last' in the newly empty
-	 * entries to NULL
+	/* the predictions we are keeping become the first ones; the
+	 * index does not move them, nor read them again from flash
 	 */
-	for (pnum = index.header.prediction_count - last; pnum <
-	      index.header.prediction_count; pnum++) {
-		index.predictions[pnum] = NULL;
-	}
+	npgps_index_discard(last, index.header.prediction_count);
 	npgps_print_blocks();
 
 	/* update index and header for new first stored prediction */
@@ -584,11 +580,11 @@ int nrf_cloud_pgps_find_prediction(struct nrf_cloud_pgps_prediction **prediction
 
 	LOG_DBG("Selected prediction num:%d", pnum);
 	index.cur_pnum = pnum;
-	*prediction = index.predictions[pnum];
+	/* the index checks the stored prediction only on first use */
+	err = npgps_index_find(pnum, cur_gps_sec,
+			       period_min * SEC_PER_MIN + (margin ? PGPS_MARGIN_SEC : 0),
+			       validate_prediction_format, prediction);
 	if (*prediction) {
-		err = validate_prediction(*prediction,
-					  cur_gps_day, cur_gps_time_of_day,
-					  period_min, false, margin);
 		if (!err) {
 			start_expiration_timer(pnum, cur_gps_sec);
 			return pnum;
@@ -1375,7 +1371,7 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 	if (parsed_len == buf_len) {
 		LOG_DBG("Parsing finished");
 
-		if (index.predictions[pnum]) {
+		if (npgps_index_get(pnum)) {
 			LOG_WRN("Received duplicate packet; ignoring");
 		} else if (gps_sec == 0) {
 			LOG_ERR("Prediction did not include GPS day and time of day; ignoring");
@@ -1390,7 +1386,7 @@ static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
 			finished = (index.loading_count == index.expected_count);
 			store_prediction(prediction_ptr, buf_len, (uint32_t)gps_sec,
 					 finished || (index.storage_extent == 1));
-			index.predictions[pnum] = npgps_block_to_pointer(index.store_block);
+			npgps_index_set(pnum, npgps_block_to_pointer(index.store_block));
 
 			if (pgps_need_assistance &&
 			    (finished || (index.loading_count > 1))) {
@@ -1475,11 +1471,11 @@ int nrf_cloud_pgps_begin_update(void)
 		index.header.prediction_period_min = PREDICTION_PERIOD;
 		index.period_sec =
 			index.header.prediction_period_min * SEC_PER_MIN;
-		memset(index.predictions, 0, sizeof(index.predictions));
+		npgps_index_reset();
 	} else {
 		for (uint8_t pnum = index.pnum_offset;
 		     pnum < index.expected_count + index.pnum_offset; pnum++) {
-			index.predictions[pnum] = NULL;
+			npgps_index_set(pnum, NULL);
 		}
 	}
 	index.loading_count = 0;
@@ -1598,6 +1594,7 @@ int nrf_cloud_pgps_init(struct nrf_cloud_pgps_init_param *param)
 	(void)ngps_block_pool_init(param->storage_base, NUM_PREDICTIONS);
 
 	memset(&index, 0, sizeof(index));
+	npgps_index_reset();
 	(void)npgps_settings_init();
 
 #if defined(CONFIG_NRF_CLOUD_PGPS_DOWNLOAD_TRANSPORT_HTTP)
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <net/nrf_cloud_pgps.h>
+
+#include "nrf_cloud_pgps_utils.h"
+#include "nrf_cloud_pgps_index.h"
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
+
+struct index_entry {
+	struct nrf_cloud_pgps_prediction *p;
+	/* start of the prediction, in GPS seconds; valid if checked is set */
+	uint32_t gps_sec;
+	bool checked;
+};
+
+/* entries are kept in a ring so discarding the oldest predictions
+ * does not move the ones that are kept
+ */
+static struct index_entry entries[NUM_PREDICTIONS];
+static int first;
+
+static struct index_entry *entry(int pnum)
+{
+	__ASSERT((pnum >= 0) && (pnum < NUM_PREDICTIONS), "invalid prediction num:%d", pnum);
+	return &entries[(first + pnum) % NUM_PREDICTIONS];
+}
+
+void npgps_index_reset(void)
+{
+	memset(entries, 0, sizeof(entries));
+	first = 0;
+}
+
+struct nrf_cloud_pgps_prediction *npgps_index_get(int pnum)
+{
+	return entry(pnum)->p;
+}
+
+void npgps_index_set(int pnum, struct nrf_cloud_pgps_prediction *p)
+{
+	struct index_entry *e = entry(pnum);
+
+	e->p = p;
+	e->checked = false;
+}
+
+void npgps_index_discard(int num, int count)
+{
+	int pnum;
+
+	for (pnum = 0; pnum < num; pnum++) {
+		npgps_index_set(pnum, NULL);
+	}
+	first = (first + num) % NUM_PREDICTIONS;
+
+	/* the entries after the ones we kept are free */
+	for (pnum = count - num; pnum < count; pnum++) {
+		npgps_index_set(pnum, NULL);
+	}
+}
+
+int npgps_index_find(int pnum, int64_t gps_sec, uint32_t window_sec,
+		     npgps_index_check_t check,
+		     struct nrf_cloud_pgps_prediction **prediction)
+{
+	struct index_entry *e = entry(pnum);
+	int err;
+
+	*prediction = e->p;
+	if (e->p == NULL) {
+		return -ENOENT;
+	}
+
+	if (!e->checked) {
+		err = check(e->p);
+		if (err) {
+			return err;
+		}
+		e->gps_sec = (uint32_t)npgps_gps_day_time_to_sec(e->p->time.date_day,
+								 e->p->time.time_full_s);
+		e->checked = true;
+	}
+
+	if ((gps_sec < e->gps_sec) || (gps_sec > ((int64_t)e->gps_sec + window_sec))) {
+		LOG_ERR("prediction does not contain desired time; "
+			"start:%u, cur:%d, end:%u",
+			e->gps_sec, (int32_t)gps_sec, e->gps_sec + window_sec);
+		return -EINVAL;
+	}
+	return 0;
+}
@@ -660,7 +660,7 @@ clean_up:
 		k_free(auth_hdr);
 	}
 	if (payload) {
-		cJSON_free(payload);
+		k_free(payload);
 	}
 
 	if (result) {
@@ -1290,30 +1290,35 @@ int nrf_cloud_rest_send_location(struct nrf_cloud_rest_context *const rest_ctx,
 	__ASSERT_NO_MSG(device_id != NULL);
 	__ASSERT_NO_MSG(gnss != NULL);
 
-	int err = -ENOMEM;
+	int err;
+	int len;
 	char *json_msg = NULL;
-	cJSON *msg_obj = NULL;
-
-	(void)nrf_cloud_codec_init();
 
-	msg_obj = cJSON_CreateObject();
-	err = nrf_cloud_gnss_msg_json_encode(gnss, msg_obj);
-	if (err) {
+	/* Allocate the message only, with its exact length */
+	len = nrf_cloud_gnss_msg_json_encode_buf(gnss, NULL, 0);
+	if (len < 0) {
+		err = len;
 		goto clean_up;
 	}
 
-	json_msg = cJSON_PrintUnformatted(msg_obj);
+	json_msg = k_malloc(len + 1);
 	if (!json_msg) {
-		LOG_ERR("Failed to print JSON");
+		err = -ENOMEM;
+		goto clean_up;
+	}
+
+	len = nrf_cloud_gnss_msg_json_encode_buf(gnss, json_msg, len + 1);
+	if (len < 0) {
+		LOG_ERR("Failed to encode GNSS message");
+		err = len;
 		goto clean_up;
 	}
 
 	err = nrf_cloud_rest_send_device_message(rest_ctx, device_id, json_msg, false, NULL);
 
 clean_up:
-	cJSON_Delete(msg_obj);
 	if (json_msg) {
-		cJSON_free((void *)json_msg);
+		k_free(json_msg);
 	}
 
 	return err;
@@ -4,7 +4,6 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
-#include <stdio.h>
 #include <zephyr/kernel_structs.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/byteorder.h>
@@ -22,9 +21,6 @@ enum state {
 	STATE_TERMINATED,
 };
 
-/* By default, when there is no shell, all events are profiled. */
-struct nrf_profiler_event_enabled_bm _nrf_profiler_event_enabled_bm;
-
 static K_SEM_DEFINE(nrf_profiler_sem, 0, 1);
 static atomic_t nrf_profiler_state;
 static uint16_t fatal_error_event_id;
@@ -36,21 +32,6 @@ enum nordic_command {
 	NORDIC_COMMAND_INFO	= 3
 };
 
-char descr[NRF_PROFILER_MAX_NUMBER_OF_APPLICATION_AND_INTERNAL_EVENTS]
-	  [CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS];
-static char *arg_types_encodings[] = {
-					"u8",  /* uint8_t */
-					"s8",  /* int8_t */
-					"u16", /* uint16_t */
-					"s16", /* int16_t */
-					"u32", /* uint32_t */
-					"s32", /* int32_t */
-					"s",   /* string */
-					"t"    /* time */
-				     };
-
-uint8_t nrf_profiler_num_events;
-
 static uint8_t buffer_data[CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE];
 static uint8_t buffer_info[CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE];
 static uint8_t buffer_commands[CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE];
@@ -104,7 +85,9 @@ static void send_system_description(void)
 	int err = 0;
 
 	for (size_t t = 0; ((t < ne) && !err); t++) {
-		err = send_info_data(descr[t], strlen(descr[t]));
+		const char *event_descr = nrf_profiler_get_event_descr(t);
+
+		err = send_info_data(event_descr, strlen(event_descr));
 		if (!err) {
 			err = send_info_data(&end_line, 1);
 		}
@@ -216,130 +199,6 @@ void nrf_profiler_term(void)
 	k_sem_take(&nrf_profiler_sem, K_FOREVER);
 }
 
-const char *nrf_profiler_get_event_descr(size_t nrf_profiler_event_id)
-{
-	return descr[nrf_profiler_event_id];
-}
-
-uint16_t nrf_profiler_register_event_type(const char *name, const char * const *args,
-				   const enum nrf_profiler_arg *arg_types,
-				   uint8_t arg_cnt)
-{
-	/* Lock to make sure that this function can be called
-	 * from multiple threads
-	 */
-	k_sched_lock();
-	uint8_t ne = nrf_profiler_num_events;
-
-	__ASSERT_NO_MSG(ne + 1 <= NRF_PROFILER_MAX_NUMBER_OF_APPLICATION_AND_INTERNAL_EVENTS);
-	size_t temp = snprintf(descr[ne],
-			CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS,
-			"%s,%d", name, ne);
-	size_t pos = temp;
-
-	__ASSERT_NO_MSG((pos < CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
-			 && (temp > 0));
-
-	for (size_t t = 0; t < arg_cnt; t++) {
-		temp = snprintf(descr[ne] + pos,
-			 CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS - pos,
-			 ",%s", arg_types_encodings[arg_types[t]]);
-		pos += temp;
-		__ASSERT_NO_MSG(
-		  (pos < CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
-		   && (temp > 0));
-	}
-
-	for (size_t t = 0; t < arg_cnt; t++) {
-		temp = snprintf(descr[ne] + pos,
-			CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS - pos,
-			",%s", args[t]);
-		pos += temp;
-		__ASSERT_NO_MSG(
-		  (pos < CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
-		   && (temp > 0));
-	}
-	/* Memory barrier to make sure that data is visible
-	 * before being accessed
-	 */
-	__DMB();
-	nrf_profiler_num_events++;
-	k_sched_unlock();
-
-	return ne;
-}
-
-void nrf_profiler_log_start(struct log_event_buf *buf)
-{
-	/* Adding one to pointer to make space for event type ID */
-	buf->payload = buf->payload_start + sizeof(uint8_t);
-	nrf_profiler_log_encode_uint32(buf, k_cycle_get_32());
-}
-
-void nrf_profiler_log_encode_uint32(struct log_event_buf *buf, uint32_t data)
-{
-	__ASSERT_NO_MSG(buf->payload - buf->payload_start + sizeof(data)
-			 <= CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN);
-	sys_put_le32(data, buf->payload);
-	buf->payload += sizeof(data);
-}
-
-void nrf_profiler_log_encode_int32(struct log_event_buf *buf, int32_t data)
-{
-	nrf_profiler_log_encode_uint32(buf, (uint32_t)data);
-}
-
-void nrf_profiler_log_encode_uint16(struct log_event_buf *buf, uint16_t data)
-{
-	__ASSERT_NO_MSG(buf->payload - buf->payload_start + sizeof(data)
-			 <= CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN);
-	sys_put_le16(data, buf->payload);
-	buf->payload += sizeof(data);
-}
-
-void nrf_profiler_log_encode_int16(struct log_event_buf *buf, int16_t data)
-{
-	nrf_profiler_log_encode_uint16(buf, (uint16_t)data);
-}
-
-void nrf_profiler_log_encode_uint8(struct log_event_buf *buf, uint8_t data)
-{
-	__ASSERT_NO_MSG(buf->payload - buf->payload_start + sizeof(data)
-			 <= CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN);
-	*(buf->payload) = data;
-	buf->payload += sizeof(data);
-}
-
-void nrf_profiler_log_encode_int8(struct log_event_buf *buf, int8_t data)
-{
-	nrf_profiler_log_encode_uint8(buf, (uint8_t)data);
-}
-
-void nrf_profiler_log_encode_string(struct log_event_buf *buf, const char *string)
-{
-	size_t string_len = strlen(string);
-
-	if (string_len > UINT8_MAX) {
-		string_len = UINT8_MAX;
-	}
-	/* First byte that is send denotes string length.
-	 * Null character is not being sent.
-	 */
-	__ASSERT_NO_MSG(buf->payload - buf->payload_start + sizeof(uint8_t) + string_len
-			 <= CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN);
-	*(buf->payload) = (uint8_t) string_len;
-	buf->payload++;
-
-	memcpy(buf->payload, string, string_len);
-	buf->payload += string_len;
-}
-
-void nrf_profiler_log_add_mem_address(struct log_event_buf *buf,
-				  const void *mem_address)
-{
-	nrf_profiler_log_encode_uint32(buf, (uint32_t)mem_address);
-}
-
 static bool nrf_profiler_RTT_send(struct log_event_buf *buf, uint8_t type_id)
 {
 	buf->payload_start[0] = type_id;
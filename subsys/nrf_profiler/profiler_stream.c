@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/sys/byteorder.h>
+#include <nrf_profiler.h>
+
+#define RING_SLOTS	CONFIG_NRF_PROFILER_STREAM_RING_SLOTS
+#define RING_MASK	(RING_SLOTS - 1)
+
+/* Event as stored by nrf_profiler_log_start: type ID followed by timestamp. */
+#define EVENT_HDR_LEN	(sizeof(uint8_t) + sizeof(uint32_t))
+
+/* Every frame starts with frame ID and body length. */
+#define FRAME_HDR_LEN	2
+#define FRAME_MAX_LEN	(FRAME_HDR_LEN + UINT8_MAX)
+#define VARINT_MAX_LEN	5
+
+/* Frames are COBS-encoded and terminated with a zero byte, so the host can
+ * find the start of the next frame after a transmission error. The encoding
+ * adds one byte per 254 bytes of data and the delimiter.
+ */
+#define FRAME_DELIMITER		0x00
+#define COBS_MAX_LEN(len)	((len) + ceiling_fraction((len), 254) + 1)
+#define FRAME_ENCODED_MAX_LEN(len) (COBS_MAX_LEN(len) + 1)
+
+#define FRAME_EVENT_MAX_LEN \
+	(FRAME_HDR_LEN + VARINT_MAX_LEN + CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN - EVENT_HDR_LEN)
+#define FRAME_DESCR_MAX_LEN \
+	(FRAME_HDR_LEN + CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(RING_SLOTS),
+	     "Number of ring buffer slots must be a power of two");
+BUILD_ASSERT(CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN <= UINT8_MAX,
+	     "Event does not fit in a single frame");
+BUILD_ASSERT(CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS <= UINT8_MAX + 1,
+	     "Event description does not fit in a single frame");
+BUILD_ASSERT(CONFIG_NRF_PROFILER_STREAM_TX_BUF_SIZE >=
+	     1 + FRAME_ENCODED_MAX_LEN(MAX(FRAME_EVENT_MAX_LEN, FRAME_DESCR_MAX_LEN)),
+	     "TX buffer cannot hold the biggest frame");
+
+enum state {
+	STATE_DISABLED,
+	STATE_INACTIVE,
+	STATE_ACTIVE,
+	STATE_TERMINATED,
+};
+
+enum stream_command {
+	STREAM_COMMAND_START	= 1,
+	STREAM_COMMAND_STOP	= 2,
+	STREAM_COMMAND_INFO	= 3
+};
+
+/* Frame IDs not used by event types. Event frames use the event type ID. */
+enum stream_frame {
+	STREAM_FRAME_TIME	= 0xFC,
+	STREAM_FRAME_CLOCK	= 0xFD,
+	STREAM_FRAME_DESCR	= 0xFE,
+	STREAM_FRAME_DROP	= 0xFF
+};
+
+BUILD_ASSERT(NRF_PROFILER_MAX_NUMBER_OF_APPLICATION_AND_INTERNAL_EVENTS <= STREAM_FRAME_TIME,
+	     "Event type IDs overlap with special frame IDs");
+
+struct ring_slot {
+	/* Sequence number used to pass slot ownership between the producers
+	 * and the consumer.
+	 */
+	atomic_t seq;
+	uint8_t len;
+	uint8_t data[CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN];
+};
+
+/* Bounded multi-producer single-consumer ring buffer. Producers (threads and
+ * interrupts) reserve a slot by advancing head and publish it by updating slot
+ * sequence number, so no lock is taken on the logging path.
+ */
+static struct {
+	atomic_t head;
+	atomic_t tail;
+	atomic_t dropped;
+	struct ring_slot slots[RING_SLOTS];
+} ring;
+
+static K_SEM_DEFINE(nrf_profiler_sem, 0, 1);
+static K_SEM_DEFINE(flush_sem, 0, 1);
+static atomic_t nrf_profiler_state;
+
+static uint8_t tx_buf[CONFIG_NRF_PROFILER_STREAM_TX_BUF_SIZE];
+static size_t tx_len;
+/* Frame being built, before it is encoded into the TX buffer. */
+static uint8_t frame_buf[FRAME_MAX_LEN];
+static uint32_t last_timestamp;
+
+static K_THREAD_STACK_DEFINE(nrf_profiler_stream_stack,
+			     CONFIG_NRF_PROFILER_STREAM_STACK_SIZE);
+static struct k_thread nrf_profiler_stream_thread;
+
+
+static inline int32_t seq_diff(atomic_val_t a, atomic_val_t b)
+{
+	return (int32_t)((uint32_t)a - (uint32_t)b);
+}
+
+static void ring_init(void)
+{
+	for (size_t i = 0; i < RING_SLOTS; i++) {
+		atomic_set(&ring.slots[i].seq, i);
+	}
+	atomic_set(&ring.head, 0);
+	atomic_set(&ring.tail, 0);
+	atomic_set(&ring.dropped, 0);
+}
+
+static bool ring_put(const uint8_t *data, size_t len)
+{
+	atomic_val_t pos = atomic_get(&ring.head);
+	struct ring_slot *slot;
+
+	while (true) {
+		slot = &ring.slots[pos & RING_MASK];
+
+		int32_t diff = seq_diff(atomic_get(&slot->seq), pos);
+
+		if (diff == 0) {
+			if (atomic_cas(&ring.head, pos, pos + 1)) {
+				break;
+			}
+		} else if (diff < 0) {
+			/* Slot still owned by the consumer - ring is full. */
+			return false;
+		}
+
+		pos = atomic_get(&ring.head);
+	}
+
+	memcpy(slot->data, data, len);
+	slot->len = len;
+	atomic_set(&slot->seq, pos + 1);
+
+	/* Do not wait for the flush period if the ring is filling up. */
+	if (seq_diff(pos, atomic_get(&ring.tail)) == RING_SLOTS / 2) {
+		k_sem_give(&flush_sem);
+	}
+
+	return true;
+}
+
+static void tx_flush(void)
+{
+	if (tx_len > 0) {
+		/* There is no way to report the error to the host - frames
+		 * that the sink fails to write are lost.
+		 */
+		(void)nrf_profiler_stream_sink_write(tx_buf, tx_len);
+		tx_len = 0;
+	}
+}
+
+static uint8_t *tx_frame_start(uint8_t frame_id, size_t body_len)
+{
+	__ASSERT_NO_MSG(body_len <= UINT8_MAX);
+
+	frame_buf[0] = frame_id;
+	frame_buf[1] = body_len;
+
+	return &frame_buf[FRAME_HDR_LEN];
+}
+
+static size_t cobs_encode(uint8_t *out, const uint8_t *data, size_t len)
+{
+	size_t code_pos = 0;
+	size_t out_len = 1;
+	uint8_t code = 1;
+
+	for (size_t i = 0; i < len; i++) {
+		if (data[i] != 0) {
+			out[out_len++] = data[i];
+			code++;
+		}
+
+		if ((data[i] == 0) || (code == 0xFF)) {
+			out[code_pos] = code;
+			code_pos = out_len++;
+			code = 1;
+		}
+	}
+	out[code_pos] = code;
+
+	return out_len;
+}
+
+static void tx_frame_end(void)
+{
+	size_t len = FRAME_HDR_LEN + frame_buf[1];
+
+	if (tx_len + FRAME_ENCODED_MAX_LEN(len) > sizeof(tx_buf)) {
+		tx_flush();
+	}
+
+	/* Every write to the sink starts with a delimiter, so the first frame
+	 * of the write is not merged with a frame lost in transmission.
+	 */
+	if (tx_len == 0) {
+		tx_buf[tx_len++] = FRAME_DELIMITER;
+	}
+
+	tx_len += cobs_encode(&tx_buf[tx_len], frame_buf, len);
+	tx_buf[tx_len++] = FRAME_DELIMITER;
+}
+
+static size_t varint_encode(uint8_t *buf, uint32_t value)
+{
+	size_t len = 0;
+
+	while (value >= 0x80) {
+		buf[len++] = (value & 0x7F) | 0x80;
+		value >>= 7;
+	}
+	buf[len++] = value;
+
+	return len;
+}
+
+static void encode_event(const uint8_t *data, size_t len)
+{
+	/* Timestamp is encoded as a signed difference to the previous event,
+	 * because events logged from preempting contexts can be stored out of
+	 * order.
+	 */
+	uint32_t timestamp = sys_get_le32(&data[sizeof(uint8_t)]);
+	int32_t delta = (int32_t)(timestamp - last_timestamp);
+	uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+	uint8_t ts_buf[VARINT_MAX_LEN];
+	size_t ts_len = varint_encode(ts_buf, zigzag);
+	size_t payload_len = len - EVENT_HDR_LEN;
+	uint8_t *body = tx_frame_start(data[0], ts_len + payload_len);
+
+	memcpy(body, ts_buf, ts_len);
+	memcpy(body + ts_len, &data[EVENT_HDR_LEN], payload_len);
+	tx_frame_end();
+	last_timestamp = timestamp;
+}
+
+static void ring_drain(void)
+{
+	atomic_val_t pos = atomic_get(&ring.tail);
+	bool time_sent = false;
+
+	while (true) {
+		struct ring_slot *slot = &ring.slots[pos & RING_MASK];
+
+		if (seq_diff(atomic_get(&slot->seq), pos + 1) < 0) {
+			/* Slot not yet published. */
+			break;
+		}
+
+		if (!time_sent) {
+			/* The absolute timestamp lets the host restore the time
+			 * base after frames were lost in transmission.
+			 */
+			sys_put_le32(last_timestamp,
+				     tx_frame_start(STREAM_FRAME_TIME, sizeof(uint32_t)));
+			tx_frame_end();
+			time_sent = true;
+		}
+
+		encode_event(slot->data, slot->len);
+		atomic_set(&slot->seq, pos + RING_SLOTS);
+		pos++;
+	}
+	atomic_set(&ring.tail, pos);
+
+	atomic_val_t dropped = atomic_set(&ring.dropped, 0);
+
+	if (dropped > 0) {
+		sys_put_le32(dropped, tx_frame_start(STREAM_FRAME_DROP, sizeof(uint32_t)));
+		tx_frame_end();
+	}
+}
+
+static void stream_start(void)
+{
+	uint8_t *body = tx_frame_start(STREAM_FRAME_CLOCK, 2 * sizeof(uint32_t));
+
+	/* Timestamps of the following events are relative to the base
+	 * sent in the clock frame.
+	 */
+	last_timestamp = k_cycle_get_32();
+	sys_put_le32(sys_clock_hw_cycles_per_sec(), body);
+	sys_put_le32(last_timestamp, body + sizeof(uint32_t));
+	tx_frame_end();
+
+	atomic_cas(&nrf_profiler_state, STATE_INACTIVE, STATE_ACTIVE);
+}
+
+static void send_system_description(void)
+{
+	uint8_t ne = nrf_profiler_num_events;
+
+	/* Memory barrier to make sure that data is visible
+	 * before being accessed
+	 */
+	__sync_synchronize();
+
+	for (size_t t = 0; t < ne; t++) {
+		const char *event_descr = nrf_profiler_get_event_descr(t);
+		size_t len = strlen(event_descr);
+
+		memcpy(tx_frame_start(STREAM_FRAME_DESCR, len), event_descr, len);
+		tx_frame_end();
+	}
+
+	/* Empty description is sent after last event description. */
+	(void)tx_frame_start(STREAM_FRAME_DESCR, 0);
+	tx_frame_end();
+}
+
+static void handle_command(uint8_t read_data)
+{
+	enum stream_command command = (enum stream_command)read_data;
+
+	switch (command) {
+	case STREAM_COMMAND_START:
+		if (atomic_get(&nrf_profiler_state) == STATE_INACTIVE) {
+			stream_start();
+		}
+		break;
+	case STREAM_COMMAND_STOP:
+		atomic_cas(&nrf_profiler_state, STATE_ACTIVE, STATE_INACTIVE);
+		break;
+	case STREAM_COMMAND_INFO:
+		send_system_description();
+		break;
+	default:
+		/* Ignore noise on the transport. */
+		break;
+	}
+}
+
+static void nrf_profiler_stream_thread_fn(void)
+{
+	while (atomic_get(&nrf_profiler_state) != STATE_TERMINATED) {
+		uint8_t read_data;
+
+		(void)k_sem_take(&flush_sem, K_MSEC(CONFIG_NRF_PROFILER_STREAM_FLUSH_PERIOD_MS));
+
+		ring_drain();
+
+		while (!nrf_profiler_stream_sink_read_cmd(&read_data)) {
+			handle_command(read_data);
+		}
+
+		tx_flush();
+	}
+
+	ring_drain();
+	tx_flush();
+	k_sem_give(&nrf_profiler_sem);
+}
+
+int nrf_profiler_init(void)
+{
+	k_sched_lock();
+
+	if (!atomic_cas(&nrf_profiler_state, STATE_DISABLED, STATE_INACTIVE)) {
+		k_sched_unlock();
+		return 0;
+	}
+
+	int err = nrf_profiler_stream_sink_init();
+
+	if (err) {
+		atomic_set(&nrf_profiler_state, STATE_DISABLED);
+		k_sched_unlock();
+		return err;
+	}
+
+	if (!IS_ENABLED(CONFIG_SHELL)) {
+		for (size_t i = 0; i < NRF_PROFILER_MAX_NUMBER_OF_APPLICATION_AND_INTERNAL_EVENTS;
+		     i++) {
+			atomic_set_bit(_nrf_profiler_event_enabled_bm.flags, i);
+		}
+	}
+
+	ring_init();
+
+	if (IS_ENABLED(CONFIG_NRF_PROFILER_STREAM_START_LOGGING_ON_SYSTEM_START)) {
+		/* The thread is not running yet, so it is safe to use the TX
+		 * buffer from here.
+		 */
+		stream_start();
+	}
+
+	k_thread_create(&nrf_profiler_stream_thread,
+			nrf_profiler_stream_stack,
+			K_THREAD_STACK_SIZEOF(nrf_profiler_stream_stack),
+			(k_thread_entry_t)nrf_profiler_stream_thread_fn,
+			NULL, NULL, NULL,
+			CONFIG_NRF_PROFILER_STREAM_THREAD_PRIORITY, 0, K_NO_WAIT);
+	k_thread_name_set(&nrf_profiler_stream_thread, "nrf_profiler_stream");
+
+	k_sched_unlock();
+	return 0;
+}
+
+void nrf_profiler_term(void)
+{
+	if (atomic_set(&nrf_profiler_state, STATE_TERMINATED) == STATE_TERMINATED) {
+		/* Already terminated. */
+		return;
+	}
+
+	k_sem_give(&flush_sem);
+	k_sem_take(&nrf_profiler_sem, K_FOREVER);
+}
+
+void nrf_profiler_log_send(struct log_event_buf *buf, uint16_t event_type_id)
+{
+	__ASSERT_NO_MSG(event_type_id <= UINT8_MAX);
+
+	if (atomic_get(&nrf_profiler_state) == STATE_ACTIVE) {
+		buf->payload_start[0] = event_type_id & UINT8_MAX;
+
+		if (!ring_put(buf->payload_start, buf->payload - buf->payload_start)) {
+			atomic_inc(&ring.dropped);
+		}
+	}
+}
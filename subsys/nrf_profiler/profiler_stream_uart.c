@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include <nrf_profiler.h>
+
+static const struct device *const uart_dev = DEVICE_DT_GET(DT_CHOSEN(ncs_nrf_profiler_uart));
+
+int nrf_profiler_stream_sink_init(void)
+{
+	if (!device_is_ready(uart_dev)) {
+		return -ENODEV;
+	}
+
+	return 0;
+}
+
+int nrf_profiler_stream_sink_write(const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(uart_dev, data[i]);
+	}
+
+	return 0;
+}
+
+int nrf_profiler_stream_sink_read_cmd(uint8_t *cmd)
+{
+	return uart_poll_in(uart_dev, cmd) ? -EAGAIN : 0;
+}
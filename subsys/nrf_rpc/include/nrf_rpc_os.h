@@ -42,6 +42,34 @@ int nrf_rpc_os_init(nrf_rpc_os_work_t callback);
 
 void nrf_rpc_os_thread_pool_send(const uint8_t *data, size_t len);
 
+/* Thread pool statistics, see CONFIG_NRF_RPC_THREAD_POOL_STATS. */
+struct nrf_rpc_os_thread_pool_stats {
+	/* Number of commands taken from the queues. */
+	uint32_t cmds;
+	/* Longest time a command waited in a queue, in microseconds. */
+	uint32_t wait_max_us;
+	/* Sum of the queue wait times, in microseconds. */
+	uint64_t wait_total_us;
+};
+
+/* Pins the commands of a group to a dedicated worker thread.
+ *
+ * @param group_id ID of the group, as sent in the packet header.
+ * @param worker Index of the dedicated worker, less than
+ *               CONFIG_NRF_RPC_THREAD_POOL_AFFINITY_WORKERS, or a negative
+ *               value to use the shared thread pool again.
+ *
+ * @return 0 on success, -NRF_EINVAL if the worker does not exist.
+ */
+int nrf_rpc_os_thread_pool_affinity_set(uint8_t group_id, int worker);
+
+void nrf_rpc_os_thread_pool_stats_get(struct nrf_rpc_os_thread_pool_stats *stats);
+
+/* Number of commands of a group taken from the queues. */
+uint32_t nrf_rpc_os_thread_pool_group_cmds(uint8_t group_id);
+
+void nrf_rpc_os_thread_pool_stats_reset(void);
+
 static inline int nrf_rpc_os_event_init(struct nrf_rpc_os_event *event)
 {
 	return k_sem_init(&event->sem, 0, 1);
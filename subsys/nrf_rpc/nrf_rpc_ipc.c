@@ -30,6 +30,14 @@ do {									       \
 	}								       \
 } while (0)
 
+/* Tx buffer allocated on the heap when the packet does not fit in the IPC
+ * Service shared memory.
+ */
+struct heap_buf {
+	sys_snode_t node;
+	uint8_t data[];
+};
+
 /* Translates error code from the lower layer to nRF RPC error code. */
 static int translate_error(int ll_err)
 {
@@ -125,6 +133,7 @@ static int init(const struct nrf_rpc_tr *transport, nrf_rpc_tr_receive_handler_t
 	cfg->priv = (void *)transport;
 
 	k_event_init(&endpoint->ept_bond);
+	sys_slist_init(&ipc_config->heap_bufs);
 
 	err = ipc_service_register_endpoint(ipc_config->ipc, &endpoint->ept, cfg);
 	if (err) {
@@ -142,9 +151,51 @@ static int init(const struct nrf_rpc_tr *transport, nrf_rpc_tr_receive_handler_t
 		return -NRF_EPIPE;
 	}
 
+	ipc_config->tx_buf_size = 0;
+	if (IS_ENABLED(CONFIG_NRF_RPC_IPC_SERVICE_NOCOPY)) {
+		err = ipc_service_get_tx_buffer_size(&endpoint->ept);
+		if (err > 0) {
+			ipc_config->tx_buf_size = err;
+		} else {
+			LOG_DBG("No-copy Tx not available (%d), using heap", err);
+		}
+	}
+
 	return 0;
 }
 
+static void *heap_buf_alloc(struct nrf_rpc_ipc *ipc_config, size_t size)
+{
+	struct heap_buf *buf;
+	k_spinlock_key_t key;
+
+	buf = k_malloc(sizeof(*buf) + size);
+	if (!buf) {
+		return NULL;
+	}
+
+	key = k_spin_lock(&ipc_config->heap_bufs_lock);
+	sys_slist_append(&ipc_config->heap_bufs, &buf->node);
+	k_spin_unlock(&ipc_config->heap_bufs_lock, key);
+
+	return buf->data;
+}
+
+/* Returns the heap buffer containing data, or NULL if data is in the shared memory. */
+static struct heap_buf *heap_buf_remove(struct nrf_rpc_ipc *ipc_config, const void *data)
+{
+	/* Only the address of the node is used until it is found in the list. */
+	struct heap_buf *buf = CONTAINER_OF(data, struct heap_buf, data);
+	k_spinlock_key_t key;
+	bool found;
+
+	key = k_spin_lock(&ipc_config->heap_bufs_lock);
+	found = sys_slist_find_and_remove(&ipc_config->heap_bufs, &buf->node);
+	k_spin_unlock(&ipc_config->heap_bufs_lock, key);
+
+	return found ? buf : NULL;
+}
+
 int send(const struct nrf_rpc_tr *transport, const uint8_t *data, size_t length)
 {
 	int err;
@@ -159,21 +210,36 @@ int send(const struct nrf_rpc_tr *transport, const uint8_t *data, size_t length)
 	LOG_DBG("Sending %u bytes", length);
 	DUMP_LIMITED_DBG(data, length, "Data: ");
 
-	err = ipc_service_send(&endpoint->ept, data, length);
+	if (ipc_config->tx_buf_size == 0) {
+		err = ipc_service_send(&endpoint->ept, data, length);
+		k_free((void *)data);
+	} else {
+		struct heap_buf *buf = heap_buf_remove(ipc_config, data);
+
+		if (buf) {
+			err = ipc_service_send(&endpoint->ept, data, length);
+			k_free(buf);
+		} else {
+			err = ipc_service_send_nocopy(&endpoint->ept, data, length);
+			if (err < 0) {
+				(void)ipc_service_drop_tx_buffer(&endpoint->ept, data);
+			}
+		}
+	}
+
 	if (err < 0) {
-		LOG_ERR("ipc_service_send returned err: %d", err);
+		LOG_ERR("Sending failed with err: %d", err);
 	} else if (err > 0) {
 		LOG_DBG("Sent %u bytes", err);
 		err = 0;
 	}
 
-	k_free((void *)data);
-
 	return translate_error(err);
 }
 
 void *tx_buf_alloc(const struct nrf_rpc_tr *transport, size_t *size)
 {
+	int err;
 	void *data = NULL;
 	struct nrf_rpc_ipc *ipc_config = transport->ctx;
 
@@ -182,7 +248,22 @@ void *tx_buf_alloc(const struct nrf_rpc_tr *transport, size_t *size)
 		goto error;
 	}
 
-	data = k_malloc(*size);
+	if (ipc_config->tx_buf_size == 0) {
+		data = k_malloc(*size);
+	} else if (*size > (size_t)ipc_config->tx_buf_size) {
+		data = heap_buf_alloc(ipc_config, *size);
+	} else {
+		uint32_t len = *size;
+
+		/* Packet is encoded directly in the shared memory. */
+		err = ipc_service_get_tx_buffer(&ipc_config->endpoint.ept, &data, &len,
+						K_FOREVER);
+		if (err < 0) {
+			LOG_ERR("ipc_service_get_tx_buffer returned err: %d", err);
+			data = NULL;
+		}
+	}
+
 	if (!data) {
 		LOG_ERR("Failed to allocate Tx buffer.");
 		goto error;
@@ -206,7 +287,17 @@ void tx_buf_free(const struct nrf_rpc_tr *transport, void *buf)
 		return;
 	}
 
-	k_free(buf);
+	if (ipc_config->tx_buf_size == 0) {
+		k_free(buf);
+	} else {
+		struct heap_buf *hbuf = heap_buf_remove(ipc_config, buf);
+
+		if (hbuf) {
+			k_free(hbuf);
+		} else {
+			(void)ipc_service_drop_tx_buffer(&ipc_config->endpoint.ept, buf);
+		}
+	}
 }
 
 const struct nrf_rpc_tr_api nrf_rpc_ipc_service_api = {
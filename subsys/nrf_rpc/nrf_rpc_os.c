@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
+
 #define NRF_RPC_LOG_MODULE NRF_RPC_OS
 #include <nrf_rpc_log.h>
 
@@ -12,45 +14,86 @@
 /* Maximum number of remote thread that this implementation allows. */
 #define MAX_REMOTE_THREADS 255
 
-/* Initial value contains ones (context free) on the
- * CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE most significant bits.
- */
-#define CONTEXT_MASK_INIT_VALUE						       \
-	(~(((atomic_val_t)1 << (8 * sizeof(atomic_val_t) -		       \
-				CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE)) - 1))
+/* Position of the group ID in the nRF RPC packet header. */
+#define PACKET_GROUP_ID_OFFSET 4
+
+#define QUEUE_SIZE CONFIG_NRF_RPC_THREAD_POOL_QUEUE_SIZE
+#define AFFINITY_WORKERS CONFIG_NRF_RPC_THREAD_POOL_AFFINITY_WORKERS
+#define WORKERS (CONFIG_NRF_RPC_THREAD_POOL_SIZE + AFFINITY_WORKERS)
 
 struct pool_start_msg {
 	const uint8_t *data;
 	size_t len;
+#if defined(CONFIG_NRF_RPC_THREAD_POOL_STATS)
+	uint32_t queued_cyc;
+#endif
 };
 
 static nrf_rpc_os_work_t thread_pool_callback;
 
-static struct pool_start_msg pool_start_msg_buf[2];
-static struct k_msgq pool_start_msg;
+/* Queue 0 is shared by the thread pool, the others are used by the
+ * dedicated workers.
+ */
+static struct pool_start_msg pool_start_msg_buf[1 + AFFINITY_WORKERS][QUEUE_SIZE];
+static struct k_msgq pool_start_msg[1 + AFFINITY_WORKERS];
+
+#if AFFINITY_WORKERS > 0
+/* Queue index of each group; 0 if the group is not pinned. */
+static uint8_t group_queue[UINT8_MAX + 1];
+#endif
+
+#if defined(CONFIG_NRF_RPC_THREAD_POOL_STATS)
+static struct k_spinlock stats_lock;
+static struct nrf_rpc_os_thread_pool_stats stats;
+static uint32_t group_cmds[UINT8_MAX + 1];
+#endif
 
 static struct k_sem context_reserved;
-static atomic_t context_mask;
+/* Set bits are free contexts. */
+static ATOMIC_DEFINE(context_mask, CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE);
 
-static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks,
-	CONFIG_NRF_RPC_THREAD_POOL_SIZE,
+static K_THREAD_STACK_ARRAY_DEFINE(pool_stacks, WORKERS,
 	CONFIG_NRF_RPC_THREAD_STACK_SIZE);
 
-static struct k_thread pool_threads[CONFIG_NRF_RPC_THREAD_POOL_SIZE];
+static struct k_thread pool_threads[WORKERS];
 
 BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE > 0,
 	     "CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE must be greaten than zero");
-BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE <= 8 * sizeof(atomic_val_t),
+BUILD_ASSERT(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE <= MAX_REMOTE_THREADS,
 	     "CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE too big");
-BUILD_ASSERT(sizeof(uint32_t) == sizeof(atomic_val_t),
-	     "Only atomic_val_t is implemented that is the same as uint32_t");
+BUILD_ASSERT(AFFINITY_WORKERS < UINT8_MAX,
+	     "CONFIG_NRF_RPC_THREAD_POOL_AFFINITY_WORKERS too big");
+
+#if defined(CONFIG_NRF_RPC_THREAD_POOL_STATS)
+static void stats_update(const struct pool_start_msg *msg)
+{
+	uint32_t wait_us = k_cyc_to_us_floor32(k_cycle_get_32() - msg->queued_cyc);
+	uint8_t group_id = 0;
+	k_spinlock_key_t key;
+
+	if (msg->len > PACKET_GROUP_ID_OFFSET) {
+		group_id = msg->data[PACKET_GROUP_ID_OFFSET];
+	}
+
+	key = k_spin_lock(&stats_lock);
+	stats.cmds++;
+	stats.wait_total_us += wait_us;
+	stats.wait_max_us = MAX(stats.wait_max_us, wait_us);
+	group_cmds[group_id]++;
+	k_spin_unlock(&stats_lock, key);
+}
+#endif
 
 static void thread_pool_entry(void *p1, void *p2, void *p3)
 {
+	struct k_msgq *queue = p1;
 	struct pool_start_msg msg;
 
 	do {
-		k_msgq_get(&pool_start_msg, &msg, K_FOREVER);
+		k_msgq_get(queue, &msg, K_FOREVER);
+#if defined(CONFIG_NRF_RPC_THREAD_POOL_STATS)
+		stats_update(&msg);
+#endif
 		thread_pool_callback(msg.data, msg.len);
 	} while (1);
 }
@@ -70,17 +113,23 @@ int nrf_rpc_os_init(nrf_rpc_os_work_t callback)
 		return err;
 	}
 
-	atomic_set(&context_mask, CONTEXT_MASK_INIT_VALUE);
+	for (i = 0; i < CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE; i++) {
+		atomic_set_bit(context_mask, i);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(pool_start_msg); i++) {
+		k_msgq_init(&pool_start_msg[i], (char *)pool_start_msg_buf[i],
+			    sizeof(struct pool_start_msg), QUEUE_SIZE);
+	}
 
-	k_msgq_init(&pool_start_msg, (char *)pool_start_msg_buf,
-		    sizeof(struct pool_start_msg),
-		    ARRAY_SIZE(pool_start_msg_buf));
+	for (i = 0; i < WORKERS; i++) {
+		/* Dedicated workers follow the shared pool threads. */
+		int queue = MAX(0, i - CONFIG_NRF_RPC_THREAD_POOL_SIZE + 1);
 
-	for (i = 0; i < CONFIG_NRF_RPC_THREAD_POOL_SIZE; i++) {
 		k_thread_create(&pool_threads[i], pool_stacks[i],
 			K_THREAD_STACK_SIZEOF(pool_stacks[i]),
 			thread_pool_entry,
-			NULL, NULL, NULL,
+			&pool_start_msg[queue], NULL, NULL,
 			CONFIG_NRF_RPC_THREAD_PRIORITY, 0, K_NO_WAIT);
 	}
 
@@ -90,12 +139,59 @@ int nrf_rpc_os_init(nrf_rpc_os_work_t callback)
 void nrf_rpc_os_thread_pool_send(const uint8_t *data, size_t len)
 {
 	struct pool_start_msg msg;
+	int queue = 0;
+
+#if AFFINITY_WORKERS > 0
+	if (len > PACKET_GROUP_ID_OFFSET) {
+		queue = group_queue[data[PACKET_GROUP_ID_OFFSET]];
+	}
+#endif
 
 	msg.data = data;
 	msg.len = len;
-	k_msgq_put(&pool_start_msg, &msg, K_FOREVER);
+#if defined(CONFIG_NRF_RPC_THREAD_POOL_STATS)
+	msg.queued_cyc = k_cycle_get_32();
+#endif
+	k_msgq_put(&pool_start_msg[queue], &msg, K_FOREVER);
+}
+
+int nrf_rpc_os_thread_pool_affinity_set(uint8_t group_id, int worker)
+{
+	if (worker >= AFFINITY_WORKERS) {
+		return -NRF_EINVAL;
+	}
+
+#if AFFINITY_WORKERS > 0
+	group_queue[group_id] = (worker < 0) ? 0 : worker + 1;
+#endif
+
+	return 0;
 }
 
+#if defined(CONFIG_NRF_RPC_THREAD_POOL_STATS)
+void nrf_rpc_os_thread_pool_stats_get(struct nrf_rpc_os_thread_pool_stats *out)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*out = stats;
+	k_spin_unlock(&stats_lock, key);
+}
+
+uint32_t nrf_rpc_os_thread_pool_group_cmds(uint8_t group_id)
+{
+	return group_cmds[group_id];
+}
+
+void nrf_rpc_os_thread_pool_stats_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	memset(&stats, 0, sizeof(stats));
+	memset(group_cmds, 0, sizeof(group_cmds));
+	k_spin_unlock(&stats_lock, key);
+}
+#endif
+
 void nrf_rpc_os_msg_set(struct nrf_rpc_os_msg *msg, const uint8_t *data,
 			size_t len)
 {
@@ -118,25 +214,33 @@ void nrf_rpc_os_msg_get(struct nrf_rpc_os_msg *msg, const uint8_t **data,
 
 uint32_t nrf_rpc_os_ctx_pool_reserve(void)
 {
-	uint32_t number;
+	int word = 0;
+	int bit;
 	atomic_val_t old_mask;
-	atomic_val_t new_mask;
 
 	k_sem_take(&context_reserved, K_FOREVER);
 
-	do {
-		old_mask = atomic_get(&context_mask);
-		number = __CLZ(old_mask);
-		new_mask = old_mask & ~(0x80000000u >> number);
-	} while (!atomic_cas(&context_mask, old_mask, new_mask));
-
-	return number;
+	/* The semaphore guarantees that a free context exists, but another
+	 * thread may take the one found in a word first; then try again.
+	 */
+	while (true) {
+		old_mask = atomic_get(&context_mask[word]);
+		if (old_mask != 0) {
+			bit = __builtin_ctzl(old_mask);
+			if (atomic_cas(&context_mask[word], old_mask,
+				       old_mask & ~BIT(bit))) {
+				return word * ATOMIC_BITS + bit;
+			}
+		} else {
+			word = (word + 1) % ARRAY_SIZE(context_mask);
+		}
+	}
 }
 
 void nrf_rpc_os_ctx_pool_release(uint32_t number)
 {
 	__ASSERT_NO_MSG(number < CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE);
 
-	atomic_or(&context_mask, 0x80000000u >> number);
+	atomic_set_bit(context_mask, number);
 	k_sem_give(&context_reserved);
 }
@@ -69,7 +69,7 @@ const void *pcd_cmd_data_ptr_get(void)
 
 #ifdef CONFIG_PCD_NET
 
-int pcd_fw_copy(const struct device *fdev)
+int pcd_fw_copy_cb(const struct device *fdev, stream_flash_callback_t cb)
 {
 	struct stream_flash_ctx stream;
 	uint8_t buf[CONFIG_PCD_BUF_SIZE];
@@ -80,7 +80,7 @@ int pcd_fw_copy(const struct device *fdev)
 	}
 
 	rc = stream_flash_init(&stream, fdev, buf, sizeof(buf),
-			       cmd->offset, 0, NULL);
+			       cmd->offset, 0, cb);
 	if (rc != 0) {
 		LOG_ERR("stream_flash_init failed: %d", rc);
 		return rc;
@@ -98,6 +98,11 @@ int pcd_fw_copy(const struct device *fdev)
 	return 0;
 }
 
+int pcd_fw_copy(const struct device *fdev)
+{
+	return pcd_fw_copy_cb(fdev, NULL);
+}
+
 void pcd_fw_copy_done(void)
 {
 	/* Signal complete by setting magic to DONE */
@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stddef.h>
+#include <ztest.h>
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/util.h>
+
+#include <modem/at_cmd_parser.h>
+#include <modem/at_params.h>
+#include <modem/at_token.h>
+
+#define BENCHMARK_ITERATIONS 1000
+#define NCELLMEAS_PARAMS     64
+
+const char *singleline[] = { "+CEREG: 2,\"76C1\",\"0102DA04\", 7\r\n+CME ERROR: 10\r\n",
+			     "+CEREG: 2,\"76C1\",\"0102DA04\", 7\r\nOK\r\n",
+			     "+CEREG: 2,\"76C1\",\"0102DA04\", 7\r\n",
+			     "+CEREG: 2,\"76C1\",\"0102DA04\", 7" };
+const char *multiline[] = { "+CGEQOSRDP: 0,0,,\r\n"
+			    "+CGEQOSRDP: 1,2,,\r\n"
+			    "+CGEQOSRDP: 2,4,,,1,65280000\r\n",
+			    "+CGEQOSRDP: 0,0,,\r\n"
+			    "+CGEQOSRDP: 1,2,,\r\n"
+			    "+CGEQOSRDP: 2,4,,,1,65280000\r\nOK\r\n" };
+const char *pduline[] = {
+	"+CMT: \"12345678\", 24\r\n"
+	"06917429000171040A91747966543100009160402143708006C8329BFD0601\r\n+CME ERROR: 123\r\n",
+	"+CMT: \"12345678\", 24\r\n"
+	"06917429000171040A91747966543100009160402143708006C8329BFD0601\r\nOK\r\n",
+	"+CMT: \"12345678\", 24\r\n"
+	"06917429000171040A91747966543100009160402143708006C8329BFD0601\r\n"
+};
+const char *singleparamline[] = {
+	"mfw_nrf9160_0.7.0-23.prealpha\r\n+CMS ERROR: 123\r\n",
+	"mfw_nrf9160_0.7.0-23.prealpha\r\nOK\r\n",
+	"mfw_nrf9160_0.7.0-23.prealpha\r\n"
+};
+const char *emptyparamline[] = { "+CPSMS: 1,,,\"10101111\",\"01101100\"\r\n",
+				 "+CPSMS: 1,,,\"10101111\",\"01101100\"\r\nOK\r\n",
+				 "+CPSMS: 1,,,\"10101111\",\"01101100\"\r\n+CME ERROR: 123\r\n" };
+const char *ncellmeas = "%NCELLMEAS: 0,\"021D140C\",\"24201\",\"0821\",65535,5300,449,50,15,"
+			"10891,5300,194,46,8,0,5300,292,60,27,24,5300,321,57,25,32,"
+			"5300,103,55,21,40,5300,47,50,16,48,1650,292,59,29,56,"
+			"8061152878017748\r\nOK\r\n";
+
+static void string_param_check(struct at_token_cursor *cursor, size_t index, const char *expected)
+{
+	char buf[64];
+	size_t len = sizeof(buf);
+	int ret;
+
+	ret = at_token_string_get(cursor, index, buf, &len);
+	zassert_equal(ret, 0, "at_token_string_get should return 0");
+	zassert_equal(len, strlen(expected), "String length should be %d", strlen(expected));
+	zassert_mem_equal(buf, expected, len, "String should be %s", expected);
+}
+
+static void test_token_fail_on_invalid_input(void)
+{
+	struct at_token_cursor cursor;
+	struct at_token token;
+	uint16_t value;
+	char buf[8];
+	size_t len = sizeof(buf);
+	int ret;
+
+	ret = at_token_cursor_init(NULL, singleline[0]);
+	zassert_equal(ret, -EINVAL, "at_token_cursor_init should return -EINVAL");
+
+	ret = at_token_cursor_init(&cursor, NULL);
+	zassert_equal(ret, -EINVAL, "at_token_cursor_init should return -EINVAL");
+
+	ret = at_token_cursor_init(&cursor, singleline[0]);
+	zassert_equal(ret, 0, "at_token_cursor_init should return 0");
+
+	ret = at_token_next(&cursor, NULL);
+	zassert_equal(ret, -EINVAL, "at_token_next should return -EINVAL");
+
+	ret = at_token_get(NULL, 0, &token);
+	zassert_equal(ret, -EINVAL, "at_token_get should return -EINVAL");
+
+	ret = at_token_unsigned_short_get(&cursor, 1, NULL);
+	zassert_equal(ret, -EINVAL, "at_token_unsigned_short_get should return -EINVAL");
+
+	ret = at_token_string_get(&cursor, 2, NULL, &len);
+	zassert_equal(ret, -EINVAL, "at_token_string_get should return -EINVAL");
+
+	/* Wrong parameter type */
+	ret = at_token_unsigned_short_get(&cursor, 2, &value);
+	zassert_equal(ret, -EINVAL, "at_token_unsigned_short_get should return -EINVAL");
+
+	ret = at_token_string_get(&cursor, 1, buf, &len);
+	zassert_equal(ret, -EINVAL, "at_token_string_get should return -EINVAL");
+
+	/* Nonexistent parameter */
+	ret = at_token_unsigned_short_get(&cursor, 5, &value);
+	zassert_equal(ret, -ENOENT, "at_token_unsigned_short_get should return -ENOENT");
+}
+
+static void test_token_singleline(void)
+{
+	struct at_token_cursor cursor;
+	uint16_t value;
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(singleline); i++) {
+		at_token_cursor_init(&cursor, singleline[i]);
+
+		zassert_equal(at_token_count_get(&cursor), 5, "There should be 5 parameters");
+		zassert_equal(at_token_type_get(&cursor, 0), AT_PARAM_TYPE_STRING,
+			      "Param type at index 0 should be a string");
+		zassert_equal(at_token_type_get(&cursor, 1), AT_PARAM_TYPE_NUM_INT,
+			      "Param type at index 1 should be a short");
+		zassert_equal(at_token_type_get(&cursor, 2), AT_PARAM_TYPE_STRING,
+			      "Param type at index 2 should be a string");
+		zassert_equal(at_token_type_get(&cursor, 3), AT_PARAM_TYPE_STRING,
+			      "Param type at index 3 should be a string");
+		zassert_equal(at_token_type_get(&cursor, 4), AT_PARAM_TYPE_NUM_INT,
+			      "Param type at index 4 should be a short");
+		zassert_equal(at_token_type_get(&cursor, 5), AT_PARAM_TYPE_INVALID,
+			      "Param type at index 5 should be invalid");
+
+		string_param_check(&cursor, 0, "+CEREG");
+
+		ret = at_token_unsigned_short_get(&cursor, 1, &value);
+		zassert_equal(ret, 0, "at_token_unsigned_short_get should return 0");
+		zassert_equal(value, 2, "Value should be 2");
+
+		string_param_check(&cursor, 2, "76C1");
+		string_param_check(&cursor, 3, "0102DA04");
+
+		ret = at_token_unsigned_short_get(&cursor, 4, &value);
+		zassert_equal(ret, 0, "at_token_unsigned_short_get should return 0");
+		zassert_equal(value, 7, "Value should be 7");
+	}
+}
+
+static void test_token_multiline(void)
+{
+	struct at_token_cursor cursor;
+	struct at_token token;
+	uint16_t value;
+	int ret;
+
+	/* Only the first response is read */
+	for (size_t i = 0; i < ARRAY_SIZE(multiline); i++) {
+		at_token_cursor_init(&cursor, multiline[i]);
+
+		zassert_equal(at_token_count_get(&cursor), 5, "There should be 5 parameters");
+
+		string_param_check(&cursor, 0, "+CGEQOSRDP");
+
+		ret = at_token_unsigned_short_get(&cursor, 1, &value);
+		zassert_equal(ret, 0, "at_token_unsigned_short_get should return 0");
+		zassert_equal(value, 0, "Value should be 0");
+
+		zassert_equal(at_token_type_get(&cursor, 3), AT_PARAM_TYPE_EMPTY,
+			      "Param type at index 3 should be empty");
+		zassert_equal(at_token_type_get(&cursor, 4), AT_PARAM_TYPE_EMPTY,
+			      "Param type at index 4 should be empty");
+
+		ret = at_token_get(&cursor, 5, &token);
+		zassert_equal(ret, -ENOENT, "at_token_get should return -ENOENT");
+	}
+}
+
+static void test_token_pduline(void)
+{
+	struct at_token_cursor cursor;
+	uint16_t value;
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(pduline); i++) {
+		at_token_cursor_init(&cursor, pduline[i]);
+
+		zassert_equal(at_token_count_get(&cursor), 4, "There should be 4 parameters");
+
+		string_param_check(&cursor, 0, "+CMT");
+		string_param_check(&cursor, 1, "12345678");
+
+		ret = at_token_unsigned_short_get(&cursor, 2, &value);
+		zassert_equal(ret, 0, "at_token_unsigned_short_get should return 0");
+		zassert_equal(value, 24, "Value should be 24");
+
+		string_param_check(&cursor, 3, "06917429000171040A9174796654310000"
+					       "9160402143708006C8329BFD0601");
+	}
+}
+
+static void test_token_singleparamline(void)
+{
+	struct at_token_cursor cursor;
+
+	for (size_t i = 0; i < ARRAY_SIZE(singleparamline); i++) {
+		at_token_cursor_init(&cursor, singleparamline[i]);
+
+		zassert_equal(at_token_count_get(&cursor), 1, "There should be 1 parameter");
+
+		string_param_check(&cursor, 0, "mfw_nrf9160_0.7.0-23.prealpha");
+	}
+}
+
+static void test_token_emptyparamline(void)
+{
+	struct at_token_cursor cursor;
+
+	for (size_t i = 0; i < ARRAY_SIZE(emptyparamline); i++) {
+		at_token_cursor_init(&cursor, emptyparamline[i]);
+
+		zassert_equal(at_token_count_get(&cursor), 6, "There should be 6 parameters");
+		zassert_equal(at_token_type_get(&cursor, 1), AT_PARAM_TYPE_NUM_INT,
+			      "Param type at index 1 should be a short");
+		zassert_equal(at_token_type_get(&cursor, 2), AT_PARAM_TYPE_EMPTY,
+			      "Param type at index 2 should be empty");
+		zassert_equal(at_token_type_get(&cursor, 3), AT_PARAM_TYPE_EMPTY,
+			      "Param type at index 3 should be empty");
+
+		string_param_check(&cursor, 4, "10101111");
+		string_param_check(&cursor, 5, "01101100");
+	}
+}
+
+static void test_token_forced_string(void)
+{
+	struct at_token_cursor cursor;
+
+	at_token_cursor_init(&cursor, "+CPIN: SIM PIN\r\nOK\r\n");
+
+	zassert_equal(at_token_count_get(&cursor), 2, "There should be 2 parameters");
+	string_param_check(&cursor, 1, "SIM PIN");
+
+	at_token_cursor_init(&cursor, "%XICCID: 8901234567890123456F\r\nOK\r\n");
+
+	zassert_equal(at_token_count_get(&cursor), 2, "There should be 2 parameters");
+	string_param_check(&cursor, 1, "8901234567890123456F");
+}
+
+static void test_token_array(void)
+{
+	struct at_token_cursor cursor;
+	uint32_t array[4];
+	size_t len = sizeof(array);
+	int ret;
+
+	at_token_cursor_init(&cursor, "%XCBAND: (1,2,3,20)\r\nOK\r\n");
+
+	zassert_equal(at_token_type_get(&cursor, 1), AT_PARAM_TYPE_ARRAY,
+		      "Param type at index 1 should be an array");
+
+	ret = at_token_array_get(&cursor, 1, array, &len);
+	zassert_equal(ret, 0, "at_token_array_get should return 0");
+	zassert_equal(len, 4 * sizeof(uint32_t), "Array should have 4 values");
+	zassert_equal(array[3], 20, "Last value should be 20");
+
+	len = 2 * sizeof(uint32_t);
+	ret = at_token_array_get(&cursor, 1, array, &len);
+	zassert_equal(ret, -ENOMEM, "at_token_array_get should return -ENOMEM");
+}
+
+static void test_token_int_range(void)
+{
+	struct at_token_cursor cursor;
+	int16_t short_value;
+	uint16_t ushort_value;
+	int32_t int_value;
+	int64_t int64_value;
+	int ret;
+
+	at_token_cursor_init(&cursor, "%XMODEMSLEEP: -1,70000,35712000000\r\n");
+
+	ret = at_token_short_get(&cursor, 1, &short_value);
+	zassert_equal(ret, 0, "at_token_short_get should return 0");
+	zassert_equal(short_value, -1, "Value should be -1");
+
+	ret = at_token_unsigned_short_get(&cursor, 1, &ushort_value);
+	zassert_equal(ret, -EINVAL, "at_token_unsigned_short_get should return -EINVAL");
+
+	ret = at_token_unsigned_short_get(&cursor, 2, &ushort_value);
+	zassert_equal(ret, -EINVAL, "at_token_unsigned_short_get should return -EINVAL");
+
+	ret = at_token_int_get(&cursor, 2, &int_value);
+	zassert_equal(ret, 0, "at_token_int_get should return 0");
+	zassert_equal(int_value, 70000, "Value should be 70000");
+
+	ret = at_token_int_get(&cursor, 3, &int_value);
+	zassert_equal(ret, -EINVAL, "at_token_int_get should return -EINVAL");
+
+	ret = at_token_int64_get(&cursor, 3, &int64_value);
+	zassert_equal(ret, 0, "at_token_int64_get should return 0");
+	zassert_equal(int64_value, 35712000000, "Value should be 35712000000");
+}
+
+static void test_token_string_too_long(void)
+{
+	struct at_token_cursor cursor;
+	const char *str;
+	char buf[8];
+	size_t len = 4;
+	int ret;
+
+	at_token_cursor_init(&cursor, singleline[0]);
+
+	/* No room for the null terminator */
+	ret = at_token_string_get(&cursor, 3, buf, &len);
+	zassert_equal(ret, -ENOMEM, "at_token_string_get should return -ENOMEM");
+
+	ret = at_token_string_ptr_get(&cursor, 3, &str, &len);
+	zassert_equal(ret, 0, "at_token_string_ptr_get should return 0");
+	zassert_equal(len, 8, "String length should be 8");
+	zassert_mem_equal(str, "0102DA04", len, "String should point into the response");
+}
+
+static void test_token_random_access(void)
+{
+	struct at_token_cursor cursor;
+	struct at_token token;
+	size_t index = 0;
+	int ret;
+
+	at_token_cursor_init(&cursor, ncellmeas);
+
+	/* Read backwards, which restarts the scan for every parameter */
+	string_param_check(&cursor, 4, "0821");
+	string_param_check(&cursor, 3, "24201");
+	string_param_check(&cursor, 2, "021D140C");
+
+	at_token_cursor_init(&cursor, ncellmeas);
+
+	while ((ret = at_token_next(&cursor, &token)) == 0) {
+		index++;
+	}
+
+	zassert_equal(ret, -ENOENT, "at_token_next should return -ENOENT");
+	zassert_equal(index, at_token_count_get(&cursor), "All parameters should be read");
+	zassert_equal(token.type, AT_PARAM_TYPE_NUM_INT, "Last param should be an integer");
+}
+
+static void test_token_benchmark(void)
+{
+	static struct at_param_list list;
+	struct at_token_cursor cursor;
+	uint32_t parser_cycles;
+	uint32_t token_cycles;
+	uint32_t sum = 0;
+	uint32_t start;
+	int32_t value;
+	int ret;
+
+	ret = at_params_list_init(&list, NCELLMEAS_PARAMS);
+	zassert_equal(ret, 0, "at_params_list_init should return 0");
+
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		(void)at_parser_params_from_str(ncellmeas, NULL, &list);
+
+		for (size_t j = 5; j < at_params_valid_count_get(&list); j++) {
+			if (!at_params_int_get(&list, j, &value)) {
+				sum += value;
+			}
+		}
+	}
+
+	parser_cycles = k_cycle_get_32() - start;
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		size_t count;
+
+		at_token_cursor_init(&cursor, ncellmeas);
+		count = at_token_count_get(&cursor);
+
+		for (size_t j = 5; j < count; j++) {
+			if (!at_token_int_get(&cursor, j, &value)) {
+				sum -= value;
+			}
+		}
+	}
+
+	token_cycles = k_cycle_get_32() - start;
+
+	at_params_list_free(&list);
+
+	zassert_equal(sum, 0, "Both parsers should read the same values");
+
+	TC_PRINT("%%NCELLMEAS response: at_cmd_parser %u cycles, at_token %u cycles\n",
+		 parser_cycles / BENCHMARK_ITERATIONS, token_cycles / BENCHMARK_ITERATIONS);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(at_token,
+			 ztest_unit_test(test_token_fail_on_invalid_input),
+			 ztest_unit_test(test_token_singleline),
+			 ztest_unit_test(test_token_multiline),
+			 ztest_unit_test(test_token_pduline),
+			 ztest_unit_test(test_token_singleparamline),
+			 ztest_unit_test(test_token_emptyparamline),
+			 ztest_unit_test(test_token_forced_string),
+			 ztest_unit_test(test_token_array),
+			 ztest_unit_test(test_token_int_range),
+			 ztest_unit_test(test_token_string_too_long),
+			 ztest_unit_test(test_token_random_access),
+			 ztest_unit_test(test_token_benchmark)
+			 );
+
+	ztest_run_test_suite(at_token);
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <unity.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <modem/at_monitor.h>
+#include <mock_nrf_modem_at.h>
+
+#define CEREG_NOTIF "+CEREG: 1,\"002F\",\"0012BEEF\",7\r\n"
+#define NCELLMEAS_NOTIF "%NCELLMEAS: 0,\"0012BEEF\",\"24201\",\"002F\",64\r\n"
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received AT notifications
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+
+AT_MONITOR(mon_cereg, "+CEREG", cereg_handler);
+AT_MONITOR(mon_cereg_short, "CEREG", cereg_short_handler);
+AT_MONITOR(mon_ncellmeas, "%NCELLMEAS", ncellmeas_handler);
+AT_MONITOR(mon_any, ANY, any_handler);
+AT_MONITOR(mon_paused, "+CEREG", paused_handler, PAUSED);
+AT_MONITOR_ISR(mon_isr, "+CEREG", isr_handler);
+
+static int cereg_cnt;
+static int cereg_short_cnt;
+static int ncellmeas_cnt;
+static int any_cnt;
+static int paused_cnt;
+static int isr_cnt;
+
+static void cereg_handler(const char *notif)
+{
+	TEST_ASSERT_EQUAL_STRING(CEREG_NOTIF, notif);
+	cereg_cnt++;
+}
+
+static void cereg_short_handler(const char *notif)
+{
+	TEST_ASSERT_NOT_NULL(strstr(notif, "CEREG"));
+	cereg_short_cnt++;
+}
+
+static void ncellmeas_handler(const char *notif)
+{
+	TEST_ASSERT_EQUAL_STRING(NCELLMEAS_NOTIF, notif);
+	ncellmeas_cnt++;
+}
+
+static void any_handler(const char *notif)
+{
+	any_cnt++;
+}
+
+static void paused_handler(const char *notif)
+{
+	paused_cnt++;
+}
+
+static void isr_handler(const char *notif)
+{
+	TEST_ASSERT_EQUAL_STRING(CEREG_NOTIF, notif);
+	isr_cnt++;
+}
+
+static void dispatch(const char *notif)
+{
+	at_monitor_dispatch(notif);
+
+	/* Let the system workqueue dispatch the notification */
+	k_sleep(K_MSEC(1));
+}
+
+void setUp(void)
+{
+	cereg_cnt = 0;
+	cereg_short_cnt = 0;
+	ncellmeas_cnt = 0;
+	any_cnt = 0;
+	paused_cnt = 0;
+	isr_cnt = 0;
+
+	mock_nrf_modem_at_Init();
+}
+
+void tearDown(void)
+{
+	mock_nrf_modem_at_Verify();
+}
+
+void test_at_monitor_dispatch(void)
+{
+	dispatch(CEREG_NOTIF);
+
+	TEST_ASSERT_EQUAL(1, cereg_cnt);
+	TEST_ASSERT_EQUAL(1, cereg_short_cnt);
+	TEST_ASSERT_EQUAL(0, ncellmeas_cnt);
+	TEST_ASSERT_EQUAL(1, any_cnt);
+	TEST_ASSERT_EQUAL(0, paused_cnt);
+	TEST_ASSERT_EQUAL(1, isr_cnt);
+
+	dispatch(NCELLMEAS_NOTIF);
+
+	TEST_ASSERT_EQUAL(1, cereg_cnt);
+	TEST_ASSERT_EQUAL(1, cereg_short_cnt);
+	TEST_ASSERT_EQUAL(1, ncellmeas_cnt);
+	TEST_ASSERT_EQUAL(2, any_cnt);
+	TEST_ASSERT_EQUAL(1, isr_cnt);
+}
+
+void test_at_monitor_filter_mid_notification(void)
+{
+	/* Filters match anywhere in the notification */
+	dispatch("%XCEREG: 1\r\n");
+
+	TEST_ASSERT_EQUAL(0, cereg_cnt);
+	TEST_ASSERT_EQUAL(1, cereg_short_cnt);
+	TEST_ASSERT_EQUAL(1, any_cnt);
+
+	/* Partial filter does not match */
+	dispatch("%NCELLMEA\r\n");
+
+	TEST_ASSERT_EQUAL(0, ncellmeas_cnt);
+	TEST_ASSERT_EQUAL(2, any_cnt);
+}
+
+void test_at_monitor_pause_resume(void)
+{
+	at_monitor_resume(&mon_paused);
+	at_monitor_pause(&mon_cereg);
+
+	dispatch(CEREG_NOTIF);
+
+	TEST_ASSERT_EQUAL(0, cereg_cnt);
+	TEST_ASSERT_EQUAL(1, paused_cnt);
+
+	at_monitor_pause(&mon_paused);
+	at_monitor_resume(&mon_cereg);
+
+	dispatch(CEREG_NOTIF);
+
+	TEST_ASSERT_EQUAL(1, cereg_cnt);
+	TEST_ASSERT_EQUAL(1, paused_cnt);
+}
+
+void test_at_monitor_drop_count(void)
+{
+	const int notif_cnt = 10;
+	uint32_t drop_cnt = at_monitor_drop_count_get();
+
+	/* Keep the workqueue from freeing the heap */
+	k_sched_lock();
+
+	for (int i = 0; i < notif_cnt; i++) {
+		at_monitor_dispatch(NCELLMEAS_NOTIF);
+	}
+
+	k_sched_unlock();
+	k_sleep(K_MSEC(1));
+
+	drop_cnt = at_monitor_drop_count_get() - drop_cnt;
+
+	TEST_ASSERT_GREATER_THAN(0, drop_cnt);
+	TEST_ASSERT_EQUAL(notif_cnt, ncellmeas_cnt + drop_cnt);
+	TEST_ASSERT_EQUAL(ncellmeas_cnt, any_cnt);
+
+	/* Heap is available again */
+	dispatch(NCELLMEAS_NOTIF);
+
+	TEST_ASSERT_EQUAL(notif_cnt + 1, ncellmeas_cnt + drop_cnt);
+}
+
+/* This is needed because AT Monitor library is initialized in SYS_INIT. */
+static int at_monitor_test_sys_init(const struct device *unused)
+{
+	__wrap_nrf_modem_at_notif_handler_set_ExpectAnyArgsAndReturn(0);
+
+	return 0;
+}
+
+/* It is required to be added to each test. That is because unity is using
+ * different main signature (returns int) and zephyr expects main which does
+ * not return value.
+ */
+extern int unity_main(void);
+
+void main(void)
+{
+	(void)unity_main();
+}
+
+SYS_INIT(at_monitor_test_sys_init, POST_KERNEL, 0);
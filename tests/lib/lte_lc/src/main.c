@@ -232,6 +232,7 @@ void test_parse_xmodemsleep(void)
 	char *at_response_2 = "%XMODEMSLEEP: 2,100400";
 	char *at_response_3 = "%XMODEMSLEEP: 4";
 	char *at_response_4 = "%XMODEMSLEEP: 4,0";
+	char *at_response_5 = "%XMODEMSLEEP: 4,\r\n";
 
 	err = parse_xmodemsleep(at_response_0, &modem_sleep);
 	zassert_equal(0, err, "parse_xmodemsleep failed, error: %d", err);
@@ -258,6 +259,12 @@ void test_parse_xmodemsleep(void)
 	zassert_equal(modem_sleep.type, 4, "Wrong modem sleep type parameter");
 	zassert_equal(modem_sleep.time, 0, "Wrong modem sleep time parameter");
 
+	/* An empty time parameter is not present. */
+	err = parse_xmodemsleep(at_response_5, &modem_sleep);
+	zassert_equal(0, err, "parse_xmodemsleep failed, error: %d", err);
+	zassert_equal(modem_sleep.type, 4, "Wrong modem sleep type parameter");
+	zassert_equal(modem_sleep.time, -1, "Wrong modem sleep time parameter");
+
 	err = parse_xmodemsleep(NULL, &modem_sleep);
 	zassert_equal(-EINVAL, err, "parse_xmodemsleep failed, error: %d", err);
 
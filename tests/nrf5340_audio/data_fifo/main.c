@@ -191,6 +191,223 @@ void test_data_fifo_data_put_size_zero(void)
 	zassert_equal(ret, -EINVAL, "block_lock did not return -EINVAL");
 }
 
+void test_data_fifo_wrap_free_out_of_order(void)
+{
+	DATA_FIFO_DEFINE(data_fifo, 3, 8);
+
+	int ret;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	/* Run several rounds, so that the FIFO wraps around */
+	for (uint32_t round = 0; round < 10; round++) {
+		uint32_t *data_ptr[2];
+
+		for (uint32_t i = 0; i < ARRAY_SIZE(data_ptr); i++) {
+			ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr[i],
+								 K_NO_WAIT);
+			zassert_equal(ret, 0, "first_vacant_get did not return 0");
+			*data_ptr[i] = round * 2 + i;
+		}
+
+		for (uint32_t i = 0; i < ARRAY_SIZE(data_ptr); i++) {
+			ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr[i],
+						   sizeof(uint32_t));
+			zassert_equal(ret, 0, "block_lock did not return 0");
+		}
+
+		internal_test_remaining_elements(&data_fifo, 2, 2, __LINE__);
+
+		void *data_ptr_read[2];
+		size_t data_size;
+
+		for (uint32_t i = 0; i < ARRAY_SIZE(data_ptr_read); i++) {
+			ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read[i],
+								&data_size, K_NO_WAIT);
+			zassert_equal(ret, 0, "_last_filled_get did not return 0");
+			zassert_equal(*(uint32_t *)data_ptr_read[i], round * 2 + i,
+				      "data out of order");
+			zassert_equal(data_size, sizeof(uint32_t), "data size incorrect");
+		}
+
+		/* Free the newest block first */
+		ret = data_fifo_block_free(&data_fifo, &data_ptr_read[1]);
+		zassert_equal(ret, 0, "block_free did not return 0");
+
+		internal_test_remaining_elements(&data_fifo, 1, 0, __LINE__);
+
+		ret = data_fifo_block_free(&data_fifo, &data_ptr_read[0]);
+		zassert_equal(ret, 0, "block_free did not return 0");
+
+		internal_test_remaining_elements(&data_fifo, 0, 0, __LINE__);
+	}
+}
+
+void test_data_fifo_drop_oldest(void)
+{
+	DATA_FIFO_DEFINE(data_fifo, 4, 8);
+
+	int ret;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	uint32_t *data_ptr;
+
+	/* Producer keeps writing and drops the oldest block on overrun,
+	 * as done by the audio datapath.
+	 */
+	for (uint32_t i = 0; i < 10; i++) {
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+		if (ret == -ENOMEM) {
+			void *data_ptr_old;
+			size_t data_size;
+
+			ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_old,
+								&data_size, K_NO_WAIT);
+			zassert_equal(ret, 0, "_last_filled_get did not return 0");
+
+			ret = data_fifo_block_free(&data_fifo, &data_ptr_old);
+			zassert_equal(ret, 0, "block_free did not return 0");
+
+			ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr,
+								 K_NO_WAIT);
+		}
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+
+		*data_ptr = i;
+		ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, sizeof(uint32_t));
+		zassert_equal(ret, 0, "block_lock did not return 0");
+	}
+
+	internal_test_remaining_elements(&data_fifo, 4, 4, __LINE__);
+
+	/* Only the newest blocks remain */
+	for (uint32_t i = 6; i < 10; i++) {
+		void *data_ptr_read;
+		size_t data_size;
+
+		ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size,
+							K_NO_WAIT);
+		zassert_equal(ret, 0, "_last_filled_get did not return 0");
+		zassert_equal(*(uint32_t *)data_ptr_read, i, "wrong block dropped");
+
+		ret = data_fifo_block_free(&data_fifo, &data_ptr_read);
+		zassert_equal(ret, 0, "block_free did not return 0");
+	}
+
+	void *data_ptr_read;
+	size_t data_size;
+
+	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, "_last_filled_get did not return -ENOMSG");
+}
+
+void test_data_fifo_drop_oldest_block_held(void)
+{
+	DATA_FIFO_DEFINE(data_fifo, 4, 8);
+
+	int ret;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	uint32_t *data_ptr;
+	void *data_ptr_held;
+	size_t data_size;
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+	*data_ptr = 0;
+	ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, sizeof(uint32_t));
+	zassert_equal(ret, 0, "block_lock did not return 0");
+
+	/* Consumer keeps the oldest block while the producer overruns */
+	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_held, &data_size, K_NO_WAIT);
+	zassert_equal(ret, 0, "_last_filled_get did not return 0");
+	zassert_equal(*(uint32_t *)data_ptr_held, 0, "wrong block read");
+
+	for (uint32_t i = 1; i < 10; i++) {
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+		if (ret == -ENOMEM) {
+			void *data_ptr_old;
+
+			ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_old,
+								&data_size, K_NO_WAIT);
+			zassert_equal(ret, 0, "_last_filled_get did not return 0");
+
+			ret = data_fifo_block_free(&data_fifo, &data_ptr_old);
+			zassert_equal(ret, 0, "block_free did not return 0");
+
+			ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr,
+								 K_NO_WAIT);
+		}
+		zassert_equal(ret, 0, "first_vacant_get did not return 0 after drop");
+		zassert_not_equal(data_ptr, data_ptr_held, "held block reused");
+
+		*data_ptr = i;
+		ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, sizeof(uint32_t));
+		zassert_equal(ret, 0, "block_lock did not return 0");
+	}
+
+	internal_test_remaining_elements(&data_fifo, 4, 3, __LINE__);
+	zassert_equal(*(uint32_t *)data_ptr_held, 0, "held block overwritten");
+
+	ret = data_fifo_block_free(&data_fifo, &data_ptr_held);
+	zassert_equal(ret, 0, "block_free did not return 0");
+
+	/* Only the newest blocks remain */
+	for (uint32_t i = 7; i < 10; i++) {
+		void *data_ptr_read;
+
+		ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size,
+							K_NO_WAIT);
+		zassert_equal(ret, 0, "_last_filled_get did not return 0");
+		zassert_equal(*(uint32_t *)data_ptr_read, i, "wrong block dropped");
+
+		ret = data_fifo_block_free(&data_fifo, &data_ptr_read);
+		zassert_equal(ret, 0, "block_free did not return 0");
+	}
+
+	internal_test_remaining_elements(&data_fifo, 0, 0, __LINE__);
+}
+
+void test_data_fifo_benchmark(void)
+{
+#define BENCHMARK_ROUNDS 1000
+	DATA_FIFO_DEFINE(data_fifo, 4, 128);
+
+	int ret;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	uint32_t start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+		void *data_ptr;
+		size_t data_size;
+
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, &data_ptr, K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+		ret = data_fifo_block_lock(&data_fifo, &data_ptr, 128);
+		zassert_equal(ret, 0, "block_lock did not return 0");
+		ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr, &data_size,
+							K_NO_WAIT);
+		zassert_equal(ret, 0, "_last_filled_get did not return 0");
+		ret = data_fifo_block_free(&data_fifo, &data_ptr);
+		zassert_equal(ret, 0, "block_free did not return 0");
+	}
+
+	uint32_t cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("data_fifo: %u cycles per get, lock, get and free round\n",
+		 cycles / BENCHMARK_ROUNDS);
+
+	internal_test_remaining_elements(&data_fifo, 0, 0, __LINE__);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_suite_data_fifo,
@@ -198,7 +415,11 @@ void test_main(void)
 		ztest_unit_test(test_data_fifo_data_put_get_ok),
 		ztest_unit_test(test_data_fifo_data_put_too_many),
 		ztest_unit_test(test_data_fifo_data_put_too_much_data),
-		ztest_unit_test(test_data_fifo_data_put_size_zero)
+		ztest_unit_test(test_data_fifo_data_put_size_zero),
+		ztest_unit_test(test_data_fifo_wrap_free_out_of_order),
+		ztest_unit_test(test_data_fifo_drop_oldest),
+		ztest_unit_test(test_data_fifo_drop_oldest_block_held),
+		ztest_unit_test(test_data_fifo_benchmark)
 	);
 
 	ztest_run_test_suite(test_suite_data_fifo);
@@ -127,6 +127,168 @@ void test_mono_into_stereo_r(void)
 	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
 }
 
+static int16_t ref_limit(int32_t pcm)
+{
+	return (int16_t)CLAMP(pcm, INT16_MIN, INT16_MAX);
+}
+
+void test_mix_odd_length_saturation(void)
+{
+	int ret;
+	/* Odd number of samples exercises both packed and single sample handling */
+	int16_t sample_a[] = { INT16_MAX, INT16_MIN, 100, -100, 30000 };
+	int16_t sample_b[] = { 100, -100, INT16_MAX, INT16_MIN, 30000 };
+	int16_t sample_r[ARRAY_SIZE(sample_a)];
+
+	for (size_t i = 0; i < ARRAY_SIZE(sample_a); i++) {
+		sample_r[i] = ref_limit(sample_a[i] + sample_b[i]);
+	}
+
+	ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b), B_MONO_INTO_A_MONO);
+	ZEQ(ret, 0);
+
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+}
+
+void test_mono_into_stereo_saturation(void)
+{
+	int ret;
+	int16_t sample_b[] = { 20000, -20000, 5, 20000, -20000 };
+	int16_t sample_a[2 * ARRAY_SIZE(sample_b)];
+	int16_t sample_r[ARRAY_SIZE(sample_a)];
+	const enum pcm_mix_mode modes[] = { B_MONO_INTO_A_STEREO_LR, B_MONO_INTO_A_STEREO_L,
+					    B_MONO_INTO_A_STEREO_R };
+
+	for (size_t m = 0; m < ARRAY_SIZE(modes); m++) {
+		for (size_t i = 0; i < ARRAY_SIZE(sample_a); i++) {
+			sample_a[i] = (i % 3) ? 20000 : -20000;
+
+			bool mixed = (modes[m] == B_MONO_INTO_A_STEREO_LR) ||
+				     ((modes[m] == B_MONO_INTO_A_STEREO_L) && (i % 2 == 0)) ||
+				     ((modes[m] == B_MONO_INTO_A_STEREO_R) && (i % 2 == 1));
+
+			sample_r[i] = mixed ? ref_limit(sample_a[i] + sample_b[i / 2]) :
+					      sample_a[i];
+		}
+
+		ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b), modes[m]);
+		ZEQ(ret, 0);
+
+		verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+	}
+}
+
+/* 10 ms of 48 kHz stereo audio */
+#define BENCHMARK_FRAME_SAMPLES 960
+#define BENCHMARK_ITERATIONS 100
+
+void test_mix_benchmark(void)
+{
+	static int16_t frame_a[BENCHMARK_FRAME_SAMPLES];
+	static int16_t frame_b[BENCHMARK_FRAME_SAMPLES];
+	uint32_t start;
+	uint32_t cycles;
+
+	for (size_t i = 0; i < ARRAY_SIZE(frame_b); i++) {
+		frame_b[i] = (int16_t)(i * 97);
+	}
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		pcm_mix(frame_a, sizeof(frame_a), frame_b, sizeof(frame_b),
+			B_STEREO_INTO_A_STEREO);
+	}
+	cycles = k_cycle_get_32() - start;
+	TC_PRINT("B_STEREO_INTO_A_STEREO: %u cycles per 10 ms frame\n",
+		 cycles / BENCHMARK_ITERATIONS);
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		pcm_mix(frame_a, sizeof(frame_a), frame_b, sizeof(frame_b) / 2,
+			B_MONO_INTO_A_STEREO_LR);
+	}
+	cycles = k_cycle_get_32() - start;
+	TC_PRINT("B_MONO_INTO_A_STEREO_LR: %u cycles per 10 ms frame\n",
+		 cycles / BENCHMARK_ITERATIONS);
+
+	start = k_cycle_get_32();
+	for (size_t i = 0; i < BENCHMARK_ITERATIONS; i++) {
+		pcm_mix(frame_a, sizeof(frame_a), frame_b, sizeof(frame_b) / 2,
+			B_MONO_INTO_A_STEREO_L);
+	}
+	cycles = k_cycle_get_32() - start;
+	TC_PRINT("B_MONO_INTO_A_STEREO_L: %u cycles per 10 ms frame\n",
+		 cycles / BENCHMARK_ITERATIONS);
+}
+
+void test_mix_24_bit(void)
+{
+	int ret;
+	int32_t sample_a[] = { 0x7FFFFF, -0x800000, 1000, -1000, 0x400000 };
+	int32_t sample_b[] = { 1, -1, 2000, -2000, 0x400000 };
+	int32_t sample_r[] = { 0x7FFFFF, -0x800000, 3000, -3000, 0x7FFFFF };
+
+	ret = pcm_mix_ext(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+			  B_MONO_INTO_A_MONO, 24);
+	ZEQ(ret, 0);
+
+	for (size_t i = 0; i < ARRAY_SIZE(sample_r); i++) {
+		ZEQ(sample_a[i], sample_r[i]);
+	}
+}
+
+void test_mix_32_bit(void)
+{
+	int ret;
+	int32_t sample_a[] = { INT32_MAX, INT32_MIN, 10, 10 };
+	int32_t sample_b[] = { 1, -1 };
+	int32_t sample_r[] = { INT32_MAX, INT32_MIN + 1, 9, 9 };
+
+	ret = pcm_mix_ext(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+			  B_MONO_INTO_A_STEREO_LR, 32);
+	ZEQ(ret, 0);
+
+	for (size_t i = 0; i < ARRAY_SIZE(sample_r); i++) {
+		ZEQ(sample_a[i], sample_r[i]);
+	}
+
+	ret = pcm_mix_ext(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+			  B_MONO_INTO_A_MONO, 20);
+	ZEQ(ret, -EINVAL);
+}
+
+void test_mix_multi_channel(void)
+{
+	int ret;
+	/* Two frames of six channel audio */
+	int16_t sample_a[] = { 10, 10, 10, 10, 10, 10, 20, 20, 20, 20, 20, 20 };
+	int16_t sample_b[] = { 1, INT16_MAX };
+	int16_t sample_r[] = { 11, 10, 11, 10, 10, 11,
+			       INT16_MAX, 20, INT16_MAX, 20, 20, INT16_MAX };
+
+	ret = pcm_mix_mono_into_channels(sample_a, sizeof(sample_a), 6,
+					 BIT(0) | BIT(2) | BIT(5), sample_b, sizeof(sample_b),
+					 16);
+	ZEQ(ret, 0);
+
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+
+	/* Channel outside of the buffer */
+	ret = pcm_mix_mono_into_channels(sample_a, sizeof(sample_a), 6, BIT(6), sample_b,
+					 sizeof(sample_b), 16);
+	ZEQ(ret, -EINVAL);
+
+	/* Too many channels */
+	ret = pcm_mix_mono_into_channels(sample_a, sizeof(sample_a), PCM_MIX_MAX_CHANNELS + 1,
+					 BIT(0), sample_b, sizeof(sample_b), 16);
+	ZEQ(ret, -EINVAL);
+
+	/* Buffer B too big */
+	ret = pcm_mix_mono_into_channels(sample_a, sizeof(sample_a), 8, BIT(0), sample_b,
+					 sizeof(sample_b), 16);
+	ZEQ(ret, -EPERM);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_suite_pcm_mix,
@@ -137,7 +299,13 @@ void test_main(void)
 		ztest_unit_test(test_high_values),
 		ztest_unit_test(test_mono_into_stereo_lr),
 		ztest_unit_test(test_mono_into_stereo_l),
-		ztest_unit_test(test_mono_into_stereo_r)
+		ztest_unit_test(test_mono_into_stereo_r),
+		ztest_unit_test(test_mix_odd_length_saturation),
+		ztest_unit_test(test_mono_into_stereo_saturation),,
+		ztest_unit_test(test_mix_24_bit),
+		ztest_unit_test(test_mix_32_bit),
+		ztest_unit_test(test_mix_multi_channel)
+		ztest_unit_test(test_mix_benchmark)
 	);
 
 	ztest_run_test_suite(test_suite_pcm_mix);
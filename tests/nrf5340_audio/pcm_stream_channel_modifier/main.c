@@ -301,6 +301,145 @@ void test_pscm_two_channel_split_32(void)
 	verify_array_eq(right_test_list, stereo_split_right_32, output_size);
 }
 
+void test_pscm_odd_samples_16(void)
+{
+	/* Odd number of 16-bit samples at unaligned addresses */
+	uint8_t input[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+	uint8_t stereo[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
+	uint8_t output[32];
+	uint8_t output_right[16];
+	uint8_t left_zero_padded[] = { 1, 2, 0, 0, 3, 4, 0, 0, 5, 6, 0, 0 };
+	uint8_t copy_padded[] = { 1, 2, 1, 2, 3, 4, 3, 4, 5, 6, 5, 6 };
+	uint8_t split_left[] = { 1, 2, 5, 6, 9, 10 };
+	uint8_t split_right[] = { 3, 4, 7, 8, 11, 12 };
+	size_t output_size;
+	int ret;
+
+	ret = pscm_zero_pad(&input[1], 6, AUDIO_CH_L, 16, &output[1], &output_size);
+	ZEQ(ret, 0);
+	ZEQ(output_size, 12);
+	verify_array_eq(&output[1], left_zero_padded, output_size);
+
+	ret = pscm_copy_pad(&input[1], 6, 16, &output[1], &output_size);
+	ZEQ(ret, 0);
+	ZEQ(output_size, 12);
+	verify_array_eq(&output[1], copy_padded, output_size);
+
+	ret = pscm_one_channel_split(&stereo[1], 12, AUDIO_CH_R, 16, &output[1], &output_size);
+	ZEQ(ret, 0);
+	ZEQ(output_size, 6);
+	verify_array_eq(&output[1], split_right, output_size);
+
+	ret = pscm_two_channel_split(&stereo[1], 12, 16, &output[1], &output_right[1],
+				     &output_size);
+	ZEQ(ret, 0);
+	ZEQ(output_size, 6);
+	verify_array_eq(&output[1], split_left, output_size);
+	verify_array_eq(&output_right[1], split_right, output_size);
+}
+
+/* 10 ms of 48 kHz mono audio */
+#define BENCHMARK_FRAME_SAMPLES 480
+#define BENCHMARK_ITERATIONS 100
+
+void test_pscm_benchmark(void)
+{
+	static uint32_t mono_left[BENCHMARK_FRAME_SAMPLES];
+	static uint32_t mono_right[BENCHMARK_FRAME_SAMPLES];
+	static uint32_t stereo[2 * BENCHMARK_FRAME_SAMPLES];
+	const uint8_t bit_depths[] = { 16, 24, 32 };
+	size_t output_size;
+	uint32_t start;
+	uint32_t cycles;
+
+	for (size_t i = 0; i < ARRAY_SIZE(bit_depths); i++) {
+		size_t mono_size = BENCHMARK_FRAME_SAMPLES * bit_depths[i] / 8;
+
+		start = k_cycle_get_32();
+		for (size_t j = 0; j < BENCHMARK_ITERATIONS; j++) {
+			pscm_combine(mono_left, mono_right, mono_size, bit_depths[i], stereo,
+				     &output_size);
+		}
+		cycles = k_cycle_get_32() - start;
+		TC_PRINT("pscm_combine %u-bit: %u cycles per 10 ms frame\n", bit_depths[i],
+			 cycles / BENCHMARK_ITERATIONS);
+
+		start = k_cycle_get_32();
+		for (size_t j = 0; j < BENCHMARK_ITERATIONS; j++) {
+			pscm_two_channel_split(stereo, 2 * mono_size, bit_depths[i], mono_left,
+					       mono_right, &output_size);
+		}
+		cycles = k_cycle_get_32() - start;
+		TC_PRINT("pscm_two_channel_split %u-bit: %u cycles per 10 ms frame\n",
+			 bit_depths[i], cycles / BENCHMARK_ITERATIONS);
+
+		start = k_cycle_get_32();
+		for (size_t j = 0; j < BENCHMARK_ITERATIONS; j++) {
+			pscm_zero_pad(mono_left, mono_size, AUDIO_CH_L, bit_depths[i], stereo,
+				      &output_size);
+		}
+		cycles = k_cycle_get_32() - start;
+		TC_PRINT("pscm_zero_pad %u-bit: %u cycles per 10 ms frame\n", bit_depths[i],
+			 cycles / BENCHMARK_ITERATIONS);
+	}
+}
+
+void test_pscm_interleave_multi_channel(void)
+{
+	const uint8_t bit_depths[] = { 16, 24, 32 };
+	const uint8_t num_channels[] = { 1, 3, 4, 8 };
+	uint8_t mono[PSCM_MAX_CHANNELS][12];
+	uint8_t mono_out[PSCM_MAX_CHANNELS][12];
+	uint8_t interleaved[PSCM_MAX_CHANNELS * 12];
+	const void *inputs[PSCM_MAX_CHANNELS];
+	void *outputs[PSCM_MAX_CHANNELS];
+	size_t output_size;
+	int ret;
+
+	for (size_t ch = 0; ch < PSCM_MAX_CHANNELS; ch++) {
+		for (size_t i = 0; i < sizeof(mono[ch]); i++) {
+			mono[ch][i] = ch * sizeof(mono[ch]) + i;
+		}
+		inputs[ch] = mono[ch];
+		outputs[ch] = mono_out[ch];
+	}
+
+	for (size_t d = 0; d < ARRAY_SIZE(bit_depths); d++) {
+		size_t bytes_per_sample = bit_depths[d] / 8;
+
+		for (size_t n = 0; n < ARRAY_SIZE(num_channels); n++) {
+			uint8_t num_ch = num_channels[n];
+
+			ret = pscm_interleave(inputs, num_ch, sizeof(mono[0]), bit_depths[d],
+					      interleaved, &output_size);
+			ZEQ(ret, 0);
+			ZEQ(output_size, num_ch * sizeof(mono[0]));
+
+			for (size_t i = 0; i < sizeof(mono[0]) / bytes_per_sample; i++) {
+				for (size_t ch = 0; ch < num_ch; ch++) {
+					verify_array_eq(
+						&interleaved[(i * num_ch + ch) * bytes_per_sample],
+						&mono[ch][i * bytes_per_sample], bytes_per_sample);
+				}
+			}
+
+			memset(mono_out, 0, sizeof(mono_out));
+			ret = pscm_deinterleave(interleaved, output_size, num_ch, bit_depths[d],
+						outputs, &output_size);
+			ZEQ(ret, 0);
+			ZEQ(output_size, sizeof(mono[0]));
+
+			for (size_t ch = 0; ch < num_ch; ch++) {
+				verify_array_eq(mono_out[ch], mono[ch], output_size);
+			}
+		}
+	}
+
+	ret = pscm_interleave(inputs, PSCM_MAX_CHANNELS + 1, sizeof(mono[0]), 16, interleaved,
+			      &output_size);
+	ZEQ(ret, -EINVAL);
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_suite_pscm,
@@ -318,7 +457,10 @@ void test_main(void)
 		ztest_unit_test(test_pscm_copy_pad_32),
 		ztest_unit_test(test_pscm_combine_32),
 		ztest_unit_test(test_pscm_one_channel_split_32),
-		ztest_unit_test(test_pscm_two_channel_split_32)
+		ztest_unit_test(test_pscm_two_channel_split_32),
+		ztest_unit_test(test_pscm_odd_samples_16),,
+		ztest_unit_test(test_pscm_interleave_multi_channel)
+		ztest_unit_test(test_pscm_benchmark)
 	);
 
 	ztest_run_test_suite(test_suite_pscm);
@@ -99,11 +99,67 @@ void test_illegal_args(void)
 		      "Err code returned");
 }
 
+void test_tone_gen_ext_multi_channel(void)
+{
+	const uint8_t bit_depths[] = { 16, 24, 32 };
+	const int32_t max_values[] = { INT16_MAX, (1 << 23) - 1, INT32_MAX };
+	int32_t tone[4 * 48];
+	size_t tone_size;
+
+	for (size_t i = 0; i < ARRAY_SIZE(bit_depths); i++) {
+		size_t bytes_per_sample = (bit_depths[i] == 16) ? 2 : 4;
+
+		zassert_equal(tone_gen_ext(tone, sizeof(tone), &tone_size, 1000, 48000, 1,
+					   bit_depths[i], 4),
+			      0, "Err code returned");
+		zassert_equal(tone_size, 48 * 4 * bytes_per_sample, "Incorrect tone size");
+
+		for (size_t s = 0; s < 48; s++) {
+			int32_t first = (bytes_per_sample == 2) ? ((int16_t *)tone)[s * 4] :
+								  tone[s * 4];
+
+			for (size_t ch = 1; ch < 4; ch++) {
+				int32_t val = (bytes_per_sample == 2) ?
+						      ((int16_t *)tone)[s * 4 + ch] :
+						      tone[s * 4 + ch];
+
+				zassert_equal(val, first, "Channels differ");
+			}
+		}
+
+		/* Peak at the 1/4 mark */
+		int32_t peak = (bytes_per_sample == 2) ? ((int16_t *)tone)[12 * 4] : tone[12 * 4];
+
+		zassert_true(peak > max_values[i] - (max_values[i] >> 10), "Wrong peak value");
+	}
+}
+
+void test_tone_gen_ext_illegal_args(void)
+{
+	int32_t tone[48];
+	size_t tone_size;
+
+	/* Invalid bit depth */
+	zassert_equal(tone_gen_ext(tone, sizeof(tone), &tone_size, 1000, 48000, 1, 8, 1),
+		      -EINVAL, "Wrong code returned");
+	/* Invalid number of channels */
+	zassert_equal(tone_gen_ext(tone, sizeof(tone), &tone_size, 1000, 48000, 1, 16, 0),
+		      -EINVAL, "Wrong code returned");
+	zassert_equal(tone_gen_ext(tone, sizeof(tone), &tone_size, 1000, 48000, 1, 16,
+				   TONE_MAX_CHANNELS + 1),
+		      -EINVAL, "Wrong code returned");
+	/* Buffer too small */
+	zassert_equal(tone_gen_ext(tone, sizeof(tone), &tone_size, 1000, 48000, 1, 32, 2),
+		      -ENOMEM, "Wrong code returned");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(test_suite_tone,
 		ztest_unit_test(test_tone_gen_valid),
-		ztest_unit_test(test_illegal_args)
+		ztest_unit_test(test_illegal_args),
+		ztest_unit_test(test_tone_gen_ext_multi_channel),
+		ztest_unit_test(test_tone_gen_ext_illegal_args)
 	);
 
 	ztest_run_test_suite(test_suite_tone);
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <errno.h>
+#include "hid_eventq.h"
+
+#define QUEUE_SIZE	12
+#define EXPIRATION	500
+
+#define KEY_PRESS	1
+#define KEY_RELEASE	-1
+
+static struct hid_eventq_event eventq_buf[QUEUE_SIZE];
+static struct hid_eventq eventq;
+
+/* Catch asserts to fail test */
+void assert_post_action(const char *file, unsigned int line)
+{
+	zassert_unreachable("reached assert file %s %x", file, line);
+}
+
+static void eventq_append(uint16_t usage_id, int16_t value, uint32_t timestamp)
+{
+	int err = hid_eventq_append(&eventq, usage_id, value, timestamp);
+
+	zassert_equal(err, 0, "append did not return 0");
+}
+
+static void eventq_expect(uint16_t usage_id_tgt, int16_t value_tgt, uint32_t line)
+{
+	uint16_t usage_id;
+	int16_t value;
+	int err = hid_eventq_get(&eventq, &usage_id, &value);
+
+	zassert_equal(err, 0, "get did not return 0. call from line: %d", line);
+	zassert_equal(usage_id, usage_id_tgt, "usage_id target %u actual val %u. call from line: %d",
+		      usage_id_tgt, usage_id, line);
+	zassert_equal(value, value_tgt, "value target %d actual val %d. call from line: %d",
+		      value_tgt, value, line);
+}
+
+static void test_setup(void)
+{
+	hid_eventq_init(&eventq, eventq_buf, ARRAY_SIZE(eventq_buf));
+}
+
+void test_hid_eventq_append_get(void)
+{
+	uint16_t usage_id;
+	int16_t value;
+	int err;
+
+	zassert_true(hid_eventq_is_empty(&eventq), "queue not empty after init");
+
+	err = hid_eventq_get(&eventq, &usage_id, &value);
+	zassert_equal(err, -ENOENT, "get did not return -ENOENT");
+
+	/* Run several rounds, so that the ring buffer wraps around */
+	for (size_t round = 0; round < 3; round++) {
+		for (size_t i = 0; i < QUEUE_SIZE; i++) {
+			eventq_append(i, KEY_PRESS, 0);
+		}
+
+		zassert_true(hid_eventq_is_full(&eventq), "queue not full");
+
+		err = hid_eventq_append(&eventq, QUEUE_SIZE, KEY_PRESS, 0);
+		zassert_equal(err, -ENOBUFS, "append did not return -ENOBUFS");
+
+		for (size_t i = 0; i < QUEUE_SIZE / 2; i++) {
+			eventq_expect(i, KEY_PRESS, __LINE__);
+		}
+
+		for (size_t i = 0; i < QUEUE_SIZE / 2; i++) {
+			eventq_append(i, KEY_RELEASE, 0);
+		}
+
+		for (size_t i = QUEUE_SIZE / 2; i < QUEUE_SIZE; i++) {
+			eventq_expect(i, KEY_PRESS, __LINE__);
+		}
+
+		for (size_t i = 0; i < QUEUE_SIZE / 2; i++) {
+			eventq_expect(i, KEY_RELEASE, __LINE__);
+		}
+
+		zassert_true(hid_eventq_is_empty(&eventq), "queue not empty");
+	}
+}
+
+void test_hid_eventq_cleanup_paired(void)
+{
+	eventq_append(1, KEY_PRESS, 0);
+	eventq_append(2, KEY_PRESS, 10);
+	eventq_append(1, KEY_RELEASE, 20);
+	eventq_append(2, KEY_RELEASE, 30);
+	eventq_append(3, KEY_PRESS, 600);
+
+	/* Events are not expired yet */
+	zassert_equal(hid_eventq_cleanup(&eventq, 400, EXPIRATION), 0, "events removed");
+
+	/* Only the first key press and release expired, but the second key
+	 * press would be left without the release.
+	 */
+	zassert_equal(hid_eventq_cleanup(&eventq, 525, EXPIRATION), 0, "events removed");
+
+	zassert_equal(hid_eventq_cleanup(&eventq, 530, EXPIRATION), 4, "events not removed");
+
+	eventq_expect(3, KEY_PRESS, __LINE__);
+	zassert_true(hid_eventq_is_empty(&eventq), "queue not empty");
+}
+
+void test_hid_eventq_cleanup_pressed(void)
+{
+	eventq_append(1, KEY_PRESS, 0);
+	eventq_append(2, KEY_PRESS, 10);
+	eventq_append(2, KEY_RELEASE, 20);
+	eventq_append(2, KEY_PRESS, 30);
+	eventq_append(2, KEY_RELEASE, 40);
+
+	/* Key 1 is still pressed, the events cannot be removed */
+	zassert_equal(hid_eventq_cleanup(&eventq, 1000, EXPIRATION), 0, "events removed");
+
+	eventq_append(1, KEY_RELEASE, 1000);
+
+	zassert_equal(hid_eventq_cleanup(&eventq, 1000, EXPIRATION), 0, "events removed");
+	zassert_equal(hid_eventq_cleanup(&eventq, 1500, EXPIRATION), 6, "events not removed");
+	zassert_true(hid_eventq_is_empty(&eventq), "queue not empty");
+}
+
+void test_hid_eventq_cleanup_consumed_press(void)
+{
+	eventq_append(1, KEY_PRESS, 0);
+	eventq_append(2, KEY_PRESS, 10);
+	eventq_append(1, KEY_RELEASE, 20);
+	eventq_append(2, KEY_RELEASE, 30);
+
+	/* The press of key 1 is no longer in the queue. Its release is not
+	 * paired and does not block removing the following events.
+	 */
+	eventq_expect(1, KEY_PRESS, __LINE__);
+
+	zassert_equal(hid_eventq_cleanup(&eventq, 1000, EXPIRATION), 3, "events not removed");
+	zassert_true(hid_eventq_is_empty(&eventq), "queue not empty");
+}
+
+void test_hid_eventq_purge_oldest(void)
+{
+	eventq_append(1, KEY_PRESS, 0);
+	eventq_append(2, KEY_PRESS, 10);
+	eventq_append(2, KEY_RELEASE, 20);
+	eventq_append(1, KEY_RELEASE, 20);
+	eventq_append(3, KEY_PRESS, 20);
+	eventq_append(3, KEY_RELEASE, 20);
+	eventq_append(4, KEY_PRESS, 30);
+	eventq_append(4, KEY_RELEASE, 40);
+	eventq_append(5, KEY_PRESS, 50);
+
+	/* Events up to the release of key 1 leave no key pressed. Events with
+	 * the same timestamp are removed too.
+	 */
+	zassert_equal(hid_eventq_purge_oldest(&eventq), 6, "wrong number of events removed");
+	zassert_equal(hid_eventq_purge_oldest(&eventq), 2, "wrong number of events removed");
+
+	/* Key 5 is pressed, no event can be removed */
+	zassert_equal(hid_eventq_purge_oldest(&eventq), 0, "events removed");
+
+	eventq_expect(5, KEY_PRESS, __LINE__);
+	zassert_true(hid_eventq_is_empty(&eventq), "queue not empty");
+}
+
+/* Simple linear congruential generator, so that the test is reproducible. */
+static uint32_t rand_next(uint32_t *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+
+	return (*seed >> 16) & 0x7fff;
+}
+
+#define STRESS_KEY_CNT		16
+#define STRESS_ROLLOVER		6
+#define STRESS_EVENT_CNT	100000
+
+struct stress_state {
+	bool connected;
+	bool held[STRESS_KEY_CNT]; /* Key state on the device. */
+	bool ignored[STRESS_KEY_CNT]; /* Key press dropped, until key is released. */
+	int host[STRESS_KEY_CNT]; /* Key state seen by the host. */
+	size_t held_cnt;
+};
+
+static void stress_host_update(struct stress_state *s, uint16_t key, int16_t value)
+{
+	s->host[key] = MAX(s->host[key] + value, 0);
+}
+
+/* Events are dropped together with the recorded state, as done by hid_state
+ * on disconnection or when the queue is full.
+ */
+static void stress_drop_all(struct stress_state *s)
+{
+	hid_eventq_reset(&eventq);
+
+	for (size_t i = 0; i < STRESS_KEY_CNT; i++) {
+		s->host[i] = 0;
+		s->ignored[i] = s->held[i];
+	}
+}
+
+static void stress_connect(struct stress_state *s, uint32_t timestamp)
+{
+	uint16_t usage_id;
+	int16_t value;
+
+	hid_eventq_cleanup(&eventq, timestamp, EXPIRATION);
+
+	while (!hid_eventq_get(&eventq, &usage_id, &value)) {
+		stress_host_update(s, usage_id, value);
+	}
+
+	s->connected = true;
+}
+
+static void stress_key(struct stress_state *s, uint16_t key, int16_t value, uint32_t timestamp)
+{
+	if (s->connected) {
+		stress_host_update(s, key, value);
+		return;
+	}
+
+	hid_eventq_cleanup(&eventq, timestamp, EXPIRATION);
+
+	if (hid_eventq_is_full(&eventq)) {
+		hid_eventq_purge_oldest(&eventq);
+	}
+
+	if (hid_eventq_is_full(&eventq)) {
+		stress_drop_all(s);
+	}
+
+	eventq_append(key, value, timestamp);
+}
+
+static void stress_verify(const struct stress_state *s)
+{
+	for (size_t i = 0; i < STRESS_KEY_CNT; i++) {
+		bool pressed = s->held[i] && !s->ignored[i];
+
+		zassert_equal(s->host[i] > 0, pressed, "key %zu host %d held %d ignored %d",
+			      i, s->host[i], s->held[i], s->ignored[i]);
+	}
+}
+
+void test_hid_eventq_stress_rollover(void)
+{
+	struct stress_state s = {0};
+	uint32_t seed = 1;
+	uint32_t timestamp = UINT32_MAX - 100000;
+
+	for (size_t i = 0; i < STRESS_EVENT_CNT; i++) {
+		uint32_t r = rand_next(&seed);
+
+		/* Timestamp wraps around during the test */
+		timestamp += r % 64;
+
+		if ((r % 97) == 0) {
+			if (s.connected) {
+				s.connected = false;
+				stress_drop_all(&s);
+			} else {
+				stress_connect(&s, timestamp);
+				stress_verify(&s);
+			}
+			continue;
+		}
+
+		uint16_t key = rand_next(&seed) % STRESS_KEY_CNT;
+
+		if (s.held[key]) {
+			s.held[key] = false;
+			s.ignored[key] = false;
+			s.held_cnt--;
+			stress_key(&s, key, KEY_RELEASE, timestamp);
+		} else if (s.held_cnt < STRESS_ROLLOVER) {
+			/* Key press is queued after the events may be dropped */
+			stress_key(&s, key, KEY_PRESS, timestamp);
+			s.held[key] = true;
+			s.held_cnt++;
+		}
+	}
+
+	stress_connect(&s, timestamp);
+	stress_verify(&s);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_suite_hid_eventq,
+		ztest_unit_test_setup_teardown(test_hid_eventq_append_get,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_hid_eventq_cleanup_paired,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_hid_eventq_cleanup_pressed,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_hid_eventq_cleanup_consumed_press,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_hid_eventq_purge_oldest,
+					       test_setup, unit_test_noop),
+		ztest_unit_test_setup_teardown(test_hid_eventq_stress_rollover,
+					       test_setup, unit_test_noop)
+	);
+
+	ztest_run_test_suite(test_suite_hid_eventq);
+}
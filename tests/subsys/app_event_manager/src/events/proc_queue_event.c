@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "proc_queue_event.h"
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROC_QUEUES)
+APP_EVENT_TYPE_DEFINE(proc_queue_event,
+		  NULL,
+		  NULL,
+		  APP_EVENT_FLAGS_CREATE(APP_EVENT_TYPE_FLAGS_PROC_QUEUE_1));
+#else
+APP_EVENT_TYPE_DEFINE(proc_queue_event,
+		  NULL,
+		  NULL,
+		  APP_EVENT_FLAGS_CREATE());
+#endif
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _PROC_QUEUE_EVENT_H_
+#define _PROC_QUEUE_EVENT_H_
+
+/**
+ * @brief Processing Queue Event
+ * @defgroup proc_queue_event Processing Queue Event
+ * @{
+ */
+
+#include <app_event_manager.h>
+#include <app_event_manager_profiler_tracer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Event processed by the dedicated processing queue 1, if the queues are used. */
+struct proc_queue_event {
+	struct app_event_header header;
+
+	int val;
+};
+
+APP_EVENT_TYPE_DECLARE(proc_queue_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _PROC_QUEUE_EVENT_H_ */
@@ -28,6 +28,8 @@ enum test_id {
 	TEST_SUBSCRIBER_ORDER,
 	TEST_OOM,
 	TEST_MULTICONTEXT,
+	TEST_PROC_QUEUE_BEFORE_INIT,
+	TEST_PROC_QUEUE,
 
 	TEST_CNT
 };
@@ -4,8 +4,11 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <ztest.h>
 #include <app_event_manager.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/shell/shell_dummy.h>
 
 #include "sized_events.h"
 #include "test_events.h"
@@ -47,6 +50,11 @@ static void test_start(enum test_id test_id)
 	zassert_equal(err, 0, "Test execution hanged");
 }
 
+static void test_proc_queue_before_init(void)
+{
+	test_start(TEST_PROC_QUEUE_BEFORE_INIT);
+}
+
 static void test_basic(void)
 {
 	test_start(TEST_BASIC);
@@ -77,6 +85,11 @@ static void test_multicontext(void)
 	test_start(TEST_MULTICONTEXT);
 }
 
+static void test_proc_queue(void)
+{
+	test_start(TEST_PROC_QUEUE);
+}
+
 static void test_event_size_static(void)
 {
 	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROVIDE_EVENT_SIZE)) {
@@ -178,9 +191,78 @@ static void test_event_size_disabled(void)
 	app_event_manager_free(ev_s1);
 }
 
+static void test_slab_alloc(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SLAB_ALLOC)) {
+		ztest_test_skip();
+		return;
+	}
+
+	struct test_size1_event *ev_tab[CONFIG_APP_EVENT_MANAGER_SLAB_DEPTH + 1];
+	const struct app_event_manager_pool_stats *stats =
+		&_app_event_manager_slab_stats[_EVENT_ID(test_size1_event) -
+					       _event_type_list_start];
+	atomic_val_t fallback_cnt = atomic_get(&stats->fallback_cnt);
+
+	for (size_t i = 0; i < ARRAY_SIZE(ev_tab); i++) {
+		ev_tab[i] = new_test_size1_event();
+		zassert_not_null(ev_tab[i], "Event allocation failed");
+	}
+
+	zassert_equal(atomic_get(&stats->used), CONFIG_APP_EVENT_MANAGER_SLAB_DEPTH,
+		      "Memory slab not fully used");
+	zassert_equal(atomic_get(&stats->fallback_cnt), fallback_cnt + 1,
+		      "Allocation over the slab depth must use the fallback allocator");
+
+	for (size_t i = 0; i < ARRAY_SIZE(ev_tab); i++) {
+		app_event_manager_free(ev_tab[i]);
+	}
+
+	zassert_equal(atomic_get(&stats->used), 0, "Memory slab blocks not freed");
+	zassert_equal(atomic_get(&stats->max_used), CONFIG_APP_EVENT_MANAGER_SLAB_DEPTH,
+		      "Unexpected maximum slab usage");
+
+	struct test_dynamic_event *ev_dyn = new_test_dynamic_event(10);
+
+	zassert_equal(atomic_get(&_app_event_manager_dyndata_pool_stats.used), 1,
+		      "Event with dynamic data not allocated from the dynamic data pool");
+	app_event_manager_free(ev_dyn);
+	zassert_equal(atomic_get(&_app_event_manager_dyndata_pool_stats.used), 0,
+		      "Event with dynamic data not freed");
+}
+
+static void test_slab_shell(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SLAB_ALLOC)) {
+		ztest_test_skip();
+		return;
+	}
+
+	const struct shell *shell = shell_backend_dummy_get_ptr();
+	const char *output;
+	size_t size;
+	int err;
+
+	/* Drop the output of the previous commands. */
+	(void)shell_backend_dummy_get_output(shell, &size);
+
+	err = shell_execute_cmd(shell, "app_event_manager show_pools");
+	zassert_equal(err, 0, "Command show_pools failed (err: %d)", err);
+
+	output = shell_backend_dummy_get_output(shell, &size);
+	zassert_not_null(strstr(output, "[P:test_size1_event] used: 0, max used: "
+				STRINGIFY(CONFIG_APP_EVENT_MANAGER_SLAB_DEPTH)),
+			 "Memory slab statistics not displayed");
+	zassert_not_null(strstr(output, "[P:dyndata] used: 0"),
+			 "Dynamic data pool statistics not displayed");
+	zassert_is_null(strstr(output, "[P:test_dynamic_event]"),
+			"Event with dynamic data has no memory slab");
+}
+
 void test_main(void)
 {
 	ztest_test_suite(app_event_manager_tests,
+			 ztest_unit_test(test_proc_queue_before_init),
 			 ztest_unit_test(test_init),
 			 ztest_unit_test(test_basic),
 			 ztest_unit_test(test_data),
@@ -188,10 +270,13 @@ void test_main(void)
 			 ztest_unit_test(test_subs_order),
 			 ztest_unit_test(test_oom),
 			 ztest_unit_test(test_multicontext),
+			 ztest_unit_test(test_proc_queue),
 			 ztest_unit_test(test_event_size_static),
 			 ztest_unit_test(test_event_size_dynamic),
 			 ztest_unit_test(test_event_size_dynamic_with_data),
-			 ztest_unit_test(test_event_size_disabled)
+			 ztest_unit_test(test_event_size_disabled),
+			 ztest_unit_test(test_slab_alloc),
+			 ztest_unit_test(test_slab_shell)
 			 );
 
 	ztest_run_test_suite(app_event_manager_tests);
@@ -23,6 +23,8 @@ extern "C" {
 
 #define TEST_EVENT_ORDER_CNT 20
 
+#define TEST_PROC_QUEUE_EVENT_CNT 20
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <ztest.h>
+
+#include "test_events.h"
+#include "proc_queue_event.h"
+
+#include "test_config.h"
+
+#define MODULE test_proc_queue
+
+static enum test_id cur_test_id;
+static int expected_val;
+
+
+static void test_end(void)
+{
+	struct test_end_event *et = new_test_end_event();
+
+	et->test_id = cur_test_id;
+	APP_EVENT_SUBMIT(et);
+}
+
+static void proc_queue_stats_check(void)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROC_QUEUES)) {
+		return;
+	}
+
+	struct app_event_manager_queue_stats stats;
+	size_t queue_idx = _app_event_manager_queue_idx(_EVENT_ID(proc_queue_event));
+
+	zassert_equal(queue_idx, 1, "Event not assigned to the processing queue 1");
+
+	_app_event_manager_queue_stats_get(queue_idx, &stats);
+	zassert_equal(stats.processed_cnt, TEST_PROC_QUEUE_EVENT_CNT,
+		      "Wrong number of events processed by the queue");
+	zassert_equal(atomic_get(&stats.depth), 0, "Events left in the queue");
+}
+
+static void proc_queue_event_handle(const struct proc_queue_event *event)
+{
+	bool in_sys_workq = (k_current_get() == &k_sys_work_q.thread);
+
+	switch (cur_test_id) {
+	case TEST_PROC_QUEUE_BEFORE_INIT:
+		/* Dedicated queues are not started before initialization. */
+		zassert_true(in_sys_workq, "Event not processed by the system workqueue");
+		test_end();
+		break;
+
+	case TEST_PROC_QUEUE:
+		zassert_equal(in_sys_workq, !IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROC_QUEUES),
+			      "Event processed by a wrong queue");
+		zassert_equal(event->val, expected_val, "Wrong event order");
+		expected_val++;
+
+		if (expected_val == TEST_PROC_QUEUE_EVENT_CNT) {
+			proc_queue_stats_check();
+			test_end();
+		}
+		break;
+
+	default:
+		zassert_true(false, "Unexpected event");
+		break;
+	}
+}
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_test_start_event(aeh)) {
+		struct test_start_event *st = cast_test_start_event(aeh);
+
+		switch (st->test_id) {
+		case TEST_PROC_QUEUE_BEFORE_INIT:
+		{
+			struct proc_queue_event *event = new_proc_queue_event();
+
+			cur_test_id = st->test_id;
+			APP_EVENT_SUBMIT(event);
+			break;
+		}
+
+		case TEST_PROC_QUEUE:
+		{
+			cur_test_id = st->test_id;
+			expected_val = 0;
+
+			for (size_t i = 0; i < TEST_PROC_QUEUE_EVENT_CNT; i++) {
+				struct proc_queue_event *event = new_proc_queue_event();
+
+				event->val = i;
+				APP_EVENT_SUBMIT(event);
+			}
+			break;
+		}
+
+		default:
+			/* Ignore other test cases, check if proper test_id. */
+			zassert_true(st->test_id < TEST_CNT,
+				     "test_id out of range");
+			break;
+		}
+
+		return false;
+	}
+
+	if (is_proc_queue_event(aeh)) {
+		proc_queue_event_handle(cast_proc_queue_event(aeh));
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, test_start_event);
+APP_EVENT_SUBSCRIBE(MODULE, proc_queue_event);
@@ -6,6 +6,7 @@
 
 #include <ztest.h>
 #include <zephyr/kernel.h>
+#include <app_event_manager.h>
 
 #include "test_event_allocator.h"
 
@@ -30,5 +31,11 @@ void *app_event_manager_alloc(size_t size)
 
 void app_event_manager_free(void *addr)
 {
+	/* Tests free unsubmitted events directly using this function. */
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SLAB_ALLOC) &&
+	    _app_event_manager_slab_free(addr)) {
+		return;
+	}
+
 	k_free(addr);
 }
@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/shell/shell_dummy.h>
+#include <app_event_manager.h>
+#include <app_event_manager_profiler_tracer.h>
+
+#define MODULE hist_test
+
+#define BUCKET_CNT	CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_HIST_BUCKET_CNT
+#define EVENT_BURST	4
+#define LISTENER_US	200
+/* Bucket n counts values from 2^(n-1) to 2^n - 1. */
+#define LISTENER_BUCKET	8
+
+BUILD_ASSERT(LISTENER_US >= BIT(LISTENER_BUCKET - 1));
+BUILD_ASSERT(LISTENER_BUCKET < BUCKET_CNT);
+
+extern struct event_listener _event_listener_list_start[];
+
+struct hist_test_event {
+	struct app_event_header header;
+};
+
+APP_EVENT_TYPE_DECLARE(hist_test_event);
+APP_EVENT_TYPE_DEFINE(hist_test_event, NULL, NULL, APP_EVENT_FLAGS_CREATE());
+
+static K_SEM_DEFINE(processed_sem, 0, EVENT_BURST);
+
+
+static bool event_handler(const struct app_event_header *aeh)
+{
+	if (is_hist_test_event(aeh)) {
+		k_busy_wait(LISTENER_US);
+		k_sem_give(&processed_sem);
+	}
+
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, hist_test_event);
+
+static size_t event_idx(void)
+{
+	const struct event_type *et = app_event_manager_event_type_find("hist_test_event");
+
+	zassert_not_null(et, "Event type not found");
+
+	return et - _event_type_list_start;
+}
+
+static size_t listener_idx(void)
+{
+	STRUCT_SECTION_FOREACH(event_listener, el) {
+		if (!strcmp(el->name, STRINGIFY(MODULE))) {
+			return el - _event_listener_list_start;
+		}
+	}
+
+	zassert_unreachable("Listener not found");
+	return 0;
+}
+
+static uint32_t hist_total(const uint32_t *buckets, size_t first_bucket)
+{
+	uint32_t total = 0;
+
+	for (size_t i = first_bucket; i < BUCKET_CNT; i++) {
+		total += buckets[i];
+	}
+
+	return total;
+}
+
+static void submit_burst(void)
+{
+	/* All events are submitted before the first one is processed. */
+	k_sched_lock();
+	for (size_t i = 0; i < EVENT_BURST; i++) {
+		APP_EVENT_SUBMIT(new_hist_test_event());
+	}
+	k_sched_unlock();
+
+	for (size_t i = 0; i < EVENT_BURST; i++) {
+		zassert_ok(k_sem_take(&processed_sem, K_SECONDS(1)), "Event not processed");
+	}
+
+	/* Let the postprocess hooks of the last event complete. */
+	k_sleep(K_MSEC(10));
+}
+
+static void test_hist_event(void)
+{
+	uint32_t buckets[BUCKET_CNT];
+
+	app_event_manager_profiler_tracer_hist_reset();
+	submit_burst();
+
+	zassert_ok(app_event_manager_profiler_tracer_hist_get(
+			APP_EVENT_MANAGER_HIST_DISPATCH_LATENCY, event_idx(), buckets), NULL);
+	zassert_equal(hist_total(buckets, 0), EVENT_BURST, "Wrong number of latency samples");
+
+	zassert_ok(app_event_manager_profiler_tracer_hist_get(
+			APP_EVENT_MANAGER_HIST_PROCESSING_TIME, event_idx(), buckets), NULL);
+	zassert_equal(hist_total(buckets, LISTENER_BUCKET), EVENT_BURST,
+		      "Processing time shorter than listener time");
+
+	/* Queue depth on submission is 1, 2, 3 and 4. */
+	zassert_ok(app_event_manager_profiler_tracer_hist_get(
+			APP_EVENT_MANAGER_HIST_QUEUE_DEPTH, event_idx(), buckets), NULL);
+	zassert_equal(buckets[0], 0, NULL);
+	zassert_equal(buckets[1], 1, NULL);
+	zassert_equal(buckets[2], 2, NULL);
+	zassert_equal(buckets[3], 1, NULL);
+	zassert_equal(hist_total(buckets, 0), EVENT_BURST, NULL);
+}
+
+static void test_hist_listener(void)
+{
+	uint32_t buckets[BUCKET_CNT];
+
+	app_event_manager_profiler_tracer_hist_reset();
+	submit_burst();
+
+	zassert_ok(app_event_manager_profiler_tracer_hist_get(
+			APP_EVENT_MANAGER_HIST_LISTENER_TIME, listener_idx(), buckets), NULL);
+	zassert_equal(hist_total(buckets, 0), EVENT_BURST, "Wrong number of listener samples");
+	zassert_equal(hist_total(buckets, LISTENER_BUCKET), EVENT_BURST,
+		      "Listener time below the busy wait time");
+}
+
+static void test_hist_invalid(void)
+{
+	uint32_t buckets[BUCKET_CNT];
+	size_t event_cnt = _event_type_list_end - _event_type_list_start;
+
+	zassert_equal(app_event_manager_profiler_tracer_hist_get(
+			APP_EVENT_MANAGER_HIST_DISPATCH_LATENCY, event_cnt, buckets), -EINVAL,
+		      NULL);
+	zassert_equal(app_event_manager_profiler_tracer_hist_get(
+			APP_EVENT_MANAGER_HIST_LISTENER_TIME,
+			CONFIG_APP_EVENT_MANAGER_PROFILER_TRACER_HIST_MAX_LISTENERS, buckets),
+		      -EINVAL, NULL);
+	zassert_equal(app_event_manager_profiler_tracer_hist_get(
+			APP_EVENT_MANAGER_HIST_LISTENER_TIME + 1, 0, buckets), -EINVAL, NULL);
+}
+
+static void test_hist_reset(void)
+{
+	uint32_t buckets[BUCKET_CNT];
+
+	submit_burst();
+	app_event_manager_profiler_tracer_hist_reset();
+
+	for (size_t t = 0; t < APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT; t++) {
+		zassert_ok(app_event_manager_profiler_tracer_hist_get(t, event_idx(), buckets),
+			   NULL);
+		zassert_equal(hist_total(buckets, 0), 0, "Histogram not cleared");
+	}
+
+	zassert_ok(app_event_manager_profiler_tracer_hist_get(
+			APP_EVENT_MANAGER_HIST_LISTENER_TIME, listener_idx(), buckets), NULL);
+	zassert_equal(hist_total(buckets, 0), 0, "Histogram not cleared");
+}
+
+static void test_hist_dump(void)
+{
+	static uint8_t buf[2048];
+	uint32_t buckets[BUCKET_CNT];
+	size_t event_cnt = _event_type_list_end - _event_type_list_start;
+	size_t size = app_event_manager_profiler_tracer_hist_dump_size();
+	const size_t hdr_size = 8;
+
+	zassert_true(size <= sizeof(buf), "Dump buffer too small");
+
+	app_event_manager_profiler_tracer_hist_reset();
+	submit_burst();
+
+	zassert_equal(app_event_manager_profiler_tracer_hist_dump(buf, size - 1), -ENOMEM, NULL);
+	zassert_equal(app_event_manager_profiler_tracer_hist_dump(buf, size), size, NULL);
+
+	zassert_equal(buf[0], 1, "Wrong dump version");
+	zassert_equal(buf[1], BUCKET_CNT, NULL);
+	zassert_equal(buf[2], APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT, NULL);
+	zassert_equal(sys_get_le16(&buf[4]), event_cnt, NULL);
+
+	size_t listener_cnt = sys_get_le16(&buf[6]);
+
+	zassert_equal(size, hdr_size + (event_cnt * APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT +
+					listener_cnt) * BUCKET_CNT * sizeof(uint32_t), NULL);
+
+	/* Histograms of the test event match the values read directly. */
+	for (size_t t = 0; t < APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT; t++) {
+		const uint8_t *pos = &buf[hdr_size +
+			((event_idx() * APP_EVENT_MANAGER_HIST_EVENT_TYPE_CNT + t) *
+			 BUCKET_CNT * sizeof(uint32_t))];
+
+		zassert_ok(app_event_manager_profiler_tracer_hist_get(t, event_idx(), buckets),
+			   NULL);
+		for (size_t b = 0; b < BUCKET_CNT; b++) {
+			zassert_equal(sys_get_le32(&pos[b * sizeof(uint32_t)]), buckets[b],
+				      "Dump does not match histogram");
+		}
+	}
+}
+
+static const char *shell_cmd_run(const char *cmd)
+{
+	const struct shell *sh = shell_backend_dummy_get_ptr();
+	size_t size;
+
+	shell_backend_dummy_clear_output(sh);
+	zassert_ok(shell_execute_cmd(sh, cmd), "Command %s failed", cmd);
+
+	return shell_backend_dummy_get_output(sh, &size);
+}
+
+static void test_hist_shell(void)
+{
+	uint32_t buckets[BUCKET_CNT];
+	const char *out;
+
+	app_event_manager_profiler_tracer_hist_reset();
+	submit_burst();
+
+	out = shell_cmd_run("app_event_manager_hist show_events hist_test_event");
+	zassert_not_null(strstr(out, "hist_test_event"), "Event not shown");
+	zassert_not_null(strstr(out, "queue depth (4 samples)"), "Queue depth not shown");
+	zassert_not_null(strstr(out, "processing time [us] (4 samples)"),
+			 "Processing time not shown");
+
+	out = shell_cmd_run("app_event_manager_hist show_listeners");
+	zassert_not_null(strstr(out, STRINGIFY(MODULE)), "Listener not shown");
+	zassert_not_null(strstr(out, "handler time [us] (4 samples)"), "Handler time not shown");
+
+	(void)shell_cmd_run("app_event_manager_hist dump");
+
+	(void)shell_cmd_run("app_event_manager_hist reset");
+	zassert_ok(app_event_manager_profiler_tracer_hist_get(
+			APP_EVENT_MANAGER_HIST_QUEUE_DEPTH, event_idx(), buckets), NULL);
+	zassert_equal(hist_total(buckets, 0), 0, "Histograms not cleared by shell");
+}
+
+void test_main(void)
+{
+	zassert_ok(app_event_manager_init(), "Error when initializing");
+
+	/* Give the shell thread time to initialize the dummy backend. */
+	k_sleep(K_MSEC(100));
+
+	ztest_test_suite(app_event_manager_profiler_tracer_hist_tests,
+			 ztest_unit_test(test_hist_event),
+			 ztest_unit_test(test_hist_listener),
+			 ztest_unit_test(test_hist_invalid),
+			 ztest_unit_test(test_hist_reset),
+			 ztest_unit_test(test_hist_dump),
+			 ztest_unit_test(test_hist_shell)
+			 );
+
+	ztest_run_test_suite(app_event_manager_profiler_tracer_hist_tests);
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <nrf_profiler.h>
+
+/* The test verifies the histograms only, profiler data is discarded. */
+int nrf_profiler_stream_sink_init(void)
+{
+	return 0;
+}
+
+int nrf_profiler_stream_sink_write(const uint8_t *data, size_t len)
+{
+	return 0;
+}
+
+int nrf_profiler_stream_sink_read_cmd(uint8_t *cmd)
+{
+	return -EAGAIN;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/bluetooth/mesh.h>
+#include <mesh/net.h>
+#include <mesh/rpl.h>
+#include <emds/emds.h>
+
+#define RPL_SIZE CONFIG_BT_MESH_CRPL
+#define BENCHMARK_LOOKUPS 100000
+
+static struct bt_mesh_net_rx rx_create(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = src,
+		.seq = seq,
+		.old_iv = old_iv,
+		.local_match = true,
+		.net_if = BT_MESH_NET_IF_ADV,
+	};
+
+	return rx;
+}
+
+static bool rpl_check(uint16_t src, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = rx_create(src, seq, old_iv);
+
+	return bt_mesh_rpl_check(&rx, NULL);
+}
+
+static const struct emds_entry *rpl_store_get(void)
+{
+	STRUCT_SECTION_FOREACH(emds_entry, entry) {
+		if (entry->id == CONFIG_BT_MESH_RPL_INDEX) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+static void fill(uint16_t cnt)
+{
+	for (uint16_t src = 1; src <= cnt; src++) {
+		zassert_false(rpl_check(src, 1, false), "Message from 0x%04x rejected", src);
+	}
+}
+
+static void test_setup(void)
+{
+	bt_mesh_rpl_clear();
+}
+
+static void test_replay(void)
+{
+	fill(RPL_SIZE);
+
+	for (uint16_t src = 1; src <= RPL_SIZE; src++) {
+		zassert_true(rpl_check(src, 1, false), "Replay from 0x%04x accepted", src);
+		zassert_true(rpl_check(src, 0, false), "Old seq from 0x%04x accepted", src);
+		zassert_false(rpl_check(src, 2, false), "New seq from 0x%04x rejected", src);
+	}
+
+	/* RPL is full, messages from unknown sources are rejected */
+	zassert_true(rpl_check(RPL_SIZE + 1, 1, false), "Message accepted with full RPL");
+}
+
+static void test_match(void)
+{
+	struct bt_mesh_net_rx rx = rx_create(1, 10, false);
+	struct bt_mesh_rpl *rpl = NULL;
+
+	zassert_false(bt_mesh_rpl_check(&rx, &rpl), "Message rejected");
+	zassert_not_null(rpl, "No slot returned");
+
+	/* The slot is not updated until the message is complete */
+	zassert_false(rpl_check(1, 10, false), "Message rejected");
+	zassert_true(rpl_check(1, 10, false), "Replay accepted");
+
+	rx = rx_create(2, 10, false);
+	rpl = NULL;
+	zassert_false(bt_mesh_rpl_check(&rx, &rpl), "Message rejected");
+	zassert_not_null(rpl, "No slot returned");
+
+	bt_mesh_rpl_update(rpl, &rx);
+	zassert_true(rpl_check(2, 10, false), "Replay accepted");
+	zassert_false(rpl_check(2, 11, false), "Message rejected");
+}
+
+static void test_iv_update(void)
+{
+	fill(RPL_SIZE / 2);
+
+	/* Sources with odd addresses send messages on the new IV index */
+	bt_mesh_rpl_reset();
+
+	for (uint16_t src = 1; src <= RPL_SIZE / 2; src += 2) {
+		zassert_false(rpl_check(src, 0, false), "New IV from 0x%04x rejected", src);
+	}
+
+	/* Entries of the even sources are now discarded. The list is
+	 * compacted, and remaining entries must still be found.
+	 */
+	bt_mesh_rpl_reset();
+
+	for (uint16_t src = 1; src <= RPL_SIZE / 2; src++) {
+		bool odd = (src % 2);
+
+		zassert_equal(rpl_check(src, 0, true), odd, "Unexpected result for 0x%04x", src);
+	}
+
+	/* Freed slots can be used by new sources */
+	for (uint16_t src = RPL_SIZE + 1; src <= RPL_SIZE + RPL_SIZE / 4; src++) {
+		zassert_false(rpl_check(src, 1, false), "Message from 0x%04x rejected", src);
+	}
+}
+
+static void test_emds_restore(void)
+{
+	static uint8_t stored[sizeof(struct bt_mesh_rpl) * RPL_SIZE];
+	const struct emds_entry *entry = rpl_store_get();
+
+	zassert_not_null(entry, "No RPL entry in EMDS");
+	zassert_equal(entry->len, sizeof(stored), "Unexpected RPL entry size");
+
+	fill(RPL_SIZE / 2);
+	memcpy(stored, entry->data, entry->len);
+
+	/* Emulate reboot. The list is cleared, then restored by emds_load(). */
+	bt_mesh_rpl_clear();
+	memcpy(entry->data, stored, entry->len);
+
+	for (uint16_t src = 1; src <= RPL_SIZE / 2; src++) {
+		zassert_true(rpl_check(src, 1, false), "Replay from 0x%04x accepted", src);
+	}
+
+	for (uint16_t src = RPL_SIZE / 2 + 1; src <= RPL_SIZE; src++) {
+		zassert_false(rpl_check(src, 1, false), "Message from 0x%04x rejected", src);
+	}
+
+	zassert_true(rpl_check(RPL_SIZE + 1, 1, false), "Message accepted with full RPL");
+}
+
+static void test_benchmark(void)
+{
+	uint32_t seq = 1;
+
+	fill(RPL_SIZE);
+
+	uint32_t start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < BENCHMARK_LOOKUPS; i++) {
+		/* Spread the lookups over the whole list */
+		uint16_t src = 1 + (i * 7919) % RPL_SIZE;
+
+		(void)rpl_check(src, seq++, false);
+	}
+
+	uint32_t cycles = k_cycle_get_32() - start;
+	uint32_t lookups_per_sec = (uint64_t)BENCHMARK_LOOKUPS *
+				   sys_clock_hw_cycles_per_sec() / MAX(cycles, 1);
+
+	TC_PRINT("RPL with %u entries: %u cycles per lookup, %u lookups per second\n",
+		 RPL_SIZE, cycles / BENCHMARK_LOOKUPS, lookups_per_sec);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(bt_mesh_rpl_test,
+			 ztest_unit_test_setup_teardown(test_replay, test_setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_match, test_setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_iv_update, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_emds_restore, test_setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_benchmark, test_setup,
+							unit_test_noop)
+			 );
+
+	ztest_run_test_suite(bt_mesh_rpl_test);
+}
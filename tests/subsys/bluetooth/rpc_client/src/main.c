@@ -0,0 +1,380 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/hci.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <nrf_rpc_cbor.h>
+#include <bt_rpc.h>
+
+#include "bt_rpc_common.h"
+#include "bt_rpc_gatt_common.h"
+#include "serialize.h"
+
+#define CMD_LOG_MAX 16
+#define BATCH_ENTRIES_MAX 8
+#define NOTIF_DATA_MAX 32
+#define RSP_BUF_SIZE 128
+#define ZCBOR_ELEM_MAX 64
+
+/* Connection index used by the fake host. */
+#define CONN_INDEX 0
+
+static const bt_addr_le_t peer_addr = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc6 },
+};
+
+static struct bt_gatt_attr test_attrs[] = {
+	BT_GATT_PRIMARY_SERVICE(BT_UUID_DECLARE_16(0xfff0)),
+	BT_GATT_CHARACTERISTIC(BT_UUID_DECLARE_16(0xfff1), BT_GATT_CHRC_NOTIFY,
+			       BT_GATT_PERM_NONE, NULL, NULL, NULL),
+	BT_GATT_CCC(NULL, BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+};
+
+static struct bt_gatt_service test_svc = BT_GATT_SERVICE(test_attrs);
+
+/* Notification characteristic value. */
+static const struct bt_gatt_attr *notif_attr = &test_attrs[2];
+
+struct batch_entry {
+	uint32_t conn_index;
+	uint32_t attr_index;
+	uint8_t data[NOTIF_DATA_MAX];
+	size_t len;
+};
+
+/* State of the fake host. */
+static struct {
+	uint8_t cmd_log[CMD_LOG_MAX];
+	size_t cmd_cnt;
+	int32_t remote_ref;
+	uint8_t conn_state;
+	struct batch_entry batch[BATCH_ENTRIES_MAX];
+	size_t batch_cnt;
+} host;
+
+
+static void host_reset(void)
+{
+	memset(&host, 0, sizeof(host));
+	host.conn_state = BT_CONN_STATE_CONNECTED;
+}
+
+static size_t cmd_count(uint8_t cmd)
+{
+	size_t cnt = 0;
+
+	for (size_t i = 0; i < host.cmd_cnt; i++) {
+		if (host.cmd_log[i] == cmd) {
+			cnt++;
+		}
+	}
+
+	return cnt;
+}
+
+static void conn_info_enc(struct nrf_rpc_cbor_ctx *rsp)
+{
+	bt_addr_le_t local = {0};
+
+	ser_encode_int(rsp, 0);
+	ser_encode_uint(rsp, BT_CONN_TYPE_LE);
+	ser_encode_uint(rsp, BT_HCI_ROLE_PERIPHERAL);
+	ser_encode_uint(rsp, BT_ID_DEFAULT);
+	/* Interval, latency and timeout. */
+	ser_encode_uint(rsp, 24);
+	ser_encode_uint(rsp, 0);
+	ser_encode_uint(rsp, 400);
+	/* Source, destination, local and remote address. */
+	ser_encode_buffer(rsp, &local, sizeof(local));
+	ser_encode_buffer(rsp, &peer_addr, sizeof(peer_addr));
+	ser_encode_buffer(rsp, &local, sizeof(local));
+	ser_encode_buffer(rsp, &peer_addr, sizeof(peer_addr));
+	/* No PHY and data length information. */
+	ser_encode_null(rsp);
+	ser_encode_null(rsp);
+	ser_encode_uint(rsp, host.conn_state);
+}
+
+static void notify_batch_dec(struct nrf_rpc_cbor_ctx *req, struct nrf_rpc_cbor_ctx *rsp)
+{
+	size_t count = ser_decode_uint(req);
+
+	zassert_true(host.batch_cnt + count <= BATCH_ENTRIES_MAX, "Too many notifications");
+
+	for (size_t i = 0; i < count; i++) {
+		struct batch_entry *entry = &host.batch[host.batch_cnt++];
+		const void *data;
+
+		entry->conn_index = ser_decode_uint(req);
+		entry->attr_index = ser_decode_uint(req);
+		entry->len = 0;
+		data = ser_decode_buffer_ptr_and_size(req, &entry->len);
+
+		zassert_true(ser_decode_valid(req), "Invalid batch encoding");
+		zassert_true(entry->len <= sizeof(entry->data), "Notification too long");
+		if (entry->len > 0) {
+			memcpy(entry->data, data, entry->len);
+		}
+	}
+
+	ser_encode_int(rsp, 0);
+}
+
+/* Decode a command of the client, and encode the response of the host. */
+static void host_cmd_handle(uint8_t cmd, struct nrf_rpc_cbor_ctx *req,
+			    struct nrf_rpc_cbor_ctx *rsp)
+{
+	zassert_true(host.cmd_cnt < CMD_LOG_MAX, "Too many commands");
+	host.cmd_log[host.cmd_cnt++] = cmd;
+
+	switch (cmd) {
+	case BT_CONN_LOOKUP_ADDR_LE_RPC_CMD:
+		ser_encode_uint(rsp, CONN_INDEX);
+		break;
+
+	case BT_CONN_REMOTE_UPDATE_REF_RPC_CMD:
+		zassert_equal(ser_decode_uint(req), CONN_INDEX, NULL);
+		host.remote_ref += ser_decode_int(req);
+		break;
+
+	case BT_CONN_GET_INFO_RPC_CMD:
+		zassert_equal(ser_decode_uint(req), CONN_INDEX, NULL);
+		conn_info_enc(rsp);
+		break;
+
+	case BT_CONN_GET_DST_OUT_RPC_CMD:
+		zassert_equal(ser_decode_uint(req), CONN_INDEX, NULL);
+		ser_encode_bool(rsp, true);
+		ser_encode_buffer(rsp, &peer_addr, sizeof(peer_addr));
+		break;
+
+	case BT_CONN_DISCONNECT_RPC_CMD:
+		zassert_equal(ser_decode_uint(req), CONN_INDEX, NULL);
+		ser_encode_int(rsp, 0);
+		break;
+
+	case BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD:
+		notify_batch_dec(req, rsp);
+		break;
+
+	case BT_GATT_NOTIFY_CB_RPC_CMD:
+		ser_encode_int(rsp, 0);
+		break;
+
+	default:
+		zassert_unreachable("Unexpected command %u", cmd);
+		break;
+	}
+}
+
+void __wrap_nrf_rpc_cbor_cmd_no_err(const struct nrf_rpc_group *group, uint8_t cmd,
+				    struct nrf_rpc_cbor_ctx *ctx,
+				    nrf_rpc_cbor_handler_t handler, void *handler_data)
+{
+	static uint8_t rsp_buf[RSP_BUF_SIZE];
+	struct nrf_rpc_cbor_ctx req;
+	struct nrf_rpc_cbor_ctx rsp;
+	size_t len;
+
+	zassert_equal(group, &bt_rpc_grp, "Unexpected group");
+
+	len = ctx->zs[0].payload - ctx->out_packet;
+	zcbor_new_decode_state(req.zs, ARRAY_SIZE(req.zs), ctx->out_packet, len,
+			       ZCBOR_ELEM_MAX);
+	zcbor_new_encode_state(rsp.zs, ARRAY_SIZE(rsp.zs), rsp_buf, sizeof(rsp_buf), 0);
+
+	host_cmd_handle(cmd, &req, &rsp);
+
+	NRF_RPC_CBOR_DISCARD(group, *ctx);
+
+	len = rsp.zs[0].payload - rsp_buf;
+	zcbor_new_decode_state(rsp.zs, ARRAY_SIZE(rsp.zs), rsp_buf, len, ZCBOR_ELEM_MAX);
+	handler(group, &rsp, handler_data);
+}
+
+static struct bt_conn *conn_get(void)
+{
+	struct bt_conn *conn = bt_conn_lookup_addr_le(BT_ID_DEFAULT, &peer_addr);
+
+	zassert_not_null(conn, "Connection not found");
+
+	return conn;
+}
+
+static void test_conn_info_cache(void)
+{
+	struct bt_conn *conn;
+	struct bt_conn_info info;
+
+	host_reset();
+	conn = conn_get();
+
+	zassert_ok(bt_conn_get_info(conn, &info), NULL);
+	zassert_equal(info.type, BT_CONN_TYPE_LE, NULL);
+	zassert_equal(info.role, BT_HCI_ROLE_PERIPHERAL, NULL);
+	zassert_equal(info.le.interval, 24, NULL);
+	zassert_equal(info.le.timeout, 400, NULL);
+	zassert_equal(bt_addr_le_cmp(info.le.dst, &peer_addr), 0, "Wrong destination");
+	zassert_equal(info.state, BT_CONN_STATE_CONNECTED, NULL);
+
+	/* Answered from the cache. */
+	zassert_ok(bt_conn_get_info(conn, &info), NULL);
+	zassert_equal(bt_addr_le_cmp(bt_conn_get_dst(conn), &peer_addr), 0,
+		      "Wrong destination");
+	zassert_equal(cmd_count(BT_CONN_GET_INFO_RPC_CMD), 1, "Information not cached");
+	zassert_equal(cmd_count(BT_CONN_GET_DST_OUT_RPC_CMD), 0, "Destination not cached");
+
+	/* Disconnecting drops the cached information. */
+	zassert_ok(bt_conn_disconnect(conn, BT_HCI_ERR_REMOTE_USER_TERM_CONN), NULL);
+	host.conn_state = BT_CONN_STATE_DISCONNECTING;
+
+	zassert_ok(bt_conn_get_info(conn, &info), NULL);
+	zassert_equal(info.state, BT_CONN_STATE_DISCONNECTING, NULL);
+	zassert_equal(cmd_count(BT_CONN_GET_INFO_RPC_CMD), 2, "Cache not invalidated");
+
+	/* A connection that is not established is not cached. */
+	zassert_ok(bt_conn_get_info(conn, &info), NULL);
+	zassert_equal(cmd_count(BT_CONN_GET_INFO_RPC_CMD), 3, "Closing connection cached");
+
+	zassert_equal(bt_addr_le_cmp(bt_conn_get_dst(conn), &peer_addr), 0,
+		      "Wrong destination");
+	zassert_equal(cmd_count(BT_CONN_GET_DST_OUT_RPC_CMD), 1, "Destination not fetched");
+
+	bt_conn_unref(conn);
+}
+
+static void notify(struct bt_conn *conn, const void *data, uint16_t len,
+		   bt_gatt_complete_func_t func)
+{
+	struct bt_gatt_notify_params params = {
+		.attr = notif_attr,
+		.data = data,
+		.len = len,
+		.func = func,
+	};
+
+	zassert_ok(bt_gatt_notify_cb(conn, &params), "Notification failed");
+}
+
+static void test_notify_batch_encoding(void)
+{
+	static const uint8_t data_1[] = { 0x01, 0x02, 0x03 };
+	static const uint8_t data_2[NOTIF_DATA_MAX] = { 0xaa, [NOTIF_DATA_MAX - 1] = 0x55 };
+	struct bt_conn *conn;
+	uint32_t attr_index;
+
+	zassert_ok(bt_rpc_gatt_attr_to_index(notif_attr, &attr_index), NULL);
+
+	host_reset();
+	conn = conn_get();
+
+	notify(conn, data_1, sizeof(data_1), NULL);
+	notify(conn, data_2, sizeof(data_2), NULL);
+	/* A notification without data. */
+	notify(conn, NULL, 0, NULL);
+
+	zassert_equal(cmd_count(BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD), 0, "Batch sent too early");
+
+	bt_rpc_gatt_notify_flush();
+
+	zassert_equal(cmd_count(BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD), 1, "Batch not sent");
+	zassert_equal(host.batch_cnt, 3, "Wrong number of notifications");
+
+	for (size_t i = 0; i < host.batch_cnt; i++) {
+		zassert_equal(host.batch[i].conn_index, CONN_INDEX, "Wrong connection");
+		zassert_equal(host.batch[i].attr_index, attr_index, "Wrong attribute");
+	}
+
+	zassert_equal(host.batch[0].len, sizeof(data_1), NULL);
+	zassert_mem_equal(host.batch[0].data, data_1, sizeof(data_1), NULL);
+	zassert_equal(host.batch[1].len, sizeof(data_2), NULL);
+	zassert_mem_equal(host.batch[1].data, data_2, sizeof(data_2), NULL);
+	zassert_equal(host.batch[2].len, 0, NULL);
+
+	/* Nothing left to send. */
+	bt_rpc_gatt_notify_flush();
+	zassert_equal(cmd_count(BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD), 1, "Empty batch sent");
+
+	bt_conn_unref(conn);
+}
+
+static void notify_complete(struct bt_conn *conn, void *user_data)
+{
+}
+
+static void test_notify_batch_order(void)
+{
+	static const uint8_t data[] = { 0x01 };
+	struct bt_conn *conn;
+
+	host_reset();
+	conn = conn_get();
+
+	/* A notification with a completion callback is not batched, and is
+	 * sent after the queued notifications.
+	 */
+	notify(conn, data, sizeof(data), NULL);
+	notify(conn, data, sizeof(data), notify_complete);
+
+	zassert_equal(host.cmd_cnt, 3, "Wrong number of commands");
+	zassert_equal(host.cmd_log[1], BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD, NULL);
+	zassert_equal(host.cmd_log[2], BT_GATT_NOTIFY_CB_RPC_CMD, NULL);
+
+	/* The batch is sent when the timeout expires. */
+	notify(conn, data, sizeof(data), NULL);
+	k_sleep(K_MSEC(CONFIG_BT_RPC_GATT_NOTIFY_BATCH_TIMEOUT * 2));
+
+	zassert_equal(cmd_count(BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD), 2, "Batch not sent");
+
+	bt_conn_unref(conn);
+}
+
+static void test_notify_batch_conn_ref(void)
+{
+	static const uint8_t data[] = { 0x01 };
+	struct bt_conn *conn;
+
+	host_reset();
+	conn = conn_get();
+
+	notify(conn, data, sizeof(data), NULL);
+
+	/* The queued notification keeps the connection referenced. */
+	bt_conn_unref(conn);
+	zassert_equal(cmd_count(BT_CONN_REMOTE_UPDATE_REF_RPC_CMD), 0,
+		      "Connection released with a queued notification");
+
+	bt_rpc_gatt_notify_flush();
+
+	zassert_equal(host.cmd_cnt, 3, "Wrong number of commands");
+	zassert_equal(host.cmd_log[1], BT_RPC_GATT_NOTIFY_BATCH_RPC_CMD, NULL);
+	zassert_equal(host.cmd_log[2], BT_CONN_REMOTE_UPDATE_REF_RPC_CMD,
+		      "Connection not released after the batch");
+	zassert_equal(host.remote_ref, -1, NULL);
+}
+
+void test_main(void)
+{
+	uint32_t svc_index;
+
+	zassert_ok(bt_rpc_gatt_add_service(&test_svc, &svc_index), NULL);
+
+	ztest_test_suite(bt_rpc_client_tests,
+			 ztest_unit_test(test_conn_info_cache),
+			 ztest_unit_test(test_notify_batch_encoding),
+			 ztest_unit_test(test_notify_batch_order),
+			 ztest_unit_test(test_notify_batch_conn_ref)
+			 );
+
+	ztest_run_test_suite(bt_rpc_client_tests);
+}
@@ -0,0 +1,493 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/uuid.h>
+#include <bluetooth/scan.h>
+
+#define AD_MAX_LEN 31
+
+#define UPDATER_STACK_SIZE 1024
+#define UPDATER_PRIORITY 1
+#define CONCURRENT_TEST_MS 200
+
+static const bt_addr_le_t addr_1 = {
+	.type = BT_ADDR_LE_RANDOM,
+	.a.val = { 0x01, 0x02, 0x03, 0x04, 0x05, 0xc6 },
+};
+
+static const bt_addr_le_t addr_2 = {
+	.type = BT_ADDR_LE_PUBLIC,
+	.a.val = { 0x11, 0x12, 0x13, 0x14, 0x15, 0x16 },
+};
+
+static const struct bt_uuid_128 uuid_128 = BT_UUID_INIT_128(
+	0x9e, 0xca, 0xdc, 0x24, 0x0e, 0xe5, 0xa9, 0xe0,
+	0x93, 0xf3, 0xa3, 0xb5, 0x01, 0x00, 0x40, 0x6e);
+
+static const uint8_t md_filter_data[] = { 0x59, 0x00, 0x01 };
+
+/* Scan callbacks registered by the Scan library, captured by wrapping the
+ * Bluetooth host function.
+ */
+static struct bt_le_scan_cb *scan_cb;
+
+static struct {
+	uint32_t match_cnt;
+	uint32_t no_match_cnt;
+	struct bt_scan_filter_match status;
+	char name[CONFIG_BT_SCAN_NAME_MAX_LEN + 1];
+	bt_addr_le_t addr;
+	uint16_t appearance;
+	uint8_t md[CONFIG_BT_SCAN_MANUFACTURER_DATA_MAX_LEN];
+} result;
+
+/* Called from the filter match callback, if set. */
+static void (*match_hook)(const struct bt_scan_filter_match *status);
+
+
+void __wrap_bt_le_scan_cb_register(struct bt_le_scan_cb *cb)
+{
+	scan_cb = cb;
+}
+
+static void scan_filter_match(struct bt_scan_device_info *device_info,
+			      struct bt_scan_filter_match *filter_match,
+			      bool connectable)
+{
+	result.match_cnt++;
+	result.status = *filter_match;
+
+	if (filter_match->name.match) {
+		memcpy(result.name, filter_match->name.name, filter_match->name.len);
+		result.name[filter_match->name.len] = '\0';
+	}
+
+	if (filter_match->addr.match) {
+		bt_addr_le_copy(&result.addr, filter_match->addr.addr);
+	}
+
+	if (filter_match->appearance.match) {
+		result.appearance = *filter_match->appearance.appearance;
+	}
+
+	if (filter_match->manufacturer_data.match) {
+		memcpy(result.md, filter_match->manufacturer_data.data,
+		       filter_match->manufacturer_data.len);
+	}
+
+	if (match_hook) {
+		match_hook(filter_match);
+	}
+}
+
+static void scan_filter_no_match(struct bt_scan_device_info *device_info,
+				 bool connectable)
+{
+	result.no_match_cnt++;
+}
+
+BT_SCAN_CB_INIT(scan_cb_data, scan_filter_match, scan_filter_no_match, NULL, NULL);
+
+/* Advertising data builder. */
+struct ad_buf {
+	uint8_t data[AD_MAX_LEN];
+	size_t len;
+};
+
+static void ad_add(struct ad_buf *ad, uint8_t type, const void *data, size_t len)
+{
+	zassert_true(ad->len + len + 2 <= sizeof(ad->data), "Advertising data too long");
+
+	ad->data[ad->len++] = len + 1;
+	ad->data[ad->len++] = type;
+	memcpy(&ad->data[ad->len], data, len);
+	ad->len += len;
+}
+
+static void ad_add_name(struct ad_buf *ad, uint8_t type, const char *name)
+{
+	ad_add(ad, type, name, strlen(name));
+}
+
+static void adv_report(const bt_addr_le_t *addr, const struct ad_buf *ad)
+{
+	struct bt_le_scan_recv_info info = {
+		.addr = addr,
+		.adv_props = BT_GAP_ADV_PROP_CONNECTABLE,
+	};
+	struct net_buf_simple buf;
+
+	zassert_not_null(scan_cb, "Scan callbacks not registered");
+
+	net_buf_simple_init_with_data(&buf, (void *)ad->data, ad->len);
+	scan_cb->recv(&info, &buf);
+}
+
+static void filters_reset(void)
+{
+	bt_scan_filter_disable();
+	bt_scan_filter_remove_all();
+	memset(&result, 0, sizeof(result));
+	match_hook = NULL;
+}
+
+static uint32_t hit_cnt(enum bt_scan_filter_type type, uint8_t idx)
+{
+	uint32_t cnt;
+
+	zassert_ok(bt_scan_filter_hit_cnt_get(type, idx, &cnt), "Cannot get hit count");
+
+	return cnt;
+}
+
+static void test_name_filter(void)
+{
+	struct ad_buf ad = {0};
+
+	filters_reset();
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Test dev"), NULL);
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER, false), NULL);
+
+	ad_add_name(&ad, BT_DATA_NAME_COMPLETE, "Test dev");
+	adv_report(&addr_1, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Name not matched");
+	zassert_true(result.status.name.match, NULL);
+	zassert_equal(strcmp(result.name, "Test dev"), 0, "Wrong name reported");
+
+	memset(&ad, 0, sizeof(ad));
+	ad_add_name(&ad, BT_DATA_NAME_COMPLETE, "Other");
+	adv_report(&addr_1, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Wrong name matched");
+	zassert_equal(result.no_match_cnt, 1, NULL);
+
+	/* The filter matches only when enabled. */
+	bt_scan_filter_disable();
+	memset(&ad, 0, sizeof(ad));
+	ad_add_name(&ad, BT_DATA_NAME_COMPLETE, "Test dev");
+	adv_report(&addr_1, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Disabled filter matched");
+}
+
+static void test_short_name_filter(void)
+{
+	const struct bt_scan_short_name short_name = {
+		.name = "Test",
+		.min_len = 3,
+	};
+	struct ad_buf ad = {0};
+
+	filters_reset();
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_SHORT_NAME, &short_name), NULL);
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_SHORT_NAME_FILTER, false), NULL);
+
+	ad_add_name(&ad, BT_DATA_NAME_SHORTENED, "Tes");
+	adv_report(&addr_1, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Short name not matched");
+	zassert_true(result.status.short_name.match, NULL);
+	zassert_equal(result.status.short_name.len, 3, NULL);
+
+	/* Shorter than the minimum length. */
+	memset(&ad, 0, sizeof(ad));
+	ad_add_name(&ad, BT_DATA_NAME_SHORTENED, "Te");
+	adv_report(&addr_1, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Too short name matched");
+}
+
+static void test_addr_filter(void)
+{
+	struct ad_buf ad = {0};
+
+	filters_reset();
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr_1), NULL);
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_ADDR_FILTER, false), NULL);
+
+	adv_report(&addr_1, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Address not matched");
+	zassert_true(result.status.addr.match, NULL);
+	zassert_equal(bt_addr_le_cmp(&result.addr, &addr_1), 0, "Wrong address reported");
+
+	adv_report(&addr_2, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Wrong address matched");
+}
+
+static void test_uuid_filter(void)
+{
+	struct ad_buf ad_16 = {0};
+	struct ad_buf ad_both = {0};
+	uint8_t uuids_16[] = { 0x0a, 0x18, 0x0d, 0x18 };
+
+	filters_reset();
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, BT_UUID_HRS), NULL);
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_UUID, &uuid_128.uuid), NULL);
+
+	ad_add(&ad_16, BT_DATA_UUID16_ALL, uuids_16, sizeof(uuids_16));
+	ad_add(&ad_both, BT_DATA_UUID16_ALL, uuids_16, sizeof(uuids_16));
+	ad_add(&ad_both, BT_DATA_UUID128_ALL, uuid_128.val, sizeof(uuid_128.val));
+
+	/* One UUID is enough in the normal mode. */
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_UUID_FILTER, false), NULL);
+	adv_report(&addr_1, &ad_16);
+
+	zassert_equal(result.match_cnt, 1, "UUID not matched");
+	zassert_equal(result.status.uuid.count, 1, NULL);
+	zassert_equal(bt_uuid_cmp(result.status.uuid.uuid[0], BT_UUID_HRS), 0,
+		      "Wrong UUID reported");
+
+	/* All UUIDs must be found in the match all mode. */
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_UUID_FILTER, true), NULL);
+	adv_report(&addr_1, &ad_16);
+
+	zassert_equal(result.match_cnt, 1, "Matched with a UUID missing");
+
+	adv_report(&addr_1, &ad_both);
+
+	zassert_equal(result.match_cnt, 2, "UUIDs not matched");
+	zassert_equal(result.status.uuid.count, 2, NULL);
+	zassert_equal(bt_uuid_cmp(result.status.uuid.uuid[1], &uuid_128.uuid), 0,
+		      "Wrong UUID reported");
+}
+
+static void test_appearance_and_manufacturer_data_filter(void)
+{
+	const uint16_t appearance = BT_APPEARANCE_HID_MOUSE;
+	const struct bt_scan_manufacturer_data md = {
+		.data = (uint8_t *)md_filter_data,
+		.data_len = sizeof(md_filter_data),
+	};
+	const uint8_t md_adv[] = { 0x59, 0x00, 0x01, 0xaa };
+	const uint8_t md_other[] = { 0x59, 0x00, 0x02, 0xaa };
+	uint8_t appearance_adv[sizeof(uint16_t)];
+	struct ad_buf ad = {0};
+
+	filters_reset();
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_APPEARANCE, &appearance), NULL);
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA, &md), NULL);
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_APPEARANCE_FILTER |
+					 BT_SCAN_MANUFACTURER_DATA_FILTER, true), NULL);
+
+	/* The appearance is decoded by the library as big-endian. */
+	sys_put_be16(appearance, appearance_adv);
+	ad_add(&ad, BT_DATA_GAP_APPEARANCE, appearance_adv, sizeof(appearance_adv));
+	ad_add(&ad, BT_DATA_MANUFACTURER_DATA, md_other, sizeof(md_other));
+	adv_report(&addr_1, &ad);
+
+	zassert_equal(result.match_cnt, 0, "Matched with wrong manufacturer data");
+
+	memset(&ad, 0, sizeof(ad));
+	ad_add(&ad, BT_DATA_GAP_APPEARANCE, appearance_adv, sizeof(appearance_adv));
+	ad_add(&ad, BT_DATA_MANUFACTURER_DATA, md_adv, sizeof(md_adv));
+	adv_report(&addr_1, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Appearance and manufacturer data not matched");
+	zassert_equal(result.appearance, appearance, "Wrong appearance reported");
+	zassert_equal(result.status.manufacturer_data.len, sizeof(md_filter_data), NULL);
+	zassert_mem_equal(result.md, md_filter_data, sizeof(md_filter_data),
+			  "Wrong manufacturer data reported");
+}
+
+static void test_match_all_filter_types(void)
+{
+	struct ad_buf ad = {0};
+
+	filters_reset();
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Test dev"), NULL);
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr_1), NULL);
+
+	ad_add_name(&ad, BT_DATA_NAME_COMPLETE, "Test dev");
+
+	/* In the normal mode, any of the filter types is enough. */
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_ADDR_FILTER, false),
+		   NULL);
+	adv_report(&addr_2, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Name not matched");
+	zassert_false(result.status.addr.match, NULL);
+
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_ADDR_FILTER, true),
+		   NULL);
+	adv_report(&addr_2, &ad);
+
+	zassert_equal(result.match_cnt, 1, "Matched without the address");
+
+	adv_report(&addr_1, &ad);
+
+	zassert_equal(result.match_cnt, 2, "Name and address not matched");
+	zassert_true(result.status.name.match, NULL);
+	zassert_true(result.status.addr.match, NULL);
+}
+
+static void test_hit_cnt(void)
+{
+	struct ad_buf ad = {0};
+	uint32_t cnt;
+
+	filters_reset();
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Dev 1"), NULL);
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Dev 2"), NULL);
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER, false), NULL);
+
+	zassert_equal(bt_scan_filter_hit_cnt_get(BT_SCAN_FILTER_TYPE_NAME, 0, NULL), -EINVAL,
+		      NULL);
+	zassert_equal(bt_scan_filter_hit_cnt_get(BT_SCAN_FILTER_TYPE_NAME, 2, &cnt), -ENOENT,
+		      NULL);
+	zassert_equal(bt_scan_filter_hit_cnt_get(BT_SCAN_FILTER_TYPE_ADDR, 0, &cnt), -ENOENT,
+		      NULL);
+	zassert_equal(bt_scan_filter_hit_cnt_get(BT_SCAN_FILTER_TYPE_MANUFACTURER_DATA + 1, 0,
+						 &cnt), -EINVAL, NULL);
+
+	ad_add_name(&ad, BT_DATA_NAME_COMPLETE, "Dev 2");
+	adv_report(&addr_1, &ad);
+	adv_report(&addr_2, &ad);
+
+	zassert_equal(hit_cnt(BT_SCAN_FILTER_TYPE_NAME, 0), 0, NULL);
+	zassert_equal(hit_cnt(BT_SCAN_FILTER_TYPE_NAME, 1), 2, NULL);
+
+	/* The counter is reset when a new filter takes the place. */
+	bt_scan_filter_remove_all();
+	zassert_equal(bt_scan_filter_hit_cnt_get(BT_SCAN_FILTER_TYPE_NAME, 0, &cnt), -ENOENT,
+		      NULL);
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Dev 3"), NULL);
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Dev 2"), NULL);
+	zassert_equal(hit_cnt(BT_SCAN_FILTER_TYPE_NAME, 1), 0, NULL);
+}
+
+static void filters_replace_hook(const struct bt_scan_filter_match *status)
+{
+	/* Compile the filters twice, so that the bank used for matching
+	 * is compiled again.
+	 */
+	bt_scan_filter_remove_all();
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Replaced"), NULL);
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr_2), NULL);
+
+	zassert_equal(strncmp(status->name.name, "Test dev", status->name.len), 0,
+		      "Reported name changed by the filter update");
+	zassert_equal(bt_addr_le_cmp(status->addr.addr, &addr_1), 0,
+		      "Reported address changed by the filter update");
+}
+
+static void test_filter_update_from_callback(void)
+{
+	struct ad_buf ad = {0};
+
+	filters_reset();
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME, "Test dev"), NULL);
+	zassert_ok(bt_scan_filter_add(BT_SCAN_FILTER_TYPE_ADDR, &addr_1), NULL);
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER | BT_SCAN_ADDR_FILTER, true),
+		   NULL);
+
+	match_hook = filters_replace_hook;
+	ad_add_name(&ad, BT_DATA_NAME_COMPLETE, "Test dev");
+	adv_report(&addr_1, &ad);
+	match_hook = NULL;
+
+	zassert_equal(result.match_cnt, 1, "Filters not matched");
+
+	/* The new filters are used for the next report. */
+	adv_report(&addr_1, &ad);
+	zassert_equal(result.match_cnt, 1, "Removed filters matched");
+
+	memset(&ad, 0, sizeof(ad));
+	ad_add_name(&ad, BT_DATA_NAME_COMPLETE, "Replaced");
+	adv_report(&addr_2, &ad);
+	zassert_equal(result.match_cnt, 2, "New filters not matched");
+}
+
+static const char * const concurrent_names[] = { "Alpha device", "Beta" };
+static atomic_t updater_stop;
+static K_THREAD_STACK_DEFINE(updater_stack, UPDATER_STACK_SIZE);
+static struct k_thread updater_thread;
+
+static void updater_fn(void *p1, void *p2, void *p3)
+{
+	for (size_t i = 0; !atomic_get(&updater_stop); i++) {
+		bt_scan_filter_remove_all();
+		bt_scan_filter_add(BT_SCAN_FILTER_TYPE_NAME,
+				   concurrent_names[i % ARRAY_SIZE(concurrent_names)]);
+		k_sleep(K_TICKS(1));
+	}
+}
+
+static const char *concurrent_adv_name;
+static atomic_t concurrent_mismatch_cnt;
+
+static void concurrent_check_hook(const struct bt_scan_filter_match *status)
+{
+	/* Whatever filters are set, a reported match must describe
+	 * the advertised name.
+	 */
+	if ((status->name.len != strlen(concurrent_adv_name)) ||
+	    strncmp(status->name.name, concurrent_adv_name, status->name.len)) {
+		atomic_inc(&concurrent_mismatch_cnt);
+	}
+}
+
+static void test_concurrent_filter_update(void)
+{
+	struct ad_buf ad[ARRAY_SIZE(concurrent_names)] = {0};
+	int64_t end;
+
+	filters_reset();
+	zassert_ok(bt_scan_filter_enable(BT_SCAN_NAME_FILTER, false), NULL);
+
+	for (size_t i = 0; i < ARRAY_SIZE(ad); i++) {
+		ad_add_name(&ad[i], BT_DATA_NAME_COMPLETE, concurrent_names[i]);
+	}
+
+	atomic_set(&updater_stop, false);
+	atomic_set(&concurrent_mismatch_cnt, 0);
+	match_hook = concurrent_check_hook;
+
+	k_thread_create(&updater_thread, updater_stack, K_THREAD_STACK_SIZEOF(updater_stack),
+			updater_fn, NULL, NULL, NULL, UPDATER_PRIORITY, 0, K_NO_WAIT);
+
+	end = k_uptime_get() + CONCURRENT_TEST_MS;
+	for (size_t i = 0; k_uptime_get() < end; i++) {
+		concurrent_adv_name = concurrent_names[i % ARRAY_SIZE(concurrent_names)];
+		adv_report(&addr_1, &ad[i % ARRAY_SIZE(ad)]);
+		k_yield();
+	}
+
+	atomic_set(&updater_stop, true);
+	k_thread_join(&updater_thread, K_FOREVER);
+	match_hook = NULL;
+
+	zassert_true(result.match_cnt > 0, "No filter matched");
+	zassert_equal(atomic_get(&concurrent_mismatch_cnt), 0,
+		      "Reported filter does not match the advertising data");
+}
+
+void test_main(void)
+{
+	bt_scan_init(NULL);
+	bt_scan_cb_register(&scan_cb_data);
+
+	ztest_test_suite(bt_scan_tests,
+			 ztest_unit_test(test_name_filter),
+			 ztest_unit_test(test_short_name_filter),
+			 ztest_unit_test(test_addr_filter),
+			 ztest_unit_test(test_uuid_filter),
+			 ztest_unit_test(test_appearance_and_manufacturer_data_filter),
+			 ztest_unit_test(test_match_all_filter_types),
+			 ztest_unit_test(test_hit_cnt),
+			 ztest_unit_test(test_filter_update_from_callback),
+			 ztest_unit_test(test_concurrent_filter_update)
+			 );
+
+	ztest_run_test_suite(bt_scan_tests);
+}
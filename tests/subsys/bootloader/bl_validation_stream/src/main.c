@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <bl_validation.h>
+#include <bl_crypto.h>
+#include <fw_info.h>
+#include <pm_config.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/devicetree.h>
+
+#define CHUNK_SIZE 0x400
+#define FLASH_END (DT_REG_ADDR(DT_CHOSEN(zephyr_flash)) \
+		+ DT_REG_SIZE(DT_CHOSEN(zephyr_flash)))
+
+static uint8_t chunk[CHUNK_SIZE];
+
+/* Stream the current app in chunks through a RAM buffer, like a copy
+ * operation would. If mangle_offset is within the app, the byte at that
+ * offset is inverted in the buffer before it is hashed.
+ */
+static int stream_app(struct bl_validate_fw_stream *stream, uint32_t len,
+		      uint32_t mangle_offset)
+{
+	for (uint32_t offset = 0; offset < len; offset += CHUNK_SIZE) {
+		uint32_t chunk_len = MIN(CHUNK_SIZE, len - offset);
+
+		memcpy(chunk, (const uint8_t *)(PM_ADDRESS + offset), chunk_len);
+		if ((mangle_offset >= offset)
+			&& (mangle_offset < (offset + chunk_len))) {
+			chunk[mangle_offset - offset] ^= 0xFF;
+		}
+
+		int err = bl_validate_firmware_stream_update(stream, chunk,
+							     chunk_len);
+
+		if (err) {
+			return err;
+		}
+	}
+	return 0;
+}
+
+void test_stream(void)
+{
+	const struct fw_info *fwinfo = fw_info_find(PM_ADDRESS);
+	struct bl_validate_fw_stream stream;
+
+	zassert_not_null(fwinfo, "Could not find firmware info.\r\n");
+
+	/* Stream past the end of the signed region, like a copy of the whole
+	 * slot would. The extra bytes must be ignored.
+	 */
+	zassert_equal(0, bl_validate_firmware_stream_init(&stream, PM_ADDRESS,
+							  fwinfo->size), NULL);
+	zassert_equal(0, stream_app(&stream, fwinfo->size + 0x200, UINT32_MAX),
+		      NULL);
+	zassert_true(bl_validate_firmware_stream_finish(&stream),
+		"Failed to validate streamed app.\r\n");
+
+	zassert_equal(0, bl_validate_firmware_stream_init(&stream, PM_ADDRESS,
+							  fwinfo->size), NULL);
+	zassert_equal(0, stream_app(&stream, fwinfo->size, 0x300), NULL);
+	zassert_false(bl_validate_firmware_stream_finish(&stream),
+		"Incorrectly validated mangled stream.\r\n");
+
+	zassert_equal(0, bl_validate_firmware_stream_init(&stream, PM_ADDRESS,
+							  fwinfo->size), NULL);
+	zassert_equal(0, stream_app(&stream, fwinfo->size - 4, UINT32_MAX),
+		      NULL);
+	zassert_false(bl_validate_firmware_stream_finish(&stream),
+		"Incorrectly validated incomplete stream.\r\n");
+
+	zassert_equal(0, bl_validate_firmware_stream_init(&stream, PM_ADDRESS,
+							  fwinfo->size - 4), NULL);
+	zassert_equal(0, stream_app(&stream, fwinfo->size, UINT32_MAX), NULL);
+	zassert_false(bl_validate_firmware_stream_finish(&stream),
+		"Incorrectly validated stream with wrong size.\r\n");
+
+	zassert_equal(-EINVAL, bl_validate_firmware_stream_init(&stream,
+							PM_ADDRESS, 0), NULL);
+}
+
+static uint32_t hash_cycles(uint32_t len)
+{
+	bl_sha256_ctx_t ctx;
+	uint8_t hash[CONFIG_SB_HASH_LEN];
+	uint32_t start = k_cycle_get_32();
+
+	zassert_equal(0, bl_sha256_init(&ctx), NULL);
+	zassert_equal(0, bl_sha256_update(&ctx, (const uint8_t *)PM_ADDRESS,
+					  len), NULL);
+	zassert_equal(0, bl_sha256_finalize(&ctx, hash), NULL);
+
+	return k_cycle_get_32() - start;
+}
+
+/* Not a pass/fail test, prints the boot time cost of validation. */
+void test_benchmark(void)
+{
+	const struct fw_info *fwinfo = fw_info_find(PM_ADDRESS);
+	const uint32_t sizes[] = {KB(256), KB(1024)};
+	struct bl_validate_fw_stream stream;
+	uint32_t start;
+
+	zassert_not_null(fwinfo, "Could not find firmware info.\r\n");
+	zassert_equal(0, bl_crypto_init(), NULL);
+
+	for (int i = 0; i < ARRAY_SIZE(sizes); i++) {
+		uint32_t len = MIN(sizes[i], FLASH_END - PM_ADDRESS);
+
+		TC_PRINT("SHA-256 of %u bytes: %u cycles\n", len,
+			 hash_cycles(len));
+	}
+
+	start = k_cycle_get_32();
+	zassert_true(bl_validate_firmware_local(PM_ADDRESS, fwinfo), NULL);
+	TC_PRINT("In place validation of %u bytes: %u cycles\n", fwinfo->size,
+		 k_cycle_get_32() - start);
+
+	zassert_equal(0, bl_validate_firmware_stream_init(&stream, PM_ADDRESS,
+							  fwinfo->size), NULL);
+	zassert_equal(0, stream_app(&stream, fwinfo->size, UINT32_MAX), NULL);
+	start = k_cycle_get_32();
+	zassert_true(bl_validate_firmware_stream_finish(&stream), NULL);
+	TC_PRINT("Validation after streaming %u bytes: %u cycles\n",
+		 fwinfo->size, k_cycle_get_32() - start);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(test_bl_validation_stream,
+			 ztest_unit_test(test_stream),
+			 ztest_unit_test(test_benchmark)
+	);
+	ztest_run_test_suite(test_bl_validation_stream);
+}
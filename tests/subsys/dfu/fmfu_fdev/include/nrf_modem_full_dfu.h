@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Declarations of the modem library functions used by fmfu_fdev. They are
+ * implemented by the mocks in this test.
+ */
+
+#ifndef NRF_MODEM_FULL_DFU_H__
+#define NRF_MODEM_FULL_DFU_H__
+
+#include <stdint.h>
+
+struct nrf_modem_full_dfu_digest;
+
+int nrf_modem_full_dfu_init(struct nrf_modem_full_dfu_digest *digest_buffer);
+int nrf_modem_full_dfu_bl_write(uint32_t len, void *src);
+int nrf_modem_full_dfu_fw_write(uint32_t addr, uint32_t len, void *src);
+int nrf_modem_full_dfu_apply(void);
+int nrf_modem_full_dfu_verify(uint32_t data_len, void *data);
+
+#endif /* NRF_MODEM_FULL_DFU_H__ */
@@ -0,0 +1,357 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <ztest.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/sys/util.h>
+#include <dfu/fmfu_fdev.h>
+#include <nrf_modem_full_dfu.h>
+#include <modem_update_decode.h>
+#include <mbedtls/sha256.h>
+#ifdef CONFIG_FMFU_FDEV_SAVE_PROGRESS
+#include <zephyr/settings/settings.h>
+#endif
+
+/* Simulated time it takes to read from flash and to write to the modem. */
+#define FLASH_READ_US_PER_KB 1000
+#define MODEM_WRITE_US_PER_KB 2000
+
+#define WRAPPER_LEN 1024
+#define SEG_COUNT 3
+
+static const struct Segment test_segments[SEG_COUNT] = {
+	/* The bootloader. */
+	{ ._Segment_target_addr = 0, ._Segment_len = 4096 },
+	{ ._Segment_target_addr = 0x50000, ._Segment_len = 20 * 1024 + 100 },
+	{ ._Segment_target_addr = 0x80000, ._Segment_len = 36 * 1024 + 12 },
+};
+
+#define BLOB_LEN (4096 + 20 * 1024 + 100 + 36 * 1024 + 12)
+
+static uint8_t flash_data[WRAPPER_LEN + BLOB_LEN];
+static uint8_t blob_hash[32];
+static uint8_t buf[2048];
+
+static struct {
+	/* Updated by both the test thread and the fmfu_fdev reader thread. */
+	atomic_t busy_us;
+	size_t flash_bytes_read;
+	size_t bl_bytes;
+	size_t fw_bytes;
+	uint32_t first_fw_addr;
+	uint32_t next_fw_addr;
+	uint32_t fail_addr;
+	/* Byte inverted in flash_data once the blob has been hashed. */
+	size_t corrupt_offset;
+	int apply_count;
+	int verify_count;
+} mock;
+
+static void simulate_delay(size_t len, uint32_t us_per_kb)
+{
+	uint32_t us = len * us_per_kb / 1024;
+
+	atomic_add(&mock.busy_us, us);
+	k_usleep(us);
+}
+
+/* Flash device mock, reads from flash_data. */
+static int mock_flash_read(const struct device *dev, off_t offset, void *data,
+			   size_t len)
+{
+	zassert_true(offset + len <= sizeof(flash_data), "Read out of bounds");
+
+	if (mock.corrupt_offset &&
+	    mock.flash_bytes_read >= WRAPPER_LEN + BLOB_LEN) {
+		flash_data[mock.corrupt_offset] ^= 0xff;
+		mock.corrupt_offset = 0;
+	}
+
+	memcpy(data, &flash_data[offset], len);
+	mock.flash_bytes_read += len;
+	simulate_delay(len, FLASH_READ_US_PER_KB);
+
+	return 0;
+}
+
+static const struct flash_parameters mock_flash_parameters = {
+	.write_block_size = 1,
+	.erase_value = 0xff,
+};
+
+static const struct flash_parameters *
+mock_flash_get_parameters(const struct device *dev)
+{
+	return &mock_flash_parameters;
+}
+
+static const struct flash_driver_api mock_flash_api = {
+	.read = mock_flash_read,
+	.get_parameters = mock_flash_get_parameters,
+};
+
+static int mock_flash_init(const struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_DEFINE(mock_flash, "mock_flash", mock_flash_init, NULL, NULL, NULL,
+	      POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &mock_flash_api);
+
+/* Decoder mocks, the wrapper in flash_data is not valid CBOR. */
+int cbor_decode_Wrapper(const uint8_t *payload, size_t payload_len,
+			struct COSE_Sign1_Manifest *result,
+			size_t *payload_len_out)
+{
+	static const uint8_t segments_cbor[1];
+
+	memset(result, 0, sizeof(*result));
+	result->_COSE_Sign1_Manifest_payload_cbor._Manifest_blob_hash.value =
+		blob_hash;
+	result->_COSE_Sign1_Manifest_payload_cbor._Manifest_blob_hash.len =
+		sizeof(blob_hash);
+	result->_COSE_Sign1_Manifest_payload_cbor._Manifest_segments.value =
+		segments_cbor;
+	result->_COSE_Sign1_Manifest_payload_cbor._Manifest_segments.len =
+		sizeof(segments_cbor);
+	*payload_len_out = WRAPPER_LEN;
+
+	return ZCBOR_SUCCESS;
+}
+
+int cbor_decode_Segments(const uint8_t *payload, size_t payload_len,
+			 struct Segments *result, size_t *payload_len_out)
+{
+	memcpy(result->_Segments__Segment, test_segments,
+	       sizeof(test_segments));
+	result->_Segments__Segment_count = SEG_COUNT;
+
+	return ZCBOR_SUCCESS;
+}
+
+/* Modem mocks, check that the written data matches the blob. */
+static const uint8_t *blob_data(uint32_t addr, uint32_t len)
+{
+	size_t offset = WRAPPER_LEN;
+
+	for (int i = 0; i < SEG_COUNT; i++) {
+		const struct Segment *seg = &test_segments[i];
+
+		if (i != 0 && addr >= seg->_Segment_target_addr &&
+		    addr + len <= seg->_Segment_target_addr + seg->_Segment_len) {
+			return &flash_data[offset + addr -
+					   seg->_Segment_target_addr];
+		}
+		offset += seg->_Segment_len;
+	}
+
+	return NULL;
+}
+
+static bool is_segment_start(uint32_t addr)
+{
+	for (int i = 1; i < SEG_COUNT; i++) {
+		if (addr == test_segments[i]._Segment_target_addr) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int nrf_modem_full_dfu_init(struct nrf_modem_full_dfu_digest *digest_buffer)
+{
+	return 0;
+}
+
+int nrf_modem_full_dfu_bl_write(uint32_t len, void *src)
+{
+	zassert_true(mock.bl_bytes + len <= test_segments[0]._Segment_len,
+		     "Bootloader too large");
+	zassert_mem_equal(src, &flash_data[WRAPPER_LEN + mock.bl_bytes], len,
+			  "Unexpected bootloader data");
+
+	mock.bl_bytes += len;
+	simulate_delay(len, MODEM_WRITE_US_PER_KB);
+
+	return 0;
+}
+
+int nrf_modem_full_dfu_fw_write(uint32_t addr, uint32_t len, void *src)
+{
+	const uint8_t *expected = blob_data(addr, len);
+
+	zassert_not_null(expected, "Write outside of segments");
+	zassert_mem_equal(src, expected, len, "Unexpected firmware data");
+
+	if (mock.fw_bytes == 0) {
+		mock.first_fw_addr = addr;
+	} else if (addr != mock.next_fw_addr) {
+		zassert_true(is_segment_start(addr), "Write out of order");
+	}
+
+	if (mock.fail_addr && addr + len > mock.fail_addr) {
+		return -EIO;
+	}
+
+	mock.fw_bytes += len;
+	mock.next_fw_addr = addr + len;
+	simulate_delay(len, MODEM_WRITE_US_PER_KB);
+
+	return 0;
+}
+
+int nrf_modem_full_dfu_apply(void)
+{
+	mock.apply_count++;
+
+	return 0;
+}
+
+int nrf_modem_full_dfu_verify(uint32_t data_len, void *data)
+{
+	mock.verify_count++;
+
+	return 0;
+}
+
+static void reset_mocks(void)
+{
+	memset(&mock, 0, sizeof(mock));
+}
+
+static int load(void)
+{
+	return fmfu_fdev_load(buf, sizeof(buf), DEVICE_GET(mock_flash), 0);
+}
+
+static void test_load(void)
+{
+	int64_t start;
+	uint32_t elapsed_us;
+
+	reset_mocks();
+	start = k_uptime_ticks();
+	zassert_equal(load(), 0, "Load failed");
+	elapsed_us = k_ticks_to_us_floor32(k_uptime_ticks() - start);
+
+	zassert_equal(mock.bl_bytes, test_segments[0]._Segment_len, NULL);
+	zassert_equal(mock.fw_bytes, BLOB_LEN - test_segments[0]._Segment_len,
+		      NULL);
+	zassert_equal(mock.first_fw_addr, test_segments[1]._Segment_target_addr,
+		      NULL);
+	zassert_equal(mock.verify_count, 1, NULL);
+	zassert_equal(mock.apply_count, 2, NULL);
+
+	TC_PRINT("Loaded %d bytes in %u us, %u us of flash and modem time, "
+		 "%zu bytes read from flash\n", BLOB_LEN, elapsed_us,
+		 (uint32_t)atomic_get(&mock.busy_us), mock.flash_bytes_read);
+
+	/* Once to check the hash, and once to write it. */
+	zassert_equal(mock.flash_bytes_read, WRAPPER_LEN + 2 * BLOB_LEN,
+		      "Blob not read twice");
+
+	if (IS_ENABLED(CONFIG_FMFU_FDEV_PIPELINE)) {
+		/* Reading overlaps with writing, so the load takes less time
+		 * than the sum of the two.
+		 */
+		zassert_true(elapsed_us < atomic_get(&mock.busy_us) * 9 / 10,
+			     "Reading and writing did not overlap");
+	}
+}
+
+static void test_invalid_hash(void)
+{
+	size_t offset = WRAPPER_LEN + BLOB_LEN - 100;
+
+	flash_data[offset] ^= 0xff;
+	reset_mocks();
+	zassert_equal(load(), -EINVAL, "Invalid blob loaded");
+	flash_data[offset] ^= 0xff;
+
+	zassert_equal(mock.bl_bytes + mock.fw_bytes, 0, "Invalid blob written");
+	zassert_equal(mock.apply_count, 0, "Invalid blob applied");
+}
+
+static void test_changed_during_write(void)
+{
+	size_t offset = WRAPPER_LEN + BLOB_LEN - 100;
+
+	if (!IS_ENABLED(CONFIG_FMFU_FDEV_HASH_ON_READ)) {
+		ztest_test_skip();
+		return;
+	}
+
+	reset_mocks();
+	mock.corrupt_offset = offset;
+	zassert_equal(load(), -EINVAL, "Changed blob loaded");
+	flash_data[offset] ^= 0xff;
+
+	/* The blob was valid when the bootloader was applied. */
+	zassert_equal(mock.verify_count, 1, NULL);
+	zassert_equal(mock.apply_count, 1, "Changed firmware applied");
+}
+
+static void test_resume(void)
+{
+	uint32_t fail_addr = test_segments[2]._Segment_target_addr + 0x1000;
+
+	reset_mocks();
+	mock.fail_addr = fail_addr;
+	zassert_equal(load(), -EIO, "Write error not reported");
+	zassert_equal(mock.apply_count, 1, "Firmware applied after error");
+
+	reset_mocks();
+	zassert_equal(load(), 0, "Load failed");
+	zassert_equal(mock.bl_bytes, test_segments[0]._Segment_len,
+		      "Bootloader not written again");
+	zassert_equal(mock.verify_count, 1, "Prevalidation not run again");
+	zassert_equal(mock.apply_count, 2, NULL);
+
+	if (IS_ENABLED(CONFIG_FMFU_FDEV_SAVE_PROGRESS)) {
+		zassert_equal(mock.first_fw_addr,
+			      test_segments[2]._Segment_target_addr,
+			      "Did not resume at the failed segment");
+	} else {
+		zassert_equal(mock.first_fw_addr,
+			      test_segments[1]._Segment_target_addr, NULL);
+	}
+
+	/* The progress is cleared once the update has been applied. */
+	reset_mocks();
+	zassert_equal(load(), 0, "Load failed");
+	zassert_equal(mock.first_fw_addr, test_segments[1]._Segment_target_addr,
+		      NULL);
+}
+
+void test_main(void)
+{
+	mbedtls_sha256_context ctx;
+
+	for (size_t i = 0; i < sizeof(flash_data); i++) {
+		flash_data[i] = (i * 7 + (i >> 8)) & 0xff;
+	}
+
+	mbedtls_sha256_init(&ctx);
+	mbedtls_sha256_starts(&ctx, false);
+	mbedtls_sha256_update(&ctx, &flash_data[WRAPPER_LEN], BLOB_LEN);
+	mbedtls_sha256_finish(&ctx, blob_hash);
+
+#ifdef CONFIG_FMFU_FDEV_SAVE_PROGRESS
+	/* Do not resume from an earlier run of the test. */
+	settings_subsys_init();
+	settings_delete("fmfu/progress");
+#endif
+
+	ztest_test_suite(test_fmfu_fdev,
+			 ztest_unit_test(test_load),
+			 ztest_unit_test(test_invalid_hash),
+			 ztest_unit_test(test_changed_during_write),
+			 ztest_unit_test(test_resume)
+	);
+	ztest_run_test_suite(test_fmfu_fdev);
+}
@@ -5,6 +5,7 @@
  */
 #include <zephyr.h>
 #include <app_event_manager.h>
+#include <event_manager_proxy.h>
 
 #include "test_config.h"
 #include "common_utils.h"
@@ -35,6 +36,20 @@ int proxy_burst_simple_events(void)
 	return 0;
 }
 
+int proxy_burst_simple_events_flushed(void)
+{
+	struct simple_event *event = new_simple_event();
+	int ret = 0;
+
+	for (size_t cnt = 0; (cnt < TEST_CONFIG_SIMPLE_BURST_SIZE) && !ret; ++cnt) {
+		proxy_direct_submit_event(&event->header);
+		ret = event_manager_proxy_flush();
+	}
+	app_event_manager_free(event);
+
+	return ret;
+}
+
 int proxy_burst_simple_pong_events(void)
 {
 	struct simple_pong_event *event = new_simple_pong_event();
@@ -72,6 +72,17 @@ void proxy_direct_submit_event(struct app_event_header *eh);
  */
 int proxy_burst_simple_events(void);
 
+/**
+ * @brief Transfer a bulk of simple events directly to proxy, one per message.
+ *
+ * The function is similar to @ref proxy_burst_simple_events, but flushes
+ * the proxy after every event, so every event is sent in a separate IPC
+ * message even if batching is enabled.
+ *
+ * @return 0 or error code.
+ */
+int proxy_burst_simple_events_flushed(void);
+
 /**
  * @brief Transfer a bulk of simple pong events directly to proxy.
  *
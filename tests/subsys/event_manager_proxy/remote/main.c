@@ -46,13 +46,22 @@ void main(void)
 	}
 	LOG_INF("Event proxy remote added");
 
-	REMOTE_EVENT_SUBSCRIBE(ipc_instance, data_event);
-	REMOTE_EVENT_SUBSCRIBE(ipc_instance, simple_event);
-	REMOTE_EVENT_SUBSCRIBE(ipc_instance, simple_ping_event);
-	REMOTE_EVENT_SUBSCRIBE(ipc_instance, data_event);
-	REMOTE_EVENT_SUBSCRIBE(ipc_instance, data_big_event);
-	REMOTE_EVENT_SUBSCRIBE(ipc_instance, test_start_event);
-	REMOTE_EVENT_SUBSCRIBE(ipc_instance, test_end_event);
+	static const struct event_manager_proxy_subscription subs[] = {
+		EVENT_MANAGER_PROXY_SUBSCRIPTION(data_event),
+		EVENT_MANAGER_PROXY_SUBSCRIPTION(simple_event),
+		EVENT_MANAGER_PROXY_SUBSCRIPTION(simple_ping_event),
+		EVENT_MANAGER_PROXY_SUBSCRIPTION(data_big_event),
+		EVENT_MANAGER_PROXY_SUBSCRIPTION(test_start_event),
+		EVENT_MANAGER_PROXY_SUBSCRIPTION(test_end_event),
+	};
+
+	ret = event_manager_proxy_subscribe_bulk(ipc_instance, subs, ARRAY_SIZE(subs));
+	if (ret) {
+		LOG_ERR("Cannot register to remote events: %d", ret);
+		__ASSERT_NO_MSG(false);
+		return;
+	}
+	LOG_INF("Event proxy subscriptions registered");
 
 	ret = event_manager_proxy_start();
 	if (ret) {
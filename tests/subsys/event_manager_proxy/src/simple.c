@@ -30,19 +30,22 @@ static void test_simple_ping_pong(void)
 	zassert_ok(err, "No pong event received");
 }
 
-static void test_simple_burst(void)
+static uint32_t simple_burst_time_us(int (*burst_fn)(void))
 {
-	uint32_t us_spent;
-
 	test_start(TEST_SIMPLE_BURST);
 	test_start_ack_wait();
 
 	test_time_start();
 
-	proxy_burst_simple_events();
+	zassert_ok(burst_fn(), "Burst failed");
 	test_end_wait(TEST_SIMPLE_BURST);
 
-	us_spent = test_time_spent_us();
+	return test_time_spent_us();
+}
+
+static void test_simple_burst(void)
+{
+	uint32_t us_spent = simple_burst_time_us(proxy_burst_simple_events);
 
 	unsigned long speed =
 				     /* Burst size + test end event */
@@ -52,6 +55,26 @@ static void test_simple_burst(void)
 	printk(" Test sending simple burst speed %lu msg/sec\n", speed);
 }
 
+static void test_simple_burst_batching(void)
+{
+	if (!IS_ENABLED(CONFIG_EVENT_MANAGER_PROXY_BATCH)) {
+		ztest_test_skip();
+		return;
+	}
+
+	/* Flushing after every event sends the same IPC messages as the
+	 * unbatched path.
+	 */
+	uint32_t unbatched_us = simple_burst_time_us(proxy_burst_simple_events_flushed);
+	uint32_t batched_us = simple_burst_time_us(proxy_burst_simple_events);
+
+	printk(" Unbatched burst time: %u us\n", unbatched_us);
+	printk(" Batched burst time: %u us\n", batched_us);
+	zassert_true(batched_us < unbatched_us,
+		     "Batched burst not faster than unbatched (%u us >= %u us)",
+		     batched_us, unbatched_us);
+}
+
 static void test_simple_burst_from_remote(void)
 {
 	uint32_t us_spent;
@@ -101,6 +124,8 @@ static void test_simple_ping_pong_performance(void)
 
 	printk(" Time: %u us\n", us_spent);
 	printk(" Test ping pong speed %lu msg/sec\n", speed);
+	printk(" Test ping pong average round trip latency %u us\n",
+	       us_spent / TEST_CONFIG_SIMPLE_BURST_SIZE);
 }
 
 static bool simple_event_handler(const struct app_event_header *aeh)
@@ -129,6 +154,7 @@ void simple_run(void)
 	ztest_test_suite(simple_tests,
 			 ztest_unit_test(test_simple_ping_pong),
 			 ztest_unit_test(test_simple_burst),
+			 ztest_unit_test(test_simple_burst_batching),
 			 ztest_unit_test(test_simple_burst_from_remote),
 			 ztest_unit_test(test_simple_ping_pong_performance)
 			 );
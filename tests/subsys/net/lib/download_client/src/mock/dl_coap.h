@@ -31,5 +31,6 @@ int coap_get_recv_timeout(struct download_client *dl);
 int coap_initiate_retransmission(struct download_client *dl);
 int coap_parse(struct download_client *client, size_t len);
 int coap_request_send(struct download_client *client);
+int coap_fragment_get(struct download_client *client);
 
 #endif /* _DL_COAP_H_ */
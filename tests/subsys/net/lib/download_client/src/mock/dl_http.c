@@ -9,7 +9,8 @@
 
 #include "mock/dl_http.h"
 
-int http_parse(struct download_client *client, size_t len)
+int http_parse(struct download_client *client,
+	       struct download_client_conn *conn, size_t len)
 {
 	return 0;
 }
@@ -18,3 +19,26 @@ int http_get_request_send(struct download_client *client)
 {
 	return 0;
 }
+
+size_t http_conn_count(const struct download_client *client)
+{
+	return 1;
+}
+
+size_t http_fragment_len(const struct download_client *client,
+			 const struct download_client_conn *conn)
+{
+	return conn->offset;
+}
+
+struct download_client_conn *http_fragment_conn_get(struct download_client *client)
+{
+	return NULL;
+}
+
+void http_fragment_consume(struct download_client *client,
+			   struct download_client_conn *conn, size_t len)
+{
+	conn->offset -= len;
+	client->progress += len;
+}
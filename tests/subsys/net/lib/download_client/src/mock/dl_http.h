@@ -8,7 +8,14 @@
 
 #include <zephyr/kernel.h>
 
-int http_parse(struct download_client *client, size_t len);
+int http_parse(struct download_client *client,
+	       struct download_client_conn *conn, size_t len);
 int http_get_request_send(struct download_client *client);
+size_t http_conn_count(const struct download_client *client);
+size_t http_fragment_len(const struct download_client *client,
+			 const struct download_client_conn *conn);
+struct download_client_conn *http_fragment_conn_get(struct download_client *client);
+void http_fragment_consume(struct download_client *client,
+			   struct download_client_conn *conn, size_t len);
 
 #endif /* _DL_HTTP_H_ */
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket_offload.h>
+
+#include <ztest.h>
+#include <download_client.h>
+
+#include "mock/coap_server.h"
+
+#define HOST "coap://10.1.0.10"
+#define FILE_SIZE (10 * 1024)
+#define RTT_MS 200
+
+#define BLOCK_SIZE (16 << CONFIG_DOWNLOAD_CLIENT_COAP_BLOCK_SIZE)
+#define WINDOW CONFIG_DOWNLOAD_CLIENT_COAP_WINDOW
+
+static struct download_client client;
+static K_SEM_DEFINE(download_done, 0, 1);
+
+static struct {
+	size_t pos;
+	size_t bytes;
+	size_t errors;
+	bool mismatch;
+} received;
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	const uint8_t *buf;
+
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		/* Fragments must be in order, whatever order the blocks came in */
+		buf = event->fragment.buf;
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			if (buf[i] != mock_coap_server_file_byte(received.pos + i)) {
+				received.mismatch = true;
+				break;
+			}
+		}
+
+		received.pos += event->fragment.len;
+		received.bytes += event->fragment.len;
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		/* Reconnect and resume */
+		received.errors++;
+		break;
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		k_sem_give(&download_done);
+		break;
+	}
+
+	return 0;
+}
+
+static struct download_client_cfg config = {
+	.sec_tag = -1,
+	.pdn_id = 0,
+	.frag_size_override = 0,
+};
+
+/* Returns the download time in milliseconds */
+static int64_t download(size_t from)
+{
+	int64_t start;
+	int err;
+
+	memset(&received, 0, sizeof(received));
+	received.pos = from;
+
+	start = k_uptime_get();
+
+	err = download_client_connect(&client, HOST, &config);
+	zassert_ok(err, NULL);
+
+	err = download_client_start(&client, "dir/file.bin", from);
+	zassert_ok(err, NULL);
+
+	err = k_sem_take(&download_done, K_SECONDS(60));
+	zassert_ok(err, "Download did not complete");
+
+	zassert_false(received.mismatch, "Fragments out of order or corrupted");
+	zassert_equal(received.pos, FILE_SIZE, NULL);
+	zassert_equal(received.bytes, FILE_SIZE - from, NULL);
+
+	return k_uptime_get() - start;
+}
+
+/* Round trips to download the file: one for the first block, which gives
+ * the file size, then one for every WINDOW blocks.
+ */
+static size_t round_trips_expected(void)
+{
+	size_t blocks = DIV_ROUND_UP(FILE_SIZE, BLOCK_SIZE);
+
+	return 1 + DIV_ROUND_UP(blocks - 1, WINDOW);
+}
+
+static void setup(void)
+{
+	mock_coap_server_init(FILE_SIZE, RTT_MS, 0);
+}
+
+static void setup_lossy(void)
+{
+	/* Datagrams of a full block are lost one time in five */
+	mock_coap_server_init(FILE_SIZE, RTT_MS / 4, 50);
+}
+
+static void teardown(void)
+{
+	download_client_disconnect(&client);
+
+	/* Let the download thread suspend itself */
+	k_sleep(K_MSEC(100));
+}
+
+static void test_download_throughput(void)
+{
+	size_t blocks = DIV_ROUND_UP(FILE_SIZE, BLOCK_SIZE);
+	int64_t sequential = blocks * RTT_MS;
+	int64_t elapsed;
+
+	elapsed = download(0);
+
+	printk("Window %d, RTT %d ms: %u bytes in %u ms, %u B/s, %u.%02ux stop-and-wait\n",
+	       WINDOW, RTT_MS, FILE_SIZE, (uint32_t)elapsed,
+	       (uint32_t)((FILE_SIZE * 1000LL) / elapsed),
+	       (uint32_t)(sequential / elapsed),
+	       (uint32_t)(((sequential * 100) / elapsed) % 100));
+
+	zassert_true(elapsed <= (round_trips_expected() + 1) * RTT_MS,
+		     "Download took %u ms, expected %u round trips",
+		     (uint32_t)elapsed, (uint32_t)round_trips_expected());
+
+	zassert_equal(mock_coap_server_request_count(), blocks, NULL);
+
+	if (WINDOW > 1) {
+		zassert_true(elapsed < sequential, "No speed-up");
+	}
+}
+
+static void test_download_from_offset(void)
+{
+	/* The download resumes from the middle of a block */
+	download(FILE_SIZE / 3);
+}
+
+static void test_download_with_loss(void)
+{
+	download(0);
+
+	zassert_true(mock_coap_server_loss_count() > 0, NULL);
+	zassert_equal(received.errors, 0, NULL);
+}
+
+void test_main(void)
+{
+	int err;
+
+	err = download_client_init(&client, download_client_callback);
+	zassert_ok(err, NULL);
+
+	ztest_test_suite(lib_download_client_coap_test,
+			 ztest_unit_test_setup_teardown(test_download_throughput,
+							setup, teardown),
+			 ztest_unit_test_setup_teardown(test_download_from_offset,
+							setup, teardown),
+			 ztest_unit_test_setup_teardown(test_download_with_loss,
+							setup_lossy, teardown));
+
+	ztest_run_test_suite(lib_download_client_coap_test);
+}
+
+#define TEST_SOCKET_PRIO 40
+NET_SOCKET_REGISTER(mock_socket, TEST_SOCKET_PRIO, AF_UNSPEC, mock_socket_is_supported,
+		    mock_socket_create);
+NET_DEVICE_OFFLOAD_INIT(mock_socket, "mock_socket", mock_nrf_modem_lib_socket_offload_init, NULL,
+			&mock_socket_iface_data, NULL, 0, &mock_if_api, 1280);
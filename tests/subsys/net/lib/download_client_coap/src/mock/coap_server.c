@@ -0,0 +1,448 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/net/coap.h>
+#include <zephyr/net/socket_offload.h>
+#include <sockets_internal.h>
+#include <ztest.h>
+
+#include "mock/coap_server.h"
+
+void mock_socket_iface_init(struct net_if *iface);
+
+struct mock_socket_iface_data {
+	struct net_if *iface;
+} mock_socket_iface_data;
+
+struct net_if_api mock_if_api = {
+	.init = mock_socket_iface_init,
+};
+
+/* Sockets behave like UDP sockets exchanging datagrams with a CoAP server
+ * over a link with a fixed round-trip time and random loss.
+ * Time is the kernel uptime.
+ */
+
+#define MOCK_CONN_COUNT 2
+#define MOCK_DGRAM_COUNT 16
+#define MOCK_DGRAM_SIZE 600
+#define MOCK_FRAME_SIZE 128
+#define MOCK_SZX_MAX COAP_BLOCK_512
+
+struct mock_dgram {
+	uint8_t buf[MOCK_DGRAM_SIZE];
+	size_t len;
+	/* Uptime at which the datagram is received */
+	int64_t ready;
+};
+
+struct mock_conn {
+	bool used;
+	struct mock_dgram dgram[MOCK_DGRAM_COUNT];
+	size_t dgram_head;
+	size_t dgram_count;
+	/* Receive timeout, in milliseconds */
+	int64_t rcvtimeo;
+};
+
+static struct {
+	size_t file_size;
+	uint32_t rtt_ms;
+	uint32_t loss_permille;
+	uint32_t rand;
+	size_t req_count;
+	size_t loss_count;
+	struct mock_conn conn[MOCK_CONN_COUNT];
+} server;
+
+void mock_coap_server_init(size_t file_size, uint32_t rtt_ms, uint32_t loss_permille)
+{
+	server.file_size = file_size;
+	server.rtt_ms = rtt_ms;
+	server.loss_permille = loss_permille;
+	server.rand = 0x2545f491;
+	server.req_count = 0;
+	server.loss_count = 0;
+}
+
+uint8_t mock_coap_server_file_byte(size_t pos)
+{
+	return (uint8_t)(pos * 31 + (pos >> 8));
+}
+
+size_t mock_coap_server_request_count(void)
+{
+	return server.req_count;
+}
+
+size_t mock_coap_server_loss_count(void)
+{
+	return server.loss_count;
+}
+
+static struct mock_conn *conn_get(void *obj)
+{
+	return ((struct net_context *)obj)->user_data;
+}
+
+/* Reproducible pseudo-random numbers (xorshift32) */
+static uint32_t rand_get(void)
+{
+	server.rand ^= server.rand << 13;
+	server.rand ^= server.rand >> 17;
+	server.rand ^= server.rand << 5;
+
+	return server.rand;
+}
+
+/* A datagram is lost if any of its radio frames is lost */
+static bool dgram_lost(size_t len)
+{
+	for (size_t i = 0; i < DIV_ROUND_UP(len, MOCK_FRAME_SIZE); i++) {
+		if (rand_get() % 1000 < server.loss_permille) {
+			server.loss_count++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static int response_build(struct coap_packet *response, uint8_t *buf, size_t size,
+			  const uint8_t *req, size_t len)
+{
+	static uint8_t payload[1 << (MOCK_SZX_MAX + 4)];
+	struct coap_packet request;
+	uint8_t token[COAP_TOKEN_MAX_LEN];
+	uint8_t tkl;
+	int block2;
+	uint8_t szx;
+	size_t offset;
+	size_t end;
+	int err;
+
+	err = coap_packet_parse(&request, (uint8_t *)req, len, NULL, 0);
+	if (err) {
+		return err;
+	}
+
+	block2 = coap_get_option_int(&request, COAP_OPTION_BLOCK2);
+	if (block2 < 0) {
+		block2 = MOCK_SZX_MAX;
+	}
+
+	/* The server may use smaller blocks than requested */
+	offset = GET_BLOCK_NUM(block2) * coap_block_size_to_bytes(GET_BLOCK_SIZE(block2));
+	szx = MIN(GET_BLOCK_SIZE(block2), MOCK_SZX_MAX);
+	end = MIN(offset + coap_block_size_to_bytes(szx), server.file_size);
+
+	if (offset >= server.file_size) {
+		return -EINVAL;
+	}
+
+	tkl = coap_header_get_token(&request, token);
+
+	err = coap_packet_init(response, buf, size, 1, COAP_TYPE_ACK, tkl, token,
+			       COAP_RESPONSE_CODE_CONTENT, coap_header_get_id(&request));
+	if (err) {
+		return err;
+	}
+
+	err = coap_append_option_int(response, COAP_OPTION_BLOCK2,
+				     ((offset / coap_block_size_to_bytes(szx)) << 4) |
+				     ((end < server.file_size) ? 0x08 : 0) | szx);
+	if (err) {
+		return err;
+	}
+
+	if (coap_get_option_int(&request, COAP_OPTION_SIZE2) >= 0) {
+		err = coap_append_option_int(response, COAP_OPTION_SIZE2, server.file_size);
+		if (err) {
+			return err;
+		}
+	}
+
+	for (size_t i = offset; i < end; i++) {
+		payload[i - offset] = mock_coap_server_file_byte(i);
+	}
+
+	err = coap_packet_append_payload_marker(response);
+	if (err) {
+		return err;
+	}
+
+	return coap_packet_append_payload(response, payload, end - offset);
+}
+
+static ssize_t mock_socket_offload_sendto(void *obj, const void *buf, size_t len, int flags,
+					  const struct sockaddr *to, socklen_t tolen)
+{
+	struct mock_conn *conn = conn_get(obj);
+	struct coap_packet response;
+	struct mock_dgram *dgram;
+	int err;
+
+	if (dgram_lost(len)) {
+		return len;
+	}
+
+	server.req_count++;
+
+	if (conn->dgram_count == MOCK_DGRAM_COUNT) {
+		/* Receive buffer full, the response is dropped */
+		return len;
+	}
+
+	dgram = &conn->dgram[(conn->dgram_head + conn->dgram_count) % MOCK_DGRAM_COUNT];
+
+	err = response_build(&response, dgram->buf, sizeof(dgram->buf), buf, len);
+	zassert_ok(err, "Invalid request");
+
+	if (dgram_lost(response.offset)) {
+		return len;
+	}
+
+	dgram->len = response.offset;
+	dgram->ready = k_uptime_get() + server.rtt_ms;
+	conn->dgram_count++;
+
+	return len;
+}
+
+static ssize_t mock_socket_offload_write(void *obj, const void *buffer, size_t count)
+{
+	return mock_socket_offload_sendto(obj, buffer, count, 0, NULL, 0);
+}
+
+static ssize_t mock_socket_offload_recvfrom(void *obj, void *buf, size_t len, int flags,
+					    struct sockaddr *from, socklen_t *fromlen)
+{
+	struct mock_conn *conn = conn_get(obj);
+	struct mock_dgram *dgram = &conn->dgram[conn->dgram_head];
+	int64_t deadline = k_uptime_get() + conn->rcvtimeo;
+
+	if (conn->dgram_count == 0 || dgram->ready > deadline) {
+		/* Nothing received before the timeout */
+		k_sleep(K_MSEC(conn->rcvtimeo));
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (dgram->ready > k_uptime_get()) {
+		k_sleep(K_MSEC(dgram->ready - k_uptime_get()));
+	}
+
+	len = MIN(len, dgram->len);
+	memcpy(buf, dgram->buf, len);
+
+	conn->dgram_head = (conn->dgram_head + 1) % MOCK_DGRAM_COUNT;
+	conn->dgram_count--;
+
+	return len;
+}
+
+static ssize_t mock_socket_offload_read(void *obj, void *buffer, size_t count)
+{
+	return mock_socket_offload_recvfrom(obj, buffer, count, 0, NULL, 0);
+}
+
+static int mock_socket_offload_close(void *obj)
+{
+	struct mock_conn *conn = conn_get(obj);
+
+	memset(conn, 0, sizeof(*conn));
+
+	return zsock_close_ctx(obj);
+}
+
+static int mock_socket_offload_ioctl(void *obj, unsigned int request, va_list args)
+{
+	switch (request) {
+	case ZFD_IOCTL_POLL_PREPARE:
+		return -EXDEV;
+
+	case ZFD_IOCTL_POLL_UPDATE:
+		return -EOPNOTSUPP;
+
+	case ZFD_IOCTL_POLL_OFFLOAD: {
+		return 0;
+	}
+
+	case ZFD_IOCTL_SET_LOCK: {
+		return 0;
+	}
+
+	default:
+		return 0;
+	}
+
+	return 0;
+}
+
+static int mock_socket_offload_connect(void *obj, const struct sockaddr *addr, socklen_t addrlen)
+{
+	return 0;
+}
+
+static int mock_socket_offload_setsockopt(void *obj, int level, int optname, const void *optval,
+					  socklen_t optlen)
+{
+	const struct timeval *time = optval;
+
+	if ((level == SOL_SOCKET) && (optname == SO_RCVTIMEO)) {
+		conn_get(obj)->rcvtimeo = time->tv_sec * MSEC_PER_SEC +
+					  time->tv_usec / USEC_PER_MSEC;
+	}
+
+	return 0;
+}
+
+static int mock_socket_offload_getsockopt(void *obj, int level, int optname, void *optval,
+					  socklen_t *optlen)
+{
+	return 0;
+}
+
+static const struct socket_op_vtable mock_socket_fd_op_vtable = {
+	.fd_vtable = {
+		.read = mock_socket_offload_read,
+		.write = mock_socket_offload_write,
+		.close = mock_socket_offload_close,
+		.ioctl = mock_socket_offload_ioctl,
+	},
+	.connect = mock_socket_offload_connect,
+	.sendto = mock_socket_offload_sendto,
+	.recvfrom = mock_socket_offload_recvfrom,
+	.getsockopt = mock_socket_offload_getsockopt,
+	.setsockopt = mock_socket_offload_setsockopt,
+};
+
+/**
+ * There is no support for dns lookup, node has to be a valid ip address
+ * that is parseable via net_ipaddr_parse
+ */
+static int mock_socket_offload_getaddrinfo(const char *node, const char *service,
+					   const struct zsock_addrinfo *hints,
+					   struct zsock_addrinfo **res)
+{
+	struct sockaddr_in *ai_addr;
+	struct zsock_addrinfo *ai;
+
+	if (!node || !res) {
+		return -1;
+	}
+
+	if (hints && hints->ai_family != AF_INET) {
+		return -1;
+	}
+
+	*res = calloc(1, sizeof(struct zsock_addrinfo));
+	ai = *res;
+	if (!ai) {
+		return -1;
+	}
+
+	ai_addr = calloc(1, sizeof(*ai_addr));
+	if (!ai_addr) {
+		free(*res);
+		return -1;
+	}
+
+	ai->ai_family = AF_INET;
+	ai->ai_socktype = SOCK_DGRAM;
+	ai->ai_protocol = IPPROTO_UDP;
+
+	ai_addr->sin_family = ai->ai_family;
+
+	if (!net_ipaddr_parse(node, strlen(node), (struct sockaddr *)ai_addr)) {
+		free(ai_addr);
+		free(*res);
+		return -1;
+	}
+
+	ai->ai_addrlen = sizeof(*ai_addr);
+	ai->ai_addr = (struct sockaddr *)ai_addr;
+
+	return 0;
+}
+
+static void mock_socket_offload_freeaddrinfo(struct zsock_addrinfo *res)
+{
+	__ASSERT_NO_MSG(res);
+
+	free(res->ai_addr);
+	free(res);
+}
+
+bool mock_socket_is_supported(int family, int type, int proto)
+{
+	return true;
+}
+
+int mock_socket_create(int family, int type, int proto)
+{
+	int fd = z_reserve_fd();
+	struct mock_conn *conn = NULL;
+	struct net_context *ctx;
+	int res;
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(server.conn); i++) {
+		if (!server.conn[i].used) {
+			conn = &server.conn[i];
+			break;
+		}
+	}
+
+	if (!conn) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	res = net_context_get(family, type, IPPROTO_UDP, &ctx);
+	if (res < 0) {
+		z_free_fd(fd);
+		errno = -res;
+		return -1;
+	}
+
+	memset(conn, 0, sizeof(*conn));
+	conn->used = true;
+
+	ctx->user_data = conn;
+	ctx->socket_data = NULL;
+
+	k_fifo_init(&ctx->recv_q);
+	k_condvar_init(&ctx->cond.recv);
+
+	z_finalize_fd(fd, ctx, (const struct fd_op_vtable *)&mock_socket_fd_op_vtable);
+
+	return fd;
+}
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg)
+{
+	return 0;
+}
+
+static const struct socket_dns_offload mock_socket_dns_offload_ops = {
+	.getaddrinfo = mock_socket_offload_getaddrinfo,
+	.freeaddrinfo = mock_socket_offload_freeaddrinfo,
+};
+
+void mock_socket_iface_init(struct net_if *iface)
+{
+	mock_socket_iface_data.iface = iface;
+
+	iface->if_dev->socket_offload = mock_socket_create;
+
+	socket_offload_dns_register(&mock_socket_dns_offload_ops);
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#ifndef _COAP_SERVER_H_
+#define _COAP_SERVER_H_
+
+#include <zephyr/kernel.h>
+
+extern struct mock_socket_iface_data mock_socket_iface_data;
+extern struct net_if_api mock_if_api;
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg);
+bool mock_socket_is_supported(int family, int type, int proto);
+int mock_socket_create(int family, int type, int proto);
+
+/**
+ * Serve a file of @p file_size bytes with CoAP block-wise transfer over
+ * the mock sockets. Responses are received @p rtt_ms after the request has
+ * been sent. Datagrams are sent in radio frames of 128 bytes, each of which
+ * is lost with a probability of @p loss_permille / 1000.
+ */
+void mock_coap_server_init(size_t file_size, uint32_t rtt_ms, uint32_t loss_permille);
+
+/** Content of the file served at position @p pos. */
+uint8_t mock_coap_server_file_byte(size_t pos);
+
+/** Number of requests received by the server. */
+size_t mock_coap_server_request_count(void);
+
+/** Number of datagrams lost in either direction. */
+size_t mock_coap_server_loss_count(void);
+
+#endif /* _COAP_SERVER_H_ */
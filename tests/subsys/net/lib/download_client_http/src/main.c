@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/socket_offload.h>
+
+#include <ztest.h>
+#include <download_client.h>
+
+#include "mock/http_server.h"
+
+#define HOST "http://10.1.0.10"
+#define FILE_SIZE (20 * 1024)
+#define RTT_MS 200
+
+#define FRAG_SIZE CONFIG_DOWNLOAD_CLIENT_HTTP_FRAG_SIZE
+#define PIPELINE_DEPTH CONFIG_DOWNLOAD_CLIENT_HTTP_PIPELINE_DEPTH
+#define CONNECTIONS CONFIG_DOWNLOAD_CLIENT_HTTP_CONNECTIONS
+
+static struct download_client client;
+static K_SEM_DEFINE(download_done, 0, 1);
+
+static struct {
+	size_t pos;
+	size_t bytes;
+	size_t errors;
+	bool mismatch;
+} received;
+
+static int download_client_callback(const struct download_client_evt *event)
+{
+	const uint8_t *buf;
+
+	switch (event->id) {
+	case DOWNLOAD_CLIENT_EVT_FRAGMENT:
+		/* Fragments must be in order, whatever connection they came from */
+		buf = event->fragment.buf;
+		for (size_t i = 0; i < event->fragment.len; i++) {
+			if (buf[i] != mock_http_server_file_byte(received.pos + i)) {
+				received.mismatch = true;
+				break;
+			}
+		}
+
+		received.pos += event->fragment.len;
+		received.bytes += event->fragment.len;
+		break;
+	case DOWNLOAD_CLIENT_EVT_ERROR:
+		/* Reconnect and resume */
+		received.errors++;
+		break;
+	case DOWNLOAD_CLIENT_EVT_DONE:
+		k_sem_give(&download_done);
+		break;
+	}
+
+	return 0;
+}
+
+static struct download_client_cfg config = {
+	.sec_tag = -1,
+	.pdn_id = 0,
+	.frag_size_override = 0,
+};
+
+/* Returns the download time in milliseconds */
+static int64_t download(size_t from)
+{
+	int64_t start;
+	int err;
+
+	memset(&received, 0, sizeof(received));
+	received.pos = from;
+
+	start = k_uptime_get();
+
+	err = download_client_connect(&client, HOST, &config);
+	zassert_ok(err, NULL);
+
+	err = download_client_start(&client, "file.bin", from);
+	zassert_ok(err, NULL);
+
+	err = k_sem_take(&download_done, K_SECONDS(60));
+	zassert_ok(err, "Download did not complete");
+
+	zassert_false(received.mismatch, "Fragments out of order or corrupted");
+	zassert_equal(received.pos, FILE_SIZE, NULL);
+	zassert_equal(received.bytes, FILE_SIZE - from, NULL);
+
+	return k_uptime_get() - start;
+}
+
+/* Round trips to download the file: one per connection to connect,
+ * one for the first range, which gives the file size, then one for
+ * every PIPELINE_DEPTH ranges requested on each connection.
+ */
+static size_t round_trips_expected(size_t from)
+{
+	size_t frags = DIV_ROUND_UP(FILE_SIZE - from, FRAG_SIZE);
+
+	return CONNECTIONS + 1 + DIV_ROUND_UP(frags - 1, PIPELINE_DEPTH * CONNECTIONS);
+}
+
+static void setup(void)
+{
+	mock_http_server_init(FILE_SIZE, RTT_MS);
+}
+
+static void teardown(void)
+{
+	download_client_disconnect(&client);
+
+	/* Let the download thread suspend itself */
+	k_sleep(K_MSEC(100));
+}
+
+static void test_download_throughput(void)
+{
+	size_t frags = DIV_ROUND_UP(FILE_SIZE, FRAG_SIZE);
+	int64_t sequential = (1 + frags) * RTT_MS;
+	int64_t elapsed;
+
+	elapsed = download(0);
+
+	printk("Depth %d, %d connection(s), RTT %d ms: %u bytes in %u ms, "
+	       "%u B/s, %u.%02ux sequential\n",
+	       PIPELINE_DEPTH, CONNECTIONS, RTT_MS, FILE_SIZE, (uint32_t)elapsed,
+	       (uint32_t)((FILE_SIZE * 1000LL) / elapsed),
+	       (uint32_t)(sequential / elapsed),
+	       (uint32_t)(((sequential * 100) / elapsed) % 100));
+
+	zassert_true(elapsed <= (round_trips_expected(0) + 1) * RTT_MS,
+		     "Download took %u ms, expected %u round trips",
+		     (uint32_t)elapsed, (uint32_t)round_trips_expected(0));
+
+	zassert_true(mock_http_server_request_count() >= frags, NULL);
+
+	if (PIPELINE_DEPTH * CONNECTIONS > 1) {
+		zassert_true(elapsed < sequential, "No speed-up");
+	}
+}
+
+static void test_download_from_offset(void)
+{
+	download(FILE_SIZE / 3);
+}
+
+static void test_download_resume_on_reset(void)
+{
+	/* Reset the connection in the middle of the third fragment,
+	 * while responses to pipelined requests are outstanding.
+	 */
+	mock_http_server_abort_at(3);
+
+	download(0);
+
+	zassert_equal(received.errors, 1, NULL);
+}
+
+void test_main(void)
+{
+	int err;
+
+	err = download_client_init(&client, download_client_callback);
+	zassert_ok(err, NULL);
+
+	ztest_test_suite(lib_download_client_http_test,
+			 ztest_unit_test_setup_teardown(test_download_throughput,
+							setup, teardown),
+			 ztest_unit_test_setup_teardown(test_download_from_offset,
+							setup, teardown),
+			 ztest_unit_test_setup_teardown(test_download_resume_on_reset,
+							setup, teardown));
+
+	ztest_run_test_suite(lib_download_client_http_test);
+}
+
+#define TEST_SOCKET_PRIO 40
+NET_SOCKET_REGISTER(mock_socket, TEST_SOCKET_PRIO, AF_UNSPEC, mock_socket_is_supported,
+		    mock_socket_create);
+NET_DEVICE_OFFLOAD_INIT(mock_socket, "mock_socket", mock_nrf_modem_lib_socket_offload_init, NULL,
+			&mock_socket_iface_data, NULL, 0, &mock_if_api, 1280);
@@ -0,0 +1,544 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/net/socket_offload.h>
+#include <zephyr/sys/fdtable.h>
+#include <sockets_internal.h>
+#include <ztest.h>
+
+#include "mock/http_server.h"
+
+void mock_socket_iface_init(struct net_if *iface);
+
+struct mock_socket_iface_data {
+	struct net_if *iface;
+} mock_socket_iface_data;
+
+struct net_if_api mock_if_api = {
+	.init = mock_socket_iface_init,
+};
+
+/* Sockets behave like TCP connections to an HTTP server over a link with
+ * a fixed round-trip time and no bandwidth limit. Time is the kernel uptime,
+ * so that the measured download time only depends on the number of
+ * round trips waited for by the download client.
+ */
+
+#define MOCK_CONN_COUNT 8
+#define MOCK_RSP_COUNT 8
+#define MOCK_RECV_TIMEOUT_MS 10000
+
+struct mock_rsp {
+	size_t first;
+	size_t last;
+	/* Uptime at which the response is received */
+	int64_t ready;
+	/* Reset the connection after half of the response */
+	bool abort;
+};
+
+struct mock_conn {
+	bool used;
+	bool closed;
+	char req[256];
+	size_t req_len;
+	struct mock_rsp rsp[MOCK_RSP_COUNT];
+	size_t rsp_head;
+	size_t rsp_count;
+	/* Header of the response at the head of the queue */
+	char hdr[128];
+	size_t hdr_len;
+	/* Bytes of the response at the head of the queue already received */
+	size_t sent;
+};
+
+static struct {
+	size_t file_size;
+	uint32_t rtt_ms;
+	size_t abort_at;
+	size_t rsp_count;
+	size_t req_count;
+	struct mock_conn conn[MOCK_CONN_COUNT];
+} server;
+
+void mock_http_server_init(size_t file_size, uint32_t rtt_ms)
+{
+	server.file_size = file_size;
+	server.rtt_ms = rtt_ms;
+	server.abort_at = 0;
+	server.rsp_count = 0;
+	server.req_count = 0;
+}
+
+uint8_t mock_http_server_file_byte(size_t pos)
+{
+	return (uint8_t)(pos * 31 + (pos >> 8));
+}
+
+void mock_http_server_abort_at(size_t rsp)
+{
+	server.abort_at = rsp;
+}
+
+size_t mock_http_server_request_count(void)
+{
+	return server.req_count;
+}
+
+static struct mock_conn *conn_get(void *obj)
+{
+	return ((struct net_context *)obj)->user_data;
+}
+
+static struct mock_rsp *rsp_head(struct mock_conn *conn)
+{
+	return conn->rsp_count ? &conn->rsp[conn->rsp_head] : NULL;
+}
+
+static size_t rsp_len(const struct mock_conn *conn, const struct mock_rsp *rsp)
+{
+	return conn->hdr_len + (rsp->last - rsp->first + 1);
+}
+
+static void rsp_hdr_set(struct mock_conn *conn)
+{
+	struct mock_rsp *rsp = rsp_head(conn);
+
+	conn->sent = 0;
+	conn->hdr_len = 0;
+
+	if (!rsp) {
+		return;
+	}
+
+	conn->hdr_len = snprintf(conn->hdr, sizeof(conn->hdr),
+				 "HTTP/1.1 206 Partial Content\r\n"
+				 "Content-Range: bytes %u-%u/%u\r\n"
+				 "Content-Length: %u\r\n"
+				 "\r\n",
+				 (unsigned int)rsp->first, (unsigned int)rsp->last,
+				 (unsigned int)server.file_size,
+				 (unsigned int)(rsp->last - rsp->first + 1));
+}
+
+static int rsp_add(struct mock_conn *conn, size_t first, size_t last)
+{
+	struct mock_rsp *rsp;
+	int64_t ready = k_uptime_get() + server.rtt_ms;
+
+	if (conn->rsp_count == MOCK_RSP_COUNT) {
+		return -ENOBUFS;
+	}
+
+	if (conn->rsp_count) {
+		/* Responses are received in order */
+		rsp = &conn->rsp[(conn->rsp_head + conn->rsp_count - 1) % MOCK_RSP_COUNT];
+		ready = MAX(ready, rsp->ready);
+	}
+
+	rsp = &conn->rsp[(conn->rsp_head + conn->rsp_count) % MOCK_RSP_COUNT];
+	rsp->first = first;
+	rsp->last = MIN(last, server.file_size - 1);
+	rsp->ready = ready;
+	rsp->abort = (++server.rsp_count == server.abort_at);
+
+	if (conn->rsp_count++ == 0) {
+		rsp_hdr_set(conn);
+	}
+
+	return 0;
+}
+
+static void rsp_remove(struct mock_conn *conn)
+{
+	conn->rsp_head = (conn->rsp_head + 1) % MOCK_RSP_COUNT;
+	conn->rsp_count--;
+	rsp_hdr_set(conn);
+}
+
+/* Uptime at which data can be received, INT64_MAX if no data is expected */
+static int64_t conn_ready_get(struct mock_conn *conn)
+{
+	struct mock_rsp *rsp = rsp_head(conn);
+
+	if (conn->closed) {
+		return 0;
+	}
+
+	return rsp ? rsp->ready : INT64_MAX;
+}
+
+static int request_parse(struct mock_conn *conn)
+{
+	char *end;
+	char *p;
+	size_t first;
+	size_t last;
+	int err;
+
+	while ((end = strstr(conn->req, "\r\n\r\n"))) {
+		end += strlen("\r\n\r\n");
+
+		p = strstr(conn->req, "Range: bytes=");
+		if (!p || p > end) {
+			return -EBADMSG;
+		}
+
+		p += strlen("Range: bytes=");
+		first = strtoul(p, &p, 10);
+		last = (*p == '-' && p[1] != '\r') ? strtoul(p + 1, NULL, 10) :
+						     server.file_size - 1;
+
+		err = rsp_add(conn, first, last);
+		if (err) {
+			return err;
+		}
+
+		server.req_count++;
+
+		conn->req_len -= end - conn->req;
+		memmove(conn->req, end, conn->req_len + 1);
+	}
+
+	return 0;
+}
+
+static ssize_t mock_socket_offload_recvfrom(void *obj, void *buf, size_t len, int flags,
+					    struct sockaddr *from, socklen_t *fromlen)
+{
+	struct mock_conn *conn = conn_get(obj);
+	struct mock_rsp *rsp;
+	uint8_t *out = buf;
+	size_t copied = 0;
+	int64_t ready;
+
+	ready = conn_ready_get(conn);
+	if (ready == INT64_MAX) {
+		k_sleep(K_MSEC(MOCK_RECV_TIMEOUT_MS));
+		errno = EAGAIN;
+		return -1;
+	}
+
+	if (ready > k_uptime_get()) {
+		k_sleep(K_MSEC(ready - k_uptime_get()));
+	}
+
+	/* Receive all the responses which have arrived, like a TCP stream */
+	while (copied < len && !conn->closed) {
+		rsp = rsp_head(conn);
+		if (!rsp || rsp->ready > k_uptime_get()) {
+			break;
+		}
+
+		if (rsp->abort && conn->sent >= rsp_len(conn, rsp) / 2) {
+			conn->closed = true;
+			break;
+		}
+
+		if (conn->sent < conn->hdr_len) {
+			out[copied] = conn->hdr[conn->sent];
+		} else {
+			out[copied] = mock_http_server_file_byte(rsp->first + conn->sent -
+								 conn->hdr_len);
+		}
+
+		copied++;
+		conn->sent++;
+
+		if (conn->sent == rsp_len(conn, rsp)) {
+			rsp_remove(conn);
+		}
+	}
+
+	return copied;
+}
+
+static ssize_t mock_socket_offload_read(void *obj, void *buffer, size_t count)
+{
+	return mock_socket_offload_recvfrom(obj, buffer, count, 0, NULL, 0);
+}
+
+static ssize_t mock_socket_offload_sendto(void *obj, const void *buf, size_t len, int flags,
+					  const struct sockaddr *to, socklen_t tolen)
+{
+	struct mock_conn *conn = conn_get(obj);
+	int err;
+
+	if (conn->closed) {
+		errno = ECONNRESET;
+		return -1;
+	}
+
+	if (len >= sizeof(conn->req) - conn->req_len) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	memcpy(conn->req + conn->req_len, buf, len);
+	conn->req_len += len;
+	conn->req[conn->req_len] = '\0';
+
+	err = request_parse(conn);
+	if (err) {
+		errno = -err;
+		return -1;
+	}
+
+	return len;
+}
+
+static ssize_t mock_socket_offload_write(void *obj, const void *buffer, size_t count)
+{
+	return mock_socket_offload_sendto(obj, buffer, count, 0, NULL, 0);
+}
+
+static int mock_socket_offload_close(void *obj)
+{
+	struct mock_conn *conn = conn_get(obj);
+
+	memset(conn, 0, sizeof(*conn));
+
+	return zsock_close_ctx(obj);
+}
+
+static int mock_socket_offload_poll(struct zsock_pollfd *fds, int nfds, int timeout)
+{
+	int64_t deadline = (timeout < 0) ? INT64_MAX : k_uptime_get() + timeout;
+	int64_t next;
+	int64_t ready;
+	int count;
+
+	while (true) {
+		next = deadline;
+		count = 0;
+
+		for (int i = 0; i < nfds; i++) {
+			void *obj = z_get_fd_obj(fds[i].fd, NULL, 0);
+
+			fds[i].revents = 0;
+
+			if (!obj) {
+				fds[i].revents = ZSOCK_POLLNVAL;
+				count++;
+				continue;
+			}
+
+			ready = conn_ready_get(conn_get(obj));
+			if (ready <= k_uptime_get()) {
+				fds[i].revents = ZSOCK_POLLIN;
+				count++;
+			} else {
+				next = MIN(next, ready);
+			}
+		}
+
+		if (count || k_uptime_get() >= deadline) {
+			return count;
+		}
+
+		if (next == INT64_MAX) {
+			/* Nothing expected and no timeout */
+			return -EAGAIN;
+		}
+
+		k_sleep(K_MSEC(next - k_uptime_get()));
+	}
+}
+
+static int mock_socket_offload_ioctl(void *obj, unsigned int request, va_list args)
+{
+	switch (request) {
+	case ZFD_IOCTL_POLL_PREPARE:
+		return -EXDEV;
+
+	case ZFD_IOCTL_POLL_UPDATE:
+		return -EOPNOTSUPP;
+
+	case ZFD_IOCTL_POLL_OFFLOAD: {
+		struct zsock_pollfd *fds;
+		int nfds;
+		int timeout;
+
+		fds = va_arg(args, struct zsock_pollfd *);
+		nfds = va_arg(args, int);
+		timeout = va_arg(args, int);
+
+		return mock_socket_offload_poll(fds, nfds, timeout);
+	}
+
+	case ZFD_IOCTL_SET_LOCK: {
+		return 0;
+	}
+
+	default:
+		return 0;
+	}
+
+	return 0;
+}
+
+static int mock_socket_offload_connect(void *obj, const struct sockaddr *addr, socklen_t addrlen)
+{
+	/* TCP handshake */
+	k_sleep(K_MSEC(server.rtt_ms));
+	return 0;
+}
+
+static int mock_socket_offload_setsockopt(void *obj, int level, int optname, const void *optval,
+					  socklen_t optlen)
+{
+	return 0;
+}
+
+static int mock_socket_offload_getsockopt(void *obj, int level, int optname, void *optval,
+					  socklen_t *optlen)
+{
+	return 0;
+}
+
+static const struct socket_op_vtable mock_socket_fd_op_vtable = {
+	.fd_vtable = {
+		.read = mock_socket_offload_read,
+		.write = mock_socket_offload_write,
+		.close = mock_socket_offload_close,
+		.ioctl = mock_socket_offload_ioctl,
+	},
+	.connect = mock_socket_offload_connect,
+	.sendto = mock_socket_offload_sendto,
+	.recvfrom = mock_socket_offload_recvfrom,
+	.getsockopt = mock_socket_offload_getsockopt,
+	.setsockopt = mock_socket_offload_setsockopt,
+};
+
+/**
+ * There is no support for dns lookup, node has to be a valid ip address
+ * that is parseable via net_ipaddr_parse
+ */
+static int mock_socket_offload_getaddrinfo(const char *node, const char *service,
+					   const struct zsock_addrinfo *hints,
+					   struct zsock_addrinfo **res)
+{
+	struct sockaddr_in *ai_addr;
+	struct zsock_addrinfo *ai;
+
+	if (!node || !res) {
+		return -1;
+	}
+
+	if (hints && hints->ai_family != AF_INET) {
+		return -1;
+	}
+
+	*res = calloc(1, sizeof(struct zsock_addrinfo));
+	ai = *res;
+	if (!ai) {
+		return -1;
+	}
+
+	ai_addr = calloc(1, sizeof(*ai_addr));
+	if (!ai_addr) {
+		free(*res);
+		return -1;
+	}
+
+	ai->ai_family = AF_INET;
+	ai->ai_socktype = SOCK_STREAM;
+	ai->ai_protocol = IPPROTO_TCP;
+
+	ai_addr->sin_family = ai->ai_family;
+
+	if (!net_ipaddr_parse(node, strlen(node), (struct sockaddr *)ai_addr)) {
+		free(ai_addr);
+		free(*res);
+		return -1;
+	}
+
+	ai->ai_addrlen = sizeof(*ai_addr);
+	ai->ai_addr = (struct sockaddr *)ai_addr;
+
+	return 0;
+}
+
+static void mock_socket_offload_freeaddrinfo(struct zsock_addrinfo *res)
+{
+	__ASSERT_NO_MSG(res);
+
+	free(res->ai_addr);
+	free(res);
+}
+
+bool mock_socket_is_supported(int family, int type, int proto)
+{
+	return true;
+}
+
+int mock_socket_create(int family, int type, int proto)
+{
+	int fd = z_reserve_fd();
+	struct mock_conn *conn = NULL;
+	struct net_context *ctx;
+	int res;
+
+	if (fd < 0) {
+		return -1;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(server.conn); i++) {
+		if (!server.conn[i].used) {
+			conn = &server.conn[i];
+			break;
+		}
+	}
+
+	if (!conn) {
+		z_free_fd(fd);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	res = net_context_get(family, type, IPPROTO_TCP, &ctx);
+	if (res < 0) {
+		z_free_fd(fd);
+		errno = -res;
+		return -1;
+	}
+
+	memset(conn, 0, sizeof(*conn));
+	conn->used = true;
+
+	ctx->user_data = conn;
+	ctx->socket_data = NULL;
+
+	k_fifo_init(&ctx->recv_q);
+	k_condvar_init(&ctx->cond.recv);
+
+	net_context_ref(ctx);
+
+	z_finalize_fd(fd, ctx, (const struct fd_op_vtable *)&mock_socket_fd_op_vtable);
+
+	return fd;
+}
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg)
+{
+	return 0;
+}
+
+static const struct socket_dns_offload mock_socket_dns_offload_ops = {
+	.getaddrinfo = mock_socket_offload_getaddrinfo,
+	.freeaddrinfo = mock_socket_offload_freeaddrinfo,
+};
+
+void mock_socket_iface_init(struct net_if *iface)
+{
+	mock_socket_iface_data.iface = iface;
+
+	iface->if_dev->socket_offload = mock_socket_create;
+
+	socket_offload_dns_register(&mock_socket_dns_offload_ops);
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#ifndef _HTTP_SERVER_H_
+#define _HTTP_SERVER_H_
+
+#include <zephyr/kernel.h>
+
+extern struct mock_socket_iface_data mock_socket_iface_data;
+extern struct net_if_api mock_if_api;
+
+int mock_nrf_modem_lib_socket_offload_init(const struct device *arg);
+bool mock_socket_is_supported(int family, int type, int proto);
+int mock_socket_create(int family, int type, int proto);
+
+/**
+ * Serve a file of @p file_size bytes over the mock sockets.
+ * Responses to HTTP range requests are received @p rtt_ms after
+ * the request has been sent, in the order of the requests.
+ */
+void mock_http_server_init(size_t file_size, uint32_t rtt_ms);
+
+/** Content of the file served at position @p pos. */
+uint8_t mock_http_server_file_byte(size_t pos);
+
+/** Reset the connection in the middle of response number @p rsp (from 1). */
+void mock_http_server_abort_at(size_t rsp);
+
+/** Number of requests received by the server. */
+size_t mock_http_server_request_count(void);
+
+#endif /* _HTTP_SERVER_H_ */
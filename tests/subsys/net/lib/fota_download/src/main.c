@@ -113,6 +113,11 @@ int download_client_file_size_get(struct download_client *client, size_t *size)
 	return 0;
 }
 
+bool download_client_is_connected(const struct download_client *client)
+{
+	return true;
+}
+
 int download_client_init(struct download_client *client,
 			 download_client_callback_t callback)
 {
@@ -0,0 +1,367 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <ztest.h>
+#include <string.h>
+
+#include "nrf_cloud_codec.h"
+#include "nrf_cloud_cbor.h"
+#include "nrf_cloud_json_writer.h"
+#include "msg_codec.h"
+
+static uint8_t cbor[512];
+static char json[512];
+static size_t cbor_len;
+
+static struct lte_lc_ncell ncells[] = {
+	{ .earfcn = 6300, .phys_cell_id = 123, .rsrp = 40, .rsrq = 3 },
+	{ .earfcn = 6301, .phys_cell_id = 7, .rsrp = NRF_CLOUD_CELL_POS_OMIT_RSRP, .rsrq = -30 },
+	{ .earfcn = 1650, .phys_cell_id = 503, .rsrp = 97, .rsrq = NRF_CLOUD_CELL_POS_OMIT_RSRQ },
+};
+
+static struct lte_lc_cells_info cells_inf = {
+	.current_cell = {
+		.id = 0x12345678, .mcc = 242, .mnc = 1, .tac = 0x1234,
+		.earfcn = 6400, .rsrp = 50, .rsrq = 20, .timing_advance = 300
+	},
+	.ncells_count = ARRAY_SIZE(ncells),
+	.neighbor_cells = ncells
+};
+
+static void savings_print(const char *name, int json_len)
+{
+	zassert_true(json_len > 0, NULL);
+
+	printk("%s: JSON %d bytes, CBOR %u bytes, %u%% saved\n", name, json_len, cbor_len,
+	       (uint32_t)(100 - (100 * cbor_len) / json_len));
+}
+
+static void setup(void)
+{
+	memset(cbor, 0, sizeof(cbor));
+	cbor_len = 0;
+}
+
+static void test_sensor_round_trip(void)
+{
+	static const char data[] = "23.5";
+	struct nrf_cloud_json_writer w;
+	struct zcbor_string app_id, decoded;
+	int err;
+
+	err = nrf_cloud_cbor_sensor_msg_encode(NRF_CLOUD_JSON_APPID_VAL_TEMP, data, strlen(data),
+					       cbor, sizeof(cbor), &cbor_len);
+	zassert_ok(err, NULL);
+	zassert_true(cbor_len <= nrf_cloud_cbor_sensor_msg_size(NRF_CLOUD_JSON_APPID_VAL_TEMP,
+								  strlen(data)), NULL);
+
+	err = sensor_msg_decode(cbor, cbor_len, &app_id, &decoded);
+	zassert_ok(err, NULL);
+	zassert_equal(app_id.len, strlen(NRF_CLOUD_JSON_APPID_VAL_TEMP), NULL);
+	zassert_mem_equal(app_id.value, NRF_CLOUD_JSON_APPID_VAL_TEMP, app_id.len, NULL);
+	zassert_equal(decoded.len, strlen(data), NULL);
+	zassert_mem_equal(decoded.value, data, decoded.len, NULL);
+
+	nrf_cloud_json_writer_init(&w, json, sizeof(json));
+	nrf_cloud_json_sensor_msg_write(&w, NRF_CLOUD_JSON_APPID_VAL_TEMP, data);
+	savings_print("sensor", nrf_cloud_json_writer_finish(&w));
+}
+
+static void test_sensor_buffer_too_small(void)
+{
+	static const char data[] = "1013.25";
+	size_t size = nrf_cloud_cbor_sensor_msg_size(NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS,
+						     strlen(data));
+	int err;
+
+	err = nrf_cloud_cbor_sensor_msg_encode(NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS, data,
+					       strlen(data), cbor, size, &cbor_len);
+	zassert_ok(err, NULL);
+
+	err = nrf_cloud_cbor_sensor_msg_encode(NRF_CLOUD_JSON_APPID_VAL_AIR_PRESS, data,
+					       strlen(data), cbor, cbor_len - 1, &cbor_len);
+	zassert_equal(err, -ENOMEM, NULL);
+}
+
+static void gnss_round_trip(const char *name, const struct nrf_cloud_gnss_data *gnss)
+{
+	struct nrf_cloud_json_writer w;
+	struct nrf_cloud_gnss_data decoded;
+	struct zcbor_string nmea;
+	int err;
+
+	err = nrf_cloud_gnss_msg_cbor_encode(gnss, cbor, sizeof(cbor), &cbor_len);
+	zassert_ok(err, NULL);
+	zassert_true(cbor_len <= NRF_CLOUD_GNSS_CBOR_MSG_SIZE_MAX, NULL);
+
+	err = gnss_msg_decode(cbor, cbor_len, &decoded, &nmea);
+	zassert_ok(err, NULL);
+	zassert_equal(decoded.type, gnss->type, NULL);
+	zassert_equal(decoded.ts_ms, gnss->ts_ms, NULL);
+
+	if (gnss->type == NRF_CLOUD_GNSS_TYPE_PVT) {
+		zassert_equal(decoded.pvt.lon, gnss->pvt.lon, NULL);
+		zassert_equal(decoded.pvt.lat, gnss->pvt.lat, NULL);
+		zassert_equal(decoded.pvt.accuracy, gnss->pvt.accuracy, NULL);
+		zassert_equal(decoded.pvt.has_alt, gnss->pvt.has_alt, NULL);
+		if (gnss->pvt.has_alt) {
+			zassert_equal(decoded.pvt.alt, gnss->pvt.alt, NULL);
+		}
+		zassert_equal(decoded.pvt.has_speed, gnss->pvt.has_speed, NULL);
+		if (gnss->pvt.has_speed) {
+			zassert_equal(decoded.pvt.speed, gnss->pvt.speed, NULL);
+		}
+		zassert_equal(decoded.pvt.has_heading, gnss->pvt.has_heading, NULL);
+		if (gnss->pvt.has_heading) {
+			zassert_equal(decoded.pvt.heading, gnss->pvt.heading, NULL);
+		}
+	} else {
+		zassert_equal(nmea.len, strlen(gnss->nmea.sentence), NULL);
+		zassert_mem_equal(nmea.value, gnss->nmea.sentence, nmea.len, NULL);
+	}
+
+	nrf_cloud_json_writer_init(&w, json, sizeof(json));
+	zassert_ok(nrf_cloud_json_gnss_msg_write(&w, gnss), NULL);
+	savings_print(name, nrf_cloud_json_writer_finish(&w));
+}
+
+static void test_gnss_round_trip(void)
+{
+	struct nrf_cloud_gnss_data gnss = {
+		.type = NRF_CLOUD_GNSS_TYPE_PVT,
+		.ts_ms = 1657000000123LL,
+		.pvt = {
+			.lon = 10.123456789012345,
+			.lat = -63.4,
+			.accuracy = 12.5f,
+			.alt = 100.25f,
+			.has_alt = 1,
+			.speed = 0.1f,
+			.has_speed = 1,
+			.heading = 359.9f,
+			.has_heading = 1
+		}
+	};
+
+	gnss_round_trip("gnss pvt", &gnss);
+
+	gnss.ts_ms = NRF_CLOUD_NO_TIMESTAMP;
+	gnss.pvt.has_speed = 0;
+	gnss_round_trip("gnss pvt, no timestamp", &gnss);
+
+	gnss.type = NRF_CLOUD_GNSS_TYPE_NMEA;
+	gnss.ts_ms = 0;
+	gnss.nmea.sentence = "$GPGGA,181908.00,3404.7041778,N,07044.3966270,W,4,13,1.00,"
+			     "495.144,M,29.200,M,,*40";
+	gnss_round_trip("gnss nmea", &gnss);
+}
+
+static void test_gnss_invalid(void)
+{
+	struct nrf_cloud_gnss_data gnss = {
+		.type = NRF_CLOUD_GNSS_TYPE_NMEA,
+	};
+	struct zcbor_string nmea;
+	int err;
+
+	err = nrf_cloud_gnss_msg_cbor_encode(&gnss, cbor, sizeof(cbor), &cbor_len);
+	zassert_equal(err, -EINVAL, NULL);
+
+	gnss.type = NRF_CLOUD_GNSS_TYPE_INVALID;
+	err = nrf_cloud_gnss_msg_cbor_encode(&gnss, cbor, sizeof(cbor), &cbor_len);
+	zassert_equal(err, -EFTYPE, NULL);
+
+	/* A sensor message is not a GNSS message */
+	err = nrf_cloud_cbor_sensor_msg_encode("TEMP", "x", 1, cbor, sizeof(cbor), &cbor_len);
+	zassert_ok(err, NULL);
+	err = gnss_msg_decode(cbor, cbor_len, &gnss, &nmea);
+	zassert_equal(err, -EBADMSG, NULL);
+}
+
+static void test_cell_pos_req_round_trip(void)
+{
+	struct nrf_cloud_json_writer w;
+	struct lte_lc_cells_info decoded;
+	struct lte_lc_ncell decoded_ncells[ARRAY_SIZE(ncells)];
+	bool request_loc;
+	int err;
+
+	for (int i = 0; i < 2; i++) {
+		err = nrf_cloud_cbor_cell_pos_req_encode(&cells_inf, i, cbor, sizeof(cbor),
+							 &cbor_len);
+		zassert_ok(err, NULL);
+		zassert_true(cbor_len <= nrf_cloud_cbor_cell_pos_req_size_max(&cells_inf), NULL);
+
+		err = cell_pos_req_decode(cbor, cbor_len, &decoded, decoded_ncells,
+					  ARRAY_SIZE(decoded_ncells), &request_loc);
+		zassert_ok(err, NULL);
+		zassert_equal(request_loc, i, NULL);
+		zassert_mem_equal(&decoded.current_cell, &cells_inf.current_cell,
+				  sizeof(decoded.current_cell), NULL);
+		zassert_equal(decoded.ncells_count, ARRAY_SIZE(ncells), NULL);
+		zassert_mem_equal(decoded_ncells, ncells, sizeof(ncells), NULL);
+	}
+
+	/* Not enough room for the neighbor cells */
+	err = cell_pos_req_decode(cbor, cbor_len, &decoded, decoded_ncells,
+				  ARRAY_SIZE(decoded_ncells) - 1, &request_loc);
+	zassert_equal(err, -EBADMSG, NULL);
+
+	nrf_cloud_json_writer_init(&w, json, sizeof(json));
+	nrf_cloud_json_obj_start(&w, NULL);
+	nrf_cloud_json_str_add(&w, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_CELL_POS);
+	nrf_cloud_json_str_add(&w, NRF_CLOUD_JSON_MSG_TYPE_KEY, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	nrf_cloud_json_obj_start(&w, NRF_CLOUD_JSON_DATA_KEY);
+	nrf_cloud_json_cell_pos_lte_write(&w, &cells_inf, 1);
+	nrf_cloud_json_obj_end(&w);
+	nrf_cloud_json_obj_end(&w);
+	savings_print("cell pos request", nrf_cloud_json_writer_finish(&w));
+}
+
+static void test_cell_pos_req_omit(void)
+{
+	struct lte_lc_cells_info inf = {
+		.current_cell = {
+			.id = 1, .mcc = 310, .mnc = 410, .tac = 3,
+			.earfcn = NRF_CLOUD_CELL_POS_OMIT_EARFCN,
+			.rsrp = NRF_CLOUD_CELL_POS_OMIT_RSRP,
+			.rsrq = NRF_CLOUD_CELL_POS_OMIT_RSRQ,
+			.timing_advance = NRF_CLOUD_CELL_POS_OMIT_TIME_ADV
+		}
+	};
+	struct lte_lc_cells_info decoded;
+	bool request_loc;
+	int err;
+
+	err = nrf_cloud_cbor_cell_pos_req_encode(&inf, true, cbor, sizeof(cbor), &cbor_len);
+	zassert_ok(err, NULL);
+
+	err = cell_pos_req_decode(cbor, cbor_len, &decoded, NULL, 0, &request_loc);
+	zassert_ok(err, NULL);
+	zassert_mem_equal(&decoded.current_cell, &inf.current_cell,
+			  sizeof(decoded.current_cell), NULL);
+	zassert_equal(decoded.ncells_count, 0, NULL);
+
+	/* Timing advance is clamped, as in JSON */
+	inf.current_cell.timing_advance = NRF_CLOUD_CELL_POS_TIME_ADV_MAX + 1;
+	err = nrf_cloud_cbor_cell_pos_req_encode(&inf, true, cbor, sizeof(cbor), &cbor_len);
+	zassert_ok(err, NULL);
+	err = cell_pos_req_decode(cbor, cbor_len, &decoded, NULL, 0, &request_loc);
+	zassert_ok(err, NULL);
+	zassert_equal(decoded.current_cell.timing_advance, NRF_CLOUD_CELL_POS_TIME_ADV_MAX, NULL);
+
+	inf.ncells_count = 1;
+	err = nrf_cloud_cbor_cell_pos_req_encode(&inf, true, cbor, sizeof(cbor), &cbor_len);
+	zassert_equal(err, -EINVAL, NULL);
+}
+
+static void test_cell_pos_resp_round_trip(void)
+{
+	static const char json_resp[] = "{\"appId\":\"CELL_POS\",\"messageType\":\"DATA\","
+					"\"data\":{\"lat\":45.52,\"lon\":-122.68,"
+					"\"uncertainty\":450,\"fulfilledWith\":\"MCELL\"}}";
+	struct nrf_cloud_cell_pos_result result = {
+		.type = CELL_POS_TYPE_MULTI,
+		.lat = 45.52,
+		.lon = -122.68,
+		.unc = 450,
+		.err = NRF_CLOUD_ERROR_NONE
+	};
+	struct nrf_cloud_cell_pos_result decoded;
+	int err;
+
+	err = cell_pos_resp_encode(&result, cbor, sizeof(cbor), &cbor_len);
+	zassert_ok(err, NULL);
+
+	err = nrf_cloud_cbor_cell_pos_resp_decode(cbor, cbor_len, &decoded);
+	zassert_equal(err, 0, NULL);
+	zassert_equal(decoded.type, result.type, NULL);
+	zassert_equal(decoded.lat, result.lat, NULL);
+	zassert_equal(decoded.lon, result.lon, NULL);
+	zassert_equal(decoded.unc, result.unc, NULL);
+	zassert_equal(decoded.err, NRF_CLOUD_ERROR_NONE, NULL);
+
+	savings_print("cell pos response", strlen(json_resp));
+}
+
+static void test_cell_pos_resp_error(void)
+{
+	struct nrf_cloud_cell_pos_result result = {
+		.err = NRF_CLOUD_ERROR_DATA_NOT_FOUND
+	};
+	struct nrf_cloud_cell_pos_result decoded;
+	int err;
+
+	err = cell_pos_resp_encode(&result, cbor, sizeof(cbor), &cbor_len);
+	zassert_ok(err, NULL);
+
+	err = nrf_cloud_cbor_cell_pos_resp_decode(cbor, cbor_len, &decoded);
+	zassert_equal(err, -EFAULT, NULL);
+	zassert_equal(decoded.err, NRF_CLOUD_ERROR_DATA_NOT_FOUND, NULL);
+	zassert_equal(decoded.type, CELL_POS_TYPE__INVALID, NULL);
+}
+
+static void test_cell_pos_resp_other(void)
+{
+	/* Same response, with indefinite-length maps */
+	static const uint8_t indefinite[] = {
+		0xbf, 0x01, 0x68, 'C', 'E', 'L', 'L', '_', 'P', 'O', 'S',
+		0x02, 0x64, 'D', 'A', 'T', 'A',
+		0x04, 0xbf,
+		0x01, 0xfb, 0x40, 0x46, 0xc2, 0x8f, 0x5c, 0x28, 0xf5, 0xc3,
+		0x02, 0xfb, 0xc0, 0x5e, 0xab, 0x85, 0x1e, 0xb8, 0x51, 0xec,
+		0x03, 0x19, 0x01, 0xc2,
+		0xff, 0xff
+	};
+	struct nrf_cloud_cell_pos_result decoded;
+	int err;
+
+	err = nrf_cloud_cbor_cell_pos_resp_decode(indefinite, sizeof(indefinite), &decoded);
+	zassert_equal(err, 0, NULL);
+	zassert_equal(decoded.lat, 45.52, NULL);
+	zassert_equal(decoded.lon, -122.68, NULL);
+	zassert_equal(decoded.unc, 450, NULL);
+
+	/* Truncated */
+	err = nrf_cloud_cbor_cell_pos_resp_decode(indefinite, sizeof(indefinite) - 1, &decoded);
+	zassert_true(err < 0, NULL);
+
+	/* Other messages are left to the application */
+	err = nrf_cloud_cbor_sensor_msg_encode(NRF_CLOUD_JSON_APPID_VAL_TEMP, "1", 1,
+					       cbor, sizeof(cbor), &cbor_len);
+	zassert_ok(err, NULL);
+	err = nrf_cloud_cbor_cell_pos_resp_decode(cbor, cbor_len, &decoded);
+	zassert_equal(err, 1, NULL);
+
+	err = nrf_cloud_cbor_cell_pos_resp_decode((const uint8_t *)"{\"a\":1}", 7, &decoded);
+	zassert_equal(err, 1, NULL);
+}
+
+void test_main(void)
+{
+	ztest_test_suite(lib_nrf_cloud_cbor_test,
+			 ztest_unit_test_setup_teardown(test_sensor_round_trip, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_sensor_buffer_too_small, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_gnss_round_trip, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_gnss_invalid, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_cell_pos_req_round_trip, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_cell_pos_req_omit, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_cell_pos_resp_round_trip, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_cell_pos_resp_error, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_cell_pos_resp_other, setup,
+							unit_test_noop));
+
+	ztest_run_test_suite(lib_nrf_cloud_cbor_test);
+}
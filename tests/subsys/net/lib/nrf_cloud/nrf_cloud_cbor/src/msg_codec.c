@@ -0,0 +1,447 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* Decoders of the device messages and encoder of the cellular positioning
+ * response, as nRF Cloud would implement them. The library only encodes
+ * device messages and decodes responses.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zcbor_encode.h>
+#include <zcbor_decode.h>
+#include <modem/modem_info.h>
+
+#include "nrf_cloud_codec.h"
+#include "msg_codec.h"
+
+/* Nesting depth of the messages: message, data, lte, cell, nmr, neighbor cell */
+#define CBOR_DEPTH_MAX 6
+
+/* Keys of the device message map, see cddl/nrf_cloud_msg.cddl */
+#define CBOR_KEY_APPID		1
+#define CBOR_KEY_MSG_TYPE	2
+#define CBOR_KEY_TS		3
+#define CBOR_KEY_DATA		4
+#define CBOR_KEY_ERR		5
+
+/* Pvt map keys */
+#define PVT_KEY_LON		1
+#define PVT_KEY_LAT		2
+#define PVT_KEY_ACCURACY	3
+#define PVT_KEY_ALTITUDE	4
+#define PVT_KEY_SPEED		5
+#define PVT_KEY_HEADING		6
+
+/* Cell_pos_req data map keys */
+#define CELL_POS_KEY_LTE	1
+#define CELL_POS_KEY_DOREPLY	2
+
+/* Lte_cell map keys */
+#define CELL_KEY_ECI		1
+#define CELL_KEY_MCC		2
+#define CELL_KEY_MNC		3
+#define CELL_KEY_TAC		4
+#define CELL_KEY_EARFCN		5
+#define CELL_KEY_RSRP		6
+#define CELL_KEY_RSRQ		7
+#define CELL_KEY_T_ADV		8
+#define CELL_KEY_NBORS		9
+
+/* Ncell map keys */
+#define NCELL_KEY_EARFCN	1
+#define NCELL_KEY_PCI		2
+#define NCELL_KEY_RSRP		3
+#define NCELL_KEY_RSRQ		4
+
+/* Cell_pos_result map keys */
+#define RESULT_KEY_LAT		1
+#define RESULT_KEY_LON		2
+#define RESULT_KEY_UNCERT	3
+#define RESULT_KEY_FULFILL	4
+
+#define ZSTR(s) ((struct zcbor_string){ .value = (const uint8_t *)(s), .len = strlen(s) })
+
+static bool tstr_put(zcbor_state_t *state, const char *str)
+{
+	struct zcbor_string zstr = ZSTR(str);
+
+	return zcbor_tstr_encode(state, &zstr);
+}
+
+static bool tstr_expect(zcbor_state_t *state, const char *str)
+{
+	struct zcbor_string zstr = ZSTR(str);
+
+	return zcbor_tstr_expect(state, &zstr);
+}
+
+static bool header_put(zcbor_state_t *state, const char *app_id)
+{
+	return zcbor_uint32_put(state, CBOR_KEY_APPID) &&
+	       tstr_put(state, app_id) &&
+	       zcbor_uint32_put(state, CBOR_KEY_MSG_TYPE) &&
+	       tstr_put(state, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+}
+
+/* Decodes an optional key: leaves the state as it was if the next key is
+ * another one, or if the end of the map is reached.
+ */
+static bool key_next(zcbor_state_t *state, uint32_t key)
+{
+	const uint8_t *payload = state->payload;
+	uint_fast32_t elem_count = state->elem_count;
+
+	if (zcbor_uint32_expect(state, key)) {
+		return true;
+	}
+
+	state->payload = payload;
+	state->elem_count = elem_count;
+	(void)zcbor_pop_error(state);
+
+	return false;
+}
+
+/* Starts decoding the next map of an array, if there is one */
+static bool map_next(zcbor_state_t *state)
+{
+	const uint8_t *payload = state->payload;
+	uint_fast32_t elem_count = state->elem_count;
+
+	if (zcbor_map_start_decode(state)) {
+		return true;
+	}
+
+	state->payload = payload;
+	state->elem_count = elem_count;
+	(void)zcbor_pop_error(state);
+
+	return false;
+}
+
+static bool header_expect(zcbor_state_t *state, struct zcbor_string *app_id)
+{
+	return zcbor_uint32_expect(state, CBOR_KEY_APPID) &&
+	       zcbor_tstr_decode(state, app_id) &&
+	       zcbor_uint32_expect(state, CBOR_KEY_MSG_TYPE) &&
+	       tstr_expect(state, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+}
+
+static bool zstr_equal(const struct zcbor_string *zstr, const char *str)
+{
+	return (zstr->len == strlen(str)) && !memcmp(zstr->value, str, zstr->len);
+}
+
+int sensor_msg_decode(const uint8_t *buf, size_t len, struct zcbor_string *app_id,
+		      struct zcbor_string *data)
+{
+	ZCBOR_STATE_D(states, CBOR_DEPTH_MAX, buf, len, 1);
+	bool ok;
+
+	ok = zcbor_map_start_decode(states) &&
+	     header_expect(states, app_id) &&
+	     zcbor_uint32_expect(states, CBOR_KEY_DATA) &&
+	     zcbor_tstr_decode(states, data) &&
+	     zcbor_map_end_decode(states);
+
+	return ok ? 0 : -EBADMSG;
+}
+
+static bool pvt_decode(zcbor_state_t *state, struct nrf_cloud_gnss_pvt *pvt)
+{
+	float value;
+
+	memset(pvt, 0, sizeof(*pvt));
+
+	if (!(zcbor_uint32_expect(state, PVT_KEY_LON) &&
+	      zcbor_float64_decode(state, &pvt->lon) &&
+	      zcbor_uint32_expect(state, PVT_KEY_LAT) &&
+	      zcbor_float64_decode(state, &pvt->lat) &&
+	      zcbor_uint32_expect(state, PVT_KEY_ACCURACY) &&
+	      zcbor_float32_decode(state, &pvt->accuracy))) {
+		return false;
+	}
+
+	if (key_next(state, PVT_KEY_ALTITUDE)) {
+		if (!zcbor_float32_decode(state, &value)) {
+			return false;
+		}
+		pvt->alt = value;
+		pvt->has_alt = 1;
+	}
+
+	if (key_next(state, PVT_KEY_SPEED)) {
+		if (!zcbor_float32_decode(state, &value)) {
+			return false;
+		}
+		pvt->speed = value;
+		pvt->has_speed = 1;
+	}
+
+	if (key_next(state, PVT_KEY_HEADING)) {
+		if (!zcbor_float32_decode(state, &value)) {
+			return false;
+		}
+		pvt->heading = value;
+		pvt->has_heading = 1;
+	}
+
+	return zcbor_map_end_decode(state);
+}
+
+int gnss_msg_decode(const uint8_t *buf, size_t len, struct nrf_cloud_gnss_data *gnss,
+		    struct zcbor_string *nmea)
+{
+	ZCBOR_STATE_D(states, CBOR_DEPTH_MAX, buf, len, 1);
+	struct zcbor_string app_id;
+	uint64_t ts;
+
+	memset(gnss, 0, sizeof(*gnss));
+	gnss->ts_ms = NRF_CLOUD_NO_TIMESTAMP;
+
+	if (!zcbor_map_start_decode(states) ||
+	    !header_expect(states, &app_id) ||
+	    !zstr_equal(&app_id, NRF_CLOUD_JSON_APPID_VAL_GNSS)) {
+		return -EBADMSG;
+	}
+
+	if (key_next(states, CBOR_KEY_TS)) {
+		if (!zcbor_uint64_decode(states, &ts) || (ts > INT64_MAX)) {
+			return -EBADMSG;
+		}
+		gnss->ts_ms = (int64_t)ts;
+	}
+
+	if (!zcbor_uint32_expect(states, CBOR_KEY_DATA)) {
+		return -EBADMSG;
+	}
+
+	if (map_next(states)) {
+		gnss->type = NRF_CLOUD_GNSS_TYPE_PVT;
+		if (!pvt_decode(states, &gnss->pvt)) {
+			return -EBADMSG;
+		}
+	} else {
+		struct zcbor_string sentence;
+
+		gnss->type = NRF_CLOUD_GNSS_TYPE_NMEA;
+		if (!zcbor_tstr_decode(states, &sentence)) {
+			return -EBADMSG;
+		}
+		if (nmea) {
+			*nmea = sentence;
+		}
+	}
+
+	return zcbor_map_end_decode(states) ? 0 : -EBADMSG;
+}
+
+static int16_t rsrp_dbm_to_idx(int32_t dbm)
+{
+	return (int16_t)(dbm + RSRP_OFFSET_VAL);
+}
+
+static int16_t rsrq_db_to_idx(float db)
+{
+	return (int16_t)lroundf((db + RSRQ_OFFSET_VAL) / RSRQ_SCALE_VAL);
+}
+
+static bool ncell_decode(zcbor_state_t *state, struct lte_lc_ncell *ncell)
+{
+	uint32_t value;
+	int32_t rsrp;
+	float rsrq;
+
+	memset(ncell, 0, sizeof(*ncell));
+	ncell->rsrp = NRF_CLOUD_CELL_POS_OMIT_RSRP;
+	ncell->rsrq = NRF_CLOUD_CELL_POS_OMIT_RSRQ;
+
+	if (!(zcbor_uint32_expect(state, NCELL_KEY_EARFCN) &&
+	      zcbor_uint32_decode(state, &ncell->earfcn) &&
+	      zcbor_uint32_expect(state, NCELL_KEY_PCI) &&
+	      zcbor_uint32_decode(state, &value) &&
+	      (value <= UINT16_MAX))) {
+		return false;
+	}
+	ncell->phys_cell_id = value;
+
+	if (key_next(state, NCELL_KEY_RSRP)) {
+		if (!zcbor_int32_decode(state, &rsrp)) {
+			return false;
+		}
+		ncell->rsrp = rsrp_dbm_to_idx(rsrp);
+	}
+
+	if (key_next(state, NCELL_KEY_RSRQ)) {
+		if (!zcbor_float32_decode(state, &rsrq)) {
+			return false;
+		}
+		ncell->rsrq = rsrq_db_to_idx(rsrq);
+	}
+
+	return zcbor_map_end_decode(state);
+}
+
+static bool cell_decode(zcbor_state_t *state, struct lte_lc_cells_info *inf,
+			struct lte_lc_ncell *ncells, size_t ncells_max)
+{
+	struct lte_lc_cell *cell = &inf->current_cell;
+	uint32_t mcc, mnc, t_adv;
+	int32_t rsrp;
+	float rsrq;
+
+	memset(inf, 0, sizeof(*inf));
+	cell->earfcn = NRF_CLOUD_CELL_POS_OMIT_EARFCN;
+	cell->rsrp = NRF_CLOUD_CELL_POS_OMIT_RSRP;
+	cell->rsrq = NRF_CLOUD_CELL_POS_OMIT_RSRQ;
+	cell->timing_advance = NRF_CLOUD_CELL_POS_OMIT_TIME_ADV;
+
+	if (!(zcbor_map_start_decode(state) &&
+	      zcbor_uint32_expect(state, CELL_KEY_ECI) &&
+	      zcbor_uint32_decode(state, &cell->id) &&
+	      zcbor_uint32_expect(state, CELL_KEY_MCC) &&
+	      zcbor_uint32_decode(state, &mcc) &&
+	      zcbor_uint32_expect(state, CELL_KEY_MNC) &&
+	      zcbor_uint32_decode(state, &mnc) &&
+	      zcbor_uint32_expect(state, CELL_KEY_TAC) &&
+	      zcbor_uint32_decode(state, &cell->tac))) {
+		return false;
+	}
+	cell->mcc = mcc;
+	cell->mnc = mnc;
+
+	if (key_next(state, CELL_KEY_EARFCN) &&
+	    !zcbor_uint32_decode(state, &cell->earfcn)) {
+		return false;
+	}
+
+	if (key_next(state, CELL_KEY_RSRP)) {
+		if (!zcbor_int32_decode(state, &rsrp)) {
+			return false;
+		}
+		cell->rsrp = rsrp_dbm_to_idx(rsrp);
+	}
+
+	if (key_next(state, CELL_KEY_RSRQ)) {
+		if (!zcbor_float32_decode(state, &rsrq)) {
+			return false;
+		}
+		cell->rsrq = rsrq_db_to_idx(rsrq);
+	}
+
+	if (key_next(state, CELL_KEY_T_ADV)) {
+		if (!zcbor_uint32_decode(state, &t_adv)) {
+			return false;
+		}
+		cell->timing_advance = MIN(t_adv, NRF_CLOUD_CELL_POS_TIME_ADV_MAX);
+	}
+
+	if (key_next(state, CELL_KEY_NBORS)) {
+		if (!zcbor_list_start_decode(state)) {
+			return false;
+		}
+
+		inf->neighbor_cells = ncells;
+		while (map_next(state)) {
+			if ((inf->ncells_count >= ncells_max) ||
+			    (inf->ncells_count == UINT8_MAX) ||
+			    !ncell_decode(state, &ncells[inf->ncells_count])) {
+				return false;
+			}
+			inf->ncells_count++;
+		}
+
+		if (!zcbor_list_end_decode(state)) {
+			return false;
+		}
+	}
+
+	return zcbor_map_end_decode(state);
+}
+
+int cell_pos_req_decode(const uint8_t *buf, size_t len, struct lte_lc_cells_info *inf,
+			struct lte_lc_ncell *ncells, size_t ncells_max, bool *request_loc)
+{
+	ZCBOR_STATE_D(states, CBOR_DEPTH_MAX, buf, len, 1);
+	struct zcbor_string app_id;
+	bool do_reply = true;
+
+	if (!(zcbor_map_start_decode(states) &&
+	      header_expect(states, &app_id) &&
+	      zstr_equal(&app_id, NRF_CLOUD_JSON_APPID_VAL_CELL_POS) &&
+	      zcbor_uint32_expect(states, CBOR_KEY_DATA) &&
+	      zcbor_map_start_decode(states) &&
+	      zcbor_uint32_expect(states, CELL_POS_KEY_LTE) &&
+	      zcbor_list_start_decode(states) &&
+	      cell_decode(states, inf, ncells, ncells_max) &&
+	      zcbor_list_end_decode(states))) {
+		return -EBADMSG;
+	}
+
+	if (key_next(states, CELL_POS_KEY_DOREPLY) &&
+	    !zcbor_bool_decode(states, &do_reply)) {
+		return -EBADMSG;
+	}
+
+	if (!(zcbor_map_end_decode(states) &&
+	      zcbor_map_end_decode(states))) {
+		return -EBADMSG;
+	}
+
+	*request_loc = do_reply;
+
+	return 0;
+}
+
+int cell_pos_resp_encode(const struct nrf_cloud_cell_pos_result *result, uint8_t *buf,
+			 size_t buf_len, size_t *out_len)
+{
+	ZCBOR_STATE_E(states, CBOR_DEPTH_MAX, buf, buf_len, 1);
+	const char *type = NULL;
+	bool ok;
+
+	if (result->type == CELL_POS_TYPE_SINGLE) {
+		type = NRF_CLOUD_CELL_POS_TYPE_VAL_SCELL;
+	} else if (result->type == CELL_POS_TYPE_MULTI) {
+		type = NRF_CLOUD_CELL_POS_TYPE_VAL_MCELL;
+	}
+
+	ok = zcbor_map_start_encode(states, 3) &&
+	     header_put(states, NRF_CLOUD_JSON_APPID_VAL_CELL_POS);
+
+	if (result->err != NRF_CLOUD_ERROR_NONE) {
+		ok = ok &&
+		     zcbor_uint32_put(states, CBOR_KEY_ERR) &&
+		     zcbor_int32_put(states, result->err);
+	} else {
+		ok = ok &&
+		     zcbor_uint32_put(states, CBOR_KEY_DATA) &&
+		     zcbor_map_start_encode(states, 4) &&
+		     zcbor_uint32_put(states, RESULT_KEY_LAT) &&
+		     zcbor_float64_put(states, result->lat) &&
+		     zcbor_uint32_put(states, RESULT_KEY_LON) &&
+		     zcbor_float64_put(states, result->lon) &&
+		     zcbor_uint32_put(states, RESULT_KEY_UNCERT) &&
+		     zcbor_uint32_put(states, result->unc) &&
+		     (!type ||
+		      (zcbor_uint32_put(states, RESULT_KEY_FULFILL) &&
+		       tstr_put(states, type))) &&
+		     zcbor_map_end_encode(states, 4);
+	}
+
+	ok = ok && zcbor_map_end_encode(states, 3);
+
+	if (!ok) {
+		return -ENOMEM;
+	}
+
+	*out_len = (size_t)states[0].payload - (size_t)buf;
+
+	return 0;
+}
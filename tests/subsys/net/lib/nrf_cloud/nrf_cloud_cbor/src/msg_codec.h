@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef MSG_CODEC_H__
+#define MSG_CODEC_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <zcbor_common.h>
+#include <modem/lte_lc.h>
+#include <net/nrf_cloud.h>
+#include <net/nrf_cloud_cell_pos.h>
+
+/**
+ * @brief Decode a sensor data device message. The decoded strings point
+ *        into the input buffer.
+ *
+ * @retval 0 If successful.
+ * @retval -EBADMSG If the message is not a sensor data message.
+ */
+int sensor_msg_decode(const uint8_t *buf, size_t len, struct zcbor_string *app_id,
+		      struct zcbor_string *data);
+
+/**
+ * @brief Decode a GNSS device message, as encoded by
+ *        nrf_cloud_gnss_msg_cbor_encode().
+ *
+ * @param[out] gnss GNSS data, of type NRF_CLOUD_GNSS_TYPE_PVT or
+ *                  NRF_CLOUD_GNSS_TYPE_NMEA. The NMEA sentence is not
+ *                  NULL-terminated, and is returned in @p nmea instead.
+ * @param[out] nmea NMEA sentence, pointing into the input buffer.
+ *
+ * @retval 0 If successful.
+ * @retval -EBADMSG If the message is not a GNSS message.
+ */
+int gnss_msg_decode(const uint8_t *buf, size_t len, struct nrf_cloud_gnss_data *gnss,
+		    struct zcbor_string *nmea);
+
+/**
+ * @brief Decode a cellular positioning request device message.
+ *
+ * @param[out] inf        Cell information. Neighbor cells are stored in
+ *                        @p ncells, which @p inf then points to.
+ * @param[out] ncells     Neighbor cells.
+ * @param[in]  ncells_max Number of elements in @p ncells.
+ *
+ * @retval 0 If successful.
+ * @retval -EBADMSG If the message is not a cellular positioning request.
+ */
+int cell_pos_req_decode(const uint8_t *buf, size_t len, struct lte_lc_cells_info *inf,
+			struct lte_lc_ncell *ncells, size_t ncells_max, bool *request_loc);
+
+/**
+ * @brief Encode a cellular positioning response, as sent by nRF Cloud.
+ *
+ * If result->err is not NRF_CLOUD_ERROR_NONE, the error is encoded instead
+ * of the location.
+ */
+int cell_pos_resp_encode(const struct nrf_cloud_cell_pos_result *result, uint8_t *buf,
+			 size_t buf_len, size_t *out_len);
+
+#endif /* MSG_CODEC_H__ */
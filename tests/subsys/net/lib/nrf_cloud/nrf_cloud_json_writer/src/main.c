@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <ztest.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cJSON.h>
+
+#include "nrf_cloud_codec.h"
+#include "nrf_cloud_json_writer.h"
+
+static char buf[1024];
+
+/* cJSON allocations are counted, to compare the heap high-water mark of
+ * building and printing a cJSON object with the one of the writer.
+ */
+static struct {
+	size_t cur;
+	size_t peak;
+} heap;
+
+static void *counting_malloc(size_t size)
+{
+	size_t *p = malloc(sizeof(size_t) + size);
+
+	if (!p) {
+		return NULL;
+	}
+
+	*p = size;
+	heap.cur += size;
+	heap.peak = MAX(heap.peak, heap.cur);
+
+	return p + 1;
+}
+
+static void counting_free(void *ptr)
+{
+	size_t *p = ptr;
+
+	if (!p) {
+		return;
+	}
+
+	p--;
+	heap.cur -= *p;
+	free(p);
+}
+
+/* Prints and deletes a cJSON object, returns the heap high-water mark */
+static size_t cjson_print(cJSON *obj, char **out)
+{
+	zassert_not_null(obj, NULL);
+
+	*out = cJSON_PrintUnformatted(obj);
+	zassert_not_null(*out, NULL);
+	cJSON_Delete(obj);
+
+	return heap.peak;
+}
+
+static void expect_same(const char *name, cJSON *ref_obj)
+{
+	char *ref;
+	size_t ref_peak;
+	int len;
+
+	ref_peak = cjson_print(ref_obj, &ref);
+
+	len = strlen(buf);
+	zassert_equal(len, strlen(ref), "%s: length %d, expected %d", name, len, strlen(ref));
+	zassert_mem_equal(buf, ref, len, "%s:\n%s\nexpected:\n%s", name, buf, ref);
+
+	printk("%s: %d bytes, heap high-water mark: cJSON %u bytes, writer %d bytes\n",
+	       name, len, ref_peak, len + 1);
+
+	counting_free(ref);
+}
+
+static void setup(void)
+{
+	memset(buf, 0, sizeof(buf));
+	memset(&heap, 0, sizeof(heap));
+}
+
+static void teardown(void)
+{
+	zassert_equal(heap.cur, 0, "cJSON memory leak");
+}
+
+static void test_sensor(void)
+{
+	static const char data[] = "23.5 \"q\" \\ \n\t\b\f\r\x01\x1f\x7f / \xc3\xa9";
+	struct nrf_cloud_json_writer w;
+	cJSON *ref;
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_sensor_msg_write(&w, NRF_CLOUD_JSON_APPID_VAL_TEMP, data);
+	zassert_true(nrf_cloud_json_writer_finish(&w) > 0, NULL);
+
+	ref = cJSON_CreateObject();
+	cJSON_AddStringToObject(ref, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_TEMP);
+	cJSON_AddStringToObject(ref, NRF_CLOUD_JSON_DATA_KEY, data);
+	cJSON_AddStringToObject(ref, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+				NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+
+	expect_same("sensor", ref);
+}
+
+static cJSON *gnss_ref(const struct nrf_cloud_gnss_data *gnss)
+{
+	cJSON *obj = cJSON_CreateObject();
+	cJSON *data;
+
+	cJSON_AddStringToObject(obj, NRF_CLOUD_JSON_APPID_KEY, NRF_CLOUD_JSON_APPID_VAL_GNSS);
+	cJSON_AddStringToObject(obj, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+				NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	if (gnss->ts_ms > NRF_CLOUD_NO_TIMESTAMP) {
+		cJSON_AddNumberToObject(obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, gnss->ts_ms);
+	}
+
+	if (gnss->type == NRF_CLOUD_GNSS_TYPE_NMEA) {
+		cJSON_AddStringToObject(obj, NRF_CLOUD_JSON_DATA_KEY, gnss->nmea.sentence);
+		return obj;
+	}
+
+	data = cJSON_AddObjectToObject(obj, NRF_CLOUD_JSON_DATA_KEY);
+	cJSON_AddNumberToObject(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_LON, gnss->pvt.lon);
+	cJSON_AddNumberToObject(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_LAT, gnss->pvt.lat);
+	cJSON_AddNumberToObject(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_ACCURACY, gnss->pvt.accuracy);
+	if (gnss->pvt.has_alt) {
+		cJSON_AddNumberToObject(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_ALTITUDE, gnss->pvt.alt);
+	}
+	if (gnss->pvt.has_speed) {
+		cJSON_AddNumberToObject(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_SPEED, gnss->pvt.speed);
+	}
+	if (gnss->pvt.has_heading) {
+		cJSON_AddNumberToObject(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_HEADING,
+					gnss->pvt.heading);
+	}
+
+	return obj;
+}
+
+static void gnss_check(const char *name, const struct nrf_cloud_gnss_data *gnss)
+{
+	struct nrf_cloud_json_writer w;
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	zassert_ok(nrf_cloud_json_gnss_msg_write(&w, gnss), NULL);
+	zassert_true(nrf_cloud_json_writer_finish(&w) > 0, NULL);
+
+	expect_same(name, gnss_ref(gnss));
+}
+
+static void test_gnss(void)
+{
+	struct nrf_cloud_gnss_data gnss = {
+		.type = NRF_CLOUD_GNSS_TYPE_PVT,
+		.ts_ms = 1657000000123LL,
+		.pvt = {
+			.lon = 10.123456789012345,
+			.lat = -63.4,
+			.accuracy = 12.5f,
+			.alt = 100.25f,
+			.has_alt = 1,
+			.speed = 0.1f,
+			.has_speed = 1,
+			.heading = 359.9f,
+			.has_heading = 1
+		}
+	};
+
+	gnss_check("gnss pvt", &gnss);
+
+	gnss.ts_ms = NRF_CLOUD_NO_TIMESTAMP;
+	gnss.pvt.has_alt = 0;
+	gnss.pvt.has_heading = 0;
+	gnss_check("gnss pvt, no timestamp", &gnss);
+
+	setup();
+	gnss.type = NRF_CLOUD_GNSS_TYPE_NMEA;
+	gnss.ts_ms = 0;
+	gnss.nmea.sentence = "$GPGGA,181908.00,3404.7041778,N,07044.3966270,W,4,13,1.00,"
+			     "495.144,M,29.200,M,0.10,0000*40";
+	gnss_check("gnss nmea", &gnss);
+}
+
+static void test_gnss_invalid(void)
+{
+	struct nrf_cloud_json_writer w;
+	char sentence[NRF_MODEM_GNSS_NMEA_MAX_LEN + 1];
+	struct nrf_cloud_gnss_data gnss = {
+		.type = NRF_CLOUD_GNSS_TYPE_NMEA,
+	};
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	zassert_equal(nrf_cloud_json_gnss_msg_write(&w, &gnss), -EINVAL, NULL);
+
+	memset(sentence, 'A', sizeof(sentence) - 1);
+	sentence[sizeof(sentence) - 1] = '\0';
+	gnss.nmea.sentence = sentence;
+	zassert_equal(nrf_cloud_json_gnss_msg_write(&w, &gnss), -EFBIG, NULL);
+
+	gnss.type = NRF_CLOUD_GNSS_TYPE_INVALID;
+	zassert_equal(nrf_cloud_json_gnss_msg_write(&w, &gnss), -EFTYPE, NULL);
+
+	/* Nothing is written before the message is validated */
+	zassert_equal(nrf_cloud_json_writer_finish(&w), 0, NULL);
+}
+
+static cJSON *cell_pos_ref(const struct lte_lc_cells_info *inf, size_t inf_cnt)
+{
+	cJSON *obj = cJSON_CreateObject();
+	cJSON *lte = cJSON_AddArrayToObject(obj, NRF_CLOUD_CELL_POS_JSON_KEY_LTE);
+
+	for (size_t i = 0; i < inf_cnt; i++) {
+		const struct lte_lc_cell *cell = &inf[i].current_cell;
+		cJSON *c = cJSON_CreateObject();
+		cJSON *nmr;
+
+		cJSON_AddItemToArray(lte, c);
+		cJSON_AddNumberToObject(c, NRF_CLOUD_CELL_POS_JSON_KEY_ECI, cell->id);
+		cJSON_AddNumberToObject(c, NRF_CLOUD_CELL_POS_JSON_KEY_MCC, cell->mcc);
+		cJSON_AddNumberToObject(c, NRF_CLOUD_CELL_POS_JSON_KEY_MNC, cell->mnc);
+		cJSON_AddNumberToObject(c, NRF_CLOUD_CELL_POS_JSON_KEY_TAC, cell->tac);
+		if (cell->earfcn != NRF_CLOUD_CELL_POS_OMIT_EARFCN) {
+			cJSON_AddNumberToObject(c, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN,
+						cell->earfcn);
+		}
+		if (cell->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP) {
+			cJSON_AddNumberToObject(c, NRF_CLOUD_CELL_POS_JSON_KEY_RSRP,
+						RSRP_IDX_TO_DBM(cell->rsrp));
+		}
+		if (cell->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ) {
+			cJSON_AddNumberToObject(c, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ,
+						RSRQ_IDX_TO_DB(cell->rsrq));
+		}
+		if (cell->timing_advance != NRF_CLOUD_CELL_POS_OMIT_TIME_ADV) {
+			cJSON_AddNumberToObject(c, NRF_CLOUD_CELL_POS_JSON_KEY_T_ADV,
+						MIN(cell->timing_advance,
+						    NRF_CLOUD_CELL_POS_TIME_ADV_MAX));
+		}
+
+		if (!inf[i].ncells_count) {
+			continue;
+		}
+
+		nmr = cJSON_AddArrayToObject(c, NRF_CLOUD_CELL_POS_JSON_KEY_NBORS);
+		for (size_t j = 0; j < inf[i].ncells_count; j++) {
+			const struct lte_lc_ncell *nc = &inf[i].neighbor_cells[j];
+			cJSON *n = cJSON_CreateObject();
+
+			cJSON_AddItemToArray(nmr, n);
+			cJSON_AddNumberToObject(n, NRF_CLOUD_CELL_POS_JSON_KEY_EARFCN, nc->earfcn);
+			cJSON_AddNumberToObject(n, NRF_CLOUD_CELL_POS_JSON_KEY_PCI,
+						nc->phys_cell_id);
+			if (nc->rsrp != NRF_CLOUD_CELL_POS_OMIT_RSRP) {
+				cJSON_AddNumberToObject(n, NRF_CLOUD_CELL_POS_JSON_KEY_RSRP,
+							RSRP_IDX_TO_DBM(nc->rsrp));
+			}
+			if (nc->rsrq != NRF_CLOUD_CELL_POS_OMIT_RSRQ) {
+				cJSON_AddNumberToObject(n, NRF_CLOUD_CELL_POS_JSON_KEY_RSRQ,
+							RSRQ_IDX_TO_DB(nc->rsrq));
+			}
+		}
+	}
+
+	return obj;
+}
+
+static void test_cell_pos(void)
+{
+	struct lte_lc_ncell ncells[] = {
+		{ .earfcn = 6300, .phys_cell_id = 123, .rsrp = 40, .rsrq = 3 },
+		{ .earfcn = 6301, .phys_cell_id = 7, .rsrp = LTE_LC_CELL_RSRP_INVALID,
+		  .rsrq = 33 },
+		{ .earfcn = 1650, .phys_cell_id = 503, .rsrp = 97,
+		  .rsrq = LTE_LC_CELL_RSRQ_INVALID },
+	};
+	struct lte_lc_cells_info inf[] = {
+		{
+			.current_cell = {
+				.id = 0x12345678, .mcc = 242, .mnc = 1, .tac = 0x1234,
+				.earfcn = 6400, .rsrp = 50, .rsrq = 20, .timing_advance = 30000
+			},
+			.ncells_count = ARRAY_SIZE(ncells),
+			.neighbor_cells = ncells
+		},
+		{
+			.current_cell = {
+				.id = 0xFFFFFFE, .mcc = 310, .mnc = 410, .tac = 3,
+				.earfcn = NRF_CLOUD_CELL_POS_OMIT_EARFCN,
+				.rsrp = NRF_CLOUD_CELL_POS_OMIT_RSRP,
+				.rsrq = NRF_CLOUD_CELL_POS_OMIT_RSRQ,
+				.timing_advance = NRF_CLOUD_CELL_POS_OMIT_TIME_ADV
+			}
+		},
+	};
+	struct nrf_cloud_json_writer w;
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_obj_start(&w, NULL);
+	nrf_cloud_json_cell_pos_lte_write(&w, inf, ARRAY_SIZE(inf));
+	nrf_cloud_json_obj_end(&w);
+	zassert_true(nrf_cloud_json_writer_finish(&w) > 0, NULL);
+
+	expect_same("cell pos", cell_pos_ref(inf, ARRAY_SIZE(inf)));
+}
+
+static void test_numbers(void)
+{
+	static const double nums[] = {
+		0, -0.0, 0.1, 1.0 / 3, 100.0 / 3, -1.5, 1e20, 1e-300,
+		INT_MAX, (double)INT_MAX + 1, INT_MIN, (double)INT_MIN - 1, UINT32_MAX,
+		123456789.123, (float)0.1, 5e-324, 1.7976931348623157e308,
+		NAN, INFINITY, -INFINITY
+	};
+	struct nrf_cloud_json_writer w;
+	cJSON *ref = cJSON_CreateArray();
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_arr_start(&w, NULL);
+	for (size_t i = 0; i < ARRAY_SIZE(nums); i++) {
+		nrf_cloud_json_num_add(&w, NULL, nums[i]);
+		cJSON_AddItemToArray(ref, cJSON_CreateNumber(nums[i]));
+	}
+
+	nrf_cloud_json_obj_start(&w, NULL);
+	nrf_cloud_json_obj_end(&w);
+	cJSON_AddItemToArray(ref, cJSON_CreateObject());
+	nrf_cloud_json_arr_start(&w, NULL);
+	nrf_cloud_json_arr_end(&w);
+	cJSON_AddItemToArray(ref, cJSON_CreateArray());
+	nrf_cloud_json_str_add(&w, NULL, "");
+	cJSON_AddItemToArray(ref, cJSON_CreateString(""));
+
+	nrf_cloud_json_arr_end(&w);
+	zassert_true(nrf_cloud_json_writer_finish(&w) > 0, NULL);
+
+	expect_same("numbers", ref);
+}
+
+static void test_buffer_size(void)
+{
+	struct nrf_cloud_json_writer w;
+	int len;
+
+	/* Measure first, as the heap-returning encoders do */
+	nrf_cloud_json_writer_init(&w, NULL, 0);
+	nrf_cloud_json_sensor_msg_write(&w, NRF_CLOUD_JSON_APPID_VAL_HUMID, "42.1");
+	len = nrf_cloud_json_writer_finish(&w);
+	zassert_equal(len, strlen("{\"appId\":\"HUMID\",\"data\":\"42.1\","
+				  "\"messageType\":\"DATA\"}"), NULL);
+
+	/* Room for the terminating NULL character is required */
+	nrf_cloud_json_writer_init(&w, buf, len);
+	nrf_cloud_json_sensor_msg_write(&w, NRF_CLOUD_JSON_APPID_VAL_HUMID, "42.1");
+	zassert_equal(nrf_cloud_json_writer_finish(&w), -ENOMEM, NULL);
+	zassert_true(strlen(buf) < len, "Buffer overflow");
+
+	nrf_cloud_json_writer_init(&w, buf, len + 1);
+	nrf_cloud_json_sensor_msg_write(&w, NRF_CLOUD_JSON_APPID_VAL_HUMID, "42.1");
+	zassert_equal(nrf_cloud_json_writer_finish(&w), len, NULL);
+	zassert_equal(strlen(buf), len, NULL);
+}
+
+static void test_nesting(void)
+{
+	struct nrf_cloud_json_writer w;
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	for (int i = 0; i <= NRF_CLOUD_JSON_WRITER_DEPTH_MAX; i++) {
+		nrf_cloud_json_arr_start(&w, NULL);
+	}
+	zassert_equal(nrf_cloud_json_writer_finish(&w), -E2BIG, NULL);
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_obj_start(&w, NULL);
+	zassert_equal(nrf_cloud_json_writer_finish(&w), -EINVAL, NULL);
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_obj_end(&w);
+	zassert_equal(nrf_cloud_json_writer_finish(&w), -EINVAL, NULL);
+}
+
+void test_main(void)
+{
+	cJSON_Hooks hooks = {
+		.malloc_fn = counting_malloc,
+		.free_fn = counting_free
+	};
+
+	cJSON_InitHooks(&hooks);
+
+	ztest_test_suite(lib_nrf_cloud_json_writer_test,
+			 ztest_unit_test_setup_teardown(test_sensor, setup, teardown),
+			 ztest_unit_test_setup_teardown(test_gnss, setup, teardown),
+			 ztest_unit_test_setup_teardown(test_gnss_invalid, setup, teardown),
+			 ztest_unit_test_setup_teardown(test_cell_pos, setup, teardown),
+			 ztest_unit_test_setup_teardown(test_numbers, setup, teardown),
+			 ztest_unit_test_setup_teardown(test_buffer_size, setup, teardown),
+			 ztest_unit_test_setup_teardown(test_nesting, setup, teardown));
+
+	ztest_run_test_suite(lib_nrf_cloud_json_writer_test);
+}
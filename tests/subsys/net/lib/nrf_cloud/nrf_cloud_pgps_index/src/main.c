@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <ztest.h>
+#include <string.h>
+#include <zephyr/drivers/flash.h>
+#include <zephyr/drivers/flash/flash_simulator.h>
+#include <zephyr/logging/log.h>
+
+#include "nrf_cloud_pgps_schema_v1.h"
+#include "nrf_cloud_pgps_utils.h"
+#include "nrf_cloud_pgps_index.h"
+
+LOG_MODULE_REGISTER(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
+
+#define PERIOD_SEC	(240 * SEC_PER_MIN)
+#define START_DAY	15000
+#define START_TIME	(2 * SEC_PER_HOUR)
+#define START_SEC	((int64_t)START_DAY * SEC_PER_DAY + START_TIME)
+#define LOOKUPS		10000
+
+static const struct device *flash_dev = DEVICE_DT_GET(DT_INST(0, zephyr_sim_flash));
+static uint8_t *storage;
+static size_t stride;
+static int check_count;
+
+/* same conversion as nrf_cloud_pgps_utils.c, which needs the full library */
+int64_t npgps_gps_day_time_to_sec(uint16_t gps_day, uint32_t gps_time_of_day)
+{
+	return (int64_t)gps_day * SEC_PER_DAY + gps_time_of_day;
+}
+
+static int check(const struct nrf_cloud_pgps_prediction *p)
+{
+	check_count++;
+	if ((p->schema_version != NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION) ||
+	    (p->time_type != NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK) ||
+	    (p->time_count != 1) ||
+	    (p->ephemeris_type != NRF_CLOUD_AGPS_EPHEMERIDES) ||
+	    (p->ephemeris_count != NRF_CLOUD_PGPS_NUM_SV)) {
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static struct nrf_cloud_pgps_prediction *block_ptr(int block)
+{
+	return (struct nrf_cloud_pgps_prediction *)(storage + block * stride);
+}
+
+static void store(int block, int64_t gps_sec, bool valid)
+{
+	static struct nrf_cloud_pgps_prediction p;
+	int err;
+
+	memset(&p, 0, sizeof(p));
+	p.time_type = NRF_CLOUD_AGPS_GPS_SYSTEM_CLOCK;
+	p.time_count = 1;
+	p.time.date_day = gps_sec / SEC_PER_DAY;
+	p.time.time_full_s = gps_sec % SEC_PER_DAY;
+	p.schema_version = NRF_CLOUD_AGPS_BIN_SCHEMA_VERSION;
+	p.ephemeris_type = NRF_CLOUD_AGPS_EPHEMERIDES;
+	p.ephemeris_count = valid ? NRF_CLOUD_PGPS_NUM_SV : 0xffff;
+	p.sentinel = (uint32_t)gps_sec;
+
+	err = flash_erase(flash_dev, block * stride, stride);
+	zassert_equal(err, 0, "flash_erase failed: %d", err);
+	err = flash_write(flash_dev, block * stride, &p, sizeof(p));
+	zassert_equal(err, 0, "flash_write failed: %d", err);
+}
+
+/* predictions are stored out of time order, as after a partial update */
+static int block_of(int pnum)
+{
+	return (pnum + NUM_PREDICTIONS / 2) % NUM_PREDICTIONS;
+}
+
+static void setup(void)
+{
+	struct flash_pages_info info;
+	size_t size;
+	int err;
+
+	/* one prediction per erase page, so each can be rewritten alone */
+	err = flash_get_page_info_by_offs(flash_dev, 0, &info);
+	zassert_equal(err, 0, NULL);
+	stride = ROUND_UP(BLOCK_SIZE, info.size);
+
+	storage = flash_simulator_get_memory(flash_dev, &size);
+	zassert_not_null(storage, NULL);
+	zassert_true(size >= NUM_BLOCKS * stride, "flash simulator too small");
+
+	npgps_index_reset();
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		store(block_of(pnum), START_SEC + pnum * PERIOD_SEC, true);
+		npgps_index_set(pnum, block_ptr(block_of(pnum)));
+	}
+	check_count = 0;
+}
+
+static void test_find(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+	int err;
+
+	for (int pass = 0; pass < 2; pass++) {
+		for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+			err = npgps_index_find(pnum, START_SEC + pnum * PERIOD_SEC + 1,
+					       PERIOD_SEC, check, &p);
+			zassert_equal(err, 0, "pnum:%d, err:%d", pnum, err);
+			zassert_equal_ptr(p, block_ptr(block_of(pnum)), NULL);
+		}
+	}
+	/* each prediction is read from flash only once */
+	zassert_equal(check_count, NUM_PREDICTIONS, NULL);
+}
+
+static void test_find_window(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+	int64_t start = START_SEC + 3 * PERIOD_SEC;
+
+	zassert_equal(npgps_index_find(3, start, PERIOD_SEC, check, &p), 0, NULL);
+	zassert_equal(npgps_index_find(3, start + PERIOD_SEC, PERIOD_SEC, check, &p), 0,
+		      NULL);
+	zassert_equal(npgps_index_find(3, start - 1, PERIOD_SEC, check, &p), -EINVAL, NULL);
+	zassert_equal(npgps_index_find(3, start + PERIOD_SEC + 1, PERIOD_SEC, check, &p),
+		      -EINVAL, NULL);
+	zassert_equal(check_count, 1, NULL);
+}
+
+static void test_find_bad_format(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+	int64_t gps_sec = START_SEC + 5 * PERIOD_SEC;
+
+	store(block_of(5), gps_sec, false);
+
+	zassert_equal(npgps_index_find(5, gps_sec, PERIOD_SEC, check, &p), -EINVAL, NULL);
+	zassert_equal(npgps_index_find(5, gps_sec, PERIOD_SEC, check, &p), -EINVAL, NULL);
+	/* a bad prediction is not cached as good */
+	zassert_equal(check_count, 2, NULL);
+
+	/* rewritten prediction is checked again */
+	store(block_of(5), gps_sec, true);
+	npgps_index_set(5, block_ptr(block_of(5)));
+	zassert_equal(npgps_index_find(5, gps_sec, PERIOD_SEC, check, &p), 0, NULL);
+	zassert_equal(check_count, 3, NULL);
+}
+
+static void test_find_empty(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+
+	npgps_index_set(7, NULL);
+	zassert_equal(npgps_index_find(7, START_SEC + 7 * PERIOD_SEC, PERIOD_SEC, check, &p),
+		      -ENOENT, NULL);
+	zassert_is_null(p, NULL);
+	zassert_equal(check_count, 0, NULL);
+}
+
+static void test_discard(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+	int discard = 4;
+	int pnum;
+	int err;
+
+	/* warm up the index, as after a first fix */
+	for (pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_equal(npgps_index_find(pnum, START_SEC + pnum * PERIOD_SEC, PERIOD_SEC,
+					       check, &p), 0, NULL);
+	}
+	check_count = 0;
+
+	npgps_index_discard(discard, NUM_PREDICTIONS);
+
+	for (pnum = 0; pnum < NUM_PREDICTIONS - discard; pnum++) {
+		err = npgps_index_find(pnum, START_SEC + (pnum + discard) * PERIOD_SEC,
+				       PERIOD_SEC, check, &p);
+		zassert_equal(err, 0, "pnum:%d, err:%d", pnum, err);
+		zassert_equal_ptr(p, block_ptr(block_of(pnum + discard)), NULL);
+	}
+	/* the predictions that were kept are not read again */
+	zassert_equal(check_count, 0, NULL);
+
+	for (; pnum < NUM_PREDICTIONS; pnum++) {
+		zassert_is_null(npgps_index_get(pnum), "pnum:%d", pnum);
+	}
+
+	/* download of a newer prediction into a freed block */
+	pnum = NUM_PREDICTIONS - 1;
+	store(block_of(0), START_SEC + (pnum + discard) * PERIOD_SEC, true);
+	npgps_index_set(pnum, block_ptr(block_of(0)));
+	zassert_equal(npgps_index_find(pnum, START_SEC + (pnum + discard) * PERIOD_SEC,
+				       PERIOD_SEC, check, &p), 0, NULL);
+	zassert_equal_ptr(p, block_ptr(block_of(0)), NULL);
+	zassert_equal(check_count, 1, NULL);
+}
+
+/* lookup as done before the index: check the prediction and read its time
+ * from flash every time
+ */
+static int find_uncached(int pnum, int64_t gps_sec, struct nrf_cloud_pgps_prediction **p)
+{
+	int64_t pred_sec;
+	int err;
+
+	*p = npgps_index_get(pnum);
+	err = check(*p);
+	if (err) {
+		return err;
+	}
+	pred_sec = npgps_gps_day_time_to_sec((*p)->time.date_day, (*p)->time.time_full_s);
+	if ((gps_sec < pred_sec) || (gps_sec > pred_sec + (int64_t)PERIOD_SEC)) {
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static void test_lookup_latency(void)
+{
+	struct nrf_cloud_pgps_prediction *p;
+	uint32_t start;
+	uint32_t uncached_cycles;
+	uint32_t uncached_reads;
+	uint32_t index_cycles;
+	uint32_t index_reads;
+	int pnum;
+	int err = 0;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < LOOKUPS; i++) {
+		pnum = i % NUM_PREDICTIONS;
+		err |= find_uncached(pnum, START_SEC + pnum * PERIOD_SEC, &p);
+	}
+	uncached_cycles = k_cycle_get_32() - start;
+	uncached_reads = check_count;
+	zassert_equal(err, 0, NULL);
+
+	check_count = 0;
+	start = k_cycle_get_32();
+	for (int i = 0; i < LOOKUPS; i++) {
+		pnum = i % NUM_PREDICTIONS;
+		err |= npgps_index_find(pnum, START_SEC + pnum * PERIOD_SEC, PERIOD_SEC,
+					check, &p);
+	}
+	index_cycles = k_cycle_get_32() - start;
+	index_reads = check_count;
+	zassert_equal(err, 0, NULL);
+
+	printk("%d lookups: uncached %u cycles, %u flash reads; "
+	       "index %u cycles, %u flash reads\n",
+	       LOOKUPS, uncached_cycles, uncached_reads, index_cycles, index_reads);
+	zassert_equal(index_reads, NUM_PREDICTIONS, NULL);
+	zassert_true(index_reads < uncached_reads, NULL);
+}
+
+void test_main(void)
+{
+	zassert_true(device_is_ready(flash_dev), "flash simulator not ready");
+
+	ztest_test_suite(lib_nrf_cloud_pgps_index_test,
+			 ztest_unit_test_setup_teardown(test_find, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_find_window, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_find_bad_format, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_find_empty, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_discard, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_lookup_latency, setup,
+							unit_test_noop));
+
+	ztest_run_test_suite(lib_nrf_cloud_pgps_index_test);
+}
@@ -6,6 +6,9 @@
 
 #include <ztest.h>
 #include <nrf_profiler.h>
+#ifdef CONFIG_NRF_PROFILER_STREAM_SINK_CUSTOM
+#include "stream_sink.h"
+#endif
 
 #define PROFILED_EVENTS_NB 100
 #define U_VALUE_START 0
@@ -117,13 +120,34 @@ static void test_performance3(void)
 	       PROFILED_EVENTS_NB, elapsed_time_us);
 }
 
+static void test_stream_delivery(void)
+{
+#ifdef CONFIG_NRF_PROFILER_STREAM_SINK_CUSTOM
+	/* Let the stream thread drain the ring buffer. */
+	k_sleep(K_MSEC(2 * CONFIG_NRF_PROFILER_STREAM_FLUSH_PERIOD_MS));
+
+	uint32_t event_cnt = stream_sink_event_cnt();
+	uint32_t drop_cnt = stream_sink_drop_cnt();
+
+	printk("Stream sink received %u events, %u events dropped\n", event_cnt, drop_cnt);
+
+	zassert_equal(stream_sink_invalid_cnt(), 0, "Malformed frames received");
+	zassert_equal(stream_sink_clock_cnt(), 1, "Missing clock frame");
+	zassert_equal(event_cnt + drop_cnt, 3 * PROFILED_EVENTS_NB,
+		      "Events lost without being reported as dropped");
+#else
+	ztest_test_skip();
+#endif
+}
+
 void test_main(void)
 {
 	ztest_test_suite(nrf_profiler_tests,
 			 ztest_unit_test(test_init),
 			 ztest_unit_test(test_performance1),
 			 ztest_unit_test(test_performance2),
-			 ztest_unit_test(test_performance3)
+			 ztest_unit_test(test_performance3),
+			 ztest_unit_test(test_stream_delivery)
 			 );
 
 	ztest_run_test_suite(nrf_profiler_tests);
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <nrf_profiler.h>
+#include "stream_sink.h"
+
+#define FRAME_HDR_LEN		2
+#define FRAME_MAX_LEN		(FRAME_HDR_LEN + UINT8_MAX)
+#define FRAME_DELIMITER		0x00
+#define STREAM_FRAME_TIME	0xFC
+#define STREAM_FRAME_CLOCK	0xFD
+#define STREAM_FRAME_DESCR	0xFE
+#define STREAM_FRAME_DROP	0xFF
+
+static uint32_t event_cnt;
+static uint32_t drop_cnt;
+static uint32_t clock_cnt;
+static uint32_t invalid_cnt;
+
+int nrf_profiler_stream_sink_init(void)
+{
+	return 0;
+}
+
+static int cobs_decode(uint8_t *out, size_t out_size, const uint8_t *data, size_t len)
+{
+	size_t out_len = 0;
+	size_t pos = 0;
+
+	while (pos < len) {
+		uint8_t code = data[pos++];
+
+		if ((code == 0) || (pos + code - 1 > len) ||
+		    (out_len + code - 1 > out_size)) {
+			return -EINVAL;
+		}
+
+		memcpy(&out[out_len], &data[pos], code - 1);
+		out_len += code - 1;
+		pos += code - 1;
+
+		if ((code != 0xFF) && (pos < len)) {
+			if (out_len >= out_size) {
+				return -EINVAL;
+			}
+			out[out_len++] = 0;
+		}
+	}
+
+	return out_len;
+}
+
+static void frame_check(const uint8_t *frame, size_t len)
+{
+	if ((len < FRAME_HDR_LEN) || (len != FRAME_HDR_LEN + frame[1])) {
+		invalid_cnt++;
+		return;
+	}
+
+	uint8_t frame_id = frame[0];
+	uint8_t body_len = frame[1];
+	const uint8_t *body = &frame[FRAME_HDR_LEN];
+
+	switch (frame_id) {
+	case STREAM_FRAME_CLOCK:
+		if (body_len == 2 * sizeof(uint32_t)) {
+			clock_cnt++;
+		} else {
+			invalid_cnt++;
+		}
+		break;
+	case STREAM_FRAME_TIME:
+		if (body_len != sizeof(uint32_t)) {
+			invalid_cnt++;
+		}
+		break;
+	case STREAM_FRAME_DROP:
+		if (body_len == sizeof(uint32_t)) {
+			drop_cnt += sys_get_le32(body);
+		} else {
+			invalid_cnt++;
+		}
+		break;
+	case STREAM_FRAME_DESCR:
+		break;
+	default:
+		if (frame_id < nrf_profiler_num_events) {
+			event_cnt++;
+		} else {
+			invalid_cnt++;
+		}
+		break;
+	}
+}
+
+int nrf_profiler_stream_sink_write(const uint8_t *data, size_t len)
+{
+	/* Stream backend writes whole frames only, every write starts with
+	 * a delimiter and every frame ends with one. The function is called
+	 * from the stream thread, so errors are counted and verified by the test.
+	 */
+	static uint8_t frame[FRAME_MAX_LEN];
+	size_t start;
+
+	if ((len == 0) || (data[0] != FRAME_DELIMITER) ||
+	    (data[len - 1] != FRAME_DELIMITER)) {
+		invalid_cnt++;
+		return 0;
+	}
+
+	start = 1;
+	for (size_t pos = 1; pos < len; pos++) {
+		if (data[pos] != FRAME_DELIMITER) {
+			continue;
+		}
+
+		int frame_len = cobs_decode(frame, sizeof(frame), &data[start], pos - start);
+
+		if (frame_len < 0) {
+			invalid_cnt++;
+		} else {
+			frame_check(frame, frame_len);
+		}
+		start = pos + 1;
+	}
+
+	return 0;
+}
+
+int nrf_profiler_stream_sink_read_cmd(uint8_t *cmd)
+{
+	return -EAGAIN;
+}
+
+uint32_t stream_sink_event_cnt(void)
+{
+	return event_cnt;
+}
+
+uint32_t stream_sink_drop_cnt(void)
+{
+	return drop_cnt;
+}
+
+uint32_t stream_sink_clock_cnt(void)
+{
+	return clock_cnt;
+}
+
+uint32_t stream_sink_invalid_cnt(void)
+{
+	return invalid_cnt;
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _STREAM_SINK_H_
+#define _STREAM_SINK_H_
+
+#include <zephyr/types.h>
+
+/* Number of event frames received by the test sink. */
+uint32_t stream_sink_event_cnt(void);
+
+/* Number of events reported as dropped by the stream backend. */
+uint32_t stream_sink_drop_cnt(void);
+
+/* Number of clock frames received by the test sink. */
+uint32_t stream_sink_clock_cnt(void);
+
+/* Number of malformed frames received by the test sink. */
+uint32_t stream_sink_invalid_cnt(void);
+
+#endif /* _STREAM_SINK_H_ */
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <ztest.h>
+#include <string.h>
+#include <zephyr/ipc/ipc_service_backend.h>
+
+#include <nrf_rpc/nrf_rpc_ipc.h>
+
+#define SHM_BUF_SIZE	128
+#define SHM_BUF_COUNT	4
+#define NOTIF_LEN	32
+#define NOTIF_COUNT	10000
+
+/* Loopback IPC Service backend: every sent packet is received on the same
+ * endpoint. The shared memory is a pool of fixed-size buffers.
+ */
+struct loopback {
+	const struct ipc_ept_cfg *cfg;
+	uint8_t shm[SHM_BUF_COUNT][SHM_BUF_SIZE];
+	bool shm_used[SHM_BUF_COUNT];
+	size_t copied;
+};
+
+static struct loopback lb_nocopy;
+static struct loopback lb_copy;
+
+static size_t received_count;
+static size_t received_len;
+static uint8_t received_first;
+
+static int shm_index(struct loopback *lb, const void *data)
+{
+	for (int i = 0; i < SHM_BUF_COUNT; i++) {
+		if (data == lb->shm[i]) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+static int lb_open_instance(const struct device *instance)
+{
+	return 0;
+}
+
+static int lb_register_endpoint(const struct device *instance, void **token,
+				const struct ipc_ept_cfg *cfg)
+{
+	struct loopback *lb = instance->data;
+
+	lb->cfg = cfg;
+	*token = lb;
+	cfg->cb.bound(cfg->priv);
+
+	return 0;
+}
+
+static int lb_send(const struct device *instance, void *token, const void *data, size_t len)
+{
+	struct loopback *lb = token;
+	static uint8_t rx_buf[1024];
+
+	if (len > sizeof(rx_buf)) {
+		return -EBADMSG;
+	}
+
+	memcpy(rx_buf, data, len);
+	lb->copied += len;
+	lb->cfg->cb.received(rx_buf, len, lb->cfg->priv);
+
+	return len;
+}
+
+static int lb_get_tx_buffer_size(const struct device *instance, void *token)
+{
+	return SHM_BUF_SIZE;
+}
+
+static int lb_get_tx_buffer(const struct device *instance, void *token, void **data,
+			    uint32_t *len, k_timeout_t wait)
+{
+	struct loopback *lb = token;
+
+	if (*len > SHM_BUF_SIZE) {
+		*len = SHM_BUF_SIZE;
+		return -ENOMEM;
+	}
+
+	for (int i = 0; i < SHM_BUF_COUNT; i++) {
+		if (!lb->shm_used[i]) {
+			lb->shm_used[i] = true;
+			*data = lb->shm[i];
+			*len = SHM_BUF_SIZE;
+			return 0;
+		}
+	}
+
+	return -ENOBUFS;
+}
+
+static int lb_drop_tx_buffer(const struct device *instance, void *token, const void *data)
+{
+	struct loopback *lb = token;
+	int i = shm_index(lb, data);
+
+	if ((i < 0) || !lb->shm_used[i]) {
+		return -EALREADY;
+	}
+	lb->shm_used[i] = false;
+
+	return 0;
+}
+
+static int lb_send_nocopy(const struct device *instance, void *token, const void *data,
+			  size_t len)
+{
+	struct loopback *lb = token;
+
+	if (shm_index(lb, data) < 0) {
+		return -EINVAL;
+	}
+
+	lb->cfg->cb.received(data, len, lb->cfg->priv);
+	lb_drop_tx_buffer(instance, token, data);
+
+	return len;
+}
+
+static const struct ipc_service_backend lb_nocopy_api = {
+	.open_instance = lb_open_instance,
+	.register_endpoint = lb_register_endpoint,
+	.send = lb_send,
+	.get_tx_buffer_size = lb_get_tx_buffer_size,
+	.get_tx_buffer = lb_get_tx_buffer,
+	.drop_tx_buffer = lb_drop_tx_buffer,
+	.send_nocopy = lb_send_nocopy,
+};
+
+/* Backend that can only send by copying. */
+static const struct ipc_service_backend lb_copy_api = {
+	.open_instance = lb_open_instance,
+	.register_endpoint = lb_register_endpoint,
+	.send = lb_send,
+};
+
+static int lb_init(const struct device *dev)
+{
+	return 0;
+}
+
+DEVICE_DEFINE(lb_nocopy_dev, "lb_nocopy", lb_init, NULL, &lb_nocopy, NULL, POST_KERNEL,
+	      CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &lb_nocopy_api);
+DEVICE_DEFINE(lb_copy_dev, "lb_copy", lb_init, NULL, &lb_copy, NULL, POST_KERNEL,
+	      CONFIG_KERNEL_INIT_PRIORITY_DEVICE, &lb_copy_api);
+
+NRF_RPC_IPC_TRANSPORT(tr_nocopy, DEVICE_GET(lb_nocopy_dev), "ept");
+NRF_RPC_IPC_TRANSPORT(tr_copy, DEVICE_GET(lb_copy_dev), "ept");
+
+static void receive_cb(const struct nrf_rpc_tr *transport, const uint8_t *packet, size_t len,
+		       void *context)
+{
+	received_count++;
+	received_len = len;
+	received_first = packet[0];
+}
+
+static void shm_assert_free(struct loopback *lb)
+{
+	for (int i = 0; i < SHM_BUF_COUNT; i++) {
+		zassert_false(lb->shm_used[i], "shared buffer %d leaked", i);
+	}
+}
+
+static void setup(void)
+{
+	received_count = 0;
+	received_len = 0;
+	lb_nocopy.copied = 0;
+	lb_copy.copied = 0;
+}
+
+static void *alloc(const struct nrf_rpc_tr *tr, size_t len, uint8_t fill)
+{
+	size_t size = len;
+	uint8_t *buf = tr->api->tx_buf_alloc(tr, &size);
+
+	zassert_not_null(buf, NULL);
+	memset(buf, fill, len);
+
+	return buf;
+}
+
+static void test_nocopy_send(void)
+{
+	uint8_t *buf = alloc(&tr_nocopy, NOTIF_LEN, 0xa5);
+
+	zassert_true(shm_index(&lb_nocopy, buf) >= 0, "not in shared memory");
+	zassert_equal(tr_nocopy.api->send(&tr_nocopy, buf, NOTIF_LEN), 0, NULL);
+
+	zassert_equal(received_count, 1, NULL);
+	zassert_equal(received_len, NOTIF_LEN, NULL);
+	zassert_equal(received_first, 0xa5, NULL);
+	zassert_equal(lb_nocopy.copied, 0, NULL);
+	shm_assert_free(&lb_nocopy);
+}
+
+static void test_nocopy_large_packet(void)
+{
+	size_t len = SHM_BUF_SIZE + 1;
+	uint8_t *buf = alloc(&tr_nocopy, len, 0x5a);
+
+	zassert_true(shm_index(&lb_nocopy, buf) < 0, "too large for shared memory");
+	zassert_equal(tr_nocopy.api->send(&tr_nocopy, buf, len), 0, NULL);
+
+	zassert_equal(received_count, 1, NULL);
+	zassert_equal(received_len, len, NULL);
+	zassert_equal(received_first, 0x5a, NULL);
+	zassert_equal(lb_nocopy.copied, len, NULL);
+	zassert_true(sys_slist_is_empty(&tr_nocopy_instance.heap_bufs), NULL);
+}
+
+static void test_nocopy_free(void)
+{
+	uint8_t *shm_buf = alloc(&tr_nocopy, NOTIF_LEN, 0);
+	uint8_t *heap_buf = alloc(&tr_nocopy, SHM_BUF_SIZE * 2, 0);
+
+	tr_nocopy.api->tx_buf_free(&tr_nocopy, heap_buf);
+	tr_nocopy.api->tx_buf_free(&tr_nocopy, shm_buf);
+
+	zassert_equal(received_count, 0, NULL);
+	shm_assert_free(&lb_nocopy);
+	zassert_true(sys_slist_is_empty(&tr_nocopy_instance.heap_bufs), NULL);
+}
+
+static void test_copy_fallback(void)
+{
+	uint8_t *buf;
+
+	zassert_equal(tr_copy_instance.tx_buf_size, 0, NULL);
+
+	buf = alloc(&tr_copy, NOTIF_LEN, 0x3c);
+	zassert_equal(tr_copy.api->send(&tr_copy, buf, NOTIF_LEN), 0, NULL);
+
+	zassert_equal(received_count, 1, NULL);
+	zassert_equal(received_first, 0x3c, NULL);
+	zassert_equal(lb_copy.copied, NOTIF_LEN, NULL);
+
+	buf = alloc(&tr_copy, NOTIF_LEN, 0);
+	tr_copy.api->tx_buf_free(&tr_copy, buf);
+	zassert_equal(received_count, 1, NULL);
+}
+
+static void notify(const struct nrf_rpc_tr *tr, struct loopback *lb, const char *name)
+{
+	uint32_t start;
+	uint32_t cycles;
+	uint64_t ns;
+
+	start = k_cycle_get_32();
+	for (int i = 0; i < NOTIF_COUNT; i++) {
+		uint8_t *buf = alloc(tr, NOTIF_LEN, (uint8_t)i);
+
+		zassert_equal(tr->api->send(tr, buf, NOTIF_LEN), 0, NULL);
+	}
+	cycles = k_cycle_get_32() - start;
+	ns = k_cyc_to_ns_floor64(cycles);
+
+	zassert_equal(received_count, NOTIF_COUNT, NULL);
+
+	printk("%s: %d notifications, %u bytes copied, %u cycles", name, NOTIF_COUNT,
+	       (uint32_t)lb->copied, cycles);
+	if (ns > 0) {
+		printk(", %u notifications/s",
+		       (uint32_t)((uint64_t)NOTIF_COUNT * NSEC_PER_SEC / ns));
+	}
+	printk("\n");
+}
+
+static void test_notification_benchmark(void)
+{
+	notify(&tr_copy, &lb_copy, "heap + copy");
+	zassert_equal(lb_copy.copied, NOTIF_COUNT * NOTIF_LEN, NULL);
+
+	received_count = 0;
+	notify(&tr_nocopy, &lb_nocopy, "no-copy");
+	zassert_equal(lb_nocopy.copied, 0, NULL);
+	shm_assert_free(&lb_nocopy);
+}
+
+void test_main(void)
+{
+	zassert_equal(tr_nocopy.api->init(&tr_nocopy, receive_cb, NULL), 0, NULL);
+	zassert_equal(tr_copy.api->init(&tr_copy, receive_cb, NULL), 0, NULL);
+
+	ztest_test_suite(nrf_rpc_ipc_test,
+			 ztest_unit_test_setup_teardown(test_nocopy_send, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_nocopy_large_packet, setup,
+							unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_nocopy_free, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_copy_fallback, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_notification_benchmark, setup,
+							unit_test_noop));
+
+	ztest_run_test_suite(nrf_rpc_ipc_test);
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2022 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <ztest.h>
+#include <string.h>
+
+#include "nrf_rpc_os.h"
+
+#define GROUP_PINNED	7
+#define GROUP_OTHER	1
+#define PACKETS		40
+#define WAIT_TIME	K_MSEC(1000)
+
+static K_SEM_DEFINE(processed, 0, PACKETS);
+static k_tid_t pinned_thread;
+static bool other_on_pinned;
+static bool pinned_moved;
+
+static uint8_t packets[2 * PACKETS][5];
+static int next_packet;
+
+static void work(const uint8_t *data, size_t len)
+{
+	if (data[4] == GROUP_PINNED) {
+		if (pinned_thread == NULL) {
+			pinned_thread = k_current_get();
+		} else if (pinned_thread != k_current_get()) {
+			pinned_moved = true;
+		}
+	} else if (k_current_get() == pinned_thread) {
+		other_on_pinned = true;
+	}
+
+	k_sem_give(&processed);
+}
+
+static void send(uint8_t group_id, int count)
+{
+	for (int i = 0; i < count; i++) {
+		uint8_t *packet = packets[next_packet++ % ARRAY_SIZE(packets)];
+
+		packet[4] = group_id;
+		nrf_rpc_os_thread_pool_send(packet, sizeof(packets[0]));
+	}
+}
+
+static void wait_processed(int count)
+{
+	for (int i = 0; i < count; i++) {
+		zassert_equal(k_sem_take(&processed, WAIT_TIME), 0, "packet %d lost", i);
+	}
+}
+
+static void setup(void)
+{
+	k_sem_reset(&processed);
+	next_packet = 0;
+	nrf_rpc_os_thread_pool_stats_reset();
+}
+
+static void test_ctx_pool(void)
+{
+	bool reserved[CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE] = { 0 };
+	uint32_t number;
+
+	/* more contexts than bits in a word */
+	for (int i = 0; i < CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE; i++) {
+		number = nrf_rpc_os_ctx_pool_reserve();
+		zassert_true(number < CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE, "bad number:%u", number);
+		zassert_false(reserved[number], "number:%u reserved twice", number);
+		reserved[number] = true;
+	}
+
+	nrf_rpc_os_ctx_pool_release(CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE - 1);
+	zassert_equal(nrf_rpc_os_ctx_pool_reserve(), CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE - 1, NULL);
+
+	for (int i = 0; i < CONFIG_NRF_RPC_CMD_CTX_POOL_SIZE; i++) {
+		nrf_rpc_os_ctx_pool_release(i);
+	}
+}
+
+static void test_burst(void)
+{
+	/* more packets than the queue holds; the sender waits for the pool */
+	send(GROUP_OTHER, PACKETS);
+	wait_processed(PACKETS);
+}
+
+static void test_affinity(void)
+{
+	zassert_equal(nrf_rpc_os_thread_pool_affinity_set(GROUP_PINNED,
+		      CONFIG_NRF_RPC_THREAD_POOL_AFFINITY_WORKERS), -NRF_EINVAL, NULL);
+	zassert_equal(nrf_rpc_os_thread_pool_affinity_set(GROUP_PINNED, 0), 0, NULL);
+
+	send(GROUP_PINNED, PACKETS / 2);
+	wait_processed(PACKETS / 2);
+	send(GROUP_OTHER, PACKETS / 2);
+	wait_processed(PACKETS / 2);
+
+	zassert_not_null(pinned_thread, NULL);
+	zassert_false(pinned_moved, "pinned group ran on several threads");
+	zassert_false(other_on_pinned, "other group ran on the dedicated worker");
+
+	zassert_equal(nrf_rpc_os_thread_pool_affinity_set(GROUP_PINNED, -1), 0, NULL);
+}
+
+static void test_stats(void)
+{
+	struct nrf_rpc_os_thread_pool_stats stats;
+
+	send(GROUP_OTHER, PACKETS / 4);
+	send(GROUP_PINNED, PACKETS / 2);
+	wait_processed(PACKETS / 4 + PACKETS / 2);
+
+	nrf_rpc_os_thread_pool_stats_get(&stats);
+	zassert_equal(stats.cmds, PACKETS / 4 + PACKETS / 2, NULL);
+	zassert_true(stats.wait_total_us >= stats.wait_max_us, NULL);
+	zassert_equal(nrf_rpc_os_thread_pool_group_cmds(GROUP_OTHER), PACKETS / 4, NULL);
+	zassert_equal(nrf_rpc_os_thread_pool_group_cmds(GROUP_PINNED), PACKETS / 2, NULL);
+
+	printk("%u commands, queue wait max %u us, mean %u us\n", stats.cmds,
+	       stats.wait_max_us, (uint32_t)(stats.wait_total_us / stats.cmds));
+}
+
+void test_main(void)
+{
+	zassert_equal(nrf_rpc_os_init(work), 0, NULL);
+
+	ztest_test_suite(nrf_rpc_os_test,
+			 ztest_unit_test_setup_teardown(test_ctx_pool, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_burst, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_affinity, setup, unit_test_noop),
+			 ztest_unit_test_setup_teardown(test_stats, setup, unit_test_noop));
+
+	ztest_run_test_suite(nrf_rpc_os_test);
+}